@@ -33,7 +33,7 @@ typedef unsigned char u8;
 typedef unsigned short u16;
 typedef unsigned int u32;
 
-#if _MSC_VER <= 1200
+#if !defined(__GNUC__) && _MSC_VER <= 1200
 typedef unsigned __int64 u64;
 #else
 typedef unsigned long long u64;
@@ -43,7 +43,7 @@ typedef signed char s8;
 typedef short s16;
 typedef int s32;
 
-#if _MSC_VER <= 1200
+#if !defined(__GNUC__) && _MSC_VER <= 1200
 typedef __int64 s64;
 #else
 typedef long long s64;
@@ -54,7 +54,7 @@ typedef double f64;
 
 typedef int BOOL;
 
-#ifdef _WIN64
+#if defined(_WIN64) || defined(__LP64__)
 typedef unsigned long long addr;
 #else
 typedef unsigned int addr;
@@ -83,7 +83,9 @@ struct u32x4 { u32 X, Y, Z, W; };
 #define FALSE 0
 #define TRUE 1
 
+#ifndef NULL
 #define NULL 0
+#endif
 
 #define U8_MIN 0
 #define U8_MAX 256
@@ -103,11 +105,11 @@ struct u32x4 { u32 X, Y, Z, W; };
 #define F32_MIN (1.1754943508e-38f)
 #define F32_MAX (3.4028234664e+38f)
 
-#if defined(__WATCOMC__) || _MSC_VER <= 1200
+#if defined(__WATCOMC__) || (!defined(__GNUC__) && _MSC_VER <= 1200)
 #define vsnprintf_s _vsnprintf
 #endif
 
-#if !defined(__WATCOMC__) && _MSC_VER <= 1200
+#if !defined(__WATCOMC__) && !defined(__GNUC__) && _MSC_VER <= 1200
 #define roundf(x) (x >= 0.0f ? floorf(x + 0.5f) : ceilf(x - 0.5f))
 #define round(x) (x < 0.0 ? ceil(x - 0.5) : floor(x + 0.5))
 #define exp2(x) pow(2.0, x)
@@ -33,18 +33,81 @@ SOFTWARE.
 // DEFAULT: FALSE
 #define RENDERER_MODULE_SETTINGS_ACCELERATE_GRAPHICS_PROPERTY_NAME "Accelerate"
 
+// The number of frames between the full clears of the depth buffer, values below two clear the depth buffer every frame.
+// The frames in between skip the clear, and alternate between the lower half of the depth range, and the upper half with the inverted depth comparison.
+// Requires the game to draw over the whole screen every frame, otherwise the stale depth values of the earlier frames show through.
+// The inverted frames draw with the mirrored depth comparison, which the draw sorting recognizes as well, so that the sorting stays active on every frame.
+// DEFAULT: 1
+#define RENDERER_MODULE_SETTINGS_DEPTH_CLEAR_INTERVAL_PROPERTY_NAME "DepthClearInterval"
+
+// Indicates whether draw calls are recorded into a per-frame command buffer and submitted sorted by state.
+// Consecutive opaque draws are grouped by texture, blend, depth, fog and cull state, all the other draws keep their order,
+// and none of the opaque draws is moved across them.
+// DEFAULT: TRUE
+#define RENDERER_MODULE_SETTINGS_DRAW_SORTING_PROPERTY_NAME "DrawSorting"
+
 // Indicates whether flat shading is active/enabled.
 // In practice means whether to overwrite the vertex color with white color or not.
 // In my case enabling this leads to disappearance of transparency in the game.
 // DEFAULT: TRUE
 #define RENDERER_MODULE_SETTINGS_FLAT_SHADING_PROPERTY_NAME "FlatShading"
 
+// Indicates whether triangle meshes submitted unchanged over several frames are kept in write-once vertex buffers,
+// and drawn from there instead of being copied into the batch again.
+// DEFAULT: TRUE
+#define RENDERER_MODULE_SETTINGS_GEOMETRY_CACHE_PROPERTY_NAME "GeometryCache"
+
+// Indicates whether the recorded draw commands are submitted to the device from a dedicated render thread.
+// The game thread keeps recording the next batch of commands while the previous one is drawn and presented.
+// DEFAULT: FALSE
+#define RENDERER_MODULE_SETTINGS_RENDER_THREAD_PROPERTY_NAME "RenderThread"
+
+// The largest width and height, in pixels, of the textures packed into the shared atlas textures, 0 disables the packing.
+// The small textures, like the fonts and the interface elements, drawn one after another are drawn in a single batch.
+// DEFAULT: 64
+#define RENDERER_MODULE_SETTINGS_TEXTURE_ATLAS_PROPERTY_NAME "TextureAtlas"
+
+// Indicates whether the converted, and the compressed, textures are stored in the cache file, and uploaded from it on the later runs.
+// The cache file is mapped into the memory, the least recently used textures are removed from it once it is full.
+// The cache file is reset when the game did not close it cleanly, it can be inspected with the TextureCache tool.
+// DEFAULT: TRUE
+#define RENDERER_MODULE_SETTINGS_TEXTURE_CACHE_PROPERTY_NAME "TextureCache"
+
+// The capacity of the cache file of the converted textures, in megabytes, up to 256.
+// DEFAULT: 64
+#define RENDERER_MODULE_SETTINGS_TEXTURE_CACHE_SIZE_PROPERTY_NAME "TextureCacheSize"
+
+// Indicates whether the uncompressed 16-bit and 32-bit textures are compressed into DXT blocks on upload, when the device supports them.
+// The compression runs on the worker threads, the textures keep their previous pixels until it completes.
+// DEFAULT: FALSE
+#define RENDERER_MODULE_SETTINGS_TEXTURE_COMPRESSION_PROPERTY_NAME "TextureCompression"
+
+// Indicates whether the texture uploads with the same pixels, or the same palette, as the texture already holds are skipped,
+// and whether the textures with the same pixels share a single device surface.
+// DEFAULT: TRUE
+#define RENDERER_MODULE_SETTINGS_TEXTURE_DEDUPLICATION_PROPERTY_NAME "TextureDeduplication"
+
+// The filter of the mip map levels generated for the textures uploaded without them: 0 - none, 1 - box, 2 - gamma-correct box.
+// The levels are generated on upload, distant textures are sampled from them instead of shimmering.
+// DEFAULT: 1
+#define RENDERER_MODULE_SETTINGS_TEXTURE_MIP_MAPS_PROPERTY_NAME "TextureMipMaps"
+
+// Indicates whether the texture uploads, that need the conversion of the pixels into the format of the texture, are converted on the worker threads.
+// The texture keeps its previous pixels until the upload completes, or until the texture is selected for rendering.
+// DEFAULT: TRUE
+#define RENDERER_MODULE_SETTINGS_TEXTURE_STAGING_PROPERTY_NAME "TextureStaging"
+
 // Indicates whether vertex buffer is used for rendering instead of just a pointer to an array of vertexes.
-// In practice, on some systems, like mine, leads to a drastic performance drop, thus making this a configuration item.
+// The vertex buffer is streamed into as a ring, and only discarded on wrap around, which makes it the faster option.
 // DEFAULT: TRUE
 #define RENDERER_MODULE_SETTINGS_VERTEX_BUFFER_PROPERTY_NAME "VertexBuffer"
 
 // Indicates whether vertexes X and Y coordinates must be offset by -0.5.
 // This change comes from the Modern Patch.
 // DEFAULT: TRUE
-#define RENDERER_MODULE_SETTINGS_VERTEX_OFFSET_PROPERTY_NAME "VertexOffset"
\ No newline at end of file
+#define RENDERER_MODULE_SETTINGS_VERTEX_OFFSET_PROPERTY_NAME "VertexOffset"
+
+// Indicates whether the primitives are clipped against the clip rectangle of the game on the CPU, and appended to the current batch,
+// instead of changing the device viewport, which forces the batch to be drawn every time the game changes the clip rectangle.
+// DEFAULT: TRUE
+#define RENDERER_MODULE_SETTINGS_VIEWPORT_CLIPPING_PROPERTY_NAME "ViewPortClipping"
\ No newline at end of file
@@ -186,14 +186,7 @@ namespace RendererModule
     // NOTE: Never being called by the application.
     DLLAPI void STDCALLAPI DrawTriangleFans(const u32 count, RVX* vertexes, const u32* indexes)
     {
-        for (u32 x = 0, i = 1; x < (count * 3 + 2) / 3; x = x + 3, i = i + 2)
-        {
-            State.Data.Indexes.Small[x + 0] = 0;
-            State.Data.Indexes.Small[x + 1] = i + 0;
-            State.Data.Indexes.Small[x + 2] = i + 1;
-        }
-
-        RenderTriangleFans((RTLVX*)vertexes, count + 2, count * 3, State.Data.Indexes.Small);
+        RenderTriangleFans((RTLVX*)vertexes, count + 2, count, indexes);
     }
 
     // 0x600014d0
@@ -247,6 +240,8 @@ namespace RendererModule
     {
         InitializeSettings();
 
+        SelectRendererVertexTransforms();
+
         AcquireRendererDeviceCount();
 
         return State.Devices.Count;
@@ -370,6 +365,17 @@ namespace RendererModule
         if (State.Lock.IsActive) { LOGERROR("D3D pageflip called in while locked\n"); }
 
         ToggleRenderer();
+
+        State.Shadow.Filtered = 0;
+
+        State.Textures.Statistics.Previous = State.Textures.Statistics.Current;
+
+        State.Textures.Statistics.Current.Uploads = 0;
+        State.Textures.Statistics.Current.Skipped = 0;
+        State.Textures.Statistics.Current.Evicted = 0;
+        State.Textures.Statistics.Current.Reloaded = 0;
+
+        State.Textures.Frame = State.Textures.Frame + 1;
     }
 
     // 0x60002f60
@@ -612,6 +618,8 @@ namespace RendererModule
                 RendererShadeMode = RENDERER_MODULE_SHADE_GOURAUD;
             }
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE:
@@ -805,6 +813,8 @@ namespace RendererModule
             default: { return RENDERER_MODULE_FAILURE; }
             }
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_FOG_START:
@@ -831,6 +841,8 @@ namespace RendererModule
                 AttemptRenderScene();
 
                 RendererDepthBias = *(f32*)&value * 0.000030517578f;
+
+                SelectRendererVertexTransforms();
             }
 
             result = RENDERER_MODULE_SUCCESS; break;
@@ -916,10 +928,14 @@ namespace RendererModule
         }
         case RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS_ALTERNATIVE:
         {
+            UpdateRendererVertexes();
+
             SelectRendererFogAlphas((u8*)value, RendererFogAlphas);
 
             State.Settings.IsFogActive = TRUE;
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_DEPTH_BUFFER_WRITE_STATE_ALTERNATIVE:
@@ -1162,7 +1178,7 @@ namespace RendererModule
         tex->FormatIndex = State.Textures.Formats.Indexes[format];
         tex->FormatIndexValue = format;
 
-        tex->MipMapCount = 1;
+        tex->MipMapCount = AcquireRendererTextureMipMapCount(tex);
 
         tex->Is16Bit = (format == RENDERER_PIXEL_FORMAT_R5G5B5 || format == RENDERER_PIXEL_FORMAT_R4G4B4);
 
@@ -1177,7 +1193,47 @@ namespace RendererModule
 
         tex->Colors = 0;
 
-        const s32 result = InitializeRendererTextureDetails(tex);
+        tex->IsShareable = !palette;
+        tex->PixelHash = INVALID_TEXTURE_HASH;
+        tex->PaletteHash = INVALID_TEXTURE_HASH;
+
+        tex->IsEvictable = TRUE;
+        tex->Frame = State.Textures.Frame;
+        tex->Size = AcquireRendererTextureMemorySize(tex);
+        tex->Backup = NULL;
+
+        EvictRendererTextures(tex->Size, NULL);
+
+        s32 result = InitializeRendererTextureDetails(tex);
+
+        // NOTE: The least recently used textures are evicted from the video memory, instead of failing the allocation.
+        while (result == RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR)
+        {
+            if (!EvictRendererTexture(AcquireRendererTextureEviction(NULL))) { break; }
+
+            tex->Surface1 = NULL;
+            tex->Texture1 = NULL;
+            tex->Surface2 = NULL;
+            tex->Texture2 = NULL;
+            tex->Palette = NULL;
+
+            result = InitializeRendererTextureDetails(tex);
+        }
+
+        // NOTE: The texture falls back to the single level, when the device is unable to create the mip map levels.
+        if (result != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK && 1 < tex->MipMapCount)
+        {
+            tex->MipMapCount = 1;
+            tex->Size = AcquireRendererTextureMemorySize(tex);
+
+            tex->Surface1 = NULL;
+            tex->Texture1 = NULL;
+            tex->Surface2 = NULL;
+            tex->Texture2 = NULL;
+            tex->Palette = NULL;
+
+            result = InitializeRendererTextureDetails(tex);
+        }
 
         if (result != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
         {
@@ -1188,8 +1244,20 @@ namespace RendererModule
             return NULL;
         }
 
-        tex->Previous = State.Textures.Current;
-        State.Textures.Current = tex;
+        if (!AttachRendererTexture(tex))
+        {
+            if (tex->Surface1 != NULL) { tex->Surface1->Release(); }
+            if (tex->Texture1 != NULL) { tex->Texture1->Release(); }
+            if (tex->Surface2 != NULL) { tex->Surface2->Release(); }
+            if (tex->Texture2 != NULL) { tex->Texture2->Release(); }
+            if (tex->Palette != NULL) { tex->Palette->Release(); }
+
+            ReleaseRendererTexture(tex);
+
+            return NULL;
+        }
+
+        State.Textures.Size = State.Textures.Size + tex->Size;
 
         return tex;
     }
@@ -1207,18 +1275,25 @@ namespace RendererModule
             State.Scene.IsActive = FALSE;
         }
 
-        while (State.Textures.Current != NULL)
+        // NOTE: The records of the textures are returned to the pool of the textures, instead of being leaked.
+        for (u32 x = 0; x < State.Textures.Active.Count; x++)
         {
-            if (State.Textures.Current->Surface1 != NULL) { State.Textures.Current->Surface1->Release(); }
-            if (State.Textures.Current->Texture1 != NULL) { State.Textures.Current->Texture1->Release(); }
-            if (State.Textures.Current->Surface2 != NULL) { State.Textures.Current->Surface2->Release(); }
-            if (State.Textures.Current->Texture2 != NULL) { State.Textures.Current->Texture2->Release(); }
-            if (State.Textures.Current->Palette != NULL) { State.Textures.Current->Palette->Release(); }
+            RendererTexture* tex = State.Textures.Active.Textures[x];
+
+            if (tex->Surface1 != NULL) { tex->Surface1->Release(); }
+            if (tex->Texture1 != NULL) { tex->Texture1->Release(); }
+            if (tex->Surface2 != NULL) { tex->Surface2->Release(); }
+            if (tex->Texture2 != NULL) { tex->Texture2->Release(); }
+            if (tex->Palette != NULL) { tex->Palette->Release(); }
+            if (tex->Backup != NULL) { tex->Backup->Release(); }
 
-            State.Textures.Current = State.Textures.Current->Previous;
+            ReleaseRendererTexture(tex);
         }
 
-        State.Textures.Current = NULL;
+        State.Textures.Active.Count = 0;
+        State.Textures.Selected = NULL;
+
+        State.Textures.Size = 0;
 
         State.Textures.Illegal = FALSE;
 
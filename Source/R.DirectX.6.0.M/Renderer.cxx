@@ -30,6 +30,14 @@ SOFTWARE.
 
 #define MAX_MESSAGE_BUFFER_LENGTH 512
 
+#define TEXTURE_HASH_PRIME_1 0x9E3779B1
+#define TEXTURE_HASH_PRIME_2 0x85EBCA77
+#define TEXTURE_HASH_PRIME_3 0xC2B2AE3D
+#define TEXTURE_HASH_PRIME_4 0x27D4EB2F
+#define TEXTURE_HASH_PRIME_5 0x165667B1
+
+#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
 using namespace Renderer;
 using namespace RendererModuleValues;
 using namespace Settings;
@@ -70,18 +78,126 @@ namespace RendererModule
         dst->UV.Y = src->UV.Y;
     }
 
-    // 0x6000e514
-    void InitializeVertexes(RVX* vertexes, const u32 count)
+    // Applies the active set of vertex transforms to a batch of vertexes in a single pass.
+    // The position related transforms are applied with one packed addition per vertex,
+    // and the fog alpha indexes are calculated four vertexes at a time.
+    void UpdateVertexes(RTLVX* vertexes, const u32 count, const u32 transforms)
     {
-        if (!SettingsState.VertexOffset) { return; }
+        if (transforms == RENDERER_VERTEX_TRANSFORM_NONE || count == 0) { return; }
 
-        for (u32 x = 0; x < count; x++)
+        const BOOL isColor = (transforms & RENDERER_VERTEX_TRANSFORM_COLOR) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isFog = (transforms & RENDERER_VERTEX_TRANSFORM_FOG) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isFogRHW = (transforms & RENDERER_VERTEX_TRANSFORM_FOG_RHW) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isPosition = (transforms & (RENDERER_VERTEX_TRANSFORM_DEPTH | RENDERER_VERTEX_TRANSFORM_OFFSET)) != RENDERER_VERTEX_TRANSFORM_NONE;
+
+        const f32 offset = (transforms & RENDERER_VERTEX_TRANSFORM_OFFSET) ? -0.5f : 0.0f;
+        const f32 bias = (transforms & RENDERER_VERTEX_TRANSFORM_DEPTH) ? RendererDepthBias : 0.0f;
+
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        const __m128 delta = _mm_setr_ps(offset, offset, bias, 0.0f);
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minimum = _mm_setzero_ps();
+        const __m128 maximum = _mm_set1_ps((f32)MAX_OUTPUT_FOG_ALPHA_VALUE);
+
+        for (; x + 4 <= count; x = x + 4)
+        {
+            RTLVX* v0 = &vertexes[x + 0];
+            RTLVX* v1 = &vertexes[x + 1];
+            RTLVX* v2 = &vertexes[x + 2];
+            RTLVX* v3 = &vertexes[x + 3];
+
+            if (isColor)
+            {
+                v0->Color = GRAPCHICS_COLOR_WHITE;
+                v1->Color = GRAPCHICS_COLOR_WHITE;
+                v2->Color = GRAPCHICS_COLOR_WHITE;
+                v3->Color = GRAPCHICS_COLOR_WHITE;
+            }
+
+            if (isFog || isFogRHW)
+            {
+                const __m128 value = isFog
+                    ? _mm_setr_ps(v0->XYZ.Z, v1->XYZ.Z, v2->XYZ.Z, v3->XYZ.Z)
+                    : _mm_sub_ps(one, _mm_mul_ps(_mm_setr_ps(v0->RHW, v1->RHW, v2->RHW, v3->RHW), _mm_set1_ps(0.000015259022f)));
+
+                // NOTE: Rounding of (value * 255 + 0.5) is the same as truncation of (value * 255 + 1).
+                // The index is clamped, the original code reads past the fog alphas when the value is outside of [0, 1).
+                const __m128 indx = _mm_add_ps(_mm_mul_ps(value, maximum), one);
+
+                u32 indexes[4];
+                _mm_storeu_si128((__m128i*)indexes, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(indx, minimum), maximum)));
+
+                v0->Specular = ((u32)RendererFogAlphas[indexes[0]]) << 24;
+                v1->Specular = ((u32)RendererFogAlphas[indexes[1]]) << 24;
+                v2->Specular = ((u32)RendererFogAlphas[indexes[2]]) << 24;
+                v3->Specular = ((u32)RendererFogAlphas[indexes[3]]) << 24;
+            }
+
+            if (isPosition)
+            {
+                _mm_storeu_ps((f32*)&v0->XYZ, _mm_add_ps(_mm_loadu_ps((f32*)&v0->XYZ), delta));
+                _mm_storeu_ps((f32*)&v1->XYZ, _mm_add_ps(_mm_loadu_ps((f32*)&v1->XYZ), delta));
+                _mm_storeu_ps((f32*)&v2->XYZ, _mm_add_ps(_mm_loadu_ps((f32*)&v2->XYZ), delta));
+                _mm_storeu_ps((f32*)&v3->XYZ, _mm_add_ps(_mm_loadu_ps((f32*)&v3->XYZ), delta));
+            }
+        }
+#endif
+
+        for (; x < count; x++)
+        {
+            RTLVX* vertex = &vertexes[x];
+
+            if (isColor) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+
+            if (isFog) { vertex->Specular = ((u32)RendererFogAlphas[AcquireFogAlphaIndex(vertex->XYZ.Z)]) << 24; }
+            else if (isFogRHW) { vertex->Specular = ((u32)RendererFogAlphas[AcquireFogAlphaIndex(1.0f - vertex->RHW * 0.000015259022f)]) << 24; }
+
+            if (isPosition)
+            {
+                vertex->XYZ.X = vertex->XYZ.X + offset;
+                vertex->XYZ.Y = vertex->XYZ.Y + offset;
+                vertex->XYZ.Z = vertex->XYZ.Z + bias;
+            }
+        }
+    }
+
+    // Applies the active vertex transforms to the vertexes added to the batch since the last update.
+    // The batched triangles and quads calculate the fog alpha from RHW instead of Z.
+    void UpdateRendererVertexes(void)
+    {
+        if (State.Data.Vertexes.Processed < State.Data.Vertexes.Count)
         {
-            f32x3* xyz = (f32x3*)((addr)vertexes + (addr)(x * sizeof(RTLVX)));
+            const u32 transforms = (State.Data.Vertexes.Transforms & RENDERER_VERTEX_TRANSFORM_FOG)
+                ? ((State.Data.Vertexes.Transforms & ~RENDERER_VERTEX_TRANSFORM_FOG) | RENDERER_VERTEX_TRANSFORM_FOG_RHW)
+                : State.Data.Vertexes.Transforms;
 
-            xyz->X = xyz->X - 0.5f;
-            xyz->Y = xyz->Y - 0.5f;
+            UpdateVertexes(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Processed],
+                State.Data.Vertexes.Count - State.Data.Vertexes.Processed, transforms);
         }
+
+        State.Data.Vertexes.Processed = State.Data.Vertexes.Count;
+    }
+
+    // Selects the set of vertex transforms matching the current state.
+    // The vertexes already in the batch are processed with the previous set first.
+    void SelectRendererVertexTransforms(void)
+    {
+        UpdateRendererVertexes();
+
+        u32 transforms = RENDERER_VERTEX_TRANSFORM_NONE;
+
+        if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_COLOR; }
+
+        if (State.Settings.IsFogActive) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_FOG; }
+
+        if (RendererDepthBias != 0.0f) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_DEPTH; }
+
+        if (SettingsState.VertexOffset) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_OFFSET; }
+
+        State.Data.Vertexes.Transforms = transforms;
     }
 
     // 0x60001830
@@ -132,6 +248,8 @@ namespace RendererModule
 
             RendererDepthBias = 0.0f;
 
+            SelectRendererVertexTransforms();
+
             State.DX.Device->SetRenderState(D3DRENDERSTATE_FLUSHBATCH, TRUE);
 
             return State.DX.Device->EndScene() == DD_OK;
@@ -150,13 +268,14 @@ namespace RendererModule
             State.Scene.IsActive = TRUE;
         }
 
-        InitializeVertexes((RVX*)State.Data.Vertexes.Vertexes, State.Data.Vertexes.Count);
+        UpdateRendererVertexes();
 
         const HRESULT result = State.DX.Device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, D3DFVF_TLVERTEX,
             State.Data.Vertexes.Vertexes, State.Data.Vertexes.Count,
             State.Data.Indexes.Medium, State.Data.Indexes.Count, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP);
 
         State.Data.Vertexes.Count = 0;
+        State.Data.Vertexes.Processed = 0;
         State.Data.Indexes.Count = 0;
 
         return result;
@@ -281,6 +400,10 @@ namespace RendererModule
 
         ResetTextures();
 
+        ReleaseRendererTexturePool();
+
+        ReleaseRendererTextureMipMaps();
+
         State.DX.Active.Instance = NULL;
 
         State.DX.Active.Surfaces.Main = NULL;
@@ -1473,9 +1596,18 @@ namespace RendererModule
         return INVALID_TEXTURE_FORMAT_INDEX;
     }
 
+    // NOTE: Invalidates the shadow copies of the render and texture stage states, so that the next selection of each state reaches the device.
+    void InitializeRendererShadowStates(void)
+    {
+        ZeroMemory(State.Shadow.States.IsValid, MAX_RENDER_STATE_COUNT * sizeof(BOOL));
+        ZeroMemory(State.Shadow.Stages.IsValid, MAX_TEXTURE_STAGE_COUNT * MAX_TEXTURE_STAGE_STATE_COUNT * sizeof(BOOL));
+    }
+
     // 0x60004d40
     void InitializeRendererState(void)
     {
+        InitializeRendererShadowStates();
+
         State.DX.Device->BeginScene();
 
         InitializeRendererTransforms();
@@ -1697,11 +1829,128 @@ namespace RendererModule
     }
 
     // 0x60005240
+    // NOTE: The textures are taken from the pool of the textures, unless the application provides the memory allocation.
     RendererTexture* AllocateRendererTexture(const u32 size)
     {
-        if (State.Lambdas.AllocateMemory != NULL) { return (RendererTexture*)State.Lambdas.AllocateMemory(size); }
+        RendererTexture* result = NULL;
+
+        if (State.Lambdas.AllocateMemory != NULL) { result = (RendererTexture*)State.Lambdas.AllocateMemory(size); }
+        else
+        {
+            if (size == sizeof(RendererTexture))
+            {
+                result = AcquireRendererTexturePoolRecord();
+
+                if (result != NULL) { return result; }
+            }
+
+            result = (RendererTexture*)malloc(size);
+        }
+
+        if (result != NULL) { result->PoolIndex = INVALID_TEXTURE_POOL_INDEX; }
+
+        return result;
+    }
+
+    // Acquires the free record from the pool of the textures, the pool grows by a slab of the records at a time.
+    RendererTexture* AcquireRendererTexturePoolRecord(void)
+    {
+        if (State.Textures.Pool.Available == 0)
+        {
+            if (MAX_TEXTURE_POOL_SLAB_COUNT <= State.Textures.Pool.Count) { return NULL; }
+
+            RendererTexture* slab = (RendererTexture*)malloc(MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT * sizeof(RendererTexture));
+
+            if (slab == NULL) { return NULL; }
+
+            const s32 offset = State.Textures.Pool.Count * MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT;
+
+            for (u32 x = 0; x < MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT; x++)
+            {
+                slab[x].PoolIndex = offset + x;
+                slab[x].PoolNext = (x + 1) < MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT ? (offset + x + 1) : INVALID_TEXTURE_POOL_INDEX;
+            }
+
+            State.Textures.Pool.Slabs[State.Textures.Pool.Count] = slab;
+            State.Textures.Pool.Count = State.Textures.Pool.Count + 1;
+
+            State.Textures.Pool.Free = offset;
+            State.Textures.Pool.Available = MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT;
+        }
+
+        const s32 indx = State.Textures.Pool.Free;
+
+        RendererTexture* result = &State.Textures.Pool.Slabs[indx / MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT][indx % MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT];
+
+        State.Textures.Pool.Free = result->PoolNext;
+        State.Textures.Pool.Available = State.Textures.Pool.Available - 1;
+
+        return result;
+    }
+
+    // Appends the texture to the dense array of the active textures, which the texture walks iterate over.
+    BOOL AttachRendererTexture(RendererTexture* tex)
+    {
+        if (State.Textures.Active.Count == State.Textures.Active.Capacity)
+        {
+            const u32 capacity = State.Textures.Active.Capacity == 0
+                ? MIN_ACTIVE_TEXTURE_CAPACITY : (State.Textures.Active.Capacity * 2);
+
+            RendererTexture** textures = (RendererTexture**)realloc(State.Textures.Active.Textures, capacity * sizeof(RendererTexture*));
+
+            if (textures == NULL) { return FALSE; }
+
+            State.Textures.Active.Textures = textures;
+            State.Textures.Active.Capacity = capacity;
+        }
+
+        tex->ActiveIndex = State.Textures.Active.Count;
+
+        State.Textures.Active.Textures[State.Textures.Active.Count] = tex;
+        State.Textures.Active.Count = State.Textures.Active.Count + 1;
+
+        return TRUE;
+    }
+
+    // Removes the texture from the dense array of the active textures, by moving the last active texture into its place.
+    void DetachRendererTexture(RendererTexture* tex)
+    {
+        const u32 indx = tex->ActiveIndex;
+
+        if (State.Textures.Active.Count <= indx || State.Textures.Active.Textures[indx] != tex) { return; }
+
+        State.Textures.Active.Count = State.Textures.Active.Count - 1;
 
-        return (RendererTexture*)malloc(size);
+        RendererTexture* last = State.Textures.Active.Textures[State.Textures.Active.Count];
+
+        State.Textures.Active.Textures[indx] = last;
+        last->ActiveIndex = indx;
+    }
+
+    // Releases the slabs of the pool of the textures, and the dense array of the active textures.
+    void ReleaseRendererTexturePool(void)
+    {
+        if (State.Textures.Active.Count != 0) { return; }
+
+        for (u32 x = 0; x < State.Textures.Pool.Count; x++)
+        {
+            free(State.Textures.Pool.Slabs[x]);
+
+            State.Textures.Pool.Slabs[x] = NULL;
+        }
+
+        State.Textures.Pool.Count = 0;
+        State.Textures.Pool.Free = INVALID_TEXTURE_POOL_INDEX;
+        State.Textures.Pool.Available = 0;
+
+        if (State.Textures.Active.Textures != NULL)
+        {
+            free(State.Textures.Active.Textures);
+
+            State.Textures.Active.Textures = NULL;
+        }
+
+        State.Textures.Active.Capacity = 0;
     }
 
     // 0x60004260
@@ -1713,6 +1962,16 @@ namespace RendererModule
     // 0x60005270
     u32 DisposeRendererTexture(RendererTexture* tex)
     {
+        if (tex->PoolIndex != INVALID_TEXTURE_POOL_INDEX)
+        {
+            tex->PoolNext = State.Textures.Pool.Free;
+
+            State.Textures.Pool.Free = tex->PoolIndex;
+            State.Textures.Pool.Available = State.Textures.Pool.Available + 1;
+
+            return RENDERER_MODULE_SUCCESS;
+        }
+
         if (State.Lambdas.ReleaseMemory != NULL) { return State.Lambdas.ReleaseMemory(tex); }
 
         free(tex);
@@ -1754,6 +2013,13 @@ namespace RendererModule
                     }
                 }
 
+                // NOTE: The system memory surface holds the top level only, the lower levels are generated into the device surface.
+                if (1 < tex->MipMapCount)
+                {
+                    desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+                    desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
+                }
+
                 if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
                 else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
             }
@@ -1844,6 +2110,14 @@ namespace RendererModule
                     }
                 }
 
+                // NOTE: The generated mip map levels are requested regardless of the environment variable.
+                if (1 < tex->MipMapCount)
+                {
+                    desc.dwFlags = DDSD_MIPMAPCOUNT | DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+                    desc.dwMipMapCount = tex->MipMapCount;
+                    desc.ddsCaps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE | DDSCAPS_COMPLEX;
+                }
+
                 if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
                 else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
             }
@@ -2032,6 +2306,15 @@ namespace RendererModule
 
         if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
 
+        if (tex != NULL)
+        {
+            tex->Frame = State.Textures.Frame;
+
+            if (!ReloadRendererTexture(tex)) { return FALSE; }
+        }
+
+        State.Textures.Selected = tex;
+
         return State.DX.Device->SetTexture(0, tex == NULL ? NULL : tex->Texture2) == DD_OK;
     }
 
@@ -2044,8 +2327,46 @@ namespace RendererModule
     // 0x60007830
     BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette)
     {
+        if (!ReloadRendererTexture(tex)) { return FALSE; }
+
+        u64 pixelHash = INVALID_TEXTURE_HASH;
+        u64 paletteHash = INVALID_TEXTURE_HASH;
+
+        if (SettingsState.TextureDeduplication)
+        {
+            if (pixels != NULL)
+            {
+                pixelHash = AcquireRendererTextureHash(pixels, AcquireRendererTextureSize(tex));
+
+                if (pixelHash == tex->PixelHash || ShareRendererTexture(tex, pixelHash))
+                {
+                    State.Textures.Statistics.Current.Skipped = State.Textures.Statistics.Current.Skipped + 1;
+
+                    pixels = NULL;
+                }
+            }
+
+            if (palette != NULL && tex->IsPalette)
+            {
+                paletteHash = AcquireRendererTextureHash(palette, MAX_TEXTURE_PALETTE_COLOR_COUNT * sizeof(u32));
+
+                if (paletteHash == tex->PaletteHash)
+                {
+                    State.Textures.Statistics.Current.Skipped = State.Textures.Statistics.Current.Skipped + 1;
+
+                    palette = NULL;
+                }
+            }
+        }
+
         if (pixels != NULL)
         {
+            if (!UnshareRendererTexture(tex)) { return FALSE; }
+
+            tex->PixelHash = INVALID_TEXTURE_HASH;
+
+            State.Textures.Statistics.Current.Uploads = State.Textures.Statistics.Current.Uploads + 1;
+
             tex->Descriptor.lpSurface = (void*)pixels;
 
             tex->Descriptor.dwFlags = DDSD_LPSURFACE;
@@ -2059,11 +2380,18 @@ namespace RendererModule
                 State.DX.Device->SetRenderState(D3DRENDERSTATE_FLUSHBATCH, TRUE);
             }
 
-            tex->Surface2->Blt(NULL, tex->Surface1, NULL, DDBLT_WAIT, NULL);
+            if (tex->Surface2->Blt(NULL, tex->Surface1, NULL, DDBLT_WAIT, NULL) == DD_OK)
+            {
+                if (GenerateRendererTextureMipMaps(tex, pixels, tex->Descriptor.lPitch)) { tex->PixelHash = pixelHash; }
+            }
         }
 
         if (palette != NULL && tex->IsPalette)
         {
+            tex->PaletteHash = INVALID_TEXTURE_HASH;
+
+            State.Textures.Statistics.Current.Uploads = State.Textures.Statistics.Current.Uploads + 1;
+
             PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
 
             for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
@@ -2077,199 +2405,547 @@ namespace RendererModule
             if (tex->Palette->SetEntries(0, 0, tex->Colors, entries) != DD_OK) { return FALSE; }
 
             if (tex->Texture2->PaletteChanged(0, tex->Colors) != DD_OK) { return FALSE; }
+
+            tex->PaletteHash = paletteHash;
         }
 
         return TRUE;
     }
 
-    // 0x60006950
-    BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value)
+    // Calculates the 64-bit hash of the data, the hash is never equal to INVALID_TEXTURE_HASH.
+    // NOTE: The data is consumed as four interleaved lanes of 32-bit words, so the hashing of the large textures is memory bound.
+    u64 AcquireRendererTextureHash(const void* data, const u32 size)
     {
-        if (!State.Scene.IsActive)
+        const u8* bytes = (u8*)data;
+
+        u32 h1 = TEXTURE_HASH_PRIME_5 + size;
+        u32 h2 = TEXTURE_HASH_PRIME_4 ^ size;
+
+        if (16 <= size)
         {
-            BeginRendererScene();
+            u32 v1 = TEXTURE_HASH_PRIME_1 + TEXTURE_HASH_PRIME_2;
+            u32 v2 = TEXTURE_HASH_PRIME_2;
+            u32 v3 = 0;
+            u32 v4 = 0 - TEXTURE_HASH_PRIME_1;
 
-            State.Scene.IsActive = TRUE;
-        }
+            const u32 count = size >> 4;
 
-        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+            for (u32 x = 0; x < count; x++)
+            {
+                const u32* values = (u32*)((addr)bytes + (addr)(x << 4));
 
-        return State.DX.Device->SetRenderState(type, value) == DD_OK;
-    }
+                v1 = ROTATE_LEFT(v1 + values[0] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v2 = ROTATE_LEFT(v2 + values[1] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v3 = ROTATE_LEFT(v3 + values[2] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v4 = ROTATE_LEFT(v4 + values[3] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+            }
 
-    // 0x60006900
-    BOOL SelectRendererTextureStage(const DWORD stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value)
-    {
-        if (!State.Scene.IsActive)
-        {
-            BeginRendererScene();
+            h1 = h1 + ROTATE_LEFT(v1, 1) + ROTATE_LEFT(v2, 7) + ROTATE_LEFT(v3, 12) + ROTATE_LEFT(v4, 18);
+            h2 = h2 + (v1 ^ ROTATE_LEFT(v3, 16)) * TEXTURE_HASH_PRIME_3 + (v2 ^ ROTATE_LEFT(v4, 16)) * TEXTURE_HASH_PRIME_1;
 
-            State.Scene.IsActive = TRUE;
+            bytes = (u8*)((addr)bytes + (addr)(count << 4));
         }
 
-        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+        const u32 remainder = size & 15;
 
-        return State.DX.Device->SetTextureStageState(stage, type, value) == DD_OK;
-    }
+        for (u32 x = 0; x < (remainder >> 2); x++)
+        {
+            const u32 value = ((u32*)bytes)[x];
 
-    // 0x60006b50
-    void SelectRendererMaterial(const f32 r, const f32 g, const f32 b)
-    {
-        D3DMATERIAL material;
-        ZeroMemory(&material, sizeof(D3DMATERIAL));
+            h1 = ROTATE_LEFT(h1 + value * TEXTURE_HASH_PRIME_3, 17) * TEXTURE_HASH_PRIME_4;
+            h2 = ROTATE_LEFT(h2 ^ (value * TEXTURE_HASH_PRIME_2), 15) * TEXTURE_HASH_PRIME_1;
+        }
 
-        material.dwSize = sizeof(D3DMATERIAL);
+        for (u32 x = remainder & (~3); x < remainder; x++)
+        {
+            h1 = ROTATE_LEFT(h1 + bytes[x] * TEXTURE_HASH_PRIME_5, 11) * TEXTURE_HASH_PRIME_1;
+            h2 = (h2 ^ bytes[x]) * TEXTURE_HASH_PRIME_3;
+        }
 
-        material.diffuse.r = r;
-        material.diffuse.g = g;
-        material.diffuse.b = b;
+        h1 = h1 ^ (h1 >> 15);
+        h1 = h1 * TEXTURE_HASH_PRIME_2;
+        h1 = h1 ^ (h1 >> 13);
+        h1 = h1 * TEXTURE_HASH_PRIME_3;
+        h1 = h1 ^ (h1 >> 16);
 
-        material.ambient.r = r;
-        material.ambient.g = g;
-        material.ambient.b = b;
+        h2 = h2 + h1;
 
-        material.dwRampSize = 1;
+        h2 = h2 ^ (h2 >> 15);
+        h2 = h2 * TEXTURE_HASH_PRIME_2;
+        h2 = h2 ^ (h2 >> 13);
+        h2 = h2 * TEXTURE_HASH_PRIME_3;
+        h2 = h2 ^ (h2 >> 16);
 
-        State.DX.Material->SetMaterial(&material);
+        const u64 result = ((u64)h1 << 32) | (u64)h2;
+
+        return result == INVALID_TEXTURE_HASH ? (INVALID_TEXTURE_HASH + 1) : result;
     }
 
-    // 0x60004390
-    void SelectRendererDeviceType(const u32 type)
+    // Calculates the size of the pixels of the texture, as provided by the application.
+    u32 AcquireRendererTextureSize(RendererTexture* tex)
     {
-        RendererDeviceType = type;
+        return tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
+            ? tex->Descriptor.dwLinearSize : (tex->Descriptor.lPitch * tex->Descriptor.dwHeight);
     }
 
-    // 0x60004050
-    void SelectRendererFogAlphas(const u8* input, u8* output)
+    // Checks whether the device surface of the texture is shared with any other texture.
+    BOOL IsRendererTextureShared(RendererTexture* tex)
     {
-        if (input == NULL) { return; }
+        if (tex->Surface2 == NULL) { return FALSE; }
 
-        for (u32 x = 0; x < MAX_OUTPUT_FOG_ALPHA_COUNT; x++)
+        for (u32 indx = 0; indx < State.Textures.Active.Count; indx++)
         {
-            const f32 value = roundf(x / 255.0f) * 63.0f;
-            const u32 indx = (u32)value;
-
-            const f32 diff = value - indx;
-
-            if (0.0f < diff)
-            {
-                const u8 result = (u8)roundf(input[indx] + (input[indx + 1] - input[indx]) * diff);
-                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - result);
-            }
-            else
-            {
+            RendererTexture* x = State.Textures.Active.Textures[indx];
 
-                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - input[indx]);
-            }
+            if (x != tex && x->IsShareable && x->Surface2 == tex->Surface2) { return TRUE; }
         }
+
+        return FALSE;
     }
 
-    // 0x600053f0
-    u32 SelectBasicRendererState(const u32 state, void* value)
+    // Attempts to replace the device surface of the texture with the device surface of another texture of the same contents.
+    BOOL ShareRendererTexture(RendererTexture* tex, const u64 hash)
     {
-        switch (state)
-        {
-        case RENDERER_MODULE_STATE_SELECT_CULL_STATE:
+        if (!tex->IsShareable || tex->Surface2 == NULL) { return FALSE; }
+
+        for (u32 indx = 0; indx < State.Textures.Active.Count; indx++)
         {
-            switch ((u32)value)
+            RendererTexture* x = State.Textures.Active.Textures[indx];
+
+            if (x == tex || !x->IsShareable || x->PixelHash != hash) { continue; }
+
+            if (x->Surface2 == NULL || x->Texture2 == NULL) { continue; }
+
+            if (x->Width != tex->Width || x->Height != tex->Height
+                || x->FormatIndex != tex->FormatIndex || x->MipMapCount != tex->MipMapCount) { continue; }
+
+            if (x->Surface2 != tex->Surface2)
             {
-            case RENDERER_MODULE_CULL_NONE: { State.Settings.Cull = RENDERER_CULL_MODE_NONE; break; }
-            case RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE: { State.Settings.Cull = RENDERER_CULL_MODE_COUNTER_CLOCK_WISE; break; }
-            case RENDERER_MODULE_CULL_CLOCK_WISE: { State.Settings.Cull = RENDERER_CULL_MODE_CLOCK_WISE; break; }
-            default: { return RENDERER_MODULE_FAILURE; }
-            }
+                if (State.Scene.IsActive)
+                {
+                    AttemptRenderScene();
 
-            break;
-        }
-        case RENDERER_MODULE_STATE_SELECT_WINDOW_MODE_STATE:
-        case RENDERER_MODULE_STATE_SELECT_WINDOW:
-        case RENDERER_MODULE_STATE_SELECT_EXECUTE_LAMBDA:
-        case RENDERER_MODULE_STATE_SELECT_LOCK_WINDOW_LAMBDA: { break; }
-        case RENDERER_MODULE_STATE_SELECT_LAMBDAS:
-        {
-            const RendererModuleLambdaContainer* lambdas = (RendererModuleLambdaContainer*)value;
+                    State.DX.Device->SetRenderState(D3DRENDERSTATE_FLUSHBATCH, TRUE);
+                }
 
-            State.Lambdas.Log = lambdas == NULL ? NULL : lambdas->Log;
+                x->Surface2->AddRef();
+                x->Texture2->AddRef();
 
-            break;
-        }
-        case RENDERER_MODULE_STATE_SELECT_LOG_LAMBDA: { State.Lambdas.Log = (RENDERERMODULELOGLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_VERSION:
-        {
-            const u32 version = (u32)value;
+                tex->Texture2->Release();
+                tex->Surface2->Release();
 
-            if (version != RENDERER_MODULE_VERSION_104 && version != RENDERER_MODULE_VERSION_105) { return RENDERER_MODULE_FAILURE; }
+                tex->Surface2 = x->Surface2;
+                tex->Texture2 = x->Texture2;
+            }
 
-            RendererVersion = version;
+            tex->PixelHash = hash;
 
-            break;
+            return TRUE;
         }
-        case RENDERER_MODULE_STATE_SELECT_MEMORY_ALLOCATE_LAMBDA: { State.Lambdas.AllocateMemory = (RENDERERMODULEALLOCATEMEMORYLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_MEMORY_RELEASE_LAMBDA: { State.Lambdas.ReleaseMemory = (RENDERERMODULERELEASEMEMORYLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_SELECT_STATE_LAMBDA: { State.Lambdas.SelectState = (RENDERERMODULESELECTSTATELAMBDA)value; break; }
-        default: { return RENDERER_MODULE_FAILURE; }
+
+        return FALSE;
+    }
+
+    // Replaces the shared device surface of the texture with the device surface of its own.
+    // NOTE: The contents of the device surface are not preserved, since the whole texture is uploaded afterwards.
+    BOOL UnshareRendererTexture(RendererTexture* tex)
+    {
+        if (!IsRendererTextureShared(tex)) { return TRUE; }
+
+        IDirectDrawSurface4* s1 = tex->Surface1;
+        IDirect3DTexture2* t1 = tex->Texture1;
+        IDirectDrawSurface4* s2 = tex->Surface2;
+        IDirect3DTexture2* t2 = tex->Texture2;
+
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+
+            State.DX.Device->SetRenderState(D3DRENDERSTATE_FLUSHBATCH, TRUE);
         }
 
-        if (State.Lambdas.SelectState != NULL) { State.Lambdas.SelectState(state, value); }
+        // NOTE: The surfaces created before the failure are released by the initialization.
+        if (InitializeRendererTextureDetails(tex) != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
+        {
+            tex->Surface1 = s1;
+            tex->Texture1 = t1;
+            tex->Surface2 = s2;
+            tex->Texture2 = t2;
 
-        return RENDERER_MODULE_SUCCESS;
+            return FALSE;
+        }
+
+        t1->Release();
+        s1->Release();
+        t2->Release();
+        s2->Release();
+
+        return TRUE;
     }
 
-    // 0x60006b00
-    BOOL RestoreRendererSurfaces(void)
+    // Calculates the size of the device surface of the texture, the size is zero for the textures outside of the video memory.
+    u32 AcquireRendererTextureMemorySize(RendererTexture* tex)
     {
-        const HRESULT mr = State.DX.Active.Surfaces.Active.Main->Restore();
-        const HRESULT dr = State.DX.Active.Surfaces.Active.Depth->Restore();
+        if (!State.Device.Capabilities.IsAccelerated) { return 0; }
 
-        return RestoreRendererTextures() && mr == DD_OK && dr == DD_OK;
+        const TextureFormat* format = &State.Textures.Formats.Formats[tex->FormatIndex];
+
+        u32 result = 0;
+
+        u32 width = tex->Width;
+        u32 height = tex->Height;
+
+        // NOTE: The sizes of the generated mip map levels are included.
+        for (u32 x = 0; x < tex->MipMapCount; x++)
+        {
+            result = result + (format->IsDXT
+                ? (((width + 3) >> 2) * ((height + 3) >> 2) * 8)
+                : (((width * format->Descriptor.ddpfPixelFormat.dwRGBBitCount + 7) >> 3) * height));
+
+            width = 1 < width ? (width >> 1) : 1;
+            height = 1 < height ? (height >> 1) : 1;
+        }
+
+        return result;
     }
 
-    // 0x60004350
-    BOOL RestoreRendererTextures(void)
+    // Acquires the least recently used texture, which device surface can be evicted from the video memory.
+    // NOTE: The textures selected within the current frame, or still selected into the device, are never evicted.
+    RendererTexture* AcquireRendererTextureEviction(RendererTexture* keep)
     {
-        RendererTexture* tex = State.Textures.Current;
+        RendererTexture* result = NULL;
 
-        while (tex != NULL)
+        for (u32 indx = 0; indx < State.Textures.Active.Count; indx++)
         {
-            if (tex->Surface2 != NULL) { tex->Surface2->Restore(); }
+            RendererTexture* x = State.Textures.Active.Textures[indx];
+
+            if (x == keep || x == State.Textures.Selected || !x->IsEvictable || x->Size == 0) { continue; }
+
+            if (x->Surface2 == NULL || x->Backup != NULL) { continue; }
+
+            if (x->Frame == State.Textures.Frame) { continue; }
+
+            if (result != NULL && result->Frame <= x->Frame) { continue; }
+
+            if (IsRendererTextureShared(x)) { continue; }
+
+            result = x;
+        }
+
+        return result;
+    }
+
+    // Copies the device surface of the texture into the system memory, and releases the device surface.
+    BOOL EvictRendererTexture(RendererTexture* tex)
+    {
+        if (tex == NULL) { return FALSE; }
+
+        DDSURFACEDESC2 desc;
+        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+        desc.dwSize = sizeof(DDSURFACEDESC2);
 
-            tex = tex->Previous;
+        if (tex->Surface2->GetSurfaceDesc(&desc) != DD_OK) { return FALSE; }
+
+        desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+        desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
+        desc.ddsCaps.dwCaps2 = 0;
+
+        IDirectDrawSurface4* backup = NULL;
+
+        if (State.DX.Active.Instance->CreateSurface(&desc, &backup, NULL) != DD_OK) { return FALSE; }
+
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+
+            State.DX.Device->SetRenderState(D3DRENDERSTATE_FLUSHBATCH, TRUE);
         }
 
+        if (backup->Blt(NULL, tex->Surface2, NULL, DDBLT_WAIT, NULL) != DD_OK)
+        {
+            backup->Release();
+
+            return FALSE;
+        }
+
+        tex->Texture2->Release();
+        tex->Surface2->Release();
+
+        tex->Surface2 = NULL;
+        tex->Texture2 = NULL;
+
+        tex->Backup = backup;
+
+        State.Textures.Size = State.Textures.Size - tex->Size;
+
+        State.Textures.Statistics.Current.Evicted = State.Textures.Statistics.Current.Evicted + 1;
+
         return TRUE;
     }
 
-    // 0x600065a0
-    BOOL RenderLines(RTLVX* vertexes, const u32 count)
+    // Evicts the least recently used device surfaces, until the textures of the size fit into the available video memory.
+    void EvictRendererTextures(const u32 size, RendererTexture* keep)
     {
-        if (!State.Scene.IsActive)
+        while (State.Settings.MaxAvailableMemory < State.Textures.Size + size)
         {
-            BeginRendererScene();
+            if (!EvictRendererTexture(AcquireRendererTextureEviction(keep))) { return; }
+        }
+    }
 
-            State.Scene.IsActive = TRUE;
+    // Recreates the device surface of the evicted texture, and copies the system memory copy back into it.
+    BOOL ReloadRendererTexture(RendererTexture* tex)
+    {
+        if (tex->Backup == NULL) { return TRUE; }
+
+        EvictRendererTextures(tex->Size, tex);
+
+        IDirectDrawSurface4* s1 = tex->Surface1;
+        IDirect3DTexture2* t1 = tex->Texture1;
+        IDirectDrawPalette* palette = tex->Palette;
+
+        // NOTE: The surfaces created before the failure are released by the initialization.
+        while (InitializeRendererTextureDetails(tex) != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
+        {
+            tex->Surface1 = s1;
+            tex->Texture1 = t1;
+            tex->Surface2 = NULL;
+            tex->Texture2 = NULL;
+            tex->Palette = palette;
+
+            if (!EvictRendererTexture(AcquireRendererTextureEviction(tex))) { return FALSE; }
         }
 
-        for (u32 x = 0; x < count; x++)
+        // NOTE: The system memory surface of the texture is kept, along with its palette.
+        tex->Texture1->Release();
+        tex->Surface1->Release();
+
+        tex->Surface1 = s1;
+        tex->Texture1 = t1;
+
+        if (palette != NULL)
+        {
+            tex->Surface2->SetPalette(palette);
+
+            if (tex->Palette != NULL && tex->Palette != palette) { tex->Palette->Release(); }
+
+            tex->Palette = palette;
+        }
+
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+
+            State.DX.Device->SetRenderState(D3DRENDERSTATE_FLUSHBATCH, TRUE);
+        }
+
+        tex->Surface2->Blt(NULL, tex->Backup, NULL, DDBLT_WAIT, NULL);
+
+        // NOTE: The system memory copy holds the top level only, the mip map levels are generated from it again.
+        if (1 < tex->MipMapCount)
+        {
+            DDSURFACEDESC2 desc;
+            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+            desc.dwSize = sizeof(DDSURFACEDESC2);
+
+            if (tex->Backup->Lock(NULL, &desc, DDLOCK_WAIT | DDLOCK_READONLY, NULL) == DD_OK)
+            {
+                GenerateRendererTextureMipMaps(tex, desc.lpSurface, desc.lPitch);
+
+                tex->Backup->Unlock(NULL);
+            }
+        }
+
+        tex->Backup->Release();
+        tex->Backup = NULL;
+
+        State.Textures.Size = State.Textures.Size + tex->Size;
+
+        State.Textures.Statistics.Current.Reloaded = State.Textures.Statistics.Current.Reloaded + 1;
+
+        return TRUE;
+    }
+
+    // Acquires the filter of the mip map levels generated for the textures, the game never uploads the mip map levels on its own.
+    // NOTE: The environment variable, that disables the mip map levels in the original code, requests the generated levels instead.
+    u32 AcquireRendererTextureMipMapFilter(void)
+    {
+        if (SettingsState.TextureMipMaps != RENDERER_TEXTURE_MIP_MAP_FILTER_NONE)
+        {
+            return SettingsState.TextureMipMaps == RENDERER_TEXTURE_MIP_MAP_FILTER_GAMMA
+                ? RENDERER_TEXTURE_MIP_MAP_FILTER_GAMMA : RENDERER_TEXTURE_MIP_MAP_FILTER_BOX;
+        }
+
+        const char* value = getenv(RENDERER_MODULE_AUTO_MIP_MAP_ENVIRONMENT_PROPERTY_NAME);
+
+        return (value != NULL && atoi(value) != 0) ? RENDERER_TEXTURE_MIP_MAP_FILTER_BOX : RENDERER_TEXTURE_MIP_MAP_FILTER_NONE;
+    }
+
+    // Acquires the number of the mip map levels of the texture, down to the single pixel, or one for the textures without the generated levels.
+    u32 AcquireRendererTextureMipMapCount(RendererTexture* tex)
+    {
+        if (tex->IsPalette || tex->FormatIndex == INVALID_TEXTURE_FORMAT_INDEX) { return 1; }
+
+        if (AcquireRendererTextureMipMapFilter() == RENDERER_TEXTURE_MIP_MAP_FILTER_NONE) { return 1; }
+
+        const TextureFormat* format = &State.Textures.Formats.Formats[tex->FormatIndex];
+
+        if (format->IsDXT || format->IsPalette || !IsRendererTextureMipMapFormat(&format->Descriptor.ddpfPixelFormat)) { return 1; }
+
+        u32 result = 1;
+
+        u32 width = tex->Width;
+        u32 height = tex->Height;
+
+        while (1 < width || 1 < height)
+        {
+            width = 1 < width ? (width >> 1) : 1;
+            height = 1 < height ? (height >> 1) : 1;
+
+            result = result + 1;
+        }
+
+        return result;
+    }
+
+    // Checks whether the mip map levels can be generated for the pixel format, which is either 16-bit RGB, or 32-bit RGB with 8-bit channels.
+    BOOL IsRendererTextureMipMapFormat(const DDPIXELFORMAT* format)
+    {
+        if (!(format->dwFlags & DDPF_RGB) || (format->dwFlags & (DDPF_FOURCC | DDPF_PALETTEINDEXED8))) { return FALSE; }
+
+        if (format->dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_16) { return TRUE; }
+
+        return format->dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_32
+            && format->dwRBitMask == 0x00FF0000 && format->dwGBitMask == 0x0000FF00 && format->dwBBitMask == 0x000000FF;
+    }
+
+    // Generates the mip map levels of the device surface of the texture, by filtering each level from the one above it.
+    // NOTE: The levels are filtered within the staging buffer, and written into the attached surfaces of the device surface,
+    // so the device surface is never read back.
+    BOOL GenerateRendererTextureMipMaps(RendererTexture* tex, const void* pixels, const u32 pitch)
+    {
+        if (tex->MipMapCount < 2 || tex->Surface2 == NULL || pixels == NULL) { return TRUE; }
+
+        const DDPIXELFORMAT* format = &tex->Descriptor.ddpfPixelFormat;
+
+        if (!IsRendererTextureMipMapFormat(format)) { return FALSE; }
+
+        const RendererMipMapGamma* gamma = NULL;
+
+        if (AcquireRendererTextureMipMapFilter() == RENDERER_TEXTURE_MIP_MAP_FILTER_GAMMA)
+        {
+            InitializeRendererTextureMipMapGamma(&State.Textures.MipMaps.Gamma);
+
+            gamma = &State.Textures.MipMaps.Gamma;
+        }
+
+        const u32 channels[MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT] =
+        {
+            format->dwRBitMask, format->dwGBitMask, format->dwBBitMask,
+            (format->dwFlags & DDPF_ALPHAPIXELS) ? format->dwRGBAlphaBitMask : 0
+        };
+
+        const u32 bytes = format->dwRGBBitCount >> 3;
+
+        // NOTE: The staging buffer consists of two halves of the size of the second level, the levels alternate between them.
+        const u32 size = (1 < tex->Width ? (tex->Width >> 1) : 1) * (1 < tex->Height ? (tex->Height >> 1) : 1) * bytes;
+
+        if (State.Textures.MipMaps.Staging.Size < size * 2)
+        {
+            u8* staging = (u8*)realloc(State.Textures.MipMaps.Staging.Pixels, size * 2);
+
+            if (staging == NULL) { return FALSE; }
+
+            State.Textures.MipMaps.Staging.Pixels = staging;
+            State.Textures.MipMaps.Staging.Size = size * 2;
+        }
+
+        const u8* src = (u8*)pixels;
+        u32 stride = pitch;
+
+        u32 width = tex->Width;
+        u32 height = tex->Height;
+
+        IDirectDrawSurface4* surface = tex->Surface2;
+
+        BOOL result = TRUE;
+
+        for (u32 x = 1; x < tex->MipMapCount; x++)
         {
-            if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertexes[x].Color = GRAPCHICS_COLOR_WHITE; }
+            u8* dst = (u8*)((addr)State.Textures.MipMaps.Staging.Pixels + (addr)((x & 1) * size));
+
+            if (format->dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_16) { FilterRendererTextureMipMap16(channels, gamma, src, stride, width, height, dst); }
+            else { FilterRendererTextureMipMap32(gamma, src, stride, width, height, dst); }
+
+            width = 1 < width ? (width >> 1) : 1;
+            height = 1 < height ? (height >> 1) : 1;
+
+            src = dst;
+            stride = width * bytes;
+
+            DDSCAPS2 caps;
+            ZeroMemory(&caps, sizeof(DDSCAPS2));
+
+            caps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP;
+
+            IDirectDrawSurface4* level = NULL;
+
+            if (surface->GetAttachedSurface(&caps, &level) != DD_OK) { result = FALSE; break; }
+
+            if (surface != tex->Surface2) { surface->Release(); }
+
+            surface = level;
+
+            DDSURFACEDESC2 desc;
+            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+            desc.dwSize = sizeof(DDSURFACEDESC2);
+
+            if (surface->Lock(NULL, &desc, DDLOCK_WAIT | DDLOCK_WRITEONLY, NULL) != DD_OK) { result = FALSE; break; }
 
-            if (State.Settings.IsFogActive)
+            for (u32 xx = 0; xx < height; xx++)
             {
-                vertexes[x].Specular = ((u32)RendererFogAlphas[(u32)roundf(vertexes[x].XYZ.Z * 255.0f + 0.5f)]) << 24;
+                CopyMemory((void*)((addr)desc.lpSurface + (addr)(xx * desc.lPitch)), (void*)((addr)src + (addr)(xx * stride)), stride);
             }
 
-            vertexes[x].XYZ.Z = RendererDepthBias + vertexes[x].XYZ.Z;
+            surface->Unlock(NULL);
         }
 
-        InitializeVertexes((RVX*)vertexes, count);
+        if (surface != tex->Surface2) { surface->Release(); }
 
-        return State.DX.Device->DrawPrimitive(D3DPT_LINESTRIP, D3DFVF_TLVERTEX,
-            vertexes, count, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP) == DD_OK;
+        return result;
     }
 
-    // 0x60006720
-    BOOL RenderPoints(RTLVX* vertexes, const u32 count)
+    // Releases the staging buffer of the generated mip map levels.
+    void ReleaseRendererTextureMipMaps(void)
     {
+        if (State.Textures.MipMaps.Staging.Pixels != NULL)
+        {
+            free(State.Textures.MipMaps.Staging.Pixels);
+
+            State.Textures.MipMaps.Staging.Pixels = NULL;
+        }
+
+        State.Textures.MipMaps.Staging.Size = 0;
+    }
+
+    // 0x60006950
+    BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value)
+    {
+        if (type < MAX_RENDER_STATE_COUNT)
+        {
+            if (State.Shadow.States.IsValid[type] && State.Shadow.States.Values[type] == value)
+            {
+                State.Shadow.Filtered = State.Shadow.Filtered + 1;
+
+                return TRUE;
+            }
+
+            State.Shadow.States.IsValid[type] = TRUE;
+            State.Shadow.States.Values[type] = value;
+        }
+
         if (!State.Scene.IsActive)
         {
             BeginRendererScene();
@@ -2277,107 +2953,231 @@ namespace RendererModule
             State.Scene.IsActive = TRUE;
         }
 
-        for (u32 x = 0; x < count; x++)
-        {
-            if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertexes[x].Color = GRAPCHICS_COLOR_WHITE; }
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        const BOOL result = State.DX.Device->SetRenderState(type, value) == DD_OK;
+
+        if (!result && type < MAX_RENDER_STATE_COUNT) { State.Shadow.States.IsValid[type] = FALSE; }
 
-            if (State.Settings.IsFogActive)
+        return result;
+    }
+
+    // 0x60006900
+    BOOL SelectRendererTextureStage(const DWORD stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value)
+    {
+        if (stage < MAX_TEXTURE_STAGE_COUNT && type < MAX_TEXTURE_STAGE_STATE_COUNT)
+        {
+            if (State.Shadow.Stages.IsValid[stage][type] && State.Shadow.Stages.Values[stage][type] == value)
             {
-                vertexes[x].Specular = ((u32)RendererFogAlphas[(u32)roundf(vertexes[x].XYZ.Z * 255.0f + 0.5f)]) << 24;
+                State.Shadow.Filtered = State.Shadow.Filtered + 1;
+
+                return TRUE;
             }
 
-            vertexes[x].XYZ.Z = RendererDepthBias + vertexes[x].XYZ.Z;
+            State.Shadow.Stages.IsValid[stage][type] = TRUE;
+            State.Shadow.Stages.Values[stage][type] = value;
         }
 
-        InitializeVertexes((RVX*)vertexes, count);
+        if (!State.Scene.IsActive)
+        {
+            BeginRendererScene();
 
-        return State.DX.Device->DrawPrimitive(D3DPT_POINTLIST, D3DFVF_TLVERTEX,
-            vertexes, count, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP) == DD_OK;
+            State.Scene.IsActive = TRUE;
+        }
+
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        const BOOL result = State.DX.Device->SetTextureStageState(stage, type, value) == DD_OK;
+
+        if (!result && stage < MAX_TEXTURE_STAGE_COUNT && type < MAX_TEXTURE_STAGE_STATE_COUNT) { State.Shadow.Stages.IsValid[stage][type] = FALSE; }
+
+        return result;
     }
 
-    // 0x60005f90
-    void RenderQuad(RTLVX* a, RTLVX* b, RTLVX* c, RTLVX* d)
+    // 0x60006b50
+    void SelectRendererMaterial(const f32 r, const f32 g, const f32 b)
     {
-        if (MaximumRendererVertexCount - 4 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+        D3DMATERIAL material;
+        ZeroMemory(&material, sizeof(D3DMATERIAL));
 
-        // A
-        {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 0];
+        material.dwSize = sizeof(D3DMATERIAL);
 
-            vertex->XYZ.X = a->XYZ.X;
-            vertex->XYZ.Y = a->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + a->XYZ.Z;
+        material.diffuse.r = r;
+        material.diffuse.g = g;
+        material.diffuse.b = b;
 
-            vertex->RHW = a->RHW;
+        material.ambient.r = r;
+        material.ambient.g = g;
+        material.ambient.b = b;
 
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : a->Color;
+        material.dwRampSize = 1;
 
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - a->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : a->Specular;
+        State.DX.Material->SetMaterial(&material);
+    }
 
-            vertex->UV.X = a->UV.X;
-            vertex->UV.Y = a->UV.Y;
+    // 0x60004390
+    void SelectRendererDeviceType(const u32 type)
+    {
+        RendererDeviceType = type;
+    }
+
+    // 0x60004050
+    void SelectRendererFogAlphas(const u8* input, u8* output)
+    {
+        if (input == NULL) { return; }
+
+        for (u32 x = 0; x < MAX_OUTPUT_FOG_ALPHA_COUNT; x++)
+        {
+            const f32 value = roundf(x / 255.0f) * 63.0f;
+            const u32 indx = (u32)value;
+
+            const f32 diff = value - indx;
+
+            if (0.0f < diff)
+            {
+                const u8 result = (u8)roundf(input[indx] + (input[indx + 1] - input[indx]) * diff);
+                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - result);
+            }
+            else
+            {
+
+                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - input[indx]);
+            }
         }
+    }
 
-        // B
+    // 0x600053f0
+    u32 SelectBasicRendererState(const u32 state, void* value)
+    {
+        switch (state)
+        {
+        case RENDERER_MODULE_STATE_SELECT_CULL_STATE:
         {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 1];
+            switch ((u32)value)
+            {
+            case RENDERER_MODULE_CULL_NONE: { State.Settings.Cull = RENDERER_CULL_MODE_NONE; break; }
+            case RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE: { State.Settings.Cull = RENDERER_CULL_MODE_COUNTER_CLOCK_WISE; break; }
+            case RENDERER_MODULE_CULL_CLOCK_WISE: { State.Settings.Cull = RENDERER_CULL_MODE_CLOCK_WISE; break; }
+            default: { return RENDERER_MODULE_FAILURE; }
+            }
 
-            vertex->XYZ.X = b->XYZ.X;
-            vertex->XYZ.Y = b->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + b->XYZ.Z;
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_WINDOW_MODE_STATE:
+        case RENDERER_MODULE_STATE_SELECT_WINDOW:
+        case RENDERER_MODULE_STATE_SELECT_EXECUTE_LAMBDA:
+        case RENDERER_MODULE_STATE_SELECT_LOCK_WINDOW_LAMBDA: { break; }
+        case RENDERER_MODULE_STATE_SELECT_LAMBDAS:
+        {
+            const RendererModuleLambdaContainer* lambdas = (RendererModuleLambdaContainer*)value;
 
-            vertex->RHW = b->RHW;
+            State.Lambdas.Log = lambdas == NULL ? NULL : lambdas->Log;
 
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : b->Color;
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_LOG_LAMBDA: { State.Lambdas.Log = (RENDERERMODULELOGLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_VERSION:
+        {
+            const u32 version = (u32)value;
 
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - b->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : b->Specular;
+            if (version != RENDERER_MODULE_VERSION_104 && version != RENDERER_MODULE_VERSION_105) { return RENDERER_MODULE_FAILURE; }
 
-            vertex->UV.X = b->UV.X;
-            vertex->UV.Y = b->UV.Y;
+            RendererVersion = version;
+
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_MEMORY_ALLOCATE_LAMBDA: { State.Lambdas.AllocateMemory = (RENDERERMODULEALLOCATEMEMORYLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_MEMORY_RELEASE_LAMBDA: { State.Lambdas.ReleaseMemory = (RENDERERMODULERELEASEMEMORYLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_SELECT_STATE_LAMBDA: { State.Lambdas.SelectState = (RENDERERMODULESELECTSTATELAMBDA)value; break; }
+        default: { return RENDERER_MODULE_FAILURE; }
         }
 
-        // C
+        if (State.Lambdas.SelectState != NULL) { State.Lambdas.SelectState(state, value); }
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60006b00
+    BOOL RestoreRendererSurfaces(void)
+    {
+        const HRESULT mr = State.DX.Active.Surfaces.Active.Main->Restore();
+        const HRESULT dr = State.DX.Active.Surfaces.Active.Depth->Restore();
+
+        return RestoreRendererTextures() && mr == DD_OK && dr == DD_OK;
+    }
+
+    // 0x60004350
+    BOOL RestoreRendererTextures(void)
+    {
+        for (u32 x = 0; x < State.Textures.Active.Count; x++)
         {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 2];
+            RendererTexture* tex = State.Textures.Active.Textures[x];
 
-            vertex->XYZ.X = c->XYZ.X;
-            vertex->XYZ.Y = c->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + c->XYZ.Z;
+            if (tex->Surface2 != NULL) { tex->Surface2->Restore(); }
 
-            vertex->RHW = c->RHW;
+            // NOTE: The contents of the restored surfaces are lost.
+            tex->PixelHash = INVALID_TEXTURE_HASH;
+            tex->PaletteHash = INVALID_TEXTURE_HASH;
+        }
 
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : c->Color;
+        return TRUE;
+    }
 
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - c->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : c->Specular;
+    // 0x600065a0
+    BOOL RenderLines(RTLVX* vertexes, const u32 count)
+    {
+        if (!State.Scene.IsActive)
+        {
+            BeginRendererScene();
 
-            vertex->UV.X = c->UV.X;
-            vertex->UV.Y = c->UV.Y;
+            State.Scene.IsActive = TRUE;
         }
 
-        // D
+        UpdateVertexes(vertexes, count, State.Data.Vertexes.Transforms);
+
+        return State.DX.Device->DrawPrimitive(D3DPT_LINESTRIP, D3DFVF_TLVERTEX,
+            vertexes, count, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP) == DD_OK;
+    }
+
+    // 0x60006720
+    BOOL RenderPoints(RTLVX* vertexes, const u32 count)
+    {
+        if (!State.Scene.IsActive)
         {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 3];
+            BeginRendererScene();
 
-            vertex->XYZ.X = d->XYZ.X;
-            vertex->XYZ.Y = d->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + d->XYZ.Z;
+            State.Scene.IsActive = TRUE;
+        }
 
-            vertex->RHW = d->RHW;
+        UpdateVertexes(vertexes, count, State.Data.Vertexes.Transforms);
 
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : d->Color;
+        return State.DX.Device->DrawPrimitive(D3DPT_POINTLIST, D3DFVF_TLVERTEX,
+            vertexes, count, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP) == DD_OK;
+    }
+
+    // 0x60005f90
+    void RenderQuad(RTLVX* a, RTLVX* b, RTLVX* c, RTLVX* d)
+    {
+        if (MaximumRendererVertexCount - 4 < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - d->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : d->Specular;
+        // A
+        {
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 0], a);
+        }
 
-            vertex->UV.X = d->UV.X;
-            vertex->UV.Y = d->UV.Y;
+        // B
+        {
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 1], b);
+        }
+
+        // C
+        {
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 2], c);
+        }
+
+        // D
+        {
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 3], d);
         }
 
         State.Data.Indexes.Medium[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
@@ -2414,66 +3214,21 @@ namespace RendererModule
 
         // A
         {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 0];
-
-            vertex->XYZ.X = a->XYZ.X;
-            vertex->XYZ.Y = a->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + a->XYZ.Z;
-
-            vertex->RHW = a->RHW;
-
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : a->Color;
-
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - a->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : a->Specular;
-
-            vertex->UV.X = a->UV.X;
-            vertex->UV.Y = a->UV.Y;
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 0], a);
 
             State.Data.Indexes.Medium[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
         }
 
         // B
         {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 1];
-
-            vertex->XYZ.X = b->XYZ.X;
-            vertex->XYZ.Y = b->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + b->XYZ.Z;
-
-            vertex->RHW = b->RHW;
-
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : b->Color;
-
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - b->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : b->Specular;
-
-            vertex->UV.X = b->UV.X;
-            vertex->UV.Y = b->UV.Y;
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 1], b);
 
             State.Data.Indexes.Medium[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
         }
 
         // C
         {
-            RTLVX* vertex = &State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 2];
-
-            vertex->XYZ.X = c->XYZ.X;
-            vertex->XYZ.Y = c->XYZ.Y;
-            vertex->XYZ.Z = RendererDepthBias + c->XYZ.Z;
-
-            vertex->RHW = c->RHW;
-
-            vertex->Color = RendererShadeMode == RENDERER_MODULE_SHADE_FLAT ? GRAPCHICS_COLOR_WHITE : c->Color;
-
-            vertex->Specular = State.Settings.IsFogActive
-                ? ((u32)RendererFogAlphas[(u32)roundf((1.0f - c->RHW * 0.000015259022f) * 255.0f + 0.5f)]) << 24
-                : c->Specular;
-
-            vertex->UV.X = c->UV.X;
-            vertex->UV.Y = c->UV.Y;
+            InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + 2], c);
 
             State.Data.Indexes.Medium[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
         }
@@ -2485,34 +3240,9 @@ namespace RendererModule
     // 0x60006400
     BOOL RenderTriangleFans(RTLVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes)
     {
-        for (u32 x = 0; x < indexCount; x++) { State.Data.Indexes.Large[x] = indexes[x]; }
-
-        if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT || State.Settings.IsFogActive || RendererDepthBias != 0.0f)
-        {
-            for (u32 x = 0; x < vertexCount; x++)
-            {
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertexes[x].Color = GRAPCHICS_COLOR_WHITE; }
-
-                if (State.Settings.IsFogActive)
-                {
-                    vertexes[x].Specular = ((u32)RendererFogAlphas[(u32)roundf(vertexes[x].XYZ.Z * 255.0f + 0.5f)]) << 24;
-                }
+        AppendRendererTriangles(D3DPT_TRIANGLEFAN, indexCount, vertexes, indexes);
 
-                vertexes[x].XYZ.Z = RendererDepthBias + vertexes[x].XYZ.Z;
-            }
-        }
-
-        if (!State.Scene.IsActive)
-        {
-            BeginRendererScene();
-
-            State.Scene.IsActive = TRUE;
-        }
-
-        InitializeVertexes((RVX*)vertexes, vertexCount);
-
-        return State.DX.Device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, D3DFVF_TLVERTEX,
-            vertexes, vertexCount, State.Data.Indexes.Large, indexCount, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP) == DD_OK;
+        return TRUE;
     }
 
     // 0x60005960
@@ -2533,40 +3263,78 @@ namespace RendererModule
     // 0x60006240
     BOOL RenderTriangleStrips(RTLVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes)
     {
-        u32 max = 0;
+        AppendRendererTriangles(D3DPT_TRIANGLESTRIP, indexCount, vertexes, indexes);
 
-        for (u32 x = 0; x < indexCount + 2; x++)
-        {
-            State.Data.Indexes.Large[x] = indexes[x];
+        return TRUE;
+    }
 
-            if (max < indexes[x]) { max = indexes[x]; }
-        }
+    // Appends the triangle strip or fan to the current batch as an indexed triangle list.
+    // The odd triangles of a strip have their winding order reversed, same as the device does.
+    void AppendRendererTriangles(const D3DPRIMITIVETYPE type, const u32 count, RTLVX* vertexes, const u32* indexes)
+    {
+        u32 x = 0;
 
-        if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT || State.Settings.IsFogActive || RendererDepthBias != 0.0f)
+        while (x < count)
         {
-            for (u32 x = 0; x < vertexCount; x++)
+            u32 length = AcquireRendererTriangleCount(count - x);
+
+            if (length < count - x && State.Data.Vertexes.Count != 0)
+            {
+                RendererRenderScene();
+
+                length = AcquireRendererTriangleCount(count - x);
+            }
+
+            for (u32 xx = 0; xx < length + 2; xx++)
             {
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertexes[x].Color = GRAPCHICS_COLOR_WHITE; }
+                const u32 position = (type == D3DPT_TRIANGLEFAN && xx == 0) ? 0 : (x + xx);
+
+                InitializeVertex(&State.Data.Vertexes.Vertexes[State.Data.Vertexes.Count + xx],
+                    &vertexes[indexes == NULL ? position : indexes[position]]);
+            }
 
-                if (State.Settings.IsFogActive)
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                u16* values = &State.Data.Indexes.Medium[State.Data.Indexes.Count + xx * 3];
+
+                const u16 indx = (u16)(State.Data.Vertexes.Count + xx);
+
+                if (type == D3DPT_TRIANGLEFAN)
                 {
-                    vertexes[x].Specular = ((u32)RendererFogAlphas[(u32)roundf(vertexes[x].XYZ.Z * 255.0f + 0.5f)]) << 24;
+                    values[0] = (u16)State.Data.Vertexes.Count;
+                    values[1] = indx + 1;
+                    values[2] = indx + 2;
+                }
+                else if (((x + xx) & 1) == 0)
+                {
+                    values[0] = indx + 0;
+                    values[1] = indx + 1;
+                    values[2] = indx + 2;
+                }
+                else
+                {
+                    values[0] = indx + 0;
+                    values[1] = indx + 2;
+                    values[2] = indx + 1;
                 }
-
-                vertexes[x].XYZ.Z = RendererDepthBias + vertexes[x].XYZ.Z;
             }
-        }
 
-        if (!State.Scene.IsActive)
-        {
-            BeginRendererScene();
+            State.Data.Indexes.Count = State.Data.Indexes.Count + length * 3;
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + length + 2;
 
-            State.Scene.IsActive = TRUE;
+            x = x + length;
         }
+    }
+
+    // Acquires the number of the triangles of a strip or a fan that fit into the current batch.
+    u32 AcquireRendererTriangleCount(const u32 count)
+    {
+        const u32 vertexes = (State.Data.Vertexes.Count + 2) < MaximumRendererVertexCount
+            ? MaximumRendererVertexCount - (State.Data.Vertexes.Count + 2) : 0;
+        const u32 indexes = (MAX_MEDIUM_INDEX_COUNT - State.Data.Indexes.Count) / 3;
 
-        InitializeVertexes((RVX*)vertexes, max + 1);
+        const u32 result = vertexes < indexes ? vertexes : indexes;
 
-        return State.DX.Device->DrawIndexedPrimitive(D3DPT_TRIANGLESTRIP, D3DFVF_TLVERTEX,
-            vertexes, max + 1, State.Data.Indexes.Large, indexCount + 2, D3DDP_DONOTUPDATEEXTENTS | D3DDP_DONOTCLIP) == DD_OK;
+        return count < result ? count : result;
     }
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ SOFTWARE.
 #endif
 
 #include "DirectDraw.hxx"
+#include "RendererMipMaps.hxx"
 
 #define DEFAULT_FOG_COLOR 0x00FFFFFF
 #define DEFAULT_FOG_DINSITY (0.5f)
@@ -36,6 +37,8 @@ SOFTWARE.
 #define DEFAULT_FOG_START (0.0f)
 #define INVALID_TEXTURE_FORMAT_COUNT (-1)
 #define INVALID_TEXTURE_FORMAT_INDEX (-1)
+#define INVALID_TEXTURE_HASH 0
+#define INVALID_TEXTURE_POOL_INDEX (-1)
 #define MAX_ACTIVE_SURFACE_COUNT 8
 #define MAX_ACTIVE_UNKNOWN_COUNT 4
 #define MAX_ACTIVE_USABLE_TEXTURE_FORMAT_COUNT 12
@@ -46,18 +49,35 @@ SOFTWARE.
 #define MAX_MEDIUM_INDEX_COUNT 8096
 #define MAX_OUTPUT_FOG_ALPHA_COUNT 256
 #define MAX_OUTPUT_FOG_ALPHA_VALUE 255
+#define MAX_RENDER_STATE_COUNT 256
 #define MAX_SMALL_INDEX_COUNT 256
 #define MAX_TEXTURE_FORMAT_COUNT 128 /* ORIGINAL: 100 */
 #define MAX_TEXTURE_PALETTE_COLOR_COUNT 256
+#define MAX_TEXTURE_POOL_SLAB_COUNT 64
+#define MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT 256
+#define MAX_TEXTURE_STAGE_COUNT 8
+#define MAX_TEXTURE_STAGE_STATE_COUNT 32
 #define MAX_UNKNOWN_COUNT (MAX_ACTIVE_UNKNOWN_COUNT + 2)
 #define MAX_USABLE_TEXTURE_FORMAT_COUNT (MAX_ACTIVE_USABLE_TEXTURE_FORMAT_COUNT + 2)
 #define MAX_VERTEX_COUNT 253
+#define MIN_ACTIVE_TEXTURE_CAPACITY 256
 #define MIN_DEVICE_AVAIABLE_VIDEO_MEMORY (16 * 1024 * 1024) /* ORIGINAL: 0x200000 (2 MB) */
 
 #define RENDERER_CULL_MODE_CLOCK_WISE           0x00000000
 #define RENDERER_CULL_MODE_NONE                 0x00000001
 #define RENDERER_CULL_MODE_COUNTER_CLOCK_WISE   0x80000000
 
+#define RENDERER_VERTEX_TRANSFORM_NONE          0x00000000
+#define RENDERER_VERTEX_TRANSFORM_COLOR         0x00000001
+#define RENDERER_VERTEX_TRANSFORM_FOG           0x00000002
+#define RENDERER_VERTEX_TRANSFORM_FOG_RHW       0x00000004
+#define RENDERER_VERTEX_TRANSFORM_DEPTH         0x00000008
+#define RENDERER_VERTEX_TRANSFORM_OFFSET        0x00000010
+
+#define RENDERER_TEXTURE_MIP_MAP_FILTER_NONE    0
+#define RENDERER_TEXTURE_MIP_MAP_FILTER_BOX     1
+#define RENDERER_TEXTURE_MIP_MAP_FILTER_GAMMA   2
+
 #define RENDERER_INITIALIZE_TEXTURE_DETAILS_OK      1
 #define RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR   0
 #define RENDERER_INITIALIZE_TEXTURE_DETAILS_INVALID (-1)
@@ -72,6 +92,11 @@ inline void LOGMESSAGE(...) { }
 #define LOGMESSAGE(...) Message(RENDERER_MODULE_MESSAGE_SEVERITY_MESSAGE, __VA_ARGS__)
 #endif
 
+#if !defined(__WATCOMC__) && _MSC_VER > 1200
+#define RENDERER_MODULE_SIMD
+#include <emmintrin.h>
+#endif
+
 namespace Renderer
 {
     struct RendererTexture
@@ -83,7 +108,6 @@ namespace Renderer
         s32 FormatIndexValue; // TODO
         BOOL IsPalette;
         u32 MipMapCount;
-        RendererTexture* Previous;
         u32 MemoryType;
         BOOL Is16Bit;
         IDirectDrawSurface4* Surface1;
@@ -93,6 +117,19 @@ namespace Renderer
         IDirectDrawPalette* Palette;
         DDSURFACEDESC2 Descriptor;
         u32 Colors;
+
+        BOOL IsShareable; // NOTE: The device surface can be shared with the other textures of the same contents.
+        u64 PixelHash;
+        u64 PaletteHash;
+
+        BOOL IsEvictable; // NOTE: The device surface can be evicted from the video memory.
+        u32 Frame; // NOTE: The frame the texture was last selected within.
+        u32 Size; // NOTE: The size of the device surface in the video memory.
+        IDirectDrawSurface4* Backup; // NOTE: The system memory copy of the evicted device surface.
+
+        s32 PoolIndex; // NOTE: The index of the record within the pool of the textures, or INVALID_TEXTURE_POOL_INDEX.
+        s32 PoolNext; // NOTE: The index of the next free record within the pool of the textures.
+        u32 ActiveIndex; // NOTE: The index of the texture within the dense array of the active textures.
     };
 }
 
@@ -113,6 +150,14 @@ namespace RendererModule
         u32 DXT;
     };
 
+    struct RendererTextureStatistics
+    {
+        u32 Uploads;
+        u32 Skipped;
+        u32 Evicted;
+        u32 Reloaded;
+    };
+
     struct RendererModuleState
     {
         struct
@@ -175,6 +220,9 @@ namespace RendererModule
             {
                 u32 Count; // 0x6001afc0
                 Renderer::RTLVX Vertexes[MAX_VERTEX_COUNT]; // 0x600150e0
+
+                u32 Processed;
+                u32 Transforms;
             } Vertexes;
         } Data;
 
@@ -240,6 +288,23 @@ namespace RendererModule
             BOOL IsActive; // 0x6001434c
         } Scene;
 
+        struct
+        {
+            struct
+            {
+                BOOL IsValid[MAX_RENDER_STATE_COUNT];
+                DWORD Values[MAX_RENDER_STATE_COUNT];
+            } States;
+
+            struct
+            {
+                BOOL IsValid[MAX_TEXTURE_STAGE_COUNT][MAX_TEXTURE_STAGE_STATE_COUNT];
+                DWORD Values[MAX_TEXTURE_STAGE_COUNT][MAX_TEXTURE_STAGE_STATE_COUNT];
+            } Stages;
+
+            u32 Filtered;
+        } Shadow;
+
         struct
         {
             BOOL IsWindowModeActive; // 0x60014b68
@@ -258,8 +323,6 @@ namespace RendererModule
 
         struct
         {
-            Renderer::RendererTexture* Current; // 0x60014b6c
-
             BOOL Illegal; // 0x60014b70
 
             struct
@@ -270,6 +333,44 @@ namespace RendererModule
 
                 TextureFormat Formats[MAX_TEXTURE_FORMAT_COUNT]; // 0x6003d188
             } Formats;
+
+            Renderer::RendererTexture* Selected;
+
+            u32 Frame;
+            u32 Size; // NOTE: The size of the device surfaces in the video memory.
+
+            struct
+            {
+                u32 Count;
+                Renderer::RendererTexture* Slabs[MAX_TEXTURE_POOL_SLAB_COUNT];
+
+                s32 Free;
+                u32 Available;
+            } Pool;
+
+            struct
+            {
+                u32 Count;
+                u32 Capacity;
+                Renderer::RendererTexture** Textures;
+            } Active;
+
+            struct
+            {
+                RendererTextureStatistics Current;
+                RendererTextureStatistics Previous;
+            } Statistics;
+
+            struct
+            {
+                struct
+                {
+                    u32 Size;
+                    u8* Pixels;
+                } Staging; // NOTE: The two halves hold the last two generated levels.
+
+                RendererMipMapGamma Gamma;
+            } MipMaps;
         } Textures;
 
         struct
@@ -296,9 +397,15 @@ namespace RendererModule
     BOOL AcquireRendererDeviceDepthBufferRemovalCapabilities(void);
     BOOL AcquireRendererDeviceState(void);
     BOOL AcquireRendererDeviceTrilinearInterpolationCapabilities(void);
+    BOOL AttachRendererTexture(Renderer::RendererTexture* tex);
     BOOL BeginRendererScene(void);
     BOOL CALLBACK EnumerateRendererDevices(GUID* uid, LPSTR name, LPSTR description, LPVOID context);
+    BOOL EvictRendererTexture(Renderer::RendererTexture* tex);
+    BOOL GenerateRendererTextureMipMaps(Renderer::RendererTexture* tex, const void* pixels, const u32 pitch);
     BOOL InitializeRendererDeviceDepthSurfaces(const u32 width, const u32 height);
+    BOOL IsRendererTextureMipMapFormat(const DDPIXELFORMAT* format);
+    BOOL IsRendererTextureShared(Renderer::RendererTexture* tex);
+    BOOL ReloadRendererTexture(Renderer::RendererTexture* tex);
     BOOL RenderLines(Renderer::RTLVX* vertexes, const u32 count);
     BOOL RenderPoints(Renderer::RTLVX* vertexes, const u32 count);
     BOOL RenderTriangleFans(Renderer::RTLVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes);
@@ -308,17 +415,27 @@ namespace RendererModule
     BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value);
     BOOL SelectRendererTexture(Renderer::RendererTexture* tex);
     BOOL SelectRendererTextureStage(const DWORD stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value);
+    BOOL ShareRendererTexture(Renderer::RendererTexture* tex, const u64 hash);
+    BOOL UnshareRendererTexture(Renderer::RendererTexture* tex);
     BOOL UpdateRendererTexture(Renderer::RendererTexture* tex, const u32* pixels, const u32* palette);
     HRESULT CALLBACK EnumerateRendererDeviceModes(LPDDSURFACEDESC2 desc, LPVOID context);
     HRESULT CALLBACK EnumerateRendererDevicePixelFormats(LPDDPIXELFORMAT format, LPVOID context);
     HRESULT CALLBACK EnumerateRendererDeviceTextureFormats(LPDDPIXELFORMAT format, LPVOID context);
+    inline u32 AcquireFogAlphaIndex(const f32 value) { const f32 result = roundf(value * 255.0f + 0.5f); return 0.0f < result ? (result < MAX_OUTPUT_FOG_ALPHA_VALUE ? (u32)result : MAX_OUTPUT_FOG_ALPHA_VALUE) : 0; }
     inline u32 AcquireNormal(const f32x3* a, const f32x3* b, const f32x3* c) { const s32 value = (s32)((b->X - a->X) * (c->Y - a->Y) - (c->X - a->X) * (b->Y - a->Y)); return *(u32*)&value; }
+    Renderer::RendererTexture* AcquireRendererTextureEviction(Renderer::RendererTexture* keep);
+    Renderer::RendererTexture* AcquireRendererTexturePoolRecord(void);
     Renderer::RendererTexture* AllocateRendererTexture(const u32 size);
     Renderer::RendererTexture* InitializeRendererTexture(void);
     s32 AcquireRendererDeviceTextureFormatIndex(const u32 palette, const u32 alpha, const u32 red, const u32 green, const u32 blue, const BOOL dxt);
     s32 InitializeRendererTextureDetails(Renderer::RendererTexture* tex);
     u32 AcquirePixelFormat(const DDPIXELFORMAT* format);
     u32 AcquireRendererDeviceCount(void);
+    u32 AcquireRendererTextureMemorySize(Renderer::RendererTexture* tex);
+    u32 AcquireRendererTextureMipMapCount(Renderer::RendererTexture* tex);
+    u32 AcquireRendererTextureMipMapFilter(void);
+    u32 AcquireRendererTextureSize(Renderer::RendererTexture* tex);
+    u32 AcquireRendererTriangleCount(const u32 count);
     u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1);
     u32 DisposeRendererTexture(Renderer::RendererTexture* tex);
     u32 EndRendererScene(void);
@@ -334,20 +451,26 @@ namespace RendererModule
     u32 STDCALLAPI InitializeRendererDeviceSurfacesExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result); // TODO
     u32 STDCALLAPI ReleaseRendererDeviceExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result); // TODO
     u32 ToggleRenderer(void);
+    u64 AcquireRendererTextureHash(const void* data, const u32 size);
     void AcquireRendererDeviceTextureFormats(void);
     void AcquireWindowModeCapabilities(void);
+    void AppendRendererTriangles(const D3DPRIMITIVETYPE type, const u32 count, Renderer::RTLVX* vertexes, const u32* indexes);
     void AttemptRenderScene(void);
+    void DetachRendererTexture(Renderer::RendererTexture* tex);
+    void EvictRendererTextures(const u32 size, Renderer::RendererTexture* keep);
     void InitializeConcreteRendererDevice(void);
     void InitializeRendererDeviceCapabilities(void);
     void InitializeRendererModuleState(const u32 pending, const u32 depth);
+    void InitializeRendererShadowStates(void);
     void InitializeRendererState(void);
     void InitializeRendererTransforms(void);
     void InitializeVertex(Renderer::RTLVX* dst, const Renderer::RTLVX* src);
-    void InitializeVertexes(Renderer::RVX* vertexes, const u32 count);
     void InitializeViewPort(void);
     void ReleaseRendererDevice(void);
     void ReleaseRendererDeviceSurfaces(void);
     void ReleaseRendererTexture(Renderer::RendererTexture* tex);
+    void ReleaseRendererTextureMipMaps(void);
+    void ReleaseRendererTexturePool(void);
     void RenderQuad(Renderer::RTLVX* a, Renderer::RTLVX* b, Renderer::RTLVX* c, Renderer::RTLVX* d);
     void RenderQuadMesh(Renderer::RTLVX* vertexes, const u32* indexes, const u32 count);
     void RenderTriangle(Renderer::RTLVX* a, Renderer::RTLVX* b, Renderer::RTLVX* c);
@@ -356,4 +479,7 @@ namespace RendererModule
     void SelectRendererDeviceType(const u32 type);
     void SelectRendererFogAlphas(const u8* input, u8* output);
     void SelectRendererMaterial(const f32 r, const f32 g, const f32 b);
+    void SelectRendererVertexTransforms(void);
+    void UpdateRendererVertexes(void);
+    void UpdateVertexes(Renderer::RTLVX* vertexes, const u32 count, const u32 transforms);
 }
\ No newline at end of file
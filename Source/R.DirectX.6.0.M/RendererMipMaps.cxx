@@ -0,0 +1,238 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RendererMipMaps.hxx"
+
+#include <math.h>
+
+namespace RendererModule
+{
+    // Initializes the lookup tables of the gamma-correct filter, that convert the 8-bit colors into the 16-bit linear colors, and back.
+    void InitializeRendererTextureMipMapGamma(RendererMipMapGamma* gamma)
+    {
+        if (gamma->IsActive) { return; }
+
+        for (u32 x = 0; x < MAX_TEXTURE_MIP_MAP_ENCODED_COLOR_COUNT; x++)
+        {
+            gamma->Linear[x] = (u16)(pow((f64)x / 255.0, 2.2) * 65535.0 + 0.5);
+        }
+
+        for (u32 x = 0; x < MAX_TEXTURE_MIP_MAP_LINEAR_COLOR_COUNT; x++)
+        {
+            gamma->Encoded[x] = (u8)(pow((f64)x / 65535.0, 1.0 / 2.2) * 255.0 + 0.5);
+        }
+
+        gamma->IsActive = TRUE;
+    }
+
+    // Filters the next mip map level of the 16-bit pixels with the 2x2 box filter, eight pixels of the level at a time.
+    // The channels are extracted by the bit masks of the pixel format, in R, G, B, A order, so the same code handles all of the 16-bit formats.
+    // NOTE: The odd last column and row are clamped to the edge, the gamma-correct filter is done through the lookup tables, when given.
+    void FilterRendererTextureMipMap16(const u32* channels, const RendererMipMapGamma* gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst)
+    {
+        const u32 w = 1 < width ? (width >> 1) : 1;
+        const u32 h = 1 < height ? (height >> 1) : 1;
+
+        u32 shifts[MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT];
+        u32 masks[MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT];
+
+        for (u32 x = 0; x < MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT; x++)
+        {
+            u32 value = channels[x] & 0xFFFF;
+
+            shifts[x] = 0;
+            masks[x] = 0;
+
+            if (value == 0) { continue; }
+
+            while (!(value & 1))
+            {
+                value = value >> 1;
+
+                shifts[x] = shifts[x] + 1;
+            }
+
+            masks[x] = value;
+        }
+
+        for (u32 y = 0; y < h; y++)
+        {
+            const u16* r0 = (u16*)((addr)src + (addr)(2 * y * pitch));
+            const u16* r1 = (u16*)((addr)src + (addr)((2 * y + 1 < height ? 2 * y + 1 : 2 * y) * pitch));
+
+            u16* output = (u16*)((addr)dst + (addr)(y * w * sizeof(u16)));
+
+            u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+            if (gamma == NULL)
+            {
+                const __m128i one = _mm_set1_epi16(1);
+                const __m128i two = _mm_set1_epi16(2);
+
+                for (; x + 8 <= w; x = x + 8)
+                {
+                    const __m128i a0 = _mm_loadu_si128((__m128i*)&r0[2 * x + 0]);
+                    const __m128i b0 = _mm_loadu_si128((__m128i*)&r0[2 * x + 8]);
+                    const __m128i a1 = _mm_loadu_si128((__m128i*)&r1[2 * x + 0]);
+                    const __m128i b1 = _mm_loadu_si128((__m128i*)&r1[2 * x + 8]);
+
+                    __m128i value = _mm_setzero_si128();
+
+                    for (u32 xx = 0; xx < MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT; xx++)
+                    {
+                        if (masks[xx] == 0) { continue; }
+
+                        const __m128i shift = _mm_cvtsi32_si128((s32)shifts[xx]);
+                        const __m128i mask = _mm_set1_epi16((s16)masks[xx]);
+
+                        const __m128i a = _mm_add_epi16(_mm_and_si128(_mm_srl_epi16(a0, shift), mask), _mm_and_si128(_mm_srl_epi16(a1, shift), mask));
+                        const __m128i b = _mm_add_epi16(_mm_and_si128(_mm_srl_epi16(b0, shift), mask), _mm_and_si128(_mm_srl_epi16(b1, shift), mask));
+
+                        // NOTE: The multiply-add with ones sums the adjacent columns into the 32-bit lanes.
+                        const __m128i sum = _mm_packs_epi32(_mm_madd_epi16(a, one), _mm_madd_epi16(b, one));
+
+                        value = _mm_or_si128(value, _mm_sll_epi16(_mm_srli_epi16(_mm_add_epi16(sum, two), 2), shift));
+                    }
+
+                    _mm_storeu_si128((__m128i*)&output[x], value);
+                }
+            }
+#endif
+
+            for (; x < w; x++)
+            {
+                const u32 x0 = 2 * x;
+                const u32 x1 = x0 + 1 < width ? x0 + 1 : x0;
+
+                u32 value = 0;
+
+                for (u32 xx = 0; xx < MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT; xx++)
+                {
+                    const u32 mask = masks[xx];
+
+                    if (mask == 0) { continue; }
+
+                    const u32 c0 = (r0[x0] >> shifts[xx]) & mask;
+                    const u32 c1 = (r0[x1] >> shifts[xx]) & mask;
+                    const u32 c2 = (r1[x0] >> shifts[xx]) & mask;
+                    const u32 c3 = (r1[x1] >> shifts[xx]) & mask;
+
+                    u32 color = (c0 + c1 + c2 + c3 + 2) >> 2;
+
+                    // NOTE: The alpha channel is always filtered linearly.
+                    if (gamma != NULL && xx < 3)
+                    {
+                        const u16* linear = gamma->Linear;
+
+                        const u32 average = ((u32)linear[(c0 * 255 + (mask >> 1)) / mask] + (u32)linear[(c1 * 255 + (mask >> 1)) / mask]
+                            + (u32)linear[(c2 * 255 + (mask >> 1)) / mask] + (u32)linear[(c3 * 255 + (mask >> 1)) / mask] + 2) >> 2;
+
+                        color = ((u32)gamma->Encoded[average] * mask + 127) / 255;
+                    }
+
+                    value = value | (color << shifts[xx]);
+                }
+
+                output[x] = (u16)value;
+            }
+        }
+    }
+
+    // Filters the next mip map level of the 32-bit pixels with the 2x2 box filter, four pixels of the level at a time.
+    // NOTE: The odd last column and row are clamped to the edge, the gamma-correct filter is done through the lookup tables, when given.
+    void FilterRendererTextureMipMap32(const RendererMipMapGamma* gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst)
+    {
+        const u32 w = 1 < width ? (width >> 1) : 1;
+        const u32 h = 1 < height ? (height >> 1) : 1;
+
+        for (u32 y = 0; y < h; y++)
+        {
+            const u32* r0 = (u32*)((addr)src + (addr)(2 * y * pitch));
+            const u32* r1 = (u32*)((addr)src + (addr)((2 * y + 1 < height ? 2 * y + 1 : 2 * y) * pitch));
+
+            u32* output = (u32*)((addr)dst + (addr)(y * w * sizeof(u32)));
+
+            u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+            if (gamma == NULL)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i two = _mm_set1_epi16(2);
+
+                for (; x + 4 <= w; x = x + 4)
+                {
+                    const __m128i a0 = _mm_loadu_si128((__m128i*)&r0[2 * x + 0]);
+                    const __m128i b0 = _mm_loadu_si128((__m128i*)&r0[2 * x + 4]);
+                    const __m128i a1 = _mm_loadu_si128((__m128i*)&r1[2 * x + 0]);
+                    const __m128i b1 = _mm_loadu_si128((__m128i*)&r1[2 * x + 4]);
+
+                    const __m128i al = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(a1, zero));
+                    const __m128i ah = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(a1, zero));
+                    const __m128i bl = _mm_add_epi16(_mm_unpacklo_epi8(b0, zero), _mm_unpacklo_epi8(b1, zero));
+                    const __m128i bh = _mm_add_epi16(_mm_unpackhi_epi8(b0, zero), _mm_unpackhi_epi8(b1, zero));
+
+                    // NOTE: The even and the odd columns are separated by the 64-bit halves, and summed.
+                    const __m128i a = _mm_add_epi16(_mm_unpacklo_epi64(al, ah), _mm_unpackhi_epi64(al, ah));
+                    const __m128i b = _mm_add_epi16(_mm_unpacklo_epi64(bl, bh), _mm_unpackhi_epi64(bl, bh));
+
+                    _mm_storeu_si128((__m128i*)&output[x],
+                        _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(a, two), 2), _mm_srli_epi16(_mm_add_epi16(b, two), 2)));
+                }
+            }
+#endif
+
+            for (; x < w; x++)
+            {
+                const u32 x0 = 2 * x;
+                const u32 x1 = x0 + 1 < width ? x0 + 1 : x0;
+
+                u32 value = 0;
+
+                for (u32 xx = 0; xx < MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT; xx++)
+                {
+                    const u32 shift = xx * 8;
+
+                    const u32 c0 = (r0[x0] >> shift) & 0xFF;
+                    const u32 c1 = (r0[x1] >> shift) & 0xFF;
+                    const u32 c2 = (r1[x0] >> shift) & 0xFF;
+                    const u32 c3 = (r1[x1] >> shift) & 0xFF;
+
+                    u32 color = (c0 + c1 + c2 + c3 + 2) >> 2;
+
+                    // NOTE: The alpha channel is always filtered linearly.
+                    if (gamma != NULL && xx < 3)
+                    {
+                        const u16* linear = gamma->Linear;
+
+                        color = gamma->Encoded[((u32)linear[c0] + (u32)linear[c1] + (u32)linear[c2] + (u32)linear[c3] + 2) >> 2];
+                    }
+
+                    value = value | (color << shift);
+                }
+
+                output[x] = value;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Basic.hxx"
+
+#if !defined(RENDERER_MODULE_NO_SIMD) && !defined(__WATCOMC__) && (_MSC_VER > 1200 || defined(__SSE2__))
+#ifndef RENDERER_MODULE_SIMD
+#define RENDERER_MODULE_SIMD
+#endif
+#include <emmintrin.h>
+#endif
+
+#define MAX_TEXTURE_MIP_MAP_CHANNEL_COUNT 4
+#define MAX_TEXTURE_MIP_MAP_ENCODED_COLOR_COUNT 256
+#define MAX_TEXTURE_MIP_MAP_LINEAR_COLOR_COUNT 65536
+
+namespace RendererModule
+{
+    // NOTE: The lookup tables of the gamma-correct filter, between the 8-bit colors and the 16-bit linear colors.
+    struct RendererMipMapGamma
+    {
+        BOOL IsActive;
+        u16 Linear[MAX_TEXTURE_MIP_MAP_ENCODED_COLOR_COUNT];
+        u8 Encoded[MAX_TEXTURE_MIP_MAP_LINEAR_COLOR_COUNT];
+    };
+
+    void FilterRendererTextureMipMap16(const u32* channels, const RendererMipMapGamma* gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst);
+    void FilterRendererTextureMipMap32(const RendererMipMapGamma* gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst);
+    void InitializeRendererTextureMipMapGamma(RendererMipMapGamma* gamma);
+}
\ No newline at end of file
@@ -39,6 +39,10 @@ namespace Settings
             RENDERER_MODULE_SETTINGS_ACCELERATE_GRAPHICS_PROPERTY_NAME, FALSE, RENDERER_MODULE_SETTINGS_FILE_NAME);
         SettingsState.FlatShading = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX6_NAME,
             RENDERER_MODULE_SETTINGS_FLAT_SHADING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureDeduplication = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX6_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_DEDUPLICATION_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureMipMaps = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX6_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_MIP_MAPS_PROPERTY_NAME, 1, RENDERER_MODULE_SETTINGS_FILE_NAME);
         SettingsState.VertexOffset = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
             RENDERER_MODULE_SETTINGS_VERTEX_OFFSET_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
     }
@@ -30,6 +30,8 @@ namespace Settings
     {
         BOOL Accelerate;
         BOOL FlatShading;
+        BOOL TextureDeduplication;
+        u32 TextureMipMaps;
         BOOL VertexOffset;
     };
 
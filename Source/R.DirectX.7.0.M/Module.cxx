@@ -105,6 +105,8 @@ namespace RendererModule
     // a.k.a. THRASH_clearwindow
     DLLAPI u32 STDCALLAPI ClearGameWindow(void)
     {
+        WaitRendererThread();
+
         return ClearRendererViewPort(State.ViewPort.X0, State.ViewPort.Y0,
             State.ViewPort.X1 + State.ViewPort.X0, State.ViewPort.Y0 + State.ViewPort.Y1,
             State.DX.Surfaces.Window == State.DX.Surfaces.Depth);
@@ -114,6 +116,22 @@ namespace RendererModule
     // a.k.a. THRASH_clip
     DLLAPI u32 STDCALLAPI ClipGameWindow(const u32 x0, const u32 y0, const u32 x1, const u32 y1)
     {
+        // NOTE: The primitives are clipped on the CPU as they are appended, thus the batch is neither drawn nor split,
+        // and the device viewport keeps covering the whole window.
+        if (SettingsState.ViewPortClipping)
+        {
+            State.ViewPort.X0 = x0;
+            State.ViewPort.Y0 = y0;
+            State.ViewPort.X1 = x1 - x0;
+            State.ViewPort.Y1 = y1 - y0;
+
+            SelectRendererClipRectangle(x0, y0, x1, y1);
+
+            return RENDERER_MODULE_SUCCESS;
+        }
+
+        WaitRendererThread();
+
         State.ViewPort.X0 = x0;
         State.ViewPort.Y0 = y0;
         State.ViewPort.X1 = x1 - x0;
@@ -143,6 +161,8 @@ namespace RendererModule
     // NOTE: Never being called by the application.
     DLLAPI u32 STDCALLAPI CreateGameWindow(const u32 width, const u32 height, const u32 format, const u32)
     {
+        WaitRendererThread();
+
         if (DAT_6005ab5c != 0
             && (format == RENDERER_PIXEL_FORMAT_R5G5B5 || format == RENDERER_PIXEL_FORMAT_R5G6B5 || format == RENDERER_PIXEL_FORMAT_A8R8G8B8))
         {
@@ -165,6 +185,8 @@ namespace RendererModule
     // NOTE: Never being called by the application.
     DLLAPI u32 STDCALLAPI DestroyGameWindow(const u32 indx)
     {
+        WaitRendererThread();
+
         if (indx < MAX_WINDOW_COUNT && State.Windows[indx].Texture != NULL && MIN_WINDOW_INDEX < indx)
         {
             if (State.Windows[indx].Surface != NULL)
@@ -223,13 +245,13 @@ namespace RendererModule
     // a.k.a. THRASH_drawpointmesh
     DLLAPI void STDCALLAPI DrawPointMesh(const u32 count, RVX* vertexes, const u32* indexes)
     {
-        const RTLVX* vs = (RTLVX*)vertexes;
-
         for (u32 x = 0; x < count; x++)
         {
-            const u16 index = *(u16*)((addr)indexes + (addr)(x * RendererIndexSize));
+            /* ORIGINAL: const u16 index = *(u16*)((addr)indexes + (addr)(x * RendererIndexSize)); */
+            const u32 index = AcquireRendererVertexIndex(indexes, x);
 
-            DrawPoint((RVX*)&vs[index]);
+            /* ORIGINAL: DrawPoint((RVX*)&((RTLVX*)vertexes)[index]); */
+            DrawPoint((RVX*)((addr)vertexes + (addr)RendererVertexSize * (addr)index));
         }
     }
 
@@ -283,8 +305,8 @@ namespace RendererModule
     {
         for (u32 x = 0; x < count; x++)
         {
-            const u16 ia = *(u16*)((addr)indexes + (addr)RendererIndexSize * (addr)(x + 0));
-            const u16 ib = *(u16*)((addr)indexes + (addr)RendererIndexSize * (addr)(x + 1));
+            const u32 ia = AcquireRendererVertexIndex(indexes, x + 0);
+            const u32 ib = AcquireRendererVertexIndex(indexes, x + 1);
 
             RVX* a = (RVX*)((addr)vertexes + (addr)RendererVertexSize * (addr)ia);
             RVX* b = (RVX*)((addr)vertexes + (addr)RendererVertexSize * (addr)ib);
@@ -355,6 +377,8 @@ namespace RendererModule
     // a.k.a. THRASH_flushwindow
     DLLAPI u32 STDCALLAPI FlushGameWindow(void)
     {
+        WaitRendererThread();
+
         return EndRendererScene();
     }
 
@@ -391,10 +415,14 @@ namespace RendererModule
     // a.k.a. THRASH_init
     DLLAPI u32 STDCALLAPI Init(void)
     {
+        WaitRendererThread();
+
         RendererState = STATE_INACTIVE;
 
         InitializeSettings();
 
+        SelectRendererVertexTransforms();
+
         AcquireRendererDeviceCount();
 
         InitializeTextureStateStates();
@@ -457,6 +485,8 @@ namespace RendererModule
     // a.k.a. THRASH_lockwindow
     DLLAPI RendererModuleWindowLock* STDCALLAPI LockGameWindow(void)
     {
+        WaitRendererThread();
+
         if (State.DX.Surfaces.Window == NULL) { return NULL; }
 
         if (State.Lock.IsActive) { LOGERROR("D3D lock called while locked\n"); }
@@ -532,8 +562,32 @@ namespace RendererModule
     // a.k.a. THRASH_pageflip
     DLLAPI void STDCALLAPI ToggleGameWindow(void)
     {
+        CommitRendererTextureCompressions();
+
+        // NOTE: The page flip of the full screen mode is handed over to the render thread together with the recorded commands,
+        // while the game thread returns right away. Window mode, and restoration of the lost surfaces stay on the game thread.
+        if (State.Thread.IsActive && !State.Lock.IsActive && !State.Settings.IsWindowMode
+            && State.DX.Active.Surfaces.Back != NULL && !State.Settings.IsToggleAllowed)
+        {
+            if (!State.Scene.IsActive) { BeginRendererScene(); }
+
+            if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+            RendererDepthBias = 0.0f;
+
+            SelectRendererVertexTransforms();
+
+            SubmitRendererCommands(RENDERER_THREAD_COMMAND_PRESENT);
+
+            CommitRendererFrame();
+
+            return;
+        }
+
         EndRendererScene();
 
+        CommitRendererFrame();
+
         if (State.Lock.IsActive) { LOGERROR("D3D pageflip called in while locked\n"); }
 
         ToggleRenderer();
@@ -543,6 +597,8 @@ namespace RendererModule
     // a.k.a. THRASH_readrect
     DLLAPI u32 STDCALLAPI ReadRectangle(const u32 x, const u32 y, const u32 width, const u32 height, u32* pixels)
     {
+        WaitRendererThread();
+
         const RendererModuleWindowLock* state = RendererLock(LOCK_READ);
 
         if (state == NULL) { return RENDERER_MODULE_FAILURE; }
@@ -566,6 +622,8 @@ namespace RendererModule
     // a.k.a. THRASH_restore
     DLLAPI u32 STDCALLAPI RestoreGameWindow(void)
     {
+        WaitRendererThread();
+
         if (RendererState == STATE_INACTIVE)
         {
             RendererState = STATE_ACTIVE;
@@ -600,6 +658,8 @@ namespace RendererModule
     // a.k.a. THRASH_selectdisplay
     DLLAPI u32 STDCALLAPI SelectDevice(const s32 indx)
     {
+        WaitRendererThread();
+
         State.Device.Identifier = NULL;
 
         if (State.DX.Instance != NULL) { RestoreGameWindow(); }
@@ -647,6 +707,8 @@ namespace RendererModule
     // a.k.a. THRASH_setstate
     DLLAPI u32 STDCALLAPI SelectState(const u32 state, void* value)
     {
+        WaitRendererThread();
+
         const u32 actual = state & RENDERER_MODULE_SELECT_STATE_MASK;
         const u32 stage = MAKETEXTURESTAGEVALUE(state);
 
@@ -717,7 +779,7 @@ namespace RendererModule
             {
                 SelectRendererState(D3DRENDERSTATE_ZWRITEENABLE, FALSE);
                 SelectRendererState(D3DRENDERSTATE_ZENABLE, D3DZB_FALSE);
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_ALWAYS);
+                SelectRendererDepthFunction(D3DCMP_ALWAYS);
 
                 break;
             }
@@ -725,7 +787,7 @@ namespace RendererModule
             {
                 SelectRendererState(D3DRENDERSTATE_ZWRITEENABLE, TRUE);
                 SelectRendererState(D3DRENDERSTATE_ZENABLE, D3DZB_TRUE);
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, RendererDepthFunction);
+                SelectRendererDepthFunction(RendererDepthFunction);
 
                 break;
             }
@@ -735,14 +797,14 @@ namespace RendererModule
                 {
                     SelectRendererState(D3DRENDERSTATE_ZENABLE, D3DZB_TRUE);
                     SelectRendererState(D3DRENDERSTATE_ZWRITEENABLE, TRUE);
-                    SelectRendererState(D3DRENDERSTATE_ZFUNC, RendererDepthFunction);
+                    SelectRendererDepthFunction(RendererDepthFunction);
                     SelectRendererState(D3DRENDERSTATE_ZENABLE, D3DZB_USEW);
                 }
                 else
                 {
                     SelectRendererState(D3DRENDERSTATE_ZWRITEENABLE, TRUE);
                     SelectRendererState(D3DRENDERSTATE_ZENABLE, D3DZB_TRUE);
-                    SelectRendererState(D3DRENDERSTATE_ZFUNC, RendererDepthFunction);
+                    SelectRendererDepthFunction(RendererDepthFunction);
 
                     return RENDERER_MODULE_FAILURE;
                 }
@@ -784,6 +846,8 @@ namespace RendererModule
                     RendererShadeMode = RENDERER_MODULE_SHADE_GOURAUD;
                 }
 
+                SelectRendererVertexTransforms();
+
                 break;
             }
             case RENDERER_MODULE_SHADE_GOURAUD_SPECULAR:
@@ -795,6 +859,8 @@ namespace RendererModule
 
                 RendererShadeMode = RENDERER_MODULE_SHADE_GOURAUD;
 
+                SelectRendererVertexTransforms();
+
                 break;
             }
             case RENDERER_MODULE_SHADE_3:
@@ -967,6 +1033,8 @@ namespace RendererModule
         case RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS:
         case RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS_ALTERNATIVE:
         {
+            UpdateRendererVertexes();
+
             SelectRendererFogAlphas((u8*)value, RendererFogAlphas);
 
             SelectRendererState(D3DRENDERSTATE_FOGTABLEMODE, D3DFOG_NONE);
@@ -974,6 +1042,8 @@ namespace RendererModule
             State.Settings.IsFogActive = TRUE;
             State.Settings.FogState = RENDERER_MODULE_FOG_ACTIVE_ALPHAS;
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_FOG_STATE:
@@ -1046,6 +1116,8 @@ namespace RendererModule
             default: { return RENDERER_MODULE_FAILURE; }
             }
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_FOG_START:
@@ -1057,7 +1129,11 @@ namespace RendererModule
 
             if (isnan(RendererDepthBias) || isnan(bias) == (RendererDepthBias == bias))
             {
+                UpdateRendererVertexes();
+
                 RendererDepthBias = bias * 0.000030517578f;
+
+                SelectRendererVertexTransforms();
             }
 
             result = RENDERER_MODULE_SUCCESS; break;
@@ -1169,7 +1245,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_NEVER;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_NEVER);
+                SelectRendererDepthFunction(D3DCMP_NEVER);
 
                 break;
             }
@@ -1177,7 +1253,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_LESS;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_LESS);
+                SelectRendererDepthFunction(D3DCMP_LESS);
 
                 break;
             }
@@ -1185,7 +1261,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_EQUAL;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_EQUAL);
+                SelectRendererDepthFunction(D3DCMP_EQUAL);
 
                 break;
             }
@@ -1193,7 +1269,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_LESSEQUAL;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_LESSEQUAL);
+                SelectRendererDepthFunction(D3DCMP_LESSEQUAL);
 
                 break;
             }
@@ -1201,7 +1277,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_GREATER;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_GREATER);
+                SelectRendererDepthFunction(D3DCMP_GREATER);
 
                 break;
             }
@@ -1209,7 +1285,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_NOTEQUAL;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_NOTEQUAL);
+                SelectRendererDepthFunction(D3DCMP_NOTEQUAL);
 
                 break;
             }
@@ -1217,7 +1293,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_GREATEREQUAL;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_GREATEREQUAL);
+                SelectRendererDepthFunction(D3DCMP_GREATEREQUAL);
 
                 break;
             }
@@ -1225,7 +1301,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_ALWAYS;
 
-                SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_ALWAYS);
+                SelectRendererDepthFunction(D3DCMP_ALWAYS);
 
                 break;
             }
@@ -2333,6 +2409,8 @@ namespace RendererModule
                 State.Scene.IsActive = TRUE;
             }
 
+            RenderRendererCommands();
+
             const RendererModuleBufferPacket* input = (RendererModuleBufferPacket*)value;
 
             if (input->Indexes == NULL || input->IndexCount == 0)
@@ -2457,6 +2535,8 @@ namespace RendererModule
     // a.k.a. THRASH_setvideomode
     DLLAPI u32 STDCALLAPI SelectVideoMode(const u32 mode, const u32 pending, const u32 depth)
     {
+        WaitRendererThread();
+
         State.Window.Bits = depth;
 
         if (depth == 1) { State.Window.Bits = GRAPHICS_BITS_PER_PIXEL_16; } // TODO
@@ -2542,6 +2622,8 @@ namespace RendererModule
     // a.k.a. THRASH_sync
     DLLAPI u32 STDCALLAPI SyncGameWindow(const u32 type)
     {
+        WaitRendererThread();
+
         switch (type)
         {
         case RENDERER_MODULE_SYNC_NORMAL: { UnlockGameWindow(RendererLock(LOCK_WRITE)); break; }
@@ -2555,6 +2637,8 @@ namespace RendererModule
     // a.k.a. THRASH_talloc
     DLLAPI RendererTexture* STDCALLAPI AllocateTexture(const u32 width, const u32 height, const u32 format, const BOOL palette, const u32 state)
     {
+        WaitRendererThread();
+
         if (State.DX.Active.Instance != NULL)
         {
             if (State.DX.Active.Instance->TestCooperativeLevel() == DD_OK)
@@ -2571,28 +2655,30 @@ namespace RendererModule
     // NOTE: Never being called by the application.
     DLLAPI u32 STDCALLAPI ReleaseTexture(RendererTexture* tex)
     {
-        if (State.Textures.Recent == NULL) { return RENDERER_MODULE_FAILURE; }
+        WaitRendererThread();
 
-        // Attempt to remove the input texture from the linked list.
-        {
-            RendererTexture* current = State.Textures.Recent;
-            RendererTexture* previous = State.Textures.Recent;
+        // NOTE: The texture is looked up by its index within the dense array of the active textures, instead of walking the linked list of the textures.
+        if (tex == NULL) { return RENDERER_MODULE_FAILURE; }
+        if (State.Textures.Active.Count <= tex->ActiveIndex || State.Textures.Active.Textures[tex->ActiveIndex] != tex) { return RENDERER_MODULE_FAILURE; }
 
-            while (current != tex)
-            {
-                previous = current;
-                current = current->Previous;
+        CancelRendererTextureCompression(tex);
 
-                if (current == NULL) { return RENDERER_MODULE_FAILURE; }
-            }
+        DetachRendererTexture(tex);
 
-            previous->Previous = current->Previous;
-        }
+        ReleaseRendererTextureAtlas(tex);
+
+        if (tex->Backup == NULL) { State.Textures.Size = State.Textures.Size - tex->Size; }
+
+        RenderRendererCommands();
 
+        if (tex->Backup != NULL) { tex->Backup->Release(); }
         if (tex->Palette != NULL) { tex->Palette->Release(); }
         if (tex->Texture != NULL) { tex->Texture->Release(); }
         if (tex->Surface != NULL) { tex->Surface->Release(); }
 
+        // NOTE: The texture is no longer active, so its record is returned to the pool of the textures.
+        ReleaseRendererTexture(tex);
+
         return RENDERER_MODULE_SUCCESS;
     }
 
@@ -2600,14 +2686,16 @@ namespace RendererModule
     // a.k.a. THRASH_treset
     DLLAPI u32 STDCALLAPI ResetTextures(void)
     {
-        State.Textures.Count = 0;
+        WaitRendererThread();
 
-        State.Textures.Recent = NULL;
+        State.Textures.Count = 0;
 
         if (State.DX.DirectX == NULL) { return RENDERER_MODULE_FAILURE; }
 
         SelectRendererTexture(NULL);
 
+        RenderRendererCommands();
+
         if (State.Scene.IsActive)
         {
             FlushGameWindow();
@@ -2617,23 +2705,28 @@ namespace RendererModule
             State.Scene.IsActive = FALSE;
         }
 
-        while (State.Textures.Current != NULL)
+        for (u32 x = 0; x < State.Textures.Active.Count; x++)
         {
-            if (State.Textures.Current->Palette != NULL) { State.Textures.Current->Palette->Release(); }
-            if (State.Textures.Current->Texture != NULL) { State.Textures.Current->Texture->Release(); }
-            if (State.Textures.Current->Surface != NULL) { State.Textures.Current->Surface->Release(); }
+            RendererTexture* tex = State.Textures.Active.Textures[x];
 
-            RendererTexture* tex = State.Textures.Current;
-
-            State.Textures.Current = State.Textures.Current->Previous;
+            if (tex->Palette != NULL) { tex->Palette->Release(); }
+            if (tex->Texture != NULL) { tex->Texture->Release(); }
+            if (tex->Surface != NULL) { tex->Surface->Release(); }
+            if (tex->Backup != NULL) { tex->Backup->Release(); }
 
             ReleaseRendererTexture(tex);
         }
 
-        State.Textures.Current = NULL;
+        State.Textures.Active.Count = 0;
+
+        ReleaseRendererTextureAtlases();
+
+        State.Textures.Size = 0;
 
         State.Textures.Illegal = FALSE;
 
+        ReleaseRendererMeshes();
+
         InitializeRenderState55();
 
         return RENDERER_MODULE_SUCCESS;
@@ -2643,10 +2736,14 @@ namespace RendererModule
     // a.k.a. THRASH_tupdate
     DLLAPI RendererTexture* STDCALLAPI UpdateTexture(RendererTexture* tex, const u32* pixels, const u32* palette)
     {
+        WaitRendererThread();
+
         if (State.DX.Active.Instance != NULL)
         {
             if (State.DX.Active.Instance->TestCooperativeLevel() == DD_OK && tex != NULL)
             {
+                RenderRendererCommands();
+
                 return UpdateRendererTexture(tex, pixels, palette) ? tex : NULL;
             }
         }
@@ -2659,8 +2756,12 @@ namespace RendererModule
     // NOTE: Never being called by the application.
     DLLAPI RendererTexture* STDCALLAPI UpdateTextureRectangle(RendererTexture* tex, const u32* pixels, const u32* palette, const s32 x, const s32 y, const s32 width, const s32 height, const s32 size, const s32)
     {
+        WaitRendererThread();
+
         if (tex != NULL && pixels != NULL && 0 < width && 0 < height)
         {
+            RenderRendererCommands();
+
             return UpdateRendererTexture(tex, pixels, palette, x, y, width, height, size) ? tex : NULL;
         }
 
@@ -2671,6 +2772,8 @@ namespace RendererModule
     // a.k.a. THRASH_unlockwindow
     DLLAPI u32 STDCALLAPI UnlockGameWindow(const RendererModuleWindowLock* state)
     {
+        WaitRendererThread();
+
         if (State.Lock.IsActive && State.Lock.Surface != NULL)
         {
             if (State.Lock.Surface->Unlock(NULL) != DD_OK) { return RENDERER_MODULE_FAILURE; }
@@ -2688,6 +2791,10 @@ namespace RendererModule
     // a.k.a. THRASH_window
     DLLAPI u32 STDCALLAPI SelectGameWindow(const u32 indx)
     {
+        WaitRendererThread();
+
+        RenderRendererCommands();
+
         SelectRendererStateValue(RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX, (void*)indx);
 
         if (indx < 9) // TODO
@@ -2748,6 +2855,8 @@ namespace RendererModule
     // a.k.a. THRASH_writerect
     DLLAPI u32 STDCALLAPI WriteRectangle(const u32 x, const u32 y, const u32 width, const u32 height, const u32* pixels)
     {
+        WaitRendererThread();
+
         RendererModuleWindowLock* state = RendererLock(LOCK_WRITE);
 
         if (state == NULL) { return RENDERER_MODULE_FAILURE; }
@@ -21,6 +21,7 @@ SOFTWARE.
 */
 
 #include "Graphics.Basic.hxx"
+#include "Mathematics.Basic.hxx"
 #include "Renderer.hxx"
 #include "RendererValues.hxx"
 #include "Settings.hxx"
@@ -28,6 +29,7 @@ SOFTWARE.
 #include <malloc.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #define MAX_MESSAGE_BUFFER_LENGTH 512
 
@@ -40,6 +42,15 @@ SOFTWARE.
 #define ALIGNMENTMASK   0xFFFFFFFC
 #define ALIGN(x)        (((x) + 3) & ALIGNMENTMASK)
 
+#define TEXTURE_HASH_PRIME_1 0x9E3779B1
+#define TEXTURE_HASH_PRIME_2 0x85EBCA77
+#define TEXTURE_HASH_PRIME_3 0xC2B2AE3D
+#define TEXTURE_HASH_PRIME_4 0x27D4EB2F
+#define TEXTURE_HASH_PRIME_5 0x165667B1
+
+#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+using namespace Mathematics;
 using namespace Renderer;
 using namespace RendererModuleValues;
 using namespace Settings;
@@ -93,18 +104,213 @@ namespace RendererModule
         }
     }
 
-    // 0x6000d580
-    void InitializeVertexes(RVX* vertexes, const u32 count)
+    // Applies the active set of vertex transforms to a batch of vertexes in a single pass.
+    // The position related transforms are applied with one packed multiply and addition per vertex,
+    // and the fog alpha indexes are calculated four vertexes at a time.
+    void UpdateVertexes(RVX* vertexes, const u32 count, const u32 transforms)
     {
-        if (!SettingsState.VertexOffset) { return; }
+        if (transforms == RENDERER_VERTEX_TRANSFORM_NONE || count == 0) { return; }
 
-        for (u32 x = 0; x < count; x++)
+        const BOOL isColor = (transforms & RENDERER_VERTEX_TRANSFORM_COLOR) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isFog = (transforms & RENDERER_VERTEX_TRANSFORM_FOG) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isPosition = (transforms & (RENDERER_VERTEX_TRANSFORM_DEPTH | RENDERER_VERTEX_TRANSFORM_OFFSET | RENDERER_VERTEX_TRANSFORM_RANGE)) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isRange = (transforms & RENDERER_VERTEX_TRANSFORM_RANGE) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isAtlas = (transforms & RENDERER_VERTEX_TRANSFORM_ATLAS) != RENDERER_VERTEX_TRANSFORM_NONE;
+
+        const f32 offset = (transforms & RENDERER_VERTEX_TRANSFORM_OFFSET) ? -0.5f : 0.0f;
+        const f32 bias = (transforms & RENDERER_VERTEX_TRANSFORM_DEPTH) ? RendererDepthBias : 0.0f;
+
+        // NOTE: The depth range maps Z into [0, 0.5] on the even frames, and into [1, 0.5] on the odd ones.
+        const f32 range = isRange ? (State.DepthRange.IsInverse ? -0.5f : 0.5f) : 1.0f;
+        const f32 base = (isRange && State.DepthRange.IsInverse) ? 1.0f : 0.0f;
+
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        const __m128 factor = _mm_setr_ps(1.0f, 1.0f, range, 1.0f);
+        const __m128 delta = _mm_setr_ps(offset, offset, bias * range + base, 0.0f);
+
+        const __m128 minimum = _mm_setzero_ps();
+        const __m128 maximum = _mm_set1_ps((f32)MAX_OUTPUT_FOG_ALPHA_VALUE);
+
+        const __m128 scale = _mm_setr_ps(State.Textures.Atlases.Scale.X, State.Textures.Atlases.Scale.Y, 0.0f, 0.0f);
+        const __m128 shift = _mm_setr_ps(State.Textures.Atlases.Offset.X, State.Textures.Atlases.Offset.Y, 0.0f, 0.0f);
+
+        for (; x + 4 <= count; x = x + 4)
+        {
+            RTLVX* v0 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 0)));
+            RTLVX* v1 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 1)));
+            RTLVX* v2 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 2)));
+            RTLVX* v3 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 3)));
+
+            if (isColor)
+            {
+                v0->Color = GRAPCHICS_COLOR_WHITE;
+                v1->Color = GRAPCHICS_COLOR_WHITE;
+                v2->Color = GRAPCHICS_COLOR_WHITE;
+                v3->Color = GRAPCHICS_COLOR_WHITE;
+            }
+
+            if (isFog)
+            {
+                // NOTE: The index is clamped, the original code reads past the fog alphas when Z is outside of [0, 1].
+                const __m128 z = _mm_mul_ps(_mm_setr_ps(v0->XYZ.Z, v1->XYZ.Z, v2->XYZ.Z, v3->XYZ.Z), maximum);
+
+                u32 indexes[4];
+                _mm_storeu_si128((__m128i*)indexes, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(z, minimum), maximum)));
+
+                v0->Specular = ((u32)RendererFogAlphas[indexes[0]]) << 24;
+                v1->Specular = ((u32)RendererFogAlphas[indexes[1]]) << 24;
+                v2->Specular = ((u32)RendererFogAlphas[indexes[2]]) << 24;
+                v3->Specular = ((u32)RendererFogAlphas[indexes[3]]) << 24;
+            }
+
+            if (isPosition)
+            {
+                _mm_storeu_ps((f32*)&v0->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v0->XYZ), factor), delta));
+                _mm_storeu_ps((f32*)&v1->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v1->XYZ), factor), delta));
+                _mm_storeu_ps((f32*)&v2->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v2->XYZ), factor), delta));
+                _mm_storeu_ps((f32*)&v3->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v3->XYZ), factor), delta));
+            }
+
+            if (isAtlas)
+            {
+                _mm_storel_pi((__m64*)&v0->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v0->UV), scale), shift));
+                _mm_storel_pi((__m64*)&v1->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v1->UV), scale), shift));
+                _mm_storel_pi((__m64*)&v2->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v2->UV), scale), shift));
+                _mm_storel_pi((__m64*)&v3->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v3->UV), scale), shift));
+            }
+        }
+#endif
+
+        for (; x < count; x++)
+        {
+            RTLVX* vertex = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * x));
+
+            if (isColor) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+
+            if (isFog) { vertex->Specular = ((u32)RendererFogAlphas[AcquireFogAlphaIndex(vertex->XYZ.Z)]) << 24; }
+
+            if (isPosition)
+            {
+                vertex->XYZ.X = vertex->XYZ.X + offset;
+                vertex->XYZ.Y = vertex->XYZ.Y + offset;
+                vertex->XYZ.Z = (vertex->XYZ.Z + bias) * range + base;
+            }
+
+            if (isAtlas)
+            {
+                vertex->UV.X = vertex->UV.X * State.Textures.Atlases.Scale.X + State.Textures.Atlases.Offset.X;
+                vertex->UV.Y = vertex->UV.Y * State.Textures.Atlases.Scale.Y + State.Textures.Atlases.Offset.Y;
+            }
+        }
+    }
+
+    // Tests a range of indexed primitives against the current cull mode using the winding of their first three vertexes,
+    // and writes the numbers of the primitives that are not culled. The winding is tested four primitives at a time.
+    // NOTE: The float to integer truncation of the original AcquireNormal is preserved,
+    // so primitives with an area smaller than one are treated as clockwise.
+    template <typename V, typename I> u32 AcquireVisiblePrimitives(V* vertexes, const I* indexes, const u32 start, const u32 count, const u32 size, u32* visible)
+    {
+        if (State.Settings.Cull == RENDERER_CULL_MODE_NONE)
+        {
+            for (u32 x = 0; x < count; x++) { visible[x] = start + x; }
+
+            return count;
+        }
+
+        u32 result = 0;
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        // The sign bits of the visible primitives are set when clockwise primitives are culled, and clear otherwise.
+        const s32 inverse = State.Settings.Cull == RENDERER_CULL_MODE_COUNTER_CLOCK_WISE ? 0xF : 0x0;
+
+        for (; x + 4 <= count; x = x + 4)
+        {
+            const f32x3* a[4];
+            const f32x3* b[4];
+            const f32x3* c[4];
+
+            for (u32 xx = 0; xx < 4; xx++)
+            {
+                const u32 indx = (start + x + xx) * size;
+
+                a[xx] = &vertexes[indexes[indx + 0]].XYZ;
+                b[xx] = &vertexes[indexes[indx + 1]].XYZ;
+                c[xx] = &vertexes[indexes[indx + 2]].XYZ;
+            }
+
+            const __m128 ax = _mm_setr_ps(a[0]->X, a[1]->X, a[2]->X, a[3]->X);
+            const __m128 ay = _mm_setr_ps(a[0]->Y, a[1]->Y, a[2]->Y, a[3]->Y);
+
+            const __m128 bx = _mm_sub_ps(_mm_setr_ps(b[0]->X, b[1]->X, b[2]->X, b[3]->X), ax);
+            const __m128 by = _mm_sub_ps(_mm_setr_ps(b[0]->Y, b[1]->Y, b[2]->Y, b[3]->Y), ay);
+            const __m128 cx = _mm_sub_ps(_mm_setr_ps(c[0]->X, c[1]->X, c[2]->X, c[3]->X), ax);
+            const __m128 cy = _mm_sub_ps(_mm_setr_ps(c[0]->Y, c[1]->Y, c[2]->Y, c[3]->Y), ay);
+
+            const __m128i normal = _mm_cvttps_epi32(_mm_sub_ps(_mm_mul_ps(bx, cy), _mm_mul_ps(cx, by)));
+
+            const s32 mask = _mm_movemask_ps(_mm_castsi128_ps(normal)) ^ inverse;
+
+            if (mask & 1) { visible[result] = start + x + 0; result = result + 1; }
+            if (mask & 2) { visible[result] = start + x + 1; result = result + 1; }
+            if (mask & 4) { visible[result] = start + x + 2; result = result + 1; }
+            if (mask & 8) { visible[result] = start + x + 3; result = result + 1; }
+        }
+#endif
+
+        for (; x < count; x++)
         {
-            f32x3* xyz = (f32x3*)((addr)vertexes + (addr)(x * RendererVertexSize));
+            const u32 indx = (start + x) * size;
+
+            f32x3* a = &vertexes[indexes[indx + 0]].XYZ;
+            f32x3* b = &vertexes[indexes[indx + 1]].XYZ;
+            f32x3* c = &vertexes[indexes[indx + 2]].XYZ;
+
+            if ((AcquireNormal(a, b, c) & RENDERER_CULL_MODE_COUNTER_CLOCK_WISE) != State.Settings.Cull)
+            {
+                visible[result] = start + x;
+                result = result + 1;
+            }
+        }
 
-            xyz->X = xyz->X - 0.5f;
-            xyz->Y = xyz->Y - 0.5f;
+        return result;
+    }
+
+    // Applies the active vertex transforms to the vertexes added to the batch since the last update.
+    void UpdateRendererVertexes(void)
+    {
+        if (State.Data.Vertexes.Processed < State.Data.Vertexes.Count)
+        {
+            UpdateVertexes((RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * State.Data.Vertexes.Processed)),
+                State.Data.Vertexes.Count - State.Data.Vertexes.Processed, State.Data.Vertexes.Transforms);
         }
+
+        State.Data.Vertexes.Processed = State.Data.Vertexes.Count;
+    }
+
+    // Selects the set of vertex transforms matching the current state.
+    // The vertexes already in the batch are processed with the previous set first.
+    void SelectRendererVertexTransforms(void)
+    {
+        UpdateRendererVertexes();
+
+        u32 transforms = RENDERER_VERTEX_TRANSFORM_NONE;
+
+        if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_COLOR; }
+
+        if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_FOG; }
+
+        if (RendererDepthBias != 0.0f) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_DEPTH; }
+
+        if (SettingsState.VertexOffset) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_OFFSET; }
+
+        if (State.DepthRange.IsActive) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_RANGE; }
+
+        if (State.Textures.Atlases.Current != NULL) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_ATLAS; }
+
+        State.Data.Vertexes.Transforms = transforms;
     }
 
     // 0x600036b0
@@ -1414,9 +1620,23 @@ namespace RendererModule
         return (caps.dpcTriCaps.dwRasterCaps & D3DPRASTERCAPS_ZBUFFERLESSHSR) != 0;
     }
 
+    void InitializeRendererShadowStates(void)
+    {
+        ZeroMemory(State.Shadow.States.IsValid, MAX_RENDER_STATE_COUNT * sizeof(BOOL));
+        ZeroMemory(State.Shadow.Stages.IsValid, MAX_TEXTURE_STAGE_COUNT * MAX_TEXTURE_STAGE_STATE_COUNT * sizeof(BOOL));
+    }
+
     // 0x6000a490
     void InitializeRendererState(void)
     {
+        InitializeRendererShadowStates();
+
+        State.DepthRange.IsActive = FALSE;
+        State.DepthRange.IsInverse = FALSE;
+        State.DepthRange.IsCleared = FALSE;
+        State.DepthRange.Frame = 0;
+        State.DepthRange.Function = D3DCMP_LESSEQUAL;
+
         State.DX.Device->BeginScene();
 
         SelectRendererTransforms(1.0f, 65535.0f);
@@ -1466,6 +1686,9 @@ namespace RendererModule
 
         State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ADDRESS, D3DTADDRESS_CLAMP);
 
+        State.Textures.Atlases.AddressU = D3DTADDRESS_CLAMP;
+        State.Textures.Atlases.AddressV = D3DTADDRESS_CLAMP;
+
         State.DX.Device->SetRenderState(D3DRENDERSTATE_SHADEMODE, D3DSHADE_GOURAUD);
         State.DX.Device->SetRenderState(D3DRENDERSTATE_CLIPPING, 0);
         State.DX.Device->SetRenderState(D3DRENDERSTATE_LIGHTING, 0);
@@ -1497,6 +1720,8 @@ namespace RendererModule
 
         State.DX.Device->SetRenderState(D3DRENDERSTATE_TEXTUREFACTOR, GRAPCHICS_COLOR_WHITE);
 
+        InitializeRendererCommands();
+
         ZeroMemory(State.Textures.Stages, MAX_TEXTURE_STAGE_COUNT * sizeof(TextureStage));
 
         State.Scene.IsActive = TRUE;
@@ -1597,6 +1822,8 @@ namespace RendererModule
     void AttemptRenderScene(void)
     {
         if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        RenderRendererCommands();
     }
 
     // 0x60006f20
@@ -1606,2379 +1833,5219 @@ namespace RendererModule
         {
             if (!State.Scene.IsActive) { BeginRendererScene(); }
 
-            InitializeVertexes((RVX*)State.Data.Vertexes.Vertexes, State.Data.Vertexes.Count);
+            UpdateRendererVertexes();
+
+            State.Commands.Statistics.Current.Recorded = State.Commands.Statistics.Current.Recorded + 1;
+
+            if (State.Commands.IsActive) { AppendRendererCommand(); }
+            else
+            {
+                State.DX.Device->DrawIndexedPrimitive(RendererPrimitiveType, RendererVertexType,
+                    State.Data.Vertexes.Vertexes, State.Data.Vertexes.Count,
+                    State.Data.Indexes.Indexes, State.Data.Indexes.Count, 0);
 
-            State.DX.Device->DrawIndexedPrimitive(RendererPrimitiveType, RendererVertexType,
-                State.Data.Vertexes.Vertexes, State.Data.Vertexes.Count,
-                State.Data.Indexes.Indexes, State.Data.Indexes.Count, 0);
+                State.Commands.Statistics.Current.Submitted = State.Commands.Statistics.Current.Submitted + 1;
+            }
 
             State.Data.Vertexes.Count = 0;
+            State.Data.Vertexes.Processed = 0;
             State.Data.Indexes.Count = 0;
         }
     }
 
-    // 0x60008810
-    BOOL BeginRendererScene(void)
+    void InitializeRendererCommands(void)
     {
-        if (State.Lock.IsActive) { UnlockGameWindow(NULL); }
+        WaitRendererThread();
 
-        State.Scene.IsActive = State.DX.Device->BeginScene() == DD_OK;
+        State.Commands.IsActive = SettingsState.DrawSorting;
 
-        return State.Scene.IsActive;
-    }
+        State.Commands.Index = 0;
 
-    // 0x60008860
-    BOOL EndRendererScene(void)
-    {
-        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+        for (u32 x = 0; x < MAX_COMMAND_BUFFER_COUNT; x++)
+        {
+            State.Commands.Buffers[x].Count = 0;
+            State.Commands.Buffers[x].Vertexes.Size = 0;
+            State.Commands.Buffers[x].Indexes.Count = 0;
+            State.Commands.Buffers[x].Textures.Count = 0;
+        }
 
-        if (State.Scene.IsActive)
+        for (u32 x = 0; x < MAX_COMMAND_STATE_COUNT; x++)
         {
-            RendererDepthBias = 0.0f;
+            DWORD value = 0;
+            State.DX.Device->GetRenderState(RendererCommandStates[x], &value);
 
-            const HRESULT result = State.DX.Device->EndScene();
+            State.Commands.Current.States[x] = value;
+            State.Commands.Device.States[x] = value;
+        }
 
-            State.Scene.IsActive = FALSE;
+        ZeroMemory(State.Commands.Current.Textures, MAX_TEXTURE_STAGE_COUNT * sizeof(IDirectDrawSurface7*));
+        ZeroMemory(State.Commands.Device.Textures, MAX_TEXTURE_STAGE_COUNT * sizeof(IDirectDrawSurface7*));
 
-            return result == DD_OK;
+        InitializeRendererThread();
+    }
+
+    s32 AcquireRendererCommandStateIndex(const D3DRENDERSTATETYPE type)
+    {
+        for (u32 x = 0; x < MAX_COMMAND_STATE_COUNT; x++)
+        {
+            if (RendererCommandStates[x] == type) { return x; }
         }
 
-        return TRUE;
+        return INVALID_COMMAND_STATE_INDEX;
     }
 
-    // 0x6000ab00
-    u32 SelectRendererTransforms(const f32 zNear, const f32 zFar)
+    DWORD AcquireRendererCommandState(const u32 key, const u32 state)
     {
-        if ((zFar <= zNear) != (zFar == zNear)) { return TRUE; }
+        u32 shift = 0;
 
-        D3DMATRIX world;
+        for (u32 x = 0; x < state; x++) { shift = shift + RendererCommandStateBits[x]; }
 
-        world._11 = 1.0f;
-        world._12 = 0.0f;
-        world._13 = 0.0f;
-        world._14 = 0.0f;
+        return (key >> shift) & ((1 << RendererCommandStateBits[state]) - 1);
+    }
 
-        world._21 = 0.0f;
-        world._22 = 1.0f;
-        world._23 = 0.0f;
-        world._24 = 0.0f;
+    // NOTE: The key packs the command states into the lower bits, and the ordinal of the texture pair
+    // in the per-frame texture table into the upper bits, so that the sorted commands are grouped by textures first.
+    u32 AcquireRendererCommandKey(void)
+    {
+        u32 key = 0;
+        u32 shift = 0;
 
-        world._31 = 0.0f;
-        world._32 = 0.0f;
-        world._33 = 1.0f;
-        world._34 = 0.0f;
+        for (u32 x = 0; x < MAX_COMMAND_STATE_COUNT; x++)
+        {
+            key = key | ((State.Commands.Current.States[x] & ((1 << RendererCommandStateBits[x]) - 1)) << shift);
 
-        world._41 = 0.0f;
-        world._42 = 0.0f;
-        world._43 = 0.0f;
-        world._44 = 1.0f;
+            shift = shift + RendererCommandStateBits[x];
+        }
 
-        D3DMATRIX view;
+        RendererCommandBuffer* buffer = &State.Commands.Buffers[State.Commands.Index];
 
-        view._11 = 1.0f;
-        view._12 = 0.0f;
-        view._13 = 0.0f;
-        view._14 = 0.0f;
+        u32 indx = buffer->Textures.Count;
 
-        view._21 = 0.0f;
-        view._22 = 1.0f;
-        view._23 = 0.0f;
-        view._24 = 0.0f;
+        while (indx != 0)
+        {
+            IDirectDrawSurface7** textures = buffer->Textures.Textures[indx - 1];
 
-        view._31 = 0.0f;
-        view._32 = 0.0f;
-        view._33 = 1.0f;
-        view._34 = 0.0f;
+            if (textures[RENDERER_TEXTURE_STAGE_0] == State.Commands.Current.Textures[RENDERER_TEXTURE_STAGE_0]
+                && textures[RENDERER_TEXTURE_STAGE_1] == State.Commands.Current.Textures[RENDERER_TEXTURE_STAGE_1]) { break; }
 
-        view._41 = 0.0f;
-        view._42 = 0.0f;
-        view._43 = 0.0f;
-        view._44 = 1.0f;
+            indx = indx - 1;
+        }
 
-        D3DMATRIX projection;
+        if (indx == 0)
+        {
+            CopyMemory(buffer->Textures.Textures[buffer->Textures.Count],
+                State.Commands.Current.Textures, MAX_COMMAND_TEXTURE_STAGE_COUNT * sizeof(IDirectDrawSurface7*));
 
-        projection._11 = 1.0f;
-        projection._12 = 0.0f;
-        projection._13 = 0.0f;
-        projection._14 = 0.0f;
+            buffer->Textures.Count = buffer->Textures.Count + 1;
 
-        projection._21 = 0.0f;
-        projection._22 = 1.0f;
-        projection._23 = 0.0f;
-        projection._24 = 0.0f;
+            indx = buffer->Textures.Count;
+        }
 
-        projection._31 = 0.0f;
-        projection._32 = 0.0f;
-        projection._33 = 1.0f;
-        projection._34 = 0.0f;
+        return key | ((indx - 1) << RENDERER_COMMAND_KEY_TEXTURE_SHIFT);
+    }
 
-        projection._41 = 0.0f;
-        projection._42 = 0.0f;
-        projection._43 = 0.0f;
-        projection._44 = 1.0f;
+    // NOTE: Records the current batch as a draw command instead of drawing it right away.
+    void AppendRendererCommand(void)
+    {
+        const u32 size = State.Data.Vertexes.Count * RendererVertexSize;
 
-        HRESULT result = State.DX.Device->SetTransform(D3DTRANSFORMSTATE_WORLD, &world);
+        RendererCommandBuffer* buffer = &State.Commands.Buffers[State.Commands.Index];
 
-        if (result == DD_OK)
+        if (MAX_COMMAND_COUNT <= buffer->Count
+            || MAX_COMMAND_TEXTURE_COUNT <= buffer->Textures.Count
+            || (MAX_COMMAND_VERTEX_COUNT * sizeof(u32)) < (buffer->Vertexes.Size + size)
+            || MAX_COMMAND_INDEX_COUNT < (buffer->Indexes.Count + State.Data.Indexes.Count))
         {
-            result = State.DX.Device->SetTransform(D3DTRANSFORMSTATE_VIEW, &view);
+            if (State.Thread.IsActive) { SubmitRendererCommands(RENDERER_THREAD_COMMAND_RENDER); }
+            else { RenderRendererCommands(); }
 
-            if (result == DD_OK)
-            {
-                projection._44 = zNear;
-                projection._34 = 1.0f;
-                projection._33 = zNear / (zFar - zNear) + 1.0f;
-                projection._43 = 0.0f;
-
-                result = State.DX.Device->SetTransform(D3DTRANSFORMSTATE_PROJECTION, &projection);
-            }
+            buffer = &State.Commands.Buffers[State.Commands.Index];
         }
 
-        return result;
-    }
+        RendererCommand* command = &buffer->Commands[buffer->Count];
 
-    // 0x6000c110
-    void AcquireRendererDeviceTextureFormats(void)
-    {
-        State.Textures.Formats.Count = 0;
+        command->Key = AcquireRendererCommandKey();
+        command->Type = RendererPrimitiveType;
+        command->Mesh = NULL;
 
-        s32 count = INVALID_TEXTURE_FORMAT_COUNT;
-        State.DX.Device->EnumTextureFormats(EnumerateRendererDeviceTextureFormats, &count);
+        command->Vertexes.Offset = buffer->Vertexes.Size;
+        command->Vertexes.Count = State.Data.Vertexes.Count;
 
-        State.Textures.Formats.Indexes[0] = INVALID_TEXTURE_FORMAT_INDEX;
-        State.Textures.Formats.Indexes[1] = AcquireRendererDeviceTextureFormatIndex(4, 0, 0, 0, 0, 0, 0);
-        State.Textures.Formats.Indexes[2] = AcquireRendererDeviceTextureFormatIndex(8, 0, 0, 0, 0, 0, 0);
-        State.Textures.Formats.Indexes[3] = AcquireRendererDeviceTextureFormatIndex(0, 1, 5, 5, 5, 0, 0);
-        State.Textures.Formats.Indexes[4] = AcquireRendererDeviceTextureFormatIndex(0, 0, 5, 6, 5, 0, 0);
-        State.Textures.Formats.Indexes[5] = INVALID_TEXTURE_FORMAT_INDEX;
-        State.Textures.Formats.Indexes[6] = AcquireRendererDeviceTextureFormatIndex(0, 8, 8, 8, 8, 0, 0);
-        State.Textures.Formats.Indexes[7] = AcquireRendererDeviceTextureFormatIndex(0, 4, 4, 4, 4, 0, 0);
-        State.Textures.Formats.Indexes[12] = AcquireRendererDeviceTextureFormatIndex(0, 0, 0, 0, 0, 1, 0);
-        State.Textures.Formats.Indexes[13] = AcquireRendererDeviceTextureFormatIndex(0, 0, 0, 0, 0, 3, 0);
-        State.Textures.Formats.Indexes[14] = INVALID_TEXTURE_FORMAT_INDEX;
-        State.Textures.Formats.Indexes[15] = INVALID_TEXTURE_FORMAT_INDEX;
-        State.Textures.Formats.Indexes[16] = INVALID_TEXTURE_FORMAT_INDEX;
-        State.Textures.Formats.Indexes[17] = INVALID_TEXTURE_FORMAT_INDEX;
-        State.Textures.Formats.Indexes[18] = AcquireRendererDeviceTextureFormatIndex(0, 0, 8, 8, 0, 0, 1);
-        State.Textures.Formats.Indexes[19] = AcquireRendererDeviceTextureFormatIndex(0, 0, 8, 8, 8, 0, 2);
-        State.Textures.Formats.Indexes[20] = AcquireRendererDeviceTextureFormatIndex(0, 0, 5, 5, 6, 0, 3);
+        command->Indexes.Offset = buffer->Indexes.Count;
+        command->Indexes.Count = State.Data.Indexes.Count;
 
-        RendererTextureFormatStates[0] = 0; // TODO
-        RendererTextureFormatStates[1] = State.Textures.Formats.Indexes[1] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[2] = State.Textures.Formats.Indexes[2] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[4] = State.Textures.Formats.Indexes[4] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[5] = State.Textures.Formats.Indexes[5] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[6] = State.Textures.Formats.Indexes[6] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[7] = State.Textures.Formats.Indexes[7] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[12] = State.Textures.Formats.Indexes[12] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[13] = State.Textures.Formats.Indexes[13] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[14] = State.Textures.Formats.Indexes[14] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[15] = State.Textures.Formats.Indexes[15] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[16] = State.Textures.Formats.Indexes[16] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[17] = State.Textures.Formats.Indexes[17] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[18] = State.Textures.Formats.Indexes[18] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[19] = State.Textures.Formats.Indexes[19] != INVALID_TEXTURE_FORMAT_INDEX;
-        RendererTextureFormatStates[20] = State.Textures.Formats.Indexes[20] != INVALID_TEXTURE_FORMAT_INDEX;
+        CopyMemory((void*)((addr)buffer->Vertexes.Vertexes + (addr)command->Vertexes.Offset),
+            State.Data.Vertexes.Vertexes, size);
+        CopyMemory(&buffer->Indexes.Indexes[command->Indexes.Offset],
+            State.Data.Indexes.Indexes, State.Data.Indexes.Count * sizeof(u16));
 
-        if (State.Textures.Formats.Indexes[3] == INVALID_TEXTURE_FORMAT_INDEX)
-        {
-            State.Textures.Formats.Indexes[3] = AcquireRendererDeviceTextureFormatIndex(0, 0, 5, 5, 5, 0, 0);
-            RendererTextureFormatStates[3] = (State.Textures.Formats.Indexes[3] != INVALID_TEXTURE_FORMAT_INDEX) ? 5 : 0; // TODO
-        }
-        else
-        {
-            RendererTextureFormatStates[3] = 1;
-        }
+        buffer->Vertexes.Size = buffer->Vertexes.Size + size;
+        buffer->Indexes.Count = buffer->Indexes.Count + State.Data.Indexes.Count;
+
+        buffer->Count = buffer->Count + 1;
     }
 
-    // 0x6000c450
-    HRESULT CALLBACK EnumerateRendererDeviceTextureFormats(LPDDPIXELFORMAT format, LPVOID context)
+    // NOTE: Records the draw of the cached mesh, the vertexes and indexes are not copied, the command refers to the mesh instead.
+    void AppendRendererMeshCommand(RendererMesh* mesh)
     {
-        ZeroMemory(&State.Textures.Formats.Formats[State.Textures.Formats.Count], sizeof(TextureFormat));
+        RendererCommandBuffer* buffer = &State.Commands.Buffers[State.Commands.Index];
 
-        CopyMemory(&State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat, format, sizeof(DDPIXELFORMAT));
+        if (MAX_COMMAND_COUNT <= buffer->Count || MAX_COMMAND_TEXTURE_COUNT <= buffer->Textures.Count)
+        {
+            if (State.Thread.IsActive) { SubmitRendererCommands(RENDERER_THREAD_COMMAND_RENDER); }
+            else { RenderRendererCommands(); }
 
-        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_NONE;
+            buffer = &State.Commands.Buffers[State.Commands.Index];
+        }
 
-        if (format->dwFlags & DDPF_FOURCC)
-        {
-            if (format->dwFourCC == FOURCC_DXT1)
-            {
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_DXT1;
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTN = FOURCC_DXT1;
-            }
-            else if (format->dwFourCC == FOURCC_DXT2)
-            {
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_DXT2;
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTN = FOURCC_DXT2;
-            }
-            else if (format->dwFourCC == FOURCC_DXT3)
+        RendererCommand* command = &buffer->Commands[buffer->Count];
+
+        command->Key = AcquireRendererCommandKey();
+        command->Type = D3DPT_TRIANGLELIST;
+        command->Mesh = mesh;
+
+        command->Vertexes.Offset = 0;
+        command->Vertexes.Count = mesh->Vertexes.Count;
+
+        command->Indexes.Offset = 0;
+        command->Indexes.Count = mesh->Indexes.Count;
+
+        buffer->Count = buffer->Count + 1;
+    }
+
+    s32 CompareRendererCommands(const void* a, const void* b)
+    {
+        const u64 ka = *(u64*)a;
+        const u64 kb = *(u64*)b;
+
+        return ka < kb ? -1 : (kb < ka ? 1 : 0);
+    }
+
+    void SelectRendererCommandState(const DWORD* states, IDirectDrawSurface7** textures)
+    {
+        for (u32 x = 0; x < MAX_COMMAND_STATE_COUNT; x++)
+        {
+            if (State.Commands.Device.States[x] != states[x])
             {
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_DXT3;
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTN = FOURCC_DXT3;
+                State.DX.Device->SetRenderState(RendererCommandStates[x], states[x]);
+
+                State.Commands.Device.States[x] = states[x];
             }
         }
 
-        if (format->dwFlags & DDPF_PALETTEINDEXED8)
+        for (u32 x = 0; x < MAX_COMMAND_TEXTURE_STAGE_COUNT; x++)
         {
-            State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = TRUE;
-            State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 8;
-            State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
-        }
-        else
-        {
-            if (format->dwFlags & DDPF_PALETTEINDEXED4)
+            if (State.Commands.Device.Textures[x] != textures[x])
             {
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = TRUE;
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 4;
-                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
+                State.DX.Device->SetTexture(x, textures[x]);
+
+                State.Commands.Device.Textures[x] = textures[x];
             }
-            else
+        }
+    }
+
+    // NOTE: The opaque commands, that neither blend nor pass the depth test on equal depth, produce the same image in any order,
+    // as either of the strict comparisons keeps the nearest, or the farthest, of the depth values regardless of the order.
+    // The commands that pass on equal depth, such as the coplanar decals drawn with D3DCMP_LESSEQUAL, rely on the recorded order.
+    BOOL IsRendererCommandOpaque(const u32 key)
+    {
+        if (AcquireRendererCommandState(key, RENDERER_COMMAND_STATE_ALPHA_BLEND_ENABLE)) { return FALSE; }
+
+        if (!AcquireRendererCommandState(key, RENDERER_COMMAND_STATE_DEPTH_WRITE_ENABLE)) { return FALSE; }
+
+        // NOTE: The key holds the device comparison, which is mirrored from D3DCMP_LESS into D3DCMP_GREATER
+        // while the frame is drawn into the inverted upper half of the depth range.
+        const DWORD function = AcquireRendererCommandState(key, RENDERER_COMMAND_STATE_DEPTH_FUNCTION);
+
+        return function == D3DCMP_LESS || function == D3DCMP_GREATER;
+    }
+
+    // NOTE: Submits the recorded commands of the buffer, and returns the number of the draw calls made.
+    // Only the consecutive opaque commands are sorted by the key, every other command stays in its recorded place,
+    // so that none of the opaque commands is moved across a command it could be drawn under or over.
+    // Adjacent commands with matching keys are merged into a single draw call.
+    // This is called either from the render thread, or from the game thread while the render thread is idle.
+    u32 RenderRendererCommandBuffer(RendererCommandBuffer* buffer)
+    {
+        u32 result = 0;
+
+        if (buffer->Count != 0)
+        {
+            u32 length = 0;
+            u32 start = 0;
+
+            while (start < buffer->Count)
             {
-                if (format->dwFlags & DDPF_RGB)
+                u32 end = start;
+
+                while (end < buffer->Count && IsRendererCommandOpaque(buffer->Commands[end].Key))
                 {
-                    State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = FALSE;
-                    State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+                    State.Commands.Order[length + end - start] = ((u64)buffer->Commands[end].Key << 32) | end;
 
-                    u32 red = 0;
+                    end = end + 1;
+                }
 
-                    {
-                        u32 value = format->dwRBitMask;
+                // NOTE: The record index in the lower bits keeps the sort stable for the commands with matching keys.
+                if (1 < end - start) { qsort(&State.Commands.Order[length], end - start, sizeof(u64), CompareRendererCommands); }
 
-                        while ((value & 1) == 0) { value = value >> 1; }
+                length = length + end - start;
 
-                        while ((value & 1) != 0) { red = red + 1; value = value >> 1; }
-                    }
+                if (end < buffer->Count)
+                {
+                    State.Commands.Order[length] = ((u64)buffer->Commands[end].Key << 32) | end;
 
-                    u32 green = 0;
+                    length = length + 1;
+                }
 
-                    {
-                        u32 value = format->dwGBitMask;
+                start = end + 1;
+            }
 
-                        while ((value & 1) == 0) { value = value >> 1; }
+            for (u32 x = 0; x < length;)
+            {
+                const RendererCommand* command = &buffer->Commands[(u32)State.Commands.Order[x]];
 
-                        while ((value & 1) != 0) { green = green + 1; value = value >> 1; }
-                    }
+                {
+                    DWORD states[MAX_COMMAND_STATE_COUNT];
 
-                    u32 blue = 0;
+                    for (u32 xx = 0; xx < MAX_COMMAND_STATE_COUNT; xx++) { states[xx] = AcquireRendererCommandState(command->Key, xx); }
 
-                    {
-                        u32 value = format->dwBBitMask;
+                    IDirectDrawSurface7* textures[MAX_TEXTURE_STAGE_COUNT];
 
-                        while ((value & 1) == 0) { value = value >> 1; }
+                    CopyMemory(textures, buffer->Textures.Textures[command->Key >> RENDERER_COMMAND_KEY_TEXTURE_SHIFT],
+                        MAX_COMMAND_TEXTURE_STAGE_COUNT * sizeof(IDirectDrawSurface7*));
 
-                        while ((value & 1) != 0) { blue = blue + 1; value = value >> 1; }
-                    }
+                    SelectRendererCommandState(states, textures);
+                }
 
-                    State.Textures.Formats.Formats[State.Textures.Formats.Count].RedBitCount = red;
-                    State.Textures.Formats.Formats[State.Textures.Formats.Count].GreenBitCount = green;
-                    State.Textures.Formats.Formats[State.Textures.Formats.Count].BlueBitCount = blue;
+                u32 next = x + 1;
 
-                    if (format->dwFlags & DDPF_ALPHAPIXELS)
+                if (command->Mesh == NULL && (command->Type == D3DPT_TRIANGLELIST || command->Type == D3DPT_LINELIST))
+                {
+                    u32 size = command->Vertexes.Count * RendererVertexSize;
+                    u32 count = command->Indexes.Count;
+
+                    while (next < length)
                     {
-                        u32 alpha = 0;
+                        const RendererCommand* c = &buffer->Commands[(u32)State.Commands.Order[next]];
 
-                        {
-                            u32 value = format->dwRGBAlphaBitMask;
+                        if (c->Key != command->Key || c->Type != command->Type || c->Mesh != NULL) { break; }
 
-                            while ((value & 1) == 0) { value = value >> 1; }
+                        if ((MAX_VERTEX_COUNT * sizeof(u32)) < (size + c->Vertexes.Count * RendererVertexSize)
+                            || MAX_LARGE_INDEX_COUNT < (count + c->Indexes.Count)) { break; }
 
-                            while ((value & 1) != 0) { alpha = alpha + 1; value = value >> 1; }
-                        }
+                        size = size + c->Vertexes.Count * RendererVertexSize;
+                        count = count + c->Indexes.Count;
 
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].AlphaBitCount = alpha;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
-                    }
-                    else
-                    {
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].AlphaBitCount = 0;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
+                        next = next + 1;
                     }
                 }
+
+                if (command->Mesh != NULL)
+                {
+                    State.DX.Device->DrawIndexedPrimitiveVB(command->Type, command->Mesh->Vertexes.Buffer, 0, command->Mesh->Vertexes.Count,
+                        command->Mesh->Indexes.Indexes, command->Mesh->Indexes.Count, 0);
+                }
+                else if (next == x + 1)
+                {
+                    State.DX.Device->DrawIndexedPrimitive(command->Type, RendererVertexType,
+                        (void*)((addr)buffer->Vertexes.Vertexes + (addr)command->Vertexes.Offset), command->Vertexes.Count,
+                        &buffer->Indexes.Indexes[command->Indexes.Offset], command->Indexes.Count, 0);
+                }
                 else
                 {
-                    if (format->dwFlags & DDPF_BUMPLUMINANCE)
+                    u32 vertexes = 0;
+                    u32 indexes = 0;
+
+                    for (u32 xx = x; xx < next; xx++)
                     {
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = FALSE;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+                        const RendererCommand* c = &buffer->Commands[(u32)State.Commands.Order[xx]];
 
-                        u32 red = 0;
+                        CopyMemory((void*)((addr)State.Commands.Merge.Vertexes + (addr)(vertexes * RendererVertexSize)),
+                            (void*)((addr)buffer->Vertexes.Vertexes + (addr)c->Vertexes.Offset), c->Vertexes.Count * RendererVertexSize);
 
+                        for (u32 i = 0; i < c->Indexes.Count; i++)
                         {
-                            u32 value = format->dwRBitMask;
-
-                            while ((value & 1) == 0) { value = value >> 1; }
-
-                            while ((value & 1) != 0) { red = red + 1; value = value >> 1; }
+                            State.Commands.Merge.Indexes[indexes + i] = (u16)(buffer->Indexes.Indexes[c->Indexes.Offset + i] + vertexes);
                         }
 
-                        u32 green = 0;
+                        vertexes = vertexes + c->Vertexes.Count;
+                        indexes = indexes + c->Indexes.Count;
+                    }
 
-                        {
-                            u32 value = format->dwGBitMask;
+                    State.DX.Device->DrawIndexedPrimitive(command->Type, RendererVertexType,
+                        State.Commands.Merge.Vertexes, vertexes, State.Commands.Merge.Indexes, indexes, 0);
+                }
 
-                            while ((value & 1) == 0) { value = value >> 1; }
+                result = result + 1;
 
-                            while ((value & 1) != 0) { green = green + 1; value = value >> 1; }
-                        }
+                x = next;
+            }
 
-                        u32 blue = 0;
+            buffer->Count = 0;
+            buffer->Vertexes.Size = 0;
+            buffer->Indexes.Count = 0;
+            buffer->Textures.Count = 0;
+        }
 
-                        {
-                            u32 value = format->dwBBitMask;
+        return result;
+    }
 
-                            while ((value & 1) == 0) { value = value >> 1; }
+    // NOTE: Submits the commands recorded so far, after the render thread, if any, is done with its work.
+    // The device is left in the currently selected state.
+    void RenderRendererCommands(void)
+    {
+        WaitRendererThread();
 
-                            while ((value & 1) != 0) { blue = blue + 1; value = value >> 1; }
-                        }
+        RendererCommandBuffer* buffer = &State.Commands.Buffers[State.Commands.Index];
 
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].RedBitCount = red;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].GreenBitCount = green;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].BlueBitCount = blue;
+        if (buffer->Count != 0)
+        {
+            if (!State.Scene.IsActive) { BeginRendererScene(); }
 
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = (red == 5 && green == 5 && blue == 6) ? 3 : 2; // TODO
-                    }
-                    else if (format->dwFlags & DDPF_BUMPDUDV)
-                    {
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = FALSE;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+            State.Commands.Statistics.Current.Submitted = State.Commands.Statistics.Current.Submitted + RenderRendererCommandBuffer(buffer);
+        }
 
-                        u32 red = 0;
+        if (State.Commands.IsActive) { SelectRendererCommandState(State.Commands.Current.States, State.Commands.Current.Textures); }
+    }
 
-                        {
-                            u32 value = format->dwRBitMask;
+    // NOTE: Hands the recorded commands over to the render thread, and switches the recording to the other buffer.
+    // The other buffer may still be in use by the render thread, thus it has to finish first.
+    void SubmitRendererCommands(const u32 type)
+    {
+        WaitRendererThread();
 
-                            while ((value & 1) == 0) { value = value >> 1; }
+        const u32 indx = State.Commands.Index;
 
-                            while ((value & 1) != 0) { red = red + 1; value = value >> 1; }
-                        }
+        State.Commands.Index = (indx + 1) % MAX_COMMAND_BUFFER_COUNT;
 
-                        u32 green = 0;
+        SubmitRendererThreadCommand(type, &State.Commands.Buffers[indx]);
+    }
 
-                        {
-                            u32 value = format->dwGBitMask;
+    void SubmitRendererThreadCommand(const u32 type, RendererCommandBuffer* buffer)
+    {
+        while (IsRendererRingFull(&State.Thread.Ring)) { WaitForSingleObject(State.Thread.Idle, INFINITE); }
 
-                            while ((value & 1) == 0) { value = value >> 1; }
+        RendererThreadCommand* command = &State.Thread.Commands[AcquireRendererRingWrite(&State.Thread.Ring)];
 
-                            while ((value & 1) != 0) { green = green + 1; value = value >> 1; }
-                        }
+        command->Type = type;
+        command->Buffer = buffer;
 
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].RedBitCount = red;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].GreenBitCount = green;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].BlueBitCount = 0;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 1; // TODO
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwRBitMask = 0xff;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwGBitMask = 0xff00;
-                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwBBitMask = 0;
-                    }
-                }
-            }
-        }
+        CommitRendererRingWrite(&State.Thread.Ring);
 
-        if (*(s32*)context == INVALID_TEXTURE_FORMAT_COUNT)
-        {
-            *(s32*)context = State.Textures.Formats.Count;
-        }
+        SetEvent(State.Thread.Work);
+    }
 
-        // NOTE: Added check to avoid writing outside the array boundaries.
-        if (MAX_TEXTURE_FORMAT_COUNT <= State.Textures.Formats.Count + 1) { return DDENUMRET_CANCEL; }
+    // NOTE: Blocks the game thread until the render thread has drained all of the submitted commands.
+    // Every call that touches the device outside of the recorded commands has to go through here first.
+    void WaitRendererThread(void)
+    {
+        if (!State.Thread.IsActive || GetCurrentThreadId() == State.Thread.ID) { return; }
 
-        State.Textures.Formats.Count = State.Textures.Formats.Count + 1;
+        while (!IsRendererRingEmpty(&State.Thread.Ring)) { WaitForSingleObject(State.Thread.Idle, INFINITE); }
 
-        return DDENUMRET_OK;
+        State.Commands.Statistics.Current.Submitted = State.Commands.Statistics.Current.Submitted + State.Thread.Submitted;
+
+        State.Thread.Submitted = 0;
     }
 
-    // 0x6000c3c0
-    s32 AcquireRendererDeviceTextureFormatIndex(const u32 palette, const u32 alpha, const u32 red, const u32 green, const u32 blue, const u32 dxtf, const u32 dxtt)
+    // NOTE: The render thread is the only consumer of the command ring, while the game thread is the only producer.
+    // Presenting ends the scene, flips, and opens the next scene right away, so that the scene stays active as seen by the game thread.
+    DWORD WINAPI ExecuteRendererThread(LPVOID)
     {
-        for (u32 x = 0; x < State.Textures.Formats.Count; x++)
+        while (TRUE)
         {
-            const TextureFormat* format = &State.Textures.Formats.Formats[x];
+            WaitForSingleObject(State.Thread.Work, INFINITE);
 
-            if (format->RedBitCount == red && format->GreenBitCount == green && format->BlueBitCount == blue)
+            while (!IsRendererRingEmpty(&State.Thread.Ring))
             {
-                if (format->PaletteColorBits == palette)
+                const RendererThreadCommand* command = &State.Thread.Commands[AcquireRendererRingRead(&State.Thread.Ring)];
+
+                const u32 type = command->Type;
+
+                if (type != RENDERER_THREAD_COMMAND_EXIT)
                 {
-                    if (format->AlphaBitCount == alpha && format->DXTF == dxtf && format->DXTT == dxtt) { return x; }
-                    else if (format->PaletteColorBits == palette && palette != 0) { return x; }
+                    State.Thread.Submitted = State.Thread.Submitted + RenderRendererCommandBuffer(command->Buffer);
+
+                    if (type == RENDERER_THREAD_COMMAND_PRESENT)
+                    {
+                        State.DX.Device->EndScene();
+
+                        State.DX.Active.Surfaces.Main->Flip(NULL, RendererToggleOptions);
+
+                        State.DX.Device->BeginScene();
+                    }
                 }
+
+                CommitRendererRingRead(&State.Thread.Ring);
+
+                SetEvent(State.Thread.Idle);
+
+                if (type == RENDERER_THREAD_COMMAND_EXIT) { return 0; }
             }
-            else if (format->PaletteColorBits == palette && palette != 0) { return x; }
         }
 
-        return INVALID_TEXTURE_FORMAT_INDEX;
+        return 0;
     }
 
-    // 0x6000a130
-    // a.k.a. createzbuffer
-    BOOL InitializeRendererDeviceDepthSurfaces(const u32 width, const u32 height, IDirectDrawSurface7* depth, IDirectDrawSurface7* surf)
+    void InitializeRendererThread(void)
     {
-        if (State.Device.Capabilities.IsDepthBufferRemovalAvailable) { return TRUE; }
+        if (State.Thread.IsActive || !State.Commands.IsActive || !SettingsState.RenderThread) { return; }
 
-        IDirectDrawSurface7* ds = surf == NULL ? State.DX.Surfaces.Depth : depth;
+        InitializeRendererRing(&State.Thread.Ring, MAX_THREAD_COMMAND_COUNT);
 
-        DDPIXELFORMAT format;
-        ZeroMemory(&format, sizeof(DDPIXELFORMAT));
+        State.Thread.Submitted = 0;
 
+        State.Thread.Work = CreateEventA(NULL, FALSE, FALSE, NULL);
+        State.Thread.Idle = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+        if (State.Thread.Work != NULL && State.Thread.Idle != NULL)
         {
-            const HRESULT result = State.DX.DirectX->EnumZBufferFormats(IID_IDirect3DHALDevice, EnumerateRendererDevicePixelFormats, &format);
+            State.Thread.Thread = CreateThread(NULL, 0, ExecuteRendererThread, NULL, 0, &State.Thread.ID);
 
-            if (result != DD_OK) { LOGERROR("EnumZBufferFormats failure! %8x\n", result); }
-        }
+            if (State.Thread.Thread != NULL)
+            {
+                State.Thread.IsActive = TRUE;
 
-        if (format.dwSize != sizeof(DDPIXELFORMAT)) { return FALSE; }
+                return;
+            }
+        }
 
-        DDSURFACEDESC2 desc;
-        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+        LOGWARNING("Unable to create the render thread, rendering on the game thread instead.\n");
 
-        desc.dwSize = sizeof(DDSURFACEDESC2);
-        desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
-        desc.dwHeight = height;
-        desc.dwWidth = width;
+        if (State.Thread.Work != NULL) { CloseHandle(State.Thread.Work); State.Thread.Work = NULL; }
+        if (State.Thread.Idle != NULL) { CloseHandle(State.Thread.Idle); State.Thread.Idle = NULL; }
+    }
 
-        CopyMemory(&desc.ddpfPixelFormat, &format, sizeof(DDPIXELFORMAT));
+    void ReleaseRendererThread(void)
+    {
+        if (!State.Thread.IsActive) { return; }
 
-        State.Device.Capabilities.IsStencilBufferAvailable = (format.dwFlags & DDPF_STENCILBUFFER) != 0;
+        WaitRendererThread();
 
-        desc.ddsCaps.dwCaps = State.Device.Capabilities.IsAccelerated
-            ? DDSCAPS_ZBUFFER | DDSCAPS_VIDEOMEMORY
-            : DDSCAPS_ZBUFFER | DDSCAPS_SYSTEMMEMORY;
+        SubmitRendererThreadCommand(RENDERER_THREAD_COMMAND_EXIT, NULL);
 
-        {
-            const HRESULT result = State.DX.Active.Instance->CreateSurface(&desc, &ds, NULL);
+        WaitForSingleObject(State.Thread.Thread, INFINITE);
 
-            if (result != DD_OK)
-            {
-                LOGERROR("CreateSurface failure! %s\n", AcquireRendererMessage(result));
+        CloseHandle(State.Thread.Thread);
+        CloseHandle(State.Thread.Work);
+        CloseHandle(State.Thread.Idle);
 
-                if (result != DDERR_OUTOFMEMORY && result != DDERR_OUTOFVIDEOMEMORY)
-                {
-                    LOGWARNING("CreateSurface for Z-buffer failed %s.\n", AcquireRendererMessage(result));
+        State.Thread.Thread = NULL;
+        State.Thread.Work = NULL;
+        State.Thread.Idle = NULL;
+        State.Thread.ID = 0;
 
-                    return FALSE;
-                }
+        State.Thread.IsActive = FALSE;
+    }
 
-                LOGWARNING("There was not enough video memory to create the Z-buffer surface.\nPlease restart the program and try another fullscreen mode with less resolution or lower bit depth.\n");
+    // 0x60008810
+    BOOL BeginRendererScene(void)
+    {
+        WaitRendererThread();
 
-                return FALSE;
-            }
-        }
+        if (State.Lock.IsActive) { UnlockGameWindow(NULL); }
 
-        {
-            IDirectDrawSurface7* s = surf != NULL ? surf
-                : (State.DX.Active.Surfaces.Back == NULL ? State.DX.Active.Surfaces.Main : State.DX.Active.Surfaces.Back);
+        State.Scene.IsActive = State.DX.Device->BeginScene() == DD_OK;
+
+        return State.Scene.IsActive;
+    }
+
+    // 0x60008860
+    BOOL EndRendererScene(void)
+    {
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        RenderRendererCommands();
+
+        if (State.Scene.IsActive)
+        {
+            RendererDepthBias = 0.0f;
+
+            SelectRendererVertexTransforms();
+
+            const HRESULT result = State.DX.Device->EndScene();
+
+            State.Scene.IsActive = FALSE;
+
+            return result == DD_OK;
+        }
+
+        return TRUE;
+    }
+
+    // Keeps the statistics of the completed frame, and advances the frame counters of the textures and the meshes.
+    void CommitRendererFrame(void)
+    {
+        State.Commands.Statistics.Previous = State.Commands.Statistics.Current;
+
+        State.Commands.Statistics.Current.Recorded = 0;
+        State.Commands.Statistics.Current.Submitted = 0;
+
+        State.Meshes.Statistics.Previous = State.Meshes.Statistics.Current;
+
+        State.Meshes.Statistics.Current.Hits = 0;
+        State.Meshes.Statistics.Current.Misses = 0;
+
+        State.Textures.Statistics.Previous = State.Textures.Statistics.Current;
+
+        State.Textures.Statistics.Current.Uploads = 0;
+        State.Textures.Statistics.Current.Skipped = 0;
+        State.Textures.Statistics.Current.Evicted = 0;
+        State.Textures.Statistics.Current.Reloaded = 0;
+        State.Textures.Statistics.Current.Batched = 0;
+
+        State.Textures.Frame = State.Textures.Frame + 1;
+
+        State.Meshes.Frame = State.Meshes.Frame + 1;
+
+        State.DepthRange.IsCleared = FALSE;
+
+        State.Shadow.Filtered = 0;
+    }
+
+    // 0x6000ab00
+    u32 SelectRendererTransforms(const f32 zNear, const f32 zFar)
+    {
+        if ((zFar <= zNear) != (zFar == zNear)) { return TRUE; }
+
+        D3DMATRIX world;
+
+        world._11 = 1.0f;
+        world._12 = 0.0f;
+        world._13 = 0.0f;
+        world._14 = 0.0f;
+
+        world._21 = 0.0f;
+        world._22 = 1.0f;
+        world._23 = 0.0f;
+        world._24 = 0.0f;
+
+        world._31 = 0.0f;
+        world._32 = 0.0f;
+        world._33 = 1.0f;
+        world._34 = 0.0f;
+
+        world._41 = 0.0f;
+        world._42 = 0.0f;
+        world._43 = 0.0f;
+        world._44 = 1.0f;
+
+        D3DMATRIX view;
+
+        view._11 = 1.0f;
+        view._12 = 0.0f;
+        view._13 = 0.0f;
+        view._14 = 0.0f;
+
+        view._21 = 0.0f;
+        view._22 = 1.0f;
+        view._23 = 0.0f;
+        view._24 = 0.0f;
+
+        view._31 = 0.0f;
+        view._32 = 0.0f;
+        view._33 = 1.0f;
+        view._34 = 0.0f;
+
+        view._41 = 0.0f;
+        view._42 = 0.0f;
+        view._43 = 0.0f;
+        view._44 = 1.0f;
+
+        D3DMATRIX projection;
+
+        projection._11 = 1.0f;
+        projection._12 = 0.0f;
+        projection._13 = 0.0f;
+        projection._14 = 0.0f;
+
+        projection._21 = 0.0f;
+        projection._22 = 1.0f;
+        projection._23 = 0.0f;
+        projection._24 = 0.0f;
+
+        projection._31 = 0.0f;
+        projection._32 = 0.0f;
+        projection._33 = 1.0f;
+        projection._34 = 0.0f;
+
+        projection._41 = 0.0f;
+        projection._42 = 0.0f;
+        projection._43 = 0.0f;
+        projection._44 = 1.0f;
+
+        HRESULT result = State.DX.Device->SetTransform(D3DTRANSFORMSTATE_WORLD, &world);
+
+        if (result == DD_OK)
+        {
+            result = State.DX.Device->SetTransform(D3DTRANSFORMSTATE_VIEW, &view);
+
+            if (result == DD_OK)
+            {
+                projection._44 = zNear;
+                projection._34 = 1.0f;
+                projection._33 = zNear / (zFar - zNear) + 1.0f;
+                projection._43 = 0.0f;
+
+                result = State.DX.Device->SetTransform(D3DTRANSFORMSTATE_PROJECTION, &projection);
+            }
+        }
+
+        return result;
+    }
+
+    // 0x6000c110
+    void AcquireRendererDeviceTextureFormats(void)
+    {
+        State.Textures.Formats.Count = 0;
+
+        s32 count = INVALID_TEXTURE_FORMAT_COUNT;
+        State.DX.Device->EnumTextureFormats(EnumerateRendererDeviceTextureFormats, &count);
+
+        State.Textures.Formats.Indexes[0] = INVALID_TEXTURE_FORMAT_INDEX;
+        State.Textures.Formats.Indexes[1] = AcquireRendererDeviceTextureFormatIndex(4, 0, 0, 0, 0, 0, 0);
+        State.Textures.Formats.Indexes[2] = AcquireRendererDeviceTextureFormatIndex(8, 0, 0, 0, 0, 0, 0);
+        State.Textures.Formats.Indexes[3] = AcquireRendererDeviceTextureFormatIndex(0, 1, 5, 5, 5, 0, 0);
+        State.Textures.Formats.Indexes[4] = AcquireRendererDeviceTextureFormatIndex(0, 0, 5, 6, 5, 0, 0);
+        State.Textures.Formats.Indexes[5] = INVALID_TEXTURE_FORMAT_INDEX;
+        State.Textures.Formats.Indexes[6] = AcquireRendererDeviceTextureFormatIndex(0, 8, 8, 8, 8, 0, 0);
+        State.Textures.Formats.Indexes[7] = AcquireRendererDeviceTextureFormatIndex(0, 4, 4, 4, 4, 0, 0);
+        State.Textures.Formats.Indexes[12] = AcquireRendererDeviceTextureFormatIndex(0, 0, 0, 0, 0, 1, 0);
+        State.Textures.Formats.Indexes[13] = AcquireRendererDeviceTextureFormatIndex(0, 0, 0, 0, 0, 3, 0);
+        State.Textures.Formats.Indexes[14] = INVALID_TEXTURE_FORMAT_INDEX;
+        State.Textures.Formats.Indexes[15] = INVALID_TEXTURE_FORMAT_INDEX;
+        State.Textures.Formats.Indexes[16] = INVALID_TEXTURE_FORMAT_INDEX;
+        State.Textures.Formats.Indexes[17] = INVALID_TEXTURE_FORMAT_INDEX;
+        State.Textures.Formats.Indexes[18] = AcquireRendererDeviceTextureFormatIndex(0, 0, 8, 8, 0, 0, 1);
+        State.Textures.Formats.Indexes[19] = AcquireRendererDeviceTextureFormatIndex(0, 0, 8, 8, 8, 0, 2);
+        State.Textures.Formats.Indexes[20] = AcquireRendererDeviceTextureFormatIndex(0, 0, 5, 5, 6, 0, 3);
+
+        RendererTextureFormatStates[0] = 0; // TODO
+        RendererTextureFormatStates[1] = State.Textures.Formats.Indexes[1] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[2] = State.Textures.Formats.Indexes[2] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[4] = State.Textures.Formats.Indexes[4] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[5] = State.Textures.Formats.Indexes[5] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[6] = State.Textures.Formats.Indexes[6] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[7] = State.Textures.Formats.Indexes[7] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[12] = State.Textures.Formats.Indexes[12] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[13] = State.Textures.Formats.Indexes[13] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[14] = State.Textures.Formats.Indexes[14] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[15] = State.Textures.Formats.Indexes[15] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[16] = State.Textures.Formats.Indexes[16] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[17] = State.Textures.Formats.Indexes[17] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[18] = State.Textures.Formats.Indexes[18] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[19] = State.Textures.Formats.Indexes[19] != INVALID_TEXTURE_FORMAT_INDEX;
+        RendererTextureFormatStates[20] = State.Textures.Formats.Indexes[20] != INVALID_TEXTURE_FORMAT_INDEX;
+
+        if (State.Textures.Formats.Indexes[3] == INVALID_TEXTURE_FORMAT_INDEX)
+        {
+            State.Textures.Formats.Indexes[3] = AcquireRendererDeviceTextureFormatIndex(0, 0, 5, 5, 5, 0, 0);
+            RendererTextureFormatStates[3] = (State.Textures.Formats.Indexes[3] != INVALID_TEXTURE_FORMAT_INDEX) ? 5 : 0; // TODO
+        }
+        else
+        {
+            RendererTextureFormatStates[3] = 1;
+        }
+    }
+
+    // 0x6000c450
+    HRESULT CALLBACK EnumerateRendererDeviceTextureFormats(LPDDPIXELFORMAT format, LPVOID context)
+    {
+        ZeroMemory(&State.Textures.Formats.Formats[State.Textures.Formats.Count], sizeof(TextureFormat));
+
+        CopyMemory(&State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat, format, sizeof(DDPIXELFORMAT));
+
+        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_NONE;
+
+        if (format->dwFlags & DDPF_FOURCC)
+        {
+            if (format->dwFourCC == FOURCC_DXT1)
+            {
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_DXT1;
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTN = FOURCC_DXT1;
+            }
+            else if (format->dwFourCC == FOURCC_DXT2)
+            {
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_DXT2;
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTN = FOURCC_DXT2;
+            }
+            else if (format->dwFourCC == FOURCC_DXT3)
+            {
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTF = DXT_FORMAT_DXT3;
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTN = FOURCC_DXT3;
+            }
+        }
+
+        if (format->dwFlags & DDPF_PALETTEINDEXED8)
+        {
+            State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = TRUE;
+            State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 8;
+            State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
+        }
+        else
+        {
+            if (format->dwFlags & DDPF_PALETTEINDEXED4)
+            {
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = TRUE;
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 4;
+                State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
+            }
+            else
+            {
+                if (format->dwFlags & DDPF_RGB)
+                {
+                    State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = FALSE;
+                    State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+
+                    u32 red = 0;
+
+                    {
+                        u32 value = format->dwRBitMask;
+
+                        while ((value & 1) == 0) { value = value >> 1; }
+
+                        while ((value & 1) != 0) { red = red + 1; value = value >> 1; }
+                    }
+
+                    u32 green = 0;
+
+                    {
+                        u32 value = format->dwGBitMask;
+
+                        while ((value & 1) == 0) { value = value >> 1; }
+
+                        while ((value & 1) != 0) { green = green + 1; value = value >> 1; }
+                    }
+
+                    u32 blue = 0;
+
+                    {
+                        u32 value = format->dwBBitMask;
+
+                        while ((value & 1) == 0) { value = value >> 1; }
+
+                        while ((value & 1) != 0) { blue = blue + 1; value = value >> 1; }
+                    }
+
+                    State.Textures.Formats.Formats[State.Textures.Formats.Count].RedBitCount = red;
+                    State.Textures.Formats.Formats[State.Textures.Formats.Count].GreenBitCount = green;
+                    State.Textures.Formats.Formats[State.Textures.Formats.Count].BlueBitCount = blue;
+
+                    if (format->dwFlags & DDPF_ALPHAPIXELS)
+                    {
+                        u32 alpha = 0;
+
+                        {
+                            u32 value = format->dwRGBAlphaBitMask;
+
+                            while ((value & 1) == 0) { value = value >> 1; }
+
+                            while ((value & 1) != 0) { alpha = alpha + 1; value = value >> 1; }
+                        }
+
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].AlphaBitCount = alpha;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
+                    }
+                    else
+                    {
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].AlphaBitCount = 0;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 0; // TODO
+                    }
+                }
+                else
+                {
+                    if (format->dwFlags & DDPF_BUMPLUMINANCE)
+                    {
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = FALSE;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+
+                        u32 red = 0;
+
+                        {
+                            u32 value = format->dwRBitMask;
+
+                            while ((value & 1) == 0) { value = value >> 1; }
+
+                            while ((value & 1) != 0) { red = red + 1; value = value >> 1; }
+                        }
+
+                        u32 green = 0;
+
+                        {
+                            u32 value = format->dwGBitMask;
+
+                            while ((value & 1) == 0) { value = value >> 1; }
+
+                            while ((value & 1) != 0) { green = green + 1; value = value >> 1; }
+                        }
+
+                        u32 blue = 0;
+
+                        {
+                            u32 value = format->dwBBitMask;
+
+                            while ((value & 1) == 0) { value = value >> 1; }
+
+                            while ((value & 1) != 0) { blue = blue + 1; value = value >> 1; }
+                        }
+
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].RedBitCount = red;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].GreenBitCount = green;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].BlueBitCount = blue;
+
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = (red == 5 && green == 5 && blue == 6) ? 3 : 2; // TODO
+                    }
+                    else if (format->dwFlags & DDPF_BUMPDUDV)
+                    {
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].IsPalette = FALSE;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].PaletteColorBits = 0;
+
+                        u32 red = 0;
+
+                        {
+                            u32 value = format->dwRBitMask;
+
+                            while ((value & 1) == 0) { value = value >> 1; }
+
+                            while ((value & 1) != 0) { red = red + 1; value = value >> 1; }
+                        }
+
+                        u32 green = 0;
+
+                        {
+                            u32 value = format->dwGBitMask;
+
+                            while ((value & 1) == 0) { value = value >> 1; }
+
+                            while ((value & 1) != 0) { green = green + 1; value = value >> 1; }
+                        }
+
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].RedBitCount = red;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].GreenBitCount = green;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].BlueBitCount = 0;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].DXTT = 1; // TODO
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwRBitMask = 0xff;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwGBitMask = 0xff00;
+                        State.Textures.Formats.Formats[State.Textures.Formats.Count].Descriptor.ddpfPixelFormat.dwBBitMask = 0;
+                    }
+                }
+            }
+        }
+
+        if (*(s32*)context == INVALID_TEXTURE_FORMAT_COUNT)
+        {
+            *(s32*)context = State.Textures.Formats.Count;
+        }
+
+        // NOTE: Added check to avoid writing outside the array boundaries.
+        if (MAX_TEXTURE_FORMAT_COUNT <= State.Textures.Formats.Count + 1) { return DDENUMRET_CANCEL; }
+
+        State.Textures.Formats.Count = State.Textures.Formats.Count + 1;
+
+        return DDENUMRET_OK;
+    }
+
+    // 0x6000c3c0
+    s32 AcquireRendererDeviceTextureFormatIndex(const u32 palette, const u32 alpha, const u32 red, const u32 green, const u32 blue, const u32 dxtf, const u32 dxtt)
+    {
+        for (u32 x = 0; x < State.Textures.Formats.Count; x++)
+        {
+            const TextureFormat* format = &State.Textures.Formats.Formats[x];
+
+            if (format->RedBitCount == red && format->GreenBitCount == green && format->BlueBitCount == blue)
+            {
+                if (format->PaletteColorBits == palette)
+                {
+                    if (format->AlphaBitCount == alpha && format->DXTF == dxtf && format->DXTT == dxtt) { return x; }
+                    else if (format->PaletteColorBits == palette && palette != 0) { return x; }
+                }
+            }
+            else if (format->PaletteColorBits == palette && palette != 0) { return x; }
+        }
+
+        return INVALID_TEXTURE_FORMAT_INDEX;
+    }
+
+    // 0x6000a130
+    // a.k.a. createzbuffer
+    BOOL InitializeRendererDeviceDepthSurfaces(const u32 width, const u32 height, IDirectDrawSurface7* depth, IDirectDrawSurface7* surf)
+    {
+        if (State.Device.Capabilities.IsDepthBufferRemovalAvailable) { return TRUE; }
+
+        IDirectDrawSurface7* ds = surf == NULL ? State.DX.Surfaces.Depth : depth;
+
+        DDPIXELFORMAT format;
+        ZeroMemory(&format, sizeof(DDPIXELFORMAT));
+
+        {
+            const HRESULT result = State.DX.DirectX->EnumZBufferFormats(IID_IDirect3DHALDevice, EnumerateRendererDevicePixelFormats, &format);
+
+            if (result != DD_OK) { LOGERROR("EnumZBufferFormats failure! %8x\n", result); }
+        }
+
+        if (format.dwSize != sizeof(DDPIXELFORMAT)) { return FALSE; }
+
+        DDSURFACEDESC2 desc;
+        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+        desc.dwSize = sizeof(DDSURFACEDESC2);
+        desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+        desc.dwHeight = height;
+        desc.dwWidth = width;
+
+        CopyMemory(&desc.ddpfPixelFormat, &format, sizeof(DDPIXELFORMAT));
+
+        State.Device.Capabilities.IsStencilBufferAvailable = (format.dwFlags & DDPF_STENCILBUFFER) != 0;
+
+        desc.ddsCaps.dwCaps = State.Device.Capabilities.IsAccelerated
+            ? DDSCAPS_ZBUFFER | DDSCAPS_VIDEOMEMORY
+            : DDSCAPS_ZBUFFER | DDSCAPS_SYSTEMMEMORY;
+
+        {
+            const HRESULT result = State.DX.Active.Instance->CreateSurface(&desc, &ds, NULL);
+
+            if (result != DD_OK)
+            {
+                LOGERROR("CreateSurface failure! %s\n", AcquireRendererMessage(result));
+
+                if (result != DDERR_OUTOFMEMORY && result != DDERR_OUTOFVIDEOMEMORY)
+                {
+                    LOGWARNING("CreateSurface for Z-buffer failed %s.\n", AcquireRendererMessage(result));
+
+                    return FALSE;
+                }
+
+                LOGWARNING("There was not enough video memory to create the Z-buffer surface.\nPlease restart the program and try another fullscreen mode with less resolution or lower bit depth.\n");
+
+                return FALSE;
+            }
+        }
+
+        {
+            IDirectDrawSurface7* s = surf != NULL ? surf
+                : (State.DX.Active.Surfaces.Back == NULL ? State.DX.Active.Surfaces.Main : State.DX.Active.Surfaces.Back);
 
             HRESULT result = s->AddAttachedSurface(ds);
 
-            if (result == DD_OK)
+            if (result == DD_OK)
+            {
+                DDSURFACEDESC2 desc;
+                ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+                desc.dwSize = sizeof(DDSURFACEDESC2);
+
+                result = ds->GetSurfaceDesc(&desc);
+
+                if (result == DD_OK)
+                {
+                    State.Device.Capabilities.IsDepthVideoMemoryCapable = (desc.ddsCaps.dwCaps & DDSCAPS_VIDEOMEMORY) != 0;
+
+                    if (!State.Device.Capabilities.IsAccelerated || State.Device.Capabilities.IsDepthVideoMemoryCapable)
+                    {
+                        if (ds != NULL) { ds->Release(); }
+
+                        return TRUE;
+                    }
+
+                    LOGWARNING("Could not fit the Z-buffer in video memory for this hardware device.\n");
+                }
+                else { LOGWARNING("Failed to get surface description of Z buffer %d.\n", result); }
+            }
+            else { LOGWARNING("AddAttachedBuffer failed for Z-Buffer %d.\n", result); }
+        }
+
+        RenderRendererCommands();
+
+        State.DX.Device->SetRenderState(D3DRENDERSTATE_ZENABLE, D3DZB_FALSE);
+        State.DX.Device->SetRenderState(D3DRENDERSTATE_ZWRITEENABLE, FALSE);
+
+        State.Commands.Current.States[RENDERER_COMMAND_STATE_DEPTH_ENABLE] = D3DZB_FALSE;
+        State.Commands.Current.States[RENDERER_COMMAND_STATE_DEPTH_WRITE_ENABLE] = FALSE;
+        State.Commands.Device.States[RENDERER_COMMAND_STATE_DEPTH_ENABLE] = D3DZB_FALSE;
+        State.Commands.Device.States[RENDERER_COMMAND_STATE_DEPTH_WRITE_ENABLE] = FALSE;
+
+        State.Shadow.States.IsValid[D3DRENDERSTATE_ZENABLE] = FALSE;
+        State.Shadow.States.IsValid[D3DRENDERSTATE_ZWRITEENABLE] = FALSE;
+
+        if (ds != NULL) { ds->Release(); }
+
+        return FALSE;
+    }
+
+    // 0x6000a450
+    HRESULT CALLBACK EnumerateRendererDevicePixelFormats(LPDDPIXELFORMAT format, LPVOID context)
+    {
+        if ((format->dwFlags & DDPF_ZBUFFER) && format->dwRGBBitCount == State.Window.Bits)
+        {
+            CopyMemory(context, format, sizeof(DDPIXELFORMAT));
+
+            return D3DENUMRET_CANCEL;
+        }
+
+        return D3DENUMRET_OK;
+    }
+    
+    // 0x60002060
+    void SelectRendererDevice(void)
+    {
+        if (RendererDeviceIndex < DEFAULT_DEVICE_INDEX)
+        {
+            if (State.Lambdas.Lambdas.AcquireWindow != NULL || State.Window.HWND != NULL)
+            {
+                const char* value = getenv(RENDERER_MODULE_DISPLAY_ENVIRONMENT_PROPERTY_NAME);
+
+                SelectDevice(value == NULL ? DEFAULT_DEVICE_INDEX : atoi(value));
+            }
+        }
+    }
+
+    // 0x600092c0
+    void AcquireRendererModuleDescriptor(RendererModuleDescriptor* desc, const char* section)
+    {
+        desc->Signature = AcquireSettingsValue(desc->Signature, section, "signature");
+        desc->Version = AcquireSettingsValue(desc->Version, section, "version");
+
+        {
+            const u32 caps = desc->Caps;
+
+            const u32 lw = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_LINE_WIDTH) >> 0, section, "linewidth");
+            const u32 ts = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TEXTURE_SQUARE) >> 1, section, "texturesquare");
+            const u32 twp2 = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TEXTURE_WIDTH_POW2) >> 2, section, "texturewidthpowerof2");
+            const u32 thp2 = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TEXTURE_HEIGHT_POW2) >> 3, section, "textureheightpowerof2");
+            const u32 soft = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_SOFTWARE) >> 4, section, "software");
+            const u32 win = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_WINDOWED) >> 5, section, "windowed");
+            const u32 gc = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_GLOBAL_CUT) >> 6, section, "globalclut");
+            const u32 tn2p = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TRILINEAR_PASS) >> 7, section, "trilinear2pass");
+
+            desc->Caps = ((lw & 1) << 0) | ((ts & 1) << 1) | ((twp2 & 1) << 2) | ((thp2 & 1) << 3)
+                | ((soft & 1) << 4) | ((win & 1) << 5) | ((gc & 1) << 6) | ((tn2p & 1) << 7);
+        }
+
+        desc->MinimumTextureWidth = AcquireSettingsValue(desc->MinimumTextureWidth, section, "texturewidthmin");
+        desc->MaximumTextureWidth = AcquireSettingsValue(desc->MaximumTextureWidth, section, "texturewidthmax");
+        desc->MultipleTextureWidth = AcquireSettingsValue(desc->MultipleTextureWidth, section, "texturewidthmultiple");
+        desc->MinimumTextureHeight = AcquireSettingsValue(desc->MinimumTextureHeight, section, "textureheightmin");
+        desc->MaximumTextureHeight = AcquireSettingsValue(desc->MaximumTextureHeight, section, "textureheightmax");
+        desc->MultipleTextureHeight = AcquireSettingsValue(desc->MultipleTextureHeight, section, "textureheightmultiple");
+        desc->ClipAlign = AcquireSettingsValue(desc->ClipAlign, section, "clipalign");
+        desc->MaximumSimultaneousTextures = AcquireSettingsValue(desc->MaximumSimultaneousTextures, section, "numstages");
+        desc->SubType = AcquireSettingsValue(desc->SubType, section, "subtype");
+        desc->VideoMemorySize = AcquireSettingsValue(desc->VideoMemorySize, section, "textureramsize");
+        desc->TotalMemorySize = AcquireSettingsValue(desc->TotalMemorySize, section, "textureramtype");
+        desc->DXV = AcquireSettingsValue(desc->DXV, section, "dxversion");
+    }
+
+    // 0x60008dc0
+    u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1, const BOOL window)
+    {
+        AttemptRenderScene();
+
+        D3DRECT rect;
+
+        DWORD options = (window == FALSE); // D3DCLEAR_TARGET
+        
+        if (State.Device.Capabilities.IsDepthAvailable && State.Window.Bits != 0) { options = options | D3DCLEAR_ZBUFFER; }
+
+        if (State.Device.Capabilities.IsStencilBufferAvailable) { options = options | D3DCLEAR_STENCIL; }
+
+        if (x1 == 0)
+        {
+            rect.x1 = 0;
+            rect.y1 = 0;
+            rect.x2 = State.Window.Width;
+            rect.y2 = State.Window.Height;
+        }
+        else
+        {
+            rect.x1 = x0;
+            rect.x2 = x1;
+            rect.y1 = y0;
+            rect.y2 = y1;
+        }
+
+        f32 depth = RendererClearDepth;
+
+        if ((options & D3DCLEAR_ZBUFFER) && SettingsState.DepthClearInterval > 1)
+        {
+            // NOTE: The first clear of the whole window after the page flip starts a new frame, which switches to the other half of the depth range.
+            // The depth buffer is then left as is, except for every Nth frame, because the previous frame wrote only into the other half.
+            if (!State.DepthRange.IsCleared && rect.x1 == 0 && rect.y1 == 0
+                && rect.x2 == (LONG)State.Window.Width && rect.y2 == (LONG)State.Window.Height)
+            {
+                State.DepthRange.IsCleared = TRUE;
+
+                // NOTE: The W buffer does not use the Z values, thus the depth range cannot be used with it.
+                const BOOL active = !(State.Shadow.States.IsValid[D3DRENDERSTATE_ZENABLE] && State.Shadow.States.Values[D3DRENDERSTATE_ZENABLE] == D3DZB_USEW);
+
+                SelectRendererDepthRange(active, active && !State.DepthRange.IsInverse);
+
+                if (active)
+                {
+                    if (State.DepthRange.Frame != 0) { options = options & ~D3DCLEAR_ZBUFFER; }
+
+                    State.DepthRange.Frame = (State.DepthRange.Frame + 1) % SettingsState.DepthClearInterval;
+                }
+            }
+
+            if (State.DepthRange.IsActive) { depth = State.DepthRange.IsInverse ? (1.0f - 0.5f * depth) : (0.5f * depth); }
+        }
+
+        if (options == 0) { return TRUE; }
+
+        return State.DX.Device->Clear(1, &rect, options, RendererClearColor, depth, 0) == DD_OK;
+    }
+
+    // 0x60008a50
+    // a.k.a. showbackbuffer
+    u32 ToggleRenderer(void)
+    {
+        if (State.Lock.IsActive) { UnlockGameWindow(NULL); }
+
+        if (!State.Settings.IsWindowMode)
+        {
+            if (State.DX.Active.Surfaces.Back != NULL)
+            {
+                HRESULT result = State.DX.Active.Surfaces.Main->Flip(NULL, RendererToggleOptions);
+
+                if (result == DDERR_SURFACELOST) { return RENDERER_MODULE_FAILURE; }
+
+                const u32 state = AcquireState(RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE);
+
+                if (!State.Settings.IsToggleAllowed) { return RENDERER_MODULE_FAILURE; }
+
+                while (TRUE)
+                {
+                    while (result = State.DX.Active.Instance->TestCooperativeLevel(), result == DD_OK)
+                    {
+                        ResetTextures();
+
+                        if (result = State.DX.Active.Instance->RestoreAllSurfaces(), result == DD_OK) { return RENDERER_MODULE_SUCCESS; }
+
+                        Sleep(1);
+                    }
+
+                    if (result == DDERR_WRONGMODE) { break; }
+
+                    if (result == DDERR_EXCLUSIVEMODEALREADYSET || result == DDERR_NOEXCLUSIVEMODE) { Sleep(1); }
+
+                    Sleep(1);
+                }
+
+                SelectVideoMode(state, 2, 1); // TODO
+
+                return RENDERER_MODULE_SUCCESS;
+            }
+        }
+        else
+        {
+            for (u32 x = 0; x < 1000000; x++)
+            {
+                const HRESULT result = State.DX.Active.Surfaces.Main->GetBltStatus(DDGBS_ISBLTDONE);
+
+                if (result != DDERR_WASSTILLDRAWING && result != DDERR_SURFACEBUSY) { break; }
+            }
+
+            RECT dst;
+            RECT src;
+
+            if (!State.Settings.IsWindowMode)
+            {
+                GetClientRect(State.Window.HWND, &dst);
+
+                POINT point;
+                ZeroMemory(&point, sizeof(POINT));
+
+                ClientToScreen(State.Window.HWND, &point);
+                OffsetRect(&dst, point.x, point.y);
+                SetRect(&src, 0, 0, State.Window.Width, State.Window.Height);
+            }
+            else
+            {
+                POINT point;
+                ZeroMemory(&point, sizeof(POINT));
+
+                ClientToScreen(State.Window.HWND, &point);
+                SetRect(&dst, point.x, point.y, State.Window.Width + point.x, State.Window.Height + point.y);
+                SetRect(&src, 0, 0, State.Window.Width, State.Window.Height);
+            }
+
+            const HRESULT result = State.DX.Active.Surfaces.Active.Main->Blt(&dst,
+                State.DX.Active.Surfaces.Active.Back, &src, RendererBlitOptions, NULL);
+
+            if (result != DD_OK) { return RENDERER_MODULE_FAILURE; }
+        }
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60008a10
+    BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value)
+    {
+        if (type < MAX_RENDER_STATE_COUNT)
+        {
+            if (State.Shadow.States.IsValid[type] && State.Shadow.States.Values[type] == value)
+            {
+                State.Shadow.Filtered = State.Shadow.Filtered + 1;
+
+                return TRUE;
+            }
+
+            State.Shadow.States.IsValid[type] = TRUE;
+            State.Shadow.States.Values[type] = value;
+        }
+
+        if (!State.Scene.IsActive) { BeginRendererScene(); }
+
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        if (State.Commands.IsActive)
+        {
+            const s32 indx = AcquireRendererCommandStateIndex(type);
+
+            if (indx != INVALID_COMMAND_STATE_INDEX)
+            {
+                State.Commands.Current.States[indx] = value;
+
+                return TRUE;
+            }
+
+            RenderRendererCommands();
+        }
+
+        const BOOL result = State.DX.Device->SetRenderState(type, value) == DD_OK;
+
+        if (!result && type < MAX_RENDER_STATE_COUNT) { State.Shadow.States.IsValid[type] = FALSE; }
+
+        return result;
+    }
+
+    // Selects the depth comparison, which is inverted while the frame is drawn into the upper half of the depth range.
+    BOOL SelectRendererDepthFunction(const D3DCMPFUNC function)
+    {
+        State.DepthRange.Function = function;
+
+        if (State.DepthRange.IsInverse)
+        {
+            switch (function)
+            {
+            case D3DCMP_LESS: { return SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_GREATER); }
+            case D3DCMP_LESSEQUAL: { return SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_GREATEREQUAL); }
+            case D3DCMP_GREATER: { return SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_LESS); }
+            case D3DCMP_GREATEREQUAL: { return SelectRendererState(D3DRENDERSTATE_ZFUNC, D3DCMP_LESSEQUAL); }
+            }
+        }
+
+        return SelectRendererState(D3DRENDERSTATE_ZFUNC, function);
+    }
+
+    // Switches the frame between the lower half of the depth range, and the inverted upper half of it.
+    // The batched vertexes must have been submitted beforehand, as they are remapped only once they are submitted.
+    void SelectRendererDepthRange(const BOOL active, const BOOL inverse)
+    {
+        State.DepthRange.IsActive = active;
+        State.DepthRange.IsInverse = inverse;
+
+        SelectRendererDepthFunction(State.DepthRange.Function);
+        SelectRendererVertexTransforms();
+    }
+
+    // 0x600089d0
+    BOOL SelectRendererTextureStage(const u32 stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value)
+    {
+        if (stage < MAX_TEXTURE_STAGE_COUNT && type < MAX_TEXTURE_STAGE_STATE_COUNT)
+        {
+            if (State.Shadow.Stages.IsValid[stage][type] && State.Shadow.Stages.Values[stage][type] == value)
+            {
+                State.Shadow.Filtered = State.Shadow.Filtered + 1;
+
+                return TRUE;
+            }
+
+            State.Shadow.Stages.IsValid[stage][type] = TRUE;
+            State.Shadow.Stages.Values[stage][type] = value;
+
+            // NOTE: The address mode of both coordinates, and the address modes of the separate coordinates, override each other.
+            if (type == D3DTSS_ADDRESS)
+            {
+                State.Shadow.Stages.IsValid[stage][D3DTSS_ADDRESSU] = FALSE;
+                State.Shadow.Stages.IsValid[stage][D3DTSS_ADDRESSV] = FALSE;
+            }
+            else if (type == D3DTSS_ADDRESSU || type == D3DTSS_ADDRESSV) { State.Shadow.Stages.IsValid[stage][D3DTSS_ADDRESS] = FALSE; }
+        }
+
+        if (!State.Scene.IsActive) { BeginRendererScene(); }
+
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        RenderRendererCommands();
+
+        const BOOL result = State.DX.Device->SetTextureStageState(stage, type, value) == DD_OK;
+
+        if (!result && stage < MAX_TEXTURE_STAGE_COUNT && type < MAX_TEXTURE_STAGE_STATE_COUNT) { State.Shadow.Stages.IsValid[stage][type] = FALSE; }
+
+        if (result && stage == RENDERER_TEXTURE_STAGE_0)
+        {
+            if (type == D3DTSS_ADDRESS || type == D3DTSS_ADDRESSU) { State.Textures.Atlases.AddressU = value; }
+            if (type == D3DTSS_ADDRESS || type == D3DTSS_ADDRESSV) { State.Textures.Atlases.AddressV = value; }
+
+            // NOTE: The packed texture selected into the first stage is moved into the device texture of its own,
+            // once its texture coordinates wrap, or mirror, since the neighbouring textures of the atlas would be sampled otherwise.
+            RendererTexture* tex = State.Textures.Atlases.Current;
+
+            if (tex != NULL && !IsRendererTextureAtlasClamped())
+            {
+                if (UnpackRendererTexture(tex)) { SelectRendererDeviceTexture(RENDERER_TEXTURE_STAGE_0, tex->Texture); }
+            }
+        }
+
+        return result;
+    }
+
+    // 0x60008d00
+    void SelectRendererMaterial(const u32 color)
+    {
+        D3DMATERIAL7 material;
+        ZeroMemory(&material, sizeof(D3DMATERIAL7));
+
+        RendererClearColor = color;
+
+        const f32 red = RGBA_GETRED(color) / 255.0f;
+        const f32 green = RGBA_GETGREEN(color) / 255.0f;
+        const f32 blue = RGBA_GETBLUE(color) / 255.0f;
+
+        material.diffuse.r = red;
+        material.diffuse.g = green;
+        material.diffuse.b = blue;
+
+        material.ambient.r = red;
+        material.ambient.g = green;
+        material.ambient.b = blue;
+
+        State.DX.Device->SetMaterial(&material);
+    }
+
+    // 0x60006e50
+    void SelectRendererFogAlphas(const u8* input, u8* output)
+    {
+        if (input == NULL) { return; }
+
+        for (u32 x = 0; x < MAX_OUTPUT_FOG_ALPHA_COUNT; x++)
+        {
+            const f32 value = roundf(x / 255.0f) * 63.0f;
+            const u32 indx = (u32)value;
+
+            const f32 diff = value - indx;
+
+            if (0.0f < diff)
+            {
+                const u8 result = (u8)roundf(input[indx] + (input[indx + 1] - input[indx]) * diff);
+                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - result);
+            }
+            else
+            {
+                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - input[indx]);
+            }
+        }
+    }
+
+    // 0x60008c80
+    BOOL RestoreRendererSurfaces(void)
+    {
+        for (u32 x = 0; x < 5000; x++)
+        {
+            if (State.DX.Active.Instance->TestCooperativeLevel() == DD_OK)
+            {
+                if (State.DX.Active.Instance->RestoreAllSurfaces() != DD_OK) { return FALSE; }
+
+                // NOTE: The contents of the restored surfaces are lost.
+                for (u32 xx = 0; xx < State.Textures.Active.Count; xx++)
+                {
+                    RendererTexture* tex = State.Textures.Active.Textures[xx];
+
+                    tex->PixelHash = INVALID_TEXTURE_HASH;
+                    tex->PaletteHash = INVALID_TEXTURE_HASH;
+                }
+
+                return TRUE;
+            }
+
+            Sleep(100);
+        }
+
+        LOGERROR("WARNING! STATE_RESTORESURFACES failed. Focus/Mode not regained before timeout.\n");
+
+        return FALSE;
+    }
+
+    // 0x60006fa0
+    void SelectRendererVertexCount(void)
+    {
+        AttemptRenderScene();
+
+        MaximumRendererVertexCount = MAX_VERTEX_COUNT / RendererVertexSize;
+    }
+
+    // 0x600094f0
+    void SelectRendererDeviceType(const u32 type)
+    {
+        RendererDeviceType = type;
+    }
+
+    // 0x6000b2c0
+    u32 SelectBasicRendererState(const u32 state, void* value)
+    {
+        switch (state)
+        {
+        case RENDERER_MODULE_STATE_SELECT_CULL_STATE:
+        {
+            switch ((u32)value)
+            {
+            case RENDERER_MODULE_CULL_NONE:
+            {
+                State.Settings.Cull = RENDERER_CULL_MODE_NONE;
+
+                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_NONE);
+
+                return RENDERER_MODULE_SUCCESS;
+            }
+            case RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE:
+            {
+                State.Settings.Cull = RENDERER_CULL_MODE_COUNTER_CLOCK_WISE;
+
+                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE);
+
+                return RENDERER_MODULE_FAILURE;
+            }
+            case RENDERER_MODULE_CULL_CLOCK_WISE:
+            {
+                State.Settings.Cull = RENDERER_CULL_MODE_CLOCK_WISE;
+
+                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_CLOCK_WISE);
+
+                return RENDERER_MODULE_FAILURE;
+            }
+            default: { return RENDERER_MODULE_FAILURE; }
+            }
+
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_WINDOW_MODE_STATE:
+        case RENDERER_MODULE_STATE_SELECT_EXECUTE_LAMBDA:
+        case RENDERER_MODULE_STATE_SELECT_LOCK_WINDOW_LAMBDA:
+        case RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE:
+        case RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX:
+        case RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE:
+        case RENDERER_MODULE_STATE_SELECT_LOG_STATE: { break; }
+        case RENDERER_MODULE_STATE_SELECT_LAMBDAS:
+        {
+            const RendererModuleLambdaContainer* lambdas = (RendererModuleLambdaContainer*)value;
+
+            State.Lambdas.Log = lambdas == NULL ? NULL : lambdas->Log;
+
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_WINDOW: { State.Window.Parent.HWND = (HWND)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_LOG_LAMBDA: { State.Lambdas.Log = (RENDERERMODULELOGLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_LINE_VERTEX_SIZE: { RendererLineVertexSize = (u32)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_VERSION:
+        {
+            const u32 version = (u32)value;
+
+            RendererVersion = version;
+
+            if (version < RENDERER_MODULE_VERSION_104 || version < RENDERER_MODULE_VERSION_107)
+            {
+                RendererVersion = RENDERER_MODULE_VERSION_107;
+            }
+
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_MEMORY_ALLOCATE_LAMBDA: { State.Lambdas.AllocateMemory = (RENDERERMODULEALLOCATEMEMORYLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_MEMORY_RELEASE_LAMBDA: { State.Lambdas.ReleaseMemory = (RENDERERMODULERELEASEMEMORYLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_SELECT_STATE_LAMBDA: { State.Lambdas.SelectState = (RENDERERMODULESELECTSTATELAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_55: { DAT_60058df4 = (u32)value; break; }
+        case RENDERER_MODULE_STATE_62: { DAT_60058df8 = (u32)value; break; }
+        case RENDERER_MODULE_STATE_INDEX_SIZE:
+        {
+            switch ((u32)value)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_1; break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_2; break; }
+            case RENDERER_MODULE_INDEX_SIZE_4: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_4; break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_8; break; }
+            default: { return RENDERER_MODULE_FAILURE; }
+            }
+
+            break;
+        }
+        default: { return RENDERER_MODULE_FAILURE; }
+        }
+
+        SelectRendererStateValue(state, value);
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60001e70
+    void SelectRendererStateValue(const u32 state, void* value)
+    {
+        const u32 actual = state & RENDERER_MODULE_SELECT_STATE_MASK;
+        const u32 stage = MAKETEXTURESTAGEVALUE(state);
+
+        const s32 indx = AcquireTextureStateStageIndex(actual);
+
+        if (indx >= 0) { State.Textures.StageStates[indx].Values[stage] = (s32)value; }
+
+        if (State.Lambdas.SelectState != NULL) { State.Lambdas.SelectState(actual, value); }
+    }
+
+    // 0x60001e20
+    s32 AcquireTextureStateStageIndex(const u32 state)
+    {
+        s32 sum = 0;
+        u32 indx = 0;
+
+        while (state < RendererModuleValues::MinMax[indx].Min || RendererModuleValues::MinMax[indx].Max < state)
+        {
+            sum = sum + (RendererModuleValues::MinMax[indx].Max - RendererModuleValues::MinMax[indx].Min);
+
+            indx = indx + 1;
+
+            if (5 < indx) { return -1; } // TODO
+        }
+
+        return (sum - RendererModuleValues::MinMax[indx].Min) + state;
+    }
+
+    // 0x60001f20
+    void InitializeTextureStateStates(void)
+    {
+        ZeroMemory(State.Textures.StageStates, MAX_TEXTURE_STATE_STATE_COUNT * sizeof(TextureStageState));
+    }
+
+    // 0x6000b590
+    void InitializeRendererModuleState(const u32 mode, const u32 pending, const u32 depth, const char* section)
+    {
+        SelectState(RENDERER_MODULE_STATE_SELECT_HINT_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_HINT_INACTIVE, section, "HINT"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
+        SelectState(RENDERER_MODULE_STATE_SELECT_CULL_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE, section, "CULL"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_FILTER_LENEAR, section, "FILTER"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_SHADE_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_SHADE_GOURAUD, section, "SHADE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_BLEND_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_ACTIVE, section, "TRANSPARENCY"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_TEST_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_TEST_16, section, "ALPHATEST"));
+        SelectState(RENDERER_MODULE_STATE_SELCT_ALPHA_FUNCTION,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_FUNCTION_GREATER, section, "ALPHACMP"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_MIP_FILTER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_MIP_FILTER_POINT, section, "MIPMAP"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_MATERIAL,
+            (void*)AcquireSettingsValue(0x00000000, section, "BACKGROUNDCOLOUR"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_CHROMATIC_COLOR,
+            (void*)AcquireSettingsValue(0x00000000, section, "CHROMACOLOUR"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_DITHER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_DITHER_INACTIVE, section, "DITHER")); // ORIGINAL: ACTIVE
+        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS, NULL);
+        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_FOG_INACTIVE, section, "FOGMODE"));
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_DENSITY,
+                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGDENSITY"));
+        }
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_START,
+                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "STATE_FOGZNEAR"));
+        }
+
+        {
+            const f32 value = 1.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_END,
+                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGZFAR"));
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_COLOR,
+            (void*)AcquireSettingsValue(GRAPCHICS_COLOR_WHITE, section, "FOGCOLOUR"));
+
+        SelectState(RENDERER_MODULE_STATE_INDEX_SIZE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_INDEX_SIZE_4, section, "INDEXSIZE"));
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_BLEND_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_SOURCE_INVERSE_SOURCE, section, "ALPHA"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_ADDRESS_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_ADDRESS_CLAMP, section, "TEXTURECLAMP"));
+
+        {
+            const f32 value = 1.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_GAMMA_CONTROL_STATE, (void*)(u32)(*(u32*)&value));
+        }
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_BIAS_STATE,
+                (void*)AcquireSettingsValue((u32)(*(u32*)&value), section, "DEPTHBIAS"));
+        }
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_MIP_MAP_LOD_BIAS_STATE, (void*)(u32)(*(u32*)&value));
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_VERTEX_TYPE, (void*)RENDERER_MODULE_VERTEX_TYPE_RTLVX);
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_NORMAL);
+        SelectState(MAKETEXTURESTAGEMASK(RENDERER_TEXTURE_STAGE_1) | RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_DISABLE);
+        SelectState(RENDERER_MODULE_STATE_MAX_PENDING_STATE,
+            (void*)AcquireSettingsValue(pending - 2U & ((s32)(pending - 2U) < 0) - 1, section, "MAXPENDING")); // TODO
+        SelectState(RENDERER_MODULE_STATE_SELECT_BACK_BUFFER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_BACK_BUFFER_ACTIVE, section, "BACKBUFFERTYPE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_FLAT_FANS_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_STATE_FLAT_FANS_ACTIVE, section, "FLATFANS"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_WIDTH, (void*)AcquireSettingsValue(1, section, "LINEWIDTH"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_STENCIL_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_STENCIL_INACTIVE, section, "STENCILBUFFER"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE, (void*)AcquireSettingsValue(mode, section, "DISPLAYMODE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_DOUBLE_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_LINE_DOUBLE_INACTIVE, section, "LINEDOUBLE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX, (void*)0); // TODO
+
+        {
+            const f32 value = 1.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_CLEAR_DEPTH_STATE, (void*)(u32)(*(u32*)&value));
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_TOGGLE_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TOGGLE_VERTICAL_SYNC, section, "FLIPRATE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE,
+            (void*)AcquireSettingsValue(0, section, "SHAMELESSPLUG")); // TODO
+
+        {
+            const u32 value = AcquireSettingsValue(((depth < 1) - 1) & 2, section, "DEPTHBUFFER");
+            const u32 result = SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)value);
+
+            if (result == RENDERER_MODULE_FAILURE && value == RENDERER_MODULE_DEPTH_ACTIVE_W)
+            {
+                SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)RENDERER_MODULE_DEPTH_ACTIVE);
+            }
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELCT_DEPTH_FUNCTION,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_DEPTH_FUNCTION_LESS_EQUAL, section, "DEPTHCMP"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_LOG_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_LOG_ACTIVE, section, "LOG"));
+    }
+
+    // 0x600088b0
+    // NOTE: Looks like the engineers made an interesting decision to extend the API in an unconventional way, such that
+    // a stage index is passed into the function, and not a valid pointer, to reset current texture.
+    BOOL SelectRendererTexture(RendererTexture* tex)
+    {
+        if ((u32)tex >= 16) // TODO
+        {
+            tex->Frame = State.Textures.Frame;
+
+            // NOTE: The texture is not drawn before the compressed pixels of its latest update are uploaded.
+            if (tex->Compression != NULL) { WaitRendererTextureCompression(tex); }
+
+            if (!ReloadRendererTexture(tex)) { return FALSE; }
+
+            // NOTE: The packed textures are moved into the device textures of their own, when their texture coordinates wrap, or mirror.
+            if (tex->Atlas != NULL && !IsRendererTextureAtlasClamped())
+            {
+                if (!UnpackRendererTexture(tex)) { return FALSE; }
+            }
+        }
+
+        if (!State.Scene.IsActive) { BeginRendererScene(); }
+
+        // NOTE: The textures of the same atlas are drawn within the same batch, only the transform of the texture coordinates changes.
+        if ((u32)tex >= 16 && tex->Atlas != NULL && State.Textures.Atlases.Current != NULL // TODO
+            && State.Textures.Atlases.Current->Atlas == tex->Atlas && State.Commands.Current.Textures[RENDERER_TEXTURE_STAGE_0] == tex->Texture)
+        {
+            if (State.Textures.Atlases.Current != tex)
+            {
+                SelectRendererTextureAtlas(tex);
+
+                State.Textures.Statistics.Current.Batched = State.Textures.Statistics.Current.Batched + 1;
+            }
+
+            return TRUE;
+        }
+
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+
+        // NOTE: The transform of the texture coordinates follows the texture selected into the first stage.
+        if ((u32)tex < 2 || ((u32)tex >= 16 && tex->Stage == RENDERER_TEXTURE_STAGE_0)) // TODO
+        {
+            RendererTexture* current = ((u32)tex >= 16 && tex->Atlas != NULL) ? tex : NULL;
+
+            if (State.Textures.Atlases.Current != current) { SelectRendererTextureAtlas(current); }
+        }
+
+        if ((u32)tex < 16) // TODO
+        {
+            if ((u32)tex == 0) // TODO
+            {
+                BOOL result = TRUE;
+
+                for (u32 x = 0; x < State.Device.Capabilities.MaximumSimultaneousTextures; x++)
+                {
+                    result = SelectRendererDeviceTexture(x, NULL);
+                }
+
+                return result;
+            }
+
+            if ((u32)tex == 1) { return SelectRendererDeviceTexture(RENDERER_TEXTURE_STAGE_0, NULL); } // TODO
+
+            if ((u32)tex == 2) { return SelectRendererDeviceTexture(RENDERER_TEXTURE_STAGE_1, NULL); } // TODO
+
+            return TRUE;
+        }
+
+        return SelectRendererDeviceTexture(tex->Stage, tex->Texture);
+    }
+
+    // NOTE: Textures of the first stages are part of the command key, thus only recorded while the commands are active,
+    // the rest of the stages are applied to the device right away, after the recorded commands are submitted.
+    BOOL SelectRendererDeviceTexture(const u32 stage, IDirectDrawSurface7* surface)
+    {
+        if (State.Commands.IsActive && stage < MAX_TEXTURE_STAGE_COUNT)
+        {
+            if (stage < MAX_COMMAND_TEXTURE_STAGE_COUNT)
+            {
+                State.Commands.Current.Textures[stage] = surface;
+
+                return TRUE;
+            }
+
+            if (State.Commands.Device.Textures[stage] == surface) { return TRUE; }
+
+            RenderRendererCommands();
+        }
+
+        if (stage < MAX_TEXTURE_STAGE_COUNT)
+        {
+            State.Commands.Current.Textures[stage] = surface;
+            State.Commands.Device.Textures[stage] = surface;
+        }
+
+        return State.DX.Device->SetTexture(stage, surface) == DD_OK;
+    }
+
+    // 0x60003570
+    u32 ReleaseRendererWindow(void)
+    {
+        if (State.DX.Instance != NULL)
+        {
+            SetForegroundWindow(State.Window.HWND);
+            PostMessageA(State.Window.HWND, RENDERER_MODULE_WINDOW_MESSAGE_RELEASE_DEVICE, 0, 0);
+            WaitForSingleObject(State.Mutex, INFINITE);
+            CloseHandle(State.Mutex);
+
+            State.Mutex = NULL;
+            State.Window.HWND = NULL;
+
+            return State.DX.Code;
+        }
+
+        return RENDERER_MODULE_FAILURE;
+    }
+
+    // 0x600035e0
+    u32 ReleaseRendererDeviceInstance(void)
+    {
+        ReleaseRendererDeviceSurfaces();
+
+        if (State.DX.Instance != NULL)
+        {
+            State.DX.Instance->Release();
+            State.DX.Instance = NULL;
+        }
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60009080
+    RendererTexture* AllocateRendererTexture(const u32 width, const u32 height, const u32 format, const BOOL palette, const u32 state, const BOOL destination)
+    {
+        if (State.DX.Active.Instance == NULL) { return NULL; }
+        if (State.Textures.Illegal) { return NULL; }
+
+        RendererTexture* tex = InitializeRendererTexture();
+
+        tex->Width = width;
+        tex->Height = height;
+        tex->FormatIndex = State.Textures.Formats.Indexes[format];
+        tex->UnknownFormatIndexValue = UnknownFormatValues[format];
+        tex->Stage = MAKETEXTURESTAGEVALUE(state);
+        tex->FormatIndexValue = MAKETEXTUREINDEXVALUE(format);
+
+        tex->MipMapCount = MAKETEXTUREMIPMAPVALUE(state) != 0 ? (MAKETEXTUREMIPMAPVALUE(state) + 1) : 0;
+
+        tex->Is16Bit = (format == RENDERER_PIXEL_FORMAT_R5G5B5 || format == RENDERER_PIXEL_FORMAT_R4G4B4);
+
+        tex->IsPalette = palette;
+        tex->MemoryType = RENDERER_MODULE_TEXTURE_LOCATION_SYSTEM_MEMORY;
+
+        tex->Surface = NULL;
+        tex->Texture = NULL;
+        tex->Palette = NULL;
+
+        tex->Colors = 0;
+
+        tex->IsCompressed = FALSE;
+        tex->Compression = NULL;
+
+        tex->IsShareable = !palette && !destination;
+        tex->PixelHash = INVALID_TEXTURE_HASH;
+        tex->PaletteHash = INVALID_TEXTURE_HASH;
+
+        tex->IsEvictable = !destination;
+        tex->Frame = State.Textures.Frame;
+        tex->Backup = NULL;
+
+        tex->Atlas = NULL;
+        tex->AtlasX = 0;
+        tex->AtlasY = 0;
+
+        if (!palette && !destination)
+        {
+            const u32 compression = AcquireRendererTextureCompressionFormat(width, height, format);
+
+            if (compression != DXT_FORMAT_NONE)
+            {
+                tex->IsCompressed = TRUE;
+                tex->FormatIndex = State.Textures.Formats.Indexes[compression == DXT_FORMAT_DXT1
+                    ? RENDERER_PIXEL_FORMAT_DXT1 : RENDERER_PIXEL_FORMAT_DXT3];
+            }
+        }
+
+        tex->Size = AcquireRendererTextureMemorySize(tex);
+
+        s32 result = RENDERER_INITIALIZE_TEXTURE_DETAILS_OK;
+
+        // NOTE: The small textures are packed into the shared atlas textures, instead of the device textures of their own.
+        if (palette || destination || tex->IsCompressed || !PackRendererTexture(tex))
+        {
+            EvictRendererTextures(tex->Size, NULL);
+
+            result = InitializeRendererTextureDetails(tex, destination);
+        }
+
+        // NOTE: The least recently used textures are evicted from the video memory, instead of failing the allocation.
+        while (result == RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR)
+        {
+            if (!EvictRendererTexture(AcquireRendererTextureEviction(NULL))) { break; }
+
+            tex->Surface = NULL;
+            tex->Texture = NULL;
+            tex->Palette = NULL;
+
+            result = InitializeRendererTextureDetails(tex, destination);
+        }
+
+        if (result != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
+        {
+            ReleaseRendererTexture(tex);
+
+            if (result != RENDERER_INITIALIZE_TEXTURE_DETAILS_INVALID) { State.Textures.Illegal = TRUE; }
+
+            return NULL;
+        }
+
+        if (!AttachRendererTexture(tex))
+        {
+            ReleaseRendererTextureAtlas(tex);
+
+            if (tex->Palette != NULL) { tex->Palette->Release(); }
+            if (tex->Texture != NULL) { tex->Texture->Release(); }
+            if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+            ReleaseRendererTexture(tex);
+
+            return NULL;
+        }
+
+        State.Textures.Count = State.Textures.Count + 1;
+
+        State.Textures.Size = State.Textures.Size + tex->Size;
+
+        return tex;
+    }
+
+    // 0x60009210
+    RendererTexture* InitializeRendererTexture(void)
+    {
+        RendererTexture* result = (RendererTexture*)AllocateRendererTexture(sizeof(RendererTexture));
+
+        if (result == NULL) { LOGERROR("D3D texture allocation ran out of memory\n"); }
+
+        return result;
+    }
+
+    // 0x6000b270
+    // NOTE: The textures are taken from the pool of the textures, unless the application provides the memory allocation.
+    RendererTexture* AllocateRendererTexture(const u32 size)
+    {
+        RendererTexture* result = NULL;
+
+        if (State.Lambdas.AllocateMemory != NULL) { result = (RendererTexture*)State.Lambdas.AllocateMemory(size); }
+        else
+        {
+            if (size == sizeof(RendererTexture))
+            {
+                result = AcquireRendererTexturePoolRecord();
+
+                if (result != NULL) { return result; }
+            }
+
+            result = (RendererTexture*)malloc(size);
+        }
+
+        if (result != NULL) { result->PoolIndex = INVALID_TEXTURE_POOL_INDEX; }
+
+        return result;
+    }
+
+    // Acquires the free record from the pool of the textures, the pool grows by a slab of the records at a time.
+    RendererTexture* AcquireRendererTexturePoolRecord(void)
+    {
+        if (State.Textures.Pool.Available == 0)
+        {
+            if (MAX_TEXTURE_POOL_SLAB_COUNT <= State.Textures.Pool.Count) { return NULL; }
+
+            RendererTexture* slab = (RendererTexture*)malloc(MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT * sizeof(RendererTexture));
+
+            if (slab == NULL) { return NULL; }
+
+            const s32 offset = State.Textures.Pool.Count * MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT;
+
+            for (u32 x = 0; x < MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT; x++)
+            {
+                slab[x].PoolIndex = offset + x;
+                slab[x].PoolNext = (x + 1) < MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT ? (offset + x + 1) : INVALID_TEXTURE_POOL_INDEX;
+            }
+
+            State.Textures.Pool.Slabs[State.Textures.Pool.Count] = slab;
+            State.Textures.Pool.Count = State.Textures.Pool.Count + 1;
+
+            State.Textures.Pool.Free = offset;
+            State.Textures.Pool.Available = MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT;
+        }
+
+        const s32 indx = State.Textures.Pool.Free;
+
+        RendererTexture* result = &State.Textures.Pool.Slabs[indx / MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT][indx % MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT];
+
+        State.Textures.Pool.Free = result->PoolNext;
+        State.Textures.Pool.Available = State.Textures.Pool.Available - 1;
+
+        return result;
+    }
+
+    // Appends the texture to the dense array of the active textures, which the texture walks iterate over.
+    BOOL AttachRendererTexture(RendererTexture* tex)
+    {
+        if (State.Textures.Active.Count == State.Textures.Active.Capacity)
+        {
+            const u32 capacity = Max(State.Textures.Active.Capacity * 2, (u32)MIN_ACTIVE_TEXTURE_CAPACITY);
+
+            RendererTexture** textures = (RendererTexture**)realloc(State.Textures.Active.Textures, capacity * sizeof(RendererTexture*));
+
+            if (textures == NULL) { return FALSE; }
+
+            State.Textures.Active.Textures = textures;
+            State.Textures.Active.Capacity = capacity;
+        }
+
+        tex->ActiveIndex = State.Textures.Active.Count;
+
+        State.Textures.Active.Textures[State.Textures.Active.Count] = tex;
+        State.Textures.Active.Count = State.Textures.Active.Count + 1;
+
+        return TRUE;
+    }
+
+    // Removes the texture from the dense array of the active textures, by moving the last active texture into its place.
+    void DetachRendererTexture(RendererTexture* tex)
+    {
+        const u32 indx = tex->ActiveIndex;
+
+        if (State.Textures.Active.Count <= indx || State.Textures.Active.Textures[indx] != tex) { return; }
+
+        State.Textures.Active.Count = State.Textures.Active.Count - 1;
+
+        RendererTexture* last = State.Textures.Active.Textures[State.Textures.Active.Count];
+
+        State.Textures.Active.Textures[indx] = last;
+        last->ActiveIndex = indx;
+    }
+
+    // Releases the slabs of the pool of the textures, and the dense array of the active textures.
+    void ReleaseRendererTexturePool(void)
+    {
+        if (State.Textures.Active.Count != 0) { return; }
+
+        for (u32 x = 0; x < State.Textures.Pool.Count; x++)
+        {
+            free(State.Textures.Pool.Slabs[x]);
+
+            State.Textures.Pool.Slabs[x] = NULL;
+        }
+
+        State.Textures.Pool.Count = 0;
+        State.Textures.Pool.Free = INVALID_TEXTURE_POOL_INDEX;
+        State.Textures.Pool.Available = 0;
+
+        if (State.Textures.Active.Textures != NULL)
+        {
+            free(State.Textures.Active.Textures);
+
+            State.Textures.Active.Textures = NULL;
+        }
+
+        State.Textures.Active.Capacity = 0;
+    }
+
+    // 0x6000c790
+    s32 InitializeRendererTextureDetails(RendererTexture* tex, const BOOL destination)
+    {
+        if (tex->Texture != NULL)
+        {
+            tex->Texture->Release();
+            tex->Texture = NULL;
+        }
+
+        DDSURFACEDESC2 desc;
+        CopyMemory(&desc, &State.Textures.Formats.Formats[tex->FormatIndex].Descriptor, sizeof(DDSURFACEDESC2));
+
+        desc.dwSize = sizeof(DDSURFACEDESC2);
+
+        // Attempt to create texture in RAM.
+        {
+            if (tex->MipMapCount == 0)
+            {
+                desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+                desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
+            }
+            else
+            {
+                desc.dwFlags = DDSD_MIPMAPCOUNT | DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+                desc.ddsCaps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY | DDSCAPS_COMPLEX;
+                desc.dwMipMapCount = tex->MipMapCount;
+            }
+
+            if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
+            else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
+
+            desc.dwHeight = tex->Height;
+            desc.dwWidth = tex->Width;
+
+            if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_FOURCC;
+
+                if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1)
+                {
+                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT1;
+                }
+                else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                {
+                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT3;
+                }
+            }
+            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_1)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
+                desc.ddpfPixelFormat.dwRBitMask = 0xff;
+                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
+                desc.ddpfPixelFormat.dwBBitMask = 0x00;
+            }
+            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_2)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_24;
+                desc.ddpfPixelFormat.dwRBitMask = 0xff;
+                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
+                desc.ddpfPixelFormat.dwBBitMask = 0xff0000;
+            }
+            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_3)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
+                desc.ddpfPixelFormat.dwRBitMask = 0x1f;
+                desc.ddpfPixelFormat.dwGBitMask = 0x3e0;
+                desc.ddpfPixelFormat.dwBBitMask = 0xfc00;
+            }
+
+            IDirectDrawSurface7* surface = NULL;
+
+            {
+                const HRESULT result = State.DX.Active.Instance->CreateSurface(&desc, &surface, NULL);
+
+                if (result != DD_OK) { return (result != DDERR_INVALIDPIXELFORMAT) - 1; }
+            }
+
+            tex->Surface = surface;
+
+            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+            desc.dwSize = sizeof(DDSURFACEDESC2);
+
+            if (surface->GetSurfaceDesc(&desc) != DD_OK)
+            {
+                surface->Release();
+
+                return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+            }
+        }
+
+        CopyMemory(&tex->Descriptor, &desc, sizeof(DDSURFACEDESC2));
+
+        // Attempt to create texture in Video Memory or RAM, depending on the device capabilities.
+        {
+            if (tex->MipMapCount == 0)
+            {
+                desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+                desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE;
+            }
+            else
+            {
+                desc.dwFlags = DDSD_MIPMAPCOUNT | DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+                desc.ddsCaps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE | DDSCAPS_COMPLEX;
+                desc.dwMipMapCount = tex->MipMapCount;
+            }
+
+            if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
+            else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
+
+            if (destination) { desc.ddsCaps.dwCaps = desc.ddsCaps.dwCaps | DDSCAPS_3DDEVICE; }
+
+            if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_FOURCC;
+
+                if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1)
+                {
+                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT1;
+                }
+                else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                {
+                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT3;
+                }
+            }
+            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_1)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
+                desc.ddpfPixelFormat.dwRBitMask = 0xff;
+                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
+                desc.ddpfPixelFormat.dwBBitMask = 0x00;
+            }
+            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_2)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_24;
+                desc.ddpfPixelFormat.dwRBitMask = 0xff;
+                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
+                desc.ddpfPixelFormat.dwBBitMask = 0xff0000;
+            }
+            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_3)
+            {
+                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+
+                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
+                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
+                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
+                desc.ddpfPixelFormat.dwRBitMask = 0x1f;
+                desc.ddpfPixelFormat.dwGBitMask = 0x3e0;
+                desc.ddpfPixelFormat.dwBBitMask = 0xfc00;
+            }
+
+            desc.ddsCaps.dwCaps = State.Device.Capabilities.IsAccelerated
+                ? desc.ddsCaps.dwCaps | DDSCAPS_VIDEOMEMORY
+                : desc.ddsCaps.dwCaps | DDSCAPS_SYSTEMMEMORY;
+
+            IDirectDrawSurface7* surface = NULL;
+
+            {
+                const HRESULT result = State.DX.Active.Instance->CreateSurface(&desc, &surface, NULL);
+
+                if (result != DD_OK)
+                {
+                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                    return (result != DDERR_INVALIDPIXELFORMAT) - 1;
+                }
+            }
+
+            IDirectDrawPalette* palette = NULL;
+
+            if (desc.ddpfPixelFormat.dwFlags & DDPF_PALETTEINDEXED8)
+            {
+                tex->Colors = 256;
+
+                PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+
+                for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
+                {
+                    entries[x].peRed = 0;
+                    entries[x].peGreen = 0xff;
+                    entries[x].peBlue = 0;
+                    entries[x].peFlags = 0;
+                }
+
+                if (State.DX.Active.Instance->CreatePalette(DDPCAPS_ALLOW256 | DDPCAPS_8BIT, entries, &palette, NULL) != DD_OK)
+                {
+                    if (surface != NULL) { surface->Release(); }
+
+                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+                }
+
+                if (surface->SetPalette(palette) != DD_OK)
+                {
+                    if (surface != NULL) { surface->Release(); }
+
+                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                    if (palette != NULL) { palette->Release(); }
+
+                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+                }
+
+                tex->Palette = palette;
+            }
+            else if (desc.ddpfPixelFormat.dwFlags & DDPF_PALETTEINDEXED4)
+            {
+                tex->Colors = 16;
+
+                PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+
+                for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
+                {
+                    entries[x].peRed = 0;
+                    entries[x].peGreen = 0xff;
+                    entries[x].peBlue = 0;
+                    entries[x].peFlags = 0;
+                }
+
+                if (State.DX.Active.Instance->CreatePalette(DDPCAPS_4BIT, entries, &palette, NULL) != DD_OK)
+                {
+                    if (surface != NULL) { surface->Release(); }
+
+                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+                }
+
+                if (surface->SetPalette(palette) != DD_OK)
+                {
+                    if (surface != NULL) { surface->Release(); }
+
+                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                    if (palette != NULL) { palette->Release(); }
+
+                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+                }
+
+                tex->Palette = palette;
+            }
+            else
+            {
+                tex->Colors = 0;
+                tex->Palette = NULL;
+            }
+
+            if (surface->Blt(NULL, tex->Surface, NULL, DDBLT_WAIT, NULL) != DD_OK)
+            {
+                if (surface != NULL) { surface->Release(); }
+
+                if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                if (palette != NULL) { palette->Release(); }
+
+                return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+            }
+
+            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+            desc.dwSize = sizeof(DDSURFACEDESC2);
+
+            if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3) { desc.dwFlags = DDSD_LINEARSIZE; }
+
+            if (surface->GetSurfaceDesc(&desc) != DD_OK)
+            {
+                if (surface != NULL) { surface->Release(); }
+
+                if (tex->Surface != NULL) { tex->Surface->Release(); }
+
+                if (palette != NULL) { palette->Release(); }
+            }
+
+            tex->MemoryType = desc.ddsCaps.dwCaps & DDSCAPS_VIDEOMEMORY
+                ? (desc.ddsCaps.dwCaps & DDSCAPS_NONLOCALVIDMEM ? RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY : RENDERER_MODULE_TEXTURE_LOCATION_LOCAL_VIDEO_MEMORY)
+                : (desc.ddsCaps.dwCaps & DDSCAPS_SYSTEMMEMORY ? RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY : RENDERER_MODULE_TEXTURE_LOCATION_SYSTEM_MEMORY);
+
+            tex->Texture = surface;
+
+            return RENDERER_INITIALIZE_TEXTURE_DETAILS_OK;
+        }
+
+        return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
+    }
+
+    // 0x60009070
+    void ReleaseRendererTexture(RendererTexture* tex)
+    {
+        if (tex != NULL)
+        {
+            CancelRendererTextureCompression(tex);
+
+            DisposeRendererTexture(tex);
+        }
+    }
+
+    // 0x6000b290
+    u32 DisposeRendererTexture(RendererTexture* tex)
+    {
+        if (tex->PoolIndex != INVALID_TEXTURE_POOL_INDEX)
+        {
+            tex->PoolNext = State.Textures.Pool.Free;
+
+            State.Textures.Pool.Free = tex->PoolIndex;
+            State.Textures.Pool.Available = State.Textures.Pool.Available + 1;
+
+            return RENDERER_MODULE_SUCCESS;
+        }
+
+        if (State.Lambdas.ReleaseMemory != NULL) { return State.Lambdas.ReleaseMemory(tex); }
+
+        free(tex);
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60001650
+    RendererModuleWindowLock* RendererLock(const u32 mode)
+    {
+        WaitRendererThread();
+
+        if (State.DX.Surfaces.Window != NULL)
+        {
+            if (State.Lock.IsActive) { LOGERROR("D3D lock called while locked\n"); }
+
+            if (State.Scene.IsActive) { EndRendererScene(); }
+
+            if (State.Lambdas.Lambdas.LockWindow != NULL) { State.Lambdas.Lambdas.LockWindow(TRUE); }
+
+            DDSURFACEDESC2 desc;
+            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+            desc.dwSize = sizeof(DDSURFACEDESC2);
+
+            u32 options = DDLOCK_SURFACEMEMORYPTR;
+
+            switch (mode)
+            {
+            case LOCK_NONE: { options = DDLOCK_SURFACEMEMORYPTR; break; }
+            case LOCK_READ: { options = DDLOCK_READONLY; break; }
+            case LOCK_WRITE: { options = DDLOCK_WRITEONLY; break; }
+            }
+
+            State.Lock.Surface = State.DX.Surfaces.Window;
+
+            State.DX.Code = State.DX.Surfaces.Window->Lock(NULL, &desc, options | DDLOCK_NOSYSLOCK | DDLOCK_WAIT, NULL);
+
+            if (State.DX.Code != DD_OK)
+            {
+                if (State.Lambdas.Lambdas.LockWindow != NULL) { State.Lambdas.Lambdas.LockWindow(FALSE); }
+
+                return NULL;
+            }
+
+            if (desc.ddpfPixelFormat.dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_16)
+            {
+                State.Lock.State.Format = (desc.ddpfPixelFormat.dwGBitMask == 0x7e0)
+                    ? RENDERER_PIXEL_FORMAT_R5G6B5
+                    : RENDERER_PIXEL_FORMAT_A1R5G5B5;
+            }
+            else if (desc.ddpfPixelFormat.dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_32)
+            {
+                State.Lock.State.Format = RENDERER_PIXEL_FORMAT_A8R8G8B8;
+            }
+            else if (desc.ddpfPixelFormat.dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_24)
+            {
+                State.Lock.State.Format = RENDERER_PIXEL_FORMAT_R8G8B8;
+            }
+
+            if (State.Settings.IsWindowMode)
+            {
+                RECT rect;
+                GetClientRect(State.Window.HWND, &rect);
+
+                POINT point;
+                ZeroMemory(&point, sizeof(POINT));
+
+                ClientToScreen(State.Window.HWND, &point);
+                OffsetRect(&rect, point.x, point.y);
+
+                if (State.DX.Surfaces.Window == State.DX.Surfaces.Active[1]) // TODO
+                {
+                    desc.lpSurface = (void*)((addr)desc.lpSurface
+                        + (addr)((desc.ddpfPixelFormat.dwRGBBitCount >> 3) * rect.left)
+                        + (addr)(desc.lPitch * rect.top));
+                }
+            }
+
+            State.Lock.State.Data = desc.lpSurface;
+            State.Lock.State.Stride = desc.lPitch;
+            State.Lock.State.Width = State.Window.Width;
+            State.Lock.State.Height = State.Window.Height;
+
+            State.Lock.IsActive = TRUE;
+        }
+
+        return &State.Lock.State;
+    }
+
+    // 0x6000bab0
+    void InitializeRenderState55(void)
+    {
+        SelectBasicRendererState(RENDERER_MODULE_STATE_55, (void*)(DAT_60058df4 + 1));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
+    }
+
+    // 0x60009670
+    BOOL AcquireRendererDeviceState(void)
+    {
+        return State.DX.Active.IsInit;
+    }
+    
+    // 0x60009500
+    void ReleaseRendererDevice(void)
+    {
+        if (AcquireRendererDeviceState() && State.Scene.IsActive)
+        {
+            FlushGameWindow();
+            SyncGameWindow(RENDERER_MODULE_SYNC_NORMAL);
+            Idle();
+
+            State.Scene.IsActive = FALSE;
+        }
+
+        ReleaseRendererThread();
+
+        ReleaseRendererTextureCompression();
+
+        if (State.DX.Clipper != NULL)
+        {
+            State.DX.Clipper->Release();
+            State.DX.Clipper = NULL;
+        }
+
+        if (State.DX.GammaControl != NULL)
+        {
+            {
+                const f32 value = 1.0f;
+
+                SelectState(RENDERER_MODULE_STATE_SELECT_GAMMA_CONTROL_STATE, (void*)(u32)(*(u32*)&value));
+            }
+
+            State.DX.GammaControl->Release();
+            State.DX.GammaControl = NULL;
+        }
+
+        ResetTextures();
+
+        ReleaseRendererTexturePool();
+
+        State.DX.Active.Instance = NULL;
+
+        State.DX.Active.Surfaces.Main = NULL;
+        State.DX.Active.Surfaces.Back = NULL;
+        State.DX.Active.Surfaces.Active.Main = NULL;
+        State.DX.Active.Surfaces.Active.Back = NULL;
+
+        State.DX.Surfaces.Window = NULL;
+
+        State.Window.Index = 0;
+
+        if (State.DX.Surfaces.Depth != NULL)
+        {
+            State.DX.Device->SetRenderState(D3DRENDERSTATE_ZENABLE, FALSE);
+            State.DX.Device->SetRenderState(D3DRENDERSTATE_ZWRITEENABLE, FALSE);
+
+            State.DX.Surfaces.Depth->Release();
+            State.DX.Surfaces.Depth = NULL;
+        }
+
+        if (State.DX.Device != NULL)
+        {
+            State.DX.Device->Release();
+            State.DX.Device = NULL;
+        }
+
+        if (State.DX.DirectX != NULL)
+        {
+            State.DX.DirectX->Release();
+            State.DX.DirectX = NULL;
+        }
+
+        State.DX.Active.IsInit = FALSE;
+
+        State.Scene.IsActive = FALSE;
+
+        State.Commands.IsActive = FALSE;
+        State.Commands.Buffers[State.Commands.Index].Count = 0;
+
+        ReleaseRendererWindows();
+    }
+
+    // 0x60001980
+    void ReleaseRendererWindows(void)
+    {
+        for (u32 x = 0; x < State.Window.Count + MIN_WINDOW_INDEX; x++)
+        {
+            if (State.Windows[x + MIN_WINDOW_INDEX].Surface != NULL)
+            {
+                State.Windows[x + MIN_WINDOW_INDEX].Surface->Release();
+                State.Windows[x + MIN_WINDOW_INDEX].Surface = NULL;
+            }
+        }
+
+        State.Window.Count = 0;
+    }
+
+    // 0x6000cf50
+    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette)
+    {
+        if (pixels == NULL && palette == NULL) { return FALSE; }
+
+        if (!ReloadRendererTexture(tex)) { return FALSE; }
+
+        u64 pixelHash = INVALID_TEXTURE_HASH;
+        u64 paletteHash = INVALID_TEXTURE_HASH;
+
+        if (SettingsState.TextureDeduplication)
+        {
+            if (pixels != NULL)
+            {
+                pixelHash = AcquireRendererTextureHash(pixels, AcquireRendererTextureSize(tex));
+
+                if (pixelHash == tex->PixelHash || ShareRendererTexture(tex, pixelHash))
+                {
+                    State.Textures.Statistics.Current.Skipped = State.Textures.Statistics.Current.Skipped + 1;
+
+                    pixels = NULL;
+                }
+            }
+
+            if (palette != NULL && tex->IsPalette)
+            {
+                paletteHash = AcquireRendererTextureHash(palette, MAX_TEXTURE_PALETTE_COLOR_COUNT * sizeof(u32));
+
+                if (paletteHash == tex->PaletteHash)
+                {
+                    State.Textures.Statistics.Current.Skipped = State.Textures.Statistics.Current.Skipped + 1;
+
+                    palette = NULL;
+                }
+            }
+
+            if (pixels == NULL && (palette == NULL || !tex->IsPalette)) { return TRUE; }
+        }
+
+        if (pixels != NULL)
+        {
+            if (!UnshareRendererTexture(tex)) { return FALSE; }
+
+            tex->PixelHash = INVALID_TEXTURE_HASH;
+
+            State.Textures.Statistics.Current.Uploads = State.Textures.Statistics.Current.Uploads + 1;
+
+            if (tex->IsCompressed)
+            {
+                if (!SubmitRendererTextureCompression(tex, pixels)) { return FALSE; }
+
+                tex->PixelHash = pixelHash;
+
+                return TRUE;
+            }
+
+            tex->Descriptor.dwFlags = DDSD_LPSURFACE;
+
+            tex->Descriptor.lpSurface =
+                (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                ? (void*)((addr)pixels + (addr)8) : (void*)pixels;
+
+            if (tex->Surface->SetSurfaceDesc(&tex->Descriptor, 0) != DD_OK) { return FALSE; }
+
+            if (State.Scene.IsActive)
+            {
+                AttemptRenderScene();
+                EndRendererScene();
+            }
+
+            if (!UploadRendererTexture(tex, NULL, NULL)) { return FALSE; }
+        }
+
+        if (palette != NULL && tex->IsPalette)
+        {
+            tex->PaletteHash = INVALID_TEXTURE_HASH;
+
+            State.Textures.Statistics.Current.Uploads = State.Textures.Statistics.Current.Uploads + 1;
+
+            PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+
+            for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
+            {
+                entries[x].peRed = (u8)RGBA_GETRED(palette[x]);
+                entries[x].peGreen = (u8)RGBA_GETGREEN(palette[x]);
+                entries[x].peBlue = (u8)RGBA_GETBLUE(palette[x]);
+                entries[x].peFlags = 0;
+            }
+
+            if (tex->Palette->SetEntries(0, 0, tex->Colors, entries) != DD_OK) { return FALSE; }
+
+            if (tex->Texture->SetPalette(tex->Palette) != DD_OK) { return FALSE; }
+
+            tex->PaletteHash = paletteHash;
+        }
+
+        // NOTE: The mip levels are only updated along with the pixels,
+        // since the update of the mip levels without the pixels releases the surfaces it never acquired.
+        if (pixels != NULL && tex->MipMapCount != 0) { UpdateRendererTexture(tex, pixels); }
+
+        if (pixels != NULL) { tex->PixelHash = pixelHash; }
+
+        return TRUE;
+    }
+
+    // 0x6000d0c0
+    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels)
+    {
+        if (tex->MipMapCount == 0 || tex->MipMapCount == 1) { return TRUE; }
+
+        IDirectDrawSurface7* s1 = tex->Surface;
+        IDirectDrawSurface7* s2 = tex->Texture;
+
+        s1->AddRef();
+        s2->AddRef();
+
+        DDSCAPS2 caps;
+        ZeroMemory(&caps, sizeof(DDSCAPS2));
+
+        DDSURFACEDESC2 desc;
+        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+
+        desc.dwSize = sizeof(DDSURFACEDESC2);
+
+        u32 offset = (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
+            || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3) ? 8 : 0; // TODO
+
+        void* allocated = NULL;
+        u32* data = NULL;
+
+        for (u32 x = 0; x < tex->MipMapCount; x++)
+        {
+            if (pixels != NULL)
+            {
+                s1->GetSurfaceDesc(&desc);
+
+                if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
+                    || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                {
+                    desc.lPitch = desc.lPitch / desc.dwHeight;
+                }
+
+                offset = offset + desc.dwHeight * desc.lPitch;
+
+                caps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE;
+
+                {
+                    IDirectDrawSurface7* attached = NULL;
+                    s1->GetAttachedSurface(&caps, &attached);
+                    s1->Release();
+
+                    s1 = attached;
+                }
+
+                {
+                    IDirectDrawSurface7* attached = NULL;
+                    s2->GetAttachedSurface(&caps, &attached);
+                    s2->Release();
+
+                    s2 = attached;
+                }
+
+                s1->GetSurfaceDesc(&tex->Descriptor);
+
+                tex->Descriptor.dwFlags = DDSD_LPSURFACE;
+
+                const u32 pitch = (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
+                    || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                    ? tex->Descriptor.lPitch
+                    : (tex->Descriptor.ddpfPixelFormat.dwRGBBitCount * ((tex->Descriptor.dwWidth + 7) >> 3));
+
+                if (pitch == tex->Descriptor.lPitch)
+                {
+                    tex->Descriptor.lpSurface = (void*)((addr)pixels + (addr)offset);
+                }
+                else
+                {
+                    if (allocated == NULL)
+                    {
+                        const u32 length = ALIGN(desc.lPitch * desc.dwHeight);
+
+                        allocated = _alloca(length);
+                        memset(allocated, 0xff, length);
+                    }
+
+                    if (data == NULL) { data = (u32*)((addr)pixels + (addr)offset); }
+
+                    tex->Descriptor.lpSurface = allocated;
+
+                    for (u32 xx = 0; xx < tex->Descriptor.dwHeight; xx++)
+                    {
+                        CopyMemory(allocated, (void*)((addr)data + (addr)(xx * pitch)), pitch);
+
+                        allocated = (void*)((addr)allocated + (addr)tex->Descriptor.lPitch);
+                    }
+                }
+
+                s1->SetSurfaceDesc(&tex->Descriptor, 0);
+                s2->Blt(NULL, s1, NULL, DDBLT_WAIT, NULL);
+            }
+
+            s1->Release();
+            s2->Release();
+        }
+
+        return TRUE;
+    }
+
+    // 0x6000cd50
+    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette, const u32 x, const u32 y, const u32 width, const u32 height, const u32 stride)
+    {
+        // NOTE: The rectangles of the compressed textures are not updated, since they do not cover the whole blocks.
+        if (pixels != NULL && tex->IsCompressed) { return FALSE; }
+
+        if (!ReloadRendererTexture(tex)) { return FALSE; }
+
+        if (pixels != NULL)
+        {
+            if (!UnshareRendererTexture(tex)) { return FALSE; }
+
+            tex->PixelHash = INVALID_TEXTURE_HASH;
+
+            RECT source;
+
+            source.left = x;
+            source.right = x + width;
+            source.top = y;
+            source.bottom = y + height;
+
+            RECT destination;
+
+            destination.left = 0;
+            destination.right = width;
+            destination.top = 0;
+            destination.bottom = height;
+
+            tex->Descriptor.dwFlags = DDSD_LPSURFACE;
+
+            tex->Descriptor.lpSurface =
+                (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                ? (void*)((addr)pixels + (addr)8) : (void*)pixels;
+
+            if (tex->Descriptor.lPitch != stride)
+            {
+                const u32 length = ALIGN(tex->Descriptor.lPitch * height);
+
+                void* allocated = _alloca(length);
+                memset(allocated, 0xff, length);
+
+                tex->Descriptor.lpSurface = (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
+                    || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+                    ? (void*)((addr)allocated + (addr)8) : allocated;
+
+                for (u32 xx = 0; xx < height; xx++)
+                {
+                    CopyMemory(allocated, (void*)((addr)pixels + (addr)(xx * stride)), stride);
+
+                    allocated = (void*)((addr)allocated + (addr)tex->Descriptor.lPitch);
+                }
+            }
+
+            if (tex->Surface->SetSurfaceDesc(&tex->Descriptor, 0) != DD_OK) { return FALSE; }
+
+            if (State.Scene.IsActive)
+            {
+                AttemptRenderScene();
+                EndRendererScene();
+            }
+
+            if (!UploadRendererTexture(tex, &source, &destination)) { return FALSE; }
+        }
+
+        if (palette != NULL && tex->IsPalette)
+        {
+            tex->PaletteHash = INVALID_TEXTURE_HASH;
+
+            PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+
+            for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
+            {
+                entries[x].peRed = (u8)RGBA_GETRED(palette[x]);
+                entries[x].peGreen = (u8)RGBA_GETGREEN(palette[x]);
+                entries[x].peBlue = (u8)RGBA_GETBLUE(palette[x]);
+                entries[x].peFlags = 0;
+            }
+
+            if (tex->Palette->SetEntries(0, 0, tex->Colors, entries) != DD_OK) { return FALSE; }
+
+            if (tex->Texture->SetPalette(tex->Palette) != DD_OK) { return FALSE; }
+        }
+
+        // NOTE: The mip levels are only updated along with the pixels,
+        // since the update of the mip levels without the pixels releases the surfaces it never acquired.
+        if (pixels != NULL && tex->MipMapCount != 0) { UpdateRendererTexture(tex, pixels); }
+
+        return TRUE;
+    }
+
+    // Calculates the 64-bit hash of the data, the hash is never equal to INVALID_TEXTURE_HASH.
+    // NOTE: The data is consumed as four interleaved lanes of 32-bit words, so the hashing of the large textures is memory bound.
+    u64 AcquireRendererTextureHash(const void* data, const u32 size)
+    {
+        const u8* bytes = (u8*)data;
+
+        u32 h1 = TEXTURE_HASH_PRIME_5 + size;
+        u32 h2 = TEXTURE_HASH_PRIME_4 ^ size;
+
+        if (16 <= size)
+        {
+            u32 v1 = TEXTURE_HASH_PRIME_1 + TEXTURE_HASH_PRIME_2;
+            u32 v2 = TEXTURE_HASH_PRIME_2;
+            u32 v3 = 0;
+            u32 v4 = 0 - TEXTURE_HASH_PRIME_1;
+
+            const u32 count = size >> 4;
+
+            for (u32 x = 0; x < count; x++)
             {
-                DDSURFACEDESC2 desc;
-                ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+                const u32* values = (u32*)((addr)bytes + (addr)(x << 4));
 
-                desc.dwSize = sizeof(DDSURFACEDESC2);
+                v1 = ROTATE_LEFT(v1 + values[0] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v2 = ROTATE_LEFT(v2 + values[1] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v3 = ROTATE_LEFT(v3 + values[2] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v4 = ROTATE_LEFT(v4 + values[3] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+            }
 
-                result = ds->GetSurfaceDesc(&desc);
+            h1 = h1 + ROTATE_LEFT(v1, 1) + ROTATE_LEFT(v2, 7) + ROTATE_LEFT(v3, 12) + ROTATE_LEFT(v4, 18);
+            h2 = h2 + (v1 ^ ROTATE_LEFT(v3, 16)) * TEXTURE_HASH_PRIME_3 + (v2 ^ ROTATE_LEFT(v4, 16)) * TEXTURE_HASH_PRIME_1;
 
-                if (result == DD_OK)
-                {
-                    State.Device.Capabilities.IsDepthVideoMemoryCapable = (desc.ddsCaps.dwCaps & DDSCAPS_VIDEOMEMORY) != 0;
+            bytes = (u8*)((addr)bytes + (addr)(count << 4));
+        }
 
-                    if (!State.Device.Capabilities.IsAccelerated || State.Device.Capabilities.IsDepthVideoMemoryCapable)
-                    {
-                        if (ds != NULL) { ds->Release(); }
+        const u32 remainder = size & 15;
 
-                        return TRUE;
-                    }
+        for (u32 x = 0; x < (remainder >> 2); x++)
+        {
+            const u32 value = ((u32*)bytes)[x];
 
-                    LOGWARNING("Could not fit the Z-buffer in video memory for this hardware device.\n");
-                }
-                else { LOGWARNING("Failed to get surface description of Z buffer %d.\n", result); }
+            h1 = ROTATE_LEFT(h1 + value * TEXTURE_HASH_PRIME_3, 17) * TEXTURE_HASH_PRIME_4;
+            h2 = ROTATE_LEFT(h2 ^ (value * TEXTURE_HASH_PRIME_2), 15) * TEXTURE_HASH_PRIME_1;
+        }
+
+        for (u32 x = remainder & (~3); x < remainder; x++)
+        {
+            h1 = ROTATE_LEFT(h1 + bytes[x] * TEXTURE_HASH_PRIME_5, 11) * TEXTURE_HASH_PRIME_1;
+            h2 = (h2 ^ bytes[x]) * TEXTURE_HASH_PRIME_3;
+        }
+
+        h1 = h1 ^ (h1 >> 15);
+        h1 = h1 * TEXTURE_HASH_PRIME_2;
+        h1 = h1 ^ (h1 >> 13);
+        h1 = h1 * TEXTURE_HASH_PRIME_3;
+        h1 = h1 ^ (h1 >> 16);
+
+        h2 = h2 + h1;
+
+        h2 = h2 ^ (h2 >> 15);
+        h2 = h2 * TEXTURE_HASH_PRIME_2;
+        h2 = h2 ^ (h2 >> 13);
+        h2 = h2 * TEXTURE_HASH_PRIME_3;
+        h2 = h2 ^ (h2 >> 16);
+
+        const u64 result = ((u64)h1 << 32) | (u64)h2;
+
+        return result == INVALID_TEXTURE_HASH ? (INVALID_TEXTURE_HASH + 1) : result;
+    }
+
+    // Calculates the size of the pixels of all of the levels of the texture, as provided by the application.
+    u32 AcquireRendererTextureSize(RendererTexture* tex)
+    {
+        const u32 levels = Max((u32)tex->MipMapCount, (u32)1);
+
+        if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
+        {
+            const u32 block = tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 ? 8 : 16;
+
+            u32 result = 8; // NOTE: The header of the block compressed pixels.
+
+            for (u32 x = 0; x < levels; x++)
+            {
+                const u32 width = (Max(tex->Width >> x, (u32)1) + 3) >> 2;
+                const u32 height = (Max(tex->Height >> x, (u32)1) + 3) >> 2;
+
+                result = result + width * height * block;
             }
-            else { LOGWARNING("AddAttachedBuffer failed for Z-Buffer %d.\n", result); }
+
+            return result;
         }
 
-        State.DX.Device->SetRenderState(D3DRENDERSTATE_ZENABLE, D3DZB_FALSE);
-        State.DX.Device->SetRenderState(D3DRENDERSTATE_ZWRITEENABLE, FALSE);
+        u32 result = 0;
 
-        if (ds != NULL) { ds->Release(); }
+        for (u32 x = 0; x < levels; x++)
+        {
+            const u32 width = Max(tex->Width >> x, (u32)1);
+            const u32 height = Max(tex->Height >> x, (u32)1);
+
+            result = result + (tex->IsCompressed
+                ? (width * height * AcquireRendererTextureCompressionPixelSize(tex->FormatIndexValue))
+                : (((width * tex->Descriptor.ddpfPixelFormat.dwRGBBitCount + 7) >> 3) * height));
+        }
+
+        return result;
+    }
+
+    // Checks whether the device texture of the texture is shared with any other texture.
+    BOOL IsRendererTextureShared(RendererTexture* tex)
+    {
+        if (tex->Texture == NULL) { return FALSE; }
+
+        for (u32 indx = 0; indx < State.Textures.Active.Count; indx++)
+        {
+            RendererTexture* x = State.Textures.Active.Textures[indx];
+
+            if (x != tex && x->IsShareable && x->Texture == tex->Texture) { return TRUE; }
+        }
 
         return FALSE;
     }
 
-    // 0x6000a450
-    HRESULT CALLBACK EnumerateRendererDevicePixelFormats(LPDDPIXELFORMAT format, LPVOID context)
+    // Attempts to replace the device texture of the texture with the device texture of another texture of the same contents.
+    BOOL ShareRendererTexture(RendererTexture* tex, const u64 hash)
     {
-        if ((format->dwFlags & DDPF_ZBUFFER) && format->dwRGBBitCount == State.Window.Bits)
+        if (!tex->IsShareable || tex->Texture == NULL) { return FALSE; }
+
+        for (u32 indx = 0; indx < State.Textures.Active.Count; indx++)
         {
-            CopyMemory(context, format, sizeof(DDPIXELFORMAT));
+            RendererTexture* x = State.Textures.Active.Textures[indx];
 
-            return D3DENUMRET_CANCEL;
+            if (x == tex || !x->IsShareable || x->PixelHash != hash) { continue; }
+
+            // NOTE: The pending compression is yet to be uploaded into the device texture.
+            if (x->Texture == NULL || x->Compression != NULL) { continue; }
+
+            if (x->Width != tex->Width || x->Height != tex->Height
+                || x->FormatIndex != tex->FormatIndex || x->MipMapCount != tex->MipMapCount) { continue; }
+
+            CancelRendererTextureCompression(tex);
+
+            if (x->Texture != tex->Texture)
+            {
+                // NOTE: The recorded commands are rendered before the device texture changes.
+                RenderRendererCommands();
+
+                x->Texture->AddRef();
+
+                tex->Texture->Release();
+                tex->Texture = x->Texture;
+            }
+
+            tex->PixelHash = hash;
+
+            return TRUE;
         }
 
-        return D3DENUMRET_OK;
+        return FALSE;
     }
-    
-    // 0x60002060
-    void SelectRendererDevice(void)
+
+    // Replaces the shared device texture of the texture with the device texture of its own, that holds the same contents.
+    BOOL UnshareRendererTexture(RendererTexture* tex)
     {
-        if (RendererDeviceIndex < DEFAULT_DEVICE_INDEX)
+        if (!IsRendererTextureShared(tex)) { return TRUE; }
+
+        IDirectDrawSurface7* surface = tex->Surface;
+        IDirectDrawSurface7* texture = tex->Texture;
+
+        texture->AddRef();
+
+        RenderRendererCommands();
+
+        // NOTE: The surfaces created before the failure are released by the initialization.
+        if (InitializeRendererTextureDetails(tex, FALSE) != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
         {
-            if (State.Lambdas.Lambdas.AcquireWindow != NULL || State.Window.HWND != NULL)
+            tex->Surface = surface;
+            tex->Texture = texture;
+
+            return FALSE;
+        }
+
+        surface->Release();
+
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+            EndRendererScene();
+        }
+
+        CopyRendererTextureLevels(tex->Texture, texture, Max((u32)tex->MipMapCount, (u32)1));
+
+        texture->Release();
+
+        return TRUE;
+    }
+
+    // Copies the levels of the source surface into the levels of the destination surface of the same dimensions and format.
+    BOOL CopyRendererTextureLevels(IDirectDrawSurface7* destination, IDirectDrawSurface7* source, const u32 levels)
+    {
+        IDirectDrawSurface7* s1 = source;
+        IDirectDrawSurface7* s2 = destination;
+
+        s1->AddRef();
+        s2->AddRef();
+
+        BOOL result = TRUE;
+
+        for (u32 x = 0; x < levels; x++)
+        {
+            if (x != 0)
             {
-                const char* value = getenv(RENDERER_MODULE_DISPLAY_ENVIRONMENT_PROPERTY_NAME);
+                DDSCAPS2 caps;
+                ZeroMemory(&caps, sizeof(DDSCAPS2));
 
-                SelectDevice(value == NULL ? DEFAULT_DEVICE_INDEX : atoi(value));
+                caps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE;
+
+                IDirectDrawSurface7* attached = NULL;
+
+                if (s1->GetAttachedSurface(&caps, &attached) != DD_OK) { result = FALSE; break; }
+
+                s1->Release();
+                s1 = attached;
+
+                attached = NULL;
+
+                if (s2->GetAttachedSurface(&caps, &attached) != DD_OK) { result = FALSE; break; }
+
+                s2->Release();
+                s2 = attached;
             }
+
+            if (s2->Blt(NULL, s1, NULL, DDBLT_WAIT, NULL) != DD_OK) { result = FALSE; break; }
+        }
+
+        s1->Release();
+        s2->Release();
+
+        return result;
+    }
+
+    // Calculates the size of the device texture of the texture, the size is zero for the textures outside of the video memory.
+    u32 AcquireRendererTextureMemorySize(RendererTexture* tex)
+    {
+        if (!State.Device.Capabilities.IsAccelerated) { return 0; }
+
+        const TextureFormat* format = &State.Textures.Formats.Formats[tex->FormatIndex];
+
+        const u32 levels = Max((u32)tex->MipMapCount, (u32)1);
+
+        u32 result = 0;
+
+        for (u32 x = 0; x < levels; x++)
+        {
+            const u32 width = Max(tex->Width >> x, (u32)1);
+            const u32 height = Max(tex->Height >> x, (u32)1);
+
+            result = result + (format->DXTF != DXT_FORMAT_NONE
+                ? (((width + 3) >> 2) * ((height + 3) >> 2) * (format->DXTF == DXT_FORMAT_DXT1 ? 8 : 16))
+                : (((width * format->Descriptor.ddpfPixelFormat.dwRGBBitCount + 7) >> 3) * height));
         }
+
+        return result;
     }
 
-    // 0x600092c0
-    void AcquireRendererModuleDescriptor(RendererModuleDescriptor* desc, const char* section)
+    // Acquires the least recently used texture, which device texture can be evicted from the video memory.
+    // NOTE: The textures selected within the current frame, or still selected into the device, are never evicted.
+    RendererTexture* AcquireRendererTextureEviction(RendererTexture* keep)
     {
-        desc->Signature = AcquireSettingsValue(desc->Signature, section, "signature");
-        desc->Version = AcquireSettingsValue(desc->Version, section, "version");
+        RendererTexture* result = NULL;
 
+        for (u32 indx = 0; indx < State.Textures.Active.Count; indx++)
         {
-            const u32 caps = desc->Caps;
+            RendererTexture* x = State.Textures.Active.Textures[indx];
 
-            const u32 lw = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_LINE_WIDTH) >> 0, section, "linewidth");
-            const u32 ts = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TEXTURE_SQUARE) >> 1, section, "texturesquare");
-            const u32 twp2 = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TEXTURE_WIDTH_POW2) >> 2, section, "texturewidthpowerof2");
-            const u32 thp2 = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TEXTURE_HEIGHT_POW2) >> 3, section, "textureheightpowerof2");
-            const u32 soft = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_SOFTWARE) >> 4, section, "software");
-            const u32 win = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_WINDOWED) >> 5, section, "windowed");
-            const u32 gc = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_GLOBAL_CUT) >> 6, section, "globalclut");
-            const u32 tn2p = AcquireSettingsValue((caps & RENDERER_MODULE_CAPS_TRILINEAR_PASS) >> 7, section, "trilinear2pass");
+            if (x == keep || !x->IsEvictable || x->Size == 0) { continue; }
 
-            desc->Caps = ((lw & 1) << 0) | ((ts & 1) << 1) | ((twp2 & 1) << 2) | ((thp2 & 1) << 3)
-                | ((soft & 1) << 4) | ((win & 1) << 5) | ((gc & 1) << 6) | ((tn2p & 1) << 7);
+            if (x->Texture == NULL || x->Backup != NULL || x->Compression != NULL) { continue; }
+
+            if (x->Frame == State.Textures.Frame) { continue; }
+
+            if (result != NULL && result->Frame <= x->Frame) { continue; }
+
+            BOOL selected = FALSE;
+
+            for (u32 xx = 0; xx < MAX_TEXTURE_STAGE_COUNT; xx++)
+            {
+                if (State.Commands.Current.Textures[xx] == x->Texture || State.Commands.Device.Textures[xx] == x->Texture) { selected = TRUE; }
+            }
+
+            if (selected || IsRendererTextureShared(x)) { continue; }
+
+            result = x;
         }
 
-        desc->MinimumTextureWidth = AcquireSettingsValue(desc->MinimumTextureWidth, section, "texturewidthmin");
-        desc->MaximumTextureWidth = AcquireSettingsValue(desc->MaximumTextureWidth, section, "texturewidthmax");
-        desc->MultipleTextureWidth = AcquireSettingsValue(desc->MultipleTextureWidth, section, "texturewidthmultiple");
-        desc->MinimumTextureHeight = AcquireSettingsValue(desc->MinimumTextureHeight, section, "textureheightmin");
-        desc->MaximumTextureHeight = AcquireSettingsValue(desc->MaximumTextureHeight, section, "textureheightmax");
-        desc->MultipleTextureHeight = AcquireSettingsValue(desc->MultipleTextureHeight, section, "textureheightmultiple");
-        desc->ClipAlign = AcquireSettingsValue(desc->ClipAlign, section, "clipalign");
-        desc->MaximumSimultaneousTextures = AcquireSettingsValue(desc->MaximumSimultaneousTextures, section, "numstages");
-        desc->SubType = AcquireSettingsValue(desc->SubType, section, "subtype");
-        desc->VideoMemorySize = AcquireSettingsValue(desc->VideoMemorySize, section, "textureramsize");
-        desc->TotalMemorySize = AcquireSettingsValue(desc->TotalMemorySize, section, "textureramtype");
-        desc->DXV = AcquireSettingsValue(desc->DXV, section, "dxversion");
+        return result;
     }
 
-    // 0x60008dc0
-    u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1, const BOOL window)
+    // Copies the device texture of the texture into the system memory, and releases the device texture.
+    BOOL EvictRendererTexture(RendererTexture* tex)
     {
-        AttemptRenderScene();
+        if (tex == NULL) { return FALSE; }
 
-        D3DRECT rect;
+        DDSURFACEDESC2 desc;
+        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
 
-        DWORD options = (window == FALSE); // D3DCLEAR_TARGET
-        
-        if (State.Device.Capabilities.IsDepthAvailable && State.Window.Bits != 0) { options = options | D3DCLEAR_ZBUFFER; }
+        desc.dwSize = sizeof(DDSURFACEDESC2);
 
-        if (State.Device.Capabilities.IsStencilBufferAvailable) { options = options | D3DCLEAR_STENCIL; }
+        if (tex->Texture->GetSurfaceDesc(&desc) != DD_OK) { return FALSE; }
 
-        if (x1 == 0)
+        if (tex->MipMapCount == 0)
         {
-            rect.x1 = 0;
-            rect.y1 = 0;
-            rect.x2 = State.Window.Width;
-            rect.y2 = State.Window.Height;
+            desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+            desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
         }
         else
         {
-            rect.x1 = x0;
-            rect.x2 = x1;
-            rect.y1 = y0;
-            rect.y2 = y1;
+            desc.dwFlags = DDSD_MIPMAPCOUNT | DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+            desc.ddsCaps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY | DDSCAPS_COMPLEX;
+            desc.dwMipMapCount = tex->MipMapCount;
+        }
+
+        desc.ddsCaps.dwCaps2 = 0;
+
+        IDirectDrawSurface7* backup = NULL;
+
+        if (State.DX.Active.Instance->CreateSurface(&desc, &backup, NULL) != DD_OK) { return FALSE; }
+
+        RenderRendererCommands();
+
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+            EndRendererScene();
+        }
+
+        if (!CopyRendererTextureLevels(backup, tex->Texture, Max((u32)tex->MipMapCount, (u32)1)))
+        {
+            backup->Release();
+
+            return FALSE;
         }
 
-        return State.DX.Device->Clear(1, &rect, options, RendererClearColor, RendererClearDepth, 0) == DD_OK;
+        tex->Texture->Release();
+        tex->Texture = NULL;
+
+        tex->Backup = backup;
+
+        State.Textures.Size = State.Textures.Size - tex->Size;
+
+        State.Textures.Statistics.Current.Evicted = State.Textures.Statistics.Current.Evicted + 1;
+
+        return TRUE;
     }
 
-    // 0x60008a50
-    // a.k.a. showbackbuffer
-    u32 ToggleRenderer(void)
+    // Evicts the least recently used device textures, until the textures of the size fit into the available video memory.
+    void EvictRendererTextures(const u32 size, RendererTexture* keep)
     {
-        if (State.Lock.IsActive) { UnlockGameWindow(NULL); }
+        while (State.Settings.MaxAvailableMemory < State.Textures.Size + size)
+        {
+            if (!EvictRendererTexture(AcquireRendererTextureEviction(keep))) { return; }
+        }
+    }
+
+    // Recreates the device texture of the evicted texture, and copies the system memory copy back into it.
+    BOOL ReloadRendererTexture(RendererTexture* tex)
+    {
+        if (tex->Backup == NULL) { return TRUE; }
+
+        EvictRendererTextures(tex->Size, tex);
+
+        IDirectDrawSurface7* surface = tex->Surface;
+        IDirectDrawPalette* palette = tex->Palette;
+
+        // NOTE: The surfaces created before the failure are released by the initialization.
+        while (InitializeRendererTextureDetails(tex, FALSE) != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
+        {
+            tex->Surface = surface;
+            tex->Texture = NULL;
+            tex->Palette = palette;
+
+            if (!EvictRendererTexture(AcquireRendererTextureEviction(tex))) { return FALSE; }
+        }
+
+        // NOTE: The system memory surface of the texture is kept, along with its palette.
+        tex->Surface->Release();
+        tex->Surface = surface;
+
+        if (palette != NULL)
+        {
+            tex->Texture->SetPalette(palette);
+
+            if (tex->Palette != NULL && tex->Palette != palette) { tex->Palette->Release(); }
+
+            tex->Palette = palette;
+        }
+
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+            EndRendererScene();
+        }
+
+        CopyRendererTextureLevels(tex->Texture, tex->Backup, Max((u32)tex->MipMapCount, (u32)1));
+
+        tex->Backup->Release();
+        tex->Backup = NULL;
+
+        State.Textures.Size = State.Textures.Size + tex->Size;
+
+        State.Textures.Statistics.Current.Reloaded = State.Textures.Statistics.Current.Reloaded + 1;
+
+        return TRUE;
+    }
+
+    // Packs the small texture into the atlas of its format, and creates the system memory surface of the texture,
+    // which pixels are copied into the rectangle of the texture within the atlas on upload.
+    BOOL PackRendererTexture(RendererTexture* tex)
+    {
+        if (SettingsState.TextureAtlas < tex->Width || SettingsState.TextureAtlas < tex->Height) { return FALSE; }
+
+        if (tex->MipMapCount != 0 || tex->Stage != RENDERER_TEXTURE_STAGE_0 || tex->FormatIndex < 0) { return FALSE; }
+
+        if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3
+            || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_2
+            || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_3) { return FALSE; }
+
+        const u32 width = tex->Width + 2 * TEXTURE_ATLAS_BORDER_SIZE;
+        const u32 height = tex->Height + 2 * TEXTURE_ATLAS_BORDER_SIZE;
+
+        if (MAX_TEXTURE_ATLAS_DIMENSION < width || MAX_TEXTURE_ATLAS_DIMENSION < height) { return FALSE; }
+
+        DDSURFACEDESC2 desc;
+        CopyMemory(&desc, &State.Textures.Formats.Formats[tex->FormatIndex].Descriptor, sizeof(DDSURFACEDESC2));
 
-        if (!State.Settings.IsWindowMode)
-        {
-            if (State.DX.Active.Surfaces.Back != NULL)
-            {
-                HRESULT result = State.DX.Active.Surfaces.Main->Flip(NULL, RendererToggleOptions);
+        if (desc.ddpfPixelFormat.dwFlags & (DDPF_PALETTEINDEXED4 | DDPF_PALETTEINDEXED8 | DDPF_FOURCC | DDPF_BUMPDUDV)) { return FALSE; }
 
-                if (result == DDERR_SURFACELOST) { return RENDERER_MODULE_FAILURE; }
+        desc.dwSize = sizeof(DDSURFACEDESC2);
+        desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+        desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
 
-                const u32 state = AcquireState(RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE);
+        if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
+        else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
 
-                if (!State.Settings.IsToggleAllowed) { return RENDERER_MODULE_FAILURE; }
+        desc.dwHeight = tex->Height;
+        desc.dwWidth = tex->Width;
 
-                while (TRUE)
-                {
-                    while (result = State.DX.Active.Instance->TestCooperativeLevel(), result == DD_OK)
-                    {
-                        ResetTextures();
+        IDirectDrawSurface7* surface = NULL;
 
-                        if (result = State.DX.Active.Instance->RestoreAllSurfaces(), result == DD_OK) { return RENDERER_MODULE_SUCCESS; }
+        if (State.DX.Active.Instance->CreateSurface(&desc, &surface, NULL) != DD_OK) { return FALSE; }
 
-                        Sleep(1);
-                    }
+        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
 
-                    if (result == DDERR_WRONGMODE) { break; }
+        desc.dwSize = sizeof(DDSURFACEDESC2);
 
-                    if (result == DDERR_EXCLUSIVEMODEALREADYSET || result == DDERR_NOEXCLUSIVEMODE) { Sleep(1); }
+        if (surface->GetSurfaceDesc(&desc) != DD_OK)
+        {
+            surface->Release();
 
-                    Sleep(1);
-                }
+            return FALSE;
+        }
 
-                SelectVideoMode(state, 2, 1); // TODO
+        RendererTextureAtlas* atlas = NULL;
+        RendererTextureAtlas* available = NULL;
 
-                return RENDERER_MODULE_SUCCESS;
+        for (u32 x = 0; x < MAX_TEXTURE_ATLAS_COUNT; x++)
+        {
+            RendererTextureAtlas* a = &State.Textures.Atlases.Atlases[x];
+
+            if (a->Texture == NULL)
+            {
+                if (available == NULL) { available = a; }
+
+                continue;
             }
+
+            if (a->FormatIndex == tex->FormatIndex && AcquireRendererTextureAtlasPosition(a, width, height, &tex->AtlasX, &tex->AtlasY)) { atlas = a; break; }
         }
-        else
+
+        if (atlas == NULL)
         {
-            for (u32 x = 0; x < 1000000; x++)
+            if (available == NULL || !InitializeRendererTextureAtlas(available, tex->FormatIndex))
             {
-                const HRESULT result = State.DX.Active.Surfaces.Main->GetBltStatus(DDGBS_ISBLTDONE);
+                surface->Release();
 
-                if (result != DDERR_WASSTILLDRAWING && result != DDERR_SURFACEBUSY) { break; }
+                return FALSE;
             }
 
-            RECT dst;
-            RECT src;
+            atlas = available;
 
-            if (!State.Settings.IsWindowMode)
-            {
-                GetClientRect(State.Window.HWND, &dst);
+            AcquireRendererTextureAtlasPosition(atlas, width, height, &tex->AtlasX, &tex->AtlasY);
+        }
 
-                POINT point;
-                ZeroMemory(&point, sizeof(POINT));
+        CopyMemory(&tex->Descriptor, &desc, sizeof(DDSURFACEDESC2));
 
-                ClientToScreen(State.Window.HWND, &point);
-                OffsetRect(&dst, point.x, point.y);
-                SetRect(&src, 0, 0, State.Window.Width, State.Window.Height);
-            }
-            else
-            {
-                POINT point;
-                ZeroMemory(&point, sizeof(POINT));
+        atlas->Texture->AddRef();
+        atlas->Count = atlas->Count + 1;
 
-                ClientToScreen(State.Window.HWND, &point);
-                SetRect(&dst, point.x, point.y, State.Window.Width + point.x, State.Window.Height + point.y);
-                SetRect(&src, 0, 0, State.Window.Width, State.Window.Height);
-            }
+        tex->Surface = surface;
+        tex->Texture = atlas->Texture;
+        tex->Palette = NULL;
+        tex->Colors = 0;
 
-            const HRESULT result = State.DX.Active.Surfaces.Active.Main->Blt(&dst,
-                State.DX.Active.Surfaces.Active.Back, &src, RendererBlitOptions, NULL);
+        tex->MemoryType = State.Device.Capabilities.IsAccelerated
+            ? RENDERER_MODULE_TEXTURE_LOCATION_LOCAL_VIDEO_MEMORY : RENDERER_MODULE_TEXTURE_LOCATION_SYSTEM_MEMORY;
 
-            if (result != DD_OK) { return RENDERER_MODULE_FAILURE; }
-        }
+        tex->Atlas = atlas;
 
-        return RENDERER_MODULE_SUCCESS;
+        // NOTE: The video memory of the atlas is accounted for once, and the atlas is never evicted.
+        tex->IsShareable = FALSE;
+        tex->IsEvictable = FALSE;
+        tex->Size = 0;
+
+        return TRUE;
     }
 
-    // 0x60008a10
-    BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value)
+    // Acquires the position of the rectangle of the dimensions, including the border, within the row of the atlas,
+    // a new row is started below the current one when the rectangle does not fit into it.
+    BOOL AcquireRendererTextureAtlasPosition(RendererTextureAtlas* atlas, const u32 width, const u32 height, u32* x, u32* y)
     {
-        if (!State.Scene.IsActive) { BeginRendererScene(); }
+        if (MAX_TEXTURE_ATLAS_DIMENSION < atlas->X + width)
+        {
+            atlas->X = 0;
+            atlas->Y = atlas->Y + atlas->Height;
+            atlas->Height = 0;
+        }
 
-        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+        if (MAX_TEXTURE_ATLAS_DIMENSION < atlas->Y + height) { return FALSE; }
+
+        *x = atlas->X + TEXTURE_ATLAS_BORDER_SIZE;
+        *y = atlas->Y + TEXTURE_ATLAS_BORDER_SIZE;
 
-        return State.DX.Device->SetRenderState(type, value) == DD_OK;
+        atlas->X = atlas->X + width;
+        atlas->Height = Max(atlas->Height, height);
+
+        return TRUE;
     }
 
-    // 0x600089d0
-    BOOL SelectRendererTextureStage(const u32 stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value)
+    // Creates the device texture of the atlas of the format, and clears it.
+    BOOL InitializeRendererTextureAtlas(RendererTextureAtlas* atlas, const s32 format)
     {
-        if (!State.Scene.IsActive) { BeginRendererScene(); }
+        DDSURFACEDESC2 desc;
+        CopyMemory(&desc, &State.Textures.Formats.Formats[format].Descriptor, sizeof(DDSURFACEDESC2));
 
-        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+        desc.dwSize = sizeof(DDSURFACEDESC2);
+        desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
+        desc.ddsCaps.dwCaps = State.Device.Capabilities.IsAccelerated
+            ? DDSCAPS_TEXTURE | DDSCAPS_VIDEOMEMORY : DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
+        desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC;
 
-        return State.DX.Device->SetTextureStageState(stage, type, value) == DD_OK;
-    }
+        desc.dwHeight = MAX_TEXTURE_ATLAS_DIMENSION;
+        desc.dwWidth = MAX_TEXTURE_ATLAS_DIMENSION;
 
-    // 0x60008d00
-    void SelectRendererMaterial(const u32 color)
-    {
-        D3DMATERIAL7 material;
-        ZeroMemory(&material, sizeof(D3DMATERIAL7));
+        const u32 size = State.Device.Capabilities.IsAccelerated
+            ? (((MAX_TEXTURE_ATLAS_DIMENSION * desc.ddpfPixelFormat.dwRGBBitCount + 7) >> 3) * MAX_TEXTURE_ATLAS_DIMENSION) : 0;
 
-        RendererClearColor = color;
+        EvictRendererTextures(size, NULL);
 
-        const f32 red = RGBA_GETRED(color) / 255.0f;
-        const f32 green = RGBA_GETGREEN(color) / 255.0f;
-        const f32 blue = RGBA_GETBLUE(color) / 255.0f;
+        IDirectDrawSurface7* surface = NULL;
 
-        material.diffuse.r = red;
-        material.diffuse.g = green;
-        material.diffuse.b = blue;
+        if (State.DX.Active.Instance->CreateSurface(&desc, &surface, NULL) != DD_OK) { return FALSE; }
 
-        material.ambient.r = red;
-        material.ambient.g = green;
-        material.ambient.b = blue;
+        DDBLTFX fx;
+        ZeroMemory(&fx, sizeof(DDBLTFX));
 
-        State.DX.Device->SetMaterial(&material);
-    }
+        fx.dwSize = sizeof(DDBLTFX);
+        fx.dwFillColor = 0;
 
-    // 0x60006e50
-    void SelectRendererFogAlphas(const u8* input, u8* output)
-    {
-        if (input == NULL) { return; }
+        surface->Blt(NULL, NULL, NULL, DDBLT_COLORFILL | DDBLT_WAIT, &fx);
 
-        for (u32 x = 0; x < MAX_OUTPUT_FOG_ALPHA_COUNT; x++)
-        {
-            const f32 value = roundf(x / 255.0f) * 63.0f;
-            const u32 indx = (u32)value;
+        atlas->Texture = surface;
+        atlas->FormatIndex = format;
+        atlas->Count = 0;
+        atlas->Size = size;
+        atlas->X = 0;
+        atlas->Y = 0;
+        atlas->Height = 0;
 
-            const f32 diff = value - indx;
+        State.Textures.Size = State.Textures.Size + size;
 
-            if (0.0f < diff)
-            {
-                const u8 result = (u8)roundf(input[indx] + (input[indx + 1] - input[indx]) * diff);
-                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - result);
-            }
-            else
-            {
-                output[x] = (u8)(MAX_OUTPUT_FOG_ALPHA_VALUE - input[indx]);
-            }
-        }
+        return TRUE;
     }
 
-    // 0x60008c80
-    BOOL RestoreRendererSurfaces(void)
+    // Moves the packed texture out of its atlas into the device texture of its own, the texture is never packed again.
+    BOOL UnpackRendererTexture(RendererTexture* tex)
     {
-        for (u32 x = 0; x < 5000; x++)
+        if (tex->Atlas == NULL) { return TRUE; }
+
+        IDirectDrawSurface7* surface = tex->Surface;
+        IDirectDrawSurface7* texture = tex->Texture;
+
+        RenderRendererCommands();
+
+        tex->Texture = NULL;
+        tex->Size = AcquireRendererTextureMemorySize(tex);
+
+        EvictRendererTextures(tex->Size, tex);
+
+        // NOTE: The surfaces created before the failure are released by the initialization.
+        if (InitializeRendererTextureDetails(tex, FALSE) != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
         {
-            if (State.DX.Active.Instance->TestCooperativeLevel() == DD_OK)
-            {
-                return State.DX.Active.Instance->RestoreAllSurfaces() == DD_OK;
-            }
+            tex->Surface = surface;
+            tex->Texture = texture;
+            tex->Size = 0;
 
-            Sleep(100);
+            return FALSE;
         }
 
-        LOGERROR("WARNING! STATE_RESTORESURFACES failed. Focus/Mode not regained before timeout.\n");
+        surface->Release();
 
-        return FALSE;
-    }
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+            EndRendererScene();
+        }
 
-    // 0x60006fa0
-    void SelectRendererVertexCount(void)
-    {
-        AttemptRenderScene();
+        RECT rect;
 
-        MaximumRendererVertexCount = MAX_VERTEX_COUNT / RendererVertexSize;
-    }
+        rect.left = tex->AtlasX;
+        rect.right = tex->AtlasX + tex->Width;
+        rect.top = tex->AtlasY;
+        rect.bottom = tex->AtlasY + tex->Height;
 
-    // 0x600094f0
-    void SelectRendererDeviceType(const u32 type)
-    {
-        RendererDeviceType = type;
+        tex->Texture->Blt(NULL, texture, &rect, DDBLT_WAIT, NULL);
+
+        texture->Release();
+
+        ReleaseRendererTextureAtlas(tex);
+
+        tex->IsShareable = TRUE;
+        tex->IsEvictable = TRUE;
+
+        State.Textures.Size = State.Textures.Size + tex->Size;
+
+        return TRUE;
     }
 
-    // 0x6000b2c0
-    u32 SelectBasicRendererState(const u32 state, void* value)
+    // Copies the pixels of the system memory surface of the texture into its device texture.
+    // The pixels of the packed textures are copied into their rectangles within the atlas,
+    // and the edges of the rectangles are repeated into the borders, so the filtering never samples the neighbouring textures.
+    BOOL UploadRendererTexture(RendererTexture* tex, RECT* destination, RECT* source)
     {
-        switch (state)
-        {
-        case RENDERER_MODULE_STATE_SELECT_CULL_STATE:
-        {
-            switch ((u32)value)
-            {
-            case RENDERER_MODULE_CULL_NONE:
-            {
-                State.Settings.Cull = RENDERER_CULL_MODE_NONE;
+        if (tex->Atlas == NULL) { return tex->Texture->Blt(destination, tex->Surface, source, DDBLT_WAIT, NULL) == DD_OK; }
 
-                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_NONE);
+        const LONG left = tex->AtlasX;
+        const LONG right = tex->AtlasX + tex->Width;
+        const LONG top = tex->AtlasY;
+        const LONG bottom = tex->AtlasY + tex->Height;
 
-                return RENDERER_MODULE_SUCCESS;
-            }
-            case RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE:
-            {
-                State.Settings.Cull = RENDERER_CULL_MODE_COUNTER_CLOCK_WISE;
+        RECT rect;
 
-                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE);
+        rect.left = destination == NULL ? left : (left + destination->left);
+        rect.right = destination == NULL ? right : (left + destination->right);
+        rect.top = destination == NULL ? top : (top + destination->top);
+        rect.bottom = destination == NULL ? bottom : (top + destination->bottom);
 
-                return RENDERER_MODULE_FAILURE;
-            }
-            case RENDERER_MODULE_CULL_CLOCK_WISE:
-            {
-                State.Settings.Cull = RENDERER_CULL_MODE_CLOCK_WISE;
+        if (tex->Texture->Blt(&rect, tex->Surface, source, DDBLT_WAIT, NULL) != DD_OK) { return FALSE; }
 
-                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_CLOCK_WISE);
+        // NOTE: The destination and the source columns, and rows, of the borders before, alongside, and after the texture.
+        const LONG columns[3][4] =
+        {
+            { left - TEXTURE_ATLAS_BORDER_SIZE, left, left, left + TEXTURE_ATLAS_BORDER_SIZE },
+            { left, right, left, right },
+            { right, right + TEXTURE_ATLAS_BORDER_SIZE, right - TEXTURE_ATLAS_BORDER_SIZE, right }
+        };
 
-                return RENDERER_MODULE_FAILURE;
-            }
-            default: { return RENDERER_MODULE_FAILURE; }
-            }
+        const LONG rows[3][4] =
+        {
+            { top - TEXTURE_ATLAS_BORDER_SIZE, top, top, top + TEXTURE_ATLAS_BORDER_SIZE },
+            { top, bottom, top, bottom },
+            { bottom, bottom + TEXTURE_ATLAS_BORDER_SIZE, bottom - TEXTURE_ATLAS_BORDER_SIZE, bottom }
+        };
 
-            break;
-        }
-        case RENDERER_MODULE_STATE_SELECT_WINDOW_MODE_STATE:
-        case RENDERER_MODULE_STATE_SELECT_EXECUTE_LAMBDA:
-        case RENDERER_MODULE_STATE_SELECT_LOCK_WINDOW_LAMBDA:
-        case RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE:
-        case RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX:
-        case RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE:
-        case RENDERER_MODULE_STATE_SELECT_LOG_STATE: { break; }
-        case RENDERER_MODULE_STATE_SELECT_LAMBDAS:
+        for (u32 y = 0; y < 3; y++)
         {
-            const RendererModuleLambdaContainer* lambdas = (RendererModuleLambdaContainer*)value;
+            for (u32 x = 0; x < 3; x++)
+            {
+                if (x == 1 && y == 1) { continue; }
 
-            State.Lambdas.Log = lambdas == NULL ? NULL : lambdas->Log;
+                RECT to;
 
-            break;
-        }
-        case RENDERER_MODULE_STATE_SELECT_WINDOW: { State.Window.Parent.HWND = (HWND)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_LOG_LAMBDA: { State.Lambdas.Log = (RENDERERMODULELOGLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_LINE_VERTEX_SIZE: { RendererLineVertexSize = (u32)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_VERSION:
-        {
-            const u32 version = (u32)value;
+                to.left = columns[x][0];
+                to.right = columns[x][1];
+                to.top = rows[y][0];
+                to.bottom = rows[y][1];
 
-            RendererVersion = version;
+                RECT from;
 
-            if (version < RENDERER_MODULE_VERSION_104 || version < RENDERER_MODULE_VERSION_107)
-            {
-                RendererVersion = RENDERER_MODULE_VERSION_107;
-            }
+                from.left = columns[x][2];
+                from.right = columns[x][3];
+                from.top = rows[y][2];
+                from.bottom = rows[y][3];
 
-            break;
-        }
-        case RENDERER_MODULE_STATE_SELECT_MEMORY_ALLOCATE_LAMBDA: { State.Lambdas.AllocateMemory = (RENDERERMODULEALLOCATEMEMORYLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_MEMORY_RELEASE_LAMBDA: { State.Lambdas.ReleaseMemory = (RENDERERMODULERELEASEMEMORYLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_SELECT_STATE_LAMBDA: { State.Lambdas.SelectState = (RENDERERMODULESELECTSTATELAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_55: { DAT_60058df4 = (u32)value; break; }
-        case RENDERER_MODULE_STATE_62: { DAT_60058df8 = (u32)value; break; }
-        case RENDERER_MODULE_STATE_INDEX_SIZE:
-        {
-            switch ((u32)value)
-            {
-            case RENDERER_MODULE_INDEX_SIZE_1: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_1; break; }
-            case RENDERER_MODULE_INDEX_SIZE_2: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_2; break; }
-            case RENDERER_MODULE_INDEX_SIZE_4: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_4; break; }
-            case RENDERER_MODULE_INDEX_SIZE_8: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_8; break; }
-            default: { return RENDERER_MODULE_FAILURE; }
+                if (tex->Texture->Blt(&to, tex->Texture, &from, DDBLT_WAIT, NULL) != DD_OK) { return FALSE; }
             }
-
-            break;
         }
-        default: { return RENDERER_MODULE_FAILURE; }
+
+        return TRUE;
+    }
+
+    // Selects the transform of the texture coordinates of the packed texture selected into the first stage, or NULL.
+    // The vertexes already in the batch are processed with the transform of the previous texture first.
+    void SelectRendererTextureAtlas(RendererTexture* tex)
+    {
+        UpdateRendererVertexes();
+
+        State.Textures.Atlases.Current = tex;
+
+        if (tex != NULL)
+        {
+            State.Textures.Atlases.Offset.X = (f32)tex->AtlasX / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
+            State.Textures.Atlases.Offset.Y = (f32)tex->AtlasY / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
+            State.Textures.Atlases.Scale.X = (f32)tex->Width / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
+            State.Textures.Atlases.Scale.Y = (f32)tex->Height / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
         }
 
-        SelectRendererStateValue(state, value);
+        SelectRendererVertexTransforms();
+    }
 
-        return RENDERER_MODULE_SUCCESS;
+    // Checks whether the first stage clamps the texture coordinates, the packed textures are only sampled with the clamping.
+    BOOL IsRendererTextureAtlasClamped(void)
+    {
+        return State.Textures.Atlases.AddressU == D3DTADDRESS_CLAMP && State.Textures.Atlases.AddressV == D3DTADDRESS_CLAMP;
     }
 
-    // 0x60001e70
-    void SelectRendererStateValue(const u32 state, void* value)
+    // Removes the texture from its atlas, the atlas is packed again from the start once its last texture is removed.
+    // NOTE: The reference of the texture to the device texture of the atlas is released by the caller.
+    void ReleaseRendererTextureAtlas(RendererTexture* tex)
     {
-        const u32 actual = state & RENDERER_MODULE_SELECT_STATE_MASK;
-        const u32 stage = MAKETEXTURESTAGEVALUE(state);
+        if (State.Textures.Atlases.Current == tex) { SelectRendererTextureAtlas(NULL); }
 
-        const s32 indx = AcquireTextureStateStageIndex(actual);
+        RendererTextureAtlas* atlas = tex->Atlas;
+
+        if (atlas == NULL) { return; }
+
+        tex->Atlas = NULL;
 
-        if (indx >= 0) { State.Textures.StageStates[indx].Values[stage] = (s32)value; }
+        atlas->Count = atlas->Count - 1;
 
-        if (State.Lambdas.SelectState != NULL) { State.Lambdas.SelectState(actual, value); }
+        if (atlas->Count == 0)
+        {
+            atlas->X = 0;
+            atlas->Y = 0;
+            atlas->Height = 0;
+        }
     }
 
-    // 0x60001e20
-    s32 AcquireTextureStateStageIndex(const u32 state)
+    // Releases the device textures of the atlases, along with the textures packed into them.
+    void ReleaseRendererTextureAtlases(void)
     {
-        s32 sum = 0;
-        u32 indx = 0;
+        State.Textures.Atlases.Current = NULL;
 
-        while (state < RendererModuleValues::MinMax[indx].Min || RendererModuleValues::MinMax[indx].Max < state)
+        for (u32 x = 0; x < MAX_TEXTURE_ATLAS_COUNT; x++)
         {
-            sum = sum + (RendererModuleValues::MinMax[indx].Max - RendererModuleValues::MinMax[indx].Min);
+            RendererTextureAtlas* atlas = &State.Textures.Atlases.Atlases[x];
 
-            indx = indx + 1;
+            if (atlas->Texture != NULL)
+            {
+                atlas->Texture->Release();
 
-            if (5 < indx) { return -1; } // TODO
-        }
+                State.Textures.Size = State.Textures.Size - atlas->Size;
+            }
 
-        return (sum - RendererModuleValues::MinMax[indx].Min) + state;
+            ZeroMemory(atlas, sizeof(RendererTextureAtlas));
+        }
     }
 
-    // 0x60001f20
-    void InitializeTextureStateStates(void)
+    // Acquires the block compressed format, that the pixels of the format are compressed into on upload.
+    // NOTE: The compression is limited to the textures of the whole blocks, and to the formats the device supports natively.
+    // The formats with more than a single bit of alpha are compressed into DXT3, since the device formats stop at DXT3.
+    u32 AcquireRendererTextureCompressionFormat(const u32 width, const u32 height, const u32 format)
     {
-        ZeroMemory(State.Textures.StageStates, MAX_TEXTURE_STATE_STATE_COUNT * sizeof(TextureStageState));
-    }
+        if (!SettingsState.TextureCompression) { return DXT_FORMAT_NONE; }
 
-    // 0x6000b590
-    void InitializeRendererModuleState(const u32 mode, const u32 pending, const u32 depth, const char* section)
-    {
-        SelectState(RENDERER_MODULE_STATE_SELECT_HINT_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_HINT_INACTIVE, section, "HINT"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
-        SelectState(RENDERER_MODULE_STATE_SELECT_CULL_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE, section, "CULL"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_FILTER_LENEAR, section, "FILTER"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_SHADE_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_SHADE_GOURAUD, section, "SHADE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_BLEND_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_ACTIVE, section, "TRANSPARENCY"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_TEST_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_TEST_16, section, "ALPHATEST"));
-        SelectState(RENDERER_MODULE_STATE_SELCT_ALPHA_FUNCTION,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_FUNCTION_GREATER, section, "ALPHACMP"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_MIP_FILTER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_MIP_FILTER_POINT, section, "MIPMAP"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_MATERIAL,
-            (void*)AcquireSettingsValue(0x00000000, section, "BACKGROUNDCOLOUR"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_CHROMATIC_COLOR,
-            (void*)AcquireSettingsValue(0x00000000, section, "CHROMACOLOUR"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_DITHER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_DITHER_INACTIVE, section, "DITHER")); // ORIGINAL: ACTIVE
-        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS, NULL);
-        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_FOG_INACTIVE, section, "FOGMODE"));
+        if (MAX_TEXTURE_COMPRESSION_ROW_PIXEL_COUNT < width
+            || (width % RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION) != 0
+            || (height % RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION) != 0) { return DXT_FORMAT_NONE; }
 
+        switch (format)
         {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_DENSITY,
-                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGDENSITY"));
-        }
-
+        case RENDERER_PIXEL_FORMAT_R5G5B5:
+        case RENDERER_PIXEL_FORMAT_R5G6B5:
         {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_START,
-                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "STATE_FOGZNEAR"));
-        }
+            if (State.Textures.Formats.Indexes[RENDERER_PIXEL_FORMAT_DXT1] != INVALID_TEXTURE_FORMAT_INDEX) { return DXT_FORMAT_DXT1; }
 
+            break;
+        }
+        case RENDERER_PIXEL_FORMAT_A8R8G8B8:
+        case RENDERER_PIXEL_FORMAT_R4G4B4:
         {
-            const f32 value = 1.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_END,
-                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGZFAR"));
+            if (State.Textures.Formats.Indexes[RENDERER_PIXEL_FORMAT_DXT3] != INVALID_TEXTURE_FORMAT_INDEX) { return DXT_FORMAT_DXT3; }
+
+            break;
+        }
         }
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_COLOR,
-            (void*)AcquireSettingsValue(GRAPCHICS_COLOR_WHITE, section, "FOGCOLOUR"));
+        return DXT_FORMAT_NONE;
+    }
 
-        SelectState(RENDERER_MODULE_STATE_INDEX_SIZE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_INDEX_SIZE_4, section, "INDEXSIZE"));
+    // Starts the worker threads of the texture compression, unless they are already running.
+    BOOL InitializeRendererTextureCompression(void)
+    {
+        if (State.Compression.IsActive) { return TRUE; }
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_BLEND_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_SOURCE_INVERSE_SOURCE, section, "ALPHA"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_ADDRESS_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_ADDRESS_CLAMP, section, "TEXTURECLAMP"));
+        SYSTEM_INFO info;
+        ZeroMemory(&info, sizeof(SYSTEM_INFO));
 
-        {
-            const f32 value = 1.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_GAMMA_CONTROL_STATE, (void*)(u32)(*(u32*)&value));
-        }
+        GetSystemInfo(&info);
 
-        {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_BIAS_STATE,
-                (void*)AcquireSettingsValue((u32)(*(u32*)&value), section, "DEPTHBIAS"));
-        }
+        // NOTE: One of the processors is left to the application.
+        const u32 count = Clamp((u32)info.dwNumberOfProcessors - 1, (u32)1, (u32)MAX_TEXTURE_COMPRESSION_THREAD_COUNT);
 
-        {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_MIP_MAP_LOD_BIAS_STATE, (void*)(u32)(*(u32*)&value));
-        }
+        State.Compression.Work = CreateSemaphoreA(NULL, 0, 0x7FFFFFFF, NULL);
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_VERTEX_TYPE, (void*)RENDERER_MODULE_VERTEX_TYPE_RTLVX);
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_NORMAL);
-        SelectState(MAKETEXTURESTAGEMASK(RENDERER_TEXTURE_STAGE_1) | RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_DISABLE);
-        SelectState(RENDERER_MODULE_STATE_MAX_PENDING_STATE,
-            (void*)AcquireSettingsValue(pending - 2U & ((s32)(pending - 2U) < 0) - 1, section, "MAXPENDING")); // TODO
-        SelectState(RENDERER_MODULE_STATE_SELECT_BACK_BUFFER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_BACK_BUFFER_ACTIVE, section, "BACKBUFFERTYPE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_FLAT_FANS_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_STATE_FLAT_FANS_ACTIVE, section, "FLATFANS"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_WIDTH, (void*)AcquireSettingsValue(1, section, "LINEWIDTH"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_STENCIL_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_STENCIL_INACTIVE, section, "STENCILBUFFER"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE, (void*)AcquireSettingsValue(mode, section, "DISPLAYMODE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_DOUBLE_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_LINE_DOUBLE_INACTIVE, section, "LINEDOUBLE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX, (void*)0); // TODO
+        if (State.Compression.Work == NULL) { return FALSE; }
+
+        InitializeCriticalSection(&State.Compression.Lock);
+
+        State.Compression.Pending = NULL;
+        State.Compression.Last = NULL;
+        State.Compression.Complete = NULL;
 
+        State.Compression.Count = 0;
+
+        for (u32 x = 0; x < count; x++)
         {
-            const f32 value = 1.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_CLEAR_DEPTH_STATE, (void*)(u32)(*(u32*)&value));
-        }
+            HANDLE thread = CreateThread(NULL, 0, CompressRendererTextureThread, NULL, 0, NULL);
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_TOGGLE_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TOGGLE_VERTICAL_SYNC, section, "FLIPRATE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE,
-            (void*)AcquireSettingsValue(0, section, "SHAMELESSPLUG")); // TODO
+            if (thread == NULL) { break; }
+
+            State.Compression.Threads[State.Compression.Count] = thread;
+            State.Compression.Count = State.Compression.Count + 1;
+        }
 
+        if (State.Compression.Count == 0)
         {
-            const u32 value = AcquireSettingsValue(((depth < 1) - 1) & 2, section, "DEPTHBUFFER");
-            const u32 result = SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)value);
+            DeleteCriticalSection(&State.Compression.Lock);
 
-            if (result == RENDERER_MODULE_FAILURE && value == RENDERER_MODULE_DEPTH_ACTIVE_W)
-            {
-                SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)RENDERER_MODULE_DEPTH_ACTIVE);
-            }
+            CloseHandle(State.Compression.Work);
+            State.Compression.Work = NULL;
+
+            LOGWARNING("Unable to start texture compression threads, compressing textures on upload.\n");
+
+            return FALSE;
         }
 
-        SelectState(RENDERER_MODULE_STATE_SELCT_DEPTH_FUNCTION,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_DEPTH_FUNCTION_LESS_EQUAL, section, "DEPTHCMP"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_LOG_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_LOG_ACTIVE, section, "LOG"));
+        State.Compression.IsActive = TRUE;
+
+        return TRUE;
     }
 
-    // 0x600088b0
-    // NOTE: Looks like the engineers made an interesting decision to extend the API in an unconventional way, such that
-    // a stage index is passed into the function, and not a valid pointer, to reset current texture.
-    BOOL SelectRendererTexture(RendererTexture* tex)
+    // Stops the worker threads of the texture compression, and discards the pixels of the pending textures.
+    void ReleaseRendererTextureCompression(void)
     {
-        if (!State.Scene.IsActive) { BeginRendererScene(); }
+        if (!State.Compression.IsActive) { return; }
 
-        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
+        EnterCriticalSection(&State.Compression.Lock);
 
-        if ((u32)tex < 16) // TODO
+        RendererTextureCompression* pending = State.Compression.Pending;
+
+        State.Compression.Pending = NULL;
+        State.Compression.Last = NULL;
+
+        LeaveCriticalSection(&State.Compression.Lock);
+
+        // NOTE: The worker threads exit once there is no pending task to compress.
+        ReleaseSemaphore(State.Compression.Work, State.Compression.Count, NULL);
+
+        for (u32 x = 0; x < State.Compression.Count; x++)
         {
-            if ((u32)tex == 0) // TODO
-            {
-                HRESULT result = DD_OK;
+            WaitForSingleObject(State.Compression.Threads[x], INFINITE);
+            CloseHandle(State.Compression.Threads[x]);
 
-                for (u32 x = 0; x < State.Device.Capabilities.MaximumSimultaneousTextures; x++)
-                {
-                    result = State.DX.Device->SetTexture(x, NULL);
-                }
+            State.Compression.Threads[x] = NULL;
+        }
 
-                return result == DD_OK;
-            }
+        CloseHandle(State.Compression.Work);
+        DeleteCriticalSection(&State.Compression.Lock);
 
-            if ((u32)tex == 1) { return State.DX.Device->SetTexture(RENDERER_TEXTURE_STAGE_0, NULL) == DD_OK; } // TODO
+        while (pending != NULL)
+        {
+            RendererTextureCompression* next = pending->Next;
 
-            if ((u32)tex == 2) { return State.DX.Device->SetTexture(RENDERER_TEXTURE_STAGE_1, NULL) == DD_OK; } // TODO
+            DisposeRendererTextureCompression(pending);
 
-            return TRUE;
+            pending = next;
         }
 
-        return State.DX.Device->SetTexture(tex->Stage, tex->Texture) == DD_OK;
-    }
+        RendererTextureCompression* complete = State.Compression.Complete;
 
-    // 0x60003570
-    u32 ReleaseRendererWindow(void)
-    {
-        if (State.DX.Instance != NULL)
+        while (complete != NULL)
         {
-            SetForegroundWindow(State.Window.HWND);
-            PostMessageA(State.Window.HWND, RENDERER_MODULE_WINDOW_MESSAGE_RELEASE_DEVICE, 0, 0);
-            WaitForSingleObject(State.Mutex, INFINITE);
-            CloseHandle(State.Mutex);
+            RendererTextureCompression* next = complete->Next;
 
-            State.Mutex = NULL;
-            State.Window.HWND = NULL;
+            DisposeRendererTextureCompression(complete);
 
-            return State.DX.Code;
+            complete = next;
         }
 
-        return RENDERER_MODULE_FAILURE;
+        State.Compression.Complete = NULL;
+
+        State.Compression.Work = NULL;
+        State.Compression.Count = 0;
+
+        State.Compression.IsActive = FALSE;
     }
 
-    // 0x600035e0
-    u32 ReleaseRendererDeviceInstance(void)
+    // Compresses the pending textures, until there are none left.
+    DWORD WINAPI CompressRendererTextureThread(LPVOID)
     {
-        ReleaseRendererDeviceSurfaces();
-
-        if (State.DX.Instance != NULL)
+        while (TRUE)
         {
-            State.DX.Instance->Release();
-            State.DX.Instance = NULL;
+            WaitForSingleObject(State.Compression.Work, INFINITE);
+
+            EnterCriticalSection(&State.Compression.Lock);
+
+            RendererTextureCompression* task = State.Compression.Pending;
+
+            if (task != NULL)
+            {
+                State.Compression.Pending = task->Next;
+
+                if (State.Compression.Pending == NULL) { State.Compression.Last = NULL; }
+            }
+
+            LeaveCriticalSection(&State.Compression.Lock);
+
+            if (task == NULL) { break; }
+
+            CompressRendererTexture(task);
+
+            EnterCriticalSection(&State.Compression.Lock);
+
+            task->Next = State.Compression.Complete;
+            State.Compression.Complete = task;
+
+            LeaveCriticalSection(&State.Compression.Lock);
         }
 
-        return RENDERER_MODULE_SUCCESS;
+        return 0;
     }
 
-    // 0x60009080
-    RendererTexture* AllocateRendererTexture(const u32 width, const u32 height, const u32 format, const BOOL palette, const u32 state, const BOOL destination)
+    // Compresses the pixels of all of the levels of the texture into the blocks.
+    void CompressRendererTexture(RendererTextureCompression* task)
     {
-        if (State.DX.Active.Instance == NULL) { return NULL; }
-        if (State.Textures.Illegal) { return NULL; }
+        const u32 size = AcquireRendererTextureCompressionPixelSize(task->Source);
+        const u32 block = task->Destination == DXT_FORMAT_DXT1 ? 8 : 16;
 
-        RendererTexture* tex = InitializeRendererTexture();
+        u32 rows[RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION * MAX_TEXTURE_COMPRESSION_ROW_PIXEL_COUNT];
 
-        tex->Width = width;
-        tex->Height = height;
-        tex->FormatIndex = State.Textures.Formats.Indexes[format];
-        tex->UnknownFormatIndexValue = UnknownFormatValues[format];
-        tex->Stage = MAKETEXTURESTAGEVALUE(state);
-        tex->FormatIndexValue = MAKETEXTUREINDEXVALUE(format);
+        u8* pixels = task->Pixels;
+        u8* blocks = task->Blocks;
 
-        tex->MipMapCount = MAKETEXTUREMIPMAPVALUE(state) != 0 ? (MAKETEXTUREMIPMAPVALUE(state) + 1) : 0;
+        for (u32 x = 0; x < task->Levels; x++)
+        {
+            const u32 width = Max(task->Width >> x, (u32)1);
+            const u32 height = Max(task->Height >> x, (u32)1);
 
-        tex->Is16Bit = (format == RENDERER_PIXEL_FORMAT_R5G5B5 || format == RENDERER_PIXEL_FORMAT_R4G4B4);
+            const u32 count = (width + RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION - 1) / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
+            const u32 length = count * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
 
-        tex->IsPalette = palette;
-        tex->MemoryType = RENDERER_MODULE_TEXTURE_LOCATION_SYSTEM_MEMORY;
+            for (u32 y = 0; y < height; y += RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION)
+            {
+                for (u32 yy = 0; yy < RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION; yy++)
+                {
+                    // NOTE: The rows and the columns past the edge of the level repeat the last ones,
+                    // so that they do not skew the end points of the blocks of the smallest levels.
+                    const u32 line = Min(y + yy, height - 1);
 
-        tex->Surface = NULL;
-        tex->Texture = NULL;
-        tex->Palette = NULL;
+                    const u8* input = (u8*)((addr)pixels + (addr)(line * width * size));
 
-        tex->Colors = 0;
+                    u32* row = &rows[yy * length];
 
-        const s32 result = InitializeRendererTextureDetails(tex, destination);
+                    for (u32 xx = 0; xx < width; xx++)
+                    {
+                        switch (task->Source)
+                        {
+                        case RENDERER_PIXEL_FORMAT_R5G5B5:
+                        {
+                            const u32 value = ((u16*)input)[xx];
 
-        if (result != RENDERER_INITIALIZE_TEXTURE_DETAILS_OK)
-        {
-            ReleaseRendererTexture(tex);
+                            const u32 a = (task->IsOpaque || (value & 0x8000)) ? 0xFF : 0x00;
+                            const u32 r = (((value >> 10) & 0x1F) << 3) | (((value >> 10) & 0x1F) >> 2);
+                            const u32 g = (((value >> 5) & 0x1F) << 3) | (((value >> 5) & 0x1F) >> 2);
+                            const u32 b = ((value & 0x1F) << 3) | ((value & 0x1F) >> 2);
 
-            if (result != RENDERER_INITIALIZE_TEXTURE_DETAILS_INVALID) { State.Textures.Illegal = TRUE; }
+                            row[xx] = (a << 24) | (r << 16) | (g << 8) | b;
 
-            return NULL;
-        }
+                            break;
+                        }
+                        case RENDERER_PIXEL_FORMAT_R5G6B5:
+                        {
+                            const u32 value = ((u16*)input)[xx];
 
-        tex->Previous = State.Textures.Current;
-        State.Textures.Current = tex;
+                            const u32 r = (((value >> 11) & 0x1F) << 3) | (((value >> 11) & 0x1F) >> 2);
+                            const u32 g = (((value >> 5) & 0x3F) << 2) | (((value >> 5) & 0x3F) >> 4);
+                            const u32 b = ((value & 0x1F) << 3) | ((value & 0x1F) >> 2);
 
-        State.Textures.Count = State.Textures.Count + 1;
+                            row[xx] = 0xFF000000 | (r << 16) | (g << 8) | b;
 
-        return tex;
-    }
+                            break;
+                        }
+                        case RENDERER_PIXEL_FORMAT_R4G4B4:
+                        {
+                            const u32 value = ((u16*)input)[xx];
 
-    // 0x60009210
-    RendererTexture* InitializeRendererTexture(void)
-    {
-        RendererTexture* result = (RendererTexture*)AllocateRendererTexture(sizeof(RendererTexture));
+                            row[xx] = (((value >> 12) & 0xF) * 0x11 << 24) | (((value >> 8) & 0xF) * 0x11 << 16)
+                                | (((value >> 4) & 0xF) * 0x11 << 8) | ((value & 0xF) * 0x11);
 
-        if (result == NULL) { LOGERROR("D3D texture allocation ran out of memory\n"); }
+                            break;
+                        }
+                        default: { row[xx] = ((u32*)input)[xx]; break; }
+                        }
+                    }
 
-        return result;
-    }
+                    for (u32 xx = width; xx < length; xx++) { row[xx] = row[width - 1]; }
+                }
 
-    // 0x6000b270
-    RendererTexture* AllocateRendererTexture(const u32 size)
-    {
-        if (State.Lambdas.AllocateMemory != NULL) { return (RendererTexture*)State.Lambdas.AllocateMemory(size); }
+                EncodeRendererTextureBlocks(task->Destination, rows, count, blocks);
 
-        return (RendererTexture*)malloc(size);
-    }
+                blocks = (u8*)((addr)blocks + (addr)(count * block));
+            }
 
-    // 0x6000c790
-    s32 InitializeRendererTextureDetails(RendererTexture* tex, const BOOL destination)
-    {
-        if (tex->Texture != NULL)
-        {
-            tex->Texture->Release();
-            tex->Texture = NULL;
+            pixels = (u8*)((addr)pixels + (addr)(width * height * size));
         }
+    }
 
-        DDSURFACEDESC2 desc;
-        CopyMemory(&desc, &State.Textures.Formats.Formats[tex->FormatIndex].Descriptor, sizeof(DDSURFACEDESC2));
+    // Encodes the four rows of the pixels into the row of the blocks.
+    void EncodeRendererTextureBlocks(const u32 format, const u32* pixels, const u32 count, u8* blocks)
+    {
+        const u32 size = format == DXT_FORMAT_DXT1 ? 8 : 16;
+        const u32 length = count * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
 
-        desc.dwSize = sizeof(DDSURFACEDESC2);
+        u32 values[RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT];
 
-        // Attempt to create texture in RAM.
+        for (u32 x = 0; x < count; x++)
         {
-            if (tex->MipMapCount == 0)
+            for (u32 xx = 0; xx < RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION; xx++)
             {
-                desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
-                desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY;
+                CopyMemory(&values[xx * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION],
+                    &pixels[xx * length + x * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION], RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION * sizeof(u32));
             }
+
+            u8* block = (u8*)((addr)blocks + (addr)(x * size));
+
+            if (format == DXT_FORMAT_DXT1) { EncodeRendererTextureColors(values, block, TRUE); }
             else
             {
-                desc.dwFlags = DDSD_MIPMAPCOUNT | DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
-                desc.ddsCaps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE | DDSCAPS_SYSTEMMEMORY | DDSCAPS_COMPLEX;
-                desc.dwMipMapCount = tex->MipMapCount;
+                EncodeRendererTextureAlphas(values, block);
+                EncodeRendererTextureColors(values, (u8*)((addr)block + (addr)8), FALSE);
             }
+        }
+    }
 
-            if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
-            else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
+    // Queues the copy of the pixels of all of the levels of the texture for the compression on the worker threads.
+    // NOTE: The compressed pixels are uploaded between the frames, or once the texture is selected, whichever comes first.
+    BOOL SubmitRendererTextureCompression(RendererTexture* tex, const u32* pixels)
+    {
+        const u32 format = State.Textures.Formats.Formats[tex->FormatIndex].DXTF;
 
-            desc.dwHeight = tex->Height;
-            desc.dwWidth = tex->Width;
+        const u32 pixel = AcquireRendererTextureCompressionPixelSize(tex->FormatIndexValue);
+        const u32 block = format == DXT_FORMAT_DXT1 ? 8 : 16;
 
-            if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+        // NOTE: The pixels hold at least the top level of the texture.
+        const u32 levels = Max((u32)tex->MipMapCount, (u32)1);
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_FOURCC;
+        u32 size = 0;
+        u32 length = 0;
 
-                if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1)
-                {
-                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT1;
-                }
-                else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                {
-                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT3;
-                }
-            }
-            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_1)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+        for (u32 x = 0; x < levels; x++)
+        {
+            const u32 width = Max(tex->Width >> x, (u32)1);
+            const u32 height = Max(tex->Height >> x, (u32)1);
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
-                desc.ddpfPixelFormat.dwRBitMask = 0xff;
-                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
-                desc.ddpfPixelFormat.dwBBitMask = 0x00;
-            }
-            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_2)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+            size = size + width * height * pixel;
+            length = length + ((width + RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION - 1) / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION)
+                * ((height + RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION - 1) / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION) * block;
+        }
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_24;
-                desc.ddpfPixelFormat.dwRBitMask = 0xff;
-                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
-                desc.ddpfPixelFormat.dwBBitMask = 0xff0000;
-            }
-            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_3)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+        RendererTextureCompression* task =
+            (RendererTextureCompression*)malloc(sizeof(RendererTextureCompression) + size + length);
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
-                desc.ddpfPixelFormat.dwRBitMask = 0x1f;
-                desc.ddpfPixelFormat.dwGBitMask = 0x3e0;
-                desc.ddpfPixelFormat.dwBBitMask = 0xfc00;
-            }
+        if (task == NULL) { return FALSE; }
 
-            IDirectDrawSurface7* surface = NULL;
+        task->Texture = tex;
 
-            {
-                const HRESULT result = State.DX.Active.Instance->CreateSurface(&desc, &surface, NULL);
+        task->Width = tex->Width;
+        task->Height = tex->Height;
+        task->Levels = levels;
 
-                if (result != DD_OK) { return (result != DDERR_INVALIDPIXELFORMAT) - 1; }
-            }
+        task->Source = tex->FormatIndexValue;
+        task->Destination = format;
 
-            tex->Surface = surface;
+        task->IsOpaque = State.Textures.Formats.Indexes[RENDERER_PIXEL_FORMAT_R5G5B5] == INVALID_TEXTURE_FORMAT_INDEX
+            || State.Textures.Formats.Formats[State.Textures.Formats.Indexes[RENDERER_PIXEL_FORMAT_R5G5B5]].AlphaBitCount == 0;
 
-            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+        task->Pixels = (u8*)((addr)task + (addr)sizeof(RendererTextureCompression));
+        task->Blocks = (u8*)((addr)task->Pixels + (addr)size);
 
-            desc.dwSize = sizeof(DDSURFACEDESC2);
+        task->Next = NULL;
 
-            if (surface->GetSurfaceDesc(&desc) != DD_OK)
-            {
-                surface->Release();
+        CopyMemory(task->Pixels, pixels, size);
 
-                return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-            }
-        }
+        CancelRendererTextureCompression(tex);
 
-        CopyMemory(&tex->Descriptor, &desc, sizeof(DDSURFACEDESC2));
+        tex->Compression = task;
 
-        // Attempt to create texture in Video Memory or RAM, depending on the device capabilities.
+        if (!InitializeRendererTextureCompression())
         {
-            if (tex->MipMapCount == 0)
-            {
-                desc.dwFlags = DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
-                desc.ddsCaps.dwCaps = DDSCAPS_TEXTURE;
-            }
-            else
-            {
-                desc.dwFlags = DDSD_MIPMAPCOUNT | DDSD_PIXELFORMAT | DDSD_WIDTH | DDSD_HEIGHT | DDSD_CAPS;
-                desc.ddsCaps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE | DDSCAPS_COMPLEX;
-                desc.dwMipMapCount = tex->MipMapCount;
-            }
+            CompressRendererTexture(task);
 
-            if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_DYNAMIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTDYNAMIC; }
-            else if (RendererTextureHint == RENDERER_MODULE_TEXTURE_HINT_STATIC) { desc.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC; }
+            const BOOL result = UploadRendererTextureCompression(task);
 
-            if (destination) { desc.ddsCaps.dwCaps = desc.ddsCaps.dwCaps | DDSCAPS_3DDEVICE; }
+            DisposeRendererTextureCompression(task);
 
-            if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+            return result;
+        }
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_FOURCC;
+        EnterCriticalSection(&State.Compression.Lock);
 
-                if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1)
-                {
-                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT1;
-                }
-                else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                {
-                    desc.ddpfPixelFormat.dwFourCC = FOURCC_DXT3;
-                }
-            }
-            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_1)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+        if (State.Compression.Last == NULL) { State.Compression.Pending = task; }
+        else { State.Compression.Last->Next = task; }
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
-                desc.ddpfPixelFormat.dwRBitMask = 0xff;
-                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
-                desc.ddpfPixelFormat.dwBBitMask = 0x00;
-            }
-            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_2)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+        State.Compression.Last = task;
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_24;
-                desc.ddpfPixelFormat.dwRBitMask = 0xff;
-                desc.ddpfPixelFormat.dwGBitMask = 0xff00;
-                desc.ddpfPixelFormat.dwBBitMask = 0xff0000;
-            }
-            else if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_BUMPDUDV_3)
-            {
-                ZeroMemory(&desc.ddpfPixelFormat, sizeof(DDPIXELFORMAT));
+        LeaveCriticalSection(&State.Compression.Lock);
 
-                desc.ddpfPixelFormat.dwSize = sizeof(DDPIXELFORMAT);
-                desc.ddpfPixelFormat.dwFlags = DDPF_BUMPDUDV;
-                desc.ddpfPixelFormat.dwRGBBitCount = GRAPHICS_BITS_PER_PIXEL_16;
-                desc.ddpfPixelFormat.dwRBitMask = 0x1f;
-                desc.ddpfPixelFormat.dwGBitMask = 0x3e0;
-                desc.ddpfPixelFormat.dwBBitMask = 0xfc00;
-            }
+        ReleaseSemaphore(State.Compression.Work, 1, NULL);
 
-            desc.ddsCaps.dwCaps = State.Device.Capabilities.IsAccelerated
-                ? desc.ddsCaps.dwCaps | DDSCAPS_VIDEOMEMORY
-                : desc.ddsCaps.dwCaps | DDSCAPS_SYSTEMMEMORY;
+        return TRUE;
+    }
 
-            IDirectDrawSurface7* surface = NULL;
+    // Detaches the pending compression from the texture, its blocks are discarded once the compression completes.
+    void CancelRendererTextureCompression(RendererTexture* tex)
+    {
+        if (tex->Compression == NULL) { return; }
 
-            {
-                const HRESULT result = State.DX.Active.Instance->CreateSurface(&desc, &surface, NULL);
+        tex->Compression->Texture = NULL;
+        tex->Compression = NULL;
+    }
 
-                if (result != DD_OK)
-                {
-                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+    // Uploads the blocks of the textures, which compression is complete.
+    void CommitRendererTextureCompressions(void)
+    {
+        if (!State.Compression.IsActive) { return; }
 
-                    return (result != DDERR_INVALIDPIXELFORMAT) - 1;
-                }
-            }
+        EnterCriticalSection(&State.Compression.Lock);
 
-            IDirectDrawPalette* palette = NULL;
+        RendererTextureCompression* task = State.Compression.Complete;
 
-            if (desc.ddpfPixelFormat.dwFlags & DDPF_PALETTEINDEXED8)
+        State.Compression.Complete = NULL;
+
+        LeaveCriticalSection(&State.Compression.Lock);
+
+        if (task == NULL) { return; }
+
+        // NOTE: The recorded commands are rendered before the textures change.
+        RenderRendererCommands();
+
+        while (task != NULL)
+        {
+            RendererTextureCompression* next = task->Next;
+
+            if (task->Texture != NULL)
             {
-                tex->Colors = 256;
+                if (!UploadRendererTextureCompression(task)) { LOGWARNING("Unable to upload compressed texture.\n"); }
+            }
 
-                PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+            DisposeRendererTextureCompression(task);
 
-                for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
-                {
-                    entries[x].peRed = 0;
-                    entries[x].peGreen = 0xff;
-                    entries[x].peBlue = 0;
-                    entries[x].peFlags = 0;
-                }
+            task = next;
+        }
+    }
 
-                if (State.DX.Active.Instance->CreatePalette(DDPCAPS_ALLOW256 | DDPCAPS_8BIT, entries, &palette, NULL) != DD_OK)
-                {
-                    if (surface != NULL) { surface->Release(); }
+    // Waits for the pending compression of the texture to complete, and uploads its blocks.
+    void WaitRendererTextureCompression(RendererTexture* tex)
+    {
+        while (tex->Compression != NULL)
+        {
+            CommitRendererTextureCompressions();
 
-                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+            if (tex->Compression != NULL) { Sleep(0); }
+        }
+    }
 
-                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-                }
+    // Copies the blocks of all of the levels of the texture into the texture.
+    BOOL UploadRendererTextureCompression(RendererTextureCompression* task)
+    {
+        RendererTexture* tex = task->Texture;
 
-                if (surface->SetPalette(palette) != DD_OK)
-                {
-                    if (surface != NULL) { surface->Release(); }
+        const u32 size = task->Destination == DXT_FORMAT_DXT1 ? 8 : 16;
 
-                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+        if (State.Scene.IsActive)
+        {
+            AttemptRenderScene();
+            EndRendererScene();
+        }
 
-                    if (palette != NULL) { palette->Release(); }
+        IDirectDrawSurface7* s1 = tex->Surface;
+        IDirectDrawSurface7* s2 = tex->Texture;
 
-                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-                }
+        s1->AddRef();
+        s2->AddRef();
 
-                tex->Palette = palette;
-            }
-            else if (desc.ddpfPixelFormat.dwFlags & DDPF_PALETTEINDEXED4)
+        BOOL result = TRUE;
+
+        u8* blocks = task->Blocks;
+
+        for (u32 x = 0; x < task->Levels; x++)
+        {
+            if (x != 0)
             {
-                tex->Colors = 16;
+                DDSCAPS2 caps;
+                ZeroMemory(&caps, sizeof(DDSCAPS2));
 
-                PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+                caps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE;
 
-                for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
-                {
-                    entries[x].peRed = 0;
-                    entries[x].peGreen = 0xff;
-                    entries[x].peBlue = 0;
-                    entries[x].peFlags = 0;
-                }
+                IDirectDrawSurface7* attached = NULL;
 
-                if (State.DX.Active.Instance->CreatePalette(DDPCAPS_4BIT, entries, &palette, NULL) != DD_OK)
-                {
-                    if (surface != NULL) { surface->Release(); }
+                if (s1->GetAttachedSurface(&caps, &attached) != DD_OK) { result = FALSE; break; }
 
-                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+                s1->Release();
+                s1 = attached;
 
-                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-                }
+                attached = NULL;
 
-                if (surface->SetPalette(palette) != DD_OK)
-                {
-                    if (surface != NULL) { surface->Release(); }
+                if (s2->GetAttachedSurface(&caps, &attached) != DD_OK) { result = FALSE; break; }
 
-                    if (tex->Surface != NULL) { tex->Surface->Release(); }
+                s2->Release();
+                s2 = attached;
+            }
 
-                    if (palette != NULL) { palette->Release(); }
+            DDSURFACEDESC2 desc;
+            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
 
-                    return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-                }
+            desc.dwSize = sizeof(DDSURFACEDESC2);
 
-                tex->Palette = palette;
-            }
-            else
-            {
-                tex->Colors = 0;
-                tex->Palette = NULL;
-            }
+            if (s1->GetSurfaceDesc(&desc) != DD_OK) { result = FALSE; break; }
 
-            if (surface->Blt(NULL, tex->Surface, NULL, DDBLT_WAIT, NULL) != DD_OK)
-            {
-                if (surface != NULL) { surface->Release(); }
+            desc.dwFlags = DDSD_LPSURFACE;
+            desc.lpSurface = blocks;
 
-                if (tex->Surface != NULL) { tex->Surface->Release(); }
+            if (s1->SetSurfaceDesc(&desc, 0) != DD_OK) { result = FALSE; break; }
+            if (s2->Blt(NULL, s1, NULL, DDBLT_WAIT, NULL) != DD_OK) { result = FALSE; break; }
 
-                if (palette != NULL) { palette->Release(); }
+            const u32 count = (Max(task->Width >> x, (u32)1) + RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION - 1) / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
+            const u32 rows = (Max(task->Height >> x, (u32)1) + RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION - 1) / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
 
-                return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-            }
+            blocks = (u8*)((addr)blocks + (addr)(rows * count * size));
+        }
+
+        s1->Release();
+        s2->Release();
+
+        return result;
+    }
+
+    // Releases the task of the texture compression, and detaches it from its texture.
+    void DisposeRendererTextureCompression(RendererTextureCompression* task)
+    {
+        if (task->Texture != NULL) { task->Texture->Compression = NULL; }
+
+        free(task);
+    }
 
-            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+    // Clips the convex polygon against a single edge of the clip rectangle.
+    template <typename V> u32 ClipRendererPolygonEdge(V* input, const u32 count, V* output, const u32 edge)
+    {
+        u32 result = 0;
 
-            desc.dwSize = sizeof(DDSURFACEDESC2);
+        for (u32 x = 0; x < count; x++)
+        {
+            V* a = &input[x];
+            V* b = &input[(x + 1) % count];
 
-            if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3) { desc.dwFlags = DDSD_LINEARSIZE; }
+            const f32 da = AcquireRendererClipDistance(&a->XYZ, edge);
+            const f32 db = AcquireRendererClipDistance(&b->XYZ, edge);
 
-            if (surface->GetSurfaceDesc(&desc) != DD_OK)
+            if (0.0f <= da)
             {
-                if (surface != NULL) { surface->Release(); }
+                output[result] = *a;
 
-                if (tex->Surface != NULL) { tex->Surface->Release(); }
-
-                if (palette != NULL) { palette->Release(); }
+                result = result + 1;
             }
 
-            tex->MemoryType = desc.ddsCaps.dwCaps & DDSCAPS_VIDEOMEMORY
-                ? (desc.ddsCaps.dwCaps & DDSCAPS_NONLOCALVIDMEM ? RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY : RENDERER_MODULE_TEXTURE_LOCATION_LOCAL_VIDEO_MEMORY)
-                : (desc.ddsCaps.dwCaps & DDSCAPS_SYSTEMMEMORY ? RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY : RENDERER_MODULE_TEXTURE_LOCATION_SYSTEM_MEMORY);
-
-            tex->Texture = surface;
+            if ((0.0f <= da) != (0.0f <= db))
+            {
+                InterpolateRendererVertex(&output[result], a, b, da / (da - db));
 
-            return RENDERER_INITIALIZE_TEXTURE_DETAILS_OK;
+                result = result + 1;
+            }
         }
 
-        return RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR;
-    }
-
-    // 0x60009070
-    void ReleaseRendererTexture(RendererTexture* tex)
-    {
-        if (tex != NULL) { DisposeRendererTexture(tex); }
+        return result;
     }
 
-    // 0x6000b290
-    u32 DisposeRendererTexture(RendererTexture* tex)
+    // Clips the convex polygon against the clip rectangle, one edge at a time, the result ends up in the vertexes.
+    // Both of the arrays must fit MAX_CLIP_VERTEX_COUNT vertexes, which is enough for a triangle.
+    template <typename V> u32 ClipRendererPolygon(V* vertexes, V* buffer, const u32 count)
     {
-        if (State.Lambdas.ReleaseMemory != NULL) { return State.Lambdas.ReleaseMemory(tex); }
+        u32 result = count;
 
-        free(tex);
+        result = ClipRendererPolygonEdge(vertexes, result, buffer, RENDERER_CLIP_LEFT);
+        result = ClipRendererPolygonEdge(buffer, result, vertexes, RENDERER_CLIP_RIGHT);
+        result = ClipRendererPolygonEdge(vertexes, result, buffer, RENDERER_CLIP_TOP);
+        result = ClipRendererPolygonEdge(buffer, result, vertexes, RENDERER_CLIP_BOTTOM);
 
-        return RENDERER_MODULE_SUCCESS;
+        return result;
     }
 
-    // 0x60001650
-    RendererModuleWindowLock* RendererLock(const u32 mode)
+    // Clips the line against the clip rectangle, returns FALSE when the line is completely outside of it.
+    template <typename V> BOOL ClipRendererSegment(V* a, V* b)
     {
-        if (State.DX.Surfaces.Window != NULL)
-        {
-            if (State.Lock.IsActive) { LOGERROR("D3D lock called while locked\n"); }
-
-            if (State.Scene.IsActive) { EndRendererScene(); }
-
-            if (State.Lambdas.Lambdas.LockWindow != NULL) { State.Lambdas.Lambdas.LockWindow(TRUE); }
+        f32 start = 0.0f;
+        f32 end = 1.0f;
 
-            DDSURFACEDESC2 desc;
-            ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+        for (u32 x = RENDERER_CLIP_LEFT; x <= RENDERER_CLIP_BOTTOM; x = x << 1)
+        {
+            const f32 da = AcquireRendererClipDistance(&a->XYZ, x);
+            const f32 db = AcquireRendererClipDistance(&b->XYZ, x);
 
-            desc.dwSize = sizeof(DDSURFACEDESC2);
+            if (da < 0.0f && db < 0.0f) { return FALSE; }
 
-            u32 options = DDLOCK_SURFACEMEMORYPTR;
+            if (da < 0.0f)
+            {
+                const f32 value = da / (da - db);
 
-            switch (mode)
+                if (start < value) { start = value; }
+            }
+            else if (db < 0.0f)
             {
-            case LOCK_NONE: { options = DDLOCK_SURFACEMEMORYPTR; break; }
-            case LOCK_READ: { options = DDLOCK_READONLY; break; }
-            case LOCK_WRITE: { options = DDLOCK_WRITEONLY; break; }
+                const f32 value = da / (da - db);
+
+                if (value < end) { end = value; }
             }
+        }
 
-            State.Lock.Surface = State.DX.Surfaces.Window;
+        if (end < start) { return FALSE; }
 
-            State.DX.Code = State.DX.Surfaces.Window->Lock(NULL, &desc, options | DDLOCK_NOSYSLOCK | DDLOCK_WAIT, NULL);
+        const V va = *a;
+        const V vb = *b;
 
-            if (State.DX.Code != DD_OK)
-            {
-                if (State.Lambdas.Lambdas.LockWindow != NULL) { State.Lambdas.Lambdas.LockWindow(FALSE); }
+        if (start != 0.0f) { InterpolateRendererVertex(a, &va, &vb, start); }
+        if (end != 1.0f) { InterpolateRendererVertex(b, &va, &vb, end); }
 
-                return NULL;
-            }
+        return TRUE;
+    }
 
-            if (desc.ddpfPixelFormat.dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_16)
-            {
-                State.Lock.State.Format = (desc.ddpfPixelFormat.dwGBitMask == 0x7e0)
-                    ? RENDERER_PIXEL_FORMAT_R5G6B5
-                    : RENDERER_PIXEL_FORMAT_A1R5G5B5;
-            }
-            else if (desc.ddpfPixelFormat.dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_32)
-            {
-                State.Lock.State.Format = RENDERER_PIXEL_FORMAT_A8R8G8B8;
-            }
-            else if (desc.ddpfPixelFormat.dwRGBBitCount == GRAPHICS_BITS_PER_PIXEL_24)
-            {
-                State.Lock.State.Format = RENDERER_PIXEL_FORMAT_R8G8B8;
-            }
+    // Appends the convex polygon to the current batch as a fan of triangles.
+    template <typename V> void AppendRendererPolygon(V* vertexes, const u32 count)
+    {
+        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
 
-            if (State.Settings.IsWindowMode)
-            {
-                RECT rect;
-                GetClientRect(State.Window.HWND, &rect);
+        RendererPrimitiveType = D3DPT_TRIANGLELIST;
 
-                POINT point;
-                ZeroMemory(&point, sizeof(POINT));
+        if (MaximumRendererVertexCount - count < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-                ClientToScreen(State.Window.HWND, &point);
-                OffsetRect(&rect, point.x, point.y);
+        V* v = &((V*)State.Data.Vertexes.Vertexes)[State.Data.Vertexes.Count];
 
-                if (State.DX.Surfaces.Window == State.DX.Surfaces.Active[1]) // TODO
-                {
-                    desc.lpSurface = (void*)((addr)desc.lpSurface
-                        + (addr)((desc.ddpfPixelFormat.dwRGBBitCount >> 3) * rect.left)
-                        + (addr)(desc.lPitch * rect.top));
-                }
-            }
+        for (u32 x = 0; x < count; x++) { v[x] = vertexes[x]; }
 
-            State.Lock.State.Data = desc.lpSurface;
-            State.Lock.State.Stride = desc.lPitch;
-            State.Lock.State.Width = State.Window.Width;
-            State.Lock.State.Height = State.Window.Height;
+        for (u32 x = 0; x < count - 2; x++)
+        {
+            u16* values = &State.Data.Indexes.Indexes[State.Data.Indexes.Count + x * 3];
 
-            State.Lock.IsActive = TRUE;
+            values[0] = (u16)(State.Data.Vertexes.Count + 0);
+            values[1] = (u16)(State.Data.Vertexes.Count + x + 1);
+            values[2] = (u16)(State.Data.Vertexes.Count + x + 2);
         }
 
-        return &State.Lock.State;
+        State.Data.Indexes.Count = State.Data.Indexes.Count + (count - 2) * 3;
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + count;
     }
 
-    // 0x6000bab0
-    void InitializeRenderState55(void)
+    // Clips the line against the clip rectangle, and appends the visible part of it to the current batch.
+    template <typename V> void ClipRendererLine(V* a, V* b)
     {
-        SelectBasicRendererState(RENDERER_MODULE_STATE_55, (void*)(DAT_60058df4 + 1));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
-    }
+        V vertexes[2];
 
-    // 0x60009670
-    BOOL AcquireRendererDeviceState(void)
-    {
-        return State.DX.Active.IsInit;
+        vertexes[0] = *a;
+        vertexes[1] = *b;
+
+        if (!ClipRendererSegment(&vertexes[0], &vertexes[1])) { return; }
+
+        if (RendererPrimitiveType != D3DPT_LINELIST) { RendererRenderScene(); }
+
+        RendererPrimitiveType = D3DPT_LINELIST;
+
+        if (MaximumRendererVertexCount - 2 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+
+        V* v = &((V*)State.Data.Vertexes.Vertexes)[State.Data.Vertexes.Count];
+
+        v[0] = vertexes[0];
+        v[1] = vertexes[1];
+
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
+
+        State.Data.Indexes.Count = State.Data.Indexes.Count + 2;
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 2;
     }
-    
-    // 0x60009500
-    void ReleaseRendererDevice(void)
+
+    // Clips the triangle against the clip rectangle, and appends the visible part of it to the current batch.
+    template <typename V> void ClipRendererTriangle(V* a, V* b, V* c)
     {
-        if (AcquireRendererDeviceState() && State.Scene.IsActive)
-        {
-            FlushGameWindow();
-            SyncGameWindow(RENDERER_MODULE_SYNC_NORMAL);
-            Idle();
+        const u32 ca = AcquireRendererClipCode(&a->XYZ);
+        const u32 cb = AcquireRendererClipCode(&b->XYZ);
+        const u32 cc = AcquireRendererClipCode(&c->XYZ);
 
-            State.Scene.IsActive = FALSE;
-        }
+        if ((ca & cb & cc) != RENDERER_CLIP_NONE) { return; }
 
-        if (State.DX.Clipper != NULL)
-        {
-            State.DX.Clipper->Release();
-            State.DX.Clipper = NULL;
-        }
+        V vertexes[MAX_CLIP_VERTEX_COUNT];
 
-        if (State.DX.GammaControl != NULL)
+        vertexes[0] = *a;
+        vertexes[1] = *b;
+        vertexes[2] = *c;
+
+        u32 count = 3;
+
+        if ((ca | cb | cc) != RENDERER_CLIP_NONE)
         {
-            {
-                const f32 value = 1.0f;
+            V buffer[MAX_CLIP_VERTEX_COUNT];
 
-                SelectState(RENDERER_MODULE_STATE_SELECT_GAMMA_CONTROL_STATE, (void*)(u32)(*(u32*)&value));
-            }
+            count = ClipRendererPolygon(vertexes, buffer, count);
 
-            State.DX.GammaControl->Release();
-            State.DX.GammaControl = NULL;
+            if (count < 3) { return; }
         }
 
-        ResetTextures();
+        AppendRendererPolygon(vertexes, count);
+    }
 
-        State.DX.Active.Instance = NULL;
+    // NOTE: Used in place of the device viewport, see ClipGameWindow.
+    void AppendRendererClippedLine(RVX* a, RVX* b)
+    {
+        if (RendererVertexSize == sizeof(RTLVX2)) { ClipRendererLine((RTLVX2*)a, (RTLVX2*)b); return; }
 
-        State.DX.Active.Surfaces.Main = NULL;
-        State.DX.Active.Surfaces.Back = NULL;
-        State.DX.Active.Surfaces.Active.Main = NULL;
-        State.DX.Active.Surfaces.Active.Back = NULL;
+        ClipRendererLine((RTLVX*)a, (RTLVX*)b);
+    }
 
-        State.DX.Surfaces.Window = NULL;
+    // NOTE: Used in place of the device viewport, see ClipGameWindow.
+    void AppendRendererClippedTriangle(RVX* a, RVX* b, RVX* c)
+    {
+        if (RendererVertexSize == sizeof(RTLVX2)) { ClipRendererTriangle((RTLVX2*)a, (RTLVX2*)b, (RTLVX2*)c); return; }
 
-        State.Window.Index = 0;
+        ClipRendererTriangle((RTLVX*)a, (RTLVX*)b, (RTLVX*)c);
+    }
 
-        if (State.DX.Surfaces.Depth != NULL)
-        {
-            State.DX.Device->SetRenderState(D3DRENDERSTATE_ZENABLE, FALSE);
-            State.DX.Device->SetRenderState(D3DRENDERSTATE_ZWRITEENABLE, FALSE);
+    // 0x600082f0
+    void RenderLine(RVX* a, RVX* b)
+    {
+        if (State.Clip.IsActive) { AppendRendererClippedLine(a, b); return; }
 
-            State.DX.Surfaces.Depth->Release();
-            State.DX.Surfaces.Depth = NULL;
-        }
+        if (RendererPrimitiveType != D3DPT_LINELIST) { RendererRenderScene(); }
 
-        if (State.DX.Device != NULL)
+        RendererPrimitiveType = D3DPT_LINELIST;
+
+        if (MaximumRendererVertexCount - 2 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+
+        // A
         {
-            State.DX.Device->Release();
-            State.DX.Device = NULL;
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
+
+            CopyMemory(v, a, RendererVertexSize);
         }
 
-        if (State.DX.DirectX != NULL)
+        // B
         {
-            State.DX.DirectX->Release();
-            State.DX.DirectX = NULL;
-        }
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
 
-        State.DX.Active.IsInit = FALSE;
+            CopyMemory(v, b, RendererVertexSize);
+        }
 
-        State.Scene.IsActive = FALSE;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
 
-        ReleaseRendererWindows();
+        State.Data.Indexes.Count = State.Data.Indexes.Count + 2;
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 2;
     }
 
-    // 0x60001980
-    void ReleaseRendererWindows(void)
+    // Appends the indexed lines to the current batch.
+    template <typename V, typename I> void AppendRendererLineMesh(V* vertexes, const I* indexes, const u32 count)
     {
-        for (u32 x = 0; x < State.Window.Count + MIN_WINDOW_INDEX; x++)
+        for (u32 x = 0; x < count; x++)
         {
-            if (State.Windows[x + MIN_WINDOW_INDEX].Surface != NULL)
-            {
-                State.Windows[x + MIN_WINDOW_INDEX].Surface->Release();
-                State.Windows[x + MIN_WINDOW_INDEX].Surface = NULL;
-            }
-        }
+            if (State.Clip.IsActive) { ClipRendererLine(&vertexes[indexes[x * 2 + 0]], &vertexes[indexes[x * 2 + 1]]); continue; }
 
-        State.Window.Count = 0;
-    }
+            if (MaximumRendererVertexCount - 2 < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-    // 0x6000cf50
-    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette)
-    {
-        if (pixels == NULL && palette == NULL) { return FALSE; }
+            V* v = &((V*)State.Data.Vertexes.Vertexes)[State.Data.Vertexes.Count];
 
-        if (pixels != NULL)
-        {
-            tex->Descriptor.dwFlags = DDSD_LPSURFACE;
+            v[0] = vertexes[indexes[x * 2 + 0]];
+            v[1] = vertexes[indexes[x * 2 + 1]];
 
-            tex->Descriptor.lpSurface =
-                (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                ? (void*)((addr)pixels + (addr)8) : (void*)pixels;
+            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
 
-            if (tex->Surface->SetSurfaceDesc(&tex->Descriptor, 0) != DD_OK) { return FALSE; }
+            State.Data.Indexes.Count = State.Data.Indexes.Count + 2;
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + 2;
+        }
+    }
 
-            if (State.Scene.IsActive)
+    // 0x600084e0
+    // NOTE: The vertex type and the index size are resolved once per mesh, rather than once per vertex.
+    void RenderLineMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    {
+        if (RendererPrimitiveType != D3DPT_LINELIST) { RendererRenderScene(); }
+
+        RendererPrimitiveType = D3DPT_LINELIST;
+
+        if (RendererVertexSize == sizeof(RTLVX2))
+        {
+            switch (RendererIndexSize)
             {
-                AttemptRenderScene();
-                EndRendererScene();
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererLineMesh((RTLVX2*)vertexes, (u8*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererLineMesh((RTLVX2*)vertexes, (u16*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererLineMesh((RTLVX2*)vertexes, (u64*)indexes, count); break; }
+            default: { AppendRendererLineMesh((RTLVX2*)vertexes, indexes, count); break; }
             }
-
-            if (tex->Texture->Blt(NULL, tex->Surface, NULL, DDBLT_WAIT, NULL) != DD_OK) { return FALSE; }
         }
-
-        if (palette != NULL && tex->IsPalette)
+        else
         {
-            PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
-
-            for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
+            switch (RendererIndexSize)
             {
-                entries[x].peRed = (u8)RGBA_GETRED(palette[x]);
-                entries[x].peGreen = (u8)RGBA_GETGREEN(palette[x]);
-                entries[x].peBlue = (u8)RGBA_GETBLUE(palette[x]);
-                entries[x].peFlags = 0;
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererLineMesh((RTLVX*)vertexes, (u8*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererLineMesh((RTLVX*)vertexes, (u16*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererLineMesh((RTLVX*)vertexes, (u64*)indexes, count); break; }
+            default: { AppendRendererLineMesh((RTLVX*)vertexes, indexes, count); break; }
             }
+        }
+    }
+
+    // 0x60008730
+    BOOL RenderPoints(RVX* vertexes, const u32 count)
+    {
+        if (!State.Scene.IsActive) { BeginRendererScene(); }
 
-            if (tex->Palette->SetEntries(0, 0, tex->Colors, entries) != DD_OK) { return FALSE; }
+        AttemptRenderScene();
 
-            if (tex->Texture->SetPalette(tex->Palette) != DD_OK) { return FALSE; }
-        }
+        const u32 length = State.Clip.IsActive ? ClipRendererPoints(vertexes, count) : count;
 
-        if (tex->MipMapCount != 0) { UpdateRendererTexture(tex, pixels); }
+        if (length == 0) { return TRUE; }
 
-        return TRUE;
+        UpdateVertexes(vertexes, length, State.Data.Vertexes.Transforms);
+
+        return State.DX.Device->DrawPrimitive(D3DPT_POINTLIST, RendererVertexType, vertexes, length, D3DDP_NONE) == DD_OK;
     }
 
-    // 0x6000d0c0
-    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels)
+    // 0x60007af0
+    void RenderQuad(RVX* a, RVX* b, RVX* c, RVX* d)
     {
-        if (tex->MipMapCount == 0 || tex->MipMapCount == 1) { return TRUE; }
-
-        IDirectDrawSurface7* s1 = tex->Surface;
-        IDirectDrawSurface7* s2 = tex->Texture;
+        if (State.Clip.IsActive)
+        {
+            AppendRendererClippedTriangle(a, b, c);
+            AppendRendererClippedTriangle(a, c, d);
 
-        s1->AddRef();
-        s2->AddRef();
+            return;
+        }
 
-        DDSCAPS2 caps;
-        ZeroMemory(&caps, sizeof(DDSCAPS2));
+        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
 
-        DDSURFACEDESC2 desc;
-        ZeroMemory(&desc, sizeof(DDSURFACEDESC2));
+        RendererPrimitiveType = D3DPT_TRIANGLELIST;
 
-        desc.dwSize = sizeof(DDSURFACEDESC2);
+        if (MaximumRendererVertexCount - 4 < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-        u32 offset = (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
-            || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3) ? 8 : 0; // TODO
+        // A
+        {
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
 
-        void* allocated = NULL;
-        u32* data = NULL;
+            CopyMemory(v, a, RendererVertexSize);
+        }
 
-        for (u32 x = 0; x < tex->MipMapCount; x++)
+        // B
         {
-            if (pixels != NULL)
-            {
-                s1->GetSurfaceDesc(&desc);
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
 
-                if (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
-                    || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                {
-                    desc.lPitch = desc.lPitch / desc.dwHeight;
-                }
+            CopyMemory(v, b, RendererVertexSize);
+        }
 
-                offset = offset + desc.dwHeight * desc.lPitch;
+        // C
+        {
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 2)));
 
-                caps.dwCaps = DDSCAPS_MIPMAP | DDSCAPS_TEXTURE;
+            CopyMemory(v, c, RendererVertexSize);
+        }
 
-                {
-                    IDirectDrawSurface7* attached = NULL;
-                    s1->GetAttachedSurface(&caps, &attached);
-                    s1->Release();
+        // D
+        {
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 3)));
 
-                    s1 = attached;
-                }
+            CopyMemory(v, d, RendererVertexSize);
+        }
 
-                {
-                    IDirectDrawSurface7* attached = NULL;
-                    s2->GetAttachedSurface(&caps, &attached);
-                    s2->Release();
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 3] = State.Data.Vertexes.Count + 0;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 4] = State.Data.Vertexes.Count + 2;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 5] = State.Data.Vertexes.Count + 3;
 
-                    s2 = attached;
-                }
+        State.Data.Indexes.Count = State.Data.Indexes.Count + 6;
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 4;
+    }
 
-                s1->GetSurfaceDesc(&tex->Descriptor);
+    // Appends the visible quads of the indexed quad list to the current batch as pairs of triangles.
+    template <typename V, typename I> void AppendRendererQuadMesh(V* vertexes, const I* indexes, const u32 count)
+    {
+        u32 visible[MAX_CULL_PRIMITIVE_COUNT];
 
-                tex->Descriptor.dwFlags = DDSD_LPSURFACE;
+        for (u32 x = 0; x < count; x = x + MAX_CULL_PRIMITIVE_COUNT)
+        {
+            const u32 length = AcquireVisiblePrimitives(vertexes, indexes, x,
+                (count - x) < MAX_CULL_PRIMITIVE_COUNT ? (count - x) : MAX_CULL_PRIMITIVE_COUNT, 4, visible);
 
-                const u32 pitch = (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
-                    || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                    ? tex->Descriptor.lPitch
-                    : (tex->Descriptor.ddpfPixelFormat.dwRGBBitCount * ((tex->Descriptor.dwWidth + 7) >> 3));
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                const I* values = &indexes[visible[xx] * 4];
 
-                if (pitch == tex->Descriptor.lPitch)
-                {
-                    tex->Descriptor.lpSurface = (void*)((addr)pixels + (addr)offset);
-                }
-                else
+                if (State.Clip.IsActive)
                 {
-                    if (allocated == NULL)
-                    {
-                        const u32 length = ALIGN(desc.lPitch * desc.dwHeight);
+                    ClipRendererTriangle(&vertexes[values[0]], &vertexes[values[1]], &vertexes[values[2]]);
+                    ClipRendererTriangle(&vertexes[values[0]], &vertexes[values[2]], &vertexes[values[3]]);
 
-                        allocated = _alloca(length);
-                        memset(allocated, 0xff, length);
-                    }
+                    continue;
+                }
 
-                    if (data == NULL) { data = (u32*)((addr)pixels + (addr)offset); }
+                if (MaximumRendererVertexCount - 4 < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-                    tex->Descriptor.lpSurface = allocated;
+                V* v = &((V*)State.Data.Vertexes.Vertexes)[State.Data.Vertexes.Count];
 
-                    for (u32 xx = 0; xx < tex->Descriptor.dwHeight; xx++)
-                    {
-                        CopyMemory(allocated, (void*)((addr)data + (addr)(xx * pitch)), pitch);
+                v[0] = vertexes[values[0]];
+                v[1] = vertexes[values[1]];
+                v[2] = vertexes[values[2]];
+                v[3] = vertexes[values[3]];
 
-                        allocated = (void*)((addr)allocated + (addr)tex->Descriptor.lPitch);
-                    }
-                }
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 3] = State.Data.Vertexes.Count + 0;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 4] = State.Data.Vertexes.Count + 2;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 5] = State.Data.Vertexes.Count + 3;
 
-                s1->SetSurfaceDesc(&tex->Descriptor, 0);
-                s2->Blt(NULL, s1, NULL, DDBLT_WAIT, NULL);
+                State.Data.Indexes.Count = State.Data.Indexes.Count + 6;
+                State.Data.Vertexes.Count = State.Data.Vertexes.Count + 4;
             }
-
-            s1->Release();
-            s2->Release();
         }
-
-        return TRUE;
     }
 
-    // 0x6000cd50
-    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette, const u32 x, const u32 y, const u32 width, const u32 height, const u32 stride)
+    // 0x60007650
+    // NOTE: The vertex type and the index size are resolved once per mesh, rather than once per vertex.
+    void RenderQuadMesh(RVX* vertexes, const u32* indexes, const u32 count)
     {
-        if (pixels != NULL)
-        {
-            RECT source;
-
-            source.left = x;
-            source.right = x + width;
-            source.top = y;
-            source.bottom = y + height;
-
-            RECT destination;
-
-            destination.left = 0;
-            destination.right = width;
-            destination.top = 0;
-            destination.bottom = height;
-
-            tex->Descriptor.dwFlags = DDSD_LPSURFACE;
+        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
 
-            tex->Descriptor.lpSurface =
-                (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1 || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                ? (void*)((addr)pixels + (addr)8) : (void*)pixels;
+        RendererPrimitiveType = D3DPT_TRIANGLELIST;
 
-            if (tex->Descriptor.lPitch != stride)
+        if (RendererVertexSize == sizeof(RTLVX2))
+        {
+            switch (RendererIndexSize)
             {
-                const u32 length = ALIGN(tex->Descriptor.lPitch * height);
-
-                void* allocated = _alloca(length);
-                memset(allocated, 0xff, length);
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererQuadMesh((RTLVX2*)vertexes, (u8*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererQuadMesh((RTLVX2*)vertexes, (u16*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererQuadMesh((RTLVX2*)vertexes, (u64*)indexes, count); break; }
+            default: { AppendRendererQuadMesh((RTLVX2*)vertexes, indexes, count); break; }
+            }
+        }
+        else
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererQuadMesh((RTLVX*)vertexes, (u8*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererQuadMesh((RTLVX*)vertexes, (u16*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererQuadMesh((RTLVX*)vertexes, (u64*)indexes, count); break; }
+            default: { AppendRendererQuadMesh((RTLVX*)vertexes, indexes, count); break; }
+            }
+        }
+    }
 
-                tex->Descriptor.lpSurface = (tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT1
-                    || tex->FormatIndexValue == RENDERER_PIXEL_FORMAT_DXT3)
-                    ? (void*)((addr)allocated + (addr)8) : allocated;
+    // 0x60006fe0
+    void RenderTriangle(RVX* a, RVX* b, RVX* c)
+    {
+        if (State.Clip.IsActive) { AppendRendererClippedTriangle(a, b, c); return; }
 
-                for (u32 xx = 0; xx < height; xx++)
-                {
-                    CopyMemory(allocated, (void*)((addr)pixels + (addr)(xx * stride)), stride);
+        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
 
-                    allocated = (void*)((addr)allocated + (addr)tex->Descriptor.lPitch);
-                }
-            }
+        RendererPrimitiveType = D3DPT_TRIANGLELIST;
 
-            if (tex->Surface->SetSurfaceDesc(&tex->Descriptor, 0) != DD_OK) { return FALSE; }
+        if (MaximumRendererVertexCount - 3 < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-            if (State.Scene.IsActive)
-            {
-                AttemptRenderScene();
-                EndRendererScene();
-            }
+        // A
+        {
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
 
-            if (tex->Texture->Blt(&source, tex->Surface, &destination, DDBLT_WAIT, NULL) != DD_OK) { return FALSE; }
+            CopyMemory(v, a, RendererVertexSize);
         }
 
-        if (palette != NULL && tex->IsPalette)
+        // B
         {
-            PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
 
-            for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
-            {
-                entries[x].peRed = (u8)RGBA_GETRED(palette[x]);
-                entries[x].peGreen = (u8)RGBA_GETGREEN(palette[x]);
-                entries[x].peBlue = (u8)RGBA_GETBLUE(palette[x]);
-                entries[x].peFlags = 0;
-            }
+            CopyMemory(v, b, RendererVertexSize);
+        }
 
-            if (tex->Palette->SetEntries(0, 0, tex->Colors, entries) != DD_OK) { return FALSE; }
+        // C
+        {
+            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 2)));
 
-            if (tex->Texture->SetPalette(tex->Palette) != DD_OK) { return FALSE; }
+            CopyMemory(v, c, RendererVertexSize);
         }
 
-        if (tex->MipMapCount != 0) { UpdateRendererTexture(tex, pixels); }
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
+        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
 
-        return TRUE;
+        State.Data.Indexes.Count = State.Data.Indexes.Count + 3;
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 3;
     }
 
-    // 0x600082f0
-    void RenderLine(RVX* a, RVX* b)
+    // 0x60008270
+    BOOL RenderTriangleFans(RVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes)
     {
-        if (RendererPrimitiveType != D3DPT_LINELIST) { RendererRenderScene(); }
+        AppendRendererTriangles(D3DPT_TRIANGLEFAN, indexCount, vertexes, indexes);
 
-        RendererPrimitiveType = D3DPT_LINELIST;
+        return TRUE;
+    }
 
-        if (MaximumRendererVertexCount - 2 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+    // Appends the visible triangles of the indexed triangle list to the current batch.
+    template <typename V, typename I> void AppendRendererTriangleMesh(V* vertexes, const I* indexes, const u32 count)
+    {
+        u32 visible[MAX_CULL_PRIMITIVE_COUNT];
 
-        // A
+        for (u32 x = 0; x < count; x = x + MAX_CULL_PRIMITIVE_COUNT)
         {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
-
-            CopyMemory(v, a, RendererVertexSize);
+            const u32 length = AcquireVisiblePrimitives(vertexes, indexes, x,
+                (count - x) < MAX_CULL_PRIMITIVE_COUNT ? (count - x) : MAX_CULL_PRIMITIVE_COUNT, 3, visible);
 
+            for (u32 xx = 0; xx < length; xx++)
             {
-                RTLVX* vertex = (RTLVX*)v;
+                const I* values = &indexes[visible[xx] * 3];
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+                if (State.Clip.IsActive) { ClipRendererTriangle(&vertexes[values[0]], &vertexes[values[1]], &vertexes[values[2]]); continue; }
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                }
+                if (MaximumRendererVertexCount - 3 < State.Data.Vertexes.Count) { RendererRenderScene(); }
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-            }
-        }
+                V* v = &((V*)State.Data.Vertexes.Vertexes)[State.Data.Vertexes.Count];
 
-        // B
-        {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
+                v[0] = vertexes[values[0]];
+                v[1] = vertexes[values[1]];
+                v[2] = vertexes[values[2]];
 
-            CopyMemory(v, b, RendererVertexSize);
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
+                State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
 
-            {
-                RTLVX* vertex = (RTLVX*)v;
+                State.Data.Indexes.Count = State.Data.Indexes.Count + 3;
+                State.Data.Vertexes.Count = State.Data.Vertexes.Count + 3;
+            }
+        }
+    }
+
+    // 0x600072a0
+    // NOTE: The vertex type and the index size are resolved once per mesh, rather than once per vertex.
+    void RenderTriangleMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    {
+        if (SettingsState.GeometryCache && RenderRendererMesh(vertexes, indexes, count)) { return; }
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                }
+        RendererPrimitiveType = D3DPT_TRIANGLELIST;
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
+        if (RendererVertexSize == sizeof(RTLVX2))
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleMesh((RTLVX2*)vertexes, (u8*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleMesh((RTLVX2*)vertexes, (u16*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleMesh((RTLVX2*)vertexes, (u64*)indexes, count); break; }
+            default: { AppendRendererTriangleMesh((RTLVX2*)vertexes, indexes, count); break; }
+            }
+        }
+        else
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleMesh((RTLVX*)vertexes, (u8*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleMesh((RTLVX*)vertexes, (u16*)indexes, count); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleMesh((RTLVX*)vertexes, (u64*)indexes, count); break; }
+            default: { AppendRendererTriangleMesh((RTLVX*)vertexes, indexes, count); break; }
             }
         }
-
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
-
-        State.Data.Indexes.Count = State.Data.Indexes.Count + 2;
-        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 2;
     }
 
-    // 0x600084e0
-    void RenderLineMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    // NOTE: Draws the triangle mesh straight from the vertex buffer of the cache, when the very same mesh,
+    // with the very same vertex transforms, was submitted during the previous frames. The device culls the triangles,
+    // same way as they would be culled on the CPU. Meshes with fog, depth bias or depth range depend on state outside of the vertexes, thus never cached,
+    // same as the meshes drawn while the primitives are clipped on the CPU.
+    BOOL RenderRendererMesh(RVX* vertexes, const u32* indexes, const u32 count)
     {
-        if (RendererPrimitiveType != D3DPT_LINELIST) { RendererRenderScene(); }
+        if (State.Clip.IsActive) { return FALSE; }
 
-        RendererPrimitiveType = D3DPT_LINELIST;
+        if (State.Data.Vertexes.Transforms & (RENDERER_VERTEX_TRANSFORM_FOG | RENDERER_VERTEX_TRANSFORM_DEPTH | RENDERER_VERTEX_TRANSFORM_RANGE | RENDERER_VERTEX_TRANSFORM_ATLAS)) { return FALSE; }
 
-        for (u32 x = 0; x < count; x++)
-        {
-            if (MaximumRendererVertexCount - 2 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+        RendererMesh* mesh = AcquireRendererMesh(vertexes, indexes, count);
 
-            // A
-            {
-                void* v = (void*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
+        if (mesh == NULL) { return FALSE; }
 
-                const u16 indx = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 2 + 0)));
+        if (mesh->Vertexes.Buffer == NULL)
+        {
+            State.Meshes.Statistics.Current.Misses = State.Meshes.Statistics.Current.Misses + 1;
 
-                void* a = (void*)((addr)vertexes + (addr)(RendererVertexSize * indx));
+            return FALSE;
+        }
 
-                CopyMemory(v, a, RendererVertexSize);
+        State.Meshes.Statistics.Current.Hits = State.Meshes.Statistics.Current.Hits + 1;
 
-                {
-                    RTLVX* vertex = (RTLVX*)v;
+        if (State.Data.Vertexes.Count != 0) { RendererRenderScene(); }
 
-                    if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        if (!State.Scene.IsActive) { BeginRendererScene(); }
 
-                    if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                    {
-                        vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                    }
+        State.Commands.Statistics.Current.Recorded = State.Commands.Statistics.Current.Recorded + 1;
 
-                    vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-                }
-            }
+        if (State.Commands.IsActive) { AppendRendererMeshCommand(mesh); }
+        else
+        {
+            State.DX.Device->DrawIndexedPrimitiveVB(D3DPT_TRIANGLELIST, mesh->Vertexes.Buffer, 0, mesh->Vertexes.Count,
+                mesh->Indexes.Indexes, mesh->Indexes.Count, 0);
 
-            // B
-            {
-                void* v = (void*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
-                
-                const u16 indx = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 2 + 1)));
-                
-                void* b = (void*)((addr)vertexes + (addr)(RendererVertexSize * indx));
+            State.Commands.Statistics.Current.Submitted = State.Commands.Statistics.Current.Submitted + 1;
+        }
 
-                CopyMemory(v, b, RendererVertexSize);
+        return TRUE;
+    }
 
-                {
-                    RTLVX* vertex = (RTLVX*)v;
+    // NOTE: Looks up the mesh in the cache by the hash of its indexes and vertexes, and keeps track of the number of consecutive frames
+    // it was seen in. The vertex buffer is created once the mesh was seen in enough frames. Returns NULL for the meshes not tracked.
+    RendererMesh* AcquireRendererMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    {
+        const u32 length = count * 3;
 
-                    if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        u32 a = 0x811c9dc5;
+        u32 b = 0x9e3779b1;
 
-                    if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                    {
-                        vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                    }
+        u32 maximum = 0;
 
-                    vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-                }
-            }
+        for (u32 x = 0; x < length; x++)
+        {
+            const u32 indx = AcquireRendererVertexIndex(indexes, x);
 
-            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
-            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
+            if (maximum < indx) { maximum = indx; }
 
-            State.Data.Indexes.Count = State.Data.Indexes.Count + 2;
-            State.Data.Vertexes.Count = State.Data.Vertexes.Count + 2;
+            a = (a ^ indx) * 0x01000193;
+            b = (((b << 5) | (b >> 27)) ^ indx) * 0x85ebca6b;
         }
-    }
 
-    // 0x60008730
-    BOOL RenderPoints(RVX* vertexes, const u32 count)
-    {
-        if (!State.Scene.IsActive) { BeginRendererScene(); }
+        const u32 vertexCount = maximum + 1;
 
-        AttemptRenderScene();
+        if (vertexCount < MIN_MESH_VERTEX_COUNT || MAX_MESH_VERTEX_COUNT < vertexCount) { return NULL; }
 
-        for (u32 x = 0; x < count; x++)
         {
-            RTLVX* vertex = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * x));
+            const u32* values = (u32*)vertexes;
+            const u32 size = (vertexCount * RendererVertexSize) / sizeof(u32);
 
-            if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
-
-            if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
+            for (u32 x = 0; x < size; x++)
             {
-                vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
+                a = (a ^ values[x]) * 0x01000193;
+                b = (((b << 5) | (b >> 27)) ^ values[x]) * 0x85ebca6b;
             }
-
-            vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
         }
 
-        InitializeVertexes(vertexes, count);
-
-        return State.DX.Device->DrawPrimitive(D3DPT_POINTLIST, RendererVertexType, vertexes, count, D3DDP_NONE) == DD_OK;
-    }
+        // Reordering of the triangles changes the result of the blending, thus only the opaque meshes are reordered.
+        const BOOL ordered = State.Shadow.States.IsValid[D3DRENDERSTATE_ALPHABLENDENABLE] && !State.Shadow.States.Values[D3DRENDERSTATE_ALPHABLENDENABLE];
 
-    // 0x60007af0
-    void RenderQuad(RVX* a, RVX* b, RVX* c, RVX* d)
-    {
-        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
+        RendererMesh* mesh = NULL;
 
-        RendererPrimitiveType = D3DPT_TRIANGLELIST;
+        for (u32 x = 0; x < State.Meshes.Count; x++)
+        {
+            RendererMesh* m = &State.Meshes.Meshes[x];
 
-        if (MaximumRendererVertexCount - 4 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+            if (m->Hash[0] == a && m->Hash[1] == b && m->Type == RendererVertexType
+                && m->Transforms == State.Data.Vertexes.Transforms && m->IsOrdered == ordered && m->Vertexes.Count == vertexCount && m->Indexes.Count == length)
+            {
+                mesh = m; break;
+            }
+        }
 
-        // A
+        if (mesh == NULL)
         {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
-
-            CopyMemory(v, a, RendererVertexSize);
+            if (State.Meshes.Count < MAX_MESH_COUNT)
+            {
+                mesh = &State.Meshes.Meshes[State.Meshes.Count];
 
+                State.Meshes.Count = State.Meshes.Count + 1;
+            }
+            else
             {
-                RTLVX* vertex = (RTLVX*)v;
+                // NOTE: Replace the least recently seen mesh, unless it is still in use by the current or the previous frame.
+                for (u32 x = 0; x < State.Meshes.Count; x++)
+                {
+                    RendererMesh* m = &State.Meshes.Meshes[x];
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+                    if (State.Meshes.Frame <= m->Frame + 1) { continue; }
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
+                    if (mesh == NULL || m->Frame < mesh->Frame) { mesh = m; }
                 }
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
+                if (mesh == NULL) { return NULL; }
+
+                ReleaseRendererMesh(mesh);
             }
+
+            mesh->Hash[0] = a;
+            mesh->Hash[1] = b;
+            mesh->Type = RendererVertexType;
+            mesh->Transforms = State.Data.Vertexes.Transforms;
+            mesh->IsOrdered = ordered;
+            mesh->Frame = State.Meshes.Frame;
+            mesh->Frames = 1;
+            mesh->Size = 0;
+            mesh->Vertexes.Count = vertexCount;
+            mesh->Vertexes.Buffer = NULL;
+            mesh->Indexes.Count = length;
+            mesh->Indexes.Indexes = NULL;
+
+            return mesh;
         }
 
-        // B
+        if (mesh->Frame != State.Meshes.Frame)
         {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
+            mesh->Frames = (mesh->Frame + 1 == State.Meshes.Frame) ? (mesh->Frames + 1) : 1;
+            mesh->Frame = State.Meshes.Frame;
+        }
 
-            CopyMemory(v, b, RendererVertexSize);
+        if (mesh->Vertexes.Buffer == NULL && MIN_MESH_FRAME_COUNT <= mesh->Frames) { InitializeRendererMesh(mesh, vertexes, indexes); }
 
-            {
-                RTLVX* vertex = (RTLVX*)v;
+        return mesh;
+    }
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+    // NOTE: Creates the write-once vertex buffer of the mesh, with the vertex transforms already applied, and a copy of its indexes.
+    // The least recently seen meshes are released to keep the cache within its memory limit.
+    BOOL InitializeRendererMesh(RendererMesh* mesh, RVX* vertexes, const u32* indexes)
+    {
+        const u32 size = mesh->Vertexes.Count * RendererVertexSize + mesh->Indexes.Count * sizeof(u16);
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                }
+        while (MAX_MESH_SIZE < State.Meshes.Size + size)
+        {
+            RendererMesh* m = NULL;
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
+            for (u32 x = 0; x < State.Meshes.Count; x++)
+            {
+                RendererMesh* mm = &State.Meshes.Meshes[x];
+
+                if (mm->Vertexes.Buffer == NULL || State.Meshes.Frame <= mm->Frame + 1) { continue; }
+
+                if (m == NULL || mm->Frame < m->Frame) { m = mm; }
             }
+
+            if (m == NULL) { return FALSE; }
+
+            ReleaseRendererMesh(m);
         }
 
-        // C
-        {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 2)));
+        WaitRendererThread();
 
-            CopyMemory(v, c, RendererVertexSize);
+        D3DVERTEXBUFFERDESC desc;
+        ZeroMemory(&desc, sizeof(D3DVERTEXBUFFERDESC));
 
-            {
-                RTLVX* vertex = (RTLVX*)v;
+        desc.dwSize = sizeof(D3DVERTEXBUFFERDESC);
+        desc.dwCaps = D3DVBCAPS_WRITEONLY;
+        desc.dwFVF = RendererVertexType;
+        desc.dwNumVertices = mesh->Vertexes.Count;
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        IDirect3DVertexBuffer7* buffer = NULL;
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                }
+        if (State.DX.DirectX->CreateVertexBuffer(&desc, &buffer, 0) != DD_OK) { return FALSE; }
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-            }
-        }
+        void* data = NULL;
 
-        // D
+        if (buffer->Lock(DDLOCK_WAIT | DDLOCK_WRITEONLY | DDLOCK_DISCARDCONTENTS, &data, NULL) != DD_OK)
         {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 3)));
+            buffer->Release();
 
-            CopyMemory(v, d, RendererVertexSize);
+            return FALSE;
+        }
 
-            {
-                RTLVX* vertex = (RTLVX*)v;
+        CopyMemory(data, vertexes, mesh->Vertexes.Count * RendererVertexSize);
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        UpdateVertexes((RVX*)data, mesh->Vertexes.Count, mesh->Transforms);
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                }
+        buffer->Unlock();
+        buffer->Optimize(State.DX.Device, 0);
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-            }
+        mesh->Indexes.Indexes = (u16*)malloc(mesh->Indexes.Count * sizeof(u16));
+
+        if (mesh->Indexes.Indexes == NULL)
+        {
+            buffer->Release();
+
+            return FALSE;
         }
 
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 3] = State.Data.Vertexes.Count + 0;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 4] = State.Data.Vertexes.Count + 2;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 5] = State.Data.Vertexes.Count + 3;
+        for (u32 x = 0; x < mesh->Indexes.Count; x++)
+        {
+            mesh->Indexes.Indexes[x] = (u16)AcquireRendererVertexIndex(indexes, x);
+        }
 
-        State.Data.Indexes.Count = State.Data.Indexes.Count + 6;
-        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 4;
-    }
+        if (mesh->IsOrdered) { OptimizeRendererMeshIndexes(mesh->Indexes.Indexes, mesh->Indexes.Count, mesh->Vertexes.Count); }
 
-    // 0x60007650
-    void RenderQuadMesh(RVX* vertexes, const u32* indexes, const u32 count)
-    {
-        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
+        mesh->Vertexes.Buffer = buffer;
+        mesh->Size = size;
 
-        RendererPrimitiveType = D3DPT_TRIANGLELIST;
+        State.Meshes.Size = State.Meshes.Size + size;
 
-        for (u32 x = 0; x < count; x++)
+        return TRUE;
+    }
+
+    void ReleaseRendererMesh(RendererMesh* mesh)
+    {
+        if (mesh->Vertexes.Buffer != NULL)
         {
-            if (MaximumRendererVertexCount - 4 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+            mesh->Vertexes.Buffer->Release();
+            mesh->Vertexes.Buffer = NULL;
+        }
 
-            const u16 ia = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 4 + 0)));
-            const u16 ib = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 4 + 1)));
-            const u16 ic = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 4 + 2)));
-            const u16 id = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 4 + 3)));
+        if (mesh->Indexes.Indexes != NULL)
+        {
+            free(mesh->Indexes.Indexes);
+            mesh->Indexes.Indexes = NULL;
+        }
 
-            RVX* a = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * ia));
-            RVX* b = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * ib));
-            RVX* c = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * ic));
-            RVX* d = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * id));
+        State.Meshes.Size = State.Meshes.Size - mesh->Size;
 
-            if (State.Settings.Cull == RENDERER_CULL_MODE_NONE || ((u32)AcquireNormal((f32x3*)a, (f32x3*)b, (f32x3*)c) & RENDERER_CULL_MODE_COUNTER_CLOCK_WISE) != State.Settings.Cull) { RenderQuad(a, b, c, d); }
-        }
+        mesh->Size = 0;
+        mesh->Frames = 0;
     }
 
-    // 0x60006fe0
-    void RenderTriangle(RVX* a, RVX* b, RVX* c)
+    // NOTE: Releases all of the cached meshes, the recorded commands must have been submitted beforehand.
+    void ReleaseRendererMeshes(void)
     {
-        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
-
-        RendererPrimitiveType = D3DPT_TRIANGLELIST;
+        for (u32 x = 0; x < State.Meshes.Count; x++) { ReleaseRendererMesh(&State.Meshes.Meshes[x]); }
 
-        if (MaximumRendererVertexCount - 3 < State.Data.Vertexes.Count) { RendererRenderScene(); }
+        State.Meshes.Count = 0;
+        State.Meshes.Size = 0;
+    }
 
-        // A
-        {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
+    // 0x60007e60
+    BOOL RenderTriangleStrips(RVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes)
+    {
+        AppendRendererTriangles(D3DPT_TRIANGLESTRIP, indexCount, vertexes, indexes);
 
-            CopyMemory(v, a, RendererVertexSize);
+        return TRUE;
+    }
 
+    // Appends the triangle strip or fan to the current batch as an indexed triangle list.
+    // Every vertex is copied once, and the odd triangles of a strip are emitted with the winding order reversed, same as the device does.
+    // The primitive is split only when it does not fit into an empty batch.
+    template <typename V, typename I> void AppendRendererTriangleStrip(const D3DPRIMITIVETYPE type, const u32 count, V* vertexes, const I* indexes)
+    {
+        if (State.Clip.IsActive)
+        {
+            for (u32 x = 0; x < count; x++)
             {
-                RTLVX* vertex = (RTLVX*)v;
+                const BOOL odd = type == D3DPT_TRIANGLESTRIP && (x & 1) != 0;
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+                const u32 a = type == D3DPT_TRIANGLEFAN ? 0 : x;
+                const u32 b = odd ? x + 2 : x + 1;
+                const u32 c = odd ? x + 1 : x + 2;
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                }
-
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
+                if (indexes == NULL) { ClipRendererTriangle(&vertexes[a], &vertexes[b], &vertexes[c]); }
+                else { ClipRendererTriangle(&vertexes[indexes[a]], &vertexes[indexes[b]], &vertexes[indexes[c]]); }
             }
+
+            return;
         }
 
-        // B
+        u32 x = 0;
+
+        while (x < count)
         {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
+            u32 length = AcquireRendererTriangleCount(count - x);
 
-            CopyMemory(v, b, RendererVertexSize);
+            if (length < count - x && State.Data.Vertexes.Count != 0)
+            {
+                RendererRenderScene();
+
+                length = AcquireRendererTriangleCount(count - x);
+            }
 
+            // NOTE: The fan center is the first vertex of each part of the fan.
             {
-                RTLVX* vertex = (RTLVX*)v;
+                V* v = &((V*)State.Data.Vertexes.Vertexes)[State.Data.Vertexes.Count];
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+                const u32 position = type == D3DPT_TRIANGLEFAN ? 0 : x;
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
+                if (indexes == NULL)
                 {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
+                    v[0] = vertexes[position];
+
+                    for (u32 xx = 1; xx < length + 2; xx++) { v[xx] = vertexes[x + xx]; }
                 }
+                else
+                {
+                    v[0] = vertexes[indexes[position]];
 
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
+                    for (u32 xx = 1; xx < length + 2; xx++) { v[xx] = vertexes[indexes[x + xx]]; }
+                }
             }
-        }
-
-        // C
-        {
-            RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 2)));
-
-            CopyMemory(v, c, RendererVertexSize);
 
+            for (u32 xx = 0; xx < length; xx++)
             {
-                RTLVX* vertex = (RTLVX*)v;
+                u16* values = &State.Data.Indexes.Indexes[State.Data.Indexes.Count + xx * 3];
 
-                if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+                const u16 indx = (u16)(State.Data.Vertexes.Count + xx);
 
-                if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
+                if (type == D3DPT_TRIANGLEFAN)
                 {
-                    vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
+                    values[0] = (u16)State.Data.Vertexes.Count;
+                    values[1] = indx + 1;
+                    values[2] = indx + 2;
+                }
+                else if (((x + xx) & 1) == 0)
+                {
+                    values[0] = indx + 0;
+                    values[1] = indx + 1;
+                    values[2] = indx + 2;
+                }
+                else
+                {
+                    values[0] = indx + 0;
+                    values[1] = indx + 2;
+                    values[2] = indx + 1;
                 }
-
-                vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
             }
-        }
 
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
-        State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
+            State.Data.Indexes.Count = State.Data.Indexes.Count + length * 3;
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + length + 2;
 
-        State.Data.Indexes.Count = State.Data.Indexes.Count + 3;
-        State.Data.Vertexes.Count = State.Data.Vertexes.Count + 3;
+            x = x + length;
+        }
     }
 
-    // 0x60008270
-    BOOL RenderTriangleFans(RVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes)
+    // NOTE: The vertex type and the index size are resolved once per primitive, rather than once per vertex.
+    void AppendRendererTriangles(const D3DPRIMITIVETYPE type, const u32 count, RVX* vertexes, const u32* indexes)
     {
-        u32 max = 0;
+        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
 
-        for (u32 x = 0; x < indexCount + 2; x++)
-        {
-            State.Data.Indexes.Large[x] = indexes[x];
+        RendererPrimitiveType = D3DPT_TRIANGLELIST;
 
-            if (max < indexes[x]) { max = indexes[x]; }
+        if (RendererVertexSize == sizeof(RTLVX2))
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, indexes); break; }
+            }
+        }
+        else
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, indexes); break; }
+            }
         }
+    }
 
-        if (!State.Scene.IsActive) { BeginRendererScene(); }
+    // Acquires the number of the triangles of a strip or a fan that fit into the current batch.
+    u32 AcquireRendererTriangleCount(const u32 count)
+    {
+        const u32 vertexes = (State.Data.Vertexes.Count + 2) < MaximumRendererVertexCount
+            ? MaximumRendererVertexCount - (State.Data.Vertexes.Count + 2) : 0;
+        const u32 indexes = (MAX_LARGE_INDEX_COUNT - State.Data.Indexes.Count) / 3;
 
-        InitializeVertexes(vertexes, max + 1);
+        const u32 result = vertexes < indexes ? vertexes : indexes;
 
-        return State.DX.Device->DrawIndexedPrimitive(D3DPT_TRIANGLEFAN, RendererVertexType,
-            vertexes, max + 1, State.Data.Indexes.Large, indexCount + 2, D3DDP_NONE) == DD_OK;
+        return count < result ? count : result;
     }
 
-    // 0x600072a0
-    void RenderTriangleMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    // Acquires the vertex index at the position, according to the current index size.
+    u32 AcquireRendererVertexIndex(const u32* indexes, const u32 position)
     {
-        if (RendererPrimitiveType != D3DPT_TRIANGLELIST) { RendererRenderScene(); }
-
-        RendererPrimitiveType = D3DPT_TRIANGLELIST;
-
-        for (u32 x = 0; x < count; x++)
+        switch (RendererIndexSize)
         {
-            if (MaximumRendererVertexCount - 3 < State.Data.Vertexes.Count) { RendererRenderScene(); }
-
-            const u16 ia = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 3 + 0)));
-            const u16 ib = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 3 + 1)));
-            const u16 ic = *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 3 + 2)));
-
-            RVX* a = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * ia));
-            RVX* b = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * ib));
-            RVX* c = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * ic));
-
-            if (State.Settings.Cull == RENDERER_CULL_MODE_NONE || ((u32)AcquireNormal((f32x3*)a, (f32x3*)b, (f32x3*)c) & RENDERER_CULL_MODE_COUNTER_CLOCK_WISE) != State.Settings.Cull) { RenderTriangle(a, b, c); }
+        case RENDERER_MODULE_INDEX_SIZE_1: { return ((u8*)indexes)[position]; }
+        case RENDERER_MODULE_INDEX_SIZE_2: { return ((u16*)indexes)[position]; }
+        case RENDERER_MODULE_INDEX_SIZE_8: { return (u32)((u64*)indexes)[position]; }
         }
+
+        return indexes[position];
     }
 
-    // 0x60007e60
-    BOOL RenderTriangleStrips(RVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes)
+    // Acquires the set of the edges of the clip rectangle the vertex is outside of.
+    u32 AcquireRendererClipCode(const f32x3* xyz)
     {
-        if (RendererPrimitiveType != D3DPT_TRIANGLESTRIP) { RendererRenderScene(); }
+        u32 result = RENDERER_CLIP_NONE;
 
-        RendererPrimitiveType = D3DPT_TRIANGLESTRIP;
+        if (xyz->X < State.Clip.Left) { result = result | RENDERER_CLIP_LEFT; }
+        if (State.Clip.Right < xyz->X) { result = result | RENDERER_CLIP_RIGHT; }
+        if (xyz->Y < State.Clip.Top) { result = result | RENDERER_CLIP_TOP; }
+        if (State.Clip.Bottom < xyz->Y) { result = result | RENDERER_CLIP_BOTTOM; }
 
-        if ((MaximumRendererVertexCount - vertexCount + 3) < State.Data.Vertexes.Count) { RendererRenderScene(); }
+        return result;
+    }
 
-        for (u32 x = 0; x < vertexCount; x++)
+    // Acquires the distance of the vertex from the edge of the clip rectangle, positive inside of the rectangle.
+    f32 AcquireRendererClipDistance(const f32x3* xyz, const u32 edge)
+    {
+        switch (edge)
         {
-            // A
-            {
-                RVX* a = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 3 + 0)))));
-
-                RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 0)));
+        case RENDERER_CLIP_LEFT: { return xyz->X - State.Clip.Left; }
+        case RENDERER_CLIP_RIGHT: { return State.Clip.Right - xyz->X; }
+        case RENDERER_CLIP_TOP: { return xyz->Y - State.Clip.Top; }
+        }
 
-                CopyMemory(v, a, RendererVertexSize);
+        return State.Clip.Bottom - xyz->Y;
+    }
 
-                {
-                    RTLVX* vertex = (RTLVX*)v;
+    // Interpolates each of the color channels with the weights of the two colors.
+    u32 InterpolateRendererColor(const u32 a, const u32 b, const f32 wa, const f32 wb)
+    {
+        u32 result = 0;
 
-                    if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        for (u32 x = 0; x < 32; x = x + 8)
+        {
+            const f32 value = (f32)((a >> x) & 0xFF) * wa + (f32)((b >> x) & 0xFF) * wb + 0.5f;
 
-                    if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                    {
-                        vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                    }
+            result = result | ((value < 255.0f ? (0.0f < value ? (u32)value : 0) : 0xFF) << x);
+        }
 
-                    vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-                }
-            }
+        return result;
+    }
 
-            // B
-            {
-                RVX* b = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 3 + 1)))));
+    // Interpolates the vertex between the two vertexes of a clipped edge.
+    // The position and the reciprocal of W are linear in screen space, while the colors and the texture coordinates
+    // are interpolated with perspective correction, same way as the device does across the triangle.
+    void InterpolateRendererVertex(RTLVX* result, const RTLVX* a, const RTLVX* b, const f32 t)
+    {
+        const f32 rhw = a->RHW + (b->RHW - a->RHW) * t;
 
-                RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 1)));
+        const f32 wa = rhw == 0.0f ? (1.0f - t) : (a->RHW * (1.0f - t) / rhw);
+        const f32 wb = 1.0f - wa;
 
-                CopyMemory(v, b, RendererVertexSize);
+        result->XYZ.X = a->XYZ.X + (b->XYZ.X - a->XYZ.X) * t;
+        result->XYZ.Y = a->XYZ.Y + (b->XYZ.Y - a->XYZ.Y) * t;
+        result->XYZ.Z = a->XYZ.Z + (b->XYZ.Z - a->XYZ.Z) * t;
+        result->RHW = rhw;
 
-                {
-                    RTLVX* vertex = (RTLVX*)v;
+        result->Color = InterpolateRendererColor(a->Color, b->Color, wa, wb);
+        result->Specular = InterpolateRendererColor(a->Specular, b->Specular, wa, wb);
 
-                    if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+        result->UV.X = a->UV.X * wa + b->UV.X * wb;
+        result->UV.Y = a->UV.Y * wa + b->UV.Y * wb;
+    }
 
-                    if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                    {
-                        vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                    }
+    // Interpolates the vertex between the two vertexes of a clipped edge, including the second set of the texture coordinates.
+    void InterpolateRendererVertex(RTLVX2* result, const RTLVX2* a, const RTLVX2* b, const f32 t)
+    {
+        InterpolateRendererVertex((RTLVX*)result, (const RTLVX*)a, (const RTLVX*)b, t);
 
-                    vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-                }
-            }
+        const f32 wa = result->RHW == 0.0f ? (1.0f - t) : (a->RHW * (1.0f - t) / result->RHW);
+        const f32 wb = 1.0f - wa;
 
-            // C
-            {
-                RVX* c = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * *(u16*)((addr)indexes + (addr)(RendererIndexSize * (x * 3 + 2)))));
+        result->UV2.X = a->UV2.X * wa + b->UV2.X * wb;
+        result->UV2.Y = a->UV2.Y * wa + b->UV2.Y * wb;
+    }
 
-                RVX* v = (RVX*)((addr)State.Data.Vertexes.Vertexes + (addr)(RendererVertexSize * (State.Data.Vertexes.Count + 2)));
+    // Removes the points outside of the clip rectangle, and acquires the number of the remaining points.
+    u32 ClipRendererPoints(RVX* vertexes, const u32 count)
+    {
+        u32 result = 0;
 
-                CopyMemory(v, c, RendererVertexSize);
+        for (u32 x = 0; x < count; x++)
+        {
+            RVX* v = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * x));
 
-                {
-                    RTLVX* vertex = (RTLVX*)v;
+            if (AcquireRendererClipCode(&((RTLVX*)v)->XYZ) != RENDERER_CLIP_NONE) { continue; }
 
-                    if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+            if (result != x) { CopyMemory((RVX*)((addr)vertexes + (addr)(RendererVertexSize * result)), v, RendererVertexSize); }
 
-                    if (State.Settings.IsFogActive && State.Settings.FogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
-                    {
-                        vertex->Specular = ((u32)RendererFogAlphas[(u32)(vertex->XYZ.Z * 255.0f)]) << 24;
-                    }
+            result = result + 1;
+        }
 
-                    vertex->XYZ.Z = RendererDepthBias + vertex->XYZ.Z;
-                }
-            }
+        return result;
+    }
 
-            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 0] = State.Data.Vertexes.Count + 0;
-            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 1] = State.Data.Vertexes.Count + 1;
-            State.Data.Indexes.Indexes[State.Data.Indexes.Count + 2] = State.Data.Vertexes.Count + 2;
+    // Selects the rectangle the primitives are clipped against on the CPU, the one covering the whole window turns the clipping off.
+    // The vertex offset is applied after the vertexes are clipped, thus the rectangle is shifted the opposite way.
+    void SelectRendererClipRectangle(const u32 x0, const u32 y0, const u32 x1, const u32 y1)
+    {
+        State.Clip.IsActive = x0 != 0 || y0 != 0 || x1 < State.Window.Width || y1 < State.Window.Height;
 
-            State.Data.Indexes.Count = State.Data.Indexes.Count + 3;
-            State.Data.Vertexes.Count = State.Data.Vertexes.Count + 3;
-        }
+        const f32 offset = SettingsState.VertexOffset ? 0.5f : 0.0f;
 
-        return TRUE;
+        State.Clip.Left = (f32)x0 + offset;
+        State.Clip.Top = (f32)y0 + offset;
+        State.Clip.Right = (f32)x1 + offset;
+        State.Clip.Bottom = (f32)y1 + offset;
     }
 }
\ No newline at end of file
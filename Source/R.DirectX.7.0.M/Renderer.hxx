@@ -29,6 +29,9 @@ SOFTWARE.
 #endif
 
 #include "DirectDraw.hxx"
+#include "RendererCompression.hxx"
+#include "RendererMesh.hxx"
+#include "RendererRing.hxx"
 
 #define STATE_INITIAL (-1)
 #define STATE_INACTIVE 0
@@ -44,37 +47,94 @@ SOFTWARE.
 #define DXT_FORMAT_DXT3 3
 #define DXT_FORMAT_NONE 0
 #define ENVIRONMENT_SECTION_NAME "DX7"
+#define INVALID_COMMAND_STATE_INDEX (-1)
 #define INVALID_TEXTURE_FORMAT_COUNT (-1)
 #define INVALID_TEXTURE_FORMAT_INDEX (-1)
+#define INVALID_TEXTURE_HASH 0
+#define INVALID_TEXTURE_POOL_INDEX (-1)
 #define LOCK_NONE 0
 #define LOCK_READ 1
 #define LOCK_WRITE 2
 #define MAX_ACTIVE_SURFACE_COUNT 8
 #define MAX_ACTIVE_UNKNOWN_COUNT 4
 #define MAX_ACTIVE_USABLE_TEXTURE_FORMAT_COUNT 20
+#define MAX_CLIP_VERTEX_COUNT 8
+#define MAX_COMMAND_BUFFER_COUNT 2
+#define MAX_COMMAND_COUNT 4096
+#define MAX_COMMAND_INDEX_COUNT (4 * MAX_LARGE_INDEX_COUNT)
+#define MAX_COMMAND_STATE_COUNT 8
+#define MAX_COMMAND_TEXTURE_COUNT 1024
+#define MAX_COMMAND_TEXTURE_STAGE_COUNT 2
+#define MAX_COMMAND_VERTEX_COUNT (8 * MAX_VERTEX_COUNT)
+#define MAX_CULL_PRIMITIVE_COUNT 256
 #define MAX_DEVICE_CAPABILITIES_COUNT 128 /* ORIGINAL: 98 */
 #define MAX_ENUMERATE_DEVICE_COUNT 60 /* ORIGINAL: 16 */
 #define MAX_ENUMERATE_DEVICE_NAME_COUNT 60 /* ORIGINAL: 10 */
 #define MAX_LARGE_INDEX_COUNT 65536
+#define MAX_MESH_COUNT 256
+#define MAX_MESH_SIZE (16 * 1024 * 1024)
+#define MAX_MESH_VERTEX_COUNT 65535
 #define MAX_OUTPUT_FOG_ALPHA_COUNT 256
 #define MAX_OUTPUT_FOG_ALPHA_VALUE 255
+#define MAX_RENDER_STATE_COUNT 256
+#define MAX_TEXTURE_ATLAS_COUNT 8
+#define MAX_TEXTURE_ATLAS_DIMENSION 512
+#define MAX_TEXTURE_COMPRESSION_ROW_PIXEL_COUNT 4096
+#define MAX_TEXTURE_COMPRESSION_THREAD_COUNT 4
 #define MAX_TEXTURE_DEPTH_FORMAT_COUNT 16 /* ORIGINAL: 6 */
 #define MAX_TEXTURE_FORMAT_COUNT 128 /* ORIGINAL: 32 */
 #define MAX_TEXTURE_PALETTE_COLOR_COUNT 256
+#define MAX_TEXTURE_POOL_SLAB_COUNT 64
+#define MAX_TEXTURE_POOL_SLAB_TEXTURE_COUNT 256
 #define MAX_TEXTURE_STAGE_COUNT 8
+#define MAX_TEXTURE_STAGE_STATE_COUNT 32
 #define MAX_TEXTURE_STATE_STATE_COUNT 120
+#define MAX_THREAD_COMMAND_COUNT 16
 #define MAX_UNKNOWN_COUNT (MAX_ACTIVE_UNKNOWN_COUNT + 2)
 #define MAX_USABLE_TEXTURE_FORMAT_COUNT (MAX_ACTIVE_USABLE_TEXTURE_FORMAT_COUNT + 2)
 #define MAX_USABLE_TEXTURE_FORMAT_INDEX_COUNT 32
 #define MAX_VERTEX_COUNT 32768
 #define MAX_WINDOW_COUNT 65536
+#define MIN_ACTIVE_TEXTURE_CAPACITY 256
 #define MIN_DEVICE_AVAIABLE_VIDEO_MEMORY (16 * 1024 * 1024) /* ORIGINAL: 0x200000 (2 MB) */
+#define MIN_MESH_FRAME_COUNT 3
+#define MIN_MESH_VERTEX_COUNT 32
 #define MIN_WINDOW_INDEX 8
+#define TEXTURE_ATLAS_BORDER_SIZE 1
+
+#define RENDERER_CLIP_NONE                      0x00000000
+#define RENDERER_CLIP_LEFT                      0x00000001
+#define RENDERER_CLIP_RIGHT                     0x00000002
+#define RENDERER_CLIP_TOP                       0x00000004
+#define RENDERER_CLIP_BOTTOM                    0x00000008
 
 #define RENDERER_CULL_MODE_CLOCK_WISE           0x00000000
 #define RENDERER_CULL_MODE_NONE                 0x00000001
 #define RENDERER_CULL_MODE_COUNTER_CLOCK_WISE   0x80000000
 
+#define RENDERER_COMMAND_STATE_ALPHA_BLEND_ENABLE       0
+#define RENDERER_COMMAND_STATE_SOURCE_BLEND             1
+#define RENDERER_COMMAND_STATE_DESTINATION_BLEND        2
+#define RENDERER_COMMAND_STATE_DEPTH_ENABLE             3
+#define RENDERER_COMMAND_STATE_DEPTH_WRITE_ENABLE       4
+#define RENDERER_COMMAND_STATE_DEPTH_FUNCTION           5
+#define RENDERER_COMMAND_STATE_FOG_ENABLE               6
+#define RENDERER_COMMAND_STATE_CULL_MODE                7
+
+#define RENDERER_COMMAND_KEY_TEXTURE_SHIFT              19
+
+#define RENDERER_THREAD_COMMAND_RENDER          0
+#define RENDERER_THREAD_COMMAND_PRESENT         1
+#define RENDERER_THREAD_COMMAND_EXIT            2
+
+#define RENDERER_VERTEX_TRANSFORM_NONE          0x00000000
+#define RENDERER_VERTEX_TRANSFORM_COLOR         0x00000001
+#define RENDERER_VERTEX_TRANSFORM_FOG           0x00000002
+#define RENDERER_VERTEX_TRANSFORM_DEPTH         0x00000004
+#define RENDERER_VERTEX_TRANSFORM_OFFSET        0x00000008
+#define RENDERER_VERTEX_TRANSFORM_RANGE         0x00000010
+#define RENDERER_VERTEX_TRANSFORM_ATLAS         0x00000020
+
 #define RENDERER_INITIALIZE_TEXTURE_DETAILS_OK      1
 #define RENDERER_INITIALIZE_TEXTURE_DETAILS_ERROR   0
 #define RENDERER_INITIALIZE_TEXTURE_DETAILS_INVALID (-1)
@@ -93,8 +153,48 @@ inline void LOGMESSAGE(...) { }
 #define isnan _isnan
 #endif
 
+#if !defined(__WATCOMC__) && _MSC_VER > 1200
+#define RENDERER_MODULE_SIMD
+#include <emmintrin.h>
+#endif
+
 namespace Renderer
 {
+    struct RendererTexture;
+
+    struct RendererTextureCompression
+    {
+        RendererTexture* Texture; // NOTE: NULL when the texture is released, or updated again, before the compression completes.
+
+        u32 Width;
+        u32 Height;
+        u32 Levels;
+
+        u32 Source; // RENDERER_PIXEL_FORMAT_*
+        u32 Destination; // DXT_FORMAT_*
+
+        BOOL IsOpaque; // NOTE: The alpha bit of the R5G5B5 pixels is ignored, when the device format has none.
+
+        u8* Pixels;
+        u8* Blocks;
+
+        RendererTextureCompression* Next;
+    };
+
+    struct RendererTextureAtlas
+    {
+        IDirectDrawSurface7* Texture;
+        s32 FormatIndex;
+
+        u32 Count; // NOTE: The number of the textures packed into the atlas.
+        u32 Size; // NOTE: The size of the atlas texture in the video memory.
+
+        // NOTE: The textures are packed into the rows, the space of the released textures is reused once the atlas is empty.
+        u32 X;
+        u32 Y;
+        u32 Height;
+    };
+
     struct RendererTexture
     {
         s32 Unk00; // TODO
@@ -104,7 +204,6 @@ namespace Renderer
         BOOL IsPalette;
         s32 MipMapCount;
         u32 Stage;
-        RendererTexture* Previous;
         u32 UnknownFormatIndexValue; // TODO
         s32 FormatIndex; // TODO
         u32 MemoryType;
@@ -114,6 +213,26 @@ namespace Renderer
         IDirectDrawPalette* Palette;
         DDSURFACEDESC2 Descriptor;
         u32 Colors;
+
+        BOOL IsCompressed; // NOTE: The pixels are compressed into the block compressed format of the texture on upload.
+        RendererTextureCompression* Compression;
+
+        BOOL IsShareable; // NOTE: The device surface can be shared with the other textures of the same contents.
+        u64 PixelHash;
+        u64 PaletteHash;
+
+        BOOL IsEvictable; // NOTE: The device texture can be evicted from the video memory.
+        u32 Frame; // NOTE: The frame the texture was last selected within.
+        u32 Size; // NOTE: The size of the device texture in the video memory.
+        IDirectDrawSurface7* Backup; // NOTE: The system memory copy of the evicted device texture.
+
+        s32 PoolIndex; // NOTE: The index of the record within the pool of the textures, or INVALID_TEXTURE_POOL_INDEX.
+        s32 PoolNext; // NOTE: The index of the next free record within the pool of the textures.
+        u32 ActiveIndex; // NOTE: The index of the texture within the dense array of the active textures.
+
+        RendererTextureAtlas* Atlas; // NOTE: The atlas the texture is packed into, or NULL when the texture has the device texture of its own.
+        u32 AtlasX;
+        u32 AtlasY;
     };
 }
 
@@ -187,6 +306,116 @@ namespace RendererModule
         BOOL Unk16; // TODO
     };
 
+    struct RendererMesh
+    {
+        u32 Hash[2];
+
+        u32 Type;
+        u32 Transforms;
+
+        BOOL IsOrdered;
+
+        u32 Frame;
+        u32 Frames;
+
+        u32 Size;
+
+        struct
+        {
+            u32 Count;
+
+            IDirect3DVertexBuffer7* Buffer;
+        } Vertexes;
+
+        struct
+        {
+            u32 Count;
+
+            u16* Indexes;
+        } Indexes;
+    };
+
+    struct RendererMeshStatistics
+    {
+        u32 Hits;
+        u32 Misses;
+    };
+
+    struct RendererTextureStatistics
+    {
+        u32 Uploads;
+        u32 Skipped;
+        u32 Evicted;
+        u32 Reloaded;
+        u32 Batched; // NOTE: The number of the texture changes between the textures of the same atlas, that did not break the batch.
+    };
+
+    struct RendererCommand
+    {
+        u32 Key;
+        D3DPRIMITIVETYPE Type;
+
+        RendererMesh* Mesh;
+
+        struct
+        {
+            u32 Offset;
+            u32 Count;
+        } Vertexes;
+
+        struct
+        {
+            u32 Offset;
+            u32 Count;
+        } Indexes;
+    };
+
+    struct RendererCommandState
+    {
+        DWORD States[MAX_COMMAND_STATE_COUNT];
+        IDirectDrawSurface7* Textures[MAX_TEXTURE_STAGE_COUNT];
+    };
+
+    struct RendererCommandStatistics
+    {
+        u32 Recorded;
+        u32 Submitted;
+    };
+
+    struct RendererCommandBuffer
+    {
+        u32 Count;
+
+        RendererCommand Commands[MAX_COMMAND_COUNT];
+
+        struct
+        {
+            u32 Size;
+
+            u32 Vertexes[MAX_COMMAND_VERTEX_COUNT];
+        } Vertexes;
+
+        struct
+        {
+            u32 Count;
+
+            u16 Indexes[MAX_COMMAND_INDEX_COUNT];
+        } Indexes;
+
+        struct
+        {
+            u32 Count;
+
+            IDirectDrawSurface7* Textures[MAX_COMMAND_TEXTURE_COUNT][MAX_COMMAND_TEXTURE_STAGE_COUNT];
+        } Textures;
+    };
+
+    struct RendererThreadCommand
+    {
+        u32 Type;
+        RendererCommandBuffer* Buffer;
+    };
+
     struct RendererModuleWindow
     {
         Renderer::RendererTexture* Texture;
@@ -256,9 +485,106 @@ namespace RendererModule
                 u32 Count; // 0x60058874
 
                 u32 Vertexes[MAX_VERTEX_COUNT]; // 0x60018868
+
+                u32 Processed;
+                u32 Transforms;
             } Vertexes;
         } Data;
 
+        struct
+        {
+            BOOL IsActive;
+
+            u32 Index;
+            RendererCommandBuffer Buffers[MAX_COMMAND_BUFFER_COUNT];
+
+            u64 Order[MAX_COMMAND_COUNT];
+
+            struct
+            {
+                u32 Vertexes[MAX_VERTEX_COUNT];
+
+                u16 Indexes[MAX_LARGE_INDEX_COUNT];
+            } Merge;
+
+            RendererCommandState Current;
+            RendererCommandState Device;
+
+            struct
+            {
+                RendererCommandStatistics Current;
+                RendererCommandStatistics Previous;
+            } Statistics;
+        } Commands;
+
+        struct
+        {
+            BOOL IsActive;
+
+            HANDLE Thread;
+            DWORD ID;
+
+            HANDLE Work;
+            HANDLE Idle;
+
+            RendererRing Ring;
+            RendererThreadCommand Commands[MAX_THREAD_COMMAND_COUNT];
+
+            u32 Submitted;
+        } Thread;
+
+        struct
+        {
+            BOOL IsActive;
+
+            u32 Count;
+            HANDLE Threads[MAX_TEXTURE_COMPRESSION_THREAD_COUNT];
+
+            HANDLE Work;
+            CRITICAL_SECTION Lock;
+
+            Renderer::RendererTextureCompression* Pending;
+            Renderer::RendererTextureCompression* Last;
+            Renderer::RendererTextureCompression* Complete;
+        } Compression;
+
+        struct
+        {
+            u32 Count;
+            u32 Size;
+
+            u32 Frame;
+
+            RendererMesh Meshes[MAX_MESH_COUNT];
+
+            struct
+            {
+                RendererMeshStatistics Current;
+                RendererMeshStatistics Previous;
+            } Statistics;
+        } Meshes;
+
+        struct
+        {
+            BOOL IsActive;
+            BOOL IsInverse;
+            BOOL IsCleared;
+
+            u32 Frame;
+
+            D3DCMPFUNC Function;
+        } DepthRange;
+
+        struct
+        {
+            BOOL IsActive;
+
+            f32 Left;
+            f32 Top;
+            f32 Right;
+            f32 Bottom;
+        } Clip;
+
         struct
         {
             GUID* Identifier; // 0x600186d8
@@ -383,6 +709,23 @@ namespace RendererModule
             BOOL IsActive; // 0x6001822c
         } Scene;
 
+        struct
+        {
+            struct
+            {
+                BOOL IsValid[MAX_RENDER_STATE_COUNT];
+                DWORD Values[MAX_RENDER_STATE_COUNT];
+            } States;
+
+            struct
+            {
+                BOOL IsValid[MAX_TEXTURE_STAGE_COUNT][MAX_TEXTURE_STAGE_STATE_COUNT];
+                DWORD Values[MAX_TEXTURE_STAGE_COUNT][MAX_TEXTURE_STAGE_STATE_COUNT];
+            } Stages;
+
+            u32 Filtered;
+        } Shadow;
+
         struct
         {
             u32 Cull; // 0x60058e1c
@@ -411,10 +754,6 @@ namespace RendererModule
             u32 Count; // 0x60058884
             BOOL Illegal; // 0x60058888
 
-            Renderer::RendererTexture* Current; // 0x60058e2c
-
-            Renderer::RendererTexture* Recent; // 0x60018858
-
             TextureStage Stages[MAX_TEXTURE_STAGE_COUNT]; // 0x6005a940
 
             TextureStageState StageStates[MAX_TEXTURE_STATE_STATE_COUNT]; // 0x6007b8a0
@@ -433,6 +772,45 @@ namespace RendererModule
                     u32 Formats[MAX_TEXTURE_DEPTH_FORMAT_COUNT]; // 0x6007b840
                 } Depth;
             } Formats;
+
+            u32 Frame;
+            u32 Size; // NOTE: The size of the device textures in the video memory.
+
+            struct
+            {
+                u32 Count;
+                Renderer::RendererTexture* Slabs[MAX_TEXTURE_POOL_SLAB_COUNT];
+
+                s32 Free;
+                u32 Available;
+            } Pool;
+
+            struct
+            {
+                u32 Count;
+                u32 Capacity;
+                Renderer::RendererTexture** Textures;
+            } Active;
+
+            struct
+            {
+                Renderer::RendererTextureAtlas Atlases[MAX_TEXTURE_ATLAS_COUNT];
+
+                Renderer::RendererTexture* Current; // NOTE: The packed texture selected into the first stage, or NULL.
+
+                f32x2 Offset;
+                f32x2 Scale;
+
+                // NOTE: The texture address modes of the first stage, the packed textures are only sampled with the clamping.
+                DWORD AddressU;
+                DWORD AddressV;
+            } Atlases;
+
+            struct
+            {
+                RendererTextureStatistics Current;
+                RendererTextureStatistics Previous;
+            } Statistics;
         } Textures;
 
         struct
@@ -474,79 +852,158 @@ namespace RendererModule
     BOOL AcquireRendererDeviceDepthBufferRemovalCapabilities(void);
     BOOL AcquireRendererDeviceState(void);
     BOOL AcquireRendererDeviceTrilinearInterpolationCapabilities(void);
+    BOOL AcquireRendererTextureAtlasPosition(Renderer::RendererTextureAtlas* atlas, const u32 width, const u32 height, u32* x, u32* y);
+    BOOL AttachRendererTexture(Renderer::RendererTexture* tex);
     BOOL BeginRendererScene(void);
+    BOOL CopyRendererTextureLevels(IDirectDrawSurface7* destination, IDirectDrawSurface7* source, const u32 levels);
     BOOL CALLBACK EnumerateDirectDrawDevices(GUID* uid, LPSTR name, LPSTR description, LPVOID context, HMONITOR monitor);
     BOOL EndRendererScene(void);
+    BOOL EvictRendererTexture(Renderer::RendererTexture* tex);
     BOOL InitializeRendererDeviceDepthSurfaces(const u32 width, const u32 height, IDirectDrawSurface7* depth, IDirectDrawSurface7* surf);
+    BOOL InitializeRendererMesh(RendererMesh* mesh, Renderer::RVX* vertexes, const u32* indexes);
+    BOOL InitializeRendererTextureAtlas(Renderer::RendererTextureAtlas* atlas, const s32 format);
+    BOOL InitializeRendererTextureCompression(void);
+    BOOL IsRendererCommandOpaque(const u32 key);
+    BOOL IsRendererTextureAtlasClamped(void);
+    BOOL IsRendererTextureShared(Renderer::RendererTexture* tex);
+    BOOL PackRendererTexture(Renderer::RendererTexture* tex);
+    BOOL ReloadRendererTexture(Renderer::RendererTexture* tex);
     BOOL RenderPoints(Renderer::RVX* vertexes, const u32 count);
+    BOOL RenderRendererMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
     BOOL RenderTriangleFans(Renderer::RVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes);
     BOOL RenderTriangleStrips(Renderer::RVX* vertexes, const u32 vertexCount, const u32 indexCount, const u32* indexes);
     BOOL RestoreRendererSurfaces(void);
+    BOOL SelectRendererDepthFunction(const D3DCMPFUNC function);
+    BOOL SelectRendererDeviceTexture(const u32 stage, IDirectDrawSurface7* surface);
     BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value);
     BOOL SelectRendererTexture(Renderer::RendererTexture* tex);
     BOOL SelectRendererTextureStage(const u32 stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value);
+    BOOL ShareRendererTexture(Renderer::RendererTexture* tex, const u64 hash);
+    BOOL SubmitRendererTextureCompression(Renderer::RendererTexture* tex, const u32* pixels);
+    BOOL UnpackRendererTexture(Renderer::RendererTexture* tex);
+    BOOL UnshareRendererTexture(Renderer::RendererTexture* tex);
     BOOL UpdateRendererTexture(Renderer::RendererTexture* tex, const u32* pixels);
     BOOL UpdateRendererTexture(Renderer::RendererTexture* tex, const u32* pixels, const u32* palette);
     BOOL UpdateRendererTexture(Renderer::RendererTexture* tex, const u32* pixels, const u32* palette, const u32 x, const u32 y, const u32 width, const u32 height, const u32 stride);
+    BOOL UploadRendererTexture(Renderer::RendererTexture* tex, RECT* destination, RECT* source);
+    BOOL UploadRendererTextureCompression(Renderer::RendererTextureCompression* task);
     const char* AcquireRendererMessage(const HRESULT code);
     const char* AcquireRendererMessageDescription(const HRESULT code);
+    DWORD AcquireRendererCommandState(const u32 key, const u32 state);
+    DWORD WINAPI CompressRendererTextureThread(LPVOID);
+    DWORD WINAPI ExecuteRendererThread(LPVOID);
+    f32 AcquireRendererClipDistance(const f32x3* xyz, const u32 edge);
     HRESULT CALLBACK EnumerateDirectDrawAcceleratedDevices(LPSTR description, LPSTR name, LPD3DDEVICEDESC7 desc, LPVOID context);
     HRESULT CALLBACK EnumerateRendererDeviceDepthPixelFormats(LPDDPIXELFORMAT format, LPVOID ctx);
     HRESULT CALLBACK EnumerateRendererDeviceModes(LPDDSURFACEDESC2 desc, LPVOID context);
     HRESULT CALLBACK EnumerateRendererDevicePixelFormats(LPDDPIXELFORMAT format, LPVOID context);
     HRESULT CALLBACK EnumerateRendererDeviceTextureFormats(LPDDPIXELFORMAT format, LPVOID context);
+    inline u32 AcquireFogAlphaIndex(const f32 z) { const f32 value = z * 255.0f; return 0.0f < value ? (value < MAX_OUTPUT_FOG_ALPHA_VALUE ? (u32)value : MAX_OUTPUT_FOG_ALPHA_VALUE) : 0; }
     inline u32 AcquireNormal(const f32x3* a, const f32x3* b, const f32x3* c) { const s32 value = (s32)((b->X - a->X) * (c->Y - a->Y) - (c->X - a->X) * (b->Y - a->Y)); return *(u32*)&value; }
+    inline u32 AcquireRendererTextureCompressionPixelSize(const u32 format) { return format == RENDERER_PIXEL_FORMAT_A8R8G8B8 ? sizeof(u32) : sizeof(u16); }
+    Renderer::RendererTexture* AcquireRendererTextureEviction(Renderer::RendererTexture* keep);
+    Renderer::RendererTexture* AcquireRendererTexturePoolRecord(void);
     Renderer::RendererTexture* AllocateRendererTexture(const u32 size);
     Renderer::RendererTexture* AllocateRendererTexture(const u32 width, const u32 height, const u32 format, const BOOL palette, const u32 state, const BOOL destination);
     Renderer::RendererTexture* InitializeRendererTexture(void);
+    RendererMesh* AcquireRendererMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
     RendererModuleWindowLock* RendererLock(const u32 mode);
+    s32 AcquireRendererCommandStateIndex(const D3DRENDERSTATETYPE type);
     s32 AcquireRendererDeviceTextureFormatIndex(const u32 palette, const u32 alpha, const u32 red, const u32 green, const u32 blue, const u32 dxtf, const u32 dxtt);
     s32 AcquireSettingsValue(const s32 value, const char* section, const char* name);
     s32 AcquireTextureStateStageIndex(const u32 state);
+    s32 CompareRendererCommands(const void* a, const void* b);
     s32 InitializeRendererTextureDetails(Renderer::RendererTexture* tex, const BOOL destination);
     u32 AcquireDirectDrawDeviceCount(GUID** uids, HMONITOR** monitors, const char* section);
     u32 AcquirePixelFormat(const DDPIXELFORMAT* format);
+    u32 AcquireRendererClipCode(const f32x3* xyz);
+    u32 AcquireRendererCommandKey(void);
     u32 AcquireRendererDeviceCount(void);
+    u32 AcquireRendererTextureCompressionFormat(const u32 width, const u32 height, const u32 format);
+    u32 AcquireRendererTextureMemorySize(Renderer::RendererTexture* tex);
+    u32 AcquireRendererTextureSize(Renderer::RendererTexture* tex);
+    u32 AcquireRendererTriangleCount(const u32 count);
+    u32 AcquireRendererVertexIndex(const u32* indexes, const u32 position);
     u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1, const BOOL window);
+    u32 ClipRendererPoints(Renderer::RVX* vertexes, const u32 count);
     u32 DisposeRendererTexture(Renderer::RendererTexture* tex);
     u32 InitializeRendererDevice(void);
+    u32 InterpolateRendererColor(const u32 a, const u32 b, const f32 wa, const f32 wb);
     u32 InitializeRendererDeviceAcceleration(void);
     u32 InitializeRendererDeviceLambdas(void);
     u32 ReleaseRendererDeviceInstance(void);
     u32 ReleaseRendererWindow(void);
+    u32 RenderRendererCommandBuffer(RendererCommandBuffer* buffer);
     u32 SelectBasicRendererState(const u32 state, void* value);
     u32 SelectRendererTransforms(const f32 zNear, const f32 zFar);
     u32 STDCALLAPI InitializeRendererDeviceExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result);
     u32 STDCALLAPI InitializeRendererDeviceSurfacesExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result);
     u32 STDCALLAPI ReleaseRendererDeviceExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result);
     u32 ToggleRenderer(void);
+    u64 AcquireRendererTextureHash(const void* data, const u32 size);
     void AcquireRendererDeviceCapabilities(void);
     void AcquireRendererDeviceTextureFormats(void);
     void AcquireRendererModuleDescriptor(RendererModuleDescriptor* desc, const char* section);
     void AcquireWindowModeCapabilities(void);
+    void AppendRendererClippedLine(Renderer::RVX* a, Renderer::RVX* b);
+    void AppendRendererClippedTriangle(Renderer::RVX* a, Renderer::RVX* b, Renderer::RVX* c);
+    void AppendRendererCommand(void);
+    void AppendRendererMeshCommand(RendererMesh* mesh);
+    void AppendRendererTriangles(const D3DPRIMITIVETYPE type, const u32 count, Renderer::RVX* vertexes, const u32* indexes);
     void AttemptRenderScene(void);
+    void CancelRendererTextureCompression(Renderer::RendererTexture* tex);
+    void CommitRendererFrame(void);
+    void CommitRendererTextureCompressions(void);
+    void CompressRendererTexture(Renderer::RendererTextureCompression* task);
+    void DetachRendererTexture(Renderer::RendererTexture* tex);
+    void DisposeRendererTextureCompression(Renderer::RendererTextureCompression* task);
+    void EncodeRendererTextureBlocks(const u32 format, const u32* pixels, const u32 count, u8* blocks);
+    void EvictRendererTextures(const u32 size, Renderer::RendererTexture* keep);
     void InitializeConcreteRendererDevice(void);
+    void InitializeRendererCommands(void);
     void InitializeRendererModuleState(const u32 mode, const u32 pending, const u32 depth, const char* section);
+    void InitializeRendererShadowStates(void);
     void InitializeRendererState(void);
+    void InitializeRendererThread(void);
     void InitializeRenderState55(void); // TODO
     void InitializeTextureStateStates(void);
-    void InitializeVertexes(Renderer::RVX* vertexes, const u32 count);
     void InitializeViewPort(void);
+    void InterpolateRendererVertex(Renderer::RTLVX* result, const Renderer::RTLVX* a, const Renderer::RTLVX* b, const f32 t);
+    void InterpolateRendererVertex(Renderer::RTLVX2* result, const Renderer::RTLVX2* a, const Renderer::RTLVX2* b, const f32 t);
     void ReleaseRendererDevice(void);
+    void ReleaseRendererMesh(RendererMesh* mesh);
+    void ReleaseRendererMeshes(void);
     void ReleaseRendererDeviceSurfaces(void);
     void ReleaseRendererTexture(Renderer::RendererTexture* tex);
+    void ReleaseRendererTextureAtlas(Renderer::RendererTexture* tex);
+    void ReleaseRendererTextureAtlases(void);
+    void ReleaseRendererTextureCompression(void);
+    void ReleaseRendererTexturePool(void);
+    void ReleaseRendererThread(void);
     void ReleaseRendererWindows(void);
     void RendererRenderScene(void);
     void RenderLine(Renderer::RVX* a, Renderer::RVX* b);
     void RenderLineMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
     void RenderQuad(Renderer::RVX* a, Renderer::RVX* b, Renderer::RVX* c, Renderer::RVX* d);
     void RenderQuadMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
+    void RenderRendererCommands(void);
     void RenderTriangle(Renderer::RVX* a, Renderer::RVX* b, Renderer::RVX* c);
     void RenderTriangleMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
+    void SelectRendererClipRectangle(const u32 x0, const u32 y0, const u32 x1, const u32 y1);
+    void SelectRendererCommandState(const DWORD* states, IDirectDrawSurface7** textures);
+    void SelectRendererDepthRange(const BOOL active, const BOOL inverse);
     void SelectRendererDevice(void);
     void SelectRendererDeviceType(const u32 type);
     void SelectRendererFogAlphas(const u8* input, u8* output);
     void SelectRendererMaterial(const u32 color);
     void SelectRendererStateValue(const u32 state, void* value);
+    void SelectRendererTextureAtlas(Renderer::RendererTexture* tex);
     void SelectRendererVertexCount(void);
+    void SelectRendererVertexTransforms(void);
+    void SubmitRendererCommands(const u32 type);
+    void SubmitRendererThreadCommand(const u32 type, RendererCommandBuffer* buffer);
+    void UpdateRendererVertexes(void);
+    void UpdateVertexes(Renderer::RVX* vertexes, const u32 count, const u32 transforms);
+    void WaitRendererTextureCompression(Renderer::RendererTexture* tex);
+    void WaitRendererThread(void);
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Mathematics.Basic.hxx"
+#include "RendererCompression.hxx"
+
+#include <string.h>
+
+using namespace Mathematics;
+
+namespace RendererModule
+{
+    // Encodes the 4x4 pixels into the colors of the block.
+    // NOTE: The end points are the extremes of the pixels along the principal axis of their colors, inset by a sixteenth of their range.
+    // The pixels with the alpha below a half are encoded as the transparent black of DXT1 blocks.
+    void EncodeRendererTextureColors(const u32* pixels, u8* block, const BOOL transparent)
+    {
+        u32 alphas = 0;
+        u32 count = 0;
+
+        s32 mins[3] = { 0xFF, 0xFF, 0xFF };
+        s32 maxs[3] = { 0, 0, 0 };
+        s32 sums[3] = { 0, 0, 0 };
+
+        for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x++)
+        {
+            if (transparent && (pixels[x] >> 24) < 0x80) { alphas = alphas | (1 << x); continue; }
+
+            for (u32 xx = 0; xx < 3; xx++)
+            {
+                const s32 value = (pixels[x] >> (16 - 8 * xx)) & 0xFF;
+
+                mins[xx] = Min(mins[xx], value);
+                maxs[xx] = Max(maxs[xx], value);
+                sums[xx] = sums[xx] + value;
+            }
+
+            count = count + 1;
+        }
+
+        if (count == 0)
+        {
+            memset(block, 0, 4);
+
+            block[4] = 0xFF;
+            block[5] = 0xFF;
+            block[6] = 0xFF;
+            block[7] = 0xFF;
+
+            return;
+        }
+
+        // The principal axis is approximated by a few iterations of the power method over the covariance of the colors.
+        f32 covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x++)
+        {
+            if (alphas & (1 << x)) { continue; }
+
+            const f32 r = (f32)((pixels[x] >> 16) & 0xFF) - (f32)sums[0] / (f32)count;
+            const f32 g = (f32)((pixels[x] >> 8) & 0xFF) - (f32)sums[1] / (f32)count;
+            const f32 b = (f32)(pixels[x] & 0xFF) - (f32)sums[2] / (f32)count;
+
+            covariance[0] = covariance[0] + r * r;
+            covariance[1] = covariance[1] + r * g;
+            covariance[2] = covariance[2] + r * b;
+            covariance[3] = covariance[3] + g * g;
+            covariance[4] = covariance[4] + g * b;
+            covariance[5] = covariance[5] + b * b;
+        }
+
+        f32 axis[3] = { (f32)(maxs[0] - mins[0]), (f32)(maxs[1] - mins[1]), (f32)(maxs[2] - mins[2]) };
+
+        for (u32 x = 0; x < 4; x++)
+        {
+            const f32 r = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+            const f32 g = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+            const f32 b = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+
+            const f32 length = Max(Max(Max(r, -r), Max(g, -g)), Max(b, -b));
+
+            if (length == 0.0f) { break; }
+
+            axis[0] = r / length;
+            axis[1] = g / length;
+            axis[2] = b / length;
+        }
+
+        u32 first = 0;
+        u32 last = 0;
+
+        {
+            f32 minimum = 0.0f;
+            f32 maximum = 0.0f;
+
+            BOOL isInit = FALSE;
+
+            for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x++)
+            {
+                if (alphas & (1 << x)) { continue; }
+
+                const f32 value = axis[0] * (f32)((pixels[x] >> 16) & 0xFF)
+                    + axis[1] * (f32)((pixels[x] >> 8) & 0xFF) + axis[2] * (f32)(pixels[x] & 0xFF);
+
+                if (!isInit || value < minimum) { minimum = value; last = pixels[x]; }
+                if (!isInit || maximum < value) { maximum = value; first = pixels[x]; }
+
+                isInit = TRUE;
+            }
+        }
+
+        u32 color1 = 0;
+        u32 color2 = 0;
+
+        for (u32 x = 0; x < 3; x++)
+        {
+            const u32 bits = x == 1 ? 6 : 5;
+
+            const s32 v1 = (first >> (16 - 8 * x)) & 0xFF;
+            const s32 v2 = (last >> (16 - 8 * x)) & 0xFF;
+
+            const s32 inset = (v1 - v2) / 16;
+
+            color1 = (color1 << bits) | ReduceRendererTextureChannel(v1 - inset, bits);
+            color2 = (color2 << bits) | ReduceRendererTextureChannel(v2 + inset, bits);
+        }
+
+        // The transparent pixels require the first color not greater than the second one, while the rest require the opposite.
+        if (alphas != 0 ? color2 < color1 : color1 < color2)
+        {
+            const u32 value = color1;
+
+            color1 = color2;
+            color2 = value;
+        }
+
+        const BOOL isOpaque = !transparent || color2 < color1;
+
+        u32 colors[4];
+
+        {
+            const u32 r1 = (((color1 >> 11) & 0x1F) << 3) | (((color1 >> 11) & 0x1F) >> 2);
+            const u32 g1 = (((color1 >> 5) & 0x3F) << 2) | (((color1 >> 5) & 0x3F) >> 4);
+            const u32 b1 = ((color1 & 0x1F) << 3) | ((color1 & 0x1F) >> 2);
+
+            const u32 r2 = (((color2 >> 11) & 0x1F) << 3) | (((color2 >> 11) & 0x1F) >> 2);
+            const u32 g2 = (((color2 >> 5) & 0x3F) << 2) | (((color2 >> 5) & 0x3F) >> 4);
+            const u32 b2 = ((color2 & 0x1F) << 3) | ((color2 & 0x1F) >> 2);
+
+            colors[0] = (r1 << 16) | (g1 << 8) | b1;
+            colors[1] = (r2 << 16) | (g2 << 8) | b2;
+
+            if (isOpaque)
+            {
+                colors[2] = (((2 * r1 + r2 + 1) / 3) << 16) | (((2 * g1 + g2 + 1) / 3) << 8) | ((2 * b1 + b2 + 1) / 3);
+                colors[3] = (((r1 + 2 * r2 + 1) / 3) << 16) | (((g1 + 2 * g2 + 1) / 3) << 8) | ((b1 + 2 * b2 + 1) / 3);
+            }
+            else
+            {
+                colors[2] = (((r1 + r2 + 1) >> 1) << 16) | (((g1 + g2 + 1) >> 1) << 8) | ((b1 + b2 + 1) >> 1);
+                colors[3] = 0;
+            }
+        }
+
+        // The last color of the blocks with the transparent black is not used for the opaque pixels.
+        const u32 length = isOpaque ? 4 : 3;
+
+        u32 indexes[RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT];
+
+#ifdef RENDERER_MODULE_SIMD
+        {
+            // NOTE: The pixels are kept in 16-bit lanes as B, G, R, A of two pixels per register,
+            // so that the squared distances of four pixels to each of the colors are computed at once.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mask = _mm_set1_epi32(0x00FFFFFF);
+
+            __m128i values[4];
+
+            for (u32 x = 0; x < length; x++)
+            {
+                values[x] = _mm_unpacklo_epi8(_mm_set1_epi32((s32)colors[x]), zero);
+            }
+
+            for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x = x + 4)
+            {
+                const __m128i px = _mm_and_si128(_mm_loadu_si128((__m128i*)&pixels[x]), mask);
+
+                const __m128i lo = _mm_unpacklo_epi8(px, zero);
+                const __m128i hi = _mm_unpackhi_epi8(px, zero);
+
+                __m128i best = _mm_setzero_si128();
+                __m128i result = _mm_setzero_si128();
+
+                for (u32 xx = 0; xx < length; xx++)
+                {
+                    const __m128i dl = _mm_sub_epi16(lo, values[xx]);
+                    const __m128i dh = _mm_sub_epi16(hi, values[xx]);
+
+                    const __m128i sl = _mm_madd_epi16(dl, dl);
+                    const __m128i sh = _mm_madd_epi16(dh, dh);
+
+                    const __m128i tl = _mm_shuffle_epi32(_mm_add_epi32(sl, _mm_srli_epi64(sl, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+                    const __m128i th = _mm_shuffle_epi32(_mm_add_epi32(sh, _mm_srli_epi64(sh, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+
+                    const __m128i distance = _mm_unpacklo_epi64(tl, th);
+
+                    if (xx == 0) { best = distance; continue; }
+
+                    const __m128i less = _mm_cmplt_epi32(distance, best);
+
+                    best = _mm_or_si128(_mm_and_si128(less, distance), _mm_andnot_si128(less, best));
+                    result = _mm_or_si128(_mm_and_si128(less, _mm_set1_epi32(xx)), _mm_andnot_si128(less, result));
+                }
+
+                _mm_storeu_si128((__m128i*)&indexes[x], result);
+            }
+        }
+#else
+        for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x++)
+        {
+            const s32 r = (pixels[x] >> 16) & 0xFF;
+            const s32 g = (pixels[x] >> 8) & 0xFF;
+            const s32 b = pixels[x] & 0xFF;
+
+            s32 best = 0;
+
+            indexes[x] = 0;
+
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                const s32 dr = r - (s32)((colors[xx] >> 16) & 0xFF);
+                const s32 dg = g - (s32)((colors[xx] >> 8) & 0xFF);
+                const s32 db = b - (s32)(colors[xx] & 0xFF);
+
+                const s32 distance = dr * dr + dg * dg + db * db;
+
+                if (xx == 0 || distance < best)
+                {
+                    best = distance;
+                    indexes[x] = xx;
+                }
+            }
+        }
+#endif
+
+        u32 value = 0;
+
+        for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x++)
+        {
+            value = value | (((alphas & (1 << x)) ? 3 : indexes[x]) << (2 * x));
+        }
+
+        block[0] = (u8)(color1 & 0xFF);
+        block[1] = (u8)(color1 >> 8);
+        block[2] = (u8)(color2 & 0xFF);
+        block[3] = (u8)(color2 >> 8);
+        block[4] = (u8)(value & 0xFF);
+        block[5] = (u8)((value >> 8) & 0xFF);
+        block[6] = (u8)((value >> 16) & 0xFF);
+        block[7] = (u8)(value >> 24);
+    }
+
+    // Encodes the alphas of the 4x4 pixels into the explicit 4-bit alphas of DXT3 blocks.
+    void EncodeRendererTextureAlphas(const u32* pixels, u8* block)
+    {
+        for (u32 x = 0; x < RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION; x++)
+        {
+            u32 alphas = 0;
+
+            for (u32 xx = 0; xx < RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION; xx++)
+            {
+                alphas = alphas | (ReduceRendererTextureChannel(pixels[x * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION + xx] >> 24, 4) << (4 * xx));
+            }
+
+            block[2 * x + 0] = (u8)(alphas & 0xFF);
+            block[2 * x + 1] = (u8)(alphas >> 8);
+        }
+    }
+}
\ No newline at end of file
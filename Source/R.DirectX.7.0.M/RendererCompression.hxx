@@ -0,0 +1,42 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Basic.hxx"
+
+#if !defined(RENDERER_MODULE_NO_SIMD) && !defined(__WATCOMC__) && (_MSC_VER > 1200 || defined(__SSE2__))
+#ifndef RENDERER_MODULE_SIMD
+#define RENDERER_MODULE_SIMD
+#endif
+#include <emmintrin.h>
+#endif
+
+#define RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION 4
+#define RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT (RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION)
+
+namespace RendererModule
+{
+    inline u32 ReduceRendererTextureChannel(const u32 value, const u32 bits) { const u32 result = value * ((1 << bits) - 1) + 128; return (result + (result >> 8)) >> 8; }
+    void EncodeRendererTextureAlphas(const u32* pixels, u8* block);
+    void EncodeRendererTextureColors(const u32* pixels, u8* block, const BOOL transparent);
+}
\ No newline at end of file
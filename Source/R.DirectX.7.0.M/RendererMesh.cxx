@@ -0,0 +1,205 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RendererMesh.hxx"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace RendererModule
+{
+    // Calculates the score of the vertex from its position in the simulated cache, and the number of its triangles not yet added.
+    // The vertexes of the most recent triangle are scored equally, so that the triangle is not favored just for being the last one.
+    f32 AcquireRendererMeshVertexScore(const s32 position, const u32 remaining)
+    {
+        if (remaining == 0) { return -1.0f; }
+
+        f32 score = 0.0f;
+
+        if (position >= 0)
+        {
+            if (position < 3) { score = 0.75f; }
+            else { score = (f32)pow(1.0f - (f32)(position - 3) / (f32)(MAX_MESH_VERTEX_CACHE_SIZE - 3), 1.5); }
+        }
+
+        return score + 2.0f / (f32)sqrt((f32)remaining);
+    }
+
+    // Reorders the triangles of the mesh for the post-transform vertex cache of the device, following the linear-speed
+    // vertex cache optimization by Tom Forsyth: the triangle with the best score among the ones using the cached vertexes is added next.
+    // The triangles keep their winding. Returns FALSE when out of memory, leaving the indexes intact.
+    BOOL OptimizeRendererMeshIndexes(u16* indexes, const u32 count, const u32 vertexCount)
+    {
+        const u32 triangles = count / 3;
+
+        u8* memory = (u8*)malloc(vertexCount * (3 * sizeof(u32) + sizeof(f32)) + count * (sizeof(u32) + sizeof(u16)) + triangles * (sizeof(f32) + sizeof(u8)));
+
+        if (memory == NULL) { return FALSE; }
+
+        u32* offsets = (u32*)memory;
+        u32* remaining = (u32*)((addr)offsets + (addr)(vertexCount * sizeof(u32)));
+        s32* positions = (s32*)((addr)remaining + (addr)(vertexCount * sizeof(u32)));
+        f32* scores = (f32*)((addr)positions + (addr)(vertexCount * sizeof(s32)));
+        u32* adjacency = (u32*)((addr)scores + (addr)(vertexCount * sizeof(f32)));
+        f32* triangleScores = (f32*)((addr)adjacency + (addr)(count * sizeof(u32)));
+        u16* output = (u16*)((addr)triangleScores + (addr)(triangles * sizeof(f32)));
+        u8* added = (u8*)((addr)output + (addr)(count * sizeof(u16)));
+
+        memset(remaining, 0, vertexCount * sizeof(u32));
+        memset(added, 0, triangles * sizeof(u8));
+
+        for (u32 x = 0; x < count; x++) { remaining[indexes[x]] = remaining[indexes[x]] + 1; }
+
+        {
+            u32 offset = 0;
+
+            for (u32 x = 0; x < vertexCount; x++)
+            {
+                offsets[x] = offset;
+                offset = offset + remaining[x];
+
+                remaining[x] = 0;
+            }
+        }
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 indx = indexes[x];
+
+            adjacency[offsets[indx] + remaining[indx]] = x / 3;
+
+            remaining[indx] = remaining[indx] + 1;
+        }
+
+        for (u32 x = 0; x < vertexCount; x++)
+        {
+            positions[x] = -1;
+            scores[x] = AcquireRendererMeshVertexScore(-1, remaining[x]);
+        }
+
+        for (u32 x = 0; x < triangles; x++)
+        {
+            triangleScores[x] = scores[indexes[x * 3 + 0]] + scores[indexes[x * 3 + 1]] + scores[indexes[x * 3 + 2]];
+        }
+
+        u32 cache[MAX_MESH_VERTEX_CACHE_SIZE + 3];
+        u32 length = 0;
+
+        s32 best = -1;
+        u32 start = 0;
+
+        for (u32 x = 0; x < triangles; x++)
+        {
+            if (best < 0)
+            {
+                // Pick the best of the remaining triangles, when none of the vertexes in the cache has any triangles left.
+                while (added[start]) { start = start + 1; }
+
+                best = start;
+
+                for (u32 xx = start + 1; xx < triangles; xx++)
+                {
+                    if (!added[xx] && triangleScores[best] < triangleScores[xx]) { best = xx; }
+                }
+            }
+
+            const u16* triangle = &indexes[best * 3];
+
+            output[x * 3 + 0] = triangle[0];
+            output[x * 3 + 1] = triangle[1];
+            output[x * 3 + 2] = triangle[2];
+
+            added[best] = TRUE;
+
+            for (u32 xx = 0; xx < 3; xx++)
+            {
+                const u32 indx = triangle[xx];
+
+                u32* items = &adjacency[offsets[indx]];
+
+                for (u32 i = 0; i < remaining[indx]; i++)
+                {
+                    if (items[i] == (u32)best)
+                    {
+                        items[i] = items[remaining[indx] - 1]; break;
+                    }
+                }
+
+                remaining[indx] = remaining[indx] - 1;
+            }
+
+            u32 values[MAX_MESH_VERTEX_CACHE_SIZE + 3];
+
+            values[0] = triangle[0];
+            values[1] = triangle[1];
+            values[2] = triangle[2];
+
+            u32 size = 3;
+
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                if (cache[xx] != triangle[0] && cache[xx] != triangle[1] && cache[xx] != triangle[2])
+                {
+                    values[size] = cache[xx];
+
+                    size = size + 1;
+                }
+            }
+
+            for (u32 xx = 0; xx < size; xx++)
+            {
+                const u32 indx = values[xx];
+
+                positions[indx] = xx < MAX_MESH_VERTEX_CACHE_SIZE ? (s32)xx : -1;
+                scores[indx] = AcquireRendererMeshVertexScore(positions[indx], remaining[indx]);
+            }
+
+            best = -1;
+
+            for (u32 xx = 0; xx < size; xx++)
+            {
+                const u32 indx = values[xx];
+                const u32* items = &adjacency[offsets[indx]];
+
+                for (u32 i = 0; i < remaining[indx]; i++)
+                {
+                    const u32 t = items[i];
+
+                    triangleScores[t] = scores[indexes[t * 3 + 0]] + scores[indexes[t * 3 + 1]] + scores[indexes[t * 3 + 2]];
+
+                    if (best < 0 || triangleScores[best] < triangleScores[t]) { best = t; }
+                }
+            }
+
+            length = size < MAX_MESH_VERTEX_CACHE_SIZE ? size : MAX_MESH_VERTEX_CACHE_SIZE;
+
+            memcpy(cache, values, length * sizeof(u32));
+        }
+
+        memcpy(indexes, output, count * sizeof(u16));
+
+        free(memory);
+
+        return TRUE;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RendererRing.hxx"
+
+#ifdef _WIN32
+#include "Native.Basic.hxx"
+#endif
+
+namespace RendererModule
+{
+    // Reads the position advanced by the other side of the ring, the slot contents it published are visible afterwards.
+    inline u32 AcquireRendererRingPosition(volatile u32* position)
+    {
+#ifdef _WIN32
+        return (u32)InterlockedCompareExchange((volatile LONG*)position, 0, 0);
+#else
+        return __atomic_load_n(position, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    // Advances the position of this side of the ring, after the slot contents are complete.
+    inline void CommitRendererRingPosition(volatile u32* position, const u32 value)
+    {
+#ifdef _WIN32
+        InterlockedExchange((volatile LONG*)position, (LONG)value);
+#else
+        __atomic_store_n(position, value, __ATOMIC_RELEASE);
+#endif
+    }
+
+    BOOL IsRendererRingEmpty(RendererRing* ring)
+    {
+        return AcquireRendererRingPosition(&ring->Read) == AcquireRendererRingPosition(&ring->Write);
+    }
+
+    // NOTE: Called by the producer only.
+    BOOL IsRendererRingFull(RendererRing* ring)
+    {
+        return (u32)(ring->Write - AcquireRendererRingPosition(&ring->Read)) == ring->Count;
+    }
+
+    // NOTE: Called by the consumer only, once the ring is not empty.
+    u32 AcquireRendererRingRead(RendererRing* ring)
+    {
+        return ring->Read & (ring->Count - 1);
+    }
+
+    // NOTE: Called by the producer only, once the ring is not full.
+    u32 AcquireRendererRingWrite(RendererRing* ring)
+    {
+        return ring->Write & (ring->Count - 1);
+    }
+
+    // Releases the slot read by the consumer back to the producer.
+    void CommitRendererRingRead(RendererRing* ring)
+    {
+        CommitRendererRingPosition(&ring->Read, ring->Read + 1);
+    }
+
+    // Publishes the slot written by the producer to the consumer.
+    void CommitRendererRingWrite(RendererRing* ring)
+    {
+        CommitRendererRingPosition(&ring->Write, ring->Write + 1);
+    }
+
+    void InitializeRendererRing(RendererRing* ring, const u32 count)
+    {
+        ring->Read = 0;
+        ring->Write = 0;
+
+        ring->Count = count;
+    }
+}
@@ -0,0 +1,47 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Basic.hxx"
+
+namespace RendererModule
+{
+    // NOTE: The single producer, single consumer ring of the slot indexes.
+    // The producer is the only one to advance the write position, while the consumer is the only one to advance the read position.
+    // The positions grow without bounds, and wrap around the number of the slots, which has to be a power of two.
+    struct RendererRing
+    {
+        volatile u32 Read;
+        volatile u32 Write;
+
+        u32 Count;
+    };
+
+    BOOL IsRendererRingEmpty(RendererRing* ring);
+    BOOL IsRendererRingFull(RendererRing* ring);
+    u32 AcquireRendererRingRead(RendererRing* ring);
+    u32 AcquireRendererRingWrite(RendererRing* ring);
+    void CommitRendererRingRead(RendererRing* ring);
+    void CommitRendererRingWrite(RendererRing* ring);
+    void InitializeRendererRing(RendererRing* ring, const u32 count);
+}
@@ -62,6 +62,25 @@ namespace RendererModuleValues
 
     u8 RendererFogAlphas[MAX_OUTPUT_FOG_ALPHA_COUNT];
 
+    D3DRENDERSTATETYPE RendererCommandStates[MAX_COMMAND_STATE_COUNT] =
+    {
+        D3DRENDERSTATE_ALPHABLENDENABLE,
+        D3DRENDERSTATE_SRCBLEND,
+        D3DRENDERSTATE_DESTBLEND,
+        D3DRENDERSTATE_ZENABLE,
+        D3DRENDERSTATE_ZWRITEENABLE,
+        D3DRENDERSTATE_ZFUNC,
+        D3DRENDERSTATE_FOGENABLE,
+        D3DRENDERSTATE_CULLMODE
+    };
+
+    // NOTE: Number of bits each of the command states occupies in the command key,
+    // the texture ordinal takes the remaining upper bits, see RENDERER_COMMAND_KEY_TEXTURE_SHIFT.
+    u32 RendererCommandStateBits[MAX_COMMAND_STATE_COUNT] =
+    {
+        1, 4, 4, 2, 1, 4, 1, 2
+    };
+
     RendererModule::MinMax MinMax[6] =
     {
         { 0x0,   0x4a },
@@ -63,6 +63,9 @@ namespace RendererModuleValues
 
     extern u8 RendererFogAlphas[MAX_OUTPUT_FOG_ALPHA_COUNT]; // 0x60018740
 
+    extern D3DRENDERSTATETYPE RendererCommandStates[MAX_COMMAND_STATE_COUNT];
+    extern u32 RendererCommandStateBits[MAX_COMMAND_STATE_COUNT];
+
     extern RendererModule::MinMax MinMax[6]; // 0x60017088 // TODO
 
     extern RendererModule::RendererModuleDescriptor2 ModuleDescriptor; // 0x600fc7c0
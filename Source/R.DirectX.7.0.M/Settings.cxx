@@ -39,9 +39,25 @@ namespace Settings
     {
         SettingsState.Accelerate = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
             RENDERER_MODULE_SETTINGS_ACCELERATE_GRAPHICS_PROPERTY_NAME, FALSE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.DepthClearInterval = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_DEPTH_CLEAR_INTERVAL_PROPERTY_NAME, 1, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.DrawSorting = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_DRAW_SORTING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
         SettingsState.FlatShading = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
             RENDERER_MODULE_SETTINGS_FLAT_SHADING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.GeometryCache = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_GEOMETRY_CACHE_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.RenderThread = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_RENDER_THREAD_PROPERTY_NAME, FALSE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureAtlas = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_ATLAS_PROPERTY_NAME, 64, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureCompression = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_COMPRESSION_PROPERTY_NAME, FALSE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureDeduplication = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_DEDUPLICATION_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
         SettingsState.VertexOffset = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
             RENDERER_MODULE_SETTINGS_VERTEX_OFFSET_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.ViewPortClipping = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX7_NAME,
+            RENDERER_MODULE_SETTINGS_VIEWPORT_CLIPPING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
     }
 }
\ No newline at end of file
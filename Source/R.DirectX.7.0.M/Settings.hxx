@@ -29,8 +29,16 @@ namespace Settings
     struct SettingsContainer
     {
         BOOL Accelerate;
+        u32 DepthClearInterval;
+        BOOL DrawSorting;
         BOOL FlatShading;
+        BOOL GeometryCache;
+        BOOL RenderThread;
+        u32 TextureAtlas;
+        BOOL TextureCompression;
+        BOOL TextureDeduplication;
         BOOL VertexOffset;
+        BOOL ViewPortClipping;
     };
 
     extern SettingsContainer SettingsState;
@@ -0,0 +1,1226 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Graphics.Basic.hxx"
+#include "ImagePixels.hxx"
+#include "Mathematics.Basic.hxx"
+
+#include <string.h>
+
+using namespace Mathematics;
+
+namespace Images
+{
+    ImageChannelLayout ImageR5G6B5Layout = { 0, 0, 11, 5, 5, 6, 0, 5 };
+    ImageChannelLayout ImageX1R5G5B5Layout = { 15, 0, 10, 5, 5, 5, 0, 5 };
+    ImageChannelLayout ImageA1R5G5B5Layout = { 15, 1, 10, 5, 5, 5, 0, 5 };
+    ImageChannelLayout ImageA4R4G4B4Layout = { 12, 4, 8, 4, 4, 4, 0, 4 };
+    ImageChannelLayout ImageX4R4G4B4Layout = { 12, 0, 8, 4, 4, 4, 0, 4 };
+    ImageChannelLayout ImageA8R3G3B2Layout = { 8, 8, 5, 3, 2, 3, 0, 2 };
+
+    // Decodes the colors of the block into the 4x4 pixels.
+    // NOTE: The colors of DXT1 blocks with the first color not greater than the second one
+    // are the two end points, the middle point, and the transparent black.
+    void DecodeImageDXTColors(const u8* block, u32* pixels, const u32 stride, const BOOL transparent)
+    {
+        const u32 color1 = (u32)block[0] | ((u32)block[1] << 8);
+        const u32 color2 = (u32)block[2] | ((u32)block[3] << 8);
+        const u32 indexes = (u32)block[4] | ((u32)block[5] << 8) | ((u32)block[6] << 16) | ((u32)block[7] << 24);
+
+        const u32 r1 = ExpandImageChannel((color1 >> 11) & 0x1F, 5);
+        const u32 g1 = ExpandImageChannel((color1 >> 5) & 0x3F, 6);
+        const u32 b1 = ExpandImageChannel(color1 & 0x1F, 5);
+
+        const u32 r2 = ExpandImageChannel((color2 >> 11) & 0x1F, 5);
+        const u32 g2 = ExpandImageChannel((color2 >> 5) & 0x3F, 6);
+        const u32 b2 = ExpandImageChannel(color2 & 0x1F, 5);
+
+        const BOOL isOpaque = !transparent || color2 < color1;
+
+#ifdef RENDERER_MODULE_SIMD
+        // NOTE: The end points are kept in 16-bit lanes as B, G, R, A of both colors,
+        // so that both of the intermediate colors are computed at once.
+        const __m128i ends = _mm_setr_epi16((s16)b1, (s16)g1, (s16)r1, 0xFF, (s16)b2, (s16)g2, (s16)r2, 0xFF);
+        const __m128i swapped = _mm_shuffle_epi32(ends, _MM_SHUFFLE(1, 0, 3, 2));
+
+        const __m128i one = _mm_set1_epi16(1);
+
+        __m128i middles;
+
+        if (isOpaque)
+        {
+            // NOTE: The high half of the product by 0x5556 is the exact quotient of the division by 3 for the values below 768.
+            middles = _mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(_mm_add_epi16(ends, ends), swapped), one), _mm_set1_epi16(0x5556));
+        }
+        else
+        {
+            middles = _mm_and_si128(_mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(ends, swapped), one), 1), _mm_setr_epi16(-1, -1, -1, -1, 0, 0, 0, 0));
+        }
+
+        const __m128i colors = _mm_packus_epi16(ends, middles);
+
+        const __m128i c0 = _mm_shuffle_epi32(colors, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128i c1 = _mm_shuffle_epi32(colors, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128i c2 = _mm_shuffle_epi32(colors, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128i c3 = _mm_shuffle_epi32(colors, _MM_SHUFFLE(3, 3, 3, 3));
+
+        const __m128i value = _mm_set1_epi32((s32)indexes);
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION; x++)
+        {
+            // NOTE: Each lane tests the low and the high bit of the index of its own pixel.
+            const __m128i lows = _mm_setr_epi32(1 << (8 * x + 0), 1 << (8 * x + 2), 1 << (8 * x + 4), 1 << (8 * x + 6));
+            const __m128i highs = _mm_slli_epi32(lows, 1);
+
+            const __m128i low = _mm_cmpeq_epi32(_mm_and_si128(value, lows), lows);
+            const __m128i high = _mm_cmpeq_epi32(_mm_and_si128(value, highs), highs);
+
+            const __m128i first = _mm_or_si128(_mm_and_si128(low, c1), _mm_andnot_si128(low, c0));
+            const __m128i second = _mm_or_si128(_mm_and_si128(low, c3), _mm_andnot_si128(low, c2));
+
+            _mm_storeu_si128((__m128i*)((addr)pixels + (addr)(x * stride)),
+                _mm_or_si128(_mm_and_si128(high, second), _mm_andnot_si128(high, first)));
+        }
+#else
+        u32 colors[4];
+
+        colors[0] = 0xFF000000 | (r1 << 16) | (g1 << 8) | b1;
+        colors[1] = 0xFF000000 | (r2 << 16) | (g2 << 8) | b2;
+
+        if (isOpaque)
+        {
+            colors[2] = 0xFF000000 | (((2 * r1 + r2 + 1) / 3) << 16) | (((2 * g1 + g2 + 1) / 3) << 8) | ((2 * b1 + b2 + 1) / 3);
+            colors[3] = 0xFF000000 | (((r1 + 2 * r2 + 1) / 3) << 16) | (((g1 + 2 * g2 + 1) / 3) << 8) | ((b1 + 2 * b2 + 1) / 3);
+        }
+        else
+        {
+            colors[2] = 0xFF000000 | (((r1 + r2 + 1) >> 1) << 16) | (((g1 + g2 + 1) >> 1) << 8) | ((b1 + b2 + 1) >> 1);
+            colors[3] = GRAPCHICS_COLOR_BLACK;
+        }
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION; x++)
+        {
+            u32* values = (u32*)((addr)pixels + (addr)(x * stride));
+
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                values[xx] = colors[(indexes >> (2 * (x * IMAGE_DXT_DIMENSION + xx))) & 3];
+            }
+        }
+#endif
+    }
+
+    // Decodes the explicit 4-bit alphas of DXT2 and DXT3 blocks into the 4x4 pixels.
+    void DecodeImageDXTExplicitAlphas(const u8* block, u32* pixels, const u32 stride)
+    {
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION; x++)
+        {
+            u32* values = (u32*)((addr)pixels + (addr)(x * stride));
+
+            const u32 alphas = (u32)block[2 * x] | ((u32)block[2 * x + 1] << 8);
+
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                values[xx] = (values[xx] & 0x00FFFFFF) | ((((alphas >> (4 * xx)) & 0x0F) * 0x11) << 24);
+            }
+        }
+    }
+
+    // Decodes the interpolated 3-bit alphas of DXT4 and DXT5 blocks into the 4x4 pixels.
+    void DecodeImageDXTInterpolatedAlphas(const u8* block, u32* pixels, const u32 stride)
+    {
+        u32 alphas[8];
+
+        alphas[0] = block[0];
+        alphas[1] = block[1];
+
+        if (alphas[1] < alphas[0])
+        {
+            for (u32 x = 1; x < 7; x++)
+            {
+                alphas[x + 1] = ((7 - x) * alphas[0] + x * alphas[1] + 3) / 7;
+            }
+        }
+        else
+        {
+            for (u32 x = 1; x < 5; x++)
+            {
+                alphas[x + 1] = ((5 - x) * alphas[0] + x * alphas[1] + 2) / 5;
+            }
+
+            alphas[6] = 0;
+            alphas[7] = 0xFF;
+        }
+
+        // NOTE: Each of the two halves of the 48-bit indexes holds the 3-bit indexes of two rows.
+        const u32 indexes[2] =
+        {
+            (u32)block[2] | ((u32)block[3] << 8) | ((u32)block[4] << 16),
+            (u32)block[5] | ((u32)block[6] << 8) | ((u32)block[7] << 16)
+        };
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION; x++)
+        {
+            u32* values = (u32*)((addr)pixels + (addr)(x * stride));
+
+            const u32 value = indexes[x >> 1] >> (12 * (x & 1));
+
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                values[xx] = (values[xx] & 0x00FFFFFF) | (alphas[(value >> (3 * xx)) & 7] << 24);
+            }
+        }
+    }
+
+    // Encodes the 4x4 pixels into the colors of the block.
+    // NOTE: The end points are the extremes of the pixels along the principal axis of their colors, inset by a sixteenth of their range.
+    // The pixels with the alpha below a half are encoded as the transparent black of DXT1 blocks.
+    void EncodeImageDXTColors(const u32* pixels, u8* block, const BOOL transparent)
+    {
+        u32 alphas = 0;
+        u32 count = 0;
+
+        s32 mins[3] = { 0xFF, 0xFF, 0xFF };
+        s32 maxs[3] = { 0, 0, 0 };
+        s32 sums[3] = { 0, 0, 0 };
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+        {
+            if (transparent && (pixels[x] >> 24) < 0x80) { alphas = alphas | (1 << x); continue; }
+
+            for (u32 xx = 0; xx < 3; xx++)
+            {
+                const s32 value = (pixels[x] >> (16 - 8 * xx)) & 0xFF;
+
+                mins[xx] = Min(mins[xx], value);
+                maxs[xx] = Max(maxs[xx], value);
+                sums[xx] = sums[xx] + value;
+            }
+
+            count = count + 1;
+        }
+
+        if (count == 0)
+        {
+            memset(block, 0, 4);
+
+            block[4] = 0xFF;
+            block[5] = 0xFF;
+            block[6] = 0xFF;
+            block[7] = 0xFF;
+
+            return;
+        }
+
+        // The principal axis is approximated by a few iterations of the power method over the covariance of the colors.
+        f32 covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+        {
+            if (alphas & (1 << x)) { continue; }
+
+            const f32 r = (f32)((pixels[x] >> 16) & 0xFF) - (f32)sums[0] / (f32)count;
+            const f32 g = (f32)((pixels[x] >> 8) & 0xFF) - (f32)sums[1] / (f32)count;
+            const f32 b = (f32)(pixels[x] & 0xFF) - (f32)sums[2] / (f32)count;
+
+            covariance[0] = covariance[0] + r * r;
+            covariance[1] = covariance[1] + r * g;
+            covariance[2] = covariance[2] + r * b;
+            covariance[3] = covariance[3] + g * g;
+            covariance[4] = covariance[4] + g * b;
+            covariance[5] = covariance[5] + b * b;
+        }
+
+        f32 axis[3] = { (f32)(maxs[0] - mins[0]), (f32)(maxs[1] - mins[1]), (f32)(maxs[2] - mins[2]) };
+
+        for (u32 x = 0; x < 4; x++)
+        {
+            const f32 r = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+            const f32 g = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+            const f32 b = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+
+            const f32 length = Max(Max(Max(r, -r), Max(g, -g)), Max(b, -b));
+
+            if (length == 0.0f) { break; }
+
+            axis[0] = r / length;
+            axis[1] = g / length;
+            axis[2] = b / length;
+        }
+
+        u32 first = 0;
+        u32 last = 0;
+
+        {
+            f32 minimum = 0.0f;
+            f32 maximum = 0.0f;
+
+            BOOL isInit = FALSE;
+
+            for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+            {
+                if (alphas & (1 << x)) { continue; }
+
+                const f32 value = axis[0] * (f32)((pixels[x] >> 16) & 0xFF)
+                    + axis[1] * (f32)((pixels[x] >> 8) & 0xFF) + axis[2] * (f32)(pixels[x] & 0xFF);
+
+                if (!isInit || value < minimum) { minimum = value; last = pixels[x]; }
+                if (!isInit || maximum < value) { maximum = value; first = pixels[x]; }
+
+                isInit = TRUE;
+            }
+        }
+
+        u32 color1 = 0;
+        u32 color2 = 0;
+
+        for (u32 x = 0; x < 3; x++)
+        {
+            const u32 bits = x == 1 ? 6 : 5;
+
+            const s32 v1 = (first >> (16 - 8 * x)) & 0xFF;
+            const s32 v2 = (last >> (16 - 8 * x)) & 0xFF;
+
+            const s32 inset = (v1 - v2) / 16;
+
+            color1 = (color1 << bits) | ReduceImageChannel(v1 - inset, bits);
+            color2 = (color2 << bits) | ReduceImageChannel(v2 + inset, bits);
+        }
+
+        // The transparent pixels require the first color not greater than the second one, while the rest require the opposite.
+        if (alphas != 0 ? color2 < color1 : color1 < color2)
+        {
+            const u32 value = color1;
+
+            color1 = color2;
+            color2 = value;
+        }
+
+        const BOOL isOpaque = !transparent || color2 < color1;
+
+        u32 colors[4];
+
+        {
+            const u32 r1 = ExpandImageChannel((color1 >> 11) & 0x1F, 5);
+            const u32 g1 = ExpandImageChannel((color1 >> 5) & 0x3F, 6);
+            const u32 b1 = ExpandImageChannel(color1 & 0x1F, 5);
+
+            const u32 r2 = ExpandImageChannel((color2 >> 11) & 0x1F, 5);
+            const u32 g2 = ExpandImageChannel((color2 >> 5) & 0x3F, 6);
+            const u32 b2 = ExpandImageChannel(color2 & 0x1F, 5);
+
+            colors[0] = (r1 << 16) | (g1 << 8) | b1;
+            colors[1] = (r2 << 16) | (g2 << 8) | b2;
+
+            if (isOpaque)
+            {
+                colors[2] = (((2 * r1 + r2 + 1) / 3) << 16) | (((2 * g1 + g2 + 1) / 3) << 8) | ((2 * b1 + b2 + 1) / 3);
+                colors[3] = (((r1 + 2 * r2 + 1) / 3) << 16) | (((g1 + 2 * g2 + 1) / 3) << 8) | ((b1 + 2 * b2 + 1) / 3);
+            }
+            else
+            {
+                colors[2] = (((r1 + r2 + 1) >> 1) << 16) | (((g1 + g2 + 1) >> 1) << 8) | ((b1 + b2 + 1) >> 1);
+                colors[3] = 0;
+            }
+        }
+
+        // The last color of the blocks with the transparent black is not used for the opaque pixels.
+        const u32 length = isOpaque ? 4 : 3;
+
+        u32 indexes[IMAGE_DXT_DIMENSION_SEGMENT];
+
+#ifdef RENDERER_MODULE_SIMD
+        {
+            // NOTE: The pixels are kept in 16-bit lanes as B, G, R, A of two pixels per register,
+            // so that the squared distances of four pixels to each of the colors are computed at once.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mask = _mm_set1_epi32(0x00FFFFFF);
+
+            __m128i values[4];
+
+            for (u32 x = 0; x < length; x++)
+            {
+                values[x] = _mm_unpacklo_epi8(_mm_set1_epi32((s32)colors[x]), zero);
+            }
+
+            for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x = x + 4)
+            {
+                const __m128i px = _mm_and_si128(_mm_loadu_si128((__m128i*)&pixels[x]), mask);
+
+                const __m128i lo = _mm_unpacklo_epi8(px, zero);
+                const __m128i hi = _mm_unpackhi_epi8(px, zero);
+
+                __m128i best = _mm_setzero_si128();
+                __m128i result = _mm_setzero_si128();
+
+                for (u32 xx = 0; xx < length; xx++)
+                {
+                    const __m128i dl = _mm_sub_epi16(lo, values[xx]);
+                    const __m128i dh = _mm_sub_epi16(hi, values[xx]);
+
+                    const __m128i sl = _mm_madd_epi16(dl, dl);
+                    const __m128i sh = _mm_madd_epi16(dh, dh);
+
+                    const __m128i tl = _mm_shuffle_epi32(_mm_add_epi32(sl, _mm_srli_epi64(sl, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+                    const __m128i th = _mm_shuffle_epi32(_mm_add_epi32(sh, _mm_srli_epi64(sh, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+
+                    const __m128i distance = _mm_unpacklo_epi64(tl, th);
+
+                    if (xx == 0) { best = distance; continue; }
+
+                    const __m128i less = _mm_cmplt_epi32(distance, best);
+
+                    best = _mm_or_si128(_mm_and_si128(less, distance), _mm_andnot_si128(less, best));
+                    result = _mm_or_si128(_mm_and_si128(less, _mm_set1_epi32(xx)), _mm_andnot_si128(less, result));
+                }
+
+                _mm_storeu_si128((__m128i*)&indexes[x], result);
+            }
+        }
+#else
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+        {
+            const s32 r = (pixels[x] >> 16) & 0xFF;
+            const s32 g = (pixels[x] >> 8) & 0xFF;
+            const s32 b = pixels[x] & 0xFF;
+
+            s32 best = 0;
+
+            indexes[x] = 0;
+
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                const s32 dr = r - (s32)((colors[xx] >> 16) & 0xFF);
+                const s32 dg = g - (s32)((colors[xx] >> 8) & 0xFF);
+                const s32 db = b - (s32)(colors[xx] & 0xFF);
+
+                const s32 distance = dr * dr + dg * dg + db * db;
+
+                if (xx == 0 || distance < best)
+                {
+                    best = distance;
+                    indexes[x] = xx;
+                }
+            }
+        }
+#endif
+
+        u32 value = 0;
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+        {
+            value = value | (((alphas & (1 << x)) ? 3 : indexes[x]) << (2 * x));
+        }
+
+        block[0] = (u8)(color1 & 0xFF);
+        block[1] = (u8)(color1 >> 8);
+        block[2] = (u8)(color2 & 0xFF);
+        block[3] = (u8)(color2 >> 8);
+        block[4] = (u8)(value & 0xFF);
+        block[5] = (u8)((value >> 8) & 0xFF);
+        block[6] = (u8)((value >> 16) & 0xFF);
+        block[7] = (u8)(value >> 24);
+    }
+
+    // Encodes the alphas of the 4x4 pixels into the explicit 4-bit alphas of DXT2 and DXT3 blocks.
+    void EncodeImageDXTExplicitAlphas(const u32* pixels, u8* block)
+    {
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION; x++)
+        {
+            u32 alphas = 0;
+
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                alphas = alphas | (ReduceImageChannel(pixels[x * IMAGE_DXT_DIMENSION + xx] >> 24, 4) << (4 * xx));
+            }
+
+            block[2 * x + 0] = (u8)(alphas & 0xFF);
+            block[2 * x + 1] = (u8)(alphas >> 8);
+        }
+    }
+
+    // Encodes the alphas of the 4x4 pixels into the interpolated 3-bit alphas of DXT4 and DXT5 blocks.
+    // NOTE: The blocks are encoded with the first alpha greater than the second one, so that all of the eight alphas
+    // are spread evenly between the extremes, unless all of the pixels share the same alpha.
+    void EncodeImageDXTInterpolatedAlphas(const u32* pixels, u8* block)
+    {
+        u32 minimum = 0xFF;
+        u32 maximum = 0;
+
+        for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+        {
+            minimum = Min(minimum, pixels[x] >> 24);
+            maximum = Max(maximum, pixels[x] >> 24);
+        }
+
+        block[0] = (u8)maximum;
+        block[1] = (u8)minimum;
+
+        u32 indexes[2] = { 0, 0 };
+
+        if (minimum != maximum)
+        {
+            const u32 range = maximum - minimum;
+
+            for (u32 x = 0; x < IMAGE_DXT_DIMENSION_SEGMENT; x++)
+            {
+                // The position of the alpha along the ramp from the second alpha to the first one.
+                const u32 position = (((pixels[x] >> 24) - minimum) * 14 + range) / (2 * range);
+
+                const u32 indx = position == 7 ? 0 : (position == 0 ? 1 : 8 - position);
+
+                indexes[x >> 3] = indexes[x >> 3] | (indx << (3 * (x & 7)));
+            }
+        }
+
+        for (u32 x = 0; x < 3; x++)
+        {
+            block[2 + x] = (u8)((indexes[0] >> (8 * x)) & 0xFF);
+            block[5 + x] = (u8)((indexes[1] >> (8 * x)) & 0xFF);
+        }
+    }
+
+    // Acquires the index of the palette color nearest to the color, comparing only the channels of the mask.
+    u32 AcquireImagePaletteIndex(const u32 color, const u32* palette, const u32 mask)
+    {
+        u32 result = 0;
+        u32 distance = U32_MAX;
+
+        const u32 value = color & mask;
+
+        const s32 a = (value >> 24) & 0xFF;
+        const s32 r = (value >> 16) & 0xFF;
+        const s32 g = (value >> 8) & 0xFF;
+        const s32 b = value & 0xFF;
+
+        for (u32 x = 0; x < MAX_IMAGE_PALETTE_VALUES_COUNT; x++)
+        {
+            const u32 entry = palette[x] & mask;
+
+            if (entry == value) { return x; }
+
+            const s32 da = (s32)((entry >> 24) & 0xFF) - a;
+            const s32 dr = (s32)((entry >> 16) & 0xFF) - r;
+            const s32 dg = (s32)((entry >> 8) & 0xFF) - g;
+            const s32 db = (s32)(entry & 0xFF) - b;
+
+            const u32 length = (u32)(da * da + dr * dr + dg * dg + db * db);
+
+            if (length < distance)
+            {
+                result = x;
+                distance = length;
+            }
+        }
+
+        return result;
+    }
+
+    // Acquires the A8R8G8B8 color of the BT.601 luma and chroma values.
+    u32 AcquireImageYUVColor(const u32 y, const u32 u, const u32 v)
+    {
+        const s32 c = 298 * ((s32)y - 16) + 128;
+        const s32 d = (s32)u - 128;
+        const s32 e = (s32)v - 128;
+
+        const s32 r = Clamp((c + 409 * e) >> 8, 0, 255);
+        const s32 g = Clamp((c - 100 * d - 208 * e) >> 8, 0, 255);
+        const s32 b = Clamp((c + 516 * d) >> 8, 0, 255);
+
+        return 0xFF000000 | (r << 16) | (g << 8) | b;
+    }
+
+    // Acquires the BT.601 luma of the A8R8G8B8 color.
+    u32 AcquireImageYUVLuma(const u32 color)
+    {
+        const s32 r = (color >> 16) & 0xFF;
+        const s32 g = (color >> 8) & 0xFF;
+        const s32 b = color & 0xFF;
+
+        return (u32)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    }
+
+    // Acquires the BT.601 chroma of the pair of A8R8G8B8 colors, averaged, as U in the low byte and V in the high one.
+    u32 AcquireImageYUVChroma(const u32 color1, const u32 color2)
+    {
+        const s32 r = (((color1 >> 16) & 0xFF) + ((color2 >> 16) & 0xFF) + 1) >> 1;
+        const s32 g = (((color1 >> 8) & 0xFF) + ((color2 >> 8) & 0xFF) + 1) >> 1;
+        const s32 b = ((color1 & 0xFF) + (color2 & 0xFF) + 1) >> 1;
+
+        const u32 u = (u32)Clamp(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128, 0, 255);
+        const u32 v = (u32)Clamp(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128, 0, 255);
+
+        return (v << 8) | u;
+    }
+
+    // Acquires the luminance of the A8R8G8B8 color.
+    u32 AcquireImageLuminance(const u32 color)
+    {
+        const u32 r = (color >> 16) & 0xFF;
+        const u32 g = (color >> 8) & 0xFF;
+        const u32 b = color & 0xFF;
+
+        return (77 * r + 150 * g + 29 * b + 128) >> 8;
+    }
+
+    // Reads the 16-bit pixels of the channel layout as A8R8G8B8 colors.
+    void ReadImagePixels16(const u16* pixels, u32* colors, const u32 count, const ImageChannelLayout* layout)
+    {
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        // NOTE: The channels are in B, G, R, A order, so that they interleave into the A8R8G8B8 colors.
+        const u32 shifts[4] = { layout->BlueShift, layout->GreenShift, layout->RedShift, layout->AlphaShift };
+        const u32 bits[4] = { layout->BlueBits, layout->GreenBits, layout->RedBits, layout->AlphaBits };
+
+        __m128i counts[4];
+        __m128i masks[4];
+        __m128i multipliers[4];
+        __m128i reductions[4];
+        __m128i fills[4];
+
+        for (u32 k = 0; k < 4; k++)
+        {
+            // NOTE: Replicating the high bits into the low ones is the multiplication by the repeated ones, followed by the shift.
+            u32 multiplier = (1 << bits[k]) + 1;
+            u32 reduction = 2 * bits[k] - 8;
+
+            if (bits[k] == 1) { multiplier = 0xFF; reduction = 0; }
+            else if (bits[k] == 2) { multiplier = 0x55; reduction = 0; }
+            else if (bits[k] == 3) { multiplier = 0x49; reduction = 1; }
+
+            counts[k] = _mm_cvtsi32_si128(shifts[k]);
+            masks[k] = _mm_set1_epi16((s16)((1 << bits[k]) - 1));
+            multipliers[k] = _mm_set1_epi16((s16)multiplier);
+            reductions[k] = _mm_cvtsi32_si128(bits[k] == 0 ? 0 : reduction);
+            fills[k] = _mm_set1_epi16(bits[k] == 0 ? 0xFF : 0);
+        }
+
+        for (; x + 8 <= count; x = x + 8)
+        {
+            const __m128i value = _mm_loadu_si128((__m128i*)&pixels[x]);
+
+            __m128i channels[4];
+
+            for (u32 k = 0; k < 4; k++)
+            {
+                const __m128i channel = _mm_and_si128(_mm_srl_epi16(value, counts[k]), masks[k]);
+
+                channels[k] = _mm_or_si128(_mm_srl_epi16(_mm_mullo_epi16(channel, multipliers[k]), reductions[k]), fills[k]);
+            }
+
+            const __m128i bg = _mm_or_si128(channels[0], _mm_slli_epi16(channels[1], 8));
+            const __m128i ra = _mm_or_si128(channels[2], _mm_slli_epi16(channels[3], 8));
+
+            _mm_storeu_si128((__m128i*)&colors[x + 0], _mm_unpacklo_epi16(bg, ra));
+            _mm_storeu_si128((__m128i*)&colors[x + 4], _mm_unpackhi_epi16(bg, ra));
+        }
+#endif
+
+        for (; x < count; x++)
+        {
+            const u32 value = pixels[x];
+
+            const u32 a = ExpandImageChannel((value >> layout->AlphaShift) & ((1 << layout->AlphaBits) - 1), layout->AlphaBits);
+            const u32 r = ExpandImageChannel((value >> layout->RedShift) & ((1 << layout->RedBits) - 1), layout->RedBits);
+            const u32 g = ExpandImageChannel((value >> layout->GreenShift) & ((1 << layout->GreenBits) - 1), layout->GreenBits);
+            const u32 b = ExpandImageChannel((value >> layout->BlueShift) & ((1 << layout->BlueBits) - 1), layout->BlueBits);
+
+            colors[x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    // Writes the A8R8G8B8 colors as the 16-bit pixels of the channel layout.
+    void WriteImagePixels16(const u32* colors, u16* pixels, const u32 count, const ImageChannelLayout* layout)
+    {
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        const u32 shifts[4] = { layout->BlueShift, layout->GreenShift, layout->RedShift, layout->AlphaShift };
+        const u32 bits[4] = { layout->BlueBits, layout->GreenBits, layout->RedBits, layout->AlphaBits };
+
+        __m128i counts[4];
+        __m128i maximums[4];
+
+        for (u32 k = 0; k < 4; k++)
+        {
+            counts[k] = _mm_cvtsi32_si128(shifts[k]);
+            maximums[k] = _mm_set1_epi16((s16)((1 << bits[k]) - 1));
+        }
+
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        const __m128i half = _mm_set1_epi16(128);
+
+        for (; x + 8 <= count; x = x + 8)
+        {
+            const __m128i color1 = _mm_loadu_si128((__m128i*)&colors[x + 0]);
+            const __m128i color2 = _mm_loadu_si128((__m128i*)&colors[x + 4]);
+
+            __m128i result = _mm_setzero_si128();
+
+            for (u32 k = 0; k < 4; k++)
+            {
+                const __m128i offset = _mm_cvtsi32_si128(8 * k);
+
+                const __m128i channel = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(color1, offset), mask),
+                    _mm_and_si128(_mm_srl_epi32(color2, offset), mask));
+
+                // NOTE: The value of (v * max + 128 + ((v * max + 128) >> 8)) >> 8 is the rounded v * max / 255.
+                const __m128i value = _mm_add_epi16(_mm_mullo_epi16(channel, maximums[k]), half);
+                const __m128i reduced = _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+
+                result = _mm_or_si128(result, _mm_sll_epi16(reduced, counts[k]));
+            }
+
+            _mm_storeu_si128((__m128i*)&pixels[x], result);
+        }
+#endif
+
+        for (; x < count; x++)
+        {
+            const u32 color = colors[x];
+
+            pixels[x] = (u16)((ReduceImageChannel((color >> 24) & 0xFF, layout->AlphaBits) << layout->AlphaShift)
+                | (ReduceImageChannel((color >> 16) & 0xFF, layout->RedBits) << layout->RedShift)
+                | (ReduceImageChannel((color >> 8) & 0xFF, layout->GreenBits) << layout->GreenShift)
+                | (ReduceImageChannel(color & 0xFF, layout->BlueBits) << layout->BlueShift));
+        }
+    }
+
+    void ReadImageA1R5G5B5(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        ReadImagePixels16((u16*)pixels, colors, count, &ImageA1R5G5B5Layout);
+    }
+
+    void ReadImageA4L4(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            colors[x] = ((u32)(values[x] >> 4) * 0x11000000) | ((u32)(values[x] & 0x0F) * 0x00111111);
+        }
+    }
+
+    void ReadImageA4R4G4B4(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        ReadImagePixels16((u16*)pixels, colors, count, &ImageA4R4G4B4Layout);
+    }
+
+    void ReadImageA8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            colors[x] = (u32)values[x] << 24;
+        }
+    }
+
+    void ReadImageA8L8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            colors[x] = ((u32)(values[x] >> 8) << 24) | ((u32)(values[x] & 0xFF) * 0x00010101);
+        }
+    }
+
+    void ReadImageA8P8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            colors[x] = ((u32)(values[x] >> 8) << 24) | (palette[values[x] & 0xFF] & 0x00FFFFFF);
+        }
+    }
+
+    void ReadImageA8R3G3B2(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        ReadImagePixels16((u16*)pixels, colors, count, &ImageA8R3G3B2Layout);
+    }
+
+    void ReadImageA8R8G8B8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        memcpy(colors, pixels, count * sizeof(u32));
+    }
+
+    void ReadImageL6V5U5(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 u = ExpandImageChannel((values[x] & 0x1F) ^ 0x10, 5);
+            const u32 v = ExpandImageChannel(((values[x] >> 5) & 0x1F) ^ 0x10, 5);
+            const u32 l = ExpandImageChannel((values[x] >> 10) & 0x3F, 6);
+
+            colors[x] = 0xFF000000 | (u << 16) | (v << 8) | l;
+        }
+    }
+
+    void ReadImageL8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        const __m128i alpha = _mm_set1_epi8((s8)0xFF);
+
+        for (; x + 16 <= count; x = x + 16)
+        {
+            const __m128i value = _mm_loadu_si128((__m128i*)&values[x]);
+
+            // NOTE: The luminance is duplicated into the blue and green bytes, and the red one is paired with the opaque alpha.
+            const __m128i bg1 = _mm_unpacklo_epi8(value, value);
+            const __m128i bg2 = _mm_unpackhi_epi8(value, value);
+            const __m128i ra1 = _mm_unpacklo_epi8(value, alpha);
+            const __m128i ra2 = _mm_unpackhi_epi8(value, alpha);
+
+            _mm_storeu_si128((__m128i*)&colors[x + 0], _mm_unpacklo_epi16(bg1, ra1));
+            _mm_storeu_si128((__m128i*)&colors[x + 4], _mm_unpackhi_epi16(bg1, ra1));
+            _mm_storeu_si128((__m128i*)&colors[x + 8], _mm_unpacklo_epi16(bg2, ra2));
+            _mm_storeu_si128((__m128i*)&colors[x + 12], _mm_unpackhi_epi16(bg2, ra2));
+        }
+#endif
+
+        for (; x < count; x++)
+        {
+            colors[x] = 0xFF000000 | ((u32)values[x] * 0x00010101);
+        }
+    }
+
+    void ReadImageP8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            colors[x] = palette[values[x]];
+        }
+    }
+
+    void ReadImageQ8W8V8U8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 value = values[x] ^ 0x80808080;
+
+            colors[x] = (value & 0xFF00FF00) | ((value & 0xFF) << 16) | ((value >> 16) & 0xFF);
+        }
+    }
+
+    void ReadImageR3G3B2(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 r = ExpandImageChannel(values[x] >> 5, 3);
+            const u32 g = ExpandImageChannel((values[x] >> 2) & 0x07, 3);
+            const u32 b = ExpandImageChannel(values[x] & 0x03, 2);
+
+            colors[x] = 0xFF000000 | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    void ReadImageR5G6B5(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        ReadImagePixels16((u16*)pixels, colors, count, &ImageR5G6B5Layout);
+    }
+
+    void ReadImageR8G8B8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            colors[x] = 0xFF000000 | ((u32)values[x * 3 + 2] << 16) | ((u32)values[x * 3 + 1] << 8) | (u32)values[x * 3 + 0];
+        }
+    }
+
+    void ReadImageUYVY(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x = x + 2)
+        {
+            const u8* value = &values[x * 2];
+
+            colors[x] = AcquireImageYUVColor(value[1], value[0], value[2]);
+
+            if (x + 1 < count) { colors[x + 1] = AcquireImageYUVColor(value[3], value[0], value[2]); }
+        }
+    }
+
+    void ReadImageV16U16(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 value = values[x] ^ 0x80008000;
+
+            colors[x] = 0xFF0000FF | ((value & 0xFF00) << 8) | ((value >> 16) & 0xFF00);
+        }
+    }
+
+    void ReadImageV8U8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 value = values[x] ^ 0x8080;
+
+            colors[x] = 0xFF0000FF | ((value & 0xFF) << 16) | (value & 0xFF00);
+        }
+    }
+
+    void ReadImageW11V11U10(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 u = ((values[x] & 0x3FF) ^ 0x200) >> 2;
+            const u32 v = (((values[x] >> 10) & 0x7FF) ^ 0x400) >> 3;
+            const u32 w = (((values[x] >> 21) & 0x7FF) ^ 0x400) >> 3;
+
+            colors[x] = 0xFF000000 | (u << 16) | (v << 8) | w;
+        }
+    }
+
+    void ReadImageX1R5G5B5(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        ReadImagePixels16((u16*)pixels, colors, count, &ImageX1R5G5B5Layout);
+    }
+
+    void ReadImageX4R4G4B4(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        ReadImagePixels16((u16*)pixels, colors, count, &ImageX4R4G4B4Layout);
+    }
+
+    void ReadImageX8L8V8U8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 value = values[x] ^ 0x00008080;
+
+            colors[x] = 0xFF000000 | (value & 0x0000FF00) | ((value & 0xFF) << 16) | ((value >> 16) & 0xFF);
+        }
+    }
+
+    void ReadImageX8R8G8B8(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u32* values = (u32*)pixels;
+
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+        for (; x + 4 <= count; x = x + 4)
+        {
+            _mm_storeu_si128((__m128i*)&colors[x], _mm_or_si128(_mm_loadu_si128((__m128i*)&values[x]), alpha));
+        }
+#endif
+
+        for (; x < count; x++)
+        {
+            colors[x] = values[x] | 0xFF000000;
+        }
+    }
+
+    void ReadImageYUY2(const void* pixels, u32* colors, const u32 count, const u32* palette)
+    {
+        const u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x = x + 2)
+        {
+            const u8* value = &values[x * 2];
+
+            colors[x] = AcquireImageYUVColor(value[0], value[1], value[3]);
+
+            if (x + 1 < count) { colors[x + 1] = AcquireImageYUVColor(value[2], value[1], value[3]); }
+        }
+    }
+
+    void WriteImageA1R5G5B5(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        WriteImagePixels16(colors, (u16*)pixels, count, &ImageA1R5G5B5Layout);
+    }
+
+    void WriteImageA4L4(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x] = (u8)((ReduceImageChannel(colors[x] >> 24, 4) << 4) | ReduceImageChannel(AcquireImageLuminance(colors[x]), 4));
+        }
+    }
+
+    void WriteImageA4R4G4B4(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        WriteImagePixels16(colors, (u16*)pixels, count, &ImageA4R4G4B4Layout);
+    }
+
+    void WriteImageA8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x] = (u8)(colors[x] >> 24);
+        }
+    }
+
+    void WriteImageA8L8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x] = (u16)(((colors[x] >> 24) << 8) | AcquireImageLuminance(colors[x]));
+        }
+    }
+
+    void WriteImageA8P8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            // NOTE: The alpha is stored along with the index, so the index is matched by the color alone.
+            const u32 index = AcquireImagePaletteIndex(colors[x], palette, 0x00FFFFFF);
+
+            values[x] = (u16)(((colors[x] >> 24) << 8) | index);
+        }
+    }
+
+    void WriteImageA8R3G3B2(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        WriteImagePixels16(colors, (u16*)pixels, count, &ImageA8R3G3B2Layout);
+    }
+
+    void WriteImageA8R8G8B8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        memcpy(pixels, colors, count * sizeof(u32));
+    }
+
+    void WriteImageL6V5U5(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 u = ReduceImageChannel((colors[x] >> 16) & 0xFF, 5) ^ 0x10;
+            const u32 v = ReduceImageChannel((colors[x] >> 8) & 0xFF, 5) ^ 0x10;
+            const u32 l = ReduceImageChannel(colors[x] & 0xFF, 6);
+
+            values[x] = (u16)((l << 10) | (v << 5) | u);
+        }
+    }
+
+    void WriteImageL8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x] = (u8)AcquireImageLuminance(colors[x]);
+        }
+    }
+
+    void WriteImageP8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        u32 color = colors[0];
+        u32 index = AcquireImagePaletteIndex(color, palette, 0xFFFFFFFF);
+
+        for (u32 x = 0; x < count; x++)
+        {
+            // NOTE: The runs of the same color are common, so the last match is reused.
+            if (colors[x] != color)
+            {
+                color = colors[x];
+                index = AcquireImagePaletteIndex(color, palette, 0xFFFFFFFF);
+            }
+
+            values[x] = (u8)index;
+        }
+    }
+
+    void WriteImageQ8W8V8U8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 value = (colors[x] & 0xFF00FF00) | ((colors[x] & 0xFF) << 16) | ((colors[x] >> 16) & 0xFF);
+
+            values[x] = value ^ 0x80808080;
+        }
+    }
+
+    void WriteImageR3G3B2(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x] = (u8)((ReduceImageChannel((colors[x] >> 16) & 0xFF, 3) << 5)
+                | (ReduceImageChannel((colors[x] >> 8) & 0xFF, 3) << 2) | ReduceImageChannel(colors[x] & 0xFF, 2));
+        }
+    }
+
+    void WriteImageR5G6B5(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        WriteImagePixels16(colors, (u16*)pixels, count, &ImageR5G6B5Layout);
+    }
+
+    void WriteImageR8G8B8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x * 3 + 0] = (u8)(colors[x] & 0xFF);
+            values[x * 3 + 1] = (u8)((colors[x] >> 8) & 0xFF);
+            values[x * 3 + 2] = (u8)((colors[x] >> 16) & 0xFF);
+        }
+    }
+
+    void WriteImageUYVY(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x = x + 2)
+        {
+            const u32 color = x + 1 < count ? colors[x + 1] : colors[x];
+            const u32 chroma = AcquireImageYUVChroma(colors[x], color);
+
+            u8* value = &values[x * 2];
+
+            value[0] = (u8)(chroma & 0xFF);
+            value[1] = (u8)AcquireImageYUVLuma(colors[x]);
+            value[2] = (u8)(chroma >> 8);
+            value[3] = (u8)AcquireImageYUVLuma(color);
+        }
+    }
+
+    void WriteImageV16U16(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            // NOTE: The low byte replicates the high one, so that the extremes map onto the extremes of 16 bits.
+            const u32 u = ((colors[x] >> 16) & 0xFF) * 0x0101;
+            const u32 v = ((colors[x] >> 8) & 0xFF) * 0x0101;
+
+            values[x] = ((v << 16) | u) ^ 0x80008000;
+        }
+    }
+
+    void WriteImageV8U8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u16* values = (u16*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            values[x] = (u16)(((colors[x] & 0xFF00) | ((colors[x] >> 16) & 0xFF)) ^ 0x8080);
+        }
+    }
+
+    void WriteImageW11V11U10(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 r = (colors[x] >> 16) & 0xFF;
+            const u32 g = (colors[x] >> 8) & 0xFF;
+            const u32 b = colors[x] & 0xFF;
+
+            const u32 u = ((r << 2) | (r >> 6)) ^ 0x200;
+            const u32 v = ((g << 3) | (g >> 5)) ^ 0x400;
+            const u32 w = ((b << 3) | (b >> 5)) ^ 0x400;
+
+            values[x] = (w << 21) | (v << 10) | u;
+        }
+    }
+
+    void WriteImageX1R5G5B5(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        WriteImagePixels16(colors, (u16*)pixels, count, &ImageX1R5G5B5Layout);
+    }
+
+    void WriteImageX4R4G4B4(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        WriteImagePixels16(colors, (u16*)pixels, count, &ImageX4R4G4B4Layout);
+    }
+
+    void WriteImageX8L8V8U8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u32* values = (u32*)pixels;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u32 value = (colors[x] & 0x0000FF00) | ((colors[x] & 0xFF) << 16) | ((colors[x] >> 16) & 0xFF);
+
+            values[x] = value ^ 0x00008080;
+        }
+    }
+
+    void WriteImageX8R8G8B8(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        memcpy(pixels, colors, count * sizeof(u32));
+    }
+
+    void WriteImageYUY2(const u32* colors, void* pixels, const u32 count, const u32* palette)
+    {
+        u8* values = (u8*)pixels;
+
+        for (u32 x = 0; x < count; x = x + 2)
+        {
+            const u32 color = x + 1 < count ? colors[x + 1] : colors[x];
+            const u32 chroma = AcquireImageYUVChroma(colors[x], color);
+
+            u8* value = &values[x * 2];
+
+            value[0] = (u8)AcquireImageYUVLuma(colors[x]);
+            value[1] = (u8)(chroma & 0xFF);
+            value[2] = (u8)AcquireImageYUVLuma(color);
+            value[3] = (u8)(chroma >> 8);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2023 - 2025 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Basic.hxx"
+
+// NOTE: The pixel kernels do not depend on the platform, so that defining RENDERER_MODULE_NO_SIMD builds their scalar paths.
+#if !defined(RENDERER_MODULE_NO_SIMD) && !defined(__WATCOMC__) && (_MSC_VER > 1200 || defined(__SSE2__))
+#ifndef RENDERER_MODULE_SIMD
+#define RENDERER_MODULE_SIMD
+#endif
+#include <emmintrin.h>
+#endif
+
+#define MAX_IMAGE_PALETTE_VALUES_COUNT 256
+
+#define IMAGE_DXT_DIMENSION 4
+#define IMAGE_DXT_DIMENSION_SEGMENT (IMAGE_DXT_DIMENSION * IMAGE_DXT_DIMENSION)
+
+namespace Images
+{
+    struct ImageChannelLayout
+    {
+        u32 AlphaShift;
+        u32 AlphaBits;
+        u32 RedShift;
+        u32 RedBits;
+        u32 GreenShift;
+        u32 GreenBits;
+        u32 BlueShift;
+        u32 BlueBits;
+    };
+
+    void DecodeImageDXTColors(const u8* block, u32* pixels, const u32 stride, const BOOL transparent);
+    void DecodeImageDXTExplicitAlphas(const u8* block, u32* pixels, const u32 stride);
+    void DecodeImageDXTInterpolatedAlphas(const u8* block, u32* pixels, const u32 stride);
+    void EncodeImageDXTColors(const u32* pixels, u8* block, const BOOL transparent);
+    void EncodeImageDXTExplicitAlphas(const u32* pixels, u8* block);
+    void EncodeImageDXTInterpolatedAlphas(const u32* pixels, u8* block);
+
+    u32 AcquireImageLuminance(const u32 color);
+    u32 AcquireImagePaletteIndex(const u32 color, const u32* palette, const u32 mask);
+    u32 AcquireImageYUVChroma(const u32 color1, const u32 color2);
+    u32 AcquireImageYUVColor(const u32 y, const u32 u, const u32 v);
+    u32 AcquireImageYUVLuma(const u32 color);
+    void ReadImagePixels16(const u16* pixels, u32* colors, const u32 count, const ImageChannelLayout* layout);
+    void WriteImagePixels16(const u32* colors, u16* pixels, const u32 count, const ImageChannelLayout* layout);
+
+    void ReadImageA1R5G5B5(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA4L4(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA4R4G4B4(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA8L8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA8P8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA8R3G3B2(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageA8R8G8B8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageL6V5U5(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageL8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageP8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageQ8W8V8U8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageR3G3B2(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageR5G6B5(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageR8G8B8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageUYVY(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageV16U16(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageV8U8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageW11V11U10(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageX1R5G5B5(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageX4R4G4B4(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageX8L8V8U8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageX8R8G8B8(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    void ReadImageYUY2(const void* pixels, u32* colors, const u32 count, const u32* palette);
+
+    void WriteImageA1R5G5B5(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA4L4(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA4R4G4B4(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA8L8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA8P8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA8R3G3B2(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageA8R8G8B8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageL6V5U5(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageL8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageP8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageQ8W8V8U8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageR3G3B2(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageR5G6B5(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageR8G8B8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageUYVY(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageV16U16(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageV8U8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageW11V11U10(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageX1R5G5B5(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageX4R4G4B4(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageX8L8V8U8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageX8R8G8B8(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    void WriteImageYUY2(const u32* colors, void* pixels, const u32 count, const u32* palette);
+
+    // Expands the channel of the bits into 8 bits, by replicating the high bits into the low ones.
+    inline u32 ExpandImageChannel(const u32 value, const u32 bits)
+    {
+        switch (bits)
+        {
+        case 0: { return 0xFF; }
+        case 1: { return value != 0 ? 0xFF : 0; }
+        case 2: { return value * 0x55; }
+        case 3: { return (value << 5) | (value << 2) | (value >> 1); }
+        case 4: { return value * 0x11; }
+        case 5: { return (value << 3) | (value >> 2); }
+        case 6: { return (value << 2) | (value >> 4); }
+        case 7: { return (value << 1) | (value >> 6); }
+        }
+
+        return value;
+    }
+
+    // Reduces the 8-bit channel into the bits, rounding to the nearest value.
+    inline u32 ReduceImageChannel(const u32 value, const u32 bits)
+    {
+        const u32 result = value * ((1 << bits) - 1) + 128;
+
+        return (result + (result >> 8)) >> 8;
+    }
+}
\ No newline at end of file
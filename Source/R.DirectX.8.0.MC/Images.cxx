@@ -22,9 +22,13 @@ SOFTWARE.
 
 #include "Graphics.Basic.hxx"
 #include "Images.hxx"
+#include "Mathematics.Basic.hxx"
 #include "Renderer.hxx"
 
 #include <stdlib.h>
+#include <string.h>
+
+using namespace Mathematics;
 
 namespace Images
 {
@@ -32,76 +36,76 @@ namespace Images
     ImageCalls AbstractImageDXTCalls = { (RELEASEIMAGECALL)&ReleaseAbstractImageDXT, (READIMAGECALL)&ReadImageDXT, (WRITEDIMAGECALL)&WriteImageDXT };
 
     // 0x600186dc
-    ImageCalls ImageA8P8Self = { TODO, TODO, TODO };
+    ImageCalls ImageA8P8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018658
-    ImageCalls ImageR8G8B8Self = { TODO, TODO, TODO };
+    ImageCalls ImageR8G8B8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018664
-    ImageCalls ImageA8R8G8B8Self = { TODO, TODO, TODO };
+    ImageCalls ImageA8R8G8B8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018670
-    ImageCalls ImageX8R8G8B8Self = { TODO, TODO, TODO };
+    ImageCalls ImageX8R8G8B8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x6001867c
-    ImageCalls ImageR5G6B5Self = { TODO, TODO, TODO };
+    ImageCalls ImageR5G6B5Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018688
-    ImageCalls ImageX1R5G5B5Self = { TODO, TODO, TODO };
+    ImageCalls ImageX1R5G5B5Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018694
-    ImageCalls ImageA1R5G5B5Self = { TODO, TODO, TODO };
+    ImageCalls ImageA1R5G5B5Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186a0
-    ImageCalls ImageA4R4G4B4Self = { TODO, TODO, TODO };
+    ImageCalls ImageA4R4G4B4Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186ac
-    ImageCalls ImageR3G3B2Self = { TODO, TODO, TODO };
+    ImageCalls ImageR3G3B2Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186b8
-    ImageCalls ImageA8Self = { TODO, TODO, TODO };
+    ImageCalls ImageA8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186c4
-    ImageCalls ImageA8R3G3B2Self = { TODO, TODO, TODO };
+    ImageCalls ImageA8R3G3B2Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186d0
-    ImageCalls ImageX4R4G4B4Self = { TODO, TODO, TODO };
+    ImageCalls ImageX4R4G4B4Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018724
-    ImageCalls ImageL6V5U5Self = { TODO, TODO, TODO };
+    ImageCalls ImageL6V5U5Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186e8
-    ImageCalls ImageP8Self = { TODO, TODO, TODO };
+    ImageCalls ImageP8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x600186f4
-    ImageCalls ImageL8Self = { TODO, TODO, TODO };
+    ImageCalls ImageL8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018700
-    ImageCalls ImageA8L8Self = { TODO, TODO, TODO };
+    ImageCalls ImageA8L8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x6001870c
-    ImageCalls ImageA4L4Self = { TODO, TODO, TODO };
+    ImageCalls ImageA4L4Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018718
-    ImageCalls ImageV8U8Self = { TODO, TODO, TODO };
+    ImageCalls ImageV8U8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018730
-    ImageCalls ImageX8L8V8U8Self = { TODO, TODO, TODO };
+    ImageCalls ImageX8L8V8U8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x6001873c
-    ImageCalls ImageQ8W8V8U8Self = { TODO, TODO, TODO };
+    ImageCalls ImageQ8W8V8U8Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018748
-    ImageCalls ImageV16U16Self = { TODO, TODO, TODO };
+    ImageCalls ImageV16U16Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018754
-    ImageCalls ImageW11V11U10Self = { TODO, TODO, TODO };
+    ImageCalls ImageW11V11U10Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018760
-    ImageCalls ImageYUVYSelf = { TODO, TODO, TODO };
+    ImageCalls ImageYUVYSelf = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x6001876c
-    ImageCalls ImageYUY2Self = { TODO, TODO, TODO };
+    ImageCalls ImageYUY2Self = { (RELEASEIMAGECALL)&ReleaseImageBitMap, (READIMAGECALL)&ReadImageBitMap, (WRITEDIMAGECALL)&WriteImageBitMap };
 
     // 0x60018778
     ImageCalls ImageDXT1Self = { (RELEASEIMAGECALL)&ReleaseImageDXT, (READIMAGECALL)&ReadImageDXT, (WRITEDIMAGECALL)&WriteImageDXT };
@@ -118,6 +122,35 @@ namespace Images
     // 0x600187a8
     ImageCalls ImageDXT5Self = { (RELEASEIMAGECALL)&ReleaseImageDXT, (READIMAGECALL)&ReadImageDXT, (WRITEDIMAGECALL)&WriteImageDXT };
 
+    ImagePixelCalls ImagePixelConverters[] =
+    {
+        { D3DFMT_R8G8B8, ReadImageR8G8B8, WriteImageR8G8B8 },
+        { D3DFMT_A8R8G8B8, ReadImageA8R8G8B8, WriteImageA8R8G8B8 },
+        { D3DFMT_X8R8G8B8, ReadImageX8R8G8B8, WriteImageX8R8G8B8 },
+        { D3DFMT_R5G6B5, ReadImageR5G6B5, WriteImageR5G6B5 },
+        { D3DFMT_X1R5G5B5, ReadImageX1R5G5B5, WriteImageX1R5G5B5 },
+        { D3DFMT_A1R5G5B5, ReadImageA1R5G5B5, WriteImageA1R5G5B5 },
+        { D3DFMT_A4R4G4B4, ReadImageA4R4G4B4, WriteImageA4R4G4B4 },
+        { D3DFMT_R3G3B2, ReadImageR3G3B2, WriteImageR3G3B2 },
+        { D3DFMT_A8, ReadImageA8, WriteImageA8 },
+        { D3DFMT_A8R3G3B2, ReadImageA8R3G3B2, WriteImageA8R3G3B2 },
+        { D3DFMT_X4R4G4B4, ReadImageX4R4G4B4, WriteImageX4R4G4B4 },
+        { D3DFMT_A8P8, ReadImageA8P8, WriteImageA8P8 },
+        { D3DFMT_P8, ReadImageP8, WriteImageP8 },
+        { D3DFMT_L8, ReadImageL8, WriteImageL8 },
+        { D3DFMT_A8L8, ReadImageA8L8, WriteImageA8L8 },
+        { D3DFMT_A4L4, ReadImageA4L4, WriteImageA4L4 },
+        { D3DFMT_V8U8, ReadImageV8U8, WriteImageV8U8 },
+        { D3DFMT_L6V5U5, ReadImageL6V5U5, WriteImageL6V5U5 },
+        { D3DFMT_X8L8V8U8, ReadImageX8L8V8U8, WriteImageX8L8V8U8 },
+        { D3DFMT_Q8W8V8U8, ReadImageQ8W8V8U8, WriteImageQ8W8V8U8 },
+        { D3DFMT_V16U16, ReadImageV16U16, WriteImageV16U16 },
+        { D3DFMT_W11V11U10, ReadImageW11V11U10, WriteImageW11V11U10 },
+        { D3DFMT_UYVY, ReadImageUYVY, WriteImageUYVY },
+        { D3DFMT_YUY2, ReadImageYUY2, WriteImageYUY2 },
+        { D3DFMT_UNKNOWN, NULL, NULL }
+    };
+
     // 0x60009ad0
     void InitializeImageContainer(ImageContainer* img)
     {
@@ -588,7 +621,7 @@ namespace Images
 
         if ((param_4 & 0xffff) == 0 || 5 < (param_4 & 0xffff) || (param_4 & 0xfff00000) != 0) { return 0x8876086c; } // TODO
 
-        dst->Unk16 = param_4 & 0x80000; // TODO
+        dst->IsGradient = param_4 & IMAGE_CONTAINER_OPTIONS_GRADIENT;
 
         img->Destination = InitializeAbstractImage(dst);
 
@@ -596,7 +629,7 @@ namespace Images
         {
             img->Source = InitializeAbstractImage(src);
 
-            if (img->Source != NULL && TODO)
+            if (img->Source != NULL && CopyImageContainer(img) == D3D_OK)
             {
                 if (img->Destination != NULL) { img->Destination->Self->Release(img->Destination, IMAGE_RELEASE_DISPOSE); img->Destination = NULL; }
                 if (img->Source != NULL) { img->Source->Self->Release(img->Source, IMAGE_RELEASE_DISPOSE); img->Source = NULL; }
@@ -614,11 +647,24 @@ namespace Images
     // 0x6000f63b
     ImageDXT* InitializeImageDXT(ImageDXT* image, ImageContainerArgs* args)
     {
-        InitializeImageBitMap((ImageBitMap*)image, args, 0, 1);
+        InitializeImageBitMap((AbstractImage*)image, args, 0, 1);
 
         image->Self = &AbstractImageDXTCalls;
 
-        TODO
+        image->Left = args->Dimensions.Left & (IMAGE_DXT_DIMENSION - 1);
+        image->Top = args->Dimensions.Top & (IMAGE_DXT_DIMENSION - 1);
+        image->Count = (image->Left + image->Width + IMAGE_DXT_DIMENSION - 1) / IMAGE_DXT_DIMENSION;
+
+        image->Pixels = (u8*)((addr)image->Pixels + (addr)((args->Dimensions.Top / IMAGE_DXT_DIMENSION) * args->Stride)
+            + (addr)(args->Dimensions.Min * args->AreaStride) + (addr)((args->Dimensions.Left / IMAGE_DXT_DIMENSION) * AcquireImageDXTBlockSize(args->Format)));
+
+        image->Row = IMAGE_DXT_INVALID_ROW;
+        image->Slice = 0;
+        image->Rows = NULL;
+
+        image->IsDirty = FALSE;
+
+        return image;
     }
 
     // 0x60010543
@@ -646,13 +692,470 @@ namespace Images
     {
         image->Self = &AbstractImageDXTCalls;
 
-        FUN_6000f752(image);
+        if (image->IsDirty) { FlushImageDXT(image); }
+
+        if (image->Rows != NULL) { free(image->Rows); image->Rows = NULL; }
+    }
+
+    // Reads the row of the pixels of the image, decoding the whole row of the blocks it belongs to.
+    void ReadImageDXT(ImageDXT* image, const u32 p2, const u32 p3, u32* pixels)
+    {
+        const u32 line = p2 + image->Top;
+        const u32 row = line / IMAGE_DXT_DIMENSION;
+        const u32 length = image->Count * IMAGE_DXT_DIMENSION;
+
+        if (image->Rows == NULL)
+        {
+            image->Rows = (u32*)malloc(IMAGE_DXT_DIMENSION * length * sizeof(u32));
+
+            if (image->Rows == NULL) { ZeroMemory(pixels, image->Width * sizeof(u32)); return; }
+        }
+
+        if (image->Row != row || image->Slice != p3)
+        {
+            const u8* blocks = (u8*)((addr)image->Pixels + (addr)(row * image->Stride) + (addr)(p3 * image->AreaStride));
+
+            DecodeImageDXTBlocks(image->Format, blocks, image->Count, image->Rows, length * sizeof(u32));
+
+            image->Row = row;
+            image->Slice = p3;
+        }
+
+        CopyMemory(pixels, &image->Rows[(line % IMAGE_DXT_DIMENSION) * length + image->Left], image->Width * sizeof(u32));
+    }
+
+    // Writes the row of the pixels of the image, encoding the whole row of the blocks it belongs to once its last row is written.
+    // NOTE: The blocks the area covers only partially are decoded first, so that the pixels outside of the area are kept.
+    void WriteImageDXT(ImageDXT* image, const u32 p2, const u32 p3, u32* pixels)
+    {
+        const u32 line = p2 + image->Top;
+        const u32 row = line / IMAGE_DXT_DIMENSION;
+        const u32 length = image->Count * IMAGE_DXT_DIMENSION;
+
+        if (image->Rows == NULL)
+        {
+            image->Rows = (u32*)malloc(IMAGE_DXT_DIMENSION * length * sizeof(u32));
+
+            if (image->Rows == NULL) { return; }
+        }
+
+        if (image->Row != row || image->Slice != p3)
+        {
+            if (image->IsDirty) { FlushImageDXT(image); }
+
+            const BOOL partial = image->Left != 0 || ((image->Left + image->Width) % IMAGE_DXT_DIMENSION) != 0
+                || row * IMAGE_DXT_DIMENSION < image->Top || image->Top + image->Height < (row + 1) * IMAGE_DXT_DIMENSION;
+
+            if (partial)
+            {
+                const u8* blocks = (u8*)((addr)image->Pixels + (addr)(row * image->Stride) + (addr)(p3 * image->AreaStride));
+
+                DecodeImageDXTBlocks(image->Format, blocks, image->Count, image->Rows, length * sizeof(u32));
+            }
+
+            image->Row = row;
+            image->Slice = p3;
+        }
+
+        CopyMemory(&image->Rows[(line % IMAGE_DXT_DIMENSION) * length + image->Left], pixels, image->Width * sizeof(u32));
+
+        image->IsDirty = TRUE;
+
+        if ((line % IMAGE_DXT_DIMENSION) == (IMAGE_DXT_DIMENSION - 1) || line + 1 == image->Top + image->Height) { FlushImageDXT(image); }
+    }
+
+    // Encodes the written pixels into the row of the blocks they belong to.
+    void FlushImageDXT(ImageDXT* image)
+    {
+        u8* blocks = (u8*)((addr)image->Pixels + (addr)(image->Row * image->Stride) + (addr)(image->Slice * image->AreaStride));
+
+        EncodeImageDXTBlocks(image->Format, image->Rows,
+            image->Count * IMAGE_DXT_DIMENSION * sizeof(u32), image->Count, blocks);
+
+        image->IsDirty = FALSE;
+    }
+
+    // Acquires the size of the block of the format, or zero when the format is not block compressed.
+    u32 AcquireImageDXTBlockSize(const D3DFORMAT format)
+    {
+        switch (format)
+        {
+        case D3DFMT_DXT1: { return 8; }
+        case D3DFMT_DXT2:
+        case D3DFMT_DXT3:
+        case D3DFMT_DXT4:
+        case D3DFMT_DXT5: { return 16; }
+        }
+
+        return 0;
+    }
+
+    // Decodes the row of the blocks into the four rows of the pixels, the stride is in bytes.
+    void DecodeImageDXTBlocks(const D3DFORMAT format, const u8* blocks, const u32 count, u32* pixels, const u32 stride)
+    {
+        const u32 size = AcquireImageDXTBlockSize(format);
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const u8* block = (u8*)((addr)blocks + (addr)(x * size));
+            u32* values = &pixels[x * IMAGE_DXT_DIMENSION];
+
+            switch (format)
+            {
+            case D3DFMT_DXT1: { DecodeImageDXTColors(block, values, stride, TRUE); break; }
+            case D3DFMT_DXT2:
+            case D3DFMT_DXT3:
+            {
+                DecodeImageDXTColors((u8*)((addr)block + (addr)8), values, stride, FALSE);
+                DecodeImageDXTExplicitAlphas(block, values, stride);
+
+                break;
+            }
+            case D3DFMT_DXT4:
+            case D3DFMT_DXT5:
+            {
+                DecodeImageDXTColors((u8*)((addr)block + (addr)8), values, stride, FALSE);
+                DecodeImageDXTInterpolatedAlphas(block, values, stride);
+
+                break;
+            }
+            }
+        }
+    }
+
+    // Encodes the four rows of the pixels into the row of the blocks, the stride is in bytes.
+    void EncodeImageDXTBlocks(const D3DFORMAT format, const u32* pixels, const u32 stride, const u32 count, u8* blocks)
+    {
+        const u32 size = AcquireImageDXTBlockSize(format);
+
+        u32 values[IMAGE_DXT_DIMENSION_SEGMENT];
+
+        for (u32 x = 0; x < count; x++)
+        {
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                CopyMemory(&values[xx * IMAGE_DXT_DIMENSION],
+                    (void*)((addr)pixels + (addr)(xx * stride) + (addr)(x * IMAGE_DXT_DIMENSION * sizeof(u32))), IMAGE_DXT_DIMENSION * sizeof(u32));
+            }
+
+            u8* block = (u8*)((addr)blocks + (addr)(x * size));
+
+            switch (format)
+            {
+            case D3DFMT_DXT1: { EncodeImageDXTColors(values, block, TRUE); break; }
+            case D3DFMT_DXT2:
+            case D3DFMT_DXT3:
+            {
+                EncodeImageDXTExplicitAlphas(values, block);
+                EncodeImageDXTColors(values, (u8*)((addr)block + (addr)8), FALSE);
+
+                break;
+            }
+            case D3DFMT_DXT4:
+            case D3DFMT_DXT5:
+            {
+                EncodeImageDXTInterpolatedAlphas(values, block);
+                EncodeImageDXTColors(values, (u8*)((addr)block + (addr)8), FALSE);
+
+                break;
+            }
+            }
+        }
+    }
+
+    // Decodes the rows of the blocks of the task into the destination image.
+    void DecodeImageDXTRows(ImageDXTTask* task)
+    {
+        ImageDXT* src = task->Source;
+        ImageBitMap* dst = task->Destination;
+
+        const u32 length = src->Count * IMAGE_DXT_DIMENSION;
+
+        u32* pixels = (u32*)malloc(IMAGE_DXT_DIMENSION * length * sizeof(u32));
+
+        if (pixels == NULL) { task->Result = DDERR_OUTOFMEMORY; return; }
+
+        for (u32 x = task->Start; x < task->End; x++)
+        {
+            DecodeImageDXTBlocks(src->Format, (u8*)((addr)src->Pixels + (addr)(x * src->Stride)), src->Count, pixels, length * sizeof(u32));
+
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                const u32 line = x * IMAGE_DXT_DIMENSION + xx;
+
+                if (line < src->Top) { continue; }
+                if (dst->Height <= line - src->Top) { break; }
+
+                u32* colors = &pixels[xx * length + src->Left];
+
+                if (src->Color != 0)
+                {
+                    for (u32 xxx = 0; xxx < src->Width; xxx++)
+                    {
+                        if (colors[xxx] == src->Color) { colors[xxx] = GRAPCHICS_COLOR_BLACK; }
+                    }
+                }
+
+                dst->Calls->Write(colors, (void*)((addr)dst->Pixels + (addr)((line - src->Top) * dst->Stride)), dst->Width, dst->Palette);
+            }
+        }
+
+        free(pixels);
+
+        task->Result = D3D_OK;
+    }
+
+    DWORD WINAPI DecodeImageDXTThread(LPVOID context)
+    {
+        DecodeImageDXTRows((ImageDXTTask*)context);
+
+        return 0;
+    }
+
+    // Decodes the block compressed image into the bitmap image of the same size.
+    // NOTE: The large images are split by the rows of the blocks across the worker threads, when allowed to,
+    // so that the mip levels of large textures are decoded by all of the processors. The images copied by the threads
+    // that already run one per processor are not split, as the extra threads would only compete with them.
+    HRESULT CopyImageDXT(ImageDXT* src, ImageBitMap* dst, const BOOL split)
+    {
+        const u32 rows = (src->Top + src->Height + IMAGE_DXT_DIMENSION - 1) / IMAGE_DXT_DIMENSION;
+
+        u32 count = 1;
+
+        if (split && MIN_IMAGE_DXT_THREAD_PIXEL_COUNT <= src->Width * src->Height)
+        {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+
+            count = Min(Clamp((u32)info.dwNumberOfProcessors, (u32)1, (u32)MAX_IMAGE_DXT_THREAD_COUNT), rows);
+        }
+
+        ImageDXTTask tasks[MAX_IMAGE_DXT_THREAD_COUNT];
+        HANDLE threads[MAX_IMAGE_DXT_THREAD_COUNT];
+
+        for (u32 x = 0; x < count; x++)
+        {
+            tasks[x].Source = src;
+            tasks[x].Destination = dst;
+            tasks[x].Start = rows * x / count;
+            tasks[x].End = rows * (x + 1) / count;
+            tasks[x].Result = D3D_OK;
+
+            threads[x] = NULL;
+        }
+
+        for (u32 x = 1; x < count; x++)
+        {
+            threads[x] = CreateThread(NULL, 0, DecodeImageDXTThread, &tasks[x], 0, NULL);
+
+            if (threads[x] == NULL) { DecodeImageDXTRows(&tasks[x]); }
+        }
+
+        DecodeImageDXTRows(&tasks[0]);
+
+        HRESULT result = D3D_OK;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            if (threads[x] != NULL)
+            {
+                WaitForSingleObject(threads[x], INFINITE);
+                CloseHandle(threads[x]);
+            }
+
+            if (tasks[x].Result != D3D_OK) { result = tasks[x].Result; }
+        }
+
+        return result;
+    }
+
+    // Initializes the bitmap image over the area of the pixels described by the arguments.
+    void InitializeImageBitMap(AbstractImage* image, ImageContainerArgs* args, const u32 bits, const u32 type)
+    {
+        ImageBitMap* bm = (ImageBitMap*)image;
+
+        bm->Format = args->Format;
+        bm->Bits = bits;
+
+        bm->Stride = args->Stride;
+        bm->AreaStride = args->AreaStride;
+
+        bm->Width = args->Dimensions.Right - args->Dimensions.Left;
+        bm->Height = args->Dimensions.Bottom - args->Dimensions.Top;
+        bm->Depth = args->Dimensions.Min < args->Dimensions.Max ? args->Dimensions.Max - args->Dimensions.Min : 1;
+
+        bm->Pixels = (u8*)args->Pixels;
+
+        // NOTE: The block compressed images address the pixels by the blocks.
+        if (bits != 0)
+        {
+            bm->Pixels = (u8*)((addr)bm->Pixels + (addr)(args->Dimensions.Top * args->Stride)
+                + (addr)(args->Dimensions.Min * args->AreaStride) + (addr)(args->Dimensions.Left * (bits >> 3)));
+        }
+
+        bm->Calls = AcquireImagePixelCalls(args->Format);
+
+        bm->Color = args->Color;
+
+        if (type == 2 && args->Palette != NULL)
+        {
+            const PALETTEENTRY* palette = (PALETTEENTRY*)args->Palette;
+
+            for (u32 x = 0; x < MAX_IMAGE_PALETTE_VALUES_COUNT; x++)
+            {
+                bm->Palette[x] = ((u32)palette[x].peFlags << 24) | ((u32)palette[x].peRed << 16)
+                    | ((u32)palette[x].peGreen << 8) | (u32)palette[x].peBlue;
+            }
+        }
+        else
+        {
+            for (u32 x = 0; x < MAX_IMAGE_PALETTE_VALUES_COUNT; x++)
+            {
+                bm->Palette[x] = 0xFF000000 | (x * 0x00010101);
+            }
+        }
+    }
+
+    // NOTE: The pair of the pixels shares the chroma, so both of the formats are read and written by the pairs of 16-bit pixels.
+    void InitializeImageYUVY(AbstractImage* image, ImageContainerArgs* args)
+    {
+        InitializeImageBitMap(image, args, GRAPHICS_BITS_PER_PIXEL_16, 1);
+    }
+
+    void* ReleaseImageBitMap(ImageBitMap* image, const u32 mode)
+    {
+        if (mode & IMAGE_RELEASE_DISPOSE) { free(image); }
+
+        return image;
+    }
+
+    // Reads the row of the pixels of the image as A8R8G8B8 colors.
+    void ReadImageBitMap(ImageBitMap* image, const u32 row, const u32 slice, u32* pixels)
+    {
+        const void* values = (void*)((addr)image->Pixels + (addr)(row * image->Stride) + (addr)(slice * image->AreaStride));
+
+        image->Calls->Read(values, pixels, image->Width, image->Palette);
+    }
+
+    // Writes the row of A8R8G8B8 colors into the pixels of the image.
+    void WriteImageBitMap(ImageBitMap* image, const u32 row, const u32 slice, u32* pixels)
+    {
+        void* values = (void*)((addr)image->Pixels + (addr)(row * image->Stride) + (addr)(slice * image->AreaStride));
+
+        image->Calls->Write(pixels, values, image->Width, image->Palette);
+    }
+
+    // Copies the pixels of the source image into the destination one.
+    // NOTE: The images of the same format, size, and palette are copied row by row, the rest are converted
+    // through the rows of A8R8G8B8 colors, with the source resampled to the nearest pixel when the sizes differ.
+    HRESULT CopyImageContainer(ImageContainer* img)
+    {
+        ImageBitMap* src = (ImageBitMap*)img->Source;
+        ImageBitMap* dst = (ImageBitMap*)img->Destination;
+
+        if (dst->Width == 0 || dst->Height == 0 || src->Width == 0 || src->Height == 0) { return D3D_OK; }
+
+        if (MAX_IMAGE_ROW_PIXEL_COUNT < src->Width || MAX_IMAGE_ROW_PIXEL_COUNT < dst->Width) { return DDERR_GENERIC; }
 
-        for (u32 x = 0; x < 4; x++)
+        if (AcquireImageDXTBlockSize(src->Format) != 0)
+        {
+            ImageDXT* dxt = (ImageDXT*)src;
+
+            if (src->Format == dst->Format)
+            {
+                ImageDXT* image = (ImageDXT*)dst;
+
+                // NOTE: The blocks of the areas aligned to the blocks are copied as they are.
+                if (dxt->Left == 0 && dxt->Top == 0 && image->Left == 0 && image->Top == 0 && src->Color == 0
+                    && src->Width == dst->Width && src->Height == dst->Height && src->Depth == dst->Depth)
+                {
+                    const u32 length = dxt->Count * AcquireImageDXTBlockSize(src->Format);
+                    const u32 rows = (src->Height + IMAGE_DXT_DIMENSION - 1) / IMAGE_DXT_DIMENSION;
+
+                    for (u32 z = 0; z < dst->Depth; z++)
+                    {
+                        for (u32 y = 0; y < rows; y++)
+                        {
+                            CopyMemory((void*)((addr)dst->Pixels + (addr)(y * dst->Stride) + (addr)(z * dst->AreaStride)),
+                                (void*)((addr)src->Pixels + (addr)(y * src->Stride) + (addr)(z * src->AreaStride)), length);
+                        }
+                    }
+
+                    return D3D_OK;
+                }
+            }
+            else if (dst->Calls != NULL && src->Width == dst->Width && src->Height == dst->Height && src->Depth == 1 && dst->Depth == 1)
+            {
+                return CopyImageDXT(dxt, dst, (img->Unk02 & IMAGE_CONTAINER_OPTIONS_SINGLE_THREAD) == 0);
+            }
+        }
+
+        if (src->Format == dst->Format && src->Bits != 0 && src->Color == 0
+            && src->Width == dst->Width && src->Height == dst->Height && src->Depth == dst->Depth
+            && memcmp(src->Palette, dst->Palette, MAX_IMAGE_PALETTE_VALUES_COUNT * sizeof(u32)) == 0)
+        {
+            const u32 length = src->Width * (src->Bits >> 3);
+
+            for (u32 z = 0; z < dst->Depth; z++)
+            {
+                for (u32 y = 0; y < dst->Height; y++)
+                {
+                    CopyMemory((void*)((addr)dst->Pixels + (addr)(y * dst->Stride) + (addr)(z * dst->AreaStride)),
+                        (void*)((addr)src->Pixels + (addr)(y * src->Stride) + (addr)(z * src->AreaStride)), length);
+                }
+            }
+
+            return D3D_OK;
+        }
+
+        u32 colors[MAX_IMAGE_ROW_PIXEL_COUNT];
+        u32 pixels[MAX_IMAGE_ROW_PIXEL_COUNT];
+
+        const BOOL isScale = src->Width != dst->Width;
+
+        for (u32 z = 0; z < dst->Depth; z++)
+        {
+            const u32 slice = z * src->Depth / dst->Depth;
+
+            for (u32 y = 0; y < dst->Height; y++)
+            {
+                src->Self->Read((AbstractImage*)src, y * src->Height / dst->Height, slice, colors);
+
+                if (src->Color != 0)
+                {
+                    for (u32 x = 0; x < src->Width; x++)
+                    {
+                        if (colors[x] == src->Color) { colors[x] = GRAPCHICS_COLOR_BLACK; }
+                    }
+                }
+
+                if (isScale)
+                {
+                    for (u32 x = 0; x < dst->Width; x++)
+                    {
+                        pixels[x] = colors[x * src->Width / dst->Width];
+                    }
+
+                    dst->Self->Write((AbstractImage*)dst, y, z, pixels);
+                }
+                else
+                {
+                    dst->Self->Write((AbstractImage*)dst, y, z, colors);
+                }
+            }
+        }
+
+        return D3D_OK;
+    }
+
+    // Acquires the pixel conversion calls of the format, or NULL when the format is not a plain bitmap.
+    ImagePixelCalls* AcquireImagePixelCalls(const D3DFORMAT format)
+    {
+        for (u32 x = 0; ImagePixelConverters[x].Format != D3DFMT_UNKNOWN; x++)
         {
-            if (image->field4193_0x1064[x] != NULL) { free(image->field4193_0x1064[x]); }
+            if (ImagePixelConverters[x].Format == format) { return &ImagePixelConverters[x]; }
         }
 
-        FUN_6000cdf2(image);
+        return NULL;
     }
 }
\ No newline at end of file
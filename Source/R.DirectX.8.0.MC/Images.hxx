@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "Basic.hxx"
 #include "DirectX.hxx"
+#include "ImagePixels.hxx"
 
 #define IMAGE_RELEASE_NONE 0
 #define IMAGE_RELEASE_DISPOSE 1
@@ -37,16 +38,19 @@ SOFTWARE.
 #define IMAGE_CONTAINER_OPTIONS_LOW_VALUE_MASK      0x0000FFFF
 #define IMAGE_CONTAINER_OPTIONS_HIGH_VALUE_MASK     0xFFF00000
 
+#define IMAGE_CONTAINER_OPTIONS_SINGLE_THREAD       0x00040000 // NOTE: The image is copied on the calling thread only.
 #define IMAGE_CONTAINER_OPTIONS_GRADIENT            0x00080000
 
 #define IMAGE_CONTAINER_OPTIONS_INVALID             0xFFFFFFFF
 
-#define MAX_IMAGE_PALETTE_VALUES_COUNT 256
-
 #define MAX_IMAGE_COLOR_MODIFIER_VALUES_COUNT 32
 
-#define IMAGE_DXT_DIMENSION 4
-#define IMAGE_DXT_DIMENSION_SEGMENT (IMAGE_DXT_DIMENSION * IMAGE_DXT_DIMENSION)
+#define MAX_IMAGE_ROW_PIXEL_COUNT 4096
+
+#define IMAGE_DXT_INVALID_ROW 0xFFFFFFFF
+
+#define MAX_IMAGE_DXT_THREAD_COUNT 8
+#define MIN_IMAGE_DXT_THREAD_PIXEL_COUNT (256 * 256)
 
 namespace Images
 {
@@ -133,6 +137,18 @@ namespace Images
 
     struct AbstractImage;
 
+    typedef void (*READIMAGEPIXELSCALL)(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    typedef void (*WRITEIMAGEPIXELSCALL)(const u32* colors, void* pixels, const u32 count, const u32* palette);
+
+    // NOTE: Converts the rows of the pixels of the format from and into the canonical A8R8G8B8 colors.
+    // The signed channels of the bump map formats are biased by a half, and are read in U, V, W or L, Q order as R, G, B, A.
+    struct ImagePixelCalls
+    {
+        D3DFORMAT Format;
+        READIMAGEPIXELSCALL Read;
+        WRITEIMAGEPIXELSCALL Write;
+    };
+
     typedef void* (*RELEASEIMAGECALL)(AbstractImage* image, const u32 mode);
     typedef void* (*READIMAGECALL)(AbstractImage* image, const u32 p2, const u32 p3, u32* pixels);
     typedef void* (*WRITEDIMAGECALL)(AbstractImage* image, const u32 p2, const u32 p3, u32* pixels);
@@ -156,44 +172,71 @@ namespace Images
         u32 Unk02;
     };
 
-    struct ImageContainerArgs
-    {
-        void* Pixels;
-        D3DFORMAT Format;
-        u32 Stride;
-        s32 Unk03; // TODO
-        s32 Unk04; // TODO
-        s32 Unk05; // TODO
-        s32 Unk06; // TODO
-        s32 Unk07; // TODO
-        s32 Unk08; // TODO
-        s32 Unk09; // TODO
-        s32 Unk10; // TODO
-        s32 Unk11; // TODO
-        s32 Unk12; // TODO
-        s32 Unk13; // TODO
-        s32 Unk14; // TODO
-        s32 Unk15; // TODO
-        s32 Unk16; // TODO
-        s32 Unk17; // TODO
-        s32 Unk18; // TODO
-    };
-
     // INHERITANCE: AbstractImage
     struct ImageBitMap
     {
         ImageCalls* Self;
 
-        char Unk00[0x1060];
+        D3DFORMAT Format;
+        u32 Bits;
+
+        u8* Pixels;
+        u32 Stride;
+        u32 AreaStride;
+
+        u32 Width;
+        u32 Height;
+        u32 Depth;
+
+        ImagePixelCalls* Calls;
+
+        u32 Color;
+
+        u32 Palette[MAX_IMAGE_PALETTE_VALUES_COUNT];
     };
 
     // INHERITANCE: ImageBitMap
     struct ImageDXT
     {
         ImageCalls* Self;
+
         D3DFORMAT Format;
+        u32 Bits;
+
+        u8* Pixels;
+        u32 Stride;
+        u32 AreaStride;
+
+        u32 Width;
+        u32 Height;
+        u32 Depth;
+
+        ImagePixelCalls* Calls;
 
-        char Unk00[0x10a0];
+        u32 Color;
+
+        u32 Palette[MAX_IMAGE_PALETTE_VALUES_COUNT];
+
+        u32 Left; // The offset of the area within the first column of the blocks.
+        u32 Top; // The offset of the area within the first row of the blocks.
+        u32 Count; // The number of the blocks in a row of the area.
+
+        u32 Row; // The row of the blocks decoded into the pixels.
+        u32 Slice; // The slice of the row of the blocks decoded into the pixels.
+        u32* Rows; // The pixels of the decoded row of the blocks.
+
+        BOOL IsDirty; // The pixels hold the written rows, that are not yet encoded into the blocks.
+    };
+
+    struct ImageDXTTask
+    {
+        ImageDXT* Source;
+        ImageBitMap* Destination;
+
+        u32 Start; // The first row of the blocks.
+        u32 End; // The row of the blocks past the last one.
+
+        HRESULT Result;
     };
 
     // INHERITANCE: ImageBitMap
@@ -213,6 +256,23 @@ namespace Images
     void DisposeAbstractImageDXT(ImageDXT* image);
     void ReadImageDXT(ImageDXT* image, const u32 p2, const u32 p3, u32* pixels);
     void WriteImageDXT(ImageDXT* image, const u32 p2, const u32 p3, u32* pixels);
+    void FlushImageDXT(ImageDXT* image);
     void* ReleaseAbstractImageDXT(ImageDXT* image, const u32 mode);
     void* ReleaseImageDXT(ImageDXT* image, const u32 mode);
+
+    u32 AcquireImageDXTBlockSize(const D3DFORMAT format);
+    void DecodeImageDXTBlocks(const D3DFORMAT format, const u8* blocks, const u32 count, u32* pixels, const u32 stride);
+    void DecodeImageDXTRows(ImageDXTTask* task);
+    void EncodeImageDXTBlocks(const D3DFORMAT format, const u32* pixels, const u32 stride, const u32 count, u8* blocks);
+    DWORD WINAPI DecodeImageDXTThread(LPVOID context);
+    HRESULT CopyImageDXT(ImageDXT* src, ImageBitMap* dst, const BOOL split);
+
+    void InitializeImageBitMap(AbstractImage* image, ImageContainerArgs* args, const u32 bits, const u32 type);
+    void InitializeImageYUVY(AbstractImage* image, ImageContainerArgs* args);
+    void ReadImageBitMap(ImageBitMap* image, const u32 row, const u32 slice, u32* pixels);
+    void WriteImageBitMap(ImageBitMap* image, const u32 row, const u32 slice, u32* pixels);
+    void* ReleaseImageBitMap(ImageBitMap* image, const u32 mode);
+    HRESULT CopyImageContainer(ImageContainer* img);
+
+    ImagePixelCalls* AcquireImagePixelCalls(const D3DFORMAT format);
 }
\ No newline at end of file
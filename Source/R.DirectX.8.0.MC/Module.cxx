@@ -88,6 +88,15 @@ namespace RendererModule
         State.ViewPort.X1 = x1 - x0;
         State.ViewPort.Y1 = y1 - y0;
 
+        // NOTE: The primitives are clipped on the CPU as they are appended, thus the pending packets are neither drawn nor split,
+        // and the device viewport keeps covering the whole window.
+        if (SettingsState.ViewPortClipping)
+        {
+            SelectRendererClipRectangle(x0, y0, x1, y1);
+
+            return RENDERER_MODULE_SUCCESS;
+        }
+
         RenderPackets();
         AttemptRenderPackets();
 
@@ -214,35 +223,13 @@ namespace RendererModule
     {
         State.Statistics.Lines = State.Statistics.Lines + 1;
 
-        if (AreRenderPacketsComplete(D3DPT_LINELIST, 2)) { RenderScene(); }
+        if (State.Clip.IsActive) { AppendRendererClippedLine(a, b); return; }
 
-        if (State.Data.Packets.Count == 0)
-        {
-            State.Data.Packets.Packets[0].Type = D3DPT_LINELIST;
-            State.Data.Packets.Packets[0].Count = 1;
-            State.Data.Packets.Packets[0].Size = 2;
-
-            State.Data.Packets.Count = 1;
-        }
-        else if (State.Data.Packets.Packets[State.Data.Packets.Count].Type == D3DPT_LINELIST)
-        {
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count =
-                State.Data.Packets.Packets[State.Data.Packets.Count].Count + 1;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size =
-                State.Data.Packets.Packets[State.Data.Packets.Count].Size + 2;
-        }
-        else
-        {
-            State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_LINELIST;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count = 1;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size = 2;
+        if (AreRenderPacketsComplete(D3DPT_LINELIST, 2)) { RenderScene(); }
 
-            State.Data.Packets.Count = State.Data.Packets.Count + 1;
-        }
+        AppendRendererPacket(D3DPT_LINELIST, 1, 2);
 
-        BYTE* lock;
-        State.Data.Vertexes.Buffer->Lock(
-            State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * 2, &lock, D3DLOCK_NOOVERWRITE);
+        BYTE* lock = LockRendererVertexes(2);
 
         RTLVX* va = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * 0));
         RTLVX* vb = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * 1));
@@ -250,8 +237,7 @@ namespace RendererModule
         CopyMemory(va, a, RendererVertexSize);
         CopyMemory(vb, b, RendererVertexSize);
 
-        UpdateVertex(va);
-        UpdateVertex(vb);
+        UpdateVertexes((RVX*)lock, 2);
 
         State.Data.Vertexes.Buffer->Unlock();
 
@@ -264,40 +250,7 @@ namespace RendererModule
     {
         State.Statistics.Lines = State.Statistics.Lines + count;
 
-        u32 indxA = 0, indxB = 1;
-
-        for (u32 x = 0; x < count; x++)
-        {
-            if (indexes != NULL)
-            {
-                switch (RendererIndexSize)
-                {
-                case RENDERER_MODULE_INDEX_SIZE_1:
-                {
-                    indxA = ((u8*)indexes)[x * 2 + 0];
-                    indxB = ((u8*)indexes)[x * 2 + 1]; break;
-                }
-                case RENDERER_MODULE_INDEX_SIZE_2:
-                case RENDERER_MODULE_INDEX_SIZE_8:
-                {
-                    indxA = ((u16*)indexes)[x * 2 + 0];
-                    indxB = ((u16*)indexes)[x * 2 + 1]; break;
-                }
-                case RENDERER_MODULE_INDEX_SIZE_4:
-                {
-                    indxA = ((u32*)indexes)[x * 2 + 0];
-                    indxB = ((u32*)indexes)[x * 2 + 1]; break;
-                }
-                }
-            }
-
-            RVX* a = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxA));
-            RVX* b = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxB));
-
-            DrawLine(a, b);
-
-            if (indexes == NULL) { indxA = indxA + 2; indxB = indxB + 2; }
-        }
+        AppendRendererLineMesh(count, vertexes, indexes);
     }
 
     // 0x60003000
@@ -320,45 +273,37 @@ namespace RendererModule
 
         if ((count % 2) == 0)
         {
-            if (AreRenderPacketsComplete(D3DPT_LINESTRIP, count + 1)) { RenderScene(); }
+            if (State.Clip.IsActive)
+            {
+                for (u32 x = 0; x < count; x++)
+                {
+                    AppendRendererClippedLine((RVX*)((addr)vertexes + (addr)(RendererVertexSize * AcquireRendererVertexIndex(indexes, x + 0))),
+                        (RVX*)((addr)vertexes + (addr)(RendererVertexSize * AcquireRendererVertexIndex(indexes, x + 1))));
+                }
 
-            State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_LINESTRIP;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count = count;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size = count + 1;
+                return;
+            }
 
-            State.Data.Packets.Count = State.Data.Packets.Count + 1;
+            if (AreRenderPacketsComplete(D3DPT_LINELIST, count * 2)) { RenderScene(); }
 
-            BYTE* lock;
-            State.Data.Vertexes.Buffer->Lock(
-                State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * (count + 1), &lock, D3DLOCK_NOOVERWRITE);
+            AppendRendererPacket(D3DPT_LINELIST, count, count * 2);
 
-            u32 indx = 0;
+            BYTE* lock = LockRendererVertexes(count * 2);
 
-            for (u32 x = 0; x < count + 1; x++)
+            for (u32 x = 0; x < count; x++)
             {
-                if (indexes != NULL)
-                {
-                    switch (RendererIndexSize)
-                    {
-                    case RENDERER_MODULE_INDEX_SIZE_1: { indx = ((u8*)indexes)[x]; break; }
-                    case RENDERER_MODULE_INDEX_SIZE_2:
-                    case RENDERER_MODULE_INDEX_SIZE_8: { indx = ((u16*)indexes)[x]; break; }
-                    case RENDERER_MODULE_INDEX_SIZE_4: { indx = ((u32*)indexes)[x]; break; }
-                    }
-                }
-
-                RTLVX* src = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * indx));
-                RTLVX* dst = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * x));
+                RTLVX* va = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * (x * 2 + 0)));
+                RTLVX* vb = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * (x * 2 + 1)));
 
-                CopyMemory(dst, src, RendererVertexSize);
-                UpdateVertex(dst);
-
-                if (indexes == NULL) { indx = indx + 1; }
+                CopyMemory(va, (void*)((addr)vertexes + (addr)(RendererVertexSize * AcquireRendererVertexIndex(indexes, x + 0))), RendererVertexSize);
+                CopyMemory(vb, (void*)((addr)vertexes + (addr)(RendererVertexSize * AcquireRendererVertexIndex(indexes, x + 1))), RendererVertexSize);
             }
 
+            UpdateVertexes((RVX*)lock, count * 2);
+
             State.Data.Vertexes.Buffer->Unlock();
 
-            State.Data.Vertexes.Count = State.Data.Vertexes.Count + count + 1;
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + count * 2;
         }
     }
 
@@ -368,35 +313,13 @@ namespace RendererModule
     {
         State.Statistics.Points = State.Statistics.Points + 1;
 
-        if (AreRenderPacketsComplete(D3DPT_POINTLIST, 1)) { RenderScene(); }
-
-        if (State.Data.Packets.Count == 0)
-        {
-            State.Data.Packets.Packets[0].Type = D3DPT_POINTLIST;
-            State.Data.Packets.Packets[0].Count = 1;
-            State.Data.Packets.Packets[0].Size = 1;
+        if (State.Clip.IsActive && AcquireRendererClipCode(&((RTLVX*)vertex)->XYZ) != RENDERER_CLIP_NONE) { return; }
 
-            State.Data.Packets.Count = 1;
-        }
-        else if (State.Data.Packets.Packets[State.Data.Packets.Count].Type == D3DPT_POINTLIST)
-        {
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count =
-                State.Data.Packets.Packets[State.Data.Packets.Count].Count + 1;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size =
-                State.Data.Packets.Packets[State.Data.Packets.Count].Size + 1;
-        }
-        else
-        {
-            State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_POINTLIST;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count = 1;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size = 1;
+        if (AreRenderPacketsComplete(D3DPT_POINTLIST, 1)) { RenderScene(); }
 
-            State.Data.Packets.Count = State.Data.Packets.Count + 1;
-        }
+        AppendRendererPacket(D3DPT_POINTLIST, 1, 1);
 
-        BYTE* lock;
-        State.Data.Vertexes.Buffer->Lock(
-            State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize, &lock, D3DLOCK_NOOVERWRITE);
+        BYTE* lock = LockRendererVertexes(1);
 
         CopyMemory(lock, vertex, RendererVertexSize);
 
@@ -413,24 +336,9 @@ namespace RendererModule
     {
         State.Statistics.Points = State.Statistics.Points + count;
 
-        u32 indx = 0;
-
         for (u32 x = 0; x < count; x++)
         {
-            if (indexes != NULL)
-            {
-                switch (RendererIndexSize)
-                {
-                case RENDERER_MODULE_INDEX_SIZE_1: { indx = ((u8*)indexes)[x]; break; }
-                case RENDERER_MODULE_INDEX_SIZE_2:
-                case RENDERER_MODULE_INDEX_SIZE_8: { indx = ((u16*)indexes)[x]; break; }
-                case RENDERER_MODULE_INDEX_SIZE_4: { indx = ((u32*)indexes)[x]; break; }
-                }
-            }
-
-            DrawPoint((RVX*)((addr)vertexes + (addr)(RendererVertexSize * indx)));
-
-            if (indexes == NULL) { indx = indx + 1; }
+            DrawPoint((RVX*)((addr)vertexes + (addr)(RendererVertexSize * AcquireRendererVertexIndex(indexes, x))));
         }
     }
 
@@ -449,35 +357,19 @@ namespace RendererModule
     {
         State.Statistics.Quads = State.Statistics.Quads + 1;
 
-        if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, 6)) { RenderScene(); }
-
-        if (State.Data.Packets.Count == 0)
+        if (State.Clip.IsActive)
         {
-            State.Data.Packets.Packets[0].Type = D3DPT_TRIANGLELIST;
-            State.Data.Packets.Packets[0].Count = 2;
-            State.Data.Packets.Packets[0].Size = 6;
+            AppendRendererClippedTriangle(a, b, c);
+            AppendRendererClippedTriangle(a, c, d);
 
-            State.Data.Packets.Count = 1;
+            return;
         }
-        else if (State.Data.Packets.Packets[State.Data.Packets.Count].Type == D3DPT_TRIANGLELIST)
-        {
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count =
-                State.Data.Packets.Packets[State.Data.Packets.Count].Count + 2;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size =
-                State.Data.Packets.Packets[State.Data.Packets.Count].Size + 6;
-        }
-        else
-        {
-            State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_TRIANGLELIST;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Count = 2;
-            State.Data.Packets.Packets[State.Data.Packets.Count].Size = 6;
 
-            State.Data.Packets.Count = State.Data.Packets.Count + 1;
-        }
+        if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, 6)) { RenderScene(); }
+
+        AppendRendererPacket(D3DPT_TRIANGLELIST, 2, 6);
 
-        BYTE* lock;
-        State.Data.Vertexes.Buffer->Lock(
-            State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * 6, &lock, D3DLOCK_NOOVERWRITE);
+        BYTE* lock = LockRendererVertexes(6);
 
         {
             RTLVX* va = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * 0));
@@ -487,10 +379,6 @@ namespace RendererModule
             CopyMemory(va, a, RendererVertexSize);
             CopyMemory(vb, b, RendererVertexSize);
             CopyMemory(vc, c, RendererVertexSize);
-
-            UpdateVertex(va);
-            UpdateVertex(vb);
-            UpdateVertex(vc);
         }
 
         {
@@ -500,13 +388,11 @@ namespace RendererModule
 
             CopyMemory(va, a, RendererVertexSize);
             CopyMemory(vc, c, RendererVertexSize);
-            CopyMemory(vc, d, RendererVertexSize);
-
-            UpdateVertex(va);
-            UpdateVertex(vc);
-            UpdateVertex(vd);
+            CopyMemory(vd, d, RendererVertexSize); /* ORIGINAL: CopyMemory(vc, d, RendererVertexSize); */
         }
 
+        UpdateVertexes((RVX*)lock, 6);
+
         State.Data.Vertexes.Buffer->Unlock();
 
         State.Data.Vertexes.Count = State.Data.Vertexes.Count + 6;
@@ -518,52 +404,7 @@ namespace RendererModule
     {
         State.Statistics.Quads = State.Statistics.Quads + count;
 
-        u32 indxA = 0, indxB = 1, indxC = 2, indxD = 3;
-
-        for (u32 x = 0; x < count; x++)
-        {
-            if (indexes != NULL)
-            {
-                switch (RendererIndexSize)
-                {
-                case RENDERER_MODULE_INDEX_SIZE_1:
-                {
-                    indxA = ((u8*)indexes)[x * 4 + 0];
-                    indxB = ((u8*)indexes)[x * 4 + 1];
-                    indxC = ((u8*)indexes)[x * 4 + 2];
-                    indxD = ((u8*)indexes)[x * 4 + 3]; break;
-                }
-                case RENDERER_MODULE_INDEX_SIZE_2:
-                case RENDERER_MODULE_INDEX_SIZE_8:
-                {
-                    indxA = ((u16*)indexes)[x * 4 + 0];
-                    indxB = ((u16*)indexes)[x * 4 + 1];
-                    indxC = ((u16*)indexes)[x * 4 + 2];
-                    indxD = ((u16*)indexes)[x * 4 + 3]; break;
-                }
-                case RENDERER_MODULE_INDEX_SIZE_4:
-                {
-                    indxA = ((u32*)indexes)[x * 4 + 0];
-                    indxB = ((u32*)indexes)[x * 4 + 1];
-                    indxC = ((u32*)indexes)[x * 4 + 2];
-                    indxD = ((u32*)indexes)[x * 4 + 3]; break;
-                }
-                }
-            }
-
-            RVX* a = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxA));
-            RVX* b = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxB));
-            RVX* c = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxC));
-            RVX* d = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxD));
-
-            DrawQuad(a, b, c, d);
-
-            if (indexes == NULL)
-            {
-                indxA = indxA + 4; indxB = indxB + 4;
-                indxC = indxC + 4; indxD = indxD + 4;
-            }
-        }
+        AppendRendererQuadMesh(count, vertexes, indexes);
     }
 
     // 0x60001960
@@ -592,27 +433,8 @@ namespace RendererModule
     {
         for (u32 x = 0; x < count; x++)
         {
-            u32 indxA = 0, indxB = 0;
-
-            switch (RendererIndexSize)
-            {
-            case RENDERER_MODULE_INDEX_SIZE_1:
-            {
-                indxA = ((u8*)indexes)[x * 2 + 0];
-                indxB = ((u8*)indexes)[x * 2 + 1]; break;
-            }
-            case RENDERER_MODULE_INDEX_SIZE_2:
-            case RENDERER_MODULE_INDEX_SIZE_8:
-            {
-                indxA = ((u16*)indexes)[x * 2 + 0];
-                indxB = ((u16*)indexes)[x * 2 + 1]; break;
-            }
-            case RENDERER_MODULE_INDEX_SIZE_4:
-            {
-                indxA = ((u32*)indexes)[x * 2 + 0];
-                indxB = ((u32*)indexes)[x * 2 + 1]; break;
-            }
-            }
+            const u32 indxA = AcquireRendererVertexIndex(indexes, x * 2 + 0);
+            const u32 indxB = AcquireRendererVertexIndex(indexes, x * 2 + 1);
 
             DrawSprite((RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxA)),
                 (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxB)));
@@ -628,35 +450,13 @@ namespace RendererModule
         {
             State.Statistics.Triangles = State.Statistics.Triangles + 1;
 
-            if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, 3)) { RenderScene(); }
-
-            if (State.Data.Packets.Count == 0)
-            {
-                State.Data.Packets.Packets[0].Type = D3DPT_TRIANGLELIST;
-                State.Data.Packets.Packets[0].Count = 1;
-                State.Data.Packets.Packets[0].Size = 3;
+            if (State.Clip.IsActive) { AppendRendererClippedTriangle(a, b, c); return; }
 
-                State.Data.Packets.Count = 1;
-            }
-            else if (State.Data.Packets.Packets[State.Data.Packets.Count].Type == D3DPT_TRIANGLELIST)
-            {
-                State.Data.Packets.Packets[State.Data.Packets.Count].Count =
-                    State.Data.Packets.Packets[State.Data.Packets.Count].Count + 1;
-                State.Data.Packets.Packets[State.Data.Packets.Count].Size =
-                    State.Data.Packets.Packets[State.Data.Packets.Count].Size + 3;
-            }
-            else
-            {
-                State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_TRIANGLELIST;
-                State.Data.Packets.Packets[State.Data.Packets.Count].Count = 1;
-                State.Data.Packets.Packets[State.Data.Packets.Count].Size = 3;
+            if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, 3)) { RenderScene(); }
 
-                State.Data.Packets.Count = State.Data.Packets.Count + 1;
-            }
+            AppendRendererPacket(D3DPT_TRIANGLELIST, 1, 3);
 
-            BYTE* lock;
-            State.Data.Vertexes.Buffer->Lock(
-                State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * 3, &lock, D3DLOCK_NOOVERWRITE);
+            BYTE* lock = LockRendererVertexes(3);
 
             RTLVX* va = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * 0));
             RTLVX* vb = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * 1));
@@ -666,9 +466,7 @@ namespace RendererModule
             CopyMemory(vb, b, RendererVertexSize);
             CopyMemory(vc, c, RendererVertexSize);
 
-            UpdateVertex(va);
-            UpdateVertex(vb);
-            UpdateVertex(vc);
+            UpdateVertexes((RVX*)lock, 3);
 
             State.Data.Vertexes.Buffer->Unlock();
 
@@ -691,44 +489,7 @@ namespace RendererModule
     {
         State.Statistics.Fans = State.Statistics.Fans + 1;
 
-        if (AreRenderPacketsComplete(D3DPT_TRIANGLEFAN, count + 2)) { RenderScene(); }
-
-        State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_TRIANGLEFAN;
-        State.Data.Packets.Packets[State.Data.Packets.Count].Count = count;
-        State.Data.Packets.Packets[State.Data.Packets.Count].Size = count + 2;
-
-        State.Data.Packets.Count = State.Data.Packets.Count + 1;
-
-        BYTE* lock;
-        State.Data.Vertexes.Buffer->Lock(
-            State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * (count + 2), &lock, D3DLOCK_NOOVERWRITE);
-
-        u32 indx = 0;
-
-        for (u32 x = 0; x < count + 2; x++)
-        {
-            if (indexes != NULL)
-            {
-                switch (RendererIndexSize)
-                {
-                case RENDERER_MODULE_INDEX_SIZE_1: { indx = ((u8*)indexes)[x]; break; }
-                case RENDERER_MODULE_INDEX_SIZE_2:
-                case RENDERER_MODULE_INDEX_SIZE_8: { indx = ((u16*)indexes)[x]; break; }
-                case RENDERER_MODULE_INDEX_SIZE_4: { indx = ((u32*)indexes)[x]; break; }
-                }
-            }
-
-            RTLVX* src = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * indx));
-            RTLVX* dst = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * x));
-
-            CopyMemory(dst, src, RendererVertexSize);
-            UpdateVertex(dst);
-
-            if (indexes == NULL) { indx = indx + 1; }
-        }
-
-        State.Data.Vertexes.Buffer->Unlock();
-        State.Data.Vertexes.Count = State.Data.Vertexes.Count + count + 2;
+        AppendRendererTriangles(D3DPT_TRIANGLEFAN, count, vertexes, indexes);
     }
 
     // 0x60002460
@@ -737,44 +498,9 @@ namespace RendererModule
     {
         State.Statistics.Triangles = State.Statistics.Triangles + count;
 
-        u32 indxA = 0, indxB = 1, indxC = 2;
-
-        for (u32 x = 0; x < count; x++)
-        {
-            if (indexes != NULL)
-            {
-                switch (RendererIndexSize)
-                {
-                case RENDERER_MODULE_INDEX_SIZE_1:
-                {
-                    indxA = ((u8*)indexes)[x * 3 + 0];
-                    indxB = ((u8*)indexes)[x * 3 + 1];
-                    indxC = ((u8*)indexes)[x * 3 + 2]; break;
-                }
-                case RENDERER_MODULE_INDEX_SIZE_2:
-                case RENDERER_MODULE_INDEX_SIZE_8:
-                {
-                    indxA = ((u16*)indexes)[x * 3 + 0];
-                    indxB = ((u16*)indexes)[x * 3 + 1];
-                    indxB = ((u16*)indexes)[x * 3 + 2]; break;
-                }
-                case RENDERER_MODULE_INDEX_SIZE_4:
-                {
-                    indxA = ((u32*)indexes)[x * 3 + 0];
-                    indxB = ((u32*)indexes)[x * 3 + 1];
-                    indxB = ((u32*)indexes)[x * 3 + 2]; break;
-                }
-                }
-            }
-
-            RVX* a = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxA));
-            RVX* b = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxB));
-            RVX* c = (RVX*)((addr)vertexes + (addr)(RendererVertexSize * indxC));
-
-            DrawTriangle(a, b, c);
+        if (SettingsState.GeometryCache && RenderRendererMesh(vertexes, indexes, count)) { return; }
 
-            if (indexes == NULL) { indxA = indxA + 3; indxB = indxB + 3; indxC = indxC + 3; }
-        }
+        AppendRendererTriangleMesh(count, vertexes, indexes);
     }
 
     // 0x60002f80
@@ -813,44 +539,7 @@ namespace RendererModule
     {
         State.Statistics.Strips = State.Statistics.Strips + 1;
 
-        if (AreRenderPacketsComplete(D3DPT_TRIANGLESTRIP, count + 2)) { RenderScene(); }
-
-        State.Data.Packets.Packets[State.Data.Packets.Count].Type = D3DPT_TRIANGLESTRIP;
-        State.Data.Packets.Packets[State.Data.Packets.Count].Count = count;
-        State.Data.Packets.Packets[State.Data.Packets.Count].Size = count + 2;
-
-        State.Data.Packets.Count = State.Data.Packets.Count + 1;
-
-        BYTE* lock;
-        State.Data.Vertexes.Buffer->Lock(
-            State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * (count + 2), &lock, D3DLOCK_NOOVERWRITE);
-
-        u32 indx = 0;
-
-        for (u32 x = 0; x < count + 2; x++)
-        {
-            if (indexes != NULL)
-            {
-                switch (RendererIndexSize)
-                {
-                case RENDERER_MODULE_INDEX_SIZE_1: { indx = ((u8*)indexes)[x]; break; }
-                case RENDERER_MODULE_INDEX_SIZE_2:
-                case RENDERER_MODULE_INDEX_SIZE_8: { indx = ((u16*)indexes)[x]; break; }
-                case RENDERER_MODULE_INDEX_SIZE_4: { indx = ((u32*)indexes)[x]; break; }
-                }
-            }
-
-            RTLVX* src = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * indx));
-            RTLVX* dst = (RTLVX*)((addr)lock + (addr)(RendererVertexSize * x));
-
-            CopyMemory(dst, src, RendererVertexSize);
-            UpdateVertex(dst);
-
-            if (indexes == NULL) { indx = indx + 1; }
-        }
-
-        State.Data.Vertexes.Buffer->Unlock();
-        State.Data.Vertexes.Count = State.Data.Vertexes.Count + count + 2;
+        AppendRendererTriangles(D3DPT_TRIANGLESTRIP, count, vertexes, indexes);
     }
 
     // 0x60001300
@@ -897,6 +586,8 @@ namespace RendererModule
     {
         InitializeSettings();
 
+        SelectRendererVertexTransforms();
+
         if (State.DX.Instance == NULL)
         {
             State.DX.Instance = Direct3DCreate8(D3D_SDK_VERSION);
@@ -1002,6 +693,17 @@ namespace RendererModule
         State.Statistics.Strips = 0;
         State.Statistics.Fans = 0;
         State.Statistics.Points = 0;
+        State.Statistics.Filtered = 0;
+        State.Statistics.Batched = 0;
+
+        State.Statistics.MeshHits = 0;
+        State.Statistics.MeshMisses = 0;
+
+        State.Meshes.Frame = State.Meshes.Frame + 1;
+
+        State.DepthRange.IsCleared = FALSE;
+
+        CommitRendererTextureUploads();
 
         BeginRendererScene();
     }
@@ -1173,7 +875,7 @@ namespace RendererModule
             {
                 SelectRendererState(D3DRS_ZWRITEENABLE, FALSE);
                 SelectRendererState(D3DRS_ZENABLE, D3DZB_FALSE);
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_ALWAYS);
+                SelectRendererDepthFunction(D3DCMP_ALWAYS);
 
                 break;
             }
@@ -1181,7 +883,7 @@ namespace RendererModule
             {
                 SelectRendererState(D3DRS_ZWRITEENABLE, TRUE);
                 SelectRendererState(D3DRS_ZENABLE, D3DZB_TRUE);
-                SelectRendererState(D3DRS_ZFUNC, RendererDepthFunction);
+                SelectRendererDepthFunction(RendererDepthFunction);
 
                 break;
             }
@@ -1191,14 +893,14 @@ namespace RendererModule
                 {
                     SelectRendererState(D3DRS_ZENABLE, D3DZB_TRUE);
                     SelectRendererState(D3DRS_ZWRITEENABLE, TRUE);
-                    SelectRendererState(D3DRS_ZFUNC, RendererDepthFunction);
+                    SelectRendererDepthFunction(RendererDepthFunction);
                     SelectRendererState(D3DRS_ZENABLE, D3DZB_USEW);
                 }
                 else
                 {
                     SelectRendererState(D3DRS_ZWRITEENABLE, TRUE);
                     SelectRendererState(D3DRS_ZENABLE, D3DZB_TRUE);
-                    SelectRendererState(D3DRS_ZFUNC, RendererDepthFunction);
+                    SelectRendererDepthFunction(RendererDepthFunction);
 
                     return RENDERER_MODULE_FAILURE;
                 }
@@ -1266,6 +968,8 @@ namespace RendererModule
             default: { return RENDERER_MODULE_FAILURE; }
             }
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE:
@@ -1484,6 +1188,8 @@ namespace RendererModule
 
             RendererFogState = RENDERER_MODULE_FOG_ACTIVE_ALPHAS;
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_FOG_STATE:
@@ -1545,6 +1251,8 @@ namespace RendererModule
             default: { return RENDERER_MODULE_FAILURE; }
             }
 
+            SelectRendererVertexTransforms();
+
             result = RENDERER_MODULE_SUCCESS; break;
         }
         case RENDERER_MODULE_STATE_SELECT_FOG_START:
@@ -1608,7 +1316,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_NEVER;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_NEVER);
+                SelectRendererDepthFunction(D3DCMP_NEVER);
 
                 break;
             }
@@ -1616,7 +1324,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_LESS;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_LESS);
+                SelectRendererDepthFunction(D3DCMP_LESS);
 
                 break;
             }
@@ -1624,7 +1332,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_EQUAL;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_EQUAL);
+                SelectRendererDepthFunction(D3DCMP_EQUAL);
 
                 break;
             }
@@ -1632,7 +1340,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_LESSEQUAL;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
+                SelectRendererDepthFunction(D3DCMP_LESSEQUAL);
 
                 break;
             }
@@ -1640,7 +1348,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_GREATER;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_GREATER);
+                SelectRendererDepthFunction(D3DCMP_GREATER);
 
                 break;
             }
@@ -1648,7 +1356,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_NOTEQUAL;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_NOTEQUAL);
+                SelectRendererDepthFunction(D3DCMP_NOTEQUAL);
 
                 break;
             }
@@ -1656,7 +1364,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_GREATEREQUAL;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_GREATEREQUAL);
+                SelectRendererDepthFunction(D3DCMP_GREATEREQUAL);
 
                 break;
             }
@@ -1664,7 +1372,7 @@ namespace RendererModule
             {
                 RendererDepthFunction = D3DCMP_ALWAYS;
 
-                SelectRendererState(D3DRS_ZFUNC, D3DCMP_ALWAYS);
+                SelectRendererDepthFunction(D3DCMP_ALWAYS);
 
                 break;
             }
@@ -2635,6 +2343,22 @@ namespace RendererModule
     {
         RendererTexture* current = (RendererTexture*)AcquireState(RENDERER_MODULE_STATE_SELECT_TEXTURE);
 
+        // NOTE: The textures of the same atlas are drawn within the same batch, only the transform of the texture coordinates changes.
+        if ((u32)tex >= 16 && tex->Atlas != NULL && State.Textures.Atlases.Current != NULL // TODO
+            && State.Textures.Atlases.Current->Atlas == tex->Atlas && IsRendererTextureAtlasClamped())
+        {
+            if (State.Textures.Atlases.Current != tex)
+            {
+                SelectRendererTextureAtlas(tex);
+
+                State.Statistics.Batched = State.Statistics.Batched + 1;
+            }
+
+            SelectRendererStateValue(RENDERER_MODULE_STATE_SELECT_TEXTURE, tex);
+
+            return RENDERER_MODULE_SUCCESS;
+        }
+
         BeginRendererScene();
         RenderPackets();
 
@@ -2646,6 +2370,8 @@ namespace RendererModule
             {
                 State.DX.Device->SetTexture(x, NULL);
             }
+
+            SelectRendererTextureAtlas(NULL);
         }
         else
         {
@@ -2653,11 +2379,19 @@ namespace RendererModule
             {
                 State.DX.Device->SetTexture((u32)tex - 1, NULL);
 
+                if ((u32)tex - 1 == RENDERER_TEXTURE_STAGE_0) { SelectRendererTextureAtlas(NULL); }
+
                 SelectRendererStateValue(RENDERER_MODULE_STATE_SELECT_TEXTURE, tex);
 
                 return RENDERER_MODULE_SUCCESS;
             }
 
+            // NOTE: Only the texture about to be rendered with waits for its pending upload.
+            WaitRendererTextureUpload(tex);
+
+            // NOTE: The packed textures are moved into the device textures of their own, when their texture coordinates wrap, or mirror.
+            if (tex->Atlas != NULL && !IsRendererTextureAtlasClamped()) { UnpackRendererTexture(tex); }
+
             if (current == tex)
             {
                 SelectRendererStateValue(RENDERER_MODULE_STATE_SELECT_TEXTURE, tex);
@@ -2667,13 +2401,13 @@ namespace RendererModule
 
             State.DX.Device->SetTexture(tex->Stage, tex->Texture);
 
+            // NOTE: The transform of the texture coordinates follows the texture selected into the first stage.
+            if (tex->Stage == RENDERER_TEXTURE_STAGE_0) { SelectRendererTextureAtlas(tex->Atlas != NULL ? tex : NULL); }
+
             palette = tex->Palette;
         }
 
-        if (palette != INVALID_TEXTURE_PALETTE_VALUE)
-        {
-            State.DX.Device->SetCurrentTexturePalette(palette);
-        }
+        if (palette != INVALID_TEXTURE_PALETTE_VALUE) { SelectRendererTexturePalette(palette); }
 
         SelectRendererStateValue(RENDERER_MODULE_STATE_SELECT_TEXTURE, tex);
 
@@ -2794,6 +2528,26 @@ namespace RendererModule
         tex->Palette = INVALID_TEXTURE_PALETTE_VALUE;
         tex->Colors = 0;
 
+        tex->IsCompressed = FALSE;
+        tex->Upload = NULL;
+
+        tex->Atlas = NULL;
+        tex->AtlasX = 0;
+        tex->AtlasY = 0;
+
+        if (palette != RENDERER_MODULE_PALETTE_ACQUIRE)
+        {
+            const D3DFORMAT compression = AcquireRendererTextureCompressionFormat(width, height, format);
+
+            if (compression != D3DFMT_UNKNOWN)
+            {
+                tex->IsCompressed = TRUE;
+                tex->TextureFormat = compression;
+            }
+        }
+
+        // NOTE: The small textures are packed into the shared atlas textures, instead of the device textures of their own.
+        if (!PackRendererTexture(tex))
         {
             const HRESULT result = InitializeRendererTexture(tex);
 
@@ -2836,7 +2590,16 @@ namespace RendererModule
                     else { next->Previous = current->Previous; }
                 }
 
-                if (current->Texture != NULL)
+                CancelRendererTextureUpload(current);
+
+                if (current->Atlas != NULL)
+                {
+                    current->Texture->Release();
+                    current->Texture = NULL;
+
+                    ReleaseRendererTextureAtlas(current);
+                }
+                else if (current->Texture != NULL)
                 {
                     while (current->Texture->Release() != D3D_OK) {}
 
@@ -2884,6 +2647,11 @@ namespace RendererModule
 
         State.Textures.Current = NULL;
 
+        ReleaseRendererTextureAtlases();
+
+        // NOTE: The palettes are handed out from the start again, since the device, along with its palettes, may be created again.
+        IsTexturePaletteInactive = TRUE;
+
         State.Textures.Illegal = FALSE;
 
         BeginRendererScene();
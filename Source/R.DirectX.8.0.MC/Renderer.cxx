@@ -28,11 +28,20 @@ SOFTWARE.
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #define MAX_MESSAGE_BUFFER_LENGTH 512
 
 #define MAX_SETTINGS_BUFFER_LENGTH 80
 
+#define TEXTURE_HASH_PRIME_1 0x9E3779B1
+#define TEXTURE_HASH_PRIME_2 0x85EBCA77
+#define TEXTURE_HASH_PRIME_3 0xC2B2AE3D
+#define TEXTURE_HASH_PRIME_4 0x27D4EB2F
+#define TEXTURE_HASH_PRIME_5 0x165667B1
+
+#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
 using namespace Images;
 using namespace Mathematics;
 using namespace Renderer;
@@ -430,6 +439,10 @@ namespace RendererModule
 
             ResetTextures();
 
+            ReleaseRendererTextureUploads();
+
+            ReleaseRendererTextureCache();
+
             ReleaseRendererWindows();
 
             ReleaseRendererObjects();
@@ -473,6 +486,8 @@ namespace RendererModule
 
         if (code == D3D_OK)
         {
+            InitializeRendererShadowStates();
+
             for (u32 x = 0; x < MAX_DEVICE_CAPABILITIES_COUNT; x++)
             {
                 if (ModuleDescriptor.Capabilities.Capabilities[x].Width != 0)
@@ -726,6 +741,8 @@ namespace RendererModule
 
             State.Data.Vertexes.Buffer = NULL;
         }
+
+        ReleaseRendererMeshes();
     }
 
     // 0x60002250
@@ -748,6 +765,8 @@ namespace RendererModule
     {
         BeginRendererScene();
 
+        if (State.Data.Packets.Count == 0) { return; }
+
         State.DX.Device->SetVertexShader(RendererCurrentShader);
         State.DX.Device->SetStreamSource(0, State.Data.Vertexes.Buffer, RendererVertexSize);
 
@@ -763,6 +782,19 @@ namespace RendererModule
         State.Data.Packets.Count = 0;
     }
 
+    // Locks the space for the vertexes right after the vertexes appended earlier.
+    // The vertex buffer is used as a ring: appending never touches the vertexes the device may still be reading,
+    // and the contents are discarded only once the buffer wraps around, so that the driver can hand out a fresh buffer instead of waiting.
+    BYTE* LockRendererVertexes(const u32 count)
+    {
+        const DWORD flags = State.Data.Vertexes.Count == 0 ? D3DLOCK_DISCARD : D3DLOCK_NOOVERWRITE;
+
+        BYTE* lock = NULL;
+        State.Data.Vertexes.Buffer->Lock(State.Data.Vertexes.Count * RendererVertexSize, RendererVertexSize * count, &lock, flags);
+
+        return lock;
+    }
+
     // 0x60001fd0
     void RenderScene(void)
     {
@@ -776,19 +808,134 @@ namespace RendererModule
     // 0x60001ff0
     void UpdateVertex(RTLVX* vertex)
     {
-        vertex->XYZ.X = vertex->XYZ.X - 0.5f;
-        vertex->XYZ.Y = vertex->XYZ.Y - 0.5f;
+        UpdateVertexes((RVX*)vertex, 1);
+    }
+
+    // Applies the active set of vertex transforms to a batch of vertexes in a single pass.
+    // The position offset and the depth range are applied with one packed multiply and addition per vertex,
+    // and the fog alpha indexes are calculated four vertexes at a time.
+    void UpdateVertexes(RVX* vertexes, const u32 count)
+    {
+        const u32 transforms = State.Data.Vertexes.Transforms;
+
+        if (transforms == RENDERER_VERTEX_TRANSFORM_NONE || count == 0) { return; }
+
+        const BOOL isColor = (transforms & RENDERER_VERTEX_TRANSFORM_COLOR) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isFog = (transforms & RENDERER_VERTEX_TRANSFORM_FOG) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isOffset = (transforms & RENDERER_VERTEX_TRANSFORM_OFFSET) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isRange = (transforms & RENDERER_VERTEX_TRANSFORM_RANGE) != RENDERER_VERTEX_TRANSFORM_NONE;
+        const BOOL isAtlas = (transforms & RENDERER_VERTEX_TRANSFORM_ATLAS) != RENDERER_VERTEX_TRANSFORM_NONE;
+
+        // NOTE: The depth range maps Z into [0, 0.5] on the even frames, and into [1, 0.5] on the odd ones.
+        const f32 range = isRange ? (State.DepthRange.IsInverse ? -0.5f : 0.5f) : 1.0f;
+        const f32 base = (isRange && State.DepthRange.IsInverse) ? 1.0f : 0.0f;
+
+        u32 x = 0;
+
+#ifdef RENDERER_MODULE_SIMD
+        const __m128 factor = _mm_setr_ps(1.0f, 1.0f, range, 1.0f);
+        const __m128 delta = _mm_setr_ps(isOffset ? -0.5f : 0.0f, isOffset ? -0.5f : 0.0f, base, 0.0f);
+
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 scale = _mm_set1_ps(255.0f / 65535.0f);
+        const __m128 minimum = _mm_setzero_ps();
+        const __m128 maximum = _mm_set1_ps((f32)MAX_OUTPUT_FOG_ALPHA_VALUE);
+
+        const __m128 stretch = _mm_setr_ps(State.Textures.Atlases.Scale.X, State.Textures.Atlases.Scale.Y, 0.0f, 0.0f);
+        const __m128 shift = _mm_setr_ps(State.Textures.Atlases.Offset.X, State.Textures.Atlases.Offset.Y, 0.0f, 0.0f);
+
+        for (; x + 4 <= count; x = x + 4)
+        {
+            RTLVX* v0 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 0)));
+            RTLVX* v1 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 1)));
+            RTLVX* v2 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 2)));
+            RTLVX* v3 = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * (x + 3)));
+
+            if (isOffset || isRange)
+            {
+                _mm_storeu_ps((f32*)&v0->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v0->XYZ), factor), delta));
+                _mm_storeu_ps((f32*)&v1->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v1->XYZ), factor), delta));
+                _mm_storeu_ps((f32*)&v2->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v2->XYZ), factor), delta));
+                _mm_storeu_ps((f32*)&v3->XYZ, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps((f32*)&v3->XYZ), factor), delta));
+            }
+
+            if (isColor)
+            {
+                v0->Color = GRAPCHICS_COLOR_WHITE;
+                v1->Color = GRAPCHICS_COLOR_WHITE;
+                v2->Color = GRAPCHICS_COLOR_WHITE;
+                v3->Color = GRAPCHICS_COLOR_WHITE;
+            }
+
+            if (isFog)
+            {
+                // NOTE: Rounding of non-negative values is the same as truncation of (value + 0.5).
+                const __m128 value = _mm_add_ps(_mm_div_ps(scale, _mm_setr_ps(v0->RHW, v1->RHW, v2->RHW, v3->RHW)), half);
 
-        if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+                u32 indexes[4];
+                _mm_storeu_si128((__m128i*)indexes, _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(value, minimum), maximum)));
 
-        if (State.Settings.IsFogActive && RendererFogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS)
+                v0->Specular = ((u32)RendererFogAlphas[indexes[0]]) << 24;
+                v1->Specular = ((u32)RendererFogAlphas[indexes[1]]) << 24;
+                v2->Specular = ((u32)RendererFogAlphas[indexes[2]]) << 24;
+                v3->Specular = ((u32)RendererFogAlphas[indexes[3]]) << 24;
+            }
+
+            if (isAtlas)
+            {
+                _mm_storel_pi((__m64*)&v0->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v0->UV), stretch), shift));
+                _mm_storel_pi((__m64*)&v1->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v1->UV), stretch), shift));
+                _mm_storel_pi((__m64*)&v2->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v2->UV), stretch), shift));
+                _mm_storel_pi((__m64*)&v3->UV, _mm_add_ps(_mm_mul_ps(_mm_loadl_pi(minimum, (__m64*)&v3->UV), stretch), shift));
+            }
+        }
+#endif
+
+        for (; x < count; x++)
         {
-            const s32 indx = (s32)roundf(((1.0f / vertex->RHW) / 65535.0f) * 255.0f);
+            RTLVX* vertex = (RTLVX*)((addr)vertexes + (addr)(RendererVertexSize * x));
+
+            if (isOffset)
+            {
+                vertex->XYZ.X = vertex->XYZ.X - 0.5f;
+                vertex->XYZ.Y = vertex->XYZ.Y - 0.5f;
+            }
+
+            if (isRange) { vertex->XYZ.Z = vertex->XYZ.Z * range + base; }
+
+            if (isColor) { vertex->Color = GRAPCHICS_COLOR_WHITE; }
+
+            if (isFog)
+            {
+                const s32 indx = (s32)roundf(((1.0f / vertex->RHW) / 65535.0f) * 255.0f);
+
+                vertex->Specular = RendererFogAlphas[Min(Max(0, indx), MAX_OUTPUT_FOG_ALPHA_VALUE)] << 24;
+            }
 
-            vertex->Specular = RendererFogAlphas[Min(Max(0, indx), 255)] << 24;
+            if (isAtlas)
+            {
+                vertex->UV.X = vertex->UV.X * State.Textures.Atlases.Scale.X + State.Textures.Atlases.Offset.X;
+                vertex->UV.Y = vertex->UV.Y * State.Textures.Atlases.Scale.Y + State.Textures.Atlases.Offset.Y;
+            }
         }
     }
 
+    // Selects the set of vertex transforms matching the current state.
+    void SelectRendererVertexTransforms(void)
+    {
+        u32 transforms = RENDERER_VERTEX_TRANSFORM_OFFSET;
+
+        if (RendererShadeMode == RENDERER_MODULE_SHADE_FLAT) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_COLOR; }
+
+        if (State.Settings.IsFogActive && RendererFogState == RENDERER_MODULE_FOG_ACTIVE_ALPHAS) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_FOG; }
+
+        if (State.DepthRange.IsActive) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_RANGE; }
+
+        if (State.Textures.Atlases.Current != NULL) { transforms = transforms | RENDERER_VERTEX_TRANSFORM_ATLAS; }
+
+        State.Data.Vertexes.Transforms = transforms;
+    }
+
     // 0x60002200
     BOOL BeginRendererScene(void)
     {
@@ -824,6 +971,30 @@ namespace RendererModule
             }
         }
 
+        // NOTE: The block compressed textures the device does not support are decoded on upload
+        // into the best of the uncompressed formats that keeps their alpha.
+        {
+            const u32 formats[] = { RENDERER_PIXEL_FORMAT_DXT1, RENDERER_PIXEL_FORMAT_DXT3, RENDERER_PIXEL_FORMAT_DXT5 };
+
+            for (u32 x = 0; x < 3; x++)
+            {
+                if (State.Textures.Formats[formats[x]] != D3DFMT_UNKNOWN) { continue; }
+
+                const D3DFORMAT fallback = formats[x] == RENDERER_PIXEL_FORMAT_DXT1 ? D3DFMT_A1R5G5B5 : D3DFMT_A4R4G4B4;
+
+                if (State.DX.Instance->CheckDeviceFormat(0, D3DDEVTYPE_HAL,
+                    format, D3DUSAGE_NONE, D3DRTYPE_TEXTURE, D3DFMT_A8R8G8B8) == D3D_OK)
+                {
+                    State.Textures.Formats[formats[x]] = D3DFMT_A8R8G8B8;
+                }
+                else if (State.DX.Instance->CheckDeviceFormat(0, D3DDEVTYPE_HAL,
+                    format, D3DUSAGE_NONE, D3DRTYPE_TEXTURE, fallback) == D3D_OK)
+                {
+                    State.Textures.Formats[formats[x]] = fallback;
+                }
+            }
+        }
+
         for (u32 x = 0; x < MAX_USABLE_TEXTURE_FORMAT_COUNT; x++)
         {
             RendererTextureFormatStates[x] = State.Textures.Formats[x] != D3DFMT_UNKNOWN;
@@ -1007,7 +1178,10 @@ namespace RendererModule
         if (State.DX.Device->CreateVertexBuffer(MAX_VERTEX_BUFFER_SIZE, D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY,
             D3DFVF_NONE, D3DPOOL_DEFAULT, &State.Data.Vertexes.Buffer) == D3D_OK)
         {
-            ZeroMemory(State.Data.Packets.Packets, MAX_RENDER_PACKET_COUNT * sizeof(RendererPacket));
+            if (State.Data.Packets.Packets == NULL && !AllocateRendererPackets(MAX_RENDER_PACKET_COUNT))
+            {
+                LOGWARNING("Unable to allocate render packets, drawing primitives right away.\n");
+            }
 
             State.Data.Packets.Count = 0;
             State.Data.Vertexes.Count = 0;
@@ -1018,988 +1192,3316 @@ namespace RendererModule
     // 0x60001e10
     BOOL AreRenderPacketsComplete(const D3DPRIMITIVETYPE type, const u32 count)
     {
-        BOOL list = FALSE;
-        BOOL result = FALSE;
+        if (MAX_VERTEX_COUNT < State.Data.Vertexes.Count + count) { return TRUE; }
+        if (MAX_VERTEX_COUNT < State.Data.Vertexes.StartIndex + count) { return TRUE; }
+
+        u32 items = 0;
+
+        if (State.Data.Packets.Count != 0)
+        {
+            const RendererPacket* packet = &State.Data.Packets.Packets[State.Data.Packets.Count - 1];
+
+            if (packet->Type == type) { items = packet->Count; }
+        }
+
+        switch (type)
+        {
+        case D3DPT_POINTLIST: { items = items + count; break; }
+        case D3DPT_LINELIST: { items = items + count / 2; break; }
+        case D3DPT_TRIANGLELIST: { items = items + count / 3; break; }
+        }
+
+        return State.Data.MaxPrimitiveCount < items;
+    }
+
+    // Grows the packet storage, so that the packets do not force the scene to be rendered early.
+    BOOL AllocateRendererPackets(const u32 count)
+    {
+        RendererPacket* packets = (RendererPacket*)realloc(State.Data.Packets.Packets, count * sizeof(RendererPacket));
+
+        if (packets == NULL) { return FALSE; }
+
+        State.Data.Packets.Packets = packets;
+        State.Data.Packets.Capacity = count;
+
+        return TRUE;
+    }
+
+    // Releases the packet storage, the pending packets must have been rendered beforehand.
+    void ReleaseRendererPackets(void)
+    {
+        if (State.Data.Packets.Packets != NULL)
+        {
+            free(State.Data.Packets.Packets);
+
+            State.Data.Packets.Packets = NULL;
+        }
 
+        State.Data.Packets.Count = 0;
+        State.Data.Packets.Capacity = 0;
+    }
+
+    // Appends the primitives to the pending packets.
+    // Consecutive packets of the same list type are merged, and are submitted with a single draw call.
+    // The vertexes must be updated and unlocked beforehand, since the primitives may be drawn right away.
+    void AppendRendererPacket(const D3DPRIMITIVETYPE type, const u32 count, const u32 size)
+    {
         if (State.Data.Packets.Count != 0)
         {
-            if (State.Data.Packets.Packets[State.Data.Packets.Count].Type == type)
+            RendererPacket* packet = &State.Data.Packets.Packets[State.Data.Packets.Count - 1];
+
+            if (packet->Type == type)
+            {
+                packet->Count = packet->Count + count;
+                packet->Size = packet->Size + size;
+
+                return;
+            }
+        }
+
+        if (State.Data.Packets.Capacity <= State.Data.Packets.Count)
+        {
+            if (!AllocateRendererPackets(Max((u32)MAX_RENDER_PACKET_COUNT, State.Data.Packets.Capacity * 2)))
             {
-                switch (type)
+                RenderPackets();
+
+                // NOTE: Without any packet storage, the primitives are drawn right away, same as a single packet is.
+                if (State.Data.Packets.Capacity == 0)
                 {
-                case D3DPT_POINTLIST:
-                case D3DPT_LINELIST:
-                case D3DPT_TRIANGLELIST: { list = TRUE; break; }
-                case D3DPT_LINESTRIP:
-                case D3DPT_TRIANGLESTRIP:
-                case D3DPT_TRIANGLEFAN: { if (State.Data.Packets.Count + 1 >= MAX_RENDER_PACKET_COUNT) { result = TRUE; } break; }
+                    State.DX.Device->SetVertexShader(RendererCurrentShader);
+                    State.DX.Device->SetStreamSource(0, State.Data.Vertexes.Buffer, RendererVertexSize);
+
+                    State.DX.Device->DrawPrimitive(type, State.Data.Vertexes.StartIndex, count);
+
+                    State.Data.Vertexes.StartIndex = State.Data.Vertexes.StartIndex + size;
+
+                    return;
                 }
             }
-            else if (State.Data.Packets.Count + 1 >= MAX_RENDER_PACKET_COUNT) { result = TRUE; }
         }
 
-        if (MAX_VERTEX_COUNT < State.Data.Vertexes.Count + count) { result = TRUE; }
-        if (MAX_VERTEX_COUNT < State.Data.Vertexes.StartIndex + count) { return TRUE; }
+        RendererPacket* packet = &State.Data.Packets.Packets[State.Data.Packets.Count];
 
-        if (!result)
+        packet->Type = type;
+        packet->Count = count;
+        packet->Size = size;
+
+        State.Data.Packets.Count = State.Data.Packets.Count + 1;
+    }
+
+    // Clips the convex polygon against a single edge of the clip rectangle.
+    template <typename V> u32 ClipRendererPolygonEdge(V* input, const u32 count, V* output, const u32 edge)
+    {
+        u32 result = 0;
+
+        for (u32 x = 0; x < count; x++)
         {
-            u32 items = 0;
+            V* a = &input[x];
+            V* b = &input[(x + 1) % count];
 
-            if (list) { items = State.Data.Packets.Packets[State.Data.Packets.Count].Count; }
+            const f32 da = AcquireRendererClipDistance(&a->XYZ, edge);
+            const f32 db = AcquireRendererClipDistance(&b->XYZ, edge);
+
+            if (0.0f <= da)
+            {
+                output[result] = *a;
 
-            switch (type) {
-            case D3DPT_LINELIST: { items = items + count / 2; break; }
-            case D3DPT_LINESTRIP: { items = (items - 1) + count; break; }
-            case D3DPT_TRIANGLELIST: { items = items + (count / 3);  break; }
-            case D3DPT_POINTLIST: { items = items + count; break; }
-            case D3DPT_TRIANGLESTRIP:
-            case D3DPT_TRIANGLEFAN: { items = (items - 2) + count; break; }
+                result = result + 1;
             }
 
-            if (State.Data.MaxPrimitiveCount < items) { return TRUE; }
+            if ((0.0f <= da) != (0.0f <= db))
+            {
+                InterpolateRendererVertex(&output[result], a, b, da / (da - db));
+
+                result = result + 1;
+            }
         }
 
         return result;
     }
 
-    // 0x60003ab0
-    u32 STDCALLAPI InitializeRendererDeviceSurfacesExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result)
+    // Clips the convex polygon against the clip rectangle, one edge at a time, the result ends up in the vertexes.
+    // Both of the arrays must fit MAX_CLIP_VERTEX_COUNT vertexes, which is enough for a triangle.
+    template <typename V> u32 ClipRendererPolygon(V* vertexes, V* buffer, const u32 count)
     {
-        if (State.Lock.IsActive) { UnlockGameWindow(NULL); }
+        u32 result = count;
 
-        AttemptRenderPackets();
+        result = ClipRendererPolygonEdge(vertexes, result, buffer, RENDERER_CLIP_LEFT);
+        result = ClipRendererPolygonEdge(buffer, result, vertexes, RENDERER_CLIP_RIGHT);
+        result = ClipRendererPolygonEdge(vertexes, result, buffer, RENDERER_CLIP_TOP);
+        result = ClipRendererPolygonEdge(buffer, result, vertexes, RENDERER_CLIP_BOTTOM);
 
-        ReleaseRendererWindows();
+        return result;
+    }
 
-        ResetTextures();
+    // Clips the line against the clip rectangle, returns FALSE when the line is completely outside of it.
+    template <typename V> BOOL ClipRendererSegment(V* a, V* b)
+    {
+        f32 start = 0.0f;
+        f32 end = 1.0f;
 
-        if (State.DX.Device != NULL)
+        for (u32 x = RENDERER_CLIP_LEFT; x <= RENDERER_CLIP_BOTTOM; x = x << 1)
         {
-            ReleaseRendererObjects();
+            const f32 da = AcquireRendererClipDistance(&a->XYZ, x);
+            const f32 db = AcquireRendererClipDistance(&b->XYZ, x);
 
-            while (State.DX.Device->Release() != D3D_OK) {}
+            if (da < 0.0f && db < 0.0f) { return FALSE; }
 
-            State.DX.Device = NULL;
-        }
+            if (da < 0.0f)
+            {
+                const f32 value = da / (da - db);
 
-        if (State.DX.Instance != NULL)
-        {
-            while (State.DX.Instance->Release() != D3D_OK) {}
+                if (start < value) { start = value; }
+            }
+            else if (db < 0.0f)
+            {
+                const f32 value = da / (da - db);
 
-            State.DX.Instance = NULL;
+                if (value < end) { end = value; }
+            }
         }
 
-        State.Scene.IsActive = FALSE;
+        if (end < start) { return FALSE; }
 
-        State.DX.Surfaces.Surfaces[2] = NULL;
-        State.DX.Surfaces.Surfaces[3] = NULL;
+        const V va = *a;
+        const V vb = *b;
 
-        State.Device.Index = DEFAULT_DEVICE_INDEX;
+        if (start != 0.0f) { InterpolateRendererVertex(a, &va, &vb, start); }
+        if (end != 1.0f) { InterpolateRendererVertex(b, &va, &vb, end); }
 
-        State.Lambdas.Log = NULL;
+        return TRUE;
+    }
 
-        IsRendererInit = FALSE;
+    // Clips the triangle against the clip rectangle, and writes the visible part of it as a list of triangles.
+    // Acquires the number of the triangles written, up to MAX_CLIP_TRIANGLE_COUNT.
+    template <typename V> u32 ClipRendererTriangle(V* a, V* b, V* c, V* output)
+    {
+        const u32 ca = AcquireRendererClipCode(&a->XYZ);
+        const u32 cb = AcquireRendererClipCode(&b->XYZ);
+        const u32 cc = AcquireRendererClipCode(&c->XYZ);
 
-        State.Window.HWND = NULL;
+        if ((ca & cb & cc) != RENDERER_CLIP_NONE) { return 0; }
 
-        if (result != NULL)
+        if ((ca | cb | cc) == RENDERER_CLIP_NONE)
         {
-            SetEvent(State.Mutexes.Surface);
+            output[0] = *a;
+            output[1] = *b;
+            output[2] = *c;
 
-            *result = RENDERER_MODULE_SUCCESS;
+            return 1;
         }
 
-        return RENDERER_MODULE_SUCCESS;
-    }
+        V vertexes[MAX_CLIP_VERTEX_COUNT];
+        V buffer[MAX_CLIP_VERTEX_COUNT];
 
-    // 0x60008bc0
-    void InitializeRendererModuleState(const u32 mode, const u32 pending, const u32 depth, const char* section)
-    {
-        SelectState(RENDERER_MODULE_STATE_SELECT_HINT_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_HINT_INACTIVE, section, "HINT"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
-        SelectState(RENDERER_MODULE_STATE_SELECT_CULL_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE, section, "CULL"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_FILTER_LENEAR, section, "FILTER"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_SHADE_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_SHADE_GOURAUD, section, "SHADE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_BLEND_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_ACTIVE, section, "TRANSPARENCY"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_TEST_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_TEST_16, section, "ALPHATEST"));
-        SelectState(RENDERER_MODULE_STATE_SELCT_ALPHA_FUNCTION,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_FUNCTION_GREATER, section, "ALPHACMP"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_MIP_FILTER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_MIP_FILTER_POINT, section, "MIPMAP"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_MATERIAL,
-            (void*)AcquireSettingsValue(0x00000000, section, "BACKGROUNDCOLOUR"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_CHROMATIC_COLOR,
-            (void*)AcquireSettingsValue(0x00000000, section, "CHROMACOLOUR"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_DITHER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_DITHER_INACTIVE, section, "DITHER"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS, NULL);
-        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_FOG_INACTIVE, section, "FOGMODE"));
+        vertexes[0] = *a;
+        vertexes[1] = *b;
+        vertexes[2] = *c;
 
-        {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_DENSITY,
-                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGDENSITY"));
-        }
+        const u32 count = ClipRendererPolygon(vertexes, buffer, 3);
 
-        {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_START,
-                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "STATE_FOGZNEAR"));
-        }
+        if (count < 3) { return 0; }
 
+        for (u32 x = 0; x < count - 2; x++)
         {
-            const f32 value = 1.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_END,
-                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGZFAR"));
+            output[x * 3 + 0] = vertexes[0];
+            output[x * 3 + 1] = vertexes[x + 1];
+            output[x * 3 + 2] = vertexes[x + 2];
         }
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_COLOR,
-            (void*)AcquireSettingsValue(GRAPCHICS_COLOR_WHITE, section, "FOGCOLOUR"));
+        return count - 2;
+    }
 
-        SelectState(RENDERER_MODULE_STATE_INDEX_SIZE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_INDEX_SIZE_4, section, "INDEXSIZE"));
+    // Clips the line against the clip rectangle, and writes the visible part of it, if any.
+    // Acquires the number of the lines written.
+    template <typename V> u32 ClipRendererLine(V* a, V* b, V* output)
+    {
+        output[0] = *a;
+        output[1] = *b;
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_BLEND_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_SOURCE_INVERSE_SOURCE, section, "ALPHA"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_ADDRESS_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_ADDRESS_CLAMP, section, "TEXTURECLAMP"));
+        return ClipRendererSegment(&output[0], &output[1]) ? 1 : 0;
+    }
 
-        {
-            const f32 value = 1.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_GAMMA_CONTROL_STATE, (void*)(u32)(*(u32*)&value));
-        }
+    // Appends the lines to the batch, the vertexes are taken in order when there are no indexes.
+    // The lines are clipped on the CPU while the clip rectangle is active, thus some of them may be dropped.
+    template <typename V, typename I> void AppendRendererLineList(const u32 count, V* vertexes, const I* indexes)
+    {
+        u32 x = 0;
 
+        while (x < count)
         {
-            const LONG value = 0;
+            const u32 length = Min(count - x, (u32)(MAX_VERTEX_COUNT / 2));
 
-            // NOTE: Change of type from f32 to a signed integer.
+            if (AreRenderPacketsComplete(D3DPT_LINELIST, length * 2)) { RenderScene(); }
 
-            SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_BIAS_STATE,
-                (void*)AcquireSettingsValue(value, section, "DEPTHBIAS"));
-        }
+            V* lock = (V*)LockRendererVertexes(length * 2);
 
-        {
-            const f32 value = 0.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_MIP_MAP_LOD_BIAS_STATE, (void*)(u32)(*(u32*)&value));
-        }
+            u32 visible = 0;
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_VERTEX_TYPE, (void*)RENDERER_MODULE_VERTEX_TYPE_RTLVX);
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_NORMAL);
-        SelectState(MAKETEXTURESTAGEMASK(RENDERER_TEXTURE_STAGE_1) | RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_DISABLE);
-        SelectState(RENDERER_MODULE_STATE_SELECT_BACK_BUFFER_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_BACK_BUFFER_ACTIVE, section, "BACKBUFFERTYPE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_FLAT_FANS_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_STATE_FLAT_FANS_ACTIVE, section, "FLATFANS"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_WIDTH, (void*)AcquireSettingsValue(1, section, "LINEWIDTH"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_STENCIL_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_STENCIL_INACTIVE, section, "STENCILBUFFER"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE, (void*)AcquireSettingsValue(mode, section, "DISPLAYMODE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_DOUBLE_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_LINE_DOUBLE_INACTIVE, section, "LINEDOUBLE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX, (void*)0); // TODO
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                const u32 indx = (x + xx) * 2;
 
-        {
-            const f32 value = 1.0f;
-            SelectState(RENDERER_MODULE_STATE_SELECT_CLEAR_DEPTH_STATE, (void*)(u32)(*(u32*)&value));
-        }
+                V* a = &vertexes[indexes == NULL ? (indx + 0) : indexes[indx + 0]];
+                V* b = &vertexes[indexes == NULL ? (indx + 1) : indexes[indx + 1]];
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_TOGGLE_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_TOGGLE_VERTICAL_SYNC, section, "FLIPRATE"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE,
-            (void*)AcquireSettingsValue(0, section, "SHAMELESSPLUG")); // TODO
+                if (State.Clip.IsActive) { visible = visible + ClipRendererLine(a, b, &lock[visible * 2]); continue; }
 
-        {
-            const u32 value = AcquireSettingsValue(depth < 0, section, "DEPTHBUFFER");
-            const u32 result = SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)value);
+                lock[visible * 2 + 0] = *a;
+                lock[visible * 2 + 1] = *b;
 
-            if (result == RENDERER_MODULE_FAILURE && value == RENDERER_MODULE_DEPTH_ACTIVE)
-            {
-                SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)RENDERER_MODULE_DEPTH_ACTIVE_W);
+                visible = visible + 1;
             }
-        }
 
-        SelectState(RENDERER_MODULE_STATE_SELCT_DEPTH_FUNCTION,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_DEPTH_FUNCTION_LESS_EQUAL, section, "DEPTHCMP"));
-        SelectState(RENDERER_MODULE_STATE_SELECT_LOG_STATE,
-            (void*)AcquireSettingsValue(RENDERER_MODULE_LOG_ACTIVE, section, "LOG"));
+            if (visible != 0) { UpdateVertexes((RVX*)lock, visible * 2); }
+
+            State.Data.Vertexes.Buffer->Unlock();
+
+            if (visible != 0) { AppendRendererPacket(D3DPT_LINELIST, visible, visible * 2); }
+
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + visible * 2;
+
+            State.Statistics.Lines = State.Statistics.Lines + length;
+
+            x = x + length;
+        }
     }
 
-    // 0x60008810
-    u32 SelectBasicRendererState(const u32 state, void* value)
+    // Appends the quads to the batch as pairs of triangles, the vertexes are taken in order when there are no indexes.
+    // While the clip rectangle is active, each of the triangles may be clipped into several ones, thus there is less quads per lock.
+    template <typename V, typename I> void AppendRendererQuadList(const u32 count, V* vertexes, const I* indexes)
     {
-        switch (state)
-        {
-        case RENDERER_MODULE_STATE_SELECT_CULL_STATE:
+        const u32 limit = State.Clip.IsActive ? MAX_CLIP_TRIANGLE_COUNT : 1;
+
+        u32 x = 0;
+
+        while (x < count)
         {
-            switch ((u32)value)
-            {
-            case RENDERER_MODULE_CULL_NONE:
-            {
-                State.Settings.Cull = RENDERER_CULL_MODE_NONE;
+            const u32 length = Min(count - x, (u32)(MAX_VERTEX_COUNT / (6 * limit)));
 
-                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_NONE);
+            if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, length * 6 * limit)) { RenderScene(); }
 
-                return RENDERER_MODULE_SUCCESS;
-            }
-            case RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE:
-            {
-                State.Settings.Cull = RENDERER_CULL_MODE_COUNTER_CLOCK_WISE;
+            V* lock = (V*)LockRendererVertexes(length * 6 * limit);
 
-                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE);
+            u32 visible = 0;
 
-                return RENDERER_MODULE_FAILURE;
-            }
-            case RENDERER_MODULE_CULL_CLOCK_WISE:
+            for (u32 xx = 0; xx < length; xx++)
             {
-                State.Settings.Cull = RENDERER_CULL_MODE_CLOCK_WISE;
+                const u32 indx = (x + xx) * 4;
 
-                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_CLOCK_WISE);
+                V* a = &vertexes[indexes == NULL ? (indx + 0) : indexes[indx + 0]];
+                V* b = &vertexes[indexes == NULL ? (indx + 1) : indexes[indx + 1]];
+                V* c = &vertexes[indexes == NULL ? (indx + 2) : indexes[indx + 2]];
+                V* d = &vertexes[indexes == NULL ? (indx + 3) : indexes[indx + 3]];
 
-                return RENDERER_MODULE_FAILURE;
-            }
-            default: { return RENDERER_MODULE_FAILURE; }
+                if (State.Clip.IsActive)
+                {
+                    visible = visible + ClipRendererTriangle(a, b, c, &lock[visible * 3]);
+                    visible = visible + ClipRendererTriangle(a, c, d, &lock[visible * 3]);
+
+                    continue;
+                }
+
+                V* v = &lock[visible * 3];
+
+                v[0] = *a;
+                v[1] = *b;
+                v[2] = *c;
+                v[3] = *a;
+                v[4] = *c;
+                v[5] = *d;
+
+                visible = visible + 2;
             }
 
-            break;
+            if (visible != 0) { UpdateVertexes((RVX*)lock, visible * 3); }
+
+            State.Data.Vertexes.Buffer->Unlock();
+
+            if (visible != 0) { AppendRendererPacket(D3DPT_TRIANGLELIST, visible, visible * 3); }
+
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + visible * 3;
+
+            State.Statistics.Quads = State.Statistics.Quads + length;
+
+            x = x + length;
         }
-        case RENDERER_MODULE_STATE_SELECT_WINDOW_MODE_STATE:
-        case RENDERER_MODULE_STATE_SELECT_EXECUTE_LAMBDA:
-        case RENDERER_MODULE_STATE_SELECT_LOCK_WINDOW_LAMBDA:
-        case RENDERER_MODULE_STATE_SELECT_LINE_VERTEX_SIZE:
-        case RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE:
-        case RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX:
-        case RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE:
-        case RENDERER_MODULE_STATE_SELECT_LOG_STATE: { break; }
-        case RENDERER_MODULE_STATE_SELECT_LAMBDAS:
+    }
+
+    // Appends the triangles that are not culled to the batch, the vertexes are taken in order when there are no indexes.
+    // While the clip rectangle is active, each of the triangles may be clipped into several ones, thus there is less triangles per lock.
+    template <typename V, typename I> void AppendRendererTriangleList(const u32 count, V* vertexes, const I* indexes)
+    {
+        const u32 limit = State.Clip.IsActive ? MAX_CLIP_TRIANGLE_COUNT : 1;
+
+        u32 x = 0;
+
+        while (x < count)
         {
-            const RendererModuleLambdaContainer* lambdas = (RendererModuleLambdaContainer*)value;
+            const u32 length = Min(count - x, (u32)(MAX_VERTEX_COUNT / (3 * limit)));
 
-            State.Lambdas.Log = lambdas == NULL ? NULL : lambdas->Log;
+            if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, length * 3 * limit)) { RenderScene(); }
 
-            break;
+            V* lock = (V*)LockRendererVertexes(length * 3 * limit);
+
+            u32 visible = 0;
+            u32 triangles = 0;
+
+            for (u32 xx = 0; xx < length; xx++)
+            {
+                const u32 indx = (x + xx) * 3;
+
+                V* a = &vertexes[indexes == NULL ? (indx + 0) : indexes[indx + 0]];
+                V* b = &vertexes[indexes == NULL ? (indx + 1) : indexes[indx + 1]];
+                V* c = &vertexes[indexes == NULL ? (indx + 2) : indexes[indx + 2]];
+
+                if (State.Settings.Cull == RENDERER_CULL_MODE_NONE
+                    || (AcquireNormal(&a->XYZ, &b->XYZ, &c->XYZ) & RENDERER_CULL_MODE_COUNTER_CLOCK_WISE) != State.Settings.Cull)
+                {
+                    visible = visible + 1;
+
+                    if (State.Clip.IsActive) { triangles = triangles + ClipRendererTriangle(a, b, c, &lock[triangles * 3]); continue; }
+
+                    V* v = &lock[triangles * 3];
+
+                    v[0] = *a;
+                    v[1] = *b;
+                    v[2] = *c;
+
+                    triangles = triangles + 1;
+                }
+            }
+
+            if (triangles != 0) { UpdateVertexes((RVX*)lock, triangles * 3); }
+
+            State.Data.Vertexes.Buffer->Unlock();
+
+            if (triangles != 0) { AppendRendererPacket(D3DPT_TRIANGLELIST, triangles, triangles * 3); }
+
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + triangles * 3;
+
+            State.Statistics.Triangles = State.Statistics.Triangles + visible;
+
+            x = x + length;
         }
-        case RENDERER_MODULE_STATE_SELECT_WINDOW: { State.Window.Parent.HWND = (HWND)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_LOG_LAMBDA: { State.Lambdas.Log = (RENDERERMODULELOGLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_VERSION: { RendererVersion = (u32)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_MEMORY_ALLOCATE_LAMBDA: { State.Lambdas.AllocateMemory = (RENDERERMODULEALLOCATEMEMORYLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_MEMORY_RELEASE_LAMBDA: { State.Lambdas.ReleaseMemory = (RENDERERMODULERELEASEMEMORYLAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_SELECT_SELECT_STATE_LAMBDA: { State.Lambdas.SelectState = (RENDERERMODULESELECTSTATELAMBDA)value; break; }
-        case RENDERER_MODULE_STATE_55: { DAT_6001eedc = (u32)value; break; }
-        case RENDERER_MODULE_STATE_62: { DAT_6001eee0 = (u32)value; break; }
-        case RENDERER_MODULE_STATE_INDEX_SIZE:
+    }
+
+    // Converts the triangle strip or fan into a triangle list, so that it can be merged with the neighbouring packets.
+    // The odd triangles of a strip have their winding order reversed, to match the order the device would use for the strip.
+    template <typename V, typename I> void AppendRendererTriangleStrip(const D3DPRIMITIVETYPE type, const u32 count, V* vertexes, const I* indexes)
+    {
+        const u32 limit = State.Clip.IsActive ? MAX_CLIP_TRIANGLE_COUNT : 1;
+
+        u32 x = 0;
+
+        while (x < count)
         {
-            switch ((u32)value)
+            const u32 length = Min(count - x, (u32)(MAX_VERTEX_COUNT / (3 * limit)));
+
+            if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, length * 3 * limit)) { RenderScene(); }
+
+            V* lock = (V*)LockRendererVertexes(length * 3 * limit);
+
+            u32 triangles = 0;
+
+            for (u32 xx = 0; xx < length; xx++)
             {
-            case RENDERER_MODULE_INDEX_SIZE_1: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_1; break; }
-            case RENDERER_MODULE_INDEX_SIZE_2: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_2; break; }
-            case RENDERER_MODULE_INDEX_SIZE_4: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_4; break; }
-            case RENDERER_MODULE_INDEX_SIZE_8: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_8; break; }
-            default: { return RENDERER_MODULE_FAILURE; }
+                const u32 indx = x + xx;
+
+                u32 indxA = indx + 0, indxB = indx + 1, indxC = indx + 2;
+
+                if (type == D3DPT_TRIANGLEFAN) { indxA = 0; }
+                else if ((indx & 1) != 0) { indxB = indx + 2; indxC = indx + 1; }
+
+                V* a = &vertexes[indexes == NULL ? indxA : indexes[indxA]];
+                V* b = &vertexes[indexes == NULL ? indxB : indexes[indxB]];
+                V* c = &vertexes[indexes == NULL ? indxC : indexes[indxC]];
+
+                if (State.Clip.IsActive) { triangles = triangles + ClipRendererTriangle(a, b, c, &lock[triangles * 3]); continue; }
+
+                V* v = &lock[triangles * 3];
+
+                v[0] = *a;
+                v[1] = *b;
+                v[2] = *c;
+
+                triangles = triangles + 1;
             }
 
-            break;
-        }
-        default: { return RENDERER_MODULE_FAILURE; }
-        }
+            if (triangles != 0) { UpdateVertexes((RVX*)lock, triangles * 3); }
 
-        SelectRendererStateValue(state, value);
+            State.Data.Vertexes.Buffer->Unlock();
 
-        return RENDERER_MODULE_SUCCESS;
+            if (triangles != 0) { AppendRendererPacket(D3DPT_TRIANGLELIST, triangles, triangles * 3); }
+
+            State.Data.Vertexes.Count = State.Data.Vertexes.Count + triangles * 3;
+
+            x = x + length;
+        }
     }
 
-    // 0x600031c0
-    void SelectRendererStateValue(const u32 state, void* value)
+    // NOTE: Used in place of the device viewport, see ClipGameWindow.
+    void AppendRendererClippedLine(RVX* a, RVX* b)
     {
-        const u32 actual = state & RENDERER_MODULE_SELECT_STATE_MASK;
-        const u32 stage = MAKETEXTURESTAGEVALUE(state);
+        if (AreRenderPacketsComplete(D3DPT_LINELIST, 2)) { RenderScene(); }
 
-        const s32 indx = AcquireTextureStateStageIndex(actual);
+        BYTE* lock = LockRendererVertexes(2);
 
-        if (indx >= 0) { State.Textures.StageStates[indx].Values[stage] = (s32)value; }
+        const u32 count = RendererVertexSize == sizeof(RTLVX2)
+            ? ClipRendererLine((RTLVX2*)a, (RTLVX2*)b, (RTLVX2*)lock) : ClipRendererLine((RTLVX*)a, (RTLVX*)b, (RTLVX*)lock);
 
-        if (State.Lambdas.SelectState != NULL) { State.Lambdas.SelectState(actual, value); }
+        if (count != 0) { UpdateVertexes((RVX*)lock, count * 2); }
+
+        State.Data.Vertexes.Buffer->Unlock();
+
+        if (count != 0) { AppendRendererPacket(D3DPT_LINELIST, count, count * 2); }
+
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + count * 2;
     }
 
-    // 0x60003170
-    s32 AcquireTextureStateStageIndex(const u32 state)
+    // NOTE: Used in place of the device viewport, see ClipGameWindow.
+    void AppendRendererClippedTriangle(RVX* a, RVX* b, RVX* c)
     {
-        s32 sum = 0;
-        u32 indx = 0;
+        if (AreRenderPacketsComplete(D3DPT_TRIANGLELIST, MAX_CLIP_TRIANGLE_COUNT * 3)) { RenderScene(); }
 
-        while (state < RendererModuleValues::MinMax[indx].Min || RendererModuleValues::MinMax[indx].Max < state)
-        {
-            sum = sum + (RendererModuleValues::MinMax[indx].Max - RendererModuleValues::MinMax[indx].Min);
+        BYTE* lock = LockRendererVertexes(MAX_CLIP_TRIANGLE_COUNT * 3);
 
-            indx = indx + 1;
+        const u32 count = RendererVertexSize == sizeof(RTLVX2)
+            ? ClipRendererTriangle((RTLVX2*)a, (RTLVX2*)b, (RTLVX2*)c, (RTLVX2*)lock) : ClipRendererTriangle((RTLVX*)a, (RTLVX*)b, (RTLVX*)c, (RTLVX*)lock);
 
-            if (5 < indx) { return -1; } // TODO
-        }
+        if (count != 0) { UpdateVertexes((RVX*)lock, count * 3); }
 
-        return (sum - RendererModuleValues::MinMax[indx].Min) + state;
+        State.Data.Vertexes.Buffer->Unlock();
+
+        if (count != 0) { AppendRendererPacket(D3DPT_TRIANGLELIST, count, count * 3); }
+
+        State.Data.Vertexes.Count = State.Data.Vertexes.Count + count * 3;
     }
 
-    // 0x60004800
-    void InitializeRendererState(void)
+    // NOTE: The vertex type and the index size are resolved once per call, rather than once per vertex.
+    void AppendRendererLineMesh(const u32 count, RVX* vertexes, const u32* indexes)
     {
-        SelectRendererTransforms(1.0f, 65535.0f);
-
-        State.DX.Device->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        State.DX.Device->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        State.DX.Device->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-        State.DX.Device->SetRenderState(D3DRS_ALPHATESTENABLE, TRUE);
-        State.DX.Device->SetRenderState(D3DRS_ALPHAFUNC, D3DCMP_GREATER);
-        State.DX.Device->SetRenderState(D3DRS_ALPHAREF, 0);
+        if (RendererVertexSize == sizeof(RTLVX2))
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererLineList(count, (RTLVX2*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererLineList(count, (RTLVX2*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererLineList(count, (RTLVX2*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererLineList(count, (RTLVX2*)vertexes, indexes); break; }
+            }
+        }
+        else
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererLineList(count, (RTLVX*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererLineList(count, (RTLVX*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererLineList(count, (RTLVX*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererLineList(count, (RTLVX*)vertexes, indexes); break; }
+            }
+        }
+    }
 
-        if (!State.Device.Capabilities.IsDepthAvailable || State.DX.Surfaces.Bits == 0)
+    // NOTE: The vertex type and the index size are resolved once per call, rather than once per vertex.
+    void AppendRendererQuadMesh(const u32 count, RVX* vertexes, const u32* indexes)
+    {
+        if (RendererVertexSize == sizeof(RTLVX2))
         {
-            State.DX.Device->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-            State.DX.Device->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-            State.DX.Device->SetRenderState(D3DRS_ZFUNC, D3DCMP_ALWAYS);
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererQuadList(count, (RTLVX2*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererQuadList(count, (RTLVX2*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererQuadList(count, (RTLVX2*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererQuadList(count, (RTLVX2*)vertexes, indexes); break; }
+            }
         }
         else
         {
-            State.DX.Device->SetRenderState(D3DRS_ZENABLE, D3DZB_TRUE);
-            State.DX.Device->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-            State.DX.Device->SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererQuadList(count, (RTLVX*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererQuadList(count, (RTLVX*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererQuadList(count, (RTLVX*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererQuadList(count, (RTLVX*)vertexes, indexes); break; }
+            }
         }
+    }
 
-        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
-        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+    // NOTE: The vertex type and the index size are resolved once per call, rather than once per vertex.
+    void AppendRendererTriangleMesh(const u32 count, RVX* vertexes, const u32* indexes)
+    {
+        if (RendererVertexSize == sizeof(RTLVX2))
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleList(count, (RTLVX2*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleList(count, (RTLVX2*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleList(count, (RTLVX2*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererTriangleList(count, (RTLVX2*)vertexes, indexes); break; }
+            }
+        }
+        else
+        {
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleList(count, (RTLVX*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleList(count, (RTLVX*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleList(count, (RTLVX*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererTriangleList(count, (RTLVX*)vertexes, indexes); break; }
+            }
+        }
+    }
 
-        if (!State.Device.Capabilities.IsModulateBlending)
+    // NOTE: The vertex type and the index size are resolved once per call, rather than once per vertex.
+    void AppendRendererTriangles(const D3DPRIMITIVETYPE type, const u32 count, RVX* vertexes, const u32* indexes)
+    {
+        if (RendererVertexSize == sizeof(RTLVX2))
         {
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererTriangleStrip(type, count, (RTLVX2*)vertexes, indexes); break; }
+            }
         }
         else
         {
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+            switch (RendererIndexSize)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, (u8*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, (u16*)indexes); break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, (u64*)indexes); break; }
+            default: { AppendRendererTriangleStrip(type, count, (RTLVX*)vertexes, indexes); break; }
+            }
         }
+    }
 
-        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
-        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+    // Draws the triangle mesh straight from the vertex and index buffers of the cache, when the very same mesh,
+    // with the very same vertex transforms, was submitted during the previous frames. The device culls the triangles the same way as the CPU does.
+    // Meshes with fog, depth range or packed textures depend on the fog alphas, the frame or the atlas, and not only on the vertexes, thus never cached,
+    // same as the meshes drawn while the primitives are clipped on the CPU.
+    BOOL RenderRendererMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    {
+        if (indexes == NULL || State.Clip.IsActive
+            || (State.Data.Vertexes.Transforms & (RENDERER_VERTEX_TRANSFORM_FOG | RENDERER_VERTEX_TRANSFORM_RANGE | RENDERER_VERTEX_TRANSFORM_ATLAS))) { return FALSE; }
 
-        State.DX.Device->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
-        State.DX.Device->SetRenderState(D3DRS_CLIPPING, 0);
-        State.DX.Device->SetRenderState(D3DRS_LIGHTING, 0);
+        RendererMesh* mesh = AcquireRendererMesh(vertexes, indexes, count);
 
+        if (mesh == NULL) { return FALSE; }
+
+        if (mesh->Vertexes.Buffer == NULL)
         {
-            const char* value = getenv(RENDERER_MODULE_WIRE_FRAME_DX8_ENVIRONMENT_PROPERTY_NAME);
+            State.Statistics.MeshMisses = State.Statistics.MeshMisses + 1;
 
-            State.DX.Device->SetRenderState(D3DRS_FILLMODE,
-                (value == NULL || atoi(value) == 0) ? D3DFILL_SOLID : D3DFILL_WIREFRAME);
+            return FALSE;
         }
 
-        State.DX.Device->SetRenderState(D3DRS_DITHERENABLE, FALSE);
-        State.DX.Device->SetRenderState(D3DRS_SPECULARENABLE, FALSE);
-        State.DX.Device->SetRenderState(D3DRS_FOGENABLE, FALSE);
-        State.DX.Device->SetRenderState(D3DRS_FOGCOLOR, 0x00ffffff);
-        State.DX.Device->SetRenderState(D3DRS_FOGTABLEMODE, D3DFOG_NONE);
-        State.DX.Device->SetRenderState(D3DRS_FOGVERTEXMODE, 0);
-        
+        State.Statistics.MeshHits = State.Statistics.MeshHits + 1;
+
+        RenderPackets();
+
+        State.DX.Device->SetVertexShader(RendererCurrentShader);
+        State.DX.Device->SetStreamSource(0, mesh->Vertexes.Buffer, RendererVertexSize);
+        State.DX.Device->SetIndices(mesh->Indexes.Buffer, 0);
+
+        State.DX.Device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, mesh->Vertexes.Count, 0, count);
+
+        return TRUE;
+    }
+
+    // Looks up the mesh in the cache by the hash of its indexes and vertexes, and keeps track of the number of consecutive frames
+    // it was seen in. The buffers are created once the mesh was seen in enough frames. Returns NULL for the meshes not tracked.
+    RendererMesh* AcquireRendererMesh(RVX* vertexes, const u32* indexes, const u32 count)
+    {
+        const u32 length = count * 3;
+
+        u32 a = 0x811c9dc5;
+        u32 b = 0x9e3779b1;
+
+        u32 maximum = 0;
+
+        for (u32 x = 0; x < length; x++)
         {
-            const f32 value = 0.0f;
-            State.DX.Device->SetRenderState(D3DRS_FOGSTART, *(DWORD*)(&value));
+            const u32 indx = AcquireRendererVertexIndex(indexes, x);
+
+            if (maximum < indx) { maximum = indx; }
+
+            a = (a ^ indx) * 0x01000193;
+            b = (((b << 5) | (b >> 27)) ^ indx) * 0x85ebca6b;
         }
 
+        const u32 vertexCount = maximum + 1;
+
+        if (vertexCount < MIN_MESH_VERTEX_COUNT || MAX_VERTEX_COUNT < vertexCount) { return NULL; }
+
         {
-            const f32 value = 1.0f;
-            State.DX.Device->SetRenderState(D3DRS_FOGEND, *(DWORD*)(&value));
+            const u32* values = (u32*)vertexes;
+            const u32 size = (vertexCount * RendererVertexSize) / sizeof(u32);
+
+            for (u32 x = 0; x < size; x++)
+            {
+                a = (a ^ values[x]) * 0x01000193;
+                b = (((b << 5) | (b >> 27)) ^ values[x]) * 0x85ebca6b;
+            }
         }
 
-        State.DX.Device->SetRenderState(D3DRS_TEXTUREFACTOR, GRAPCHICS_COLOR_WHITE);
+        // Reordering of the triangles changes the result of the blending, thus only the opaque meshes are reordered.
+        const BOOL ordered = State.Shadow.States.IsValid[D3DRS_ALPHABLENDENABLE] && !State.Shadow.States.Values[D3DRS_ALPHABLENDENABLE];
+
+        RendererMesh* mesh = NULL;
+
+        for (u32 x = 0; x < State.Meshes.Count; x++)
+        {
+            RendererMesh* m = &State.Meshes.Meshes[x];
+
+            if (m->Hash[0] == a && m->Hash[1] == b && m->Shader == RendererCurrentShader
+                && m->Transforms == State.Data.Vertexes.Transforms && m->IsOrdered == ordered && m->Vertexes.Count == vertexCount && m->Indexes.Count == length)
+            {
+                mesh = m; break;
+            }
+        }
+
+        if (mesh == NULL)
+        {
+            if (State.Meshes.Count < MAX_MESH_COUNT)
+            {
+                mesh = &State.Meshes.Meshes[State.Meshes.Count];
+
+                State.Meshes.Count = State.Meshes.Count + 1;
+            }
+            else
+            {
+                // Replace the least recently seen mesh, the meshes seen during the current frame are kept.
+                for (u32 x = 0; x < State.Meshes.Count; x++)
+                {
+                    RendererMesh* m = &State.Meshes.Meshes[x];
+
+                    if (m->Frame == State.Meshes.Frame) { continue; }
+
+                    if (mesh == NULL || m->Frame < mesh->Frame) { mesh = m; }
+                }
+
+                if (mesh == NULL) { return NULL; }
+
+                ReleaseRendererMesh(mesh);
+            }
+
+            mesh->Hash[0] = a;
+            mesh->Hash[1] = b;
+            mesh->Shader = RendererCurrentShader;
+            mesh->Transforms = State.Data.Vertexes.Transforms;
+            mesh->IsOrdered = ordered;
+            mesh->Frame = State.Meshes.Frame;
+            mesh->Frames = 1;
+            mesh->Size = 0;
+            mesh->Vertexes.Count = vertexCount;
+            mesh->Vertexes.Buffer = NULL;
+            mesh->Indexes.Count = length;
+            mesh->Indexes.Buffer = NULL;
+
+            return mesh;
+        }
+
+        if (mesh->Frame != State.Meshes.Frame)
+        {
+            mesh->Frames = (mesh->Frame + 1 == State.Meshes.Frame) ? (mesh->Frames + 1) : 1;
+            mesh->Frame = State.Meshes.Frame;
+        }
+
+        if (mesh->Vertexes.Buffer == NULL && MIN_MESH_FRAME_COUNT <= mesh->Frames) { InitializeRendererMesh(mesh, vertexes, indexes); }
+
+        return mesh;
+    }
+
+    // Creates the write-only vertex and index buffers of the mesh, with the vertex transforms already applied.
+    // The buffers are managed, so they survive the device reset. The least recently seen meshes are released to keep the cache within its memory limit.
+    BOOL InitializeRendererMesh(RendererMesh* mesh, RVX* vertexes, const u32* indexes)
+    {
+        const u32 size = mesh->Vertexes.Count * RendererVertexSize + mesh->Indexes.Count * sizeof(u16);
+
+        while (MAX_MESH_SIZE < State.Meshes.Size + size)
+        {
+            RendererMesh* m = NULL;
+
+            for (u32 x = 0; x < State.Meshes.Count; x++)
+            {
+                RendererMesh* mm = &State.Meshes.Meshes[x];
+
+                if (mm->Vertexes.Buffer == NULL || mm->Frame == State.Meshes.Frame) { continue; }
+
+                if (m == NULL || mm->Frame < m->Frame) { m = mm; }
+            }
+
+            if (m == NULL) { return FALSE; }
+
+            ReleaseRendererMesh(m);
+        }
+
+        if (State.DX.Device->CreateVertexBuffer(mesh->Vertexes.Count * RendererVertexSize, D3DUSAGE_WRITEONLY,
+            RendererCurrentShader, D3DPOOL_MANAGED, &mesh->Vertexes.Buffer) != D3D_OK) { return FALSE; }
+
+        if (State.DX.Device->CreateIndexBuffer(mesh->Indexes.Count * sizeof(u16), D3DUSAGE_WRITEONLY,
+            D3DFMT_INDEX16, D3DPOOL_MANAGED, &mesh->Indexes.Buffer) != D3D_OK)
+        {
+            ReleaseRendererMesh(mesh);
+
+            return FALSE;
+        }
+
+        {
+            BYTE* lock = NULL;
+
+            if (mesh->Vertexes.Buffer->Lock(0, 0, &lock, D3DLOCK_NONE) != D3D_OK)
+            {
+                ReleaseRendererMesh(mesh);
+
+                return FALSE;
+            }
+
+            CopyMemory(lock, vertexes, mesh->Vertexes.Count * RendererVertexSize);
+
+            UpdateVertexes((RVX*)lock, mesh->Vertexes.Count);
+
+            mesh->Vertexes.Buffer->Unlock();
+        }
+
+        {
+            u16* values = (u16*)malloc(mesh->Indexes.Count * sizeof(u16));
+
+            if (values == NULL)
+            {
+                ReleaseRendererMesh(mesh);
+
+                return FALSE;
+            }
+
+            for (u32 x = 0; x < mesh->Indexes.Count; x++) { values[x] = (u16)AcquireRendererVertexIndex(indexes, x); }
+
+            if (mesh->IsOrdered) { OptimizeRendererMeshIndexes(values, mesh->Indexes.Count, mesh->Vertexes.Count); }
+
+            BYTE* lock = NULL;
+
+            if (mesh->Indexes.Buffer->Lock(0, 0, &lock, D3DLOCK_NONE) != D3D_OK)
+            {
+                free(values);
+
+                ReleaseRendererMesh(mesh);
+
+                return FALSE;
+            }
+
+            CopyMemory(lock, values, mesh->Indexes.Count * sizeof(u16));
+
+            mesh->Indexes.Buffer->Unlock();
+
+            free(values);
+        }
+
+        mesh->Size = size;
+
+        State.Meshes.Size = State.Meshes.Size + size;
+
+        return TRUE;
+    }
+
+    void ReleaseRendererMesh(RendererMesh* mesh)
+    {
+        if (mesh->Vertexes.Buffer != NULL)
+        {
+            mesh->Vertexes.Buffer->Release();
+            mesh->Vertexes.Buffer = NULL;
+        }
+
+        if (mesh->Indexes.Buffer != NULL)
+        {
+            mesh->Indexes.Buffer->Release();
+            mesh->Indexes.Buffer = NULL;
+        }
+
+        State.Meshes.Size = State.Meshes.Size - mesh->Size;
+
+        mesh->Size = 0;
+        mesh->Frames = 0;
+    }
+
+    void ReleaseRendererMeshes(void)
+    {
+        for (u32 x = 0; x < State.Meshes.Count; x++) { ReleaseRendererMesh(&State.Meshes.Meshes[x]); }
+
+        State.Meshes.Count = 0;
+        State.Meshes.Size = 0;
+    }
+
+    // Acquires the vertex index at the position, or the position itself when there are no indexes.
+    u32 AcquireRendererVertexIndex(const u32* indexes, const u32 indx)
+    {
+        if (indexes == NULL) { return indx; }
+
+        switch (RendererIndexSize)
+        {
+        case RENDERER_MODULE_INDEX_SIZE_1: { return ((u8*)indexes)[indx]; }
+        case RENDERER_MODULE_INDEX_SIZE_2: { return ((u16*)indexes)[indx]; }
+        case RENDERER_MODULE_INDEX_SIZE_4: { return ((u32*)indexes)[indx]; }
+        case RENDERER_MODULE_INDEX_SIZE_8: { return (u32)((u64*)indexes)[indx]; }
+        }
+
+        return indx;
+    }
+
+    // 0x60003ab0
+    u32 STDCALLAPI InitializeRendererDeviceSurfacesExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result)
+    {
+        if (State.Lock.IsActive) { UnlockGameWindow(NULL); }
+
+        AttemptRenderPackets();
+
+        ReleaseRendererWindows();
+
+        ResetTextures();
+
+        ReleaseRendererTextureUploads();
+
+        ReleaseRendererTextureCache();
+
+        if (State.DX.Device != NULL)
+        {
+            ReleaseRendererObjects();
+
+            while (State.DX.Device->Release() != D3D_OK) {}
+
+            State.DX.Device = NULL;
+        }
+
+        ReleaseRendererPackets();
+
+        if (State.DX.Instance != NULL)
+        {
+            while (State.DX.Instance->Release() != D3D_OK) {}
+
+            State.DX.Instance = NULL;
+        }
+
+        State.Scene.IsActive = FALSE;
+
+        State.DX.Surfaces.Surfaces[2] = NULL;
+        State.DX.Surfaces.Surfaces[3] = NULL;
+
+        State.Device.Index = DEFAULT_DEVICE_INDEX;
+
+        State.Lambdas.Log = NULL;
+
+        IsRendererInit = FALSE;
+
+        State.Window.HWND = NULL;
+
+        if (result != NULL)
+        {
+            SetEvent(State.Mutexes.Surface);
+
+            *result = RENDERER_MODULE_SUCCESS;
+        }
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60008bc0
+    void InitializeRendererModuleState(const u32 mode, const u32 pending, const u32 depth, const char* section)
+    {
+        SelectState(RENDERER_MODULE_STATE_SELECT_HINT_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_HINT_INACTIVE, section, "HINT"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
+        SelectState(RENDERER_MODULE_STATE_SELECT_CULL_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE, section, "CULL"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_FILTER_LENEAR, section, "FILTER"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_SHADE_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_SHADE_GOURAUD, section, "SHADE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_BLEND_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_ACTIVE, section, "TRANSPARENCY"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_ALPHA_TEST_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_TEST_16, section, "ALPHATEST"));
+        SelectState(RENDERER_MODULE_STATE_SELCT_ALPHA_FUNCTION,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_FUNCTION_GREATER, section, "ALPHACMP"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_MIP_FILTER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_MIP_FILTER_POINT, section, "MIPMAP"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_MATERIAL,
+            (void*)AcquireSettingsValue(0x00000000, section, "BACKGROUNDCOLOUR"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_CHROMATIC_COLOR,
+            (void*)AcquireSettingsValue(0x00000000, section, "CHROMACOLOUR"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_DITHER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_DITHER_INACTIVE, section, "DITHER"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_ALPHAS, NULL);
+        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_FOG_INACTIVE, section, "FOGMODE"));
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_DENSITY,
+                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGDENSITY"));
+        }
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_START,
+                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "STATE_FOGZNEAR"));
+        }
+
+        {
+            const f32 value = 1.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_FOG_END,
+                (void*)AcquireSettingsValue((s32)(*(s32*)&value), section, "FOGZFAR"));
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_FOG_COLOR,
+            (void*)AcquireSettingsValue(GRAPCHICS_COLOR_WHITE, section, "FOGCOLOUR"));
+
+        SelectState(RENDERER_MODULE_STATE_INDEX_SIZE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_INDEX_SIZE_4, section, "INDEXSIZE"));
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_BLEND_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_ALPHA_BLEND_SOURCE_INVERSE_SOURCE, section, "ALPHA"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_ADDRESS_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TEXTURE_ADDRESS_CLAMP, section, "TEXTURECLAMP"));
+
+        {
+            const f32 value = 1.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_GAMMA_CONTROL_STATE, (void*)(u32)(*(u32*)&value));
+        }
+
+        {
+            const LONG value = 0;
+
+            // NOTE: Change of type from f32 to a signed integer.
+
+            SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_BIAS_STATE,
+                (void*)AcquireSettingsValue(value, section, "DEPTHBIAS"));
+        }
+
+        {
+            const f32 value = 0.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_MIP_MAP_LOD_BIAS_STATE, (void*)(u32)(*(u32*)&value));
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_VERTEX_TYPE, (void*)RENDERER_MODULE_VERTEX_TYPE_RTLVX);
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_NORMAL);
+        SelectState(MAKETEXTURESTAGEMASK(RENDERER_TEXTURE_STAGE_1) | RENDERER_MODULE_STATE_SELECT_TEXTURE_STAGE_BLEND_STATE, (void*)RENDERER_MODULE_TEXTURE_STAGE_BLEND_DISABLE);
+        SelectState(RENDERER_MODULE_STATE_SELECT_BACK_BUFFER_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_BACK_BUFFER_ACTIVE, section, "BACKBUFFERTYPE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_FLAT_FANS_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_STATE_FLAT_FANS_ACTIVE, section, "FLATFANS"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_WIDTH, (void*)AcquireSettingsValue(1, section, "LINEWIDTH"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_STENCIL_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_STENCIL_INACTIVE, section, "STENCILBUFFER"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE, (void*)AcquireSettingsValue(mode, section, "DISPLAYMODE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_LINE_DOUBLE_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_LINE_DOUBLE_INACTIVE, section, "LINEDOUBLE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX, (void*)0); // TODO
+
+        {
+            const f32 value = 1.0f;
+            SelectState(RENDERER_MODULE_STATE_SELECT_CLEAR_DEPTH_STATE, (void*)(u32)(*(u32*)&value));
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_TOGGLE_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_TOGGLE_VERTICAL_SYNC, section, "FLIPRATE"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE,
+            (void*)AcquireSettingsValue(0, section, "SHAMELESSPLUG")); // TODO
+
+        {
+            const u32 value = AcquireSettingsValue(depth < 0, section, "DEPTHBUFFER");
+            const u32 result = SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)value);
+
+            if (result == RENDERER_MODULE_FAILURE && value == RENDERER_MODULE_DEPTH_ACTIVE)
+            {
+                SelectState(RENDERER_MODULE_STATE_SELECT_DEPTH_STATE, (void*)RENDERER_MODULE_DEPTH_ACTIVE_W);
+            }
+        }
+
+        SelectState(RENDERER_MODULE_STATE_SELCT_DEPTH_FUNCTION,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_DEPTH_FUNCTION_LESS_EQUAL, section, "DEPTHCMP"));
+        SelectState(RENDERER_MODULE_STATE_SELECT_LOG_STATE,
+            (void*)AcquireSettingsValue(RENDERER_MODULE_LOG_ACTIVE, section, "LOG"));
+    }
+
+    // 0x60008810
+    u32 SelectBasicRendererState(const u32 state, void* value)
+    {
+        switch (state)
+        {
+        case RENDERER_MODULE_STATE_SELECT_CULL_STATE:
+        {
+            switch ((u32)value)
+            {
+            case RENDERER_MODULE_CULL_NONE:
+            {
+                State.Settings.Cull = RENDERER_CULL_MODE_NONE;
+
+                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_NONE);
+
+                return RENDERER_MODULE_SUCCESS;
+            }
+            case RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE:
+            {
+                State.Settings.Cull = RENDERER_CULL_MODE_COUNTER_CLOCK_WISE;
+
+                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_COUNTER_CLOCK_WISE);
+
+                return RENDERER_MODULE_FAILURE;
+            }
+            case RENDERER_MODULE_CULL_CLOCK_WISE:
+            {
+                State.Settings.Cull = RENDERER_CULL_MODE_CLOCK_WISE;
+
+                SelectRendererStateValue(state, (void*)RENDERER_MODULE_CULL_CLOCK_WISE);
+
+                return RENDERER_MODULE_FAILURE;
+            }
+            default: { return RENDERER_MODULE_FAILURE; }
+            }
+
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_WINDOW_MODE_STATE:
+        case RENDERER_MODULE_STATE_SELECT_EXECUTE_LAMBDA:
+        case RENDERER_MODULE_STATE_SELECT_LOCK_WINDOW_LAMBDA:
+        case RENDERER_MODULE_STATE_SELECT_LINE_VERTEX_SIZE:
+        case RENDERER_MODULE_STATE_SELECT_DISPLAY_STATE:
+        case RENDERER_MODULE_STATE_SELECT_GAME_WINDOW_INDEX:
+        case RENDERER_MODULE_STATE_SELECT_SHAMELESS_PLUG_STATE:
+        case RENDERER_MODULE_STATE_SELECT_LOG_STATE: { break; }
+        case RENDERER_MODULE_STATE_SELECT_LAMBDAS:
+        {
+            const RendererModuleLambdaContainer* lambdas = (RendererModuleLambdaContainer*)value;
+
+            State.Lambdas.Log = lambdas == NULL ? NULL : lambdas->Log;
+
+            break;
+        }
+        case RENDERER_MODULE_STATE_SELECT_WINDOW: { State.Window.Parent.HWND = (HWND)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_LOG_LAMBDA: { State.Lambdas.Log = (RENDERERMODULELOGLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_VERSION: { RendererVersion = (u32)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_MEMORY_ALLOCATE_LAMBDA: { State.Lambdas.AllocateMemory = (RENDERERMODULEALLOCATEMEMORYLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_MEMORY_RELEASE_LAMBDA: { State.Lambdas.ReleaseMemory = (RENDERERMODULERELEASEMEMORYLAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_SELECT_SELECT_STATE_LAMBDA: { State.Lambdas.SelectState = (RENDERERMODULESELECTSTATELAMBDA)value; break; }
+        case RENDERER_MODULE_STATE_55: { DAT_6001eedc = (u32)value; break; }
+        case RENDERER_MODULE_STATE_62: { DAT_6001eee0 = (u32)value; break; }
+        case RENDERER_MODULE_STATE_INDEX_SIZE:
+        {
+            switch ((u32)value)
+            {
+            case RENDERER_MODULE_INDEX_SIZE_1: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_1; break; }
+            case RENDERER_MODULE_INDEX_SIZE_2: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_2; break; }
+            case RENDERER_MODULE_INDEX_SIZE_4: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_4; break; }
+            case RENDERER_MODULE_INDEX_SIZE_8: { RendererIndexSize = RENDERER_MODULE_INDEX_SIZE_8; break; }
+            default: { return RENDERER_MODULE_FAILURE; }
+            }
+
+            break;
+        }
+        default: { return RENDERER_MODULE_FAILURE; }
+        }
+
+        SelectRendererStateValue(state, value);
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x600031c0
+    void SelectRendererStateValue(const u32 state, void* value)
+    {
+        const u32 actual = state & RENDERER_MODULE_SELECT_STATE_MASK;
+        const u32 stage = MAKETEXTURESTAGEVALUE(state);
+
+        const s32 indx = AcquireTextureStateStageIndex(actual);
+
+        if (indx >= 0) { State.Textures.StageStates[indx].Values[stage] = (s32)value; }
+
+        if (State.Lambdas.SelectState != NULL) { State.Lambdas.SelectState(actual, value); }
+    }
+
+    // 0x60003170
+    s32 AcquireTextureStateStageIndex(const u32 state)
+    {
+        s32 sum = 0;
+        u32 indx = 0;
+
+        while (state < RendererModuleValues::MinMax[indx].Min || RendererModuleValues::MinMax[indx].Max < state)
+        {
+            sum = sum + (RendererModuleValues::MinMax[indx].Max - RendererModuleValues::MinMax[indx].Min);
+
+            indx = indx + 1;
+
+            if (5 < indx) { return -1; } // TODO
+        }
+
+        return (sum - RendererModuleValues::MinMax[indx].Min) + state;
+    }
+
+    void InitializeRendererShadowStates(void)
+    {
+        ZeroMemory(State.Shadow.States.IsValid, MAX_RENDER_STATE_COUNT * sizeof(BOOL));
+        ZeroMemory(State.Shadow.Stages.IsValid, MAX_TEXTURE_STAGE_COUNT * MAX_TEXTURE_STAGE_STATE_COUNT * sizeof(BOOL));
+
+        State.Textures.Palettes.Current = INVALID_TEXTURE_PALETTE_VALUE;
+    }
+
+    // 0x60004800
+    void InitializeRendererState(void)
+    {
+        InitializeRendererShadowStates();
+
+        State.DepthRange.IsActive = FALSE;
+        State.DepthRange.IsInverse = FALSE;
+        State.DepthRange.IsCleared = FALSE;
+        State.DepthRange.Frame = 0;
+        State.DepthRange.Function = D3DCMP_LESSEQUAL;
+
+        SelectRendererTransforms(1.0f, 65535.0f);
+
+        State.DX.Device->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        State.DX.Device->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        State.DX.Device->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        State.DX.Device->SetRenderState(D3DRS_ALPHATESTENABLE, TRUE);
+        State.DX.Device->SetRenderState(D3DRS_ALPHAFUNC, D3DCMP_GREATER);
+        State.DX.Device->SetRenderState(D3DRS_ALPHAREF, 0);
+
+        if (!State.Device.Capabilities.IsDepthAvailable || State.DX.Surfaces.Bits == 0)
+        {
+            State.DX.Device->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+            State.DX.Device->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+            State.DX.Device->SetRenderState(D3DRS_ZFUNC, D3DCMP_ALWAYS);
+        }
+        else
+        {
+            State.DX.Device->SetRenderState(D3DRS_ZENABLE, D3DZB_TRUE);
+            State.DX.Device->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+            State.DX.Device->SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
+        }
+
+        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+
+        if (!State.Device.Capabilities.IsModulateBlending)
+        {
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+        }
+        else
+        {
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+            State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+        }
+
+        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
+        State.DX.Device->SetTextureStageState(RENDERER_TEXTURE_STAGE_0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+
+        State.Textures.Atlases.AddressU = D3DTADDRESS_CLAMP;
+        State.Textures.Atlases.AddressV = D3DTADDRESS_CLAMP;
+
+        State.DX.Device->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
+        State.DX.Device->SetRenderState(D3DRS_CLIPPING, 0);
+        State.DX.Device->SetRenderState(D3DRS_LIGHTING, 0);
+
+        {
+            const char* value = getenv(RENDERER_MODULE_WIRE_FRAME_DX8_ENVIRONMENT_PROPERTY_NAME);
+
+            State.DX.Device->SetRenderState(D3DRS_FILLMODE,
+                (value == NULL || atoi(value) == 0) ? D3DFILL_SOLID : D3DFILL_WIREFRAME);
+        }
+
+        State.DX.Device->SetRenderState(D3DRS_DITHERENABLE, FALSE);
+        State.DX.Device->SetRenderState(D3DRS_SPECULARENABLE, FALSE);
+        State.DX.Device->SetRenderState(D3DRS_FOGENABLE, FALSE);
+        State.DX.Device->SetRenderState(D3DRS_FOGCOLOR, 0x00ffffff);
+        State.DX.Device->SetRenderState(D3DRS_FOGTABLEMODE, D3DFOG_NONE);
+        State.DX.Device->SetRenderState(D3DRS_FOGVERTEXMODE, 0);
+        
+        {
+            const f32 value = 0.0f;
+            State.DX.Device->SetRenderState(D3DRS_FOGSTART, *(DWORD*)(&value));
+        }
+
+        {
+            const f32 value = 1.0f;
+            State.DX.Device->SetRenderState(D3DRS_FOGEND, *(DWORD*)(&value));
+        }
+
+        State.DX.Device->SetRenderState(D3DRS_TEXTUREFACTOR, GRAPCHICS_COLOR_WHITE);
+
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE, (void*)RENDERER_MODULE_TEXTURE_FILTER_LENEAR);
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_MIP_FILTER_STATE, (void*)RENDERER_MODULE_TEXTURE_MIP_FILTER_POINT);
+    }
+
+    // 0x60004b80
+    u32 SelectRendererTransforms(const f32 zNear, const f32 zFar)
+    {
+        if ((zFar <= zNear) != (zFar == zNear)) { return TRUE; }
+
+        D3DMATRIX world;
+
+        world._11 = 1.0f;
+        world._12 = 0.0f;
+        world._13 = 0.0f;
+        world._14 = 0.0f;
+
+        world._21 = 0.0f;
+        world._22 = 1.0f;
+        world._23 = 0.0f;
+        world._24 = 0.0f;
+
+        world._31 = 0.0f;
+        world._32 = 0.0f;
+        world._33 = 1.0f;
+        world._34 = 0.0f;
+
+        world._41 = 0.0f;
+        world._42 = 0.0f;
+        world._43 = 0.0f;
+        world._44 = 1.0f;
+
+        D3DMATRIX view;
+
+        view._11 = 1.0f;
+        view._12 = 0.0f;
+        view._13 = 0.0f;
+        view._14 = 0.0f;
+
+        view._21 = 0.0f;
+        view._22 = 1.0f;
+        view._23 = 0.0f;
+        view._24 = 0.0f;
+
+        view._31 = 0.0f;
+        view._32 = 0.0f;
+        view._33 = 1.0f;
+        view._34 = 0.0f;
+
+        view._41 = 0.0f;
+        view._42 = 0.0f;
+        view._43 = 0.0f;
+        view._44 = 1.0f;
+
+        D3DMATRIX projection;
+
+        projection._11 = 1.0f;
+        projection._12 = 0.0f;
+        projection._13 = 0.0f;
+        projection._14 = 0.0f;
+
+        projection._21 = 0.0f;
+        projection._22 = 1.0f;
+        projection._23 = 0.0f;
+        projection._24 = 0.0f;
+
+        projection._31 = 0.0f;
+        projection._32 = 0.0f;
+        projection._33 = 1.0f;
+        projection._34 = 0.0f;
+
+        projection._41 = 0.0f;
+        projection._42 = 0.0f;
+        projection._43 = 0.0f;
+        projection._44 = 1.0f;
+
+        HRESULT result = State.DX.Device->SetTransform(D3DTS_WORLD, &world);
+
+        if (result == D3D_OK)
+        {
+            result = State.DX.Device->SetTransform(D3DTS_VIEW, &view);
+
+            if (result == D3D_OK)
+            {
+                projection._44 = zNear;
+                projection._34 = 1.0f;
+                projection._33 = zNear / (zFar - zNear) + 1.0f;
+                projection._43 = 0.0f;
+
+                result = State.DX.Device->SetTransform(D3DTS_PROJECTION, &projection);
+            }
+        }
+
+        return result;
+    }
+
+    // 0x60001b40
+    BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value)
+    {
+        if (type < MAX_RENDER_STATE_COUNT)
+        {
+            if (State.Shadow.States.IsValid[type] && State.Shadow.States.Values[type] == value)
+            {
+                State.Statistics.Filtered = State.Statistics.Filtered + 1;
+
+                return TRUE;
+            }
+
+            State.Shadow.States.IsValid[type] = TRUE;
+            State.Shadow.States.Values[type] = value;
+        }
+
+        BeginRendererScene();
+
+        RenderPackets();
+
+        const BOOL result = State.DX.Device->SetRenderState(type, value) == D3D_OK;
+
+        if (!result && type < MAX_RENDER_STATE_COUNT) { State.Shadow.States.IsValid[type] = FALSE; }
+
+        return result;
+    }
+    
+    // Selects the depth comparison, which is inverted while the frame is drawn into the upper half of the depth range.
+    BOOL SelectRendererDepthFunction(const D3DCMPFUNC function)
+    {
+        State.DepthRange.Function = function;
+
+        if (State.DepthRange.IsInverse)
+        {
+            switch (function)
+            {
+            case D3DCMP_LESS: { return SelectRendererState(D3DRS_ZFUNC, D3DCMP_GREATER); }
+            case D3DCMP_LESSEQUAL: { return SelectRendererState(D3DRS_ZFUNC, D3DCMP_GREATEREQUAL); }
+            case D3DCMP_GREATER: { return SelectRendererState(D3DRS_ZFUNC, D3DCMP_LESS); }
+            case D3DCMP_GREATEREQUAL: { return SelectRendererState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL); }
+            }
+        }
+
+        return SelectRendererState(D3DRS_ZFUNC, function);
+    }
+
+    // Switches the frame between the lower half of the depth range, and the inverted upper half of it.
+    // The vertexes are remapped as they are appended, so the pending packets must have been rendered beforehand.
+    void SelectRendererDepthRange(const BOOL active, const BOOL inverse)
+    {
+        State.DepthRange.IsActive = active;
+        State.DepthRange.IsInverse = inverse;
+
+        SelectRendererDepthFunction(State.DepthRange.Function);
+        SelectRendererVertexTransforms();
+    }
+
+    // 0x60001c40
+    BOOL SelectRendererMaterial(const u32 color)
+    {
+        D3DMATERIAL8 material;
+        ZeroMemory(&material, sizeof(D3DMATERIAL8));
+
+        RendererClearColor = color;
+
+        const f32 red = RGBA_GETRED(color) / 255.0f;
+        const f32 green = RGBA_GETGREEN(color) / 255.0f;
+        const f32 blue = RGBA_GETBLUE(color) / 255.0f;
+
+        material.Diffuse.r = red;
+        material.Diffuse.g = green;
+        material.Diffuse.b = blue;
+
+        material.Ambient.r = red;
+        material.Ambient.g = green;
+        material.Ambient.b = blue;
+
+        State.DX.Device->SetMaterial(&material);
+
+        return TRUE;
+    }
+
+    // 0x60001b10
+    BOOL SelectRendererTextureStage(const u32 stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value)
+    {
+        if (stage < MAX_TEXTURE_STAGE_COUNT && type < MAX_TEXTURE_STAGE_STATE_COUNT)
+        {
+            if (State.Shadow.Stages.IsValid[stage][type] && State.Shadow.Stages.Values[stage][type] == value)
+            {
+                State.Statistics.Filtered = State.Statistics.Filtered + 1;
+
+                return TRUE;
+            }
+
+            State.Shadow.Stages.IsValid[stage][type] = TRUE;
+            State.Shadow.Stages.Values[stage][type] = value;
+        }
+
+        BeginRendererScene();
+
+        RenderPackets();
+
+        const BOOL result = State.DX.Device->SetTextureStageState(stage, type, value) == D3D_OK;
+
+        if (!result && stage < MAX_TEXTURE_STAGE_COUNT && type < MAX_TEXTURE_STAGE_STATE_COUNT) { State.Shadow.Stages.IsValid[stage][type] = FALSE; }
+
+        if (result && stage == RENDERER_TEXTURE_STAGE_0)
+        {
+            if (type == D3DTSS_ADDRESSU) { State.Textures.Atlases.AddressU = value; }
+            if (type == D3DTSS_ADDRESSV) { State.Textures.Atlases.AddressV = value; }
+
+            // NOTE: The packed texture selected into the first stage is moved into the device texture of its own,
+            // once its texture coordinates wrap, or mirror, since the neighbouring textures of the atlas would be sampled otherwise.
+            RendererTexture* tex = State.Textures.Atlases.Current;
+
+            if (tex != NULL && !IsRendererTextureAtlasClamped())
+            {
+                if (UnpackRendererTexture(tex)) { State.DX.Device->SetTexture(RENDERER_TEXTURE_STAGE_0, tex->Texture); }
+            }
+        }
+
+        return result;
+    }
+
+    // 0x600076f0
+    void SelectRendererFogAlphas(const u8* input, u8* output)
+    {
+        if (input == NULL || output == NULL) { return; }
+
+        for (u32 x = 0; x < MAX_INPUT_FOG_ALPHA_COUNT; x++)
+        {
+            u8 current = input[x];
+            u8 next = input[Clamp<u32>(x + 1, 0, MAX_INPUT_FOG_ALPHA_COUNT - 1)];
+
+            output[x * 4 + 0] = current;
+            output[x * 4 + 1] = (u8)((s32)current + (s32)(0.33f * (next - current)));
+            output[x * 4 + 2] = (u8)((s32)current + (s32)(0.67f * (next - current)));
+            output[x * 4 + 3] = next;
+        }
+    }
+
+    // 0x60002f30
+    BOOL RestoreRendererSurfaces(void)
+    {
+        for (u32 x = 0; x < 4; x++)
+        {
+            const HRESULT result = State.DX.Device->TestCooperativeLevel();
+
+            if (result == D3DERR_DEVICENOTRESET || result == D3D_OK) { return TRUE; }
+
+            Sleep(100);
+        }
+
+        return FALSE;
+    }
+
+    // 0x60001910
+    void ModifyRendererSurface(IDirect3DSurface8* surface, const u32 count)
+    {
+        if (surface == NULL) { return; }
+
+        u32 actual = surface->AddRef() - 1;
+
+        surface->Release();
+
+        if (actual != count)
+        {
+            while (actual < count) { actual = surface->AddRef(); }
+            while (count < actual) { actual = surface->Release(); }
+        }
+    }
+
+    // 0x60001d00
+    u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1, const BOOL window)
+    {
+        D3DRECT rect;
+
+        DWORD options = (window == FALSE); // D3DCLEAR_TARGET
+
+        DWORD state = D3DZB_FALSE;
+
+        if (State.Device.Capabilities.IsDepthAvailable && State.DX.Surfaces.Bits != 0)
+        {
+            State.DX.Device->GetRenderState(D3DRS_ZENABLE, &state);
+
+            if (state != D3DZB_FALSE) { options = options | D3DCLEAR_ZBUFFER; }
+        }
+
+        if (State.Device.Capabilities.IsStencilBufferAvailable) { options = options | D3DCLEAR_STENCIL; }
+
+        if (x1 == 0)
+        {
+            rect.x1 = 0;
+            rect.y1 = 0;
+            rect.x2 = State.DX.Surfaces.Width;
+            rect.y2 = State.DX.Surfaces.Height;
+        }
+        else
+        {
+            rect.x1 = x0;
+            rect.x2 = x0 + x1;
+            rect.y1 = y0;
+            rect.y2 = y0 + y1;
+        }
+
+        f32 depth = RendererClearDepth;
+
+        if ((options & D3DCLEAR_ZBUFFER) && SettingsState.DepthClearInterval > 1)
+        {
+            // NOTE: The first clear of the whole window after the page flip starts a new frame, which switches to the other half of the depth range.
+            // The depth buffer is then left as is, except for every Nth frame, because the previous frame wrote only into the other half.
+            if (!State.DepthRange.IsCleared && rect.x1 == 0 && rect.y1 == 0
+                && rect.x2 == (LONG)State.DX.Surfaces.Width && rect.y2 == (LONG)State.DX.Surfaces.Height)
+            {
+                State.DepthRange.IsCleared = TRUE;
+
+                RenderPackets();
+
+                // NOTE: The W buffer does not use the Z values, thus the depth range cannot be used with it.
+                const BOOL active = state != D3DZB_USEW;
+
+                SelectRendererDepthRange(active, active && !State.DepthRange.IsInverse);
+
+                if (active)
+                {
+                    if (State.DepthRange.Frame != 0) { options = options & ~D3DCLEAR_ZBUFFER; }
+
+                    State.DepthRange.Frame = (State.DepthRange.Frame + 1) % SettingsState.DepthClearInterval;
+                }
+            }
+
+            if (State.DepthRange.IsActive) { depth = State.DepthRange.IsInverse ? (1.0f - 0.5f * depth) : (0.5f * depth); }
+        }
+
+        if (options == 0) { return TRUE; }
+
+        return State.DX.Device->Clear(1, &rect, options, RendererClearColor, depth, 0) == D3D_OK;
+    }
+
+    // 0x60001b70
+    u32 ToggleRenderer(void)
+    {
+        if (State.DX.Device->TestCooperativeLevel() != D3D_OK)
+        {
+            if (RendererToggleState)
+            {
+                if (State.Lambdas.ToggleRenderer != NULL) { State.Lambdas.ToggleRenderer(FALSE); }
+
+                RendererToggleState = FALSE;
+            }
+
+            while (TRUE)
+            {
+                if (State.DX.Device->TestCooperativeLevel() == D3DERR_DEVICENOTRESET)
+                {
+                    ReleaseRendererObjects();
+
+                    if (State.DX.Device->Reset(&State.Device.Presentation) == D3D_OK)
+                    {
+                        // NOTE: Device reset brings all of the states back to their defaults.
+                        InitializeRendererShadowStates();
+
+                        if (State.Lambdas.ToggleRenderer != NULL) { State.Lambdas.ToggleRenderer(TRUE); }
+                    }
+
+                    RendererToggleState = TRUE;
+
+                    return RENDERER_MODULE_SUCCESS;
+                }
+
+                if (State.Lambdas.ToggleRendererWait != NULL) { State.Lambdas.ToggleRendererWait(State.Lambdas.ToggleRendererWaitContext); }
+
+                Sleep(10);
+            }
+        }
+
+        State.DX.Device->Present(NULL, NULL, State.Window.HWND, NULL);
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60007af0
+    RendererTexture* AllocateRendererTexture(void)
+    {
+        return AllocateRendererTexture(sizeof(RendererTexture));
+    }
+
+    // 0x600087c0
+    RendererTexture* AllocateRendererTexture(const u32 size)
+    {
+        if (State.Lambdas.AllocateMemory != NULL)
+        {
+            return (RendererTexture*)State.Lambdas.AllocateMemory(size);
+        }
+
+        return (RendererTexture*)malloc(size);
+    }
+
+    // 0x60007e60
+    HRESULT InitializeRendererTexture(RendererTexture* tex)
+    {
+        const HRESULT result = State.DX.Device->CreateTexture(tex->Width, tex->Height,
+            tex->MipMapCount + 1, D3DUSAGE_NONE, tex->TextureFormat, D3DPOOL_MANAGED, &tex->Texture);
+
+        if (result == D3D_OK) { tex->MemoryType = RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY; }
+
+        return result;
+    }
+
+    // 0x600092b0
+    // NOTE: The palettes are handed out from the list of the released palettes without colors, and then from the ones never used,
+    // instead of the original bit tree. The least recently used released palette, that keeps its colors, is reused
+    // once too many of the released palettes keep their colors, or once all of the palettes are handed out.
+    u32 AcquireTexturePalette()
+    {
+        if (IsTexturePaletteInactive)
+        {
+            InitializeTexturePalette();
+
+            IsTexturePaletteInactive = FALSE;
+        }
+
+        u32 indx = INVALID_TEXTURE_PALETTE_VALUE;
+
+        if (MAX_TEXTURE_PALETTE_CACHE_COUNT <= State.Textures.Palettes.Unused) { indx = State.Textures.Palettes.Oldest; }
+        else if (State.Textures.Palettes.Free != INVALID_TEXTURE_PALETTE_VALUE)
+        {
+            indx = State.Textures.Palettes.Free;
+
+            State.Textures.Palettes.Free = State.Textures.Palettes.Palettes[indx].Next;
+        }
+        else if (State.Textures.Palettes.Count < MAX_TEXTURE_PALETTE_COUNT)
+        {
+            indx = State.Textures.Palettes.Count;
+
+            State.Textures.Palettes.Count = State.Textures.Palettes.Count + 1;
+        }
+        else { indx = State.Textures.Palettes.Oldest; }
+
+        if (indx == INVALID_TEXTURE_PALETTE_VALUE) { return INVALID_TEXTURE_PALETTE_VALUE; }
+
+        TexturePalette* palette = &State.Textures.Palettes.Palettes[indx];
+
+        // NOTE: The reused palette loses its colors, thus it is removed from its hash bucket.
+        if (palette->Hash != INVALID_TEXTURE_HASH)
+        {
+            DetachTexturePalette(indx);
+
+            u32* bucket = &State.Textures.Palettes.Buckets[palette->Hash & (MAX_TEXTURE_PALETTE_BUCKET_COUNT - 1)];
+
+            while (*bucket != indx) { bucket = &State.Textures.Palettes.Palettes[*bucket].Next; }
+
+            *bucket = palette->Next;
+        }
+
+        palette->Hash = INVALID_TEXTURE_HASH;
+        palette->References = 1;
+        palette->Next = INVALID_TEXTURE_PALETTE_VALUE;
+        palette->Older = INVALID_TEXTURE_PALETTE_VALUE;
+        palette->Newer = INVALID_TEXTURE_PALETTE_VALUE;
+
+        return indx;
+    }
+
+    // Acquires the palette with the colors of the hash, either shared with the other textures, or released earlier,
+    // or INVALID_TEXTURE_PALETTE_VALUE when there is no such palette.
+    u32 AcquireTexturePalette(const u64 hash)
+    {
+        u32 indx = State.Textures.Palettes.Buckets[hash & (MAX_TEXTURE_PALETTE_BUCKET_COUNT - 1)];
+
+        while (indx != INVALID_TEXTURE_PALETTE_VALUE)
+        {
+            TexturePalette* palette = &State.Textures.Palettes.Palettes[indx];
+
+            if (palette->Hash == hash)
+            {
+                if (palette->References == 0) { DetachTexturePalette(indx); }
+
+                palette->References = palette->References + 1;
+
+                return indx;
+            }
+
+            indx = palette->Next;
+        }
+
+        return INVALID_TEXTURE_PALETTE_VALUE;
+    }
+
+    // Removes the released palette from the list of the released palettes, that keep their colors.
+    void DetachTexturePalette(const u32 palette)
+    {
+        TexturePalette* p = &State.Textures.Palettes.Palettes[palette];
+
+        if (p->Older == INVALID_TEXTURE_PALETTE_VALUE) { State.Textures.Palettes.Oldest = p->Newer; }
+        else { State.Textures.Palettes.Palettes[p->Older].Newer = p->Newer; }
+
+        if (p->Newer == INVALID_TEXTURE_PALETTE_VALUE) { State.Textures.Palettes.Newest = p->Older; }
+        else { State.Textures.Palettes.Palettes[p->Newer].Older = p->Older; }
+
+        p->Older = INVALID_TEXTURE_PALETTE_VALUE;
+        p->Newer = INVALID_TEXTURE_PALETTE_VALUE;
+
+        State.Textures.Palettes.Unused = State.Textures.Palettes.Unused - 1;
+    }
+
+    // 0x60009210
+    void InitializeTexturePalette(void)
+    {
+        State.Textures.Palettes.Current = INVALID_TEXTURE_PALETTE_VALUE;
+
+        State.Textures.Palettes.Count = 0;
+        State.Textures.Palettes.Free = INVALID_TEXTURE_PALETTE_VALUE;
+
+        State.Textures.Palettes.Unused = 0;
+        State.Textures.Palettes.Oldest = INVALID_TEXTURE_PALETTE_VALUE;
+        State.Textures.Palettes.Newest = INVALID_TEXTURE_PALETTE_VALUE;
+
+        for (u32 x = 0; x < MAX_TEXTURE_PALETTE_BUCKET_COUNT; x++)
+        {
+            State.Textures.Palettes.Buckets[x] = INVALID_TEXTURE_PALETTE_VALUE;
+        }
+    }
+
+    // 0x60009250
+    // NOTE: The released palette, that holds the colors, keeps them, so that the texture with the same colors
+    // shares it again without uploading the colors, until the palette is reused.
+    void ReleaseTexturePalette(const s32 palette)
+    {
+        if (IsTexturePaletteInactive || palette < 0 || MAX_TEXTURE_PALETTE_COUNT <= palette) { return; }
+
+        TexturePalette* p = &State.Textures.Palettes.Palettes[palette];
+
+        if (p->References == 0) { return; }
+
+        p->References = p->References - 1;
+
+        if (p->References != 0) { return; }
+
+        if (p->Hash == INVALID_TEXTURE_HASH)
+        {
+            p->Next = State.Textures.Palettes.Free;
+
+            State.Textures.Palettes.Free = palette;
+
+            return;
+        }
+
+        p->Older = State.Textures.Palettes.Newest;
+        p->Newer = INVALID_TEXTURE_PALETTE_VALUE;
+
+        if (State.Textures.Palettes.Newest == INVALID_TEXTURE_PALETTE_VALUE) { State.Textures.Palettes.Oldest = palette; }
+        else { State.Textures.Palettes.Palettes[State.Textures.Palettes.Newest].Newer = palette; }
+
+        State.Textures.Palettes.Newest = palette;
+
+        State.Textures.Palettes.Unused = State.Textures.Palettes.Unused + 1;
+    }
+
+    // 0x600090d0
+    void InitializeRenderState55(void)
+    {
+        SelectBasicRendererState(RENDERER_MODULE_STATE_55, (void*)(DAT_6001eedc + 1));
+        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
+    }
+
+    // 0x600087e0
+    u32 DisposeRendererTexture(RendererTexture* tex)
+    {
+        if (State.Lambdas.ReleaseMemory != NULL) { return State.Lambdas.ReleaseMemory(tex); }
+
+        free(tex);
+
+        return RENDERER_MODULE_SUCCESS;
+    }
+
+    // 0x60007b00
+    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette)
+    {
+        if (tex == NULL) { return FALSE; }
+        if (pixels == NULL && palette == NULL) { return FALSE; }
+
+        if (palette != NULL)
+        {
+            if (!UpdateRendererTexturePalette(tex, palette)) { return FALSE; }
+        }
+
+        if (pixels == NULL) { return TRUE; }
+
+        if (tex->IsCompressed) { return SubmitRendererTextureUpload(tex, pixels); }
+
+        // NOTE: The pixels are in the format of the texture, unless the texture holds the decoded block compressed pixels.
+        const D3DFORMAT format = AcquireRendererTextureFormat(tex->PixelFormat);
+
+        u32* px = (u32*)pixels;
+
+        if (tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT1 || tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT3)
+        {
+            const u8 v0 = (*(u8*)((addr)px + (addr)0));
+            const u8 v1 = (*(u8*)((addr)px + (addr)1));
+
+            if ((v0 == 24 && v1 == 251) || (v0 == 26 && v1 == 251))
+            {
+                px = (u32*)((addr)px + (addr)(2 * sizeof(u32)));
+            }
+        }
+
+        // NOTE: The pixels of the packed textures are converted straight into their rectangles within the atlas.
+        if (tex->Atlas != NULL)
+        {
+            D3DRECT rect;
+
+            rect.x1 = 0;
+            rect.x2 = tex->Width;
+
+            rect.y1 = 0;
+            rect.y2 = tex->Height;
+
+            return UploadRendererTextureAtlas(tex, px, format, AcquireRendererTextureLevelPitch(format, tex->Width, tex->PixelSize), &rect);
+        }
+
+        // NOTE: The pixels, that need the conversion into the format of the texture, are converted on the worker threads.
+        if (SettingsState.TextureStaging && format != tex->TextureFormat
+            && AcquireImageDXTBlockSize(tex->TextureFormat) == 0
+            && AcquireRendererDeviceFormatSize(tex->TextureFormat, RendererDeviceFormatSizeBytes) != 0)
+        {
+            return SubmitRendererTextureUpload(tex, px);
+        }
+
+        // NOTE: The pending upload of the texture would overwrite the pixels once committed.
+        CancelRendererTextureUpload(tex);
+
+        // NOTE: The plain pixels are converted straight into the locked levels of the texture,
+        // while the block compressed pixels are converted through the image containers.
+        if (tex->Width <= MAX_IMAGE_ROW_PIXEL_COUNT && tex->PixelSize != 0
+            && AcquireImagePixelCalls(format) != NULL && AcquireImagePixelCalls(tex->TextureFormat) != NULL
+            && (format == tex->TextureFormat || (format != D3DFMT_P8 && format != D3DFMT_A8P8
+                && tex->TextureFormat != D3DFMT_P8 && tex->TextureFormat != D3DFMT_A8P8)))
+        {
+            return UploadRendererTexturePixels(tex, px, format);
+        }
+
+        for (u32 x = 0; x < tex->MipMapCount; x++)
+        {
+            IDirect3DSurface8* surface = NULL;
+            tex->Texture->GetSurfaceLevel(x, &surface);
+
+            D3DSURFACE_DESC desc;
+            ZeroMemory(&desc, sizeof(D3DSURFACE_DESC));
+
+            surface->GetDesc(&desc);
+
+            D3DRECT rect;
+
+            rect.x1 = 0;
+            rect.x2 = desc.Width;
+
+            rect.y1 = 0;
+            rect.y2 = desc.Height;
+
+            // NOTE: The pitch of the pixels is calculated from their format, instead of locking the level just to acquire its pitch.
+            const u32 pitch = AcquireRendererTextureLevelPitch(format, desc.Width, tex->PixelSize);
+            const u32 size = pitch * AcquireRendererTextureLevelRows(format, desc.Height);
+
+            if (UpdateRendererTextureLevel(surface, NULL, &rect, px, format, pitch,
+                NULL, &rect, IMAGE_CONTAINER_OPTIONS_COLOR, GRAPCHICS_COLOR_BLACK) != D3D_OK)
+            {
+                surface->Release();
+
+                return FALSE;
+            }
+
+            surface->Release();
+
+            px = (u32*)((addr)px + (addr)size);
+        }
+
+        return TRUE;
+    }
+
+    // 0x60009140
+    // NOTE: The textures with the same colors share the same palette, so the colors of the palette are uploaded
+    // only when no other palette, either in use or released, holds them already.
+    BOOL UpdateRendererTexturePalette(RendererTexture* tex, const u32* palette)
+    {
+        if (tex == NULL || palette == NULL) { return FALSE; }
+        if (RendererTextureFormatStates[2] != 1) { return FALSE; } // TODO
+        if (tex->PaletteMode != RENDERER_MODULE_PALETTE_ACQUIRE) { return FALSE; }
+
+        if (tex->Palette != INVALID_TEXTURE_PALETTE_VALUE)
+        {
+            const u64 hash = AcquireRendererTextureHash(palette, MAX_TEXTURE_PALETTE_COLOR_COUNT * sizeof(u32));
+
+            TexturePalette* current = &State.Textures.Palettes.Palettes[tex->Palette];
+
+            if (current->Hash != hash)
+            {
+                u32 indx = AcquireTexturePalette(hash);
+
+                if (indx == INVALID_TEXTURE_PALETTE_VALUE)
+                {
+                    // NOTE: The palette of the texture is only filled in place while it holds no colors, and no other texture shares it,
+                    // otherwise its colors are kept for the textures switching back to them.
+                    indx = (current->Hash == INVALID_TEXTURE_HASH && current->References == 1) ? tex->Palette : AcquireTexturePalette();
+
+                    if (indx == INVALID_TEXTURE_PALETTE_VALUE) { return FALSE; }
+
+                    PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+
+                    for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
+                    {
+                        entries[x].peRed = (palette[x] >> 16) & 0xff;
+                        entries[x].peGreen = (palette[x] >> 8) & 0xff;
+                        entries[x].peBlue = (palette[x] >> 0) & 0xff;
+                        entries[x].peFlags = (palette[x] >> 24) & 0xff;
+                    }
+
+                    if (State.DX.Device->SetPaletteEntries(indx, entries) != D3D_OK)
+                    {
+                        if (indx != tex->Palette) { ReleaseTexturePalette(indx); }
+
+                        return FALSE;
+                    }
+
+                    TexturePalette* p = &State.Textures.Palettes.Palettes[indx];
+                    u32* bucket = &State.Textures.Palettes.Buckets[hash & (MAX_TEXTURE_PALETTE_BUCKET_COUNT - 1)];
+
+                    p->Hash = hash;
+                    p->Next = *bucket;
+
+                    *bucket = indx;
+                }
+
+                if (indx != tex->Palette)
+                {
+                    ReleaseTexturePalette(tex->Palette);
+
+                    tex->Palette = indx;
+                }
+            }
+
+            return SelectRendererTexturePalette(tex->Palette);
+        }
+
+        return FALSE;
+    }
+
+    // Selects the palette into the device, unless it is selected already.
+    BOOL SelectRendererTexturePalette(const u32 palette)
+    {
+        if (State.Textures.Palettes.Current == palette) { return TRUE; }
+
+        if (State.DX.Device->SetCurrentTexturePalette(palette) != D3D_OK)
+        {
+            State.Textures.Palettes.Current = INVALID_TEXTURE_PALETTE_VALUE;
+
+            return FALSE;
+        }
+
+        State.Textures.Palettes.Current = palette;
+
+        return TRUE;
+    }
+
+    // 0x60007c90
+    BOOL UpdateRendererTextureRectangle(RendererTexture* tex, const u32* pixels, const u32* palette, const s32 x, const s32 y, const s32 width, const s32 height, const s32 size, const s32 level)
+    {
+        if (tex == NULL) { return FALSE; }
+        if (pixels == NULL && palette == NULL) { return FALSE; }
+
+        if (-1 < x && -1 < y && 0 < width && 0 < height && 0 < size && -1 < level)
+        {
+            if (palette == NULL || UpdateRendererTexturePalette(tex, palette))
+            {
+                if (pixels == NULL) { return TRUE; }
+
+                // NOTE: The pending upload of the texture would overwrite the rectangle once complete.
+                WaitRendererTextureUpload(tex);
+
+                // NOTE: The packed textures have the single level, which is a rectangle within the atlas.
+                if (tex->Atlas != NULL)
+                {
+                    if (level != 0 || tex->Width < (u32)(x + width) || tex->Height < (u32)(y + height)) { return FALSE; }
+
+                    D3DRECT rect;
+
+                    rect.x1 = x;
+                    rect.x2 = x + width;
+                    rect.y1 = y;
+                    rect.y2 = y + height;
+
+                    return UploadRendererTextureAtlas(tex, pixels, AcquireRendererTextureFormat(tex->PixelFormat), size, &rect);
+                }
+
+                IDirect3DSurface8* surface = NULL;
+                tex->Texture->GetSurfaceLevel(level, &surface);
+
+                D3DSURFACE_DESC desc;
+                ZeroMemory(&desc, sizeof(D3DSURFACE_DESC));
+
+                surface->GetDesc(&desc);
+
+                D3DRECT dst;
+
+                dst.x1 = x;
+                dst.x2 = x + width;
+                dst.y1 = y;
+                dst.y2 = height + y;
+
+                D3DRECT src;
+
+                src.x1 = 0;
+                src.x2 = width;
+                src.y1 = 0;
+                src.y2 = height;
+
+                if (dst.x2 <= desc.Width && dst.y2 <= desc.Height)
+                {
+                    u32* px = (u32*)pixels;
+
+                    if (tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT1 || tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT3)
+                    {
+                        const u8 v0 = (*(u8*)((addr)px + (addr)0));
+                        const u8 v1 = (*(u8*)((addr)px + (addr)1));
+
+                        if ((v0 == 24 && v1 == 251) || (v0 == 26 && v1 == 251)) // TODO
+                        {
+                            px = (u32*)((addr)px + (addr)(2 * sizeof(u32)));
+                        }
+                    }
+
+                    if (UpdateRendererTextureLevel(surface,
+                        NULL, &dst, px, AcquireRendererTextureFormat(tex->PixelFormat), size,
+                        NULL, &src, IMAGE_CONTAINER_OPTIONS_COLOR, GRAPCHICS_COLOR_BLACK) == D3D_OK)
+                    {
+                        surface->Release();
+
+                        return TRUE;
+                    }
+
+                    surface->Release();
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    // Acquires the block compressed format, that the pixels of the format are compressed into on upload.
+    // NOTE: The compression is limited to the textures of the whole blocks, and to the formats the device supports natively.
+    D3DFORMAT AcquireRendererTextureCompressionFormat(const u32 width, const u32 height, const u32 format)
+    {
+        if (!SettingsState.TextureCompression) { return D3DFMT_UNKNOWN; }
+
+        if (MAX_IMAGE_ROW_PIXEL_COUNT < width
+            || (width % IMAGE_DXT_DIMENSION) != 0 || (height % IMAGE_DXT_DIMENSION) != 0) { return D3DFMT_UNKNOWN; }
+
+        switch (format)
+        {
+        case RENDERER_PIXEL_FORMAT_R5G5B5:
+        case RENDERER_PIXEL_FORMAT_R5G6B5:
+        {
+            if (State.Textures.Formats[RENDERER_PIXEL_FORMAT_DXT1] == D3DFMT_DXT1) { return D3DFMT_DXT1; }
+
+            break;
+        }
+        case RENDERER_PIXEL_FORMAT_A8R8G8B8:
+        case RENDERER_PIXEL_FORMAT_R4G4B4:
+        {
+            if (State.Textures.Formats[RENDERER_PIXEL_FORMAT_DXT5] == D3DFMT_DXT5) { return D3DFMT_DXT5; }
+
+            break;
+        }
+        }
+
+        return D3DFMT_UNKNOWN;
+    }
+
+    // Starts the worker threads of the texture uploads, unless they are already running.
+    BOOL InitializeRendererTextureUploads(void)
+    {
+        if (State.Uploads.IsActive) { return TRUE; }
+
+        SYSTEM_INFO info;
+        ZeroMemory(&info, sizeof(SYSTEM_INFO));
+
+        GetSystemInfo(&info);
+
+        // NOTE: One of the processors is left to the application.
+        const u32 count = Clamp((u32)info.dwNumberOfProcessors - 1, (u32)1, (u32)MAX_TEXTURE_UPLOAD_THREAD_COUNT);
+
+        State.Uploads.Work = CreateSemaphoreA(NULL, 0, 0x7FFFFFFF, NULL);
+
+        if (State.Uploads.Work == NULL) { return FALSE; }
+
+        InitializeCriticalSection(&State.Uploads.Lock);
+
+        State.Uploads.Pending = NULL;
+        State.Uploads.Last = NULL;
+        State.Uploads.Complete = NULL;
+
+        State.Uploads.Count = 0;
+
+        for (u32 x = 0; x < count; x++)
+        {
+            HANDLE thread = CreateThread(NULL, 0, PrepareRendererTextureUploadThread, NULL, 0, NULL);
+
+            if (thread == NULL) { break; }
+
+            State.Uploads.Threads[State.Uploads.Count] = thread;
+            State.Uploads.Count = State.Uploads.Count + 1;
+        }
+
+        if (State.Uploads.Count == 0)
+        {
+            DeleteCriticalSection(&State.Uploads.Lock);
+
+            CloseHandle(State.Uploads.Work);
+            State.Uploads.Work = NULL;
+
+            LOGWARNING("Unable to start texture upload threads, converting textures on upload.\n");
+
+            return FALSE;
+        }
+
+        State.Uploads.IsActive = TRUE;
+
+        return TRUE;
+    }
+
+    // Stops the worker threads of the texture uploads, and discards the pixels of the pending textures.
+    void ReleaseRendererTextureUploads(void)
+    {
+        if (!State.Uploads.IsActive) { return; }
+
+        EnterCriticalSection(&State.Uploads.Lock);
+
+        RendererTextureUpload* pending = State.Uploads.Pending;
+
+        State.Uploads.Pending = NULL;
+        State.Uploads.Last = NULL;
+
+        State.Uploads.IsActive = FALSE;
+
+        LeaveCriticalSection(&State.Uploads.Lock);
+
+        // NOTE: The worker threads exit once there is no pending task to prepare, and the uploads are no longer active.
+        ReleaseSemaphore(State.Uploads.Work, State.Uploads.Count, NULL);
+
+        for (u32 x = 0; x < State.Uploads.Count; x++)
+        {
+            WaitForSingleObject(State.Uploads.Threads[x], INFINITE);
+            CloseHandle(State.Uploads.Threads[x]);
+
+            State.Uploads.Threads[x] = NULL;
+        }
+
+        CloseHandle(State.Uploads.Work);
+        DeleteCriticalSection(&State.Uploads.Lock);
+
+        while (pending != NULL)
+        {
+            RendererTextureUpload* next = pending->Next;
+
+            DisposeRendererTextureUpload(pending);
+
+            pending = next;
+        }
+
+        RendererTextureUpload* complete = State.Uploads.Complete;
+
+        while (complete != NULL)
+        {
+            RendererTextureUpload* next = complete->Next;
+
+            DisposeRendererTextureUpload(complete);
+
+            complete = next;
+        }
+
+        State.Uploads.Complete = NULL;
+
+        State.Uploads.Work = NULL;
+        State.Uploads.Count = 0;
+    }
+
+    // Prepares the pending textures for the upload, until the uploads are released.
+    // NOTE: The pending task could be taken by the texture waiting for it, so the lack of the task does not stop the thread.
+    DWORD WINAPI PrepareRendererTextureUploadThread(LPVOID)
+    {
+        while (TRUE)
+        {
+            WaitForSingleObject(State.Uploads.Work, INFINITE);
+
+            EnterCriticalSection(&State.Uploads.Lock);
+
+            const BOOL active = State.Uploads.IsActive;
+
+            RendererTextureUpload* task = State.Uploads.Pending;
+
+            if (task != NULL)
+            {
+                State.Uploads.Pending = task->Next;
+
+                if (State.Uploads.Pending == NULL) { State.Uploads.Last = NULL; }
+            }
+
+            LeaveCriticalSection(&State.Uploads.Lock);
+
+            if (task == NULL)
+            {
+                if (active) { continue; }
+
+                break;
+            }
+
+            // NOTE: The worker threads already run on all of the processors, so the images are not split any further.
+            PrepareRendererTextureUpload(task, IMAGE_CONTAINER_OPTIONS_SINGLE_THREAD);
+
+            EnterCriticalSection(&State.Uploads.Lock);
+
+            task->Next = State.Uploads.Complete;
+            State.Uploads.Complete = task;
+
+            LeaveCriticalSection(&State.Uploads.Lock);
+        }
+
+        return 0;
+    }
+
+    // Prepares the staged pixels of the texture, by either compressing them into the blocks, or converting them into the format of the texture.
+    void PrepareRendererTextureUpload(RendererTextureUpload* task, const u32 options)
+    {
+        if (AcquireImageDXTBlockSize(task->Destination) != 0) { CompressRendererTexture(task); }
+        else { task->IsValid = ConvertRendererTexture(task, options); }
+    }
+
+    // Converts the pixels of all of the levels of the texture into the format of the texture, the options are added to the ones of the conversion.
+    BOOL ConvertRendererTexture(RendererTextureUpload* task, const u32 options)
+    {
+        BOOL result = TRUE;
+
+        u8* pixels = task->Pixels;
+        u8* staging = task->Staging;
+
+        for (u32 x = 0; x < task->Levels; x++)
+        {
+            const u32 width = Max(task->Width >> x, (u32)1);
+            const u32 height = Max(task->Height >> x, (u32)1);
+
+            const u32 spitch = AcquireRendererTextureLevelPitch(task->Source, width, task->PixelSize);
+            const u32 dpitch = AcquireRendererTextureLevelPitch(task->Destination, width, task->StagingPixelSize);
+
+            ImageContainer img;
+
+            InitializeImageContainer(&img);
+
+            ImageContainerArgs dsti;
+            ZeroMemory(&dsti, sizeof(ImageContainerArgs));
+
+            dsti.Format = task->Destination;
+            dsti.Pixels = staging;
+            dsti.Stride = dpitch;
+            dsti.Width = width;
+            dsti.Height = height;
+            dsti.Unk09 = 1;
+            dsti.Dimensions.Right = width;
+            dsti.Dimensions.Bottom = height;
+            dsti.Dimensions.Max = 1;
+
+            ImageContainerArgs srci;
+            ZeroMemory(&srci, sizeof(ImageContainerArgs));
+
+            srci.Format = task->Source;
+            srci.Pixels = pixels;
+            srci.Stride = spitch;
+            srci.Dimensions.Right = width;
+            srci.Dimensions.Bottom = height;
+            srci.Dimensions.Max = 1;
+            srci.Color = GRAPCHICS_COLOR_BLACK;
+
+            if (UpdateImageContainer(&img, &dsti, &srci, IMAGE_CONTAINER_OPTIONS_COLOR | options) != D3D_OK) { result = FALSE; }
+
+            ReleaseImageContainer(&img);
+
+            pixels = (u8*)((addr)pixels + (addr)(spitch * AcquireRendererTextureLevelRows(task->Source, height)));
+            staging = (u8*)((addr)staging + (addr)(dpitch * height));
+        }
+
+        return result;
+    }
+
+    // Compresses the pixels of all of the levels of the texture into the blocks.
+    void CompressRendererTexture(RendererTextureUpload* task)
+    {
+        ImagePixelCalls* calls = AcquireImagePixelCalls(task->Source);
+
+        const u32 size = AcquireImageDXTBlockSize(task->Destination);
+
+        u32 rows[IMAGE_DXT_DIMENSION * MAX_IMAGE_ROW_PIXEL_COUNT];
+
+        u8* pixels = task->Pixels;
+        u8* blocks = task->Staging;
+
+        for (u32 x = 0; x < task->Levels; x++)
+        {
+            const u32 width = Max(task->Width >> x, (u32)1);
+            const u32 height = Max(task->Height >> x, (u32)1);
+
+            const u32 count = (width + IMAGE_DXT_DIMENSION - 1) / IMAGE_DXT_DIMENSION;
+            const u32 length = count * IMAGE_DXT_DIMENSION;
+
+            for (u32 y = 0; y < height; y += IMAGE_DXT_DIMENSION)
+            {
+                for (u32 yy = 0; yy < IMAGE_DXT_DIMENSION; yy++)
+                {
+                    // NOTE: The rows and the columns past the edge of the level repeat the last ones,
+                    // so that they do not skew the end points of the blocks of the smallest levels.
+                    const u32 line = Min(y + yy, height - 1);
+
+                    u32* row = &rows[yy * length];
+
+                    calls->Read((void*)((addr)pixels + (addr)(line * width * task->PixelSize)), row, width, NULL);
+
+                    for (u32 xx = width; xx < length; xx++) { row[xx] = row[width - 1]; }
+                }
+
+                EncodeImageDXTBlocks(task->Destination, rows, length * sizeof(u32), count, blocks);
+
+                blocks = (u8*)((addr)blocks + (addr)(count * size));
+            }
+
+            pixels = (u8*)((addr)pixels + (addr)(width * height * task->PixelSize));
+        }
+    }
+
+    // Queues the copy of the pixels of all of the levels of the texture for the conversion, or the compression, on the worker threads.
+    // NOTE: The texture keeps its previous pixels until the staged ones are uploaded between the frames, or until the texture is selected.
+    BOOL SubmitRendererTextureUpload(RendererTexture* tex, const u32* pixels)
+    {
+        const D3DFORMAT source = AcquireRendererTextureFormat(tex->PixelFormat);
+        const u32 pixel = AcquireRendererDeviceFormatSize(tex->TextureFormat, RendererDeviceFormatSizeBytes);
+
+        // NOTE: The pixels hold at least the top level of the texture.
+        const u32 levels = Max(tex->MipMapCount, (u32)1);
+
+        u32 size = 0;
+        u32 length = 0;
+
+        for (u32 x = 0; x < levels; x++)
+        {
+            const u32 width = Max(tex->Width >> x, (u32)1);
+            const u32 height = Max(tex->Height >> x, (u32)1);
+
+            size = size + AcquireRendererTextureLevelPitch(source, width, tex->PixelSize) * AcquireRendererTextureLevelRows(source, height);
+            length = length + AcquireRendererTextureLevelPitch(tex->TextureFormat, width, pixel) * AcquireRendererTextureLevelRows(tex->TextureFormat, height);
+        }
+
+        u64 hash = INVALID_TEXTURE_HASH;
+
+        // NOTE: The pixels converted, or compressed, on the earlier runs are uploaded straight from the cache file.
+        if (InitializeRendererTextureCache())
+        {
+            hash = AcquireRendererTextureHash(pixels, size);
+
+            RendererTextureCacheEntry* entry =
+                AcquireRendererTextureCacheEntry(hash, source, tex->TextureFormat, tex->Width, tex->Height, levels);
+
+            if (entry != NULL && entry->Size == length)
+            {
+                CancelRendererTextureUpload(tex);
+
+                RendererTextureUpload task;
+                ZeroMemory(&task, sizeof(RendererTextureUpload));
+
+                task.Texture = tex;
+
+                task.Width = tex->Width;
+                task.Height = tex->Height;
+                task.Levels = levels;
+
+                task.Source = source;
+                task.Destination = tex->TextureFormat;
+
+                task.PixelSize = tex->PixelSize;
+                task.StagingPixelSize = pixel;
+
+                task.IsValid = TRUE;
+
+                task.Staging = (u8*)((addr)State.TextureCache.Data + (addr)entry->Offset);
+
+                return UploadRendererTextureLevels(&task);
+            }
+        }
+
+        RendererTextureUpload* task =
+            (RendererTextureUpload*)malloc(sizeof(RendererTextureUpload) + size + length);
+
+        if (task == NULL) { return FALSE; }
+
+        task->Texture = tex;
+
+        task->Width = tex->Width;
+        task->Height = tex->Height;
+        task->Levels = levels;
+
+        task->Source = source;
+        task->Destination = tex->TextureFormat;
+
+        task->PixelSize = tex->PixelSize;
+        task->StagingPixelSize = pixel;
+
+        task->IsValid = TRUE;
+
+        task->Hash = hash;
+        task->StagingSize = length;
+
+        task->Pixels = (u8*)((addr)task + (addr)sizeof(RendererTextureUpload));
+        task->Staging = (u8*)((addr)task->Pixels + (addr)size);
+
+        task->Next = NULL;
+
+        CopyMemory(task->Pixels, pixels, size);
+
+        CancelRendererTextureUpload(tex);
+
+        tex->Upload = task;
+
+        // NOTE: The texture selected into the device is rendered with before it is selected again, so it is uploaded right away.
+        if (IsRendererTextureSelected(tex) || !InitializeRendererTextureUploads())
+        {
+            PrepareRendererTextureUpload(task, IMAGE_CONTAINER_OPTIONS_NONE);
+
+            const BOOL result = UploadRendererTextureLevels(task);
+
+            StoreRendererTextureCache(task);
+
+            DisposeRendererTextureUpload(task);
+
+            return result;
+        }
+
+        EnterCriticalSection(&State.Uploads.Lock);
+
+        if (State.Uploads.Last == NULL) { State.Uploads.Pending = task; }
+        else { State.Uploads.Last->Next = task; }
+
+        State.Uploads.Last = task;
+
+        LeaveCriticalSection(&State.Uploads.Lock);
+
+        ReleaseSemaphore(State.Uploads.Work, 1, NULL);
+
+        return TRUE;
+    }
+
+    // Detaches the pending compression from the texture, its blocks are discarded once the compression completes.
+    void CancelRendererTextureUpload(RendererTexture* tex)
+    {
+        if (tex->Upload == NULL) { return; }
+
+        tex->Upload->Texture = NULL;
+        tex->Upload = NULL;
+    }
+
+    // Uploads the staged pixels of the textures, which preparation is complete.
+    void CommitRendererTextureUploads(void)
+    {
+        if (!State.Uploads.IsActive) { return; }
+
+        EnterCriticalSection(&State.Uploads.Lock);
+
+        RendererTextureUpload* task = State.Uploads.Complete;
+
+        State.Uploads.Complete = NULL;
+
+        LeaveCriticalSection(&State.Uploads.Lock);
+
+        while (task != NULL)
+        {
+            RendererTextureUpload* next = task->Next;
+
+            if (task->Texture != NULL)
+            {
+                if (!UploadRendererTextureLevels(task)) { LOGWARNING("Unable to upload staged texture.\n"); }
+            }
+
+            StoreRendererTextureCache(task);
+
+            DisposeRendererTextureUpload(task);
+
+            task = next;
+        }
+    }
+
+    // Waits for the pending upload of the texture to complete, and uploads its staged pixels.
+    // NOTE: The upload, that none of the worker threads has taken yet, is prepared on the calling thread,
+    // so that the texture does not wait for the uploads queued ahead of it.
+    void WaitRendererTextureUpload(RendererTexture* tex)
+    {
+        if (tex->Upload == NULL || !State.Uploads.IsActive) { return; }
+
+        RendererTextureUpload* task = NULL;
+
+        EnterCriticalSection(&State.Uploads.Lock);
+
+        {
+            RendererTextureUpload* previous = NULL;
+            RendererTextureUpload* current = State.Uploads.Pending;
+
+            while (current != NULL && current != tex->Upload)
+            {
+                previous = current;
+                current = current->Next;
+            }
+
+            if (current != NULL)
+            {
+                if (previous == NULL) { State.Uploads.Pending = current->Next; }
+                else { previous->Next = current->Next; }
+
+                if (State.Uploads.Last == current) { State.Uploads.Last = previous; }
+
+                task = current;
+            }
+        }
+
+        LeaveCriticalSection(&State.Uploads.Lock);
+
+        if (task != NULL)
+        {
+            PrepareRendererTextureUpload(task, IMAGE_CONTAINER_OPTIONS_NONE);
+
+            if (!UploadRendererTextureLevels(task)) { LOGWARNING("Unable to upload staged texture.\n"); }
+
+            StoreRendererTextureCache(task);
+
+            DisposeRendererTextureUpload(task);
+
+            return;
+        }
+
+        while (tex->Upload != NULL)
+        {
+            CommitRendererTextureUploads();
 
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_FILTER_STATE, (void*)RENDERER_MODULE_TEXTURE_FILTER_LENEAR);
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE_MIP_FILTER_STATE, (void*)RENDERER_MODULE_TEXTURE_MIP_FILTER_POINT);
+            if (tex->Upload != NULL) { Sleep(0); }
+        }
     }
 
-    // 0x60004b80
-    u32 SelectRendererTransforms(const f32 zNear, const f32 zFar)
+    // Copies the staged pixels of all of the levels of the texture into the texture.
+    BOOL UploadRendererTextureLevels(RendererTextureUpload* task)
     {
-        if ((zFar <= zNear) != (zFar == zNear)) { return TRUE; }
+        if (!task->IsValid) { return FALSE; }
 
-        D3DMATRIX world;
+        RendererTexture* tex = task->Texture;
 
-        world._11 = 1.0f;
-        world._12 = 0.0f;
-        world._13 = 0.0f;
-        world._14 = 0.0f;
+        u8* staging = task->Staging;
 
-        world._21 = 0.0f;
-        world._22 = 1.0f;
-        world._23 = 0.0f;
-        world._24 = 0.0f;
+        for (u32 x = 0; x < task->Levels; x++)
+        {
+            const u32 pitch = AcquireRendererTextureLevelPitch(task->Destination, Max(task->Width >> x, (u32)1), task->StagingPixelSize);
+            const u32 rows = AcquireRendererTextureLevelRows(task->Destination, Max(task->Height >> x, (u32)1));
 
-        world._31 = 0.0f;
-        world._32 = 0.0f;
-        world._33 = 1.0f;
-        world._34 = 0.0f;
+            IDirect3DSurface8* surface = NULL;
 
-        world._41 = 0.0f;
-        world._42 = 0.0f;
-        world._43 = 0.0f;
-        world._44 = 1.0f;
+            if (tex->Texture->GetSurfaceLevel(x, &surface) != D3D_OK) { return FALSE; }
 
-        D3DMATRIX view;
+            D3DLOCKED_RECT lock;
+            ZeroMemory(&lock, sizeof(D3DLOCKED_RECT));
 
-        view._11 = 1.0f;
-        view._12 = 0.0f;
-        view._13 = 0.0f;
-        view._14 = 0.0f;
+            if (surface->LockRect(&lock, NULL, D3DLOCK_NONE) != D3D_OK)
+            {
+                surface->Release();
 
-        view._21 = 0.0f;
-        view._22 = 1.0f;
-        view._23 = 0.0f;
-        view._24 = 0.0f;
+                return FALSE;
+            }
 
-        view._31 = 0.0f;
-        view._32 = 0.0f;
-        view._33 = 1.0f;
-        view._34 = 0.0f;
+            for (u32 y = 0; y < rows; y++)
+            {
+                CopyMemory((void*)((addr)lock.pBits + (addr)(y * lock.Pitch)),
+                    (void*)((addr)staging + (addr)(y * pitch)), pitch);
+            }
 
-        view._41 = 0.0f;
-        view._42 = 0.0f;
-        view._43 = 0.0f;
-        view._44 = 1.0f;
+            surface->UnlockRect();
+            surface->Release();
 
-        D3DMATRIX projection;
+            staging = (u8*)((addr)staging + (addr)(rows * pitch));
+        }
 
-        projection._11 = 1.0f;
-        projection._12 = 0.0f;
-        projection._13 = 0.0f;
-        projection._14 = 0.0f;
+        return TRUE;
+    }
 
-        projection._21 = 0.0f;
-        projection._22 = 1.0f;
-        projection._23 = 0.0f;
-        projection._24 = 0.0f;
+    // Converts the plain pixels of all of the levels of the texture straight into the texture, each of the levels is locked once for writing.
+    // The pixels in the format of the texture are copied row by row, and the rest are converted with the pixel calls of the formats.
+    // NOTE: The pixels hold at least the top level of the texture, the rows of the pixels are tightly packed.
+    BOOL UploadRendererTexturePixels(RendererTexture* tex, const u32* pixels, const D3DFORMAT format)
+    {
+        ImagePixelCalls* reader = AcquireImagePixelCalls(format);
+        ImagePixelCalls* writer = AcquireImagePixelCalls(tex->TextureFormat);
 
-        projection._31 = 0.0f;
-        projection._32 = 0.0f;
-        projection._33 = 1.0f;
-        projection._34 = 0.0f;
+        const BOOL isCopy = format == tex->TextureFormat;
 
-        projection._41 = 0.0f;
-        projection._42 = 0.0f;
-        projection._43 = 0.0f;
-        projection._44 = 1.0f;
+        const u32 levels = Max(tex->MipMapCount, (u32)1);
 
-        HRESULT result = State.DX.Device->SetTransform(D3DTS_WORLD, &world);
+        u32 colors[MAX_IMAGE_ROW_PIXEL_COUNT];
 
-        if (result == D3D_OK)
+        u8* px = (u8*)pixels;
+
+        for (u32 x = 0; x < levels; x++)
         {
-            result = State.DX.Device->SetTransform(D3DTS_VIEW, &view);
+            const u32 width = Max(tex->Width >> x, (u32)1);
+            const u32 height = Max(tex->Height >> x, (u32)1);
 
-            if (result == D3D_OK)
+            const u32 pitch = AcquireRendererTextureLevelPitch(format, width, tex->PixelSize);
+
+            D3DLOCKED_RECT lock;
+            ZeroMemory(&lock, sizeof(D3DLOCKED_RECT));
+
+            if (tex->Texture->LockRect(x, &lock, NULL, D3DLOCK_NOSYSLOCK) != D3D_OK) { return FALSE; }
+
+            for (u32 y = 0; y < height; y++)
             {
-                projection._44 = zNear;
-                projection._34 = 1.0f;
-                projection._33 = zNear / (zFar - zNear) + 1.0f;
-                projection._43 = 0.0f;
+                void* src = (void*)((addr)px + (addr)(y * pitch));
+                void* dst = (void*)((addr)lock.pBits + (addr)(y * lock.Pitch));
 
-                result = State.DX.Device->SetTransform(D3DTS_PROJECTION, &projection);
+                if (isCopy) { CopyMemory(dst, src, pitch); }
+                else
+                {
+                    reader->Read(src, colors, width, NULL);
+                    writer->Write(colors, dst, width, NULL);
+                }
             }
+
+            tex->Texture->UnlockRect(x);
+
+            px = (u8*)((addr)px + (addr)(pitch * height));
         }
 
-        return result;
+        return TRUE;
     }
 
-    // 0x60001b40
-    BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value)
+    // Releases the task of the texture upload, and detaches it from its texture.
+    void DisposeRendererTextureUpload(RendererTextureUpload* task)
     {
-        BeginRendererScene();
-
-        RenderPackets();
+        if (task->Texture != NULL) { task->Texture->Upload = NULL; }
 
-        return State.DX.Device->SetRenderState(type, value) == D3D_OK;
+        free(task);
     }
-    
-    // 0x60001c40
-    BOOL SelectRendererMaterial(const u32 color)
-    {
-        D3DMATERIAL8 material;
-        ZeroMemory(&material, sizeof(D3DMATERIAL8));
-
-        RendererClearColor = color;
 
-        const f32 red = RGBA_GETRED(color) / 255.0f;
-        const f32 green = RGBA_GETGREEN(color) / 255.0f;
-        const f32 blue = RGBA_GETBLUE(color) / 255.0f;
+    // Acquires the pitch of the level of the pixels of the format, the block compressed formats are pitched by the rows of the blocks.
+    u32 AcquireRendererTextureLevelPitch(const D3DFORMAT format, const u32 width, const u32 size)
+    {
+        const u32 block = AcquireImageDXTBlockSize(format);
 
-        material.Diffuse.r = red;
-        material.Diffuse.g = green;
-        material.Diffuse.b = blue;
+        if (block != 0) { return ((width + IMAGE_DXT_DIMENSION - 1) / IMAGE_DXT_DIMENSION) * block; }
 
-        material.Ambient.r = red;
-        material.Ambient.g = green;
-        material.Ambient.b = blue;
+        return width * size;
+    }
 
-        State.DX.Device->SetMaterial(&material);
+    // Acquires the number of the rows of the level of the pixels of the format, the block compressed formats count the rows of the blocks.
+    u32 AcquireRendererTextureLevelRows(const D3DFORMAT format, const u32 height)
+    {
+        if (AcquireImageDXTBlockSize(format) != 0) { return (height + IMAGE_DXT_DIMENSION - 1) / IMAGE_DXT_DIMENSION; }
 
-        return TRUE;
+        return height;
     }
 
-    // 0x60001b10
-    BOOL SelectRendererTextureStage(const u32 stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value)
+    // Checks whether the texture is the one selected into the device.
+    BOOL IsRendererTextureSelected(RendererTexture* tex)
     {
-        BeginRendererScene();
+        const s32 indx = AcquireTextureStateStageIndex(RENDERER_MODULE_STATE_SELECT_TEXTURE);
 
-        RenderPackets();
+        if (indx < 0) { return FALSE; }
 
-        return State.DX.Device->SetTextureStageState(stage, type, value) == D3D_OK;
+        return State.Textures.StageStates[indx].Values[MAKETEXTURESTAGEVALUE(RENDERER_MODULE_STATE_SELECT_TEXTURE)] == (s32)tex;
     }
 
-    // 0x600076f0
-    void SelectRendererFogAlphas(const u8* input, u8* output)
+    // Packs the small texture into the atlas of its format, instead of the device texture of its own.
+    // The pixels of the texture are converted straight into the rectangle of the texture within the atlas on upload.
+    BOOL PackRendererTexture(RendererTexture* tex)
     {
-        if (input == NULL || output == NULL) { return; }
+        if (SettingsState.TextureAtlas < tex->Width || SettingsState.TextureAtlas < tex->Height) { return FALSE; }
 
-        for (u32 x = 0; x < MAX_INPUT_FOG_ALPHA_COUNT; x++)
+        if (tex->MipMapCount != 0 || tex->Stage != RENDERER_TEXTURE_STAGE_0
+            || tex->PaletteMode == RENDERER_MODULE_PALETTE_ACQUIRE || tex->IsCompressed) { return FALSE; }
+
+        if (tex->TextureFormat == D3DFMT_P8 || tex->TextureFormat == D3DFMT_A8P8 || AcquireImageDXTBlockSize(tex->TextureFormat) != 0
+            || AcquireRendererDeviceFormatSize(tex->TextureFormat, RendererDeviceFormatSizeBytes) == 0) { return FALSE; }
+
+        const u32 width = tex->Width + 2 * TEXTURE_ATLAS_BORDER_SIZE;
+        const u32 height = tex->Height + 2 * TEXTURE_ATLAS_BORDER_SIZE;
+
+        if (MAX_TEXTURE_ATLAS_DIMENSION < width || MAX_TEXTURE_ATLAS_DIMENSION < height) { return FALSE; }
+
+        RendererTextureAtlas* atlas = NULL;
+        RendererTextureAtlas* available = NULL;
+
+        for (u32 x = 0; x < MAX_TEXTURE_ATLAS_COUNT; x++)
         {
-            u8 current = input[x];
-            u8 next = input[Clamp<u32>(x + 1, 0, MAX_INPUT_FOG_ALPHA_COUNT - 1)];
+            RendererTextureAtlas* a = &State.Textures.Atlases.Atlases[x];
 
-            output[x * 4 + 0] = current;
-            output[x * 4 + 1] = (u8)((s32)current + (s32)(0.33f * (next - current)));
-            output[x * 4 + 2] = (u8)((s32)current + (s32)(0.67f * (next - current)));
-            output[x * 4 + 3] = next;
+            if (a->Texture == NULL)
+            {
+                if (available == NULL) { available = a; }
+
+                continue;
+            }
+
+            if (a->Format == tex->TextureFormat && AcquireRendererTextureAtlasPosition(a, width, height, &tex->AtlasX, &tex->AtlasY)) { atlas = a; break; }
+        }
+
+        if (atlas == NULL)
+        {
+            if (available == NULL || !InitializeRendererTextureAtlas(available, tex->TextureFormat)) { return FALSE; }
+
+            atlas = available;
+
+            AcquireRendererTextureAtlasPosition(atlas, width, height, &tex->AtlasX, &tex->AtlasY);
         }
+
+        atlas->Texture->AddRef();
+        atlas->Count = atlas->Count + 1;
+
+        tex->Texture = atlas->Texture;
+        tex->MemoryType = RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY;
+
+        tex->Atlas = atlas;
+
+        return TRUE;
     }
 
-    // 0x60002f30
-    BOOL RestoreRendererSurfaces(void)
+    // Acquires the position of the rectangle of the dimensions, including the border, within the row of the atlas,
+    // a new row is started below the current one when the rectangle does not fit into it.
+    BOOL AcquireRendererTextureAtlasPosition(RendererTextureAtlas* atlas, const u32 width, const u32 height, u32* x, u32* y)
     {
-        for (u32 x = 0; x < 4; x++)
+        if (MAX_TEXTURE_ATLAS_DIMENSION < atlas->X + width)
         {
-            const HRESULT result = State.DX.Device->TestCooperativeLevel();
+            atlas->X = 0;
+            atlas->Y = atlas->Y + atlas->Height;
+            atlas->Height = 0;
+        }
 
-            if (result == D3DERR_DEVICENOTRESET || result == D3D_OK) { return TRUE; }
+        if (MAX_TEXTURE_ATLAS_DIMENSION < atlas->Y + height) { return FALSE; }
 
-            Sleep(100);
-        }
+        *x = atlas->X + TEXTURE_ATLAS_BORDER_SIZE;
+        *y = atlas->Y + TEXTURE_ATLAS_BORDER_SIZE;
 
-        return FALSE;
+        atlas->X = atlas->X + width;
+        atlas->Height = Max(atlas->Height, height);
+
+        return TRUE;
     }
 
-    // 0x60001910
-    void ModifyRendererSurface(IDirect3DSurface8* surface, const u32 count)
+    // Creates the device texture of the atlas of the format, and clears it.
+    BOOL InitializeRendererTextureAtlas(RendererTextureAtlas* atlas, const D3DFORMAT format)
     {
-        if (surface == NULL) { return; }
+        IDirect3DTexture8* texture = NULL;
 
-        u32 actual = surface->AddRef() - 1;
+        if (State.DX.Device->CreateTexture(MAX_TEXTURE_ATLAS_DIMENSION, MAX_TEXTURE_ATLAS_DIMENSION,
+            1, D3DUSAGE_NONE, format, D3DPOOL_MANAGED, &texture) != D3D_OK) { return FALSE; }
 
-        surface->Release();
+        D3DLOCKED_RECT lock;
+        ZeroMemory(&lock, sizeof(D3DLOCKED_RECT));
 
-        if (actual != count)
+        if (texture->LockRect(0, &lock, NULL, D3DLOCK_NONE) == D3D_OK)
         {
-            while (actual < count) { actual = surface->AddRef(); }
-            while (count < actual) { actual = surface->Release(); }
+            ZeroMemory(lock.pBits, lock.Pitch * MAX_TEXTURE_ATLAS_DIMENSION);
+
+            texture->UnlockRect(0);
         }
+
+        atlas->Texture = texture;
+        atlas->Format = format;
+        atlas->Count = 0;
+        atlas->X = 0;
+        atlas->Y = 0;
+        atlas->Height = 0;
+
+        return TRUE;
     }
 
-    // 0x60001d00
-    u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1, const BOOL window)
+    // Moves the packed texture out of its atlas into the device texture of its own, the texture is never packed again.
+    BOOL UnpackRendererTexture(RendererTexture* tex)
     {
-        D3DRECT rect;
+        if (tex->Atlas == NULL) { return TRUE; }
 
-        DWORD options = (window == FALSE); // D3DCLEAR_TARGET
+        IDirect3DTexture8* texture = tex->Texture;
 
-        if (State.Device.Capabilities.IsDepthAvailable && State.DX.Surfaces.Bits != 0)
-        {
-            DWORD state = D3DZB_FALSE;
+        RenderPackets();
 
-            State.DX.Device->GetRenderState(D3DRS_ZENABLE, &state);
+        tex->Texture = NULL;
 
-            if (state != D3DZB_FALSE) { options = options | D3DCLEAR_ZBUFFER; }
+        if (InitializeRendererTexture(tex) != D3D_OK)
+        {
+            tex->Texture = texture;
+
+            return FALSE;
         }
 
-        if (State.Device.Capabilities.IsStencilBufferAvailable) { options = options | D3DCLEAR_STENCIL; }
+        RECT rect;
 
-        if (x1 == 0)
+        rect.left = tex->AtlasX;
+        rect.right = tex->AtlasX + tex->Width;
+        rect.top = tex->AtlasY;
+        rect.bottom = tex->AtlasY + tex->Height;
+
+        D3DLOCKED_RECT src;
+        ZeroMemory(&src, sizeof(D3DLOCKED_RECT));
+
+        D3DLOCKED_RECT dst;
+        ZeroMemory(&dst, sizeof(D3DLOCKED_RECT));
+
+        if (texture->LockRect(0, &src, &rect, D3DLOCK_READONLY) != D3D_OK)
         {
-            rect.x1 = 0;
-            rect.y1 = 0;
-            rect.x2 = State.DX.Surfaces.Width;
-            rect.y2 = State.DX.Surfaces.Height;
+            tex->Texture->Release();
+            tex->Texture = texture;
+
+            return FALSE;
         }
-        else
+
+        if (tex->Texture->LockRect(0, &dst, NULL, D3DLOCK_NONE) != D3D_OK)
         {
-            rect.x1 = x0;
-            rect.x2 = x0 + x1;
-            rect.y1 = y0;
-            rect.y2 = y0 + y1;
+            texture->UnlockRect(0);
+
+            tex->Texture->Release();
+            tex->Texture = texture;
+
+            return FALSE;
+        }
+
+        const u32 length = tex->Width * AcquireRendererDeviceFormatSize(tex->TextureFormat, RendererDeviceFormatSizeBytes);
+
+        for (u32 y = 0; y < tex->Height; y++)
+        {
+            CopyMemory((void*)((addr)dst.pBits + (addr)(y * dst.Pitch)),
+                (void*)((addr)src.pBits + (addr)(y * src.Pitch)), length);
         }
 
-        return State.DX.Device->Clear(1, &rect, options, RendererClearColor, RendererClearDepth, 0) == D3D_OK;
+        tex->Texture->UnlockRect(0);
+        texture->UnlockRect(0);
+
+        texture->Release();
+
+        ReleaseRendererTextureAtlas(tex);
+
+        return TRUE;
     }
 
-    // 0x60001b70
-    u32 ToggleRenderer(void)
+    // Converts the pixels of the rectangle of the packed texture into the atlas,
+    // and repeats the edges of the texture into the borders, so the filtering never samples the neighbouring textures of the atlas.
+    BOOL UploadRendererTextureAtlas(RendererTexture* tex, const u32* pixels, const D3DFORMAT format, const u32 pitch, const D3DRECT* rect)
     {
-        if (State.DX.Device->TestCooperativeLevel() != D3D_OK)
+        IDirect3DSurface8* surface = NULL;
+
+        if (tex->Texture->GetSurfaceLevel(0, &surface) != D3D_OK) { return FALSE; }
+
+        D3DRECT dst;
+
+        dst.x1 = tex->AtlasX + rect->x1;
+        dst.x2 = tex->AtlasX + rect->x2;
+        dst.y1 = tex->AtlasY + rect->y1;
+        dst.y2 = tex->AtlasY + rect->y2;
+
+        D3DRECT src;
+
+        src.x1 = 0;
+        src.x2 = rect->x2 - rect->x1;
+        src.y1 = 0;
+        src.y2 = rect->y2 - rect->y1;
+
+        if (UpdateRendererTextureLevel(surface, NULL, &dst, pixels, format, pitch,
+            NULL, &src, IMAGE_CONTAINER_OPTIONS_COLOR, GRAPCHICS_COLOR_BLACK) != D3D_OK)
         {
-            if (RendererToggleState)
-            {
-                if (State.Lambdas.ToggleRenderer != NULL) { State.Lambdas.ToggleRenderer(FALSE); }
+            surface->Release();
 
-                RendererToggleState = FALSE;
-            }
+            return FALSE;
+        }
 
-            while (TRUE)
-            {
-                if (State.DX.Device->TestCooperativeLevel() == D3DERR_DEVICENOTRESET)
-                {
-                    ReleaseRendererObjects();
+        RECT area;
 
-                    if (State.DX.Device->Reset(&State.Device.Presentation) == D3D_OK)
-                    {
-                        if (State.Lambdas.ToggleRenderer != NULL) { State.Lambdas.ToggleRenderer(TRUE); }
-                    }
+        area.left = tex->AtlasX - TEXTURE_ATLAS_BORDER_SIZE;
+        area.right = tex->AtlasX + tex->Width + TEXTURE_ATLAS_BORDER_SIZE;
+        area.top = tex->AtlasY - TEXTURE_ATLAS_BORDER_SIZE;
+        area.bottom = tex->AtlasY + tex->Height + TEXTURE_ATLAS_BORDER_SIZE;
 
-                    RendererToggleState = TRUE;
+        D3DLOCKED_RECT lock;
+        ZeroMemory(&lock, sizeof(D3DLOCKED_RECT));
 
-                    return RENDERER_MODULE_SUCCESS;
-                }
+        if (surface->LockRect(&lock, &area, D3DLOCK_NONE) != D3D_OK)
+        {
+            surface->Release();
 
-                if (State.Lambdas.ToggleRendererWait != NULL) { State.Lambdas.ToggleRendererWait(State.Lambdas.ToggleRendererWaitContext); }
+            return FALSE;
+        }
+
+        const u32 size = AcquireRendererDeviceFormatSize(tex->TextureFormat, RendererDeviceFormatSizeBytes);
+        const u32 length = tex->Width * size;
+
+        // NOTE: The rows of the borders above, and below, the texture repeat its first, and last, rows.
+        const addr first = (addr)lock.pBits + (addr)(TEXTURE_ATLAS_BORDER_SIZE * lock.Pitch + TEXTURE_ATLAS_BORDER_SIZE * size);
+        const addr last = first + (addr)((tex->Height - 1) * lock.Pitch);
+
+        for (u32 x = 0; x < TEXTURE_ATLAS_BORDER_SIZE; x++)
+        {
+            CopyMemory((void*)((addr)lock.pBits + (addr)(x * lock.Pitch + TEXTURE_ATLAS_BORDER_SIZE * size)), (void*)first, length);
+            CopyMemory((void*)(last + (addr)((x + 1) * lock.Pitch)), (void*)last, length);
+        }
+
+        // NOTE: The columns of the borders to the left, and to the right, of the texture repeat its first, and last, columns,
+        // including the rows of the borders, so that the corners repeat the corner pixels of the texture.
+        for (u32 y = 0; y < tex->Height + 2 * TEXTURE_ATLAS_BORDER_SIZE; y++)
+        {
+            const addr row = (addr)lock.pBits + (addr)(y * lock.Pitch);
 
-                Sleep(10);
+            for (u32 x = 0; x < TEXTURE_ATLAS_BORDER_SIZE; x++)
+            {
+                CopyMemory((void*)(row + (addr)(x * size)), (void*)(row + (addr)(TEXTURE_ATLAS_BORDER_SIZE * size)), size);
+                CopyMemory((void*)(row + (addr)((TEXTURE_ATLAS_BORDER_SIZE + tex->Width + x) * size)),
+                    (void*)(row + (addr)((TEXTURE_ATLAS_BORDER_SIZE + tex->Width - 1) * size)), size);
             }
         }
 
-        State.DX.Device->Present(NULL, NULL, State.Window.HWND, NULL);
+        surface->UnlockRect();
+        surface->Release();
 
-        return RENDERER_MODULE_SUCCESS;
+        return TRUE;
     }
 
-    // 0x60007af0
-    RendererTexture* AllocateRendererTexture(void)
+    // Selects the transform of the texture coordinates of the packed texture selected into the first stage, or NULL.
+    // NOTE: The vertexes are transformed as they are copied into the vertex buffer, so the vertexes already appended keep their transform.
+    void SelectRendererTextureAtlas(RendererTexture* tex)
     {
-        return AllocateRendererTexture(sizeof(RendererTexture));
-    }
+        State.Textures.Atlases.Current = tex;
 
-    // 0x600087c0
-    RendererTexture* AllocateRendererTexture(const u32 size)
-    {
-        if (State.Lambdas.AllocateMemory != NULL)
+        if (tex != NULL)
         {
-            return (RendererTexture*)State.Lambdas.AllocateMemory(size);
+            State.Textures.Atlases.Offset.X = (f32)tex->AtlasX / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
+            State.Textures.Atlases.Offset.Y = (f32)tex->AtlasY / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
+            State.Textures.Atlases.Scale.X = (f32)tex->Width / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
+            State.Textures.Atlases.Scale.Y = (f32)tex->Height / (f32)MAX_TEXTURE_ATLAS_DIMENSION;
         }
 
-        return (RendererTexture*)malloc(size);
+        SelectRendererVertexTransforms();
     }
 
-    // 0x60007e60
-    HRESULT InitializeRendererTexture(RendererTexture* tex)
+    // Checks whether the first stage clamps the texture coordinates, the packed textures are only sampled with the clamping.
+    BOOL IsRendererTextureAtlasClamped(void)
     {
-        const HRESULT result = State.DX.Device->CreateTexture(tex->Width, tex->Height,
-            tex->MipMapCount + 1, D3DUSAGE_NONE, tex->TextureFormat, D3DPOOL_MANAGED, &tex->Texture);
+        return State.Textures.Atlases.AddressU == D3DTADDRESS_CLAMP && State.Textures.Atlases.AddressV == D3DTADDRESS_CLAMP;
+    }
 
-        if (result == D3D_OK) { tex->MemoryType = RENDERER_MODULE_TEXTURE_LOCATION_NON_LOCAL_VIDEO_MEMORY; }
+    // Removes the texture from its atlas, the atlas is packed again from the start once its last texture is removed.
+    // NOTE: The reference of the texture to the device texture of the atlas is released by the caller.
+    void ReleaseRendererTextureAtlas(RendererTexture* tex)
+    {
+        if (State.Textures.Atlases.Current == tex) { SelectRendererTextureAtlas(NULL); }
 
-        return result;
+        RendererTextureAtlas* atlas = tex->Atlas;
+
+        if (atlas == NULL) { return; }
+
+        tex->Atlas = NULL;
+
+        atlas->Count = atlas->Count - 1;
+
+        if (atlas->Count == 0)
+        {
+            atlas->X = 0;
+            atlas->Y = 0;
+            atlas->Height = 0;
+        }
     }
 
-    // 0x600092b0
-    u32 AcquireTexturePalette()
+    // Releases the device textures of the atlases, along with the references of the textures packed into them.
+    void ReleaseRendererTextureAtlases(void)
     {
-        if (IsTexturePaletteInactive)
+        SelectRendererTextureAtlas(NULL);
+
+        for (u32 x = 0; x < MAX_TEXTURE_ATLAS_COUNT; x++)
         {
-            InitializeTexturePalette();
+            RendererTextureAtlas* atlas = &State.Textures.Atlases.Atlases[x];
 
-            IsTexturePaletteInactive = FALSE;
+            if (atlas->Texture != NULL)
+            {
+                while (atlas->Texture->Release() != D3D_OK) {}
+            }
+
+            ZeroMemory(atlas, sizeof(RendererTextureAtlas));
         }
+    }
 
-        if (TexturePaletteValues[0] == 0) { return U32_MAX; }
+    // Calculates the 64-bit hash of the data, the hash is never equal to INVALID_TEXTURE_HASH.
+    // NOTE: The data is consumed as four interleaved lanes of 32-bit words, so the hashing of the large textures is memory bound.
+    u64 AcquireRendererTextureHash(const void* data, const u32 size)
+    {
+        const u8* bytes = (u8*)data;
 
-        u32 i = 0;
-        u32 bits = 1;
-        u32 value = 0;
-        u32 indx = 1;
-        u32 iteration = 9;
+        u32 h1 = TEXTURE_HASH_PRIME_5 + size;
+        u32 h2 = TEXTURE_HASH_PRIME_4 ^ size;
 
-        while (TRUE)
+        if (16 <= size)
         {
-            i = (value - 1) + indx;
+            u32 v1 = TEXTURE_HASH_PRIME_1 + TEXTURE_HASH_PRIME_2;
+            u32 v2 = TEXTURE_HASH_PRIME_2;
+            u32 v3 = 0;
+            u32 v4 = 0 - TEXTURE_HASH_PRIME_1;
 
-            for (u32 x = value; x < indx; x = x + 1)
+            const u32 count = size >> 4;
+
+            for (u32 x = 0; x < count; x++)
             {
-                if (TexturePaletteValues[i] != 0)
-                {
-                    TexturePaletteValues[i] = TexturePaletteValues[i] - 1;
+                const u32* values = (u32*)((addr)bytes + (addr)(x << 4));
 
-                    value = x * 2;
+                v1 = ROTATE_LEFT(v1 + values[0] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v2 = ROTATE_LEFT(v2 + values[1] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v3 = ROTATE_LEFT(v3 + values[2] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+                v4 = ROTATE_LEFT(v4 + values[3] * TEXTURE_HASH_PRIME_2, 13) * TEXTURE_HASH_PRIME_1;
+            }
 
-                    break;
-                }
+            h1 = h1 + ROTATE_LEFT(v1, 1) + ROTATE_LEFT(v2, 7) + ROTATE_LEFT(v3, 12) + ROTATE_LEFT(v4, 18);
+            h2 = h2 + (v1 ^ ROTATE_LEFT(v3, 16)) * TEXTURE_HASH_PRIME_3 + (v2 ^ ROTATE_LEFT(v4, 16)) * TEXTURE_HASH_PRIME_1;
 
-                i = i + 1;
-            }
+            bytes = (u8*)((addr)bytes + (addr)(count << 4));
+        }
 
-            indx = indx << 1;
-            iteration = iteration - 1;
+        const u32 remainder = size & 15;
 
-            if (iteration == 0)
-            {
-                if (TexturePaletteIndexes[value] == 0) { value = value + 1; }
+        for (u32 x = 0; x < (remainder >> 2); x++)
+        {
+            const u32 value = ((u32*)bytes)[x];
 
-                indx = 0;
+            h1 = ROTATE_LEFT(h1 + value * TEXTURE_HASH_PRIME_3, 17) * TEXTURE_HASH_PRIME_4;
+            h2 = ROTATE_LEFT(h2 ^ (value * TEXTURE_HASH_PRIME_2), 15) * TEXTURE_HASH_PRIME_1;
+        }
 
-                do
-                {
-                    if ((bits & TexturePaletteIndexes[value]) != 0)
-                    {
-                        TexturePaletteIndexes[value] = ~bits & TexturePaletteIndexes[value];
+        for (u32 x = remainder & (~3); x < remainder; x++)
+        {
+            h1 = ROTATE_LEFT(h1 + bytes[x] * TEXTURE_HASH_PRIME_5, 11) * TEXTURE_HASH_PRIME_1;
+            h2 = (h2 ^ bytes[x]) * TEXTURE_HASH_PRIME_3;
+        }
 
-                        return value * 0x20 + indx;
-                    }
+        h1 = h1 ^ (h1 >> 15);
+        h1 = h1 * TEXTURE_HASH_PRIME_2;
+        h1 = h1 ^ (h1 >> 13);
+        h1 = h1 * TEXTURE_HASH_PRIME_3;
+        h1 = h1 ^ (h1 >> 16);
 
-                    bits = bits << 1;
-                    indx = indx + 1;
-                } while (indx < 0x20);
+        h2 = h2 + h1;
 
-                return value * 0x20 + indx;
-            }
-        }
+        h2 = h2 ^ (h2 >> 15);
+        h2 = h2 * TEXTURE_HASH_PRIME_2;
+        h2 = h2 ^ (h2 >> 13);
+        h2 = h2 * TEXTURE_HASH_PRIME_3;
+        h2 = h2 ^ (h2 >> 16);
+
+        const u64 result = ((u64)h1 << 32) | (u64)h2;
+
+        return result == INVALID_TEXTURE_HASH ? (INVALID_TEXTURE_HASH + 1) : result;
     }
 
-    // 0x60009210
-    void InitializeTexturePalette(void)
+    // Opens the cache file of the converted textures, and maps it into the memory, unless it is already open.
+    // NOTE: The cache file is reset when it is created by a different version, or with a different capacity,
+    // as well as when it was not closed cleanly, or any of its entries lies outside of its data.
+    BOOL InitializeRendererTextureCache(void)
     {
-        u32 bits = 1;
-        u32 value = 0x4000; // TODO
+        if (State.TextureCache.IsActive) { return TRUE; }
+        if (State.TextureCache.IsInvalid || !SettingsState.TextureCache || SettingsState.TextureCacheSize == 0) { return FALSE; }
 
-        u32* values = TexturePaletteValues;
+        // NOTE: The cache is attempted only once, regardless of the result.
+        State.TextureCache.IsInvalid = TRUE;
 
-        for (u32 x = 9; x != 0; x--) // TODO
+        const u32 capacity = Min(SettingsState.TextureCacheSize, (u32)MAX_TEXTURE_CACHE_SIZE) * 1024 * 1024;
+        const u32 size = sizeof(RendererTextureCacheHeader) + capacity;
+
+        State.TextureCache.File = CreateFileA(TEXTURE_CACHE_FILE_NAME,
+            GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        if (State.TextureCache.File == INVALID_HANDLE_VALUE)
         {
-            if (bits != 0)
-            {
-                for (u32 xx = bits; xx != 0; xx--)
-                {
-                    values[xx] = value;
-                }
+            State.TextureCache.File = NULL;
 
-                values = (u32*)((addr)values + (addr)bits);
-            }
+            LOGWARNING("Unable to open texture cache file %s.\n", TEXTURE_CACHE_FILE_NAME);
 
-            value = value >> 1;
-            bits = bits << 1;
+            return FALSE;
         }
 
-        for (u32 x = 0; x < MAX_TEXTURE_PALETTE_INDEX_COUNT; x++)
+        State.TextureCache.Mapping = CreateFileMappingA(State.TextureCache.File, NULL, PAGE_READWRITE, 0, size, NULL);
+
+        if (State.TextureCache.Mapping != NULL)
         {
-            TexturePaletteIndexes[x] = U32_MAX;
+            State.TextureCache.Header = (RendererTextureCacheHeader*)MapViewOfFile(State.TextureCache.Mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
         }
-    }
 
-    // 0x60009250
-    void ReleaseTexturePalette(const s32 palette)
-    {
-        u32 bits = 1;
-        u32 value = 0x4000; // TODO
+        if (State.TextureCache.Header == NULL)
+        {
+            ReleaseRendererTextureCache();
+
+            LOGWARNING("Unable to map texture cache file %s.\n", TEXTURE_CACHE_FILE_NAME);
+
+            return FALSE;
+        }
+
+        RendererTextureCacheHeader* header = State.TextureCache.Header;
 
-        for (u32 x = 9; x != 0; x--) // TODO
+        const u32 state = AcquireRendererTextureCacheState(header, capacity);
+
+        if (state != TEXTURE_CACHE_STATE_VALID)
         {
-            value = value >> 1;
-            const u32 indx = (palette / value - 1) + bits;
-            bits = bits << 1;
+            if (state == TEXTURE_CACHE_STATE_DIRTY || state == TEXTURE_CACHE_STATE_INVALID_ENTRY)
+            {
+                LOGWARNING("Texture cache file %s is damaged, resetting it.\n", TEXTURE_CACHE_FILE_NAME);
+            }
 
-            TexturePaletteValues[indx] = TexturePaletteValues[indx] + 1;
+            InitializeRendererTextureCacheHeader(header, capacity);
         }
 
-        TexturePaletteIndexes[palette / value] = TexturePaletteIndexes[palette / value] | 1 << ((byte)palette & 0x1f);
-    }
+        // NOTE: The cache file stays dirty while it is in use, so that it is reset after a crash.
+        header->IsDirty = TRUE;
 
-    // 0x600090d0
-    void InitializeRenderState55(void)
-    {
-        SelectBasicRendererState(RENDERER_MODULE_STATE_55, (void*)(DAT_6001eedc + 1));
-        SelectState(RENDERER_MODULE_STATE_SELECT_TEXTURE, NULL);
-    }
+        FlushViewOfFile(header, sizeof(RendererTextureCacheHeader));
 
-    // 0x600087e0
-    u32 DisposeRendererTexture(RendererTexture* tex)
-    {
-        if (State.Lambdas.ReleaseMemory != NULL) { return State.Lambdas.ReleaseMemory(tex); }
+        State.TextureCache.Data = (u8*)((addr)header + (addr)sizeof(RendererTextureCacheHeader));
 
-        free(tex);
+        State.TextureCache.IsActive = TRUE;
+        State.TextureCache.IsInvalid = FALSE;
 
-        return RENDERER_MODULE_SUCCESS;
+        return TRUE;
     }
 
-    // 0x60007b00
-    BOOL UpdateRendererTexture(RendererTexture* tex, const u32* pixels, const u32* palette)
+    // Marks the cache file of the converted textures clean, then unmaps and closes it.
+    void ReleaseRendererTextureCache(void)
     {
-        if (tex == NULL) { return FALSE; }
-        if (pixels == NULL && palette == NULL) { return FALSE; }
-
-        if (palette != NULL)
+        if (State.TextureCache.Header != NULL)
         {
-            if (!UpdateRendererTexturePalette(tex, palette)) { return FALSE; }
-        }
+            // NOTE: The data is written out before the cache file is marked clean.
+            FlushViewOfFile(State.TextureCache.Header, 0);
 
-        if (pixels == NULL) { return TRUE; }
+            State.TextureCache.Header->IsDirty = FALSE;
 
-        u32* px = (u32*)pixels;
+            FlushViewOfFile(State.TextureCache.Header, sizeof(RendererTextureCacheHeader));
 
-        if (tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT1 || tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT3)
-        {
-            const u8 v0 = (*(u8*)((addr)px + (addr)0));
-            const u8 v1 = (*(u8*)((addr)px + (addr)1));
+            UnmapViewOfFile(State.TextureCache.Header);
 
-            if ((v0 == 24 && v1 == 251) || (v0 == 26 && v1 == 251))
-            {
-                px = (u32*)((addr)px + (addr)(2 * sizeof(u32)));
-            }
+            State.TextureCache.Header = NULL;
         }
 
-        for (u32 x = 0; x < tex->MipMapCount; x++)
+        if (State.TextureCache.Mapping != NULL)
         {
-            IDirect3DSurface8* surface = NULL;
-            tex->Texture->GetSurfaceLevel(x, &surface);
+            CloseHandle(State.TextureCache.Mapping);
 
-            D3DSURFACE_DESC desc;
-            ZeroMemory(&desc, sizeof(D3DSURFACE_DESC));
+            State.TextureCache.Mapping = NULL;
+        }
 
-            surface->GetDesc(&desc);
+        if (State.TextureCache.File != NULL)
+        {
+            CloseHandle(State.TextureCache.File);
 
-            D3DLOCKED_RECT lock;
-            ZeroMemory(&lock, sizeof(D3DLOCKED_RECT));
+            State.TextureCache.File = NULL;
+        }
 
-            surface->LockRect(&lock, NULL, D3DLOCK_NOSYSLOCK | D3DLOCK_READONLY);
-            surface->UnlockRect();
+        State.TextureCache.Data = NULL;
 
-            D3DRECT rect;
+        State.TextureCache.IsActive = FALSE;
+    }
 
-            rect.x1 = 0;
-            rect.x2 = desc.Width;
+    // Acquires the cache entry of the converted pixels, and marks it as the most recently used one.
+    RendererTextureCacheEntry* AcquireRendererTextureCacheEntry(const u64 hash, const D3DFORMAT source, const D3DFORMAT destination, const u32 width, const u32 height, const u32 levels)
+    {
+        RendererTextureCacheHeader* header = State.TextureCache.Header;
 
-            rect.y1 = 0;
-            rect.y2 = desc.Height;
+        for (u32 x = 0; x < header->Count; x++)
+        {
+            RendererTextureCacheEntry* entry = &header->Entries[x];
 
-            if (UpdateRendererTextureLevel(surface, NULL, &rect, px, tex->TextureFormat, lock.Pitch,
-                NULL, &rect, IMAGE_CONTAINER_OPTIONS_COLOR, GRAPCHICS_COLOR_BLACK) != D3D_OK)
-            {
-                surface->Release();
+            if (entry->Hash != hash || entry->Source != source || entry->Destination != destination
+                || entry->Width != width || entry->Height != height || entry->Levels != levels) { continue; }
 
-                return FALSE;
-            }
+            header->Tick = header->Tick + 1;
 
-            surface->Release();
+            entry->Tick = header->Tick;
 
-            px = (u32*)((addr)px + (addr)(lock.Pitch * desc.Height));
+            return entry;
         }
 
-        return TRUE;
+        return NULL;
     }
 
-    // 0x60009140
-    BOOL UpdateRendererTexturePalette(RendererTexture* tex, const u32* palette)
+    // Stores the converted pixels of the prepared texture upload into the cache file.
+    void StoreRendererTextureCache(RendererTextureUpload* task)
     {
-        if (tex == NULL || palette == NULL) { return FALSE; }
-        if (RendererTextureFormatStates[2] != 1) { return FALSE; } // TODO
-        if (tex->PaletteMode != RENDERER_MODULE_PALETTE_ACQUIRE) { return FALSE; }
+        if (!State.TextureCache.IsActive || !task->IsValid || task->Hash == INVALID_TEXTURE_HASH) { return; }
 
-        if (tex->Palette != INVALID_TEXTURE_PALETTE_VALUE)
-        {
-            PALETTEENTRY entries[MAX_TEXTURE_PALETTE_COLOR_COUNT];
+        RendererTextureCacheHeader* header = State.TextureCache.Header;
 
-            for (u32 x = 0; x < MAX_TEXTURE_PALETTE_COLOR_COUNT; x++)
-            {
-                entries[x].peRed = (palette[x] >> 16) & 0xff;
-                entries[x].peGreen = (palette[x] >> 8) & 0xff;
-                entries[x].peBlue = (palette[x] >> 0) & 0xff;
-                entries[x].peFlags = (palette[x] >> 24) & 0xff;
-            }
+        if (header->Capacity < task->StagingSize) { return; }
 
-            if (State.DX.Device->SetPaletteEntries(tex->Palette, entries) != D3D_OK) { return FALSE; }
+        if (AcquireRendererTextureCacheEntry(task->Hash,
+            task->Source, task->Destination, task->Width, task->Height, task->Levels) != NULL) { return; }
 
-            return State.DX.Device->SetCurrentTexturePalette(tex->Palette) == D3D_OK;
-        }
+        if (MAX_TEXTURE_CACHE_ENTRY_COUNT <= header->Count
+            || header->Capacity < header->Size + task->StagingSize) { TrimRendererTextureCache(task->StagingSize); }
 
-        return FALSE;
-    }
+        RendererTextureCacheEntry* entry = &header->Entries[header->Count];
 
-    // 0x60007c90
-    BOOL UpdateRendererTextureRectangle(RendererTexture* tex, const u32* pixels, const u32* palette, const s32 x, const s32 y, const s32 width, const s32 height, const s32 size, const s32 level)
-    {
-        if (tex == NULL) { return FALSE; }
-        if (pixels == NULL && palette == NULL) { return FALSE; }
+        CopyMemory((void*)((addr)State.TextureCache.Data + (addr)header->Size), task->Staging, task->StagingSize);
 
-        if (-1 < x && -1 < y && 0 < width && 0 < height && 0 < size && -1 < level)
-        {
-            if (palette == NULL || UpdateRendererTexturePalette(tex, palette))
-            {
-                if (pixels == NULL) { return TRUE; }
+        header->Tick = header->Tick + 1;
 
-                IDirect3DSurface8* surface = NULL;
-                tex->Texture->GetSurfaceLevel(level, &surface);
+        entry->Source = task->Source;
+        entry->Destination = task->Destination;
 
-                D3DSURFACE_DESC desc;
-                ZeroMemory(&desc, sizeof(D3DSURFACE_DESC));
+        entry->Width = task->Width;
+        entry->Height = task->Height;
+        entry->Levels = task->Levels;
 
-                surface->GetDesc(&desc);
+        entry->Offset = header->Size;
+        entry->Size = task->StagingSize;
 
-                D3DRECT dst;
+        entry->Tick = header->Tick;
 
-                dst.x1 = x;
-                dst.x2 = x + width;
-                dst.y1 = y;
-                dst.y2 = height + y;
+        // NOTE: The hash is written last, so that the entry is never matched before its pixels are complete.
+        entry->Hash = task->Hash;
 
-                D3DRECT src;
+        header->Size = header->Size + task->StagingSize;
+        header->Count = header->Count + 1;
+    }
 
-                src.x1 = 0;
-                src.x2 = width;
-                src.y1 = 0;
-                src.y2 = height;
+    // Removes the least recently used entries from the cache file, until the entry of the size fits,
+    // and moves the pixels of the remaining entries together to the start of the data.
+    void TrimRendererTextureCache(const u32 size)
+    {
+        RendererTextureCacheHeader* header = State.TextureCache.Header;
 
-                if (dst.x2 <= desc.Width && dst.y2 <= desc.Height)
-                {
-                    u32* px = (u32*)pixels;
+        u32 used = header->Size;
 
-                    if (tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT1 || tex->PixelFormat == RENDERER_PIXEL_FORMAT_DXT3)
-                    {
-                        const u8 v0 = (*(u8*)((addr)px + (addr)0));
-                        const u8 v1 = (*(u8*)((addr)px + (addr)1));
+        while (header->Count != 0 && (MAX_TEXTURE_CACHE_ENTRY_COUNT <= header->Count || header->Capacity < used + size))
+        {
+            u32 indx = 0;
 
-                        if ((v0 == 24 && v1 == 251) || (v0 == 26 && v1 == 251)) // TODO
-                        {
-                            px = (u32*)((addr)px + (addr)(2 * sizeof(u32)));
-                        }
-                    }
+            for (u32 x = 1; x < header->Count; x++)
+            {
+                if (header->Entries[x].Tick < header->Entries[indx].Tick) { indx = x; }
+            }
 
-                    if (UpdateRendererTextureLevel(surface,
-                        NULL, &dst, px, tex->TextureFormat, size,
-                        NULL, &src, IMAGE_CONTAINER_OPTIONS_COLOR, GRAPCHICS_COLOR_BLACK) == D3D_OK)
-                    {
-                        surface->Release();
+            used = used - header->Entries[indx].Size;
 
-                        return TRUE;
-                    }
+            header->Count = header->Count - 1;
 
-                    surface->Release();
-                }
+            MoveMemory(&header->Entries[indx], &header->Entries[indx + 1], (header->Count - indx) * sizeof(RendererTextureCacheEntry));
+        }
+
+        u32 offset = 0;
+
+        for (u32 x = 0; x < header->Count; x++)
+        {
+            RendererTextureCacheEntry* entry = &header->Entries[x];
+
+            if (entry->Offset != offset)
+            {
+                MoveMemory((void*)((addr)State.TextureCache.Data + (addr)offset),
+                    (void*)((addr)State.TextureCache.Data + (addr)entry->Offset), entry->Size);
+
+                entry->Offset = offset;
             }
+
+            offset = offset + entry->Size;
         }
 
-        return FALSE;
+        header->Size = offset;
     }
 
     // 0x60009876
@@ -2091,10 +4593,11 @@ namespace RendererModule
                 return result;
             }
 
-            rect.top = 0;
-            rect.left = 0;
+            // NOTE: The size is computed before the origin is reset, so the locked area keeps its size.
             rect.right = rect.right - rect.left;
             rect.bottom = rect.bottom - rect.top;
+            rect.top = 0;
+            rect.left = 0;
         }
 
 
@@ -2104,21 +4607,21 @@ namespace RendererModule
         dsti.Format = desc.Format;
         dsti.Pixels = lock.pBits;
         dsti.Stride = lock.Pitch;
-        dsti.Unk03 = 0;
+        dsti.AreaStride = 0;
         dsti.Unk04 = 0;
         dsti.Unk05 = 0;
-        dsti.Unk06 = desc.Width;
-        dsti.Unk07 = desc.Height;
+        dsti.Width = desc.Width;
+        dsti.Height = desc.Height;
         dsti.Unk08 = 0;
         dsti.Unk09 = 1;
-        dsti.Unk10 = rect.left;
-        dsti.Unk11 = rect.top;
-        dsti.Unk12 = rect.right;
-        dsti.Unk13 = rect.bottom;
-        dsti.Unk14 = 0;
-        dsti.Unk15 = 1;
-        dsti.Unk17 = 0;
-        dsti.Unk18 = param_2;
+        dsti.Dimensions.Left = rect.left;
+        dsti.Dimensions.Top = rect.top;
+        dsti.Dimensions.Right = rect.right;
+        dsti.Dimensions.Bottom = rect.bottom;
+        dsti.Dimensions.Min = 0;
+        dsti.Dimensions.Max = 1;
+        dsti.Color = 0;
+        dsti.Palette = dpal;
 
         ImageContainerArgs srci;
         ZeroMemory(&srci, sizeof(ImageContainerArgs));
@@ -2126,15 +4629,15 @@ namespace RendererModule
         srci.Format = format;
         srci.Pixels = (void*)pixels;
         srci.Stride = pitch;
-        srci.Unk03 = 0;
-        srci.Unk10 = src->x1;
-        srci.Unk11 = src->y1;
-        srci.Unk12 = src->x2;
-        srci.Unk13 = src->y2;
-        srci.Unk14 = 0;
-        srci.Unk15 = 1;
-        srci.Unk17 = param_10;
-        srci.Unk18 = param_7;
+        srci.AreaStride = 0;
+        srci.Dimensions.Left = srect->x1;
+        srci.Dimensions.Top = srect->y1;
+        srci.Dimensions.Right = srect->x2;
+        srci.Dimensions.Bottom = srect->y2;
+        srci.Dimensions.Min = 0;
+        srci.Dimensions.Max = 1;
+        srci.Color = color;
+        srci.Palette = spal;
 
         HRESULT result = UpdateImageContainer(&img, &dsti, &srci, param_9);
 
@@ -2146,4 +4649,92 @@ namespace RendererModule
 
         return result;
     }
+
+    // Acquires the set of the edges of the clip rectangle the vertex is outside of.
+    u32 AcquireRendererClipCode(const f32x3* xyz)
+    {
+        u32 result = RENDERER_CLIP_NONE;
+
+        if (xyz->X < State.Clip.Left) { result = result | RENDERER_CLIP_LEFT; }
+        if (State.Clip.Right < xyz->X) { result = result | RENDERER_CLIP_RIGHT; }
+        if (xyz->Y < State.Clip.Top) { result = result | RENDERER_CLIP_TOP; }
+        if (State.Clip.Bottom < xyz->Y) { result = result | RENDERER_CLIP_BOTTOM; }
+
+        return result;
+    }
+
+    // Acquires the distance of the vertex from the edge of the clip rectangle, positive inside of the rectangle.
+    f32 AcquireRendererClipDistance(const f32x3* xyz, const u32 edge)
+    {
+        switch (edge)
+        {
+        case RENDERER_CLIP_LEFT: { return xyz->X - State.Clip.Left; }
+        case RENDERER_CLIP_RIGHT: { return State.Clip.Right - xyz->X; }
+        case RENDERER_CLIP_TOP: { return xyz->Y - State.Clip.Top; }
+        }
+
+        return State.Clip.Bottom - xyz->Y;
+    }
+
+    // Interpolates each of the color channels with the weights of the two colors.
+    u32 InterpolateRendererColor(const u32 a, const u32 b, const f32 wa, const f32 wb)
+    {
+        u32 result = 0;
+
+        for (u32 x = 0; x < 32; x = x + 8)
+        {
+            const f32 value = (f32)((a >> x) & 0xFF) * wa + (f32)((b >> x) & 0xFF) * wb + 0.5f;
+
+            result = result | ((value < 255.0f ? (0.0f < value ? (u32)value : 0) : 0xFF) << x);
+        }
+
+        return result;
+    }
+
+    // Interpolates the vertex between the two vertexes of a clipped edge.
+    // The position and the reciprocal of W are linear in screen space, while the colors and the texture coordinates
+    // are interpolated with perspective correction, same way as the device does across the triangle.
+    void InterpolateRendererVertex(RTLVX* result, const RTLVX* a, const RTLVX* b, const f32 t)
+    {
+        const f32 rhw = a->RHW + (b->RHW - a->RHW) * t;
+
+        const f32 wa = rhw == 0.0f ? (1.0f - t) : (a->RHW * (1.0f - t) / rhw);
+        const f32 wb = 1.0f - wa;
+
+        result->XYZ.X = a->XYZ.X + (b->XYZ.X - a->XYZ.X) * t;
+        result->XYZ.Y = a->XYZ.Y + (b->XYZ.Y - a->XYZ.Y) * t;
+        result->XYZ.Z = a->XYZ.Z + (b->XYZ.Z - a->XYZ.Z) * t;
+        result->RHW = rhw;
+
+        result->Color = InterpolateRendererColor(a->Color, b->Color, wa, wb);
+        result->Specular = InterpolateRendererColor(a->Specular, b->Specular, wa, wb);
+
+        result->UV.X = a->UV.X * wa + b->UV.X * wb;
+        result->UV.Y = a->UV.Y * wa + b->UV.Y * wb;
+    }
+
+    // Interpolates the vertex between the two vertexes of a clipped edge, including the second set of the texture coordinates.
+    void InterpolateRendererVertex(RTLVX2* result, const RTLVX2* a, const RTLVX2* b, const f32 t)
+    {
+        InterpolateRendererVertex((RTLVX*)result, (const RTLVX*)a, (const RTLVX*)b, t);
+
+        const f32 wa = result->RHW == 0.0f ? (1.0f - t) : (a->RHW * (1.0f - t) / result->RHW);
+        const f32 wb = 1.0f - wa;
+
+        result->UV2.X = a->UV2.X * wa + b->UV2.X * wb;
+        result->UV2.Y = a->UV2.Y * wa + b->UV2.Y * wb;
+    }
+
+
+    // Selects the rectangle the primitives are clipped against on the CPU, the one covering the whole window turns the clipping off.
+    // The vertex offset is applied after the vertexes are clipped, thus the rectangle is shifted the opposite way.
+    void SelectRendererClipRectangle(const u32 x0, const u32 y0, const u32 x1, const u32 y1)
+    {
+        State.Clip.IsActive = x0 != 0 || y0 != 0 || x1 < State.DX.Surfaces.Width || y1 < State.DX.Surfaces.Height;
+
+        State.Clip.Left = (f32)x0 + 0.5f;
+        State.Clip.Top = (f32)y0 + 0.5f;
+        State.Clip.Right = (f32)x1 + 0.5f;
+        State.Clip.Bottom = (f32)y1 + 0.5f;
+    }
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "DirectX.hxx"
 #include "RendererModule.Export.hxx"
+#include "RendererMesh.hxx"
+#include "RendererTextureCache.hxx"
 
 #define CLEAR_DEPTH_VALUE (1.0f)
 #define DEFAULT_DEVICE_INDEX 0
@@ -31,36 +33,66 @@ SOFTWARE.
 #define DEFAULT_FOG_END (1.0f)
 #define DEFAULT_TEXTURE_PALETTE_VALUE 0
 #define ENVIRONMENT_SECTION_NAME "DX8"
+#define INVALID_TEXTURE_HASH 0
 #define INVALID_TEXTURE_PALETTE_VALUE 0xFFFF
 #define MAX_ACTIVE_SURFACE_COUNT 8
 #define MAX_ACTIVE_UNKNOWN_COUNT 10
+#define MAX_CLIP_TRIANGLE_COUNT (MAX_CLIP_VERTEX_COUNT - 2)
+#define MAX_CLIP_VERTEX_COUNT 8
 #define MAX_DEVICE_CAPABILITIES_COUNT 256
 #define MAX_ENUMERATE_DEVICE_NAME_COUNT 60 /* ORIGINAL: 10 */
 #define MAX_IMAGE_FORMAT_DESCRIPTOR_COUNT 30
+#define MAX_MESH_COUNT 256
+#define MAX_MESH_SIZE (16 * 1024 * 1024)
 #define MAX_INPUT_FOG_ALPHA_COUNT 64
 #define MAX_OUTPUT_FOG_ALPHA_COUNT 256
 #define MAX_OUTPUT_FOG_ALPHA_VALUE 255
 #define MAX_RENDER_PACKET_COUNT 10000
+#define MAX_RENDER_STATE_COUNT 256
+#define MAX_TEXTURE_ATLAS_COUNT 8
+#define MAX_TEXTURE_ATLAS_DIMENSION 512
+#define MAX_TEXTURE_CACHE_SIZE 256 /* MB */
 #define MAX_TEXTURE_FORMAT_COUNT 34
+#define MAX_TEXTURE_PALETTE_BUCKET_COUNT 1024
+#define MAX_TEXTURE_PALETTE_CACHE_COUNT 256
 #define MAX_TEXTURE_PALETTE_COLOR_COUNT 256
-#define MAX_TEXTURE_PALETTE_INDEX_COUNT 512
+#define MAX_TEXTURE_PALETTE_COUNT 16384
 #define MAX_TEXTURE_STAGE_COUNT 8
+#define MAX_TEXTURE_STAGE_STATE_COUNT 32
 #define MAX_TEXTURE_STATE_STATE_COUNT 120
+#define MAX_TEXTURE_UPLOAD_THREAD_COUNT 4
 #define MAX_USABLE_TEXTURE_FORMAT_COUNT 34
 #define MAX_USABLE_TEXTURE_FORMAT_INDEX_COUNT 34
 #define MAX_VERTEX_BUFFER_SIZE 2621400
 #define MAX_VERTEX_COUNT 65535
 #define MAX_WINDOW_COUNT 256
 #define MIN_ACTUAL_DEVICE_CAPABILITIES_INDEX 2
+#define MIN_MESH_FRAME_COUNT 3
+#define MIN_MESH_VERTEX_COUNT 32
 #define MIN_SIMULTANEOUS_TEXTURE_COUNT 1
 #define MIN_WINDOW_INDEX 8
 #define RENDERER_DEVICE_DEPTH_FORMAT_COUNT 5
 #define RENDERER_DEVICE_FORMAT_COUNT 2
+#define TEXTURE_ATLAS_BORDER_SIZE 1
+#define TEXTURE_CACHE_FILE_NAME ".\\azhp.dx8.cache"
+
+#define RENDERER_CLIP_NONE                      0x00000000
+#define RENDERER_CLIP_LEFT                      0x00000001
+#define RENDERER_CLIP_RIGHT                     0x00000002
+#define RENDERER_CLIP_TOP                       0x00000004
+#define RENDERER_CLIP_BOTTOM                    0x00000008
 
 #define RENDERER_CULL_MODE_CLOCK_WISE           0x00000000
 #define RENDERER_CULL_MODE_NONE                 0x00000001
 #define RENDERER_CULL_MODE_COUNTER_CLOCK_WISE   0x80000000
 
+#define RENDERER_VERTEX_TRANSFORM_NONE          0x00000000
+#define RENDERER_VERTEX_TRANSFORM_COLOR         0x00000001
+#define RENDERER_VERTEX_TRANSFORM_FOG           0x00000002
+#define RENDERER_VERTEX_TRANSFORM_OFFSET        0x00000004
+#define RENDERER_VERTEX_TRANSFORM_RANGE         0x00000008
+#define RENDERER_VERTEX_TRANSFORM_ATLAS         0x00000010
+
 #define MAKEPIXELFORMAT(x) (x & 0xFF)
 
 #if !defined(__WATCOMC__) && _MSC_VER <= 1200
@@ -73,8 +105,52 @@ inline void LOGMESSAGE(...) { }
 #define LOGMESSAGE(...) Message(RENDERER_MODULE_MESSAGE_SEVERITY_MESSAGE, __VA_ARGS__)
 #endif
 
+#if !defined(__WATCOMC__) && _MSC_VER > 1200
+#define RENDERER_MODULE_SIMD
+#include <emmintrin.h>
+#endif
+
 namespace Renderer
 {
+    struct RendererTexture;
+
+    struct RendererTextureUpload
+    {
+        RendererTexture* Texture; // NOTE: NULL when the texture is released, or updated again, before the upload completes.
+
+        u32 Width;
+        u32 Height;
+        u32 Levels;
+
+        D3DFORMAT Source;
+        D3DFORMAT Destination;
+
+        u32 PixelSize;
+        u32 StagingPixelSize; // NOTE: Unused when the pixels are compressed into the blocks.
+
+        BOOL IsValid; // NOTE: FALSE when the conversion of the pixels fails.
+
+        u64 Hash; // NOTE: The hash of the pixels, or INVALID_TEXTURE_HASH when the staged pixels are not cached.
+        u32 StagingSize;
+
+        u8* Pixels;
+        u8* Staging; // NOTE: The blocks, or the converted pixels, of all of the levels in the format of the texture.
+
+        RendererTextureUpload* Next;
+    };
+
+    struct RendererTextureAtlas
+    {
+        IDirect3DTexture8* Texture;
+        D3DFORMAT Format;
+
+        u32 Count; // NOTE: The number of the textures packed into the atlas.
+
+        u32 X; // NOTE: The position, and the height, of the current row of the atlas.
+        u32 Y;
+        u32 Height;
+    };
+
     struct RendererTexture
     {
         DWORD Handle;
@@ -92,6 +168,13 @@ namespace Renderer
         IDirect3DTexture8* Texture;
         u32 Palette;
         u32 Colors;
+
+        BOOL IsCompressed; // NOTE: The pixels are compressed into the block compressed format of the texture on upload.
+        RendererTextureUpload* Upload; // NOTE: The pending upload, the texture keeps its previous pixels until it is committed.
+
+        RendererTextureAtlas* Atlas; // NOTE: The atlas the texture is packed into, or NULL when the texture has the device texture of its own.
+        u32 AtlasX;
+        u32 AtlasY;
     };
 }
 
@@ -117,6 +200,35 @@ namespace RendererModule
         s32 Values[MAX_TEXTURE_STAGE_COUNT];
     };
 
+    struct RendererMesh
+    {
+        u32 Hash[2];
+
+        u32 Shader;
+        u32 Transforms;
+
+        BOOL IsOrdered;
+
+        u32 Frame;
+        u32 Frames;
+
+        u32 Size;
+
+        struct
+        {
+            u32 Count;
+
+            IDirect3DVertexBuffer8* Buffer;
+        } Vertexes;
+
+        struct
+        {
+            u32 Count;
+
+            IDirect3DIndexBuffer8* Buffer;
+        } Indexes;
+    };
+
     struct RendererPacket
     {
         D3DPRIMITIVETYPE Type;
@@ -124,6 +236,17 @@ namespace RendererModule
         u32 Size;
     };
 
+    struct TexturePalette
+    {
+        u64 Hash; // NOTE: The hash of the colors of the palette, or INVALID_TEXTURE_HASH when the palette holds no colors yet.
+        u32 References; // NOTE: The number of the textures sharing the palette.
+
+        u32 Next; // NOTE: The next palette within the same hash bucket, or within the list of the free palettes.
+
+        u32 Older; // NOTE: The neighbouring released palettes, that keep their colors, from the least recently used one.
+        u32 Newer;
+    };
+
     struct TextureStage
     {
         s32 Unk01; // TODO
@@ -183,8 +306,9 @@ namespace RendererModule
             struct
             {
                 u32 Count; // 0x6001dab4
+                u32 Capacity;
 
-                RendererPacket Packets[MAX_RENDER_PACKET_COUNT]; // 0x60021000
+                RendererPacket* Packets; /* ORIGINAL: RendererPacket Packets[MAX_RENDER_PACKET_COUNT]; */ // 0x60021000
             } Packets;
 
             struct
@@ -194,6 +318,8 @@ namespace RendererModule
                 IDirect3DVertexBuffer8* Buffer; // 0x6001dabc
 
                 u32 StartIndex; // 0x6001dac0
+
+                u32 Transforms;
             } Vertexes;
         } Data;
 
@@ -273,8 +399,60 @@ namespace RendererModule
             u32 Strips; // 0x6001dad4
             u32 Fans; // 0x6001dad8
             u32 Points; // 0x6001dadc
+
+            u32 Filtered;
+            u32 Batched;
+
+            u32 MeshHits;
+            u32 MeshMisses;
         } Statistics;
 
+        struct
+        {
+            u32 Count;
+            u32 Size;
+
+            u32 Frame;
+
+            RendererMesh Meshes[MAX_MESH_COUNT];
+        } Meshes;
+
+        struct
+        {
+            BOOL IsActive;
+            BOOL IsInverse;
+            BOOL IsCleared;
+
+            u32 Frame;
+
+            D3DCMPFUNC Function;
+        } DepthRange;
+
+        struct
+        {
+            BOOL IsActive;
+
+            f32 Left;
+            f32 Top;
+            f32 Right;
+            f32 Bottom;
+        } Clip;
+
+        struct
+        {
+            struct
+            {
+                BOOL IsValid[MAX_RENDER_STATE_COUNT];
+                DWORD Values[MAX_RENDER_STATE_COUNT];
+            } States;
+
+            struct
+            {
+                BOOL IsValid[MAX_TEXTURE_STAGE_COUNT][MAX_TEXTURE_STAGE_STATE_COUNT];
+                DWORD Values[MAX_TEXTURE_STAGE_COUNT][MAX_TEXTURE_STAGE_STATE_COUNT];
+            } Stages;
+        } Shadow;
+
         struct
         {
             BOOL Illegal; // 0x6001edec
@@ -286,8 +464,64 @@ namespace RendererModule
             TextureStage Stages[MAX_TEXTURE_STAGE_COUNT]; // 0x60020040
 
             TextureStageState StageStates[MAX_TEXTURE_STATE_STATE_COUNT]; // 0x6001dae8
+
+            struct
+            {
+                Renderer::RendererTextureAtlas Atlases[MAX_TEXTURE_ATLAS_COUNT];
+
+                Renderer::RendererTexture* Current; // NOTE: The packed texture selected into the first stage.
+
+                f32x2 Offset;
+                f32x2 Scale;
+
+                DWORD AddressU;
+                DWORD AddressV;
+            } Atlases;
+
+            struct
+            {
+                u32 Current; // NOTE: The palette selected into the device.
+
+                u32 Count; // NOTE: The number of the palettes ever handed out, the ones above it were never used.
+                u32 Free; // NOTE: The list of the released palettes without colors.
+
+                u32 Unused; // NOTE: The number of the released palettes, that keep their colors to be shared again.
+                u32 Oldest;
+                u32 Newest;
+
+                u32 Buckets[MAX_TEXTURE_PALETTE_BUCKET_COUNT];
+
+                TexturePalette Palettes[MAX_TEXTURE_PALETTE_COUNT];
+            } Palettes;
         } Textures;
 
+        struct
+        {
+            BOOL IsActive;
+
+            u32 Count;
+            HANDLE Threads[MAX_TEXTURE_UPLOAD_THREAD_COUNT];
+
+            HANDLE Work;
+            CRITICAL_SECTION Lock;
+
+            Renderer::RendererTextureUpload* Pending;
+            Renderer::RendererTextureUpload* Last;
+            Renderer::RendererTextureUpload* Complete;
+        } Uploads;
+
+        struct
+        {
+            BOOL IsActive;
+            BOOL IsInvalid; // NOTE: The cache file can not be opened, so it is not attempted again.
+
+            HANDLE File;
+            HANDLE Mapping;
+
+            RendererTextureCacheHeader* Header;
+            u8* Data;
+        } TextureCache;
+
         struct
         {
             u32 X0; // 0x6001da9c
@@ -327,52 +561,114 @@ namespace RendererModule
     BOOL AcquireRendererDeviceDepthFormat(const u32 device, const D3DFORMAT adapter, const D3DFORMAT target, D3DFORMAT* result);
     BOOL AcquireRendererDeviceDepthFormat(u32* bits, D3DFORMAT* result);
     BOOL AcquireRendererDeviceDepthWindowFormat(u32* width, u32* height, u32* bits, D3DFORMAT* format);
+    BOOL AcquireRendererTextureAtlasPosition(Renderer::RendererTextureAtlas* atlas, const u32 width, const u32 height, u32* x, u32* y);
+    BOOL AllocateRendererPackets(const u32 count);
     BOOL AreRenderPacketsComplete(const D3DPRIMITIVETYPE type, const u32 count);
     BOOL AttemptRenderPackets(void);
     BOOL BeginRendererScene(void);
+    BOOL ConvertRendererTexture(Renderer::RendererTextureUpload* task, const u32 options);
+    BOOL InitializeRendererMesh(RendererMesh* mesh, Renderer::RVX* vertexes, const u32* indexes);
+    BOOL InitializeRendererTextureAtlas(Renderer::RendererTextureAtlas* atlas, const D3DFORMAT format);
+    BOOL InitializeRendererTextureCache(void);
+    BOOL InitializeRendererTextureUploads(void);
+    BOOL IsRendererTextureAtlasClamped(void);
+    BOOL IsRendererTextureSelected(Renderer::RendererTexture* tex);
+    BOOL PackRendererTexture(Renderer::RendererTexture* tex);
+    BOOL RenderRendererMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
     BOOL RestoreRendererSurfaces(void);
+    BOOL SelectRendererDepthFunction(const D3DCMPFUNC function);
     BOOL SelectRendererMaterial(const u32 color);
     BOOL SelectRendererState(const D3DRENDERSTATETYPE type, const DWORD value);
+    BOOL SelectRendererTexturePalette(const u32 palette);
     BOOL SelectRendererTextureStage(const u32 stage, const D3DTEXTURESTAGESTATETYPE type, const DWORD value);
+    BOOL SubmitRendererTextureUpload(Renderer::RendererTexture* tex, const u32* pixels);
+    BOOL UnpackRendererTexture(Renderer::RendererTexture* tex);
     BOOL UpdateRendererTexture(Renderer::RendererTexture* tex, const u32* pixels, const u32* palette);
     BOOL UpdateRendererTexturePalette(Renderer::RendererTexture* tex, const u32* palette);
     BOOL UpdateRendererTextureRectangle(Renderer::RendererTexture* tex, const u32* pixels, const u32* palette, const s32 x, const s32 y, const s32 width, const s32 height, const s32 size, const s32 level);
+    BOOL UploadRendererTextureAtlas(Renderer::RendererTexture* tex, const u32* pixels, const D3DFORMAT format, const u32 pitch, const D3DRECT* rect);
+    BOOL UploadRendererTextureLevels(Renderer::RendererTextureUpload* task);
+    BOOL UploadRendererTexturePixels(Renderer::RendererTexture* tex, const u32* pixels, const D3DFORMAT format);
+    BYTE* LockRendererVertexes(const u32 count);
+    D3DFORMAT AcquireRendererTextureCompressionFormat(const u32 width, const u32 height, const u32 format);
     D3DFORMAT AcquireRendererTextureFormat(const u32 indx);
+    DWORD WINAPI PrepareRendererTextureUploadThread(LPVOID);
+    f32 AcquireRendererClipDistance(const f32x3* xyz, const u32 edge);
     HRESULT InitializeRendererTexture(Renderer::RendererTexture* tex);
     inline u32 AcquireNormal(const f32x3* a, const f32x3* b, const f32x3* c) { const s32 value = (s32)((b->X - a->X) * (c->Y - a->Y) - (c->X - a->X) * (b->Y - a->Y)); return *(u32*)&value; }
+    RendererMesh* AcquireRendererMesh(Renderer::RVX* vertexes, const u32* indexes, const u32 count);
+    RendererTextureCacheEntry* AcquireRendererTextureCacheEntry(const u64 hash, const D3DFORMAT source, const D3DFORMAT destination, const u32 width, const u32 height, const u32 levels);
     Renderer::RendererTexture* AllocateRendererTexture(const u32 size);
     Renderer::RendererTexture* AllocateRendererTexture(void);
     s32 AcquireSettingsValue(const s32 value, const char* section, const char* name);
     s32 AcquireTextureStateStageIndex(const u32 state);
+    u32 AcquireRendererClipCode(const f32x3* xyz);
     u32 AcquireRendererDeviceCount(void);
     u32 AcquireRendererDeviceFormat(const D3DFORMAT format);
     u32 AcquireRendererDeviceFormatSize(const D3DFORMAT format, const RendererDeviceFormatSize size);
+    u32 AcquireRendererTextureLevelPitch(const D3DFORMAT format, const u32 width, const u32 size);
+    u32 AcquireRendererTextureLevelRows(const D3DFORMAT format, const u32 height);
+    u32 AcquireRendererVertexIndex(const u32* indexes, const u32 indx);
     u32 AcquireTexturePalette();
+    u32 AcquireTexturePalette(const u64 hash);
     u32 ClearRendererViewPort(const u32 x0, const u32 y0, const u32 x1, const u32 y1, const BOOL window);
     u32 DisposeRendererTexture(Renderer::RendererTexture* tex);
+    u32 InterpolateRendererColor(const u32 a, const u32 b, const f32 wa, const f32 wb);
     u32 SelectBasicRendererState(const u32 state, void* value);
     u32 SelectRendererTransforms(const f32 zNear, const f32 zFar);
     u32 STDCALLAPI InitializeRendererDeviceExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result);
     u32 STDCALLAPI InitializeRendererDeviceSurfacesExecute(const void*, const HWND hwnd, const u32 msg, const u32 wp, const u32 lp, HRESULT* result);
     u32 ToggleRenderer(void);
+    u64 AcquireRendererTextureHash(const void* data, const u32 size);
     void AcquireRendererDeviceFormats(void);
     void AcquireRendererDeviceMemorySize(void);
     void AcquireRendererModuleDescriptor(RendererModuleDescriptor* desc, const char* section);
     void AcquireRendererTextureFormats(const D3DFORMAT format);
+    void AppendRendererClippedLine(Renderer::RVX* a, Renderer::RVX* b);
+    void AppendRendererClippedTriangle(Renderer::RVX* a, Renderer::RVX* b, Renderer::RVX* c);
+    void AppendRendererLineMesh(const u32 count, Renderer::RVX* vertexes, const u32* indexes);
+    void AppendRendererPacket(const D3DPRIMITIVETYPE type, const u32 count, const u32 size);
+    void AppendRendererQuadMesh(const u32 count, Renderer::RVX* vertexes, const u32* indexes);
+    void AppendRendererTriangleMesh(const u32 count, Renderer::RVX* vertexes, const u32* indexes);
+    void AppendRendererTriangles(const D3DPRIMITIVETYPE type, const u32 count, Renderer::RVX* vertexes, const u32* indexes);
+    void CancelRendererTextureUpload(Renderer::RendererTexture* tex);
+    void CommitRendererTextureUploads(void);
+    void CompressRendererTexture(Renderer::RendererTextureUpload* task);
+    void DetachTexturePalette(const u32 palette);
+    void DisposeRendererTextureUpload(Renderer::RendererTextureUpload* task);
     void InitializeRendererModuleState(const u32 mode, const u32 pending, const u32 depth, const char* section);
+    void InitializeRendererShadowStates(void);
     void InitializeRendererState(void);
     void InitializeRenderState55(void);
     void InitializeTexturePalette(void);
     void InitializeTextureStateStates(void);
     void InitializeVertexBuffer(void);
     void InitializeViewPort(void);
+    void InterpolateRendererVertex(Renderer::RTLVX* result, const Renderer::RTLVX* a, const Renderer::RTLVX* b, const f32 t);
+    void InterpolateRendererVertex(Renderer::RTLVX2* result, const Renderer::RTLVX2* a, const Renderer::RTLVX2* b, const f32 t);
     void ModifyRendererSurface(IDirect3DSurface8* surface, const u32 count);
+    void PrepareRendererTextureUpload(Renderer::RendererTextureUpload* task, const u32 options);
+    void ReleaseRendererMesh(RendererMesh* mesh);
+    void ReleaseRendererMeshes(void);
     void ReleaseRendererObjects(void);
+    void ReleaseRendererPackets(void);
+    void ReleaseRendererTextureAtlas(Renderer::RendererTexture* tex);
+    void ReleaseRendererTextureAtlases(void);
+    void ReleaseRendererTextureCache(void);
+    void ReleaseRendererTextureUploads(void);
     void ReleaseRendererWindows(void);
     void ReleaseTexturePalette(const s32 palette);
     void RenderPackets(void);
     void RenderScene(void);
+    void SelectRendererClipRectangle(const u32 x0, const u32 y0, const u32 x1, const u32 y1);
+    void SelectRendererDepthRange(const BOOL active, const BOOL inverse);
     void SelectRendererFogAlphas(const u8* input, u8* output);
     void SelectRendererStateValue(const u32 state, void* value);
+    void SelectRendererTextureAtlas(Renderer::RendererTexture* tex);
+    void SelectRendererVertexTransforms(void);
+    void StoreRendererTextureCache(Renderer::RendererTextureUpload* task);
+    void TrimRendererTextureCache(const u32 size);
     void UpdateVertex(Renderer::RTLVX* vertex);
+    void UpdateVertexes(Renderer::RVX* vertexes, const u32 count);
+    void WaitRendererTextureUpload(Renderer::RendererTexture* tex);
 }
\ No newline at end of file
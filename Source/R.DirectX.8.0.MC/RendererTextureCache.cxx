@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RendererTextureCache.hxx"
+
+#include <string.h>
+
+namespace RendererModule
+{
+    // Checks that the cache file was closed cleanly, and that every one of its entries lies within the data in use,
+    // in the order of their offsets, without overlapping the others.
+    u32 AcquireRendererTextureCacheState(const RendererTextureCacheHeader* header, const u32 capacity)
+    {
+        if (header->Magic != TEXTURE_CACHE_MAGIC || header->Version != TEXTURE_CACHE_VERSION) { return TEXTURE_CACHE_STATE_INVALID_HEADER; }
+
+        if (header->Capacity != capacity) { return TEXTURE_CACHE_STATE_INVALID_CAPACITY; }
+
+        if (header->IsDirty) { return TEXTURE_CACHE_STATE_DIRTY; }
+
+        if (MAX_TEXTURE_CACHE_ENTRY_COUNT < header->Count || capacity < header->Size) { return TEXTURE_CACHE_STATE_INVALID_HEADER; }
+
+        u32 offset = 0;
+
+        for (u32 x = 0; x < header->Count; x++)
+        {
+            const RendererTextureCacheEntry* entry = &header->Entries[x];
+
+            if (entry->Offset < offset || header->Size < entry->Size
+                || header->Size - entry->Size < entry->Offset) { return TEXTURE_CACHE_STATE_INVALID_ENTRY; }
+
+            offset = entry->Offset + entry->Size;
+        }
+
+        return TEXTURE_CACHE_STATE_VALID;
+    }
+
+    // Resets the cache file into the empty one of the capacity.
+    void InitializeRendererTextureCacheHeader(RendererTextureCacheHeader* header, const u32 capacity)
+    {
+        memset(header, 0x00, sizeof(RendererTextureCacheHeader));
+
+        header->Magic = TEXTURE_CACHE_MAGIC;
+        header->Version = TEXTURE_CACHE_VERSION;
+        header->Capacity = capacity;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Basic.hxx"
+
+#define MAX_TEXTURE_CACHE_ENTRY_COUNT 4096
+#define TEXTURE_CACHE_MAGIC 0x48435854 /* TXCH */
+#define TEXTURE_CACHE_VERSION 2
+
+#define TEXTURE_CACHE_STATE_VALID               0
+#define TEXTURE_CACHE_STATE_INVALID_HEADER      1
+#define TEXTURE_CACHE_STATE_INVALID_CAPACITY    2
+#define TEXTURE_CACHE_STATE_INVALID_ENTRY       3
+#define TEXTURE_CACHE_STATE_DIRTY               4
+
+namespace RendererModule
+{
+    // NOTE: The layout of the cache file does not depend on the platform, so that the file can be inspected by the tools.
+    struct RendererTextureCacheEntry
+    {
+        u64 Hash;
+
+        u32 Source; // NOTE: The D3DFORMAT of the pixels of the texture.
+        u32 Destination; // NOTE: The D3DFORMAT of the converted pixels.
+
+        u32 Width;
+        u32 Height;
+        u32 Levels;
+
+        u32 Offset;
+        u32 Size;
+
+        u32 Tick; // NOTE: The time the entry was last used at, the least recently used entries are trimmed first.
+    };
+
+    struct RendererTextureCacheHeader
+    {
+        u32 Magic;
+        u32 Version;
+
+        BOOL IsDirty; // NOTE: The cache file is in use, or was not closed cleanly, so its contents can not be trusted.
+
+        u32 Capacity; // NOTE: The size of the data of the cache file, in bytes.
+        u32 Size; // NOTE: The size of the data in use, the entries are kept in the order of their offsets.
+
+        u32 Tick;
+
+        u32 Count;
+        RendererTextureCacheEntry Entries[MAX_TEXTURE_CACHE_ENTRY_COUNT];
+    };
+
+    u32 AcquireRendererTextureCacheState(const RendererTextureCacheHeader* header, const u32 capacity);
+    void InitializeRendererTextureCacheHeader(RendererTextureCacheHeader* header, const u32 capacity);
+}
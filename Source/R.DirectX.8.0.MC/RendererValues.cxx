@@ -119,7 +119,4 @@ namespace RendererModuleValues
         { D3DFMT_DXT5,      IMAGE_FORMAT_DESCRIPTOR_TYPE_RGB,       GRAPHICS_BITS_PER_PIXEL_16, GRAPHICS_BITS_PER_PIXEL_0, GRAPHICS_BITS_PER_PIXEL_3, GRAPHICS_BITS_PER_PIXEL_5,  GRAPHICS_BITS_PER_PIXEL_6,  GRAPHICS_BITS_PER_PIXEL_5,  0, 1 },
         { D3DFMT_UNKNOWN,   IMAGE_FORMAT_DESCRIPTOR_TYPE_RGB,       GRAPHICS_BITS_PER_PIXEL_32, GRAPHICS_BITS_PER_PIXEL_0, GRAPHICS_BITS_PER_PIXEL_8, GRAPHICS_BITS_PER_PIXEL_8,  GRAPHICS_BITS_PER_PIXEL_8,  GRAPHICS_BITS_PER_PIXEL_8,  0, 1 }
     };
-
-    u32 TexturePaletteIndexes[MAX_TEXTURE_PALETTE_INDEX_COUNT];
-    u32 TexturePaletteValues[MAX_TEXTURE_PALETTE_INDEX_COUNT];
 }
@@ -71,7 +71,4 @@ namespace RendererModuleValues
     extern BOOL IsTexturePaletteInactive; // 0x6001c220
 
     extern Images::ImageFormatDescriptor ImageFormatDescriptors[MAX_IMAGE_FORMAT_DESCRIPTOR_COUNT]; // 0x6001c230
-
-    extern u32 TexturePaletteIndexes[MAX_TEXTURE_PALETTE_INDEX_COUNT]; // 0x6001f040
-    extern u32 TexturePaletteValues[MAX_TEXTURE_PALETTE_INDEX_COUNT]; // 0x6001f840
 }
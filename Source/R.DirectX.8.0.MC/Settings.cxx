@@ -37,7 +37,23 @@ namespace Settings
 
     void InitializeSettings(void)
     {
+        SettingsState.DepthClearInterval = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_DEPTH_CLEAR_INTERVAL_PROPERTY_NAME, 1, RENDERER_MODULE_SETTINGS_FILE_NAME);
         SettingsState.FlatShading = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
             RENDERER_MODULE_SETTINGS_FLAT_SHADING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.GeometryCache = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_GEOMETRY_CACHE_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureAtlas = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_ATLAS_PROPERTY_NAME, 64, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureCache = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_CACHE_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureCacheSize = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_CACHE_SIZE_PROPERTY_NAME, 64, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureCompression = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_COMPRESSION_PROPERTY_NAME, FALSE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.TextureStaging = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_TEXTURE_STAGING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
+        SettingsState.ViewPortClipping = GetPrivateProfileIntA(RENDERER_MODULE_SETTINGS_SECTION_DX8_NAME,
+            RENDERER_MODULE_SETTINGS_VIEWPORT_CLIPPING_PROPERTY_NAME, TRUE, RENDERER_MODULE_SETTINGS_FILE_NAME);
     }
 }
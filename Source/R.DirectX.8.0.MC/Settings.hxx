@@ -28,7 +28,15 @@ namespace Settings
 {
     struct SettingsContainer
     {
+        u32 DepthClearInterval;
         BOOL FlatShading;
+        BOOL GeometryCache;
+        u32 TextureAtlas;
+        BOOL TextureCache;
+        u32 TextureCacheSize;
+        BOOL TextureCompression;
+        BOOL TextureStaging;
+        BOOL ViewPortClipping;
     };
 
     extern SettingsContainer SettingsState;
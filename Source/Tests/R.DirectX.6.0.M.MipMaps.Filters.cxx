@@ -0,0 +1,49 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RendererMipMaps.hxx"
+
+// NOTE: The unit is built twice, along with the filters, once with the SIMD paths and once without them,
+// the scalar build is renamed into the RendererModuleScalar namespace, so that both of the builds are linked together.
+namespace RendererModule
+{
+    RendererMipMapGamma TestMipMapGamma;
+
+    // Returns TRUE when the filters of the build use the SIMD paths.
+    BOOL IsTestMipMapSIMD(void)
+    {
+#ifdef RENDERER_MODULE_SIMD
+        return TRUE;
+#else
+        return FALSE;
+#endif
+    }
+
+    // Filters the next mip map level of the 16-bit or the 32-bit pixels, the same way the renderer does.
+    void FilterTestMipMap(const u32 bits, const u32* channels, const BOOL gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst)
+    {
+        if (gamma) { InitializeRendererTextureMipMapGamma(&TestMipMapGamma); }
+
+        if (bits == 16) { FilterRendererTextureMipMap16(channels, gamma ? &TestMipMapGamma : NULL, src, pitch, width, height, dst); }
+        else { FilterRendererTextureMipMap32(gamma ? &TestMipMapGamma : NULL, src, pitch, width, height, dst); }
+    }
+}
@@ -0,0 +1,278 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#include "Tests.hxx"
+
+#define TEST_MIP_MAP_CHANNEL_COUNT 4
+#define TEST_MIP_MAP_PADDING 12
+#define TEST_MIP_MAP_BENCHMARK_TIME 0.25
+
+// NOTE: The filters of the SIMD build, and the ones of the scalar build, see R.DirectX.6.0.M.MipMaps.Filters.cxx.
+namespace RendererModule
+{
+    BOOL IsTestMipMapSIMD(void);
+    void FilterTestMipMap(const u32 bits, const u32* channels, const BOOL gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst);
+}
+
+namespace RendererModuleScalar
+{
+    BOOL IsTestMipMapSIMD(void);
+    void FilterTestMipMap(const u32 bits, const u32* channels, const BOOL gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst);
+}
+
+typedef void (*FILTERTESTMIPMAPCALL)(const u32 bits, const u32* channels, const BOOL gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst);
+
+struct TestMipMapFormat
+{
+    const char* Name;
+    u32 Bits;
+    u32 Channels[TEST_MIP_MAP_CHANNEL_COUNT]; // NOTE: The bit masks of the channels in R, G, B, A order.
+};
+
+const TestMipMapFormat TestMipMapFormats[] =
+{
+    { "R5G6B5", 16, { 0xF800, 0x07E0, 0x001F, 0x0000 } },
+    { "X1R5G5B5", 16, { 0x7C00, 0x03E0, 0x001F, 0x0000 } },
+    { "A1R5G5B5", 16, { 0x7C00, 0x03E0, 0x001F, 0x8000 } },
+    { "A4R4G4B4", 16, { 0x0F00, 0x00F0, 0x000F, 0xF000 } },
+    { "A8R8G8B8", 32, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 } }
+};
+
+u16 TestMipMapLinear[256];
+u8 TestMipMapEncoded[65536];
+
+u32 TestMipMapSeed = 0x6C8E9CF5;
+
+u32 AcquireTestMipMapRandom(void)
+{
+    TestMipMapSeed = TestMipMapSeed ^ (TestMipMapSeed << 13);
+    TestMipMapSeed = TestMipMapSeed ^ (TestMipMapSeed >> 17);
+    TestMipMapSeed = TestMipMapSeed ^ (TestMipMapSeed << 5);
+
+    return TestMipMapSeed;
+}
+
+// Filters the next mip map level pixel by pixel, channel by channel, as the reference for the filters of the renderer.
+void FilterTestMipMapReference(const TestMipMapFormat* format, const BOOL gamma, const u8* src, const u32 pitch, const u32 width, const u32 height, u8* dst)
+{
+    const u32 bytes = format->Bits >> 3;
+
+    const u32 w = 1 < width ? (width >> 1) : 1;
+    const u32 h = 1 < height ? (height >> 1) : 1;
+
+    for (u32 y = 0; y < h; y++)
+    {
+        for (u32 x = 0; x < w; x++)
+        {
+            const u32 xs[2] = { 2 * x, std::min(2 * x + 1, width - 1) };
+            const u32 ys[2] = { 2 * y, std::min(2 * y + 1, height - 1) };
+
+            u32 pixels[4];
+
+            for (u32 i = 0; i < 4; i++)
+            {
+                const u8* pixel = &src[ys[i >> 1] * pitch + xs[i & 1] * bytes];
+
+                pixels[i] = bytes == 2 ? *(u16*)pixel : *(u32*)pixel;
+            }
+
+            u32 value = 0;
+
+            for (u32 i = 0; i < TEST_MIP_MAP_CHANNEL_COUNT; i++)
+            {
+                const u32 channel = format->Channels[i];
+
+                if (channel == 0) { continue; }
+
+                u32 shift = 0;
+
+                while (!((channel >> shift) & 1)) { shift = shift + 1; }
+
+                const u32 mask = channel >> shift;
+
+                u32 sum = 0;
+
+                for (u32 ii = 0; ii < 4; ii++)
+                {
+                    const u32 color = (pixels[ii] >> shift) & mask;
+
+                    sum = sum + (gamma && i < 3 ? TestMipMapLinear[(color * 255 + (mask >> 1)) / mask] : color);
+                }
+
+                const u32 average = (sum + 2) >> 2;
+
+                value = value | ((gamma && i < 3 ? ((u32)TestMipMapEncoded[average] * mask + 127) / 255 : average) << shift);
+            }
+
+            if (bytes == 2) { *(u16*)&dst[(y * w + x) * bytes] = (u16)value; }
+            else { *(u32*)&dst[(y * w + x) * bytes] = value; }
+        }
+    }
+}
+
+// Filters all of the mip map levels of the pixels, each from the one above it, and appends them into the levels.
+void FilterTestMipMaps(FILTERTESTMIPMAPCALL filter, const TestMipMapFormat* format, const BOOL gamma, const std::vector<u8>& pixels, const u32 width, const u32 height, std::vector<std::vector<u8>>& levels)
+{
+    const u32 bytes = format->Bits >> 3;
+
+    const u8* src = pixels.data();
+    u32 pitch = width * bytes + TEST_MIP_MAP_PADDING;
+
+    u32 w = width;
+    u32 h = height;
+
+    levels.clear();
+
+    while (1 < w || 1 < h)
+    {
+        const u32 lw = 1 < w ? (w >> 1) : 1;
+        const u32 lh = 1 < h ? (h >> 1) : 1;
+
+        levels.emplace_back(lw * lh * bytes);
+
+        if (filter == NULL) { FilterTestMipMapReference(format, gamma, src, pitch, w, h, levels.back().data()); }
+        else { filter(format->Bits, format->Channels, gamma, src, pitch, w, h, levels.back().data()); }
+
+        src = levels.back().data();
+        pitch = lw * bytes;
+
+        w = lw;
+        h = lh;
+    }
+}
+
+// Fills the top level of the pixels, with the padding at the end of the rows, with the random values, and with the extremes of the channels.
+std::vector<u8> InitializeTestMipMapPixels(const TestMipMapFormat* format, const u32 width, const u32 height)
+{
+    std::vector<u8> result((width * (format->Bits >> 3) + TEST_MIP_MAP_PADDING) * height);
+
+    for (u32 x = 0; x < result.size(); x++)
+    {
+        const u32 value = AcquireTestMipMapRandom();
+
+        result[x] = (value & 0x700) == 0 ? ((value & 1) ? 0xFF : 0x00) : (u8)value;
+    }
+
+    return result;
+}
+
+// Compares the mip map levels of the SIMD and the scalar filters with the ones of the reference, for the sizes with the odd edges and the SIMD tails.
+void TestMipMaps(void)
+{
+    const u32 sizes[][2] = { { 1, 1 }, { 2, 2 }, { 3, 5 }, { 17, 9 }, { 33, 1 }, { 1, 33 }, { 64, 64 }, { 130, 66 }, { 256, 256 } };
+
+    CHECK(!RendererModuleScalar::IsTestMipMapSIMD());
+
+    for (u32 x = 0; x < sizeof(TestMipMapFormats) / sizeof(TestMipMapFormat); x++)
+    {
+        const TestMipMapFormat* format = &TestMipMapFormats[x];
+
+        for (u32 xx = 0; xx < sizeof(sizes) / sizeof(sizes[0]); xx++)
+        {
+            const u32 width = sizes[xx][0];
+            const u32 height = sizes[xx][1];
+
+            const std::vector<u8> pixels = InitializeTestMipMapPixels(format, width, height);
+
+            for (u32 gamma = FALSE; gamma <= TRUE; gamma++)
+            {
+                std::vector<std::vector<u8>> reference;
+                std::vector<std::vector<u8>> simd;
+                std::vector<std::vector<u8>> scalar;
+
+                FilterTestMipMaps(NULL, format, gamma, pixels, width, height, reference);
+                FilterTestMipMaps(RendererModule::FilterTestMipMap, format, gamma, pixels, width, height, simd);
+                FilterTestMipMaps(RendererModuleScalar::FilterTestMipMap, format, gamma, pixels, width, height, scalar);
+
+                if (simd != reference || scalar != reference)
+                {
+                    printf("%s %ux%u, %s filter: the levels differ from the reference.\n", format->Name, width, height, gamma ? "gamma-correct" : "box");
+
+                    TestFailures = TestFailures + 1;
+                }
+            }
+        }
+    }
+}
+
+// Returns the millions of the pixels of the top level per second, the mip map levels are filtered from.
+f64 AcquireTestMipMapSpeed(FILTERTESTMIPMAPCALL filter, const TestMipMapFormat* format, const BOOL gamma, const std::vector<u8>& pixels, const u32 size)
+{
+    std::vector<std::vector<u8>> levels;
+
+    u32 count = 0;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    f64 time = 0.0;
+
+    while (time < TEST_MIP_MAP_BENCHMARK_TIME)
+    {
+        FilterTestMipMaps(filter, format, gamma, pixels, size, size, levels);
+
+        count = count + 1;
+        time = AcquireTestTime(start);
+    }
+
+    return (f64)count * size * size / time / 1000000.0;
+}
+
+// Prints the speed of the generation of all of the mip map levels of the 256x256 and the 512x512 textures.
+void BenchmarkMipMaps(void)
+{
+    const u32 sizes[] = { 256, 512 };
+
+    printf("%-12s %8s %16s %16s %16s\n", "Format", "Size", "Box SIMD MP/s", "Box Scalar MP/s", "Gamma MP/s");
+
+    for (u32 x = 0; x < sizeof(TestMipMapFormats) / sizeof(TestMipMapFormat); x++)
+    {
+        const TestMipMapFormat* format = &TestMipMapFormats[x];
+
+        for (u32 xx = 0; xx < sizeof(sizes) / sizeof(u32); xx++)
+        {
+            const std::vector<u8> pixels = InitializeTestMipMapPixels(format, sizes[xx], sizes[xx]);
+
+            printf("%-12s %8u %16.1f %16.1f %16.1f\n", format->Name, sizes[xx],
+                AcquireTestMipMapSpeed(RendererModule::FilterTestMipMap, format, FALSE, pixels, sizes[xx]),
+                AcquireTestMipMapSpeed(RendererModuleScalar::FilterTestMipMap, format, FALSE, pixels, sizes[xx]),
+                AcquireTestMipMapSpeed(RendererModule::FilterTestMipMap, format, TRUE, pixels, sizes[xx]));
+        }
+    }
+}
+
+s32 main(s32 argc, char** argv)
+{
+    for (u32 x = 0; x < 256; x++) { TestMipMapLinear[x] = (u16)(pow((f64)x / 255.0, 2.2) * 65535.0 + 0.5); }
+    for (u32 x = 0; x < 65536; x++) { TestMipMapEncoded[x] = (u8)(pow((f64)x / 65535.0, 1.0 / 2.2) * 255.0 + 0.5); }
+
+    if (!RendererModule::IsTestMipMapSIMD()) { printf("R.DirectX.6.0.M.MipMaps: the SIMD paths are not available, the scalar paths are compared with the reference only.\n"); }
+
+    TestMipMaps();
+
+    if (IS_BENCHMARK(argc, argv)) { BenchmarkMipMaps(); }
+
+    return CompleteTest("R.DirectX.6.0.M.MipMaps");
+}
@@ -0,0 +1,167 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ImagePixels.hxx"
+#include "RendererCompression.hxx"
+#include "Tests.DXT.hxx"
+
+#define TEST_COMPRESSION_PIXEL_COUNT 4096
+
+// NOTE: The encoders of the scalar build, renamed into the RendererModuleScalar namespace, see CMakeLists.txt.
+namespace RendererModuleScalar
+{
+    void EncodeRendererTextureAlphas(const u32* pixels, u8* block);
+    void EncodeRendererTextureColors(const u32* pixels, u8* block, const BOOL transparent);
+}
+
+typedef void (*ENCODETESTALPHASCALL)(const u32* pixels, u8* block);
+typedef void (*ENCODETESTCOLORSCALL)(const u32* pixels, u8* block, const BOOL transparent);
+
+u32 TestCompressionSeed = 0x6C8E9CF5;
+
+u32 AcquireTestCompressionRandom(void)
+{
+    TestCompressionSeed = TestCompressionSeed ^ (TestCompressionSeed << 13);
+    TestCompressionSeed = TestCompressionSeed ^ (TestCompressionSeed >> 17);
+    TestCompressionSeed = TestCompressionSeed ^ (TestCompressionSeed << 5);
+
+    return TestCompressionSeed;
+}
+
+// Encodes the four rows of the pixels into the row of the blocks of the DXT format, same as EncodeRendererTextureBlocks does.
+// NOTE: The module encodes DXT2 and DXT3 blocks the same way, with the explicit alphas.
+u32 EncodeTestCompressionBlocks(ENCODETESTALPHASCALL alphas, ENCODETESTCOLORSCALL colors, const u32 format, const u32* pixels, const u32 count, u8* blocks)
+{
+    const u32 size = format == 1 ? 8 : 16;
+    const u32 length = count / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
+
+    u32 values[RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT];
+
+    for (u32 x = 0; x < count / RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; x++)
+    {
+        for (u32 xx = 0; xx < RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION; xx++)
+        {
+            memcpy(&values[xx * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION],
+                &pixels[xx * length + x * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION], RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION * sizeof(u32));
+        }
+
+        u8* block = (u8*)((addr)blocks + (addr)(x * size));
+
+        if (format == 1) { colors(values, block, TRUE); }
+        else
+        {
+            alphas(values, block);
+            colors(values, (u8*)((addr)block + (addr)8), FALSE);
+        }
+    }
+
+    return count / RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT * size;
+}
+
+// Compares the blocks the SIMD build encodes with the ones of the scalar build, over the random pixels, and over the gradients.
+void TestCompressionKernels(void)
+{
+    static u32 pixels[TEST_COMPRESSION_PIXEL_COUNT];
+    static u8 simd[TEST_COMPRESSION_PIXEL_COUNT];
+    static u8 scalar[TEST_COMPRESSION_PIXEL_COUNT];
+
+    const u32 formats[] = { 1, 3 };
+
+    for (u32 x = 0; x < 2; x++)
+    {
+        if (x == 0) { for (u32 xx = 0; xx < TEST_COMPRESSION_PIXEL_COUNT; xx++) { pixels[xx] = AcquireTestCompressionRandom(); } }
+        else { InitializeTestDXTGradients(pixels, TEST_COMPRESSION_PIXEL_COUNT, AcquireTestCompressionRandom); }
+
+        for (u32 xx = 0; xx < sizeof(formats) / sizeof(u32); xx++)
+        {
+            const u32 size = EncodeTestCompressionBlocks(RendererModule::EncodeRendererTextureAlphas,
+                RendererModule::EncodeRendererTextureColors, formats[xx], pixels, TEST_COMPRESSION_PIXEL_COUNT, simd);
+
+            CHECK(size == EncodeTestCompressionBlocks(RendererModuleScalar::EncodeRendererTextureAlphas,
+                RendererModuleScalar::EncodeRendererTextureColors, formats[xx], pixels, TEST_COMPRESSION_PIXEL_COUNT, scalar));
+
+            for (u32 xxx = 0; xxx < size; xxx++)
+            {
+                if (simd[xxx] != scalar[xxx])
+                {
+                    printf("Encode DXT%u Blocks: %s, byte %u is 0x%02X instead of 0x%02X.\n",
+                        formats[xx], x == 0 ? "random pixels" : "gradients", xxx, simd[xxx], scalar[xxx]);
+
+                    TestFailures = TestFailures + 1;
+
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Encodes the gradients into the DXT blocks, and checks the pixels decoded from the blocks against the gradients.
+// NOTE: The blocks are decoded with the decoders of R.DirectX.8.0.MC, which R.DirectX.8.0.MC.Images checks.
+void TestCompressionDXT(void)
+{
+    static u32 pixels[TEST_COMPRESSION_PIXEL_COUNT];
+    static u8 blocks[TEST_COMPRESSION_PIXEL_COUNT];
+    static u32 decoded[TEST_COMPRESSION_PIXEL_COUNT];
+
+    InitializeTestDXTGradients(pixels, TEST_COMPRESSION_PIXEL_COUNT, AcquireTestCompressionRandom);
+
+    const u32 formats[] = { 1, 3 };
+    const char* names[] = { "Encode DXT1 Blocks", "Encode DXT3 Blocks" };
+
+    const u32 length = TEST_COMPRESSION_PIXEL_COUNT / RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION;
+
+    for (u32 x = 0; x < sizeof(formats) / sizeof(u32); x++)
+    {
+        const u32 size = formats[x] == 1 ? 8 : 16;
+
+        EncodeTestCompressionBlocks(RendererModule::EncodeRendererTextureAlphas,
+            RendererModule::EncodeRendererTextureColors, formats[x], pixels, TEST_COMPRESSION_PIXEL_COUNT, blocks);
+
+        for (u32 xx = 0; xx < TEST_COMPRESSION_PIXEL_COUNT / RENDERER_TEXTURE_COMPRESSION_BLOCK_PIXEL_COUNT; xx++)
+        {
+            const u8* block = &blocks[xx * size];
+            u32* values = &decoded[xx * RENDERER_TEXTURE_COMPRESSION_BLOCK_DIMENSION];
+
+            if (formats[x] == 1) { Images::DecodeImageDXTColors(block, values, length * sizeof(u32), TRUE); }
+            else
+            {
+                Images::DecodeImageDXTColors((u8*)((addr)block + (addr)8), values, length * sizeof(u32), FALSE);
+                Images::DecodeImageDXTExplicitAlphas(block, values, length * sizeof(u32));
+            }
+        }
+
+        CheckTestDXTPixels(names[x], formats[x], pixels, decoded, TEST_COMPRESSION_PIXEL_COUNT);
+    }
+}
+
+s32 main(s32 argc, char** argv)
+{
+#ifndef RENDERER_MODULE_SIMD
+    printf("R.DirectX.7.0.M.Compression: the SIMD paths are not available, the scalar paths are compared with themselves.\n");
+#endif
+
+    TestCompressionKernels();
+    TestCompressionDXT();
+
+    return CompleteTest("R.DirectX.7.0.M.Compression");
+}
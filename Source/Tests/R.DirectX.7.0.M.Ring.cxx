@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <thread>
+
+#include "Tests.hxx"
+#include "RendererRing.hxx"
+
+using namespace RendererModule;
+
+#define TEST_RING_SLOT_COUNT 16
+#define TEST_RING_COMMAND_COUNT 4000000
+
+// Checks the empty and the full states of the ring, including the wrap around of the positions.
+void TestRingBounds(const u32 start)
+{
+    RendererRing ring;
+
+    InitializeRendererRing(&ring, TEST_RING_SLOT_COUNT);
+
+    ring.Read = start;
+    ring.Write = start;
+
+    CHECK(IsRendererRingEmpty(&ring));
+    CHECK(!IsRendererRingFull(&ring));
+
+    for (u32 x = 0; x < TEST_RING_SLOT_COUNT; x++)
+    {
+        CHECK(!IsRendererRingFull(&ring));
+        CHECK(AcquireRendererRingWrite(&ring) == ((start + x) % TEST_RING_SLOT_COUNT));
+
+        CommitRendererRingWrite(&ring);
+
+        CHECK(!IsRendererRingEmpty(&ring));
+    }
+
+    CHECK(IsRendererRingFull(&ring));
+
+    for (u32 x = 0; x < TEST_RING_SLOT_COUNT; x++)
+    {
+        CHECK(!IsRendererRingEmpty(&ring));
+        CHECK(AcquireRendererRingRead(&ring) == ((start + x) % TEST_RING_SLOT_COUNT));
+
+        CommitRendererRingRead(&ring);
+
+        CHECK(!IsRendererRingFull(&ring));
+    }
+
+    CHECK(IsRendererRingEmpty(&ring));
+}
+
+// Hands the sequence of the commands over from the producer to the mock consumer, which checks that none is lost, repeated, or reordered.
+// Both of the sides spin instead of waiting on the events, so that they interleave as often as possible.
+void TestRingStress(const u32 start)
+{
+    RendererRing ring;
+    u32 slots[TEST_RING_SLOT_COUNT];
+
+    InitializeRendererRing(&ring, TEST_RING_SLOT_COUNT);
+
+    ring.Read = start;
+    ring.Write = start;
+
+    u32 mismatches = 0;
+
+    std::thread consumer([&]()
+        {
+            for (u32 x = 0; x < TEST_RING_COMMAND_COUNT; x++)
+            {
+                while (IsRendererRingEmpty(&ring)) { std::this_thread::yield(); }
+
+                if (slots[AcquireRendererRingRead(&ring)] != x) { mismatches = mismatches + 1; }
+
+                // NOTE: The slot is overwritten once it is released, which the producer must not do earlier.
+                slots[AcquireRendererRingRead(&ring)] = U32_MAX;
+
+                CommitRendererRingRead(&ring);
+            }
+        });
+
+    for (u32 x = 0; x < TEST_RING_COMMAND_COUNT; x++)
+    {
+        while (IsRendererRingFull(&ring)) { std::this_thread::yield(); }
+
+        slots[AcquireRendererRingWrite(&ring)] = x;
+
+        CommitRendererRingWrite(&ring);
+    }
+
+    consumer.join();
+
+    CHECK(mismatches == 0);
+    CHECK(IsRendererRingEmpty(&ring));
+    CHECK(ring.Write == start + TEST_RING_COMMAND_COUNT);
+}
+
+s32 main(s32 argc, char** argv)
+{
+    TestRingBounds(0);
+    TestRingBounds(U32_MAX - TEST_RING_SLOT_COUNT / 2);
+
+    TestRingStress(0);
+    TestRingStress(U32_MAX - TEST_RING_COMMAND_COUNT / 2);
+
+    return CompleteTest("R.DirectX.7.0.M.Ring");
+}
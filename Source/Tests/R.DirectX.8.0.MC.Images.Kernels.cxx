@@ -0,0 +1,270 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ImagePixels.hxx"
+
+#include <string.h>
+
+// NOTE: The unit is built twice, along with the kernels, once with the SIMD paths and once without them,
+// the scalar build is renamed into the ImagesScalar namespace, so that both of the builds are linked together.
+namespace Images
+{
+    typedef void (*READTESTIMAGEPIXELSCALL)(const void* pixels, u32* colors, const u32 count, const u32* palette);
+    typedef void (*WRITETESTIMAGEPIXELSCALL)(const u32* colors, void* pixels, const u32 count, const u32* palette);
+    typedef u32 (*RUNTESTIMAGEKERNELCALL)(const u32* colors, const u32 count, const u32* palette, u8* output);
+
+    struct TestImageKernel
+    {
+        const char* Name;
+        RUNTESTIMAGEKERNELCALL Run;
+    };
+
+    // Reads the colors, taken as the pixels of the format, into the output.
+    template <READTESTIMAGEPIXELSCALL READ>
+    u32 RunTestImageRead(const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        READ(colors, (u32*)output, count, palette);
+
+        return count * sizeof(u32);
+    }
+
+    // Writes the colors as the pixels of the format into the output.
+    template <WRITETESTIMAGEPIXELSCALL WRITE>
+    u32 RunTestImageWrite(const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        memset(output, 0, count * sizeof(u32));
+
+        WRITE(colors, output, count, palette);
+
+        return count * sizeof(u32);
+    }
+
+    // Decodes the colors, taken as the row of the blocks of 16 bytes, into the four rows of the pixels.
+    template <u32 MODE>
+    u32 RunTestImageDecode(const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        const u32 blocks = count / IMAGE_DXT_DIMENSION_SEGMENT;
+        const u32 stride = blocks * IMAGE_DXT_DIMENSION * sizeof(u32);
+
+        memset(output, 0, count * sizeof(u32));
+
+        for (u32 x = 0; x < blocks; x++)
+        {
+            const u8* block = (u8*)((addr)colors + (addr)(x * IMAGE_DXT_DIMENSION_SEGMENT));
+            u32* pixels = (u32*)((addr)output + (addr)(x * IMAGE_DXT_DIMENSION * sizeof(u32)));
+
+            switch (MODE)
+            {
+            case 0: { DecodeImageDXTColors(block, pixels, stride, FALSE); break; }
+            case 1: { DecodeImageDXTColors(block, pixels, stride, TRUE); break; }
+            case 2: { DecodeImageDXTExplicitAlphas(block, pixels, stride); break; }
+            case 3: { DecodeImageDXTInterpolatedAlphas(block, pixels, stride); break; }
+            }
+        }
+
+        return count * sizeof(u32);
+    }
+
+    // Decodes the colors, taken as the row of the blocks of the DXT format, into the four rows of the pixels, same as DecodeImageDXTBlocks does.
+    template <u32 FORMAT>
+    u32 RunTestImageDecodeBlocks(const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        const u32 blocks = count / IMAGE_DXT_DIMENSION_SEGMENT;
+        const u32 size = FORMAT == 1 ? 8 : 16;
+        const u32 stride = blocks * IMAGE_DXT_DIMENSION * sizeof(u32);
+
+        for (u32 x = 0; x < blocks; x++)
+        {
+            const u8* block = (u8*)((addr)colors + (addr)(x * size));
+            u32* pixels = (u32*)((addr)output + (addr)(x * IMAGE_DXT_DIMENSION * sizeof(u32)));
+
+            switch (FORMAT)
+            {
+            case 1: { DecodeImageDXTColors(block, pixels, stride, TRUE); break; }
+            case 3:
+            {
+                DecodeImageDXTColors((u8*)((addr)block + (addr)8), pixels, stride, FALSE);
+                DecodeImageDXTExplicitAlphas(block, pixels, stride);
+
+                break;
+            }
+            case 5:
+            {
+                DecodeImageDXTColors((u8*)((addr)block + (addr)8), pixels, stride, FALSE);
+                DecodeImageDXTInterpolatedAlphas(block, pixels, stride);
+
+                break;
+            }
+            }
+        }
+
+        return blocks * IMAGE_DXT_DIMENSION_SEGMENT * sizeof(u32);
+    }
+
+    // Encodes the colors, taken as the 4x4 pixels of the blocks, into the blocks of 8 bytes.
+    template <u32 MODE>
+    u32 RunTestImageEncode(const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        const u32 blocks = count / IMAGE_DXT_DIMENSION_SEGMENT;
+
+        memset(output, 0, blocks * 8);
+
+        for (u32 x = 0; x < blocks; x++)
+        {
+            const u32* pixels = &colors[x * IMAGE_DXT_DIMENSION_SEGMENT];
+            u8* block = (u8*)((addr)output + (addr)(x * 8));
+
+            switch (MODE)
+            {
+            case 0: { EncodeImageDXTColors(pixels, block, FALSE); break; }
+            case 1: { EncodeImageDXTColors(pixels, block, TRUE); break; }
+            case 2: { EncodeImageDXTExplicitAlphas(pixels, block); break; }
+            case 3: { EncodeImageDXTInterpolatedAlphas(pixels, block); break; }
+            }
+        }
+
+        return blocks * 8;
+    }
+
+    // Encodes the colors, taken as the four rows of the pixels, into the row of the blocks of the DXT format, same as EncodeImageDXTBlocks does.
+    template <u32 FORMAT>
+    u32 RunTestImageEncodeBlocks(const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        const u32 blocks = count / IMAGE_DXT_DIMENSION_SEGMENT;
+        const u32 size = FORMAT == 1 ? 8 : 16;
+        const u32 length = blocks * IMAGE_DXT_DIMENSION;
+
+        u32 values[IMAGE_DXT_DIMENSION_SEGMENT];
+
+        for (u32 x = 0; x < blocks; x++)
+        {
+            for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION; xx++)
+            {
+                memcpy(&values[xx * IMAGE_DXT_DIMENSION], &colors[xx * length + x * IMAGE_DXT_DIMENSION], IMAGE_DXT_DIMENSION * sizeof(u32));
+            }
+
+            u8* block = (u8*)((addr)output + (addr)(x * size));
+
+            switch (FORMAT)
+            {
+            case 1: { EncodeImageDXTColors(values, block, TRUE); break; }
+            case 3:
+            {
+                EncodeImageDXTExplicitAlphas(values, block);
+                EncodeImageDXTColors(values, (u8*)((addr)block + (addr)8), FALSE);
+
+                break;
+            }
+            case 5:
+            {
+                EncodeImageDXTInterpolatedAlphas(values, block);
+                EncodeImageDXTColors(values, (u8*)((addr)block + (addr)8), FALSE);
+
+                break;
+            }
+            }
+        }
+
+        return blocks * size;
+    }
+
+#define TEST_IMAGE_FORMAT(F) { "Read " #F, RunTestImageRead<ReadImage##F> }, { "Write " #F, RunTestImageWrite<WriteImage##F> }
+
+    TestImageKernel TestImageKernels[] =
+    {
+        TEST_IMAGE_FORMAT(A1R5G5B5),
+        TEST_IMAGE_FORMAT(A4L4),
+        TEST_IMAGE_FORMAT(A4R4G4B4),
+        TEST_IMAGE_FORMAT(A8),
+        TEST_IMAGE_FORMAT(A8L8),
+        TEST_IMAGE_FORMAT(A8P8),
+        TEST_IMAGE_FORMAT(A8R3G3B2),
+        TEST_IMAGE_FORMAT(A8R8G8B8),
+        TEST_IMAGE_FORMAT(L6V5U5),
+        TEST_IMAGE_FORMAT(L8),
+        TEST_IMAGE_FORMAT(P8),
+        TEST_IMAGE_FORMAT(Q8W8V8U8),
+        TEST_IMAGE_FORMAT(R3G3B2),
+        TEST_IMAGE_FORMAT(R5G6B5),
+        TEST_IMAGE_FORMAT(R8G8B8),
+        TEST_IMAGE_FORMAT(UYVY),
+        TEST_IMAGE_FORMAT(V16U16),
+        TEST_IMAGE_FORMAT(V8U8),
+        TEST_IMAGE_FORMAT(W11V11U10),
+        TEST_IMAGE_FORMAT(X1R5G5B5),
+        TEST_IMAGE_FORMAT(X4R4G4B4),
+        TEST_IMAGE_FORMAT(X8L8V8U8),
+        TEST_IMAGE_FORMAT(X8R8G8B8),
+        TEST_IMAGE_FORMAT(YUY2),
+        { "Decode DXT Colors", RunTestImageDecode<0> },
+        { "Decode DXT1 Colors", RunTestImageDecode<1> },
+        { "Decode DXT Explicit Alphas", RunTestImageDecode<2> },
+        { "Decode DXT Interpolated Alphas", RunTestImageDecode<3> },
+        { "Decode DXT1 Blocks", RunTestImageDecodeBlocks<1> },
+        { "Decode DXT3 Blocks", RunTestImageDecodeBlocks<3> },
+        { "Decode DXT5 Blocks", RunTestImageDecodeBlocks<5> },
+        { "Encode DXT Colors", RunTestImageEncode<0> },
+        { "Encode DXT1 Colors", RunTestImageEncode<1> },
+        { "Encode DXT Explicit Alphas", RunTestImageEncode<2> },
+        { "Encode DXT Interpolated Alphas", RunTestImageEncode<3> },
+        { "Encode DXT1 Blocks", RunTestImageEncodeBlocks<1> },
+        { "Encode DXT3 Blocks", RunTestImageEncodeBlocks<3> },
+        { "Encode DXT5 Blocks", RunTestImageEncodeBlocks<5> }
+    };
+
+    // Returns TRUE when the kernels of the build use the SIMD paths.
+    BOOL IsTestImageKernelSIMD(void)
+    {
+#ifdef RENDERER_MODULE_SIMD
+        return TRUE;
+#else
+        return FALSE;
+#endif
+    }
+
+    u32 AcquireTestImageKernelCount(void)
+    {
+        return sizeof(TestImageKernels) / sizeof(TestImageKernel);
+    }
+
+    const char* AcquireTestImageKernelName(const u32 index)
+    {
+        return TestImageKernels[index].Name;
+    }
+
+    // Returns the index of the kernel of the name, or the number of the kernels when there is none.
+    u32 AcquireTestImageKernelIndex(const char* name)
+    {
+        u32 x = 0;
+
+        while (x < AcquireTestImageKernelCount() && strcmp(TestImageKernels[x].Name, name) != 0) { x = x + 1; }
+
+        return x;
+    }
+
+    // Runs the kernel over the count of the colors, and returns the number of the bytes written into the output.
+    // NOTE: The output has to hold at least as many bytes as the colors do.
+    u32 RunTestImageKernel(const u32 index, const u32* colors, const u32 count, const u32* palette, u8* output)
+    {
+        return TestImageKernels[index].Run(colors, count, palette, output);
+    }
+}
@@ -0,0 +1,280 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "ImagePixels.hxx"
+#include "Tests.DXT.hxx"
+
+#define TEST_IMAGE_PIXEL_COUNT 4096
+#define TEST_IMAGE_PALETTE_COUNT 256
+#define TEST_IMAGE_BENCHMARK_TIME 0.25
+#define TEST_IMAGE_DXT_SIZE 1024
+#define MAX_TEST_IMAGE_DXT_THREAD_COUNT 64
+
+// NOTE: The kernels of the SIMD build, and the ones of the scalar build, see R.DirectX.8.0.MC.Images.Kernels.cxx.
+namespace Images
+{
+    BOOL IsTestImageKernelSIMD(void);
+    u32 AcquireTestImageKernelCount(void);
+    const char* AcquireTestImageKernelName(const u32 index);
+    u32 AcquireTestImageKernelIndex(const char* name);
+    u32 RunTestImageKernel(const u32 index, const u32* colors, const u32 count, const u32* palette, u8* output);
+}
+
+namespace ImagesScalar
+{
+    BOOL IsTestImageKernelSIMD(void);
+    u32 AcquireTestImageKernelCount(void);
+    const char* AcquireTestImageKernelName(const u32 index);
+    u32 AcquireTestImageKernelIndex(const char* name);
+    u32 RunTestImageKernel(const u32 index, const u32* colors, const u32 count, const u32* palette, u8* output);
+}
+
+u32 TestImageSeed = 0x2545F491;
+
+u32 AcquireTestImageRandom(void)
+{
+    TestImageSeed = TestImageSeed ^ (TestImageSeed << 13);
+    TestImageSeed = TestImageSeed ^ (TestImageSeed >> 17);
+    TestImageSeed = TestImageSeed ^ (TestImageSeed << 5);
+
+    return TestImageSeed;
+}
+
+// Fills the colors with the random values, mixed with the extremes of the channels,
+// and with the blocks of a single color, and of a single alpha, for the special cases of the DXT encoders.
+void InitializeTestImageColors(u32* colors, const u32 count)
+{
+    const u32 extremes[] = { 0x00000000, 0xFFFFFFFF, 0x80808080, 0x7F7F7F7F, 0x00FFFFFF, 0xFF000000, 0x01010101, 0xFEFEFEFE };
+
+    for (u32 x = 0; x < count; x++)
+    {
+        const u32 value = AcquireTestImageRandom();
+
+        colors[x] = (value & 0x7) == 0 ? extremes[(value >> 3) & 0x7] : value;
+    }
+
+    for (u32 x = 0; x + 4 * IMAGE_DXT_DIMENSION_SEGMENT <= count; x = x + 4 * IMAGE_DXT_DIMENSION_SEGMENT)
+    {
+        const u32 color = colors[x];
+        const u32 alpha = colors[x + IMAGE_DXT_DIMENSION_SEGMENT] & 0xFF000000;
+
+        for (u32 xx = 0; xx < IMAGE_DXT_DIMENSION_SEGMENT; xx++)
+        {
+            colors[x + xx] = color;
+            colors[x + IMAGE_DXT_DIMENSION_SEGMENT + xx] = alpha | (colors[x + IMAGE_DXT_DIMENSION_SEGMENT + xx] & 0x00FFFFFF);
+        }
+    }
+}
+
+// Compares the output of the SIMD kernels with the one of the scalar kernels, over the counts that cover all of the remainders of the SIMD loops.
+void TestImageKernels(const u32* palette)
+{
+    static u32 colors[TEST_IMAGE_PIXEL_COUNT];
+    static u8 simd[TEST_IMAGE_PIXEL_COUNT * sizeof(u32)];
+    static u8 scalar[TEST_IMAGE_PIXEL_COUNT * sizeof(u32)];
+
+    CHECK(Images::AcquireTestImageKernelCount() == ImagesScalar::AcquireTestImageKernelCount());
+    CHECK(!ImagesScalar::IsTestImageKernelSIMD());
+
+    const u32 counts[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 4093, TEST_IMAGE_PIXEL_COUNT };
+
+    for (u32 x = 0; x < sizeof(counts) / sizeof(u32); x++)
+    {
+        InitializeTestImageColors(colors, counts[x]);
+
+        for (u32 xx = 0; xx < Images::AcquireTestImageKernelCount(); xx++)
+        {
+            const u32 size = Images::RunTestImageKernel(xx, colors, counts[x], palette, simd);
+
+            CHECK(size == ImagesScalar::RunTestImageKernel(xx, colors, counts[x], palette, scalar));
+
+            for (u32 xxx = 0; xxx < size; xxx++)
+            {
+                if (simd[xxx] != scalar[xxx])
+                {
+                    printf("%s: %u pixel(s), byte %u is 0x%02X instead of 0x%02X.\n",
+                        Images::AcquireTestImageKernelName(xx), counts[x], xxx, simd[xxx], scalar[xxx]);
+
+                    TestFailures = TestFailures + 1;
+
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Encodes the gradients into the DXT blocks, and checks the pixels decoded from the blocks against the gradients.
+void TestImageDXT(const u32* palette)
+{
+    static u32 colors[TEST_IMAGE_PIXEL_COUNT];
+    static u32 blocks[TEST_IMAGE_PIXEL_COUNT];
+    static u32 decoded[TEST_IMAGE_PIXEL_COUNT];
+
+    InitializeTestDXTGradients(colors, TEST_IMAGE_PIXEL_COUNT, AcquireTestImageRandom);
+
+    const u32 formats[] = { 1, 3, 5 };
+
+    const char* encoders[] = { "Encode DXT1 Blocks", "Encode DXT3 Blocks", "Encode DXT5 Blocks" };
+    const char* decoders[] = { "Decode DXT1 Blocks", "Decode DXT3 Blocks", "Decode DXT5 Blocks" };
+
+    for (u32 x = 0; x < sizeof(formats) / sizeof(u32); x++)
+    {
+        memset(blocks, 0, sizeof(blocks));
+
+        Images::RunTestImageKernel(Images::AcquireTestImageKernelIndex(encoders[x]), colors, TEST_IMAGE_PIXEL_COUNT, palette, (u8*)blocks);
+        Images::RunTestImageKernel(Images::AcquireTestImageKernelIndex(decoders[x]), blocks, TEST_IMAGE_PIXEL_COUNT, palette, (u8*)decoded);
+
+        CheckTestDXTPixels(encoders[x], formats[x], colors, decoded, TEST_IMAGE_PIXEL_COUNT);
+    }
+}
+
+// Returns the millions of the pixels per second the kernel converts.
+f64 AcquireTestImageKernelSpeed(u32 (*run)(const u32, const u32*, const u32, const u32*, u8*), const u32 index, const u32* colors, const u32* palette, u8* output)
+{
+    u32 count = 0;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    f64 time = 0.0;
+
+    while (time < TEST_IMAGE_BENCHMARK_TIME)
+    {
+        for (u32 x = 0; x < 16; x++) { run(index, colors, TEST_IMAGE_PIXEL_COUNT, palette, output); }
+
+        count = count + 16;
+        time = AcquireTestTime(start);
+    }
+
+    return (f64)count * TEST_IMAGE_PIXEL_COUNT / time / 1000000.0;
+}
+
+// Prints the speed of the SIMD kernels and of the scalar ones.
+void BenchmarkImageKernels(const u32* palette)
+{
+    static u32 colors[TEST_IMAGE_PIXEL_COUNT];
+    static u8 output[TEST_IMAGE_PIXEL_COUNT * sizeof(u32)];
+
+    InitializeTestImageColors(colors, TEST_IMAGE_PIXEL_COUNT);
+
+    printf("%-32s %12s %12s %8s\n", "Kernel", "SIMD MP/s", "Scalar MP/s", "Ratio");
+
+    for (u32 x = 0; x < Images::AcquireTestImageKernelCount(); x++)
+    {
+        const f64 simd = AcquireTestImageKernelSpeed(Images::RunTestImageKernel, x, colors, palette, output);
+        const f64 scalar = AcquireTestImageKernelSpeed(ImagesScalar::RunTestImageKernel, x, colors, palette, output);
+
+        printf("%-32s %12.1f %12.1f %7.2fx\n", Images::AcquireTestImageKernelName(x), simd, scalar, simd / scalar);
+    }
+}
+
+// Prints the speed of the decoding of the whole DXT images, with the rows of the blocks split across the threads, same as CopyImageDXT does.
+// NOTE: The threads are started for every image, as CopyImageDXT does, and the counts above the number of the processors show the cost
+// of the oversubscription, that is of splitting the images, while all of the processors are busy with the other images.
+void BenchmarkImageDXT(const u32* palette)
+{
+    // NOTE: The row of the blocks of the image is decoded into the row of the pixels of the benchmark.
+    const u32 rows = TEST_IMAGE_DXT_SIZE / IMAGE_DXT_DIMENSION;
+    const u32 length = TEST_IMAGE_DXT_SIZE * IMAGE_DXT_DIMENSION;
+
+    static_assert(TEST_IMAGE_DXT_SIZE * IMAGE_DXT_DIMENSION == TEST_IMAGE_PIXEL_COUNT);
+
+    std::vector<u32> blocks(rows * length);
+
+    InitializeTestImageColors(blocks.data(), (u32)blocks.size());
+
+    const u32 processors = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::vector<u32> counts = { 1, 2, 4, processors, 2 * processors, 4 * processors };
+
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+
+    std::vector<std::vector<u8>> outputs(MAX_TEST_IMAGE_DXT_THREAD_COUNT, std::vector<u8>(length * sizeof(u32)));
+
+    printf("%-32s %12s %12s\n", "Image", "Threads", "MP/s");
+
+    const char* names[] = { "Decode DXT1 Blocks", "Decode DXT3 Blocks", "Decode DXT5 Blocks" };
+
+    for (u32 x = 0; x < sizeof(names) / sizeof(const char*); x++)
+    {
+        const u32 index = Images::AcquireTestImageKernelIndex(names[x]);
+
+        for (u32 xx = 0; xx < counts.size() && counts[xx] <= MAX_TEST_IMAGE_DXT_THREAD_COUNT; xx++)
+        {
+            const u32 count = counts[xx];
+
+            u32 images = 0;
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            f64 time = 0.0;
+
+            while (time < TEST_IMAGE_BENCHMARK_TIME)
+            {
+                std::vector<std::thread> threads;
+
+                for (u32 i = 0; i < count; i++)
+                {
+                    threads.emplace_back([&, i]()
+                        {
+                            for (u32 row = rows * i / count; row < rows * (i + 1) / count; row++)
+                            {
+                                Images::RunTestImageKernel(index, &blocks[row * length], length, palette, outputs[i].data());
+                            }
+                        });
+                }
+
+                for (u32 i = 0; i < count; i++) { threads[i].join(); }
+
+                images = images + 1;
+                time = AcquireTestTime(start);
+            }
+
+            printf("%-32s %12u %12.1f\n", names[x], count, (f64)images * TEST_IMAGE_DXT_SIZE * TEST_IMAGE_DXT_SIZE / time / 1000000.0);
+        }
+    }
+}
+
+s32 main(s32 argc, char** argv)
+{
+    u32 palette[TEST_IMAGE_PALETTE_COUNT];
+
+    for (u32 x = 0; x < TEST_IMAGE_PALETTE_COUNT; x++) { palette[x] = AcquireTestImageRandom(); }
+
+    if (!Images::IsTestImageKernelSIMD()) { printf("R.DirectX.8.0.MC.Images: the SIMD paths are not available, the scalar paths are compared with themselves.\n"); }
+
+    TestImageKernels(palette);
+    TestImageDXT(palette);
+
+    if (IS_BENCHMARK(argc, argv))
+    {
+        BenchmarkImageKernels(palette);
+        BenchmarkImageDXT(palette);
+    }
+
+    return CompleteTest("R.DirectX.8.0.MC.Images");
+}
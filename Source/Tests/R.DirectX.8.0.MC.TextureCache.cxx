@@ -0,0 +1,147 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Tests.hxx"
+#include "RendererTextureCache.hxx"
+
+using namespace RendererModule;
+
+#define TEST_CACHE_CAPACITY (1024 * 1024)
+
+static RendererTextureCacheHeader Header;
+
+// Resets the header into the clean one, with the three adjacent entries.
+void InitializeTestHeader(void)
+{
+    InitializeRendererTextureCacheHeader(&Header, TEST_CACHE_CAPACITY);
+
+    for (u32 x = 0; x < 3; x++)
+    {
+        RendererTextureCacheEntry* entry = &Header.Entries[x];
+
+        entry->Hash = 0x1000 + x;
+        entry->Source = 21; // NOTE: D3DFMT_A8R8G8B8.
+        entry->Destination = 0x31545844; // NOTE: D3DFMT_DXT1.
+        entry->Width = 64;
+        entry->Height = 64;
+        entry->Levels = 1;
+        entry->Offset = x * 4096;
+        entry->Size = 4096;
+        entry->Tick = x + 1;
+    }
+
+    Header.Count = 3;
+    Header.Size = 3 * 4096;
+    Header.Tick = 3;
+}
+
+// Writes the header, followed by the zeroed data of the capacity, into the file, the way the renderer maps it.
+BOOL WriteTestCache(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+
+    if (file == NULL) { return FALSE; }
+
+    BOOL result = fwrite(&Header, sizeof(RendererTextureCacheHeader), 1, file) == 1;
+
+    u8* data = (u8*)calloc(TEST_CACHE_CAPACITY, 1);
+
+    result = result && data != NULL && fwrite(data, TEST_CACHE_CAPACITY, 1, file) == 1;
+
+    free(data);
+    fclose(file);
+
+    return result;
+}
+
+void TestValidation(void)
+{
+    InitializeTestHeader();
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_VALID);
+
+    // NOTE: The file of the other capacity, or of the other version, is reset.
+    CHECK(AcquireRendererTextureCacheState(&Header, 2 * TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_CAPACITY);
+
+    Header.Version = TEXTURE_CACHE_VERSION - 1;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_HEADER);
+
+    // NOTE: The file left open by the crashed game is reset.
+    InitializeTestHeader();
+    Header.IsDirty = TRUE;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_DIRTY);
+
+    InitializeTestHeader();
+    Header.Count = MAX_TEXTURE_CACHE_ENTRY_COUNT + 1;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_HEADER);
+
+    InitializeTestHeader();
+    Header.Size = TEST_CACHE_CAPACITY + 1;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_HEADER);
+
+    // NOTE: The entry past the data in use.
+    InitializeTestHeader();
+    Header.Entries[2].Size = 8192;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_ENTRY);
+
+    // NOTE: The entry, which end wraps around past zero.
+    InitializeTestHeader();
+    Header.Entries[2].Offset = U32_MAX - 1024;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_ENTRY);
+
+    InitializeTestHeader();
+    Header.Entries[1].Size = U32_MAX;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_ENTRY);
+
+    // NOTE: The entries overlapping each other.
+    InitializeTestHeader();
+    Header.Entries[1].Offset = 2048;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_ENTRY);
+
+    // NOTE: The entries out of the order of their offsets.
+    InitializeTestHeader();
+    Header.Entries[0].Offset = 8192;
+    Header.Entries[2].Offset = 0;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_INVALID_ENTRY);
+
+    // NOTE: The gaps between the entries are allowed.
+    InitializeTestHeader();
+    Header.Entries[0].Size = 1024;
+    CHECK(AcquireRendererTextureCacheState(&Header, TEST_CACHE_CAPACITY) == TEXTURE_CACHE_STATE_VALID);
+}
+
+// Writes the sample cache files for the inspection tool.
+void TestFiles(void)
+{
+    InitializeTestHeader();
+    CHECK(WriteTestCache("TextureCache.Valid.cache"));
+
+    Header.IsDirty = TRUE;
+    CHECK(WriteTestCache("TextureCache.Dirty.cache"));
+}
+
+s32 main(s32 argc, char** argv)
+{
+    TestValidation();
+    TestFiles();
+
+    return CompleteTest("R.DirectX.8.0.MC.TextureCache");
+}
@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "Tests.hxx"
+#include "RendererMesh.hxx"
+
+using namespace RendererModule;
+
+#define TEST_MESH_GRID_SIZE 128
+#define TEST_MESH_SOUP_VERTEX_COUNT 4096
+#define TEST_MESH_SOUP_TRIANGLE_COUNT 16384
+#define TEST_MESH_BENCHMARK_TIME 0.5
+
+struct TestMesh
+{
+    const char* Name;
+    u32 VertexCount;
+    std::vector<u16> Indexes;
+};
+
+u32 TestMeshSeed = 0x9E3779B9;
+
+u32 AcquireTestMeshRandom(void)
+{
+    TestMeshSeed = TestMeshSeed ^ (TestMeshSeed << 13);
+    TestMeshSeed = TestMeshSeed ^ (TestMeshSeed >> 17);
+    TestMeshSeed = TestMeshSeed ^ (TestMeshSeed << 5);
+
+    return TestMeshSeed;
+}
+
+// Creates the grid of the quads of two triangles each, in the order of the rows.
+TestMesh InitializeTestMeshGrid(const char* name, const u32 size)
+{
+    TestMesh mesh = { name, size * size };
+
+    for (u32 y = 0; y < size - 1; y++)
+    {
+        for (u32 x = 0; x < size - 1; x++)
+        {
+            const u16 a = (u16)(y * size + x);
+            const u16 b = (u16)(a + 1);
+            const u16 c = (u16)(a + size);
+            const u16 d = (u16)(c + 1);
+
+            mesh.Indexes.insert(mesh.Indexes.end(), { a, c, b, b, c, d });
+        }
+    }
+
+    return mesh;
+}
+
+// Shuffles the triangles of the mesh, and rotates their vertexes, keeping the winding.
+TestMesh ShuffleTestMesh(const char* name, const TestMesh& source)
+{
+    TestMesh mesh = { name, source.VertexCount, source.Indexes };
+
+    const u32 triangles = (u32)mesh.Indexes.size() / 3;
+
+    for (u32 x = triangles - 1; x > 0; x--)
+    {
+        const u32 xx = AcquireTestMeshRandom() % (x + 1);
+
+        for (u32 i = 0; i < 3; i++) { std::swap(mesh.Indexes[x * 3 + i], mesh.Indexes[xx * 3 + i]); }
+    }
+
+    for (u32 x = 0; x < triangles; x++)
+    {
+        std::rotate(&mesh.Indexes[x * 3], &mesh.Indexes[x * 3 + AcquireTestMeshRandom() % 3], &mesh.Indexes[x * 3 + 3]);
+    }
+
+    return mesh;
+}
+
+// Creates the triangles of the random vertexes, which no order can make cache friendly.
+TestMesh InitializeTestMeshSoup(const char* name, const u32 vertexCount, const u32 triangleCount)
+{
+    TestMesh mesh = { name, vertexCount };
+
+    for (u32 x = 0; x < triangleCount * 3; x++) { mesh.Indexes.push_back((u16)(AcquireTestMeshRandom() % vertexCount)); }
+
+    return mesh;
+}
+
+// Returns the average number of the vertexes transformed per triangle, the ACMR, of the first in, first out vertex cache of the size.
+f64 AcquireTestMeshACMR(const std::vector<u16>& indexes, const u32 size)
+{
+    std::vector<u16> cache;
+
+    u32 misses = 0;
+
+    for (u32 x = 0; x < indexes.size(); x++)
+    {
+        if (std::find(cache.begin(), cache.end(), indexes[x]) != cache.end()) { continue; }
+
+        misses = misses + 1;
+
+        cache.push_back(indexes[x]);
+
+        if (size < cache.size()) { cache.erase(cache.begin()); }
+    }
+
+    return (f64)misses / (f64)(indexes.size() / 3);
+}
+
+// Returns the triangles of the mesh rotated to start with their smallest index, and sorted, to compare the meshes regardless of the order.
+std::vector<u64> AcquireTestMeshTriangles(const std::vector<u16>& indexes)
+{
+    std::vector<u64> result;
+
+    for (u32 x = 0; x < indexes.size(); x = x + 3)
+    {
+        u16 triangle[3] = { indexes[x], indexes[x + 1], indexes[x + 2] };
+
+        std::rotate(triangle, std::min_element(triangle, triangle + 3), triangle + 3);
+
+        result.push_back(((u64)triangle[0] << 32) | ((u64)triangle[1] << 16) | (u64)triangle[2]);
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+// Checks that the optimized mesh has the same triangles, with the same winding, and that it does not transform more vertexes than the source does.
+std::vector<u16> TestMeshOptimization(const TestMesh& mesh)
+{
+    std::vector<u16> indexes = mesh.Indexes;
+
+    CHECK(OptimizeRendererMeshIndexes(indexes.data(), (u32)indexes.size(), mesh.VertexCount));
+    CHECK(AcquireTestMeshTriangles(indexes) == AcquireTestMeshTriangles(mesh.Indexes));
+
+    for (u32 size = 16; size <= MAX_MESH_VERTEX_CACHE_SIZE; size = size * 2)
+    {
+        CHECK(AcquireTestMeshACMR(indexes, size) <= AcquireTestMeshACMR(mesh.Indexes, size));
+    }
+
+    return indexes;
+}
+
+// Prints the ACMR of the meshes before and after the optimization, and the speed of the optimization.
+void BenchmarkMeshOptimization(const std::vector<TestMesh>& meshes)
+{
+    printf("%-16s %10s %12s %12s %12s %12s %10s\n", "Mesh", "Triangles", "ACMR 16", "Optimized", "ACMR 32", "Optimized", "MTris/s");
+
+    for (u32 x = 0; x < meshes.size(); x++)
+    {
+        const TestMesh& mesh = meshes[x];
+        const u32 triangles = (u32)mesh.Indexes.size() / 3;
+
+        std::vector<u16> indexes = mesh.Indexes;
+
+        u32 count = 0;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        f64 time = 0.0;
+
+        while (time < TEST_MESH_BENCHMARK_TIME)
+        {
+            indexes = mesh.Indexes;
+
+            OptimizeRendererMeshIndexes(indexes.data(), (u32)indexes.size(), mesh.VertexCount);
+
+            count = count + 1;
+            time = AcquireTestTime(start);
+        }
+
+        printf("%-16s %10u %12.3f %12.3f %12.3f %12.3f %10.2f\n", mesh.Name, triangles,
+            AcquireTestMeshACMR(mesh.Indexes, 16), AcquireTestMeshACMR(indexes, 16),
+            AcquireTestMeshACMR(mesh.Indexes, 32), AcquireTestMeshACMR(indexes, 32),
+            (f64)count * triangles / time / 1000000.0);
+    }
+}
+
+s32 main(s32 argc, char** argv)
+{
+    std::vector<TestMesh> meshes;
+
+    meshes.push_back(InitializeTestMeshGrid("Grid", TEST_MESH_GRID_SIZE));
+    meshes.push_back(ShuffleTestMesh("Shuffled Grid", meshes[0]));
+    meshes.push_back(InitializeTestMeshGrid("Quad", 2));
+    meshes.push_back(InitializeTestMeshSoup("Soup", TEST_MESH_SOUP_VERTEX_COUNT, TEST_MESH_SOUP_TRIANGLE_COUNT));
+
+    std::vector<std::vector<u16>> optimized;
+
+    for (u32 x = 0; x < meshes.size(); x++) { optimized.push_back(TestMeshOptimization(meshes[x])); }
+
+    // NOTE: The ideal ACMR of the grid is 0.5, that is one new vertex for every two triangles,
+    // whereas the order of the rows transforms every vertex twice, as the rows do not fit into the cache.
+    CHECK(AcquireTestMeshACMR(optimized[1], MAX_MESH_VERTEX_CACHE_SIZE) < 0.8);
+    CHECK(AcquireTestMeshACMR(optimized[1], MAX_MESH_VERTEX_CACHE_SIZE) < AcquireTestMeshACMR(meshes[0].Indexes, MAX_MESH_VERTEX_CACHE_SIZE));
+
+    if (IS_BENCHMARK(argc, argv)) { BenchmarkMeshOptimization(meshes); }
+
+    return CompleteTest(TEST_MESH_MODULE_NAME);
+}
@@ -0,0 +1,173 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <math.h>
+
+#include "Tests.hxx"
+
+#define TEST_DXT_DIMENSION 4
+#define TEST_DXT_DIMENSION_SEGMENT (TEST_DXT_DIMENSION * TEST_DXT_DIMENSION)
+#define TEST_DXT_NOISE 2
+
+// NOTE: The bounds of the error of the decoded colors, along with the quantization of the end points into R5G6B5 colors,
+// and the noise of the gradients, the colors may be off by the half of the spacing of the four colors of the block, and by the inset of the end points.
+#define MAX_TEST_DXT_COLOR_ERROR_CONSTANT 10
+#define MAX_TEST_DXT_COLOR_ERROR_DIVISOR 4
+#define MAX_TEST_DXT_COLOR_ROOT_MEAN_SQUARE_ERROR 8.0
+#define MAX_TEST_DXT_FAILURE_COUNT 8
+
+// Fills the four rows of the pixels of the blocks with the gradients between two random colors, with a little noise,
+// so that the colors of each of the blocks lie close to a line, as the DXT blocks expect them to.
+// NOTE: The alphas are the gradients too, so that the DXT1 blocks mix the opaque and the transparent pixels,
+// and every fourth block is of a single color, for the special cases of the encoders.
+inline void InitializeTestDXTGradients(u32* pixels, const u32 count, u32 (*random)(void))
+{
+    const u32 blocks = count / TEST_DXT_DIMENSION_SEGMENT;
+    const u32 length = blocks * TEST_DXT_DIMENSION;
+
+    for (u32 x = 0; x < blocks; x++)
+    {
+        const u32 color1 = random();
+        const u32 color2 = random();
+
+        const u32 single = random() & 0xFF;
+
+        for (u32 xx = 0; xx < TEST_DXT_DIMENSION_SEGMENT; xx++)
+        {
+            const s32 position = (x & 3) == 0 ? (s32)single : (s32)(random() & 0xFF);
+
+            u32 value = 0;
+
+            for (u32 xxx = 0; xxx < 32; xxx = xxx + 8)
+            {
+                const s32 v1 = (color1 >> xxx) & 0xFF;
+                const s32 v2 = (color2 >> xxx) & 0xFF;
+
+                const s32 noise = (x & 3) == 0 ? 0 : (s32)(random() % (2 * TEST_DXT_NOISE + 1)) - TEST_DXT_NOISE;
+
+                const s32 channel = v1 + (v2 - v1) * position / 255 + noise;
+
+                value = value | ((u32)(channel < 0 ? 0 : (0xFF < channel ? 0xFF : channel)) << xxx);
+            }
+
+            pixels[(xx / TEST_DXT_DIMENSION) * length + x * TEST_DXT_DIMENSION + (xx % TEST_DXT_DIMENSION)] = value;
+        }
+    }
+}
+
+// Checks the pixels decoded from the DXT blocks of the format against the pixels the blocks were encoded from.
+// The colors have to be within the bound relative to the range of the colors of the block, and so do the alphas, while
+// the transparent pixels of DXT1 blocks have to be the transparent black.
+inline void CheckTestDXTPixels(const char* name, const u32 format, const u32* pixels, const u32* decoded, const u32 count)
+{
+    const u32 blocks = count / TEST_DXT_DIMENSION_SEGMENT;
+    const u32 length = blocks * TEST_DXT_DIMENSION;
+
+    u32 failures = 0;
+    u32 samples = 0;
+
+    f64 squares = 0.0;
+
+    for (u32 x = 0; x < blocks; x++)
+    {
+        s32 mins[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+        s32 maxs[4] = { 0, 0, 0, 0 };
+
+        for (u32 xx = 0; xx < TEST_DXT_DIMENSION_SEGMENT; xx++)
+        {
+            const u32 value = pixels[(xx / TEST_DXT_DIMENSION) * length + x * TEST_DXT_DIMENSION + (xx % TEST_DXT_DIMENSION)];
+
+            for (u32 xxx = 0; xxx < 4; xxx++)
+            {
+                // NOTE: The transparent pixels of DXT1 blocks do not take part in the colors of the block.
+                if (xxx != 3 && format == 1 && (value >> 24) < 0x80) { continue; }
+
+                const s32 channel = (value >> (8 * xxx)) & 0xFF;
+
+                mins[xxx] = channel < mins[xxx] ? channel : mins[xxx];
+                maxs[xxx] = maxs[xxx] < channel ? channel : maxs[xxx];
+            }
+        }
+
+        for (u32 xx = 0; xx < TEST_DXT_DIMENSION_SEGMENT; xx++)
+        {
+            const u32 indx = (xx / TEST_DXT_DIMENSION) * length + x * TEST_DXT_DIMENSION + (xx % TEST_DXT_DIMENSION);
+
+            const u32 value = pixels[indx];
+            const u32 result = decoded[indx];
+
+            BOOL isValid = TRUE;
+
+            if (format == 1 && (value >> 24) < 0x80) { isValid = result == 0; }
+            else
+            {
+                for (u32 xxx = 0; xxx < 3; xxx++)
+                {
+                    const s32 error = (s32)((value >> (8 * xxx)) & 0xFF) - (s32)((result >> (8 * xxx)) & 0xFF);
+
+                    squares = squares + (f64)(error * error);
+                    samples = samples + 1;
+
+                    const s32 bound = (maxs[xxx] - mins[xxx]) / MAX_TEST_DXT_COLOR_ERROR_DIVISOR + MAX_TEST_DXT_COLOR_ERROR_CONSTANT;
+
+                    if (bound < error || error < -bound) { isValid = FALSE; }
+                }
+
+                const s32 error = (s32)(value >> 24) - (s32)(result >> 24);
+
+                switch (format)
+                {
+                case 1: { isValid = isValid && (result >> 24) == 0xFF; break; }
+                case 3: { isValid = isValid && -8 <= error && error <= 8; break; }
+                case 5:
+                {
+                    const s32 bound = (maxs[3] - mins[3]) / 14 + 1;
+
+                    isValid = isValid && -bound <= error && error <= bound;
+
+                    break;
+                }
+                }
+            }
+
+            if (!isValid)
+            {
+                if (failures < MAX_TEST_DXT_FAILURE_COUNT) { printf("%s: block %u, pixel %u is 0x%08X instead of 0x%08X.\n", name, x, xx, result, value); }
+
+                failures = failures + 1;
+            }
+        }
+    }
+
+    const f64 error = samples == 0 ? 0.0 : sqrt(squares / (f64)samples);
+
+    if (MAX_TEST_DXT_COLOR_ROOT_MEAN_SQUARE_ERROR < error)
+    {
+        printf("%s: the root mean square error of the colors is %.2f, above %.2f.\n", name, error, MAX_TEST_DXT_COLOR_ROOT_MEAN_SQUARE_ERROR);
+
+        failures = failures + 1;
+    }
+
+    TestFailures = TestFailures + failures;
+}
@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Basic.hxx"
+
+// NOTE: Reports the failed condition, and fails the test, without stopping it, so that all of the failures are listed.
+#define CHECK(x) { if (!(x)) { printf("%s(%d): CHECK(%s) failed.\n", __FILE__, __LINE__, #x); TestFailures = TestFailures + 1; } }
+
+// NOTE: The benchmarks run only when asked for, as the tests have to stay quick.
+#define IS_BENCHMARK(argc, argv) (1 < argc && strcmp(argv[1], "--benchmark") == 0)
+
+static u32 TestFailures = 0;
+
+// Returns the number of the seconds elapsed since the start.
+inline f64 AcquireTestTime(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prints the outcome of the test, and returns its exit code.
+inline s32 CompleteTest(const char* name)
+{
+    if (TestFailures == 0) { printf("%s: passed.\n", name); return EXIT_SUCCESS; }
+
+    printf("%s: %u failure(s).\n", name, TestFailures);
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,160 @@
+/*
+Copyright (c) 2023 - 2024 Americus Maximus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// NOTES
+// Prints the header, and the entries, of the cache file of the converted textures of the DirectX 8 renderer,
+// and checks it the same way the renderer does when it opens the file.
+//
+// Usage: <texturecache>.exe <Full path of the cache file>
+//
+// The tool returns zero when the cache file would be used by the renderer as is, and non-zero otherwise.
+
+#include "RendererTextureCache.hxx"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REQUIRED_ARGUMENT_COUNT 2
+#define PATH_ARGUMENT_INDEX 1
+
+#define SUCCESS 0
+#define FAILURE_INVALID_ARGUMENT_COUNT (-1)
+#define FAILURE_READING_FILE (-2)
+#define FAILURE_MEMORY_ALLOCATION (-3)
+#define FAILURE_INVALID_CACHE (-4)
+
+using namespace RendererModule;
+
+// Prints the format either as its four character code, or as its number.
+void PrintFormat(const u32 format)
+{
+    const char a = (char)(format & 0xFF);
+    const char b = (char)((format >> 8) & 0xFF);
+    const char c = (char)((format >> 16) & 0xFF);
+    const char d = (char)((format >> 24) & 0xFF);
+
+    if (0xFF < format && ' ' <= a && ' ' <= b && ' ' <= c && ' ' <= d) { printf("%9c%c%c%c", a, b, c, d); }
+    else { printf("%12u", format); }
+}
+
+const char* AcquireStateName(const u32 state)
+{
+    switch (state)
+    {
+    case TEXTURE_CACHE_STATE_VALID: { return "valid"; }
+    case TEXTURE_CACHE_STATE_INVALID_HEADER: { return "invalid header, the renderer resets the file"; }
+    case TEXTURE_CACHE_STATE_INVALID_CAPACITY: { return "capacity mismatch, the renderer resets the file"; }
+    case TEXTURE_CACHE_STATE_INVALID_ENTRY: { return "entry outside of the data, the renderer resets the file"; }
+    case TEXTURE_CACHE_STATE_DIRTY: { return "dirty, the file is either in use, or was not closed cleanly, the renderer resets it"; }
+    }
+
+    return "unknown";
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != REQUIRED_ARGUMENT_COUNT)
+    {
+        printf("File path not provided.\n");
+        printf("Usage: <texturecache>.exe <Full path of the cache file>\n");
+
+        return FAILURE_INVALID_ARGUMENT_COUNT;
+    }
+
+    FILE* file = fopen(argv[PATH_ARGUMENT_INDEX], "rb");
+
+    if (file == NULL)
+    {
+        printf("ERROR: Unable to open %s...\n", argv[PATH_ARGUMENT_INDEX]);
+
+        return FAILURE_READING_FILE;
+    }
+
+    fseek(file, 0, SEEK_END);
+
+    const long length = ftell(file);
+
+    fseek(file, 0, SEEK_SET);
+
+    RendererTextureCacheHeader* header = (RendererTextureCacheHeader*)malloc(sizeof(RendererTextureCacheHeader));
+
+    if (header == NULL)
+    {
+        fclose(file);
+
+        printf("ERROR: Unable to allocate memory.\n");
+
+        return FAILURE_MEMORY_ALLOCATION;
+    }
+
+    if (length < (long)sizeof(RendererTextureCacheHeader) || fread(header, sizeof(RendererTextureCacheHeader), 1, file) != 1)
+    {
+        free(header);
+        fclose(file);
+
+        printf("ERROR: Unable to read the header of %s...\n", argv[PATH_ARGUMENT_INDEX]);
+
+        return FAILURE_READING_FILE;
+    }
+
+    fclose(file);
+
+    // NOTE: The renderer maps the header, followed by the data of the capacity from its settings.
+    const u32 capacity = (u32)(length - (long)sizeof(RendererTextureCacheHeader));
+
+    printf("File:     %s, %ld bytes\n", argv[PATH_ARGUMENT_INDEX], length);
+    printf("Magic:    0x%08X, Version: %u\n", header->Magic, header->Version);
+    printf("Capacity: %u bytes\n", header->Capacity);
+    printf("Size:     %u bytes\n", header->Size);
+    printf("Tick:     %u\n", header->Tick);
+    printf("Dirty:    %s\n", header->IsDirty ? "yes" : "no");
+    printf("Entries:  %u\n", header->Count);
+
+    const u32 count = header->Count < MAX_TEXTURE_CACHE_ENTRY_COUNT ? header->Count : MAX_TEXTURE_CACHE_ENTRY_COUNT;
+
+    if (count != 0)
+    {
+        printf("\n%5s %16s %12s %12s %11s %6s %10s %10s %10s\n",
+            "Index", "Hash", "Source", "Destination", "Dimensions", "Levels", "Offset", "Size", "Tick");
+
+        for (u32 x = 0; x < count; x++)
+        {
+            const RendererTextureCacheEntry* entry = &header->Entries[x];
+
+            printf("%5u %08X%08X ", x, (u32)(entry->Hash >> 32), (u32)entry->Hash);
+
+            PrintFormat(entry->Source);
+            printf(" ");
+            PrintFormat(entry->Destination);
+
+            printf(" %5ux%-5u %6u %10u %10u %10u\n", entry->Width, entry->Height, entry->Levels, entry->Offset, entry->Size, entry->Tick);
+        }
+    }
+
+    const u32 state = AcquireRendererTextureCacheState(header, capacity);
+
+    printf("\nState:    %s\n", AcquireStateName(state));
+
+    free(header);
+
+    return state == TEXTURE_CACHE_STATE_VALID ? SUCCESS : FAILURE_INVALID_CACHE;
+}